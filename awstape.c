@@ -39,6 +39,8 @@
 /*-------------------------------------------------------------------*/
 DLL_EXPORT void close_awstape( DEVBLK* dev )
 {
+    tapestrm_close( dev );
+
     if (dev->fd >= 0)
     {
         if (!dev->batch || !dev->quiet)
@@ -53,6 +55,8 @@ DLL_EXPORT void close_awstape( DEVBLK* dev )
     dev->blockid =  0;
     dev->fenced  =  0;
 
+    tapeidx_free( dev );
+
     return;
 }
 
@@ -63,6 +67,8 @@ DLL_EXPORT void close_awstape( DEVBLK* dev )
 DLL_EXPORT int rewind_awstape (DEVBLK *dev,BYTE *unitstat,BYTE code)
 {
     off_t rcoff;
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0)
+        return -1;
     rcoff=lseek(dev->fd,0,SEEK_SET);
     if(rcoff<0)
     {
@@ -200,6 +206,7 @@ DLL_EXPORT int open_awstape( DEVBLK* dev, BYTE* unitstat, BYTE code )
     /* Open success. Save file descriptor and rewind to load-point */
 
     dev->fd = rc;
+    tapestrm_open( dev );
     rc = rewind_awstape( dev, unitstat, code );
     return rc;
 
@@ -230,7 +237,10 @@ off_t           rcoff;                  /* Return code from lseek()  */
     }
 
     /* Read the 6-byte block header */
-    rc = read (dev->fd, buf, sizeof(AWSTAPE_BLKHDR));
+    if (dev->tapestrm)
+        rc = tapestrm_pread (dev, buf, sizeof(AWSTAPE_BLKHDR), blkpos);
+    else
+        rc = read (dev->fd, buf, sizeof(AWSTAPE_BLKHDR));
 
     /* Handle read error condition */
     if (rc < 0)
@@ -286,6 +296,10 @@ off_t           blkpos;                 /* Offset of block header    */
 int             blklen = 0;             /* Total length of block     */
 U16             seglen;                 /* Data length of segment    */
 
+    /* Present any deferred write error first */
+    if (tapestrm_flush( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Initialize current block position */
     blkpos = dev->nxtblkpos;
 
@@ -332,7 +346,10 @@ U16             seglen;                 /* Data length of segment    */
             break;
 
         /* Read data block segment from tape file */
-        rc = read (dev->fd, buf+blklen, seglen);
+        if (dev->tapestrm)
+            rc = tapestrm_pread (dev, buf+blklen, seglen, blkpos - seglen);
+        else
+            rc = read (dev->fd, buf+blklen, seglen);
 
         /* Handle read error condition */
         if (rc < 0)
@@ -367,6 +384,7 @@ U16             seglen;                 /* Data length of segment    */
 
     /* Increment the block number */
     dev->blockid++;
+    tapeidx_note( dev, blklen == 0, false );
 
     /* Increment file number and return zero if tapemark was read */
     if (blklen == 0)
@@ -464,7 +482,10 @@ U16             prvblkl;                /* Length of previous chunk  */
         awshdr.prvblkl[1] = (prvblkl >> 8) & 0xFF;
 
         /* Write the chunk header */
-        rc = write (dev->fd, &awshdr, sizeof(awshdr));
+        if (dev->tapestrm)
+            rc = tapestrm_pwrite (dev, &awshdr, sizeof(awshdr), blkpos);
+        else
+            rc = write (dev->fd, &awshdr, sizeof(awshdr));
         if (rc < (int)sizeof(awshdr))
         {
             // "%1d:%04X Tape file %s, type %s: error in function %s, offset 0x%16.16"PRIX64": %s"
@@ -483,7 +504,10 @@ U16             prvblkl;                /* Length of previous chunk  */
         }
 
         /* Now write the chunk itself */
-        rc = write (dev->fd, buf, chksize);
+        if (dev->tapestrm)
+            rc = tapestrm_pwrite (dev, buf, chksize, blkpos + sizeof(awshdr));
+        else
+            rc = write (dev->fd, buf, chksize);
         if (rc < (int)chksize)
         {
             // "%1d:%04X Tape file %s, type %s: error in function %s, offset 0x%16.16"PRIX64": %s"
@@ -517,10 +541,16 @@ U16             prvblkl;                /* Length of previous chunk  */
     while (blklen);
 
     dev->blockid++;
+    tapeidx_note( dev, false, true );
 
     /* Set new physical EOF */
-    do rc = ftruncate( dev->fd, dev->nxtblkpos );
-    while (EINTR == rc);
+    if (dev->tapestrm)
+        rc = tapestrm_ftruncate( dev, dev->nxtblkpos );
+    else
+    {
+        do rc = ftruncate( dev->fd, dev->nxtblkpos );
+        while (EINTR == rc);
+    }
 
     /* Handle write error condition */
     if (rc != 0)
@@ -602,7 +632,10 @@ U16             prvblkl;                /* Length of previous block  */
     awshdr.flags2 = 0;
 
     /* Write the block header */
-    rc = write (dev->fd, &awshdr, sizeof(awshdr));
+    if (dev->tapestrm)
+        rc = tapestrm_pwrite (dev, &awshdr, sizeof(awshdr), blkpos);
+    else
+        rc = write (dev->fd, &awshdr, sizeof(awshdr));
     if (rc < (int)sizeof(awshdr))
     {
         /* Handle write error condition */
@@ -617,10 +650,16 @@ U16             prvblkl;                /* Length of previous block  */
     /* Calculate the offsets of the next and previous blocks */
     dev->nxtblkpos = blkpos + sizeof(awshdr);
     dev->prvblkpos = blkpos;
+    tapeidx_note( dev, true, true );
 
     /* Set new physical EOF */
-    do rc = ftruncate( dev->fd, dev->nxtblkpos );
-    while (EINTR == rc);
+    if (dev->tapestrm)
+        rc = tapestrm_ftruncate( dev, dev->nxtblkpos );
+    else
+    {
+        do rc = ftruncate( dev->fd, dev->nxtblkpos );
+        while (EINTR == rc);
+    }
 
     if (rc != 0)
     {
@@ -632,8 +671,8 @@ U16             prvblkl;                /* Length of previous block  */
         return -1;
     }
 
-    /* Return normal status */
-    return 0;
+    /* Tapemarks are written out immediately */
+    return tapestrm_flush( dev, unitstat, code );
 
 } /* end function write_awsmark */
 
@@ -652,6 +691,10 @@ DLL_EXPORT int sync_awstape (DEVBLK *dev, BYTE *unitstat,BYTE code)
         return -1;
     }
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_flush( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Perform sync. Return error on failure. */
     if (fdatasync( dev->fd ) < 0)
     {
@@ -683,6 +726,10 @@ off_t           blkpos;                 /* Offset of block header    */
 int             blklen = 0;             /* Total length of block     */
 U16             seglen;                 /* Data length of segment    */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Initialize current block position */
     blkpos = dev->nxtblkpos;
 
@@ -718,6 +765,7 @@ U16             seglen;                 /* Data length of segment    */
         dev->curfilen++;
 
     dev->blockid++;
+    tapeidx_note( dev, blklen == 0, false );
 
     /* Return block length or zero if tapemark */
     return blklen;
@@ -740,6 +788,10 @@ U16             curblkl;                /* Length of current block   */
 U16             prvblkl;                /* Length of previous block  */
 off_t           blkpos;                 /* Offset of block header    */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Unit check if already at start of tape */
     if (dev->nxtblkpos == 0)
     {
@@ -789,6 +841,15 @@ DLL_EXPORT int fsf_awstape (DEVBLK *dev, BYTE *unitstat,BYTE code)
 {
 int             rc;                     /* Return code               */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0)
+        return -1;
+
+    /* Find the next tapemark in the block index if possible,
+       otherwise continue from the highest indexed block */
+    if (tapeidx_fsf( dev ) > 0)
+        return 0;
+
     while (1)
     {
         /* Forward space over next block */
@@ -820,6 +881,20 @@ DLL_EXPORT int bsf_awstape (DEVBLK *dev, BYTE *unitstat,BYTE code)
 {
 int             rc;                     /* Return code               */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0)
+        return -1;
+
+    /* Find the previous tapemark in the block index if possible */
+    switch (tapeidx_bsf( dev ))
+    {
+    case 1:
+        return 0;
+    case 0:
+        build_senseX(TAPE_BSENSE_LOADPTERR,dev,unitstat,code);
+        return -1;
+    }
+
     while (1)
     {
         /* Exit if now at start of tape */
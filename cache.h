@@ -251,13 +251,13 @@ typedef struct _CACHEBLK {              /* Cache header              */
 /*-------------------------------------------------------------------*/
 CCH_DLL_IMPORT int cachestats_cmd(int argc, char *argv[], char *cmdline);
 
-int         cache_nbr(int ix);
-int         cache_busy(int ix);
-int         cache_empty(int ix);
-int         cache_waiters(int ix);
-S64         cache_size(int ix);
-S64         cache_hits(int ix);
-S64         cache_misses(int ix);
+CCH_DLL_IMPORT int         cache_nbr(int ix);
+CCH_DLL_IMPORT int         cache_busy(int ix);
+CCH_DLL_IMPORT int         cache_empty(int ix);
+CCH_DLL_IMPORT int         cache_waiters(int ix);
+CCH_DLL_IMPORT S64         cache_size(int ix);
+CCH_DLL_IMPORT S64         cache_hits(int ix);
+CCH_DLL_IMPORT S64         cache_misses(int ix);
 int         cache_busy_percent(int ix);
 int         cache_empty_percent(int ix);
 int         cache_hit_percent(int ix);
@@ -298,6 +298,13 @@ int         cache_release(int ix, int i, int flag);
 #define   CCKD_CACHE_USED    0x00800000 /* Entry has been used       */
 
 #define   CKD_CACHE_ACTIVE   0x80000000 /* Active entry              */
+#define   CKD_CACHE_WRITING  0x20000000 /* Entry being written back  */
+#define   CKD_CACHE_WBFAIL   0x10000000 /* Write-back failed         */
+#define   CKD_CACHE_WRITE    0x04000000 /* Entry pending write-back  */
+                                        /* (CKD_CACHE_WRITING,
+                                            CKD_CACHE_WBFAIL and
+                                            CKD_CACHE_WRITE are also
+                                            used for FBA entries)    */
 #define   FBA_CACHE_ACTIVE   0x80000000 /* Active entry              */
 #define   SHRD_CACHE_ACTIVE  0x80000000 /* Active entry              */
 
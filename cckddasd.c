@@ -1511,6 +1511,7 @@ TID             tid;                    /* Readahead thread id       */
 char            threadname[40];
 int             rc;
 int             ras;
+U32             affgen = 0;             /* sysblk.affgen applied     */
 
     UNREFERENCED(arg);
 
@@ -1548,6 +1549,8 @@ int             ras;
 
     while (ra <= cckdblk.ramax)   /* continue until ramax=0 (shutdown) or max reduced by command line */
     {
+        UPDATE_THREAD_AFFINITY( &sysblk.srvaff, affgen );
+
         if (cckdblk.ra1st < 0)
         {
             cckdblk.rawaiting++;
@@ -1781,6 +1784,7 @@ TID             tid;                    /* Writer thead id           */
 char            threadname[40];
 int             rc;
 int             wrs;
+U32             affgen = 0;             /* sysblk.affgen applied     */
 
     UNREFERENCED( arg );
 
@@ -1827,6 +1831,8 @@ int             wrs;
 
     while (writer <= cckdblk.wrmax || cckdblk.wrpending)
     {
+        UPDATE_THREAD_AFFINITY( &sysblk.srvaff, affgen );
+
         /* Wait for work */
         if (cckdblk.wrpending == 0)
         {
@@ -5017,6 +5023,7 @@ struct timeval  tv_now;                 /* Time-of-day (as timeval)  */
 time_t          tt_now;                 /* Time-of-day (as time_t)   */
 struct timespec tm;                     /* Time-of-day to wait       */
 int             gcs;
+U32             affgen = 0;             /* sysblk.affgen applied     */
 
     UNREFERENCED( arg );
 
@@ -5055,6 +5062,8 @@ int             gcs;
 
     while (gcol <= cckdblk.gcmax)
     {
+        UPDATE_THREAD_AFFINITY( &sysblk.srvaff, affgen );
+
         // "Begin CCKD garbage collection"
         if (cckdblk.gcmsgs)
             WRMSG( HHC00382, "I" );
@@ -6072,6 +6081,7 @@ void cckd_command_help()
         , "  help          Display help message"
         , "  stats         Display cckd statistics"
         , "  opts          Display cckd options"
+        , "  wbflush       Write out and sync write-back images"
         , ""
 
         //    ***  Please keep these in alphabetical order!  ***
@@ -6093,6 +6103,7 @@ void cckd_command_help()
         , "  raq=<n>       Set readahead queue size             ( 0 .. 16)"
         , "  rat=<n>       Set number tracks to read ahead      ( 0 .. 16)"
         , "  trace=<n>     Set trace table size             (0 ... 200000)"
+        , "  wbwr=<n>      Set number write-back threads        ( 1 ... 8)"
         , "  wr=<n>        Set number writer threads            ( 1 ... 9)"
 
         , NULL
@@ -6146,6 +6157,7 @@ void cckd_command_opts()
         ","   "raq=%d"
         ","   "rat=%d"
         ","   "trace=%d"
+        ","   "wbwr=%d"
         ","   "wr=%d"
 
         , cckdblk.gcparm
@@ -6156,6 +6168,7 @@ void cckd_command_opts()
         , cckdblk.ranbr
         , cckdblk.readaheads
         , cckdblk.itracen
+        , dasd_wb_writers( -1 )
         , cckdblk.wrmax
     );
     WRMSG( HHC00346, "I", msgbuf );
@@ -6169,6 +6182,7 @@ void cckd_command_opts()
 void cckd_command_stats()
 {
     char msgbuf[128];
+    U64  wbwrites, wbimages, wbbytes, wbsyncs;
 
     WRMSG( HHC00347, "I", "cckd stats:" );
 
@@ -6204,6 +6218,11 @@ void cckd_command_stats()
                     cckdblk.stats_gcolmoves, cckdblk.stats_gcolbytes >> SHIFT_1K );
     WRMSG( HHC00347, "I", msgbuf );
 
+    dasd_wb_stats( &wbwrites, &wbimages, &wbbytes, &wbsyncs );
+    MSGBUF( msgbuf, "  write-back writes%10"PRIu64" images...%10"PRIu64" Kbytes...%10"PRIu64" syncs....%10"PRIu64,
+                    wbwrites, wbimages, wbbytes >> SHIFT_1K, wbsyncs );
+    WRMSG( HHC00347, "I", msgbuf );
+
     return;
 } /* end function cckd_command_stats */
 
@@ -6277,6 +6296,11 @@ int   rc;
                 if (!cmd) return 0;
                 cckd_command_opts();
             }
+            // Write out and sync the write-back images
+            else if (CMD( kw, WBFLUSH, 7 ))
+            {
+                dasd_wb_flush_all();
+            }
             else
             {
                 // "CCKD file: invalid cckd keyword: %s"
@@ -6599,6 +6623,21 @@ int   rc;
                 RELEASE_TRACE_LOCK();
             }
         }
+        // Number write-back threads
+        else if (CMD( kw, WBWR, 4 ))
+        {
+            if (val < 1 || val > DASD_WB_MAX_WRITER)
+            {
+                // "CCKD file: value %d invalid for %s"
+                WRMSG( HHC00348, "E", val, kw );
+                return -1;
+            }
+            else
+            {
+                dasd_wb_writers( val );
+                opts = 1;
+            }
+        }
         // Number writer threads
         else if (CMD( kw, WR, 2 ))
         {
@@ -65,6 +65,7 @@
 #include "devtype.h"
 #include "opcode.h"
 #include "httpmisc.h"
+#include "cckddasd.h"
 
 /*-------------------------------------------------------------------*/
 /*                     cgibin_blinkenlights_cpu                      */
@@ -1195,6 +1196,491 @@ void cgibin_xml_rates_info(WEBBLK *webblk)
     hprintf(webblk->sock,"</hercules>\n");
 }
 
+/*-------------------------------------------------------------------*/
+/*                     cgibin_metrics_...                            */
+/*-------------------------------------------------------------------*/
+/* Machine readable metrics for monitoring systems, either in the    */
+/* OpenMetrics text format (cgi-bin/metrics, also served as plain    */
+/* /metrics) or as JSON (cgi-bin/metrics/json). Both formats are     */
+/* produced by the same code: every metric family is announced by    */
+/* metrics_family and its samples are added by metrics_u64 or        */
+/* metrics_dbl with a NULL terminated list of label name/value pairs.*/
+/*                                                                   */
+/* Unlike the HTML pages no global lock (intlock, devlock etc.) is   */
+/* obtained. The values are single aligned words updated by their    */
+/* owning threads and are read without serialization; a scrape may   */
+/* therefore see values from slightly different instants. The CPU    */
+/* statistics are read with the CPU's own cpulock held just long     */
+/* enough to keep its REGS from being freed by a deconfigure. The    */
+/* whole response is formatted into memory and written at once.      */
+/*-------------------------------------------------------------------*/
+
+typedef struct METBUF                   /* Metrics response buffer   */
+{
+    char   *buf;                        /* Buffer                    */
+    size_t  len;                        /* Bytes used                */
+    size_t  size;                       /* Bytes allocated           */
+    bool    json;                       /* JSON rather than OpenMetr.*/
+    bool    counter;                    /* Current family is counter */
+    int     nfam;                       /* Families so far           */
+    int     nsamp;                      /* Samples in current family */
+    const char* name;                   /* Current family name       */
+}
+METBUF;
+
+#define METBUF_INITSIZE     (64 * 1024)
+#define METRICS_MAXLOCKS    512         /* Distinct lock names       */
+
+static void ATTR_PRINTF(2,3) metrics_printf( METBUF* mb, const char* fmt, ... )
+{
+    va_list  vargs;
+    char    *newbuf;
+    int      n;
+
+    if (!mb->buf)
+        return;
+
+    for (;;)
+    {
+        va_start( vargs, fmt );
+        n = vsnprintf( mb->buf + mb->len, mb->size - mb->len, fmt, vargs );
+        va_end( vargs );
+
+        if (n < 0)
+            return;
+
+        if (mb->len + n < mb->size)
+        {
+            mb->len += n;
+            return;
+        }
+
+        if (!(newbuf = realloc( mb->buf, mb->size * 2 + n )))
+        {
+            free( mb->buf );
+            mb->buf = NULL;
+            return;
+        }
+        mb->buf   = newbuf;
+        mb->size  = mb->size * 2 + n;
+    }
+}
+
+static void metrics_endfamily( METBUF* mb )
+{
+    if (mb->json && mb->nfam)
+        metrics_printf( mb, "]}" );
+}
+
+static void metrics_family( METBUF* mb, const char* name,
+                            const char* type, const char* help )
+{
+    metrics_endfamily( mb );
+
+    mb->name    = name;
+    mb->counter = (strcmp( type, "counter" ) == 0);
+    mb->nsamp   = 0;
+
+    if (mb->json)
+        metrics_printf( mb, "%s\n{\"name\":\"%s\",\"type\":\"%s\",\"help\":\"%s\",\"samples\":[",
+            mb->nfam ? "," : "", name, type, help );
+    else
+        metrics_printf( mb, "# TYPE %s %s\n# HELP %s %s\n",
+            name, type, name, help );
+
+    mb->nfam++;
+}
+
+/* Label values may be lock names and the like: quote what needs it */
+static void metrics_labelvalue( METBUF* mb, const char* val )
+{
+    char  esc[128];
+    int   n = 0;
+
+    for (; *val && n < (int) sizeof( esc ) - 3; val++)
+    {
+        if (*val == '"' || *val == '\\')
+            esc[n++] = '\\';
+        esc[n++] = (*val >= ' ' && *val < 0x7F) ? *val : '?';
+    }
+    esc[n] = 0;
+    metrics_printf( mb, "\"%s\"", esc );
+}
+
+static void metrics_sample( METBUF* mb, const char** labels, const char* value )
+{
+    int  i;
+
+    if (mb->json)
+    {
+        metrics_printf( mb, "%s{\"labels\":{", mb->nsamp ? "," : "" );
+        for (i = 0; labels && labels[i]; i += 2)
+        {
+            metrics_printf( mb, "%s\"%s\":", i ? "," : "", labels[i] );
+            metrics_labelvalue( mb, labels[i+1] );
+        }
+        metrics_printf( mb, "},\"value\":%s}", value );
+    }
+    else
+    {
+        metrics_printf( mb, "%s%s", mb->name, mb->counter ? "_total" : "" );
+        if (labels && labels[0])
+        {
+            metrics_printf( mb, "{" );
+            for (i = 0; labels[i]; i += 2)
+            {
+                metrics_printf( mb, "%s%s=", i ? "," : "", labels[i] );
+                metrics_labelvalue( mb, labels[i+1] );
+            }
+            metrics_printf( mb, "}" );
+        }
+        metrics_printf( mb, " %s\n", value );
+    }
+    mb->nsamp++;
+}
+
+static void metrics_u64( METBUF* mb, const char** labels, U64 value )
+{
+    char  buf[32];
+    MSGBUF( buf, "%"PRIu64, value );
+    metrics_sample( mb, labels, buf );
+}
+
+static void metrics_dbl( METBUF* mb, const char** labels, double value )
+{
+    char  buf[32];
+    MSGBUF( buf, "%.6f", value );
+    metrics_sample( mb, labels, buf );
+}
+
+/* Lock statistics are summed by lock name since e.g. every device
+   has its own "&dev->lock" */
+typedef struct METLOCK
+{
+    const char* name;
+    U64         obtains;
+    U64         contended;
+    U64         waitusecs;
+}
+METLOCK;
+
+typedef struct METLOCKS
+{
+    METLOCK     lock[ METRICS_MAXLOCKS ];
+    int         nlocks;
+}
+METLOCKS;
+
+static void metrics_lockstat( const char* name, U64 obtains, U64 contended,
+                              U64 waitusecs, void* arg )
+{
+    METLOCKS*  ml = arg;
+    int        i;
+
+    if (!name)
+        return;
+
+    for (i = 0; i < ml->nlocks; i++)
+        if (strcmp( ml->lock[i].name, name ) == 0)
+            break;
+
+    if (i == ml->nlocks)
+    {
+        if (ml->nlocks >= METRICS_MAXLOCKS)
+            return;
+        /* (names of destroyed locks must not be referenced later) */
+        if (!(ml->lock[i].name = strdup( name )))
+            return;
+        ml->nlocks++;
+    }
+    ml->lock[i].obtains   += obtains;
+    ml->lock[i].contended += contended;
+    ml->lock[i].waitusecs += waitusecs;
+}
+
+static void metrics_cpus( METBUF* mb )
+{
+    static const struct {
+        const char* name; const char* type; const char* help;
+    } fam[] = {
+        { "hercules_cpu_mips",          "gauge",   "Instructions executed per second in millions" },
+        { "hercules_cpu_sios",          "gauge",   "SIO/SSCH instructions per second"             },
+        { "hercules_cpu_busy_percent",  "gauge",   "Percentage of time not in wait state"         },
+        { "hercules_cpu_wait_percent",  "gauge",   "Percentage of time in wait state"             },
+        { "hercules_cpu_instructions",  "counter", "Instructions executed"                        },
+        { "hercules_cpu_sio",           "counter", "SIO/SSCH instructions executed"               },
+        { "hercules_cpu_wait_seconds",  "counter", "Time spent in wait state"                     },
+    };
+    U64     val[ MAX_CPU_ENGS ][7];
+    bool    online[ MAX_CPU_ENGS ];
+    char    cpustr[8];
+    const char* labels[] = { "cpu", cpustr, NULL };
+    REGS   *regs;
+    int     cpu, f, hicpu = sysblk.hicpu;
+
+    for (cpu = 0; cpu < hicpu; cpu++)
+    {
+        online[ cpu ] = false;
+        obtain_lock( &sysblk.cpulock[ cpu ]);
+        if (IS_CPU_ONLINE( cpu ))
+        {
+            regs = sysblk.regs[ cpu ];
+            online[ cpu ] = true;
+            val[ cpu ][0] = regs->mipsrate;
+            val[ cpu ][1] = regs->siosrate;
+            val[ cpu ][2] = regs->cpustate == CPUSTATE_STARTED ? regs->cpupct : 0;
+            val[ cpu ][3] = regs->cpustate == CPUSTATE_STARTED ? 100 - regs->cpupct : 0;
+            val[ cpu ][4] = regs->prevcount + regs->instcount;
+            val[ cpu ][5] = regs->siototal + regs->siocount;
+            val[ cpu ][6] = regs->waittime_accumulated + regs->waittime;
+        }
+        release_lock( &sysblk.cpulock[ cpu ]);
+    }
+
+    for (f = 0; f < (int) _countof( fam ); f++)
+    {
+        metrics_family( mb, fam[f].name, fam[f].type, fam[f].help );
+
+        for (cpu = 0; cpu < hicpu; cpu++)
+        {
+            if (!online[ cpu ])
+                continue;
+
+            MSGBUF( cpustr, "%02X", cpu );
+
+            switch (f)
+            {
+            case 0:  metrics_dbl( mb, labels, val[ cpu ][0] / 1000000.0 ); break;
+            case 6:  metrics_dbl( mb, labels, (double) val[ cpu ][6] / ETOD_SEC ); break;
+            default: metrics_u64( mb, labels, val[ cpu ][f] );
+            }
+        }
+    }
+}
+
+static void metrics_devices( METBUF* mb )
+{
+    DEVBLK *dev;
+    char    devstr[8], typstr[8];
+    const char* labels[] = { "device", devstr, "type", typstr, NULL };
+    int     f;
+
+    for (f = 0; f < 6; f++)
+    {
+        switch (f)
+        {
+        case 0: metrics_family( mb, "hercules_device_io",         "counter", "Channel programs executed" );        break;
+        case 1: metrics_family( mb, "hercules_device_io_seconds", "counter", "Time spent executing channel programs" ); break;
+        case 2: metrics_family( mb, "hercules_net_rx_packets",    "counter", "Packets received from the host network" ); break;
+        case 3: metrics_family( mb, "hercules_net_rx_bytes",      "counter", "Bytes received from the host network" );   break;
+        case 4: metrics_family( mb, "hercules_net_tx_packets",    "counter", "Packets sent to the host network" );       break;
+        case 5: metrics_family( mb, "hercules_net_tx_bytes",      "counter", "Bytes sent to the host network" );         break;
+        }
+
+        for (dev = sysblk.firstdev; dev; dev = dev->nextdev)
+        {
+            if (!dev->allocated || !(dev->pmcw.flag5 & PMCW5_V))
+                continue;
+
+            /* Only network adapters have packet counts */
+            if (f >= 2 && !(dev->netrxpkts | dev->nettxpkts))
+                continue;
+
+            MSGBUF( devstr, "%1d:%04X", SSID_TO_LCSS( dev->ssid ), dev->devnum );
+            MSGBUF( typstr, "%04X", dev->devtype );
+
+            switch (f)
+            {
+            case 0: metrics_u64( mb, labels, dev->excps ); break;
+            case 1: metrics_dbl( mb, labels, (double) dev->excptime / ETOD_SEC ); break;
+            case 2: metrics_u64( mb, labels, dev->netrxpkts  ); break;
+            case 3: metrics_u64( mb, labels, dev->netrxbytes ); break;
+            case 4: metrics_u64( mb, labels, dev->nettxpkts  ); break;
+            case 5: metrics_u64( mb, labels, dev->nettxbytes ); break;
+            }
+        }
+    }
+}
+
+static void metrics_caches( METBUF* mb )
+{
+    char    ixstr[4];
+    const char* labels[] = { "cache", ixstr, NULL };
+    int     ix, f;
+    S64     val;
+
+    for (f = 0; f < 7; f++)
+    {
+        switch (f)
+        {
+        case 0: metrics_family( mb, "hercules_cache_entries", "gauge",   "Cache entries" );             break;
+        case 1: metrics_family( mb, "hercules_cache_busy",    "gauge",   "Busy cache entries" );        break;
+        case 2: metrics_family( mb, "hercules_cache_empty",   "gauge",   "Empty cache entries" );       break;
+        case 3: metrics_family( mb, "hercules_cache_waiters", "gauge",   "Threads waiting for a cache entry" ); break;
+        case 4: metrics_family( mb, "hercules_cache_bytes",   "gauge",   "Cache buffer storage" );      break;
+        case 5: metrics_family( mb, "hercules_cache_hits",    "counter", "Cache lookup hits" );         break;
+        case 6: metrics_family( mb, "hercules_cache_misses",  "counter", "Cache lookup misses" );       break;
+        }
+
+        for (ix = 0; ix < CACHE_MAX_INDEX; ix++)
+        {
+            switch (f)
+            {
+            case 0:  val = cache_nbr(     ix ); break;
+            case 1:  val = cache_busy(    ix ); break;
+            case 2:  val = cache_empty(   ix ); break;
+            case 3:  val = cache_waiters( ix ); break;
+            case 4:  val = cache_size(    ix ); break;
+            case 5:  val = cache_hits(    ix ); break;
+            default: val = cache_misses(  ix ); break;
+            }
+
+            /* (cache not created) */
+            if (val < 0)
+                continue;
+
+            MSGBUF( ixstr, "%d", ix );
+            metrics_u64( mb, labels, (U64) val );
+        }
+    }
+}
+
+static void metrics_cckd( METBUF* mb )
+{
+    static const char* const cntname[] = {
+        "hercules_cckd_reads",              "Track/block group reads",
+        "hercules_cckd_read_bytes",         "Bytes read",
+        "hercules_cckd_writes",             "Track/block group writes",
+        "hercules_cckd_write_bytes",        "Bytes written",
+        "hercules_cckd_cache_hits",         "Track cache hits",
+        "hercules_cckd_cache_misses",       "Track cache misses",
+        "hercules_cckd_l2_cache_hits",      "L2 cache hits",
+        "hercules_cckd_l2_cache_misses",    "L2 cache misses",
+        "hercules_cckd_l2_reads",           "L2 table reads",
+        "hercules_cckd_readaheads",         "Readaheads",
+        "hercules_cckd_readahead_misses",   "Readaheads not used",
+        "hercules_cckd_io_waits",           "Waits for i/o",
+        "hercules_cckd_cache_waits",        "Waits for a cache entry",
+        "hercules_cckd_stress_writes",      "Writes under stress",
+        "hercules_cckd_gc_moves",           "Spaces moved by the garbage collector",
+        "hercules_cckd_gc_bytes",           "Bytes moved by the garbage collector",
+    };
+    const U64 cntval[] = {
+        cckdblk.stats_reads,          cckdblk.stats_readbytes,
+        cckdblk.stats_writes,         cckdblk.stats_writebytes,
+        cckdblk.stats_cachehits,      cckdblk.stats_cachemisses,
+        cckdblk.stats_l2cachehits,    cckdblk.stats_l2cachemisses,
+        cckdblk.stats_l2reads,        cckdblk.stats_readaheads,
+        cckdblk.stats_readaheadmisses,cckdblk.stats_iowaits,
+        cckdblk.stats_cachewaits,     cckdblk.stats_stresswrites,
+        cckdblk.stats_gcolmoves,      cckdblk.stats_gcolbytes,
+    };
+    int  i;
+
+    for (i = 0; i < (int) _countof( cntval ); i++)
+    {
+        metrics_family( mb, cntname[ 2*i ], "counter", cntname[ 2*i+1 ] );
+        metrics_u64( mb, NULL, cntval[i] );
+    }
+
+    metrics_family( mb, "hercules_cckd_readahead_threads", "gauge", "Active readahead threads" );
+    metrics_u64( mb, NULL, cckdblk.raa );
+    metrics_family( mb, "hercules_cckd_writer_threads", "gauge", "Active writer threads" );
+    metrics_u64( mb, NULL, cckdblk.wra );
+    metrics_family( mb, "hercules_cckd_writes_pending", "gauge", "Writes pending" );
+    metrics_u64( mb, NULL, cckdblk.wrpending );
+    metrics_family( mb, "hercules_cckd_gc_threads", "gauge", "Active garbage collector threads" );
+    metrics_u64( mb, NULL, cckdblk.gca );
+}
+
+static void metrics_locks( METBUF* mb )
+{
+    METLOCKS*  ml;
+    const char* labels[] = { "lock", NULL, NULL };
+    int        i, f;
+
+    if (!(ml = calloc( 1, sizeof( METLOCKS ))))
+        return;
+
+    hthread_lock_stats( metrics_lockstat, ml );
+
+    for (f = 0; f < 3; f++)
+    {
+        switch (f)
+        {
+        case 0: metrics_family( mb, "hercules_lock_obtains",      "counter", "Exclusive lock obtains" ); break;
+        case 1: metrics_family( mb, "hercules_lock_contended",    "counter", "Lock obtains which had to wait" ); break;
+        case 2: metrics_family( mb, "hercules_lock_wait_seconds", "counter", "Time spent waiting for locks" ); break;
+        }
+
+        for (i = 0; i < ml->nlocks; i++)
+        {
+            labels[1] = ml->lock[i].name;
+            switch (f)
+            {
+            case 0: metrics_u64( mb, labels, ml->lock[i].obtains   ); break;
+            case 1: metrics_u64( mb, labels, ml->lock[i].contended ); break;
+            case 2: metrics_dbl( mb, labels, ml->lock[i].waitusecs / 1000000.0 ); break;
+            }
+        }
+    }
+
+    for (i = 0; i < ml->nlocks; i++)
+        free( (void*) ml->lock[i].name );
+    free( ml );
+}
+
+static void cgibin_metrics_common( WEBBLK* webblk, bool json )
+{
+    METBUF  mb;
+
+    memset( &mb, 0, sizeof( mb ));
+    mb.json = json;
+    mb.size = METBUF_INITSIZE;
+    mb.buf  = malloc( mb.size );
+
+    if (json)
+        metrics_printf( &mb, "{\"metrics\":[" );
+
+    metrics_family( &mb, "hercules_mips", "gauge", "Instructions executed per second in millions, all CPUs" );
+    metrics_dbl( &mb, NULL, sysblk.mipsrate / 1000000.0 );
+    metrics_family( &mb, "hercules_sios", "gauge", "SIO/SSCH instructions per second, all CPUs" );
+    metrics_u64( &mb, NULL, sysblk.siosrate );
+
+    metrics_cpus( &mb );
+    metrics_devices( &mb );
+    metrics_caches( &mb );
+    metrics_cckd( &mb );
+    metrics_locks( &mb );
+
+    metrics_endfamily( &mb );
+
+    if (json)
+        metrics_printf( &mb, "\n]}\n" );
+    else
+        metrics_printf( &mb, "# EOF\n" );
+
+    hprintf( webblk->sock, "Expires: 0\n" );
+    hprintf( webblk->sock, "Content-Type: %s\n\n", json
+        ? "application/json"
+        : "application/openmetrics-text; version=1.0.0; charset=utf-8" );
+
+    if (mb.buf)
+        hwrite( webblk->sock, mb.buf, mb.len );
+
+    free( mb.buf );
+}
+
+void cgibin_metrics( WEBBLK* webblk )
+{
+    cgibin_metrics_common( webblk, false );
+}
+
+void cgibin_metrics_json( WEBBLK* webblk )
+{
+    cgibin_metrics_common( webblk, true );
+}
+
 /*-------------------------------------------------------------------*/
 /*   cgibin_hwrite      --      helper function to output HTML       */
 /*-------------------------------------------------------------------*/
@@ -1344,6 +1830,9 @@ CGITAB cgidir[] =
 
     { "xml/rates",           &cgibin_xml_rates_info      },
 
+    { "metrics",             &cgibin_metrics             },
+    { "metrics/json",        &cgibin_metrics_json        },
+
     { NULL, NULL }
 };
 
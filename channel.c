@@ -2591,6 +2591,7 @@ DEVBLK *dev;
 int     current_priority;               /* Current thread priority   */
 int     rc = 0;                         /* Return code               */
 u_int   waitcount = 0;                  /* Wait counter              */
+U32     affgen = 0;                     /* sysblk.affgen applied     */
 
     UNREFERENCED(arg);
 
@@ -2636,6 +2637,9 @@ u_int   waitcount = 0;                  /* Wait counter              */
 
             release_lock (&sysblk.ioqlock);
 
+            /* Follow any AFFINITY DEV host CPU set change           */
+            UPDATE_THREAD_AFFINITY( &sysblk.devaff, affgen );
+
             /* Set priority to requested device priority; should not */
             /* have any Hercules locks held                          */
             if (dev->devprio != current_priority)
@@ -4335,11 +4339,15 @@ int     rc;                             /* Return code               */
 
 static INLINE void* execute_ccw_chain_fast_return
 (
+    DEVBLK* dev,
     IOBUF*  pIOBUF,
     IOBUF*  pInitial_IOBUF,
     void*   pvRetVal
 )
 {
+    /* Accumulate channel program execution time */
+    dev->excptime += host_tod() - dev->excpstod;
+
     if (pIOBUF != pInitial_IOBUF)
         iobuf_destroy( pIOBUF );
     return pvRetVal;
@@ -4355,7 +4363,7 @@ static INLINE void* execute_ccw_chain_clear_busy_unlock_and_return
 {
     clear_subchannel_busy( dev );
     release_lock( &dev->lock );
-    return execute_ccw_chain_fast_return( pIOBUF, pInitial_IOBUF, pvRetVal );
+    return execute_ccw_chain_fast_return( dev, pIOBUF, pInitial_IOBUF, pvRetVal );
 }
 
 static INLINE void* execute_ccw_chain_clear_busy_and_return
@@ -4444,6 +4452,7 @@ IOBUF iobuf_initial;                    /* Channel I/O buffer        */
 
     /* Increment excp count */
     dev->excps++;
+    dev->excpstod = host_tod();
 
     /* Indicate that we're started */
     dev->scsw.flag2 |= SCSW2_FC_START;
@@ -4637,7 +4646,7 @@ execute_clear:
             RELEASE_INTLOCK(NULL);
 
             /* Return */
-            return execute_ccw_chain_fast_return( iobuf, &iobuf_initial, NULL );
+            return execute_ccw_chain_fast_return( dev, iobuf, &iobuf_initial, NULL );
 
         } /* end perform clear subchannel */
 
@@ -4661,7 +4670,7 @@ execute_halt:
                     WRMSG( HHC01309, "I", LCSS_DEVNUM );
             }
 
-            return execute_ccw_chain_fast_return( iobuf, &iobuf_initial, NULL );
+            return execute_ccw_chain_fast_return( dev, iobuf, &iobuf_initial, NULL );
 
         } /* end perform halt subchannel */
 
@@ -4685,7 +4694,7 @@ execute_halt:
                     WRMSG( HHC01307, "I", LCSS_DEVNUM );
             }
 
-            return execute_ccw_chain_fast_return( iobuf, &iobuf_initial, NULL );
+            return execute_ccw_chain_fast_return( dev, iobuf, &iobuf_initial, NULL );
 
         } /* end attention processing */
 
@@ -5074,7 +5083,7 @@ execute_halt:
                     goto execute_halt;
                 }
 
-                return execute_ccw_chain_fast_return( iobuf, &iobuf_initial, NULL );
+                return execute_ccw_chain_fast_return( dev, iobuf, &iobuf_initial, NULL );
             }
 
             release_lock (&dev->lock);
@@ -5191,7 +5200,7 @@ execute_halt:
 
             /* Leave device as busy, unlock device and return */
             release_lock(&dev->lock);
-            return execute_ccw_chain_fast_return( iobuf, &iobuf_initial, NULL );
+            return execute_ccw_chain_fast_return( dev, iobuf, &iobuf_initial, NULL );
         }
 
         /* Handle initial status settings on first non-immediate CCW */
@@ -5800,7 +5809,7 @@ breakchain:
 
     /* If we're shutting down, skip final sequence and just exit now */
     if (sysblk.shutdown)
-        return execute_ccw_chain_fast_return( iobuf, &iobuf_initial, NULL );
+        return execute_ccw_chain_fast_return( dev, iobuf, &iobuf_initial, NULL );
 
     /* Final sequence MUST be performed with INTLOCK held to prevent
        I/O instructions (such as test_subchan) from proceeding before
@@ -5884,7 +5893,7 @@ breakchain:
     queue_io_interrupt_and_update_status_locked( dev, TRUE );
     release_lock( &dev->lock );
     RELEASE_INTLOCK( NULL );
-    return execute_ccw_chain_fast_return( iobuf, &iobuf_initial, NULL );
+    return execute_ccw_chain_fast_return( dev, iobuf, &iobuf_initial, NULL );
 
 } /* end function execute_ccw_chain */
 
@@ -5999,6 +6008,58 @@ int     i;                              /* Interruption subclass     */
     return SIE_NO_INTERCEPT;
 } /* end function interrupt_enabled */
 
+/*-------------------------------------------------------------------*/
+/* Wake a waiting CPU that is enabled for an I/O interrupt this CPU  */
+/* cannot take, preferring the CPU that took the device's last one.  */
+/*-------------------------------------------------------------------*/
+static void ARCH_DEP( wake_io_interrupt_cpu )( IOINT* io )
+{
+    REGS *regs;
+    CPU_BITMAP mask = sysblk.waiting_mask;
+    CPU_BITMAP wake;
+    int i;
+
+    /* If any CPUs are waiting, isolate to subgroup enabled for
+     * I/O interrupts.
+     */
+    if (mask)
+    {
+        wake = mask;
+
+        /* Turn off wake mask bits for waiting CPUs that aren't
+         * enabled for I/O interrupts for the device.
+         */
+        for (i=0; mask; mask >>= 1, ++i)
+        {
+            if (mask & 1)
+            {
+                regs = sysblk.regs[i];
+
+                if (!ARCH_DEP( interrupt_enabled )( regs, io->dev ))
+                    wake ^= regs->cpubit;
+            }
+        }
+
+        /* Wakeup the CPU which took this device's previous
+         * interrupt if it can take this one too, otherwise
+         * the LRU waiting CPU enabled for I/O interrupts.
+         */
+        i = io->dev->intcpu;
+
+        if (1
+            && i < sysblk.maxcpu
+            && sysblk.regs[i]
+            && (wake & sysblk.regs[i]->cpubit)
+        )
+        {
+            sysblk.iointstat.hinted++;
+            wake = sysblk.regs[i]->cpubit;
+        }
+
+        WAKEUP_CPU_MASK( wake );
+    }
+}
+
 
 /*-------------------------------------------------------------------*/
 /*                 PRESENT PENDING I/O INTERRUPT                     */
@@ -6040,7 +6101,7 @@ int ARCH_DEP( present_io_interrupt )( REGS* regs, U32* ioid, U32* ioparm,
                                       U32* iointid, BYTE* csw,
                                       DEVBLK** pdev )
 {
-IOINT  *io, *io2;                       /* -> I/O interrupt entry    */
+IOINT  *io;                             /* -> I/O interrupt entry    */
 DEVBLK *dev;                            /* -> Device control block   */
 int     icode = 0;                      /* Intercept code            */
 bool    dotsch = true;                  /* perform TSCH after int    */
@@ -6074,8 +6135,29 @@ retry:
 
     obtain_lock( &sysblk.iointqlk );
     {
-        for (io = sysblk.iointq; io != NULL; io = io->next)
+        for (io = NEXT_IO_INTERRUPT_QLOCKED( NULL ); io != NULL; io = NEXT_IO_INTERRUPT_QLOCKED( io ))
         {
+#if defined( FEATURE_CHANNEL_SUBSYSTEM )
+            /* Skip a whole subclass this CPU is disabled for in CR6,
+               offering its first interrupt to another CPU instead */
+            if (1
+                && io->bucket < 8
+                && io == sysblk.iointq[ io->bucket ].head
+                && !SIE_MODE( regs )
+                && !(regs->CR_L(6) & (0x80000000 >> io->bucket))
+            )
+            {
+                IOINT* last = sysblk.iointq[ io->bucket ].tail;
+
+                for (; io != last && io->dev->tschpending; io = io->next);
+
+                if (!io->dev->tschpending)
+                    ARCH_DEP( wake_io_interrupt_cpu )( io );
+
+                io = last;
+                continue;
+            }
+#endif
             /* Can't present interrupt while TEST SUBCHANNEL required
              * (interrupt already presented for this device)
              */
@@ -6095,39 +6177,7 @@ retry:
             }
 
             /* See if another CPU can take this interrupt */
-            {
-                REGS *regs;
-                CPU_BITMAP mask = sysblk.waiting_mask;
-                CPU_BITMAP wake;
-                int i;
-
-                /* If any CPUs are waiting, isolate to subgroup enabled for
-                 * I/O interrupts.
-                 */
-                if (mask)
-                {
-                    wake = mask;
-
-                    /* Turn off wake mask bits for waiting CPUs that aren't
-                     * enabled for I/O interrupts for the device.
-                     */
-                    for (i=0; mask; mask >>= 1, ++i)
-                    {
-                        if (mask & 1)
-                        {
-                            regs = sysblk.regs[i];
-
-                            if (!ARCH_DEP( interrupt_enabled )( regs, io->dev ))
-                                wake ^= regs->cpubit;
-                        }
-                    }
-
-                    /* Wakeup the LRU waiting CPU enabled for I/O
-                     * interrupts.
-                     */
-                    WAKEUP_CPU_MASK( wake );
-                }
-            }
+            ARCH_DEP( wake_io_interrupt_cpu )( io );
 
         } /* end for(io) */
 
@@ -6144,7 +6194,7 @@ retry:
             */
             ASSERT( dev == NULL );
 
-            for (io = sysblk.iointq; io != NULL; io = io->next)
+            for (io = NEXT_IO_INTERRUPT_QLOCKED( NULL ); io != NULL; io = NEXT_IO_INTERRUPT_QLOCKED( io ))
             {
                 /* Exit loop if pending interrupts from this device */
                 if (ARCH_DEP( interrupt_enabled )( regs, io->dev ))
@@ -6185,9 +6235,7 @@ retry:
          */
         obtain_lock( &sysblk.iointqlk );
         {
-            for (io2 = sysblk.iointq; io2 != NULL && io2 != io; io2 = io2->next);
-
-            if (io2 == NULL || dev->tschpending)
+            if (!io->queued || io->dev != dev || dev->tschpending)
             {
                 /* Our interrupt was dequeued; retry */
                 release_lock( &sysblk.iointqlk );
@@ -6231,6 +6279,8 @@ retry:
                 if (!SIE_MODE(regs) || icode != SIE_INTERCEPT_IOINTP)
                 {
                     /* Dequeue the interrupt */
+                    if (dev->pciioint.queued)
+                        Sample_IO_Interrupt_QLocked( &dev->pciioint );
                     PCI_dequeued = DEQUEUE_IO_INTERRUPT_QLOCKED( &dev->pciioint ) == 0 ? true : false;
 
                     if (!PCI_dequeued)
@@ -6280,9 +6330,13 @@ retry:
                     dev->pmcw.flag27 &= ~PMCW27_I;
 
                 /* Dequeue the interrupt */
+                Sample_IO_Interrupt_QLocked( io );
                 DEQUEUE_IO_INTERRUPT_QLOCKED( io );
             }
 
+            /* Remember which CPU took it as a hint for the next one */
+            dev->intcpu = regs->cpuad;
+
             /* TEST SUBCHANNEL is now required to clear the interrupt */
             dev->tschpending = dotsch;
 
@@ -6354,7 +6408,6 @@ int
 ARCH_DEP(present_zone_io_interrupt) (U32 *ioid, U32 *ioparm,
                                      U32 *iointid, BYTE zone)
 {
-IOINT  *io;                             /* -> I/O interrupt entry    */
 DEVBLK *dev;                            /* -> Device control block   */
 typedef struct _DEVLIST {               /* list of device block ptrs */
     struct _DEVLIST *next;              /* next list entry or NULL   */
@@ -6417,11 +6470,12 @@ DEVLIST *pZoneDevs = NULL;              /* devices in requested zone */
     obtain_lock(&sysblk.iointqlk);
     for (pDEVLIST = pZoneDevs, pPrevDEVLIST = NULL; pDEVLIST;)
     {
-        /* Search interrupt queue for this device */
-        for (io = sysblk.iointq; io != NULL && io->dev != pDEVLIST->dev; io = io->next);
-
         /* Is interrupt queued for this device? */
-        if (io == NULL)
+        if (1
+            && !pDEVLIST->dev->ioint.queued
+            && !pDEVLIST->dev->pciioint.queued
+            && !pDEVLIST->dev->attnioint.queued
+        )
         {
             /* No, remove it from our list */
             if (!pPrevDEVLIST)
@@ -6547,33 +6601,66 @@ DLL_EXPORT void Queue_IO_Interrupt( IOINT* io, U8 clrbsy, const char* location )
     release_lock( &sysblk.iointqlk );
 }
 
+/*-------------------------------------------------------------------*/
+/*  Return the sysblk.iointq[] bucket for an I/O interrupt priority  */
+/*-------------------------------------------------------------------*/
+static INLINE int iointq_bucket( int priority )
+{
+    int isc = 0;
+
+    /* ISC n is priority bit 0x00800000 >> n (see io.c MSCH) */
+    while (isc < 8 && !(priority & (0x00800000 >> isc)))
+        isc++;
+
+    return isc;     /* (8 = no ISC assigned, presented last) */
+}
+
 DLL_EXPORT void Queue_IO_Interrupt_QLocked( IOINT* io, U8 clrbsy, const char* location )
 {
-IOINT* prev;
+IOINTQ* q;                              /* -> Queue bucket           */
+IOINT*  next;                           /* -> Insert before entry    */
+int     depth;                          /* Queue depth bin           */
 
     UNREFERENCED( location );
 
-    /* Check if an I/O interrupt is already queued for this device */
-    for
-    (
-        prev = (IOINT*) &sysblk.iointq;
-        (1
-            && prev->next != NULL
-            && prev->next != io
-            && prev->next->priority >= io->dev->priority
-        );
-        prev = prev->next
-    )
-    {
-        ;   /* (do nothing, we are only searching) */
-    }
-
     /* If no interrupt in queue for this device then add one */
-    if (prev->next != io)
+    if (!io->queued)
     {
-        io->next     = prev->next;
-        prev->next   = io;
         io->priority = io->dev->priority;
+        io->bucket   = iointq_bucket( io->priority );
+        io->qtod     = host_tod();
+        io->queued   = 1;
+
+        q = &sysblk.iointq[ io->bucket ];
+
+        /* Normally no higher priority than the last entry: append */
+        if (!q->tail || q->tail->priority >= io->priority)
+            next = NULL;
+        else
+        {
+            /* Queue after all entries of equal or higher priority */
+            for (next = q->head; next->priority >= io->priority; next = next->next)
+                ;   /* (do nothing, we are only searching) */
+        }
+
+        io->next = next;
+        io->prev = next ? next->prev : q->tail;
+
+        if (io->prev) io->prev->next = io;
+        else          q->head        = io;
+
+        if (next)     next->prev     = io;
+        else          q->tail        = io;
+
+        sysblk.iointqmask |= (1 << io->bucket);
+
+        /* Update queue depth statistics */
+        sysblk.iointstat.queued++;
+        if (++sysblk.iointstat.depth > sysblk.iointstat.maxdepth)
+            sysblk.iointstat.maxdepth = sysblk.iointstat.depth;
+        for (depth=0; depth < IOINTQ_DEPTH_BINS-1
+            && (sysblk.iointstat.depth >> (depth+1)); depth++);
+        sysblk.iointstat.depthbin[ depth ]++;
     }
 
     /* Update device flags according to interrupt type */
@@ -6613,33 +6700,35 @@ int rc;
 
 DLL_EXPORT int Dequeue_IO_Interrupt_QLocked( IOINT* io, const char* location )
 {
-IOINT* prev;
+IOINTQ* q;                              /* -> Queue bucket           */
 int rc = -1;        /* No I/O interrupts were queued for this device */
 
     UNREFERENCED( location );
 
-    /* Search the I/O interrupt queue for an interrupt
-       for this device and dequeue it if one is found. */
-    for
-    (
-        prev = (IOINT*) &sysblk.iointq;
-        prev->next != NULL;
-        prev = prev->next
-    )
+    /* Dequeue the interrupt if one is queued for this device and
+       update device flags according to interrupt type. */
+    if (io->queued)
     {
-        /* Is this I/O interrupt for requested device? */
-        if (prev->next == io)
-        {
-            /* Yes, dequeue the I/O interrupt and update
-               device flags according to interrupt type. */
-            prev->next = io->next;
-                 if (io->pending)     io->dev->pending     = 0;
-            else if (io->pcipending)  io->dev->pcipending  = 0;
-            else if (io->attnpending) io->dev->attnpending = 0;
-
-            rc = 0;   /* I/O interrupt successfully dequeued */
-            break;    /* I/O interrupt successfully dequeued */
-        }
+        q = &sysblk.iointq[ io->bucket ];
+
+        if (io->prev) io->prev->next = io->next;
+        else          q->head        = io->next;
+
+        if (io->next) io->next->prev = io->prev;
+        else          q->tail        = io->prev;
+
+        if (!q->head)
+            sysblk.iointqmask &= ~(1 << io->bucket);
+
+        io->next   = io->prev = NULL;
+        io->queued = 0;
+        sysblk.iointstat.depth--;
+
+             if (io->pending)     io->dev->pending     = 0;
+        else if (io->pcipending)  io->dev->pcipending  = 0;
+        else if (io->attnpending) io->dev->attnpending = 0;
+
+        rc = 0;   /* I/O interrupt successfully dequeued */
     }
 #if 0 // (debugging example)
     if (sysblk.fishtest && io->dev->devnum == 0x0604)
@@ -6653,6 +6742,39 @@ int rc = -1;        /* No I/O interrupts were queued for this device */
     return rc;  /* rc=0: interrupt dequeued, rc=-1: NOTHING dequeued */
 }
 
+/*-------------------------------------------------------------------*/
+/*  Return the next queued I/O interrupt in presentation order, or   */
+/*  the first one if 'io' is NULL. sysblk.iointqlk must be held.     */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT IOINT* Next_IO_Interrupt_QLocked( IOINT* io )
+{
+    int  bucket;
+
+    if (io && io->next)
+        return io->next;
+
+    for (bucket = io ? io->bucket + 1 : 0; bucket < IOINTQ_BUCKETS; bucket++)
+        if (sysblk.iointqmask & (1 << bucket))
+            return sysblk.iointq[ bucket ].head;
+
+    return NULL;
+}
+
+/*-------------------------------------------------------------------*/
+/*  Record how long an I/O interrupt waited before being presented.  */
+/*  sysblk.iointqlk must be held.                                    */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT void Sample_IO_Interrupt_QLocked( IOINT* io )
+{
+    U64  usecs = (host_tod() - io->qtod) / ETOD_USEC;
+    int  bin;
+
+    for (bin=0; bin < IOINTQ_LAT_BINS-1 && (usecs >> bin); bin++);
+
+    sysblk.iointstat.latbin[ bin ]++;
+    sysblk.iointstat.presented++;
+}
+
 /*-------------------------------------------------------------------*/
 /*  NOTE: sysblk.iointqlk needed to examine sysblk.iointq.           */
 /*  sysblk.intlock (which MUST be held before calling these          */
@@ -6668,7 +6790,7 @@ DLL_EXPORT void Update_IC_IOPENDING()
 
 DLL_EXPORT void Update_IC_IOPENDING_QLocked()
 {
-    if (!sysblk.iointq)
+    if (!sysblk.iointqmask)
     {
         OFF_IC_IOPENDING;
     }
@@ -266,9 +266,23 @@ BYTE            serial[12+1] = {0};     /* Dasd serial number        */
     sfxptr--;
     sfxchar = *sfxptr;
 
+    /* Write-back and mapping are off unless requested */
+    dev->wback = 0;
+    dev->wbsync = DASD_WB_DEF_SYNC;
+    dev->dasdmapreq = dev->dasdmapped = 0;
+
     /* process the remaining arguments */
     for (i = 1; i < argc; i++)
     {
+        if ((rc = dasd_wb_parm( dev, DEVBUF_TYPE_CKD, argv[i] )) > 0
+         || (rc = dasd_map_parm( dev, argv[i] )) > 0)
+            continue;
+        if (rc < 0)
+        {
+            // "%1d:%04X CKD file: parameter %s in argument %d is invalid"
+            WRMSG( HHC00402, "E", LCSS_DEVNUM, argv[i], i + 1 );
+            return -1;
+        }
         if (strcasecmp ("lazywrite", argv[i]) == 0)
         {
             dev->ckdnolazywr = 0;
@@ -643,6 +657,18 @@ BYTE            serial[12+1] = {0};     /* Dasd serial number        */
     /* default for device cache is on */
     dev->devcache = TRUE;
 
+    /* Write-back only for uncompressed images that can be updated */
+    if (cckd || dev->ckdrdonly)
+        dev->wback = 0;
+
+    /* Map uncompressed images instead of caching them if requested */
+    if (!cckd && dev->dasdmapreq)
+    {
+        dasd_map_open (dev, DEVBUF_TYPE_CKD);
+        if (dev->dasdmapped)
+            dev->wback = 0;
+    }
+
     if (!cckd) return 0;
     else return cckd_dasd_init_handler(dev, argc, argv);
 
@@ -711,6 +737,1052 @@ DEVBLK         *dev = data;             /* -> device block           */
     return 0;
 }
 
+/*-------------------------------------------------------------------*/
+/* Write-back of uncompressed CKD and FBA images                     */
+/*                                                                   */
+/* With the "writeback" device option an updated track image (or    */
+/* FBA block group) is not written when the device moves off it or   */
+/* the channel program ends.  Its cache entry is flagged             */
+/* CKD_CACHE_WRITE instead, which keeps the entry from being reused, */
+/* and the write-back threads write the flagged images of a device   */
+/* in track order, adjacent images with a single pwritev.  An image  */
+/* being written is flagged CKD_CACHE_WRITING and a device that      */
+/* wants it back waits for the write to finish.                      */
+/*                                                                   */
+/* The image files are fdatasync'ed every "wbsync=n" seconds (0 =    */
+/* after every write), when the device is closed and by the          */
+/* "cckd wbflush" command.                                           */
+/*                                                                   */
+/* An image whose write fails stays pending and is flagged           */
+/* CKD_CACHE_WBFAIL.  It is written again every DASD_WB_RETRY        */
+/* seconds and when the device is flushed, and every write to the    */
+/* device gets an equipment check until it has been written.  If the */
+/* write still fails when the device is flushed the image is given   */
+/* up and an error message is issued.                                */
+/*                                                                   */
+/* dasdwb.lock is always obtained before the cache lock.             */
+/*-------------------------------------------------------------------*/
+
+typedef struct DASDWB_ENT {             /* Image being written back  */
+        int     ix;                     /* Cache index               */
+        int     trk;                    /* Track or block group      */
+        BYTE   *buf;                    /* -> Image                  */
+        int     len;                    /* Image length              */
+        BYTE    wasfail;                /* 1=An earlier write failed */
+        BYTE    failed;                 /* 1=This write failed       */
+} DASDWB_ENT;
+
+static struct {
+        LOCK    lock;                   /* Write-back lock           */
+        COND    wrcond;                 /* Signalled when queued     */
+        COND    donecond;               /* Signalled when written    */
+        DEVBLK *syncdev;                /* Device being fdatasync'ed */
+        int     inited;                 /* 1=Lock and conds inited   */
+        int     wrmax;                  /* Max writer threads        */
+        int     wrs;                    /* Writer threads started    */
+        int     wrwaiting;              /* Writers waiting for work  */
+        int     waiters;                /* Threads waiting for write */
+        int     pending;                /* Images waiting for write  */
+        U64     writes;                 /* Number of writes          */
+        U64     images;                 /* Images written            */
+        U64     bytes;                  /* Bytes written             */
+        U64     syncs;                  /* Number of fdatasyncs      */
+} dasdwb;
+
+static void dasd_wb_init()
+{
+    if (!dasdwb.inited)
+    {
+        initialize_lock( &dasdwb.lock );
+        initialize_condition( &dasdwb.wrcond );
+        initialize_condition( &dasdwb.donecond );
+        dasdwb.wrmax = DASD_WB_DEF_WRITER;
+        dasdwb.inited = 1;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/* Parse a write-back device option                                  */
+/*                                                                   */
+/* Returns 1 for "writeback" (or "wb") and "wbsync=n", 0 for any     */
+/* other option and -1 if the option is invalid.                     */
+/*-------------------------------------------------------------------*/
+int dasd_wb_parm( DEVBLK *dev, BYTE type, const char *parm )
+{
+int     n;                              /* wbsync value              */
+char    c;                              /* Trailing character        */
+
+    if (strcasecmp( "writeback", parm ) == 0
+     || strcasecmp( "wb",        parm ) == 0)
+    {
+#if defined( _MSVC_ )
+        /* (the writers need pwrite) */
+        return -1;
+#endif
+        dasd_wb_init();
+        dev->wback = type;
+        dev->wberrno = 0;
+        dev->wbsynctime = time( NULL );
+        return 1;
+    }
+
+    if (strncasecmp( "wbsync=", parm, 7 ) == 0)
+    {
+        if (sscanf( parm + 7, "%d%c", &n, &c ) != 1 || n < 0)
+            return -1;
+        dev->wbsync = n;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* Locate an image in the device's file(s)                           */
+/*-------------------------------------------------------------------*/
+static int dasd_wb_locate( DEVBLK *dev, int trk, off_t *off, int *len )
+{
+int     f;                              /* CKD file index            */
+
+    if (dev->wback == DEVBUF_TYPE_FBA)
+    {
+        *off = (off_t)((S64)trk * CFBA_BLKGRP_SIZE);
+        *len = dev->fbaend - *off < CFBA_BLKGRP_SIZE ?
+               (int)(dev->fbaend - *off) : CFBA_BLKGRP_SIZE;
+        return dev->fd;
+    }
+
+    for (f = 0; f < dev->ckdnumfd; f++)
+        if (trk < dev->ckdhitrk[f]) break;
+    *off = (off_t)(CKD_DEVHDR_SIZE +
+         ((U64)(trk - (f ? dev->ckdhitrk[f-1] : 0))) * dev->ckdtrksz);
+    *len = dev->ckdtrksz;
+    return dev->ckdfd[f];
+}
+
+/*-------------------------------------------------------------------*/
+/* Write `n' adjacent images starting at file offset `off'           */
+/*-------------------------------------------------------------------*/
+static int dasd_wb_pwrite( int fd, DASDWB_ENT *ent, int n, off_t off )
+{
+#if defined( _MSVC_ )
+    UNREFERENCED( fd ); UNREFERENCED( ent ); UNREFERENCED( n );
+    UNREFERENCED( off );
+    errno = ENOSYS;
+    return -1;
+#else
+ssize_t         done = 0;               /* Bytes of image written    */
+ssize_t         rc;                     /* Return code               */
+int             i;                      /* Image index               */
+#if defined( HAVE_PWRITEV )
+struct iovec    iov[ DASD_WB_MAX_IOV ]; /* Images to be written      */
+
+    for (i = 0; i < n; i++)
+    {
+        iov[i].iov_base = ent[i].buf;
+        iov[i].iov_len  = ent[i].len;
+    }
+    while ((done = pwritev( fd, iov, n, off )) < 0)
+        if (EINTR != errno)
+            return -1;
+#endif
+
+    /* Write whatever is left one image at a time */
+    for (i = 0; i < n; off += ent[i++].len)
+    {
+        if (done >= ent[i].len)
+        {
+            done -= ent[i].len;
+            continue;
+        }
+        while (done < ent[i].len)
+        {
+            rc = pwrite( fd, ent[i].buf + done, ent[i].len - done, off + done );
+            if (rc < 0)
+            {
+                if (EINTR == errno)
+                    continue;
+                return -1;
+            }
+            done += rc;
+        }
+        done = 0;
+    }
+    return 0;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/* fdatasync the device's file(s)                                    */
+/*-------------------------------------------------------------------*/
+static void dasd_wb_datasync( DEVBLK *dev )
+{
+int     f;                              /* CKD file index            */
+
+    if (dev->wback == DEVBUF_TYPE_FBA)
+        fdatasync( dev->fd );
+    else
+        for (f = 0; f < dev->ckdnumfd; f++)
+            fdatasync( dev->ckdfd[f] );
+}
+
+static int dasd_wb_cmp( const void *a, const void *b )
+{
+    return ((const DASDWB_ENT*)a)->trk - ((const DASDWB_ENT*)b)->trk;
+}
+
+/*-------------------------------------------------------------------*/
+/* Write the pending images of device `dev'                          */
+/*                                                                   */
+/* With `fail' 0 the images not tried yet are written, with          */
+/* CKD_CACHE_WBFAIL those whose earlier write failed.  Called and    */
+/* returns with dasdwb.lock held; returns 0 if nothing was written.  */
+/*-------------------------------------------------------------------*/
+static int dasd_wb_write_dev( DEVBLK *dev, U32 fail )
+{
+DASDWB_ENT     *ent;                    /* Images being written      */
+int             nbr;                    /* Number cache entries      */
+int             n = 0;                  /* Number images             */
+int             i, j;                   /* Indexes                   */
+U32             flag;                   /* Cache entry flags         */
+U16             d;                      /* Device number             */
+int             trk;                    /* Track or block group      */
+int             fd, fd2;                /* File descriptors          */
+off_t           off, off2;              /* File offsets              */
+int             len;                    /* Image length              */
+int             err = 0;                /* errno of failed write     */
+int             done = 0;               /* Images written            */
+int             failed = 0;             /* Images newly failed       */
+U64             bytes = 0;              /* Bytes written             */
+U64             writes = 0;             /* Number of writes          */
+
+    cache_lock( CACHE_DEVBUF );
+
+    nbr = cache_nbr( CACHE_DEVBUF );
+    if (!(ent = malloc( nbr * sizeof( DASDWB_ENT ))))
+    {
+        cache_unlock( CACHE_DEVBUF );
+        return 0;
+    }
+
+    /* Take all of the device's images that may be written */
+    for (i = 0; i < nbr; i++)
+    {
+        flag = cache_getflag( CACHE_DEVBUF, i );
+        if ((flag & (CKD_CACHE_WRITE|CKD_CACHE_WRITING|CKD_CACHE_ACTIVE
+                    |CKD_CACHE_WBFAIL)) != (CKD_CACHE_WRITE|fail)
+         || (flag & CACHE_TYPE) != dev->wback)
+            continue;
+        CKD_CACHE_GETKEY( i, d, trk );
+        if (d != dev->devnum
+         || cache_getval( CACHE_DEVBUF, i ) != SSID_TO_LCSS( dev->ssid ))
+            continue;
+        cache_setflag( CACHE_DEVBUF, i, ~0, CKD_CACHE_WRITING );
+        ent[n].ix  = i;
+        ent[n].trk = trk;
+        ent[n].buf = cache_getbuf( CACHE_DEVBUF, i, 0 );
+        ent[n].wasfail = (flag & CKD_CACHE_WBFAIL) ? 1 : 0;
+        ent[n].failed = 0;
+        n++;
+    }
+
+    cache_unlock( CACHE_DEVBUF );
+
+    if (!n)
+    {
+        free( ent );
+        return 0;
+    }
+
+    dev->wbwriting += n;
+
+    release_lock( &dasdwb.lock );
+
+    /* Write runs of adjacent images */
+    {
+        qsort( ent, n, sizeof( DASDWB_ENT ), dasd_wb_cmp );
+
+        for (i = 0; i < n; i = j)
+        {
+            fd = dasd_wb_locate( dev, ent[i].trk, &off, &ent[i].len );
+            len = ent[i].len;
+
+            for (j = i + 1; j < n && j - i < DASD_WB_MAX_IOV; j++)
+            {
+                if (ent[j].trk != ent[j-1].trk + 1)
+                    break;
+                fd2 = dasd_wb_locate( dev, ent[j].trk, &off2, &ent[j].len );
+                if (fd2 != fd || off2 != off + len)
+                    break;
+                len += ent[j].len;
+            }
+
+            writes++;
+            if (dasd_wb_pwrite( fd, ent + i, j - i, off ) < 0)
+            {
+                err = errno;
+                while (i < j)
+                    ent[i++].failed = 1;
+                continue;
+            }
+            bytes += len;
+            done += j - i;
+        }
+
+        if (err)
+        {
+            if (dev->wback == DEVBUF_TYPE_FBA)
+                // "%1d:%04X FBA file %s: error in function %s: %s"
+                WRMSG( HHC00502, "E", LCSS_DEVNUM,
+                       dev->filename, "pwritev()", strerror( err ));
+            else
+                // "%1d:%04X CKD file %s: error in function %s: %s"
+                WRMSG( HHC00404, "E", LCSS_DEVNUM,
+                       dev->filename, "pwritev()", strerror( err ));
+        }
+
+        if (done && !dev->wbsync)
+            dasd_wb_datasync( dev );
+    }
+
+    obtain_lock( &dasdwb.lock );
+
+    /* Written images are done with, the others stay pending */
+    cache_lock( CACHE_DEVBUF );
+    for (i = 0; i < n; i++)
+    {
+        if (!ent[i].failed)
+        {
+            cache_setflag( CACHE_DEVBUF, ent[i].ix,
+              ~(CKD_CACHE_WRITE|CKD_CACHE_WRITING|CKD_CACHE_WBFAIL), 0 );
+            if (ent[i].wasfail)
+                failed--;
+        }
+        else
+        {
+            cache_setflag( CACHE_DEVBUF, ent[i].ix,
+              ~CKD_CACHE_WRITING, CKD_CACHE_WBFAIL );
+            if (!ent[i].wasfail)
+                failed++;
+        }
+    }
+    cache_unlock( CACHE_DEVBUF );
+
+    dasdwb.pending -= done;
+    dasdwb.writes  += writes;
+    dasdwb.images  += done;
+    dasdwb.bytes   += bytes;
+
+    dev->wbwriting -= n;
+    dev->wbpending -= done;
+    dev->wbfailed  += failed;
+    if (err)
+    {
+        dev->wberrno = err;
+        dev->wbfailtime = time( NULL );
+    }
+    if (done && dev->wbsync)
+        dev->wbunsynced = 1;
+    else if (done)
+    {
+        dev->wbsynctime = time( NULL );
+        dasdwb.syncs++;
+    }
+
+    if (dasdwb.waiters)
+        broadcast_condition( &dasdwb.donecond );
+
+    free( ent );
+    return 1;
+}
+
+/*-------------------------------------------------------------------*/
+/* Write the pending images of one device                            */
+/*                                                                   */
+/* The device with the oldest pending image is chosen.  Called and   */
+/* returns with sysblk.config and dasdwb.lock held; returns 0 if     */
+/* nothing was written.                                              */
+/*-------------------------------------------------------------------*/
+static int dasd_wb_write()
+{
+DEVBLK         *dev;                    /* -> Device being written   */
+int             nbr;                    /* Number cache entries      */
+int             i, o = -1;              /* Indexes                   */
+U32             flag;                   /* Cache entry flags         */
+U32             type;                   /* DEVBUF_TYPE_CKD/FBA       */
+U16             lcss;                   /* Logical channel subsystem */
+U16             devnum;                 /* Device number             */
+int             trk;                    /* Track or block group      */
+
+    if (!dasdwb.pending)
+        return 0;
+
+    cache_lock( CACHE_DEVBUF );
+
+    /* Find the oldest image that may be written (the CCKD and shared
+       device entries use the same flag bits for their own purposes) */
+    nbr = cache_nbr( CACHE_DEVBUF );
+    for (i = 0; i < nbr; i++)
+    {
+        flag = cache_getflag( CACHE_DEVBUF, i );
+        if ((flag & (CKD_CACHE_WRITE|CKD_CACHE_WRITING|CKD_CACHE_ACTIVE
+                    |CKD_CACHE_WBFAIL)) == CKD_CACHE_WRITE
+         && ((flag & CACHE_TYPE) == DEVBUF_TYPE_CKD
+          || (flag & CACHE_TYPE) == DEVBUF_TYPE_FBA)
+         && (o < 0 || cache_getage( CACHE_DEVBUF, i )
+                    < cache_getage( CACHE_DEVBUF, o )))
+            o = i;
+    }
+
+    if (o < 0)
+    {
+        cache_unlock( CACHE_DEVBUF );
+        return 0;
+    }
+
+    CKD_CACHE_GETKEY( o, devnum, trk );
+    UNREFERENCED( trk ); // (silence "set but not used" warning)
+    type = cache_getflag( CACHE_DEVBUF, o ) & CACHE_TYPE;
+    lcss = cache_getval( CACHE_DEVBUF, o );
+
+    cache_unlock( CACHE_DEVBUF );
+
+    for (dev = sysblk.firstdev; dev; dev = dev->nextdev)
+        if (dev->allocated && dev->wback == type && dev->devnum == devnum
+         && SSID_TO_LCSS( dev->ssid ) == lcss)
+            break;
+
+    /* Without a device (which should not happen: a device is flushed
+       when it is closed) the image is kept, as there is nowhere to
+       write it */
+    if (!dev)
+    {
+        cache_lock( CACHE_DEVBUF );
+        if ((cache_getflag( CACHE_DEVBUF, o )
+             & (CKD_CACHE_WRITE|CKD_CACHE_WRITING|CKD_CACHE_ACTIVE
+               |CKD_CACHE_WBFAIL)) == CKD_CACHE_WRITE)
+            cache_setflag( CACHE_DEVBUF, o, ~0, CKD_CACHE_WBFAIL );
+        cache_unlock( CACHE_DEVBUF );
+        return 1;
+    }
+
+    return dasd_wb_write_dev( dev, 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/* Write again the images of devices whose retry interval expired    */
+/* (called and returns with sysblk.config and dasdwb.lock held)      */
+/*-------------------------------------------------------------------*/
+static void dasd_wb_retry_due()
+{
+DEVBLK *dev;                            /* -> Device block           */
+time_t  now = time( NULL );             /* Current time              */
+
+    for (dev = sysblk.firstdev; dev; dev = dev->nextdev)
+    {
+        if (!dev->allocated || !dev->wback || !dev->wbfailed
+         || now - dev->wbfailtime < DASD_WB_RETRY)
+            continue;
+
+        dev->wbfailtime = now;
+        dasd_wb_write_dev( dev, CKD_CACHE_WBFAIL );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/* Give up the device's images that could not be written             */
+/* (called and returns with dasdwb.lock held)                        */
+/*-------------------------------------------------------------------*/
+static void dasd_wb_discard( DEVBLK *dev )
+{
+int     nbr;                            /* Number cache entries      */
+int     n = 0;                          /* Images given up           */
+int     i;                              /* Cache index               */
+U32     flag;                           /* Cache entry flags         */
+U16     devnum;                         /* Device number             */
+int     trk;                            /* Track or block group      */
+char    msgbuf[64];                     /* Message text              */
+
+    cache_lock( CACHE_DEVBUF );
+    nbr = cache_nbr( CACHE_DEVBUF );
+    for (i = 0; i < nbr; i++)
+    {
+        flag = cache_getflag( CACHE_DEVBUF, i );
+        if ((flag & (CKD_CACHE_WRITING|CKD_CACHE_ACTIVE|CKD_CACHE_WBFAIL))
+                 != CKD_CACHE_WBFAIL
+         || (flag & CACHE_TYPE) != dev->wback)
+            continue;
+        CKD_CACHE_GETKEY( i, devnum, trk );
+        UNREFERENCED( trk ); // (silence "set but not used" warning)
+        if (devnum != dev->devnum
+         || cache_getval( CACHE_DEVBUF, i ) != SSID_TO_LCSS( dev->ssid ))
+            continue;
+        cache_setflag( CACHE_DEVBUF, i, ~(CKD_CACHE_WRITE|CKD_CACHE_WBFAIL), 0 );
+        n++;
+    }
+    cache_unlock( CACHE_DEVBUF );
+
+    if (!n)
+        return;
+
+    dev->wbfailed  -= n;
+    dev->wbpending -= n;
+    dasdwb.pending -= n;
+
+    if (dev->wback == DEVBUF_TYPE_FBA)
+    {
+        MSGBUF( msgbuf, "%d block groups not written", n );
+        // "%1d:%04X FBA file %s: error in function %s: %s"
+        WRMSG( HHC00502, "E", LCSS_DEVNUM,
+               dev->filename, "dasd_wb_flush()", msgbuf );
+    }
+    else
+    {
+        MSGBUF( msgbuf, "%d track images not written", n );
+        // "%1d:%04X CKD file %s: error in function %s: %s"
+        WRMSG( HHC00404, "E", LCSS_DEVNUM,
+               dev->filename, "dasd_wb_flush()", msgbuf );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/* fdatasync devices whose "wbsync=n" interval has expired           */
+/* (called and returns with sysblk.config and dasdwb.lock held)      */
+/*-------------------------------------------------------------------*/
+static void dasd_wb_sync_due()
+{
+DEVBLK *dev;                            /* -> Device block           */
+time_t  now = time( NULL );             /* Current time              */
+
+    for (dev = sysblk.firstdev; dev; dev = dev->nextdev)
+    {
+        if (!dev->allocated || !dev->wback || !dev->wbunsynced
+         || now - dev->wbsynctime < dev->wbsync)
+            continue;
+
+        dev->wbunsynced = 0;
+        dev->wbsynctime = now;
+        dasdwb.syncdev = dev;
+        release_lock( &dasdwb.lock );
+        {
+            dasd_wb_datasync( dev );
+        }
+        obtain_lock( &dasdwb.lock );
+        dasdwb.syncdev = NULL;
+        dasdwb.syncs++;
+
+        if (dasdwb.waiters)
+            broadcast_condition( &dasdwb.donecond );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/* Write-back thread                                                 */
+/*-------------------------------------------------------------------*/
+static void* dasd_wb_writer( void *arg )
+{
+char    threadname[40];                 /* Thread name               */
+int     wrote;                          /* 1=images were written     */
+
+    MSGBUF( threadname, "dasd_wb_writer %d", (int)(uintptr_t) arg );
+
+    obtain_lock( &dasdwb.lock );
+
+    // "Thread id "TIDPAT", prio %d, name '%s' started"
+    LOG_THREAD_BEGIN( threadname );
+
+    while (dasdwb.wrs <= dasdwb.wrmax)
+    {
+        /* The device list is walked with sysblk.config held, which is
+           obtained first (a device is closed and flushed with it held) */
+        release_lock( &dasdwb.lock );
+        obtain_lock( &sysblk.config );
+        obtain_lock( &dasdwb.lock );
+
+        if (!(wrote = dasd_wb_write()))
+        {
+            dasd_wb_retry_due();
+            dasd_wb_sync_due();
+        }
+
+        release_lock( &sysblk.config );
+
+        if (wrote)
+            continue;
+
+        dasdwb.wrwaiting++;
+        timed_wait_condition_relative_usecs( &dasdwb.wrcond,
+            &dasdwb.lock, 1000000, NULL );
+        dasdwb.wrwaiting--;
+    }
+
+    dasdwb.wrs--;
+
+    release_lock( &dasdwb.lock );
+
+    // "Thread id "TIDPAT", prio %d, name '%s' ended"
+    LOG_THREAD_END( threadname );
+    return NULL;
+}
+
+/*-------------------------------------------------------------------*/
+/* Queue the updated image in cache entry `ix' for write-back        */
+/*                                                                   */
+/* The entry is also made inactive: the device is done with it.      */
+/*-------------------------------------------------------------------*/
+void dasd_wb_queue( DEVBLK *dev, int ix )
+{
+TID     tid;                            /* Writer thread id          */
+int     rc;                             /* Return code               */
+
+    obtain_lock( &dasdwb.lock );
+
+    cache_lock( CACHE_DEVBUF );
+    cache_setval( CACHE_DEVBUF, ix, SSID_TO_LCSS( dev->ssid ));
+    if (!(cache_setflag( CACHE_DEVBUF, ix, ~CKD_CACHE_ACTIVE,
+                         CKD_CACHE_WRITE ) & CKD_CACHE_WRITE))
+    {
+        dev->wbpending++;
+        dasdwb.pending++;
+    }
+    cache_unlock( CACHE_DEVBUF );
+
+    if (dasdwb.wrwaiting)
+        signal_condition( &dasdwb.wrcond );
+    else if (dasdwb.wrs < dasdwb.wrmax)
+    {
+        ++dasdwb.wrs;
+
+        /* Release lock across thread create to prevent interlock  */
+        release_lock( &dasdwb.lock );
+        {
+            rc = create_thread( &tid, DETACHED, dasd_wb_writer,
+                                (void*)(uintptr_t) dasdwb.wrs,
+                                "dasd_wb_writer" );
+        }
+        obtain_lock( &dasdwb.lock );
+
+        if (rc)
+        {
+            // "Error in function create_thread() for %s %d of %d: %s"
+            WRMSG( HHC00106, "E", "dasd_wb_writer()",
+                   dasdwb.wrs-1, dasdwb.wrmax, strerror( rc ));
+            --dasdwb.wrs;
+        }
+    }
+
+    release_lock( &dasdwb.lock );
+}
+
+/*-------------------------------------------------------------------*/
+/* Wait for cache entry `ix' to be written back                      */
+/*-------------------------------------------------------------------*/
+void dasd_wb_wait( int ix )
+{
+    obtain_lock( &dasdwb.lock );
+    while (cache_getflag( CACHE_DEVBUF, ix ) & CKD_CACHE_WRITING)
+    {
+        dasdwb.waiters++;
+        wait_condition( &dasdwb.donecond, &dasdwb.lock );
+        dasdwb.waiters--;
+    }
+    release_lock( &dasdwb.lock );
+}
+
+/*-------------------------------------------------------------------*/
+/* Return the errno of a failed write-back                           */
+/*                                                                   */
+/* It is reset once no image of the device is left unwritten.        */
+/*-------------------------------------------------------------------*/
+int dasd_wb_error( DEVBLK *dev )
+{
+int     err;                            /* errno of failed write     */
+
+    if (!dev->wback)
+        return 0;
+
+    obtain_lock( &dasdwb.lock );
+    err = dev->wberrno;
+    if (!dev->wbfailed)
+        dev->wberrno = 0;
+    release_lock( &dasdwb.lock );
+
+    return err;
+}
+
+/*-------------------------------------------------------------------*/
+/* Write out and fdatasync the device's pending images               */
+/*                                                                   */
+/* Images whose write failed are tried once more and then given up.  */
+/*-------------------------------------------------------------------*/
+void dasd_wb_flush( DEVBLK *dev )
+{
+int     sync;                           /* 1=fdatasync needed        */
+
+    if (!dev->wback)
+        return;
+
+    obtain_lock( &dasdwb.lock );
+
+    if (dev->wbfailed)
+        dasd_wb_write_dev( dev, CKD_CACHE_WBFAIL );
+
+    while (dev->wbpending > dev->wbfailed || dev->wbwriting
+        || dasdwb.syncdev == dev)
+    {
+        /* Write them here rather than wait for the writer threads,
+           which need sysblk.config that our caller may be holding */
+        if (dasd_wb_write_dev( dev, 0 ))
+            continue;
+
+        /* (an image still active on another thread is queued again
+            at the end of its channel program, so check periodically) */
+        dasdwb.waiters++;
+        timed_wait_condition_relative_usecs( &dasdwb.donecond,
+            &dasdwb.lock, 1000000, NULL );
+        dasdwb.waiters--;
+    }
+
+    if (dev->wbfailed)
+        dasd_wb_discard( dev );
+
+    sync = dev->wbunsynced;
+    dev->wbunsynced = 0;
+    dev->wbsynctime = time( NULL );
+    if (sync)
+        dasdwb.syncs++;
+
+    release_lock( &dasdwb.lock );
+
+    if (sync)
+        dasd_wb_datasync( dev );
+}
+
+/*-------------------------------------------------------------------*/
+/* Write out and sync the pending and mapped images of all devices   */
+/*-------------------------------------------------------------------*/
+void dasd_wb_flush_all()
+{
+DEVBLK *dev;                            /* -> Device block           */
+int     have_config_lock = have_lock( &sysblk.config );
+
+    if (!have_config_lock)
+        obtain_lock( &sysblk.config );
+
+    for (dev = sysblk.firstdev; dev; dev = dev->nextdev)
+    {
+        if (dev->allocated && dev->wback)
+            dasd_wb_flush( dev );
+        if (dev->allocated && dev->dasdmapped)
+            dasd_map_sync( dev );
+    }
+
+    if (!have_config_lock)
+        release_lock( &sysblk.config );
+}
+
+/*-------------------------------------------------------------------*/
+/* Set the maximum number of write-back threads (if `wrmax' >= 0)    */
+/* and return it                                                     */
+/*-------------------------------------------------------------------*/
+int dasd_wb_writers( int wrmax )
+{
+    dasd_wb_init();
+
+    obtain_lock( &dasdwb.lock );
+    if (wrmax >= 0)
+    {
+        dasdwb.wrmax = wrmax;
+        broadcast_condition( &dasdwb.wrcond );
+    }
+    wrmax = dasdwb.wrmax;
+    release_lock( &dasdwb.lock );
+
+    return wrmax;
+}
+
+/*-------------------------------------------------------------------*/
+/* Return the write-back statistics                                  */
+/*-------------------------------------------------------------------*/
+void dasd_wb_stats( U64 *writes, U64 *images, U64 *bytes, U64 *syncs )
+{
+    dasd_wb_init();
+
+    obtain_lock( &dasdwb.lock );
+    *writes = dasdwb.writes;
+    *images = dasdwb.images;
+    *bytes  = dasdwb.bytes;
+    *syncs  = dasdwb.syncs;
+    release_lock( &dasdwb.lock );
+}
+
+/*-------------------------------------------------------------------*/
+/* Memory-mapped uncompressed CKD and FBA images                     */
+/*                                                                   */
+/* With the "mmap" device option the image files are mapped and the  */
+/* read exits point dev->buf straight at the track image (or FBA     */
+/* block group) in the mapping instead of reading it into a cache    */
+/* entry.  CCWs then copy between the mapping and guest storage.     */
+/*                                                                   */
+/* The mapping is advised MADV_RANDOM so that a random track read    */
+/* faults in only its own pages.  Once DASD_MAP_SEQ images have been */
+/* read in order the following DASD_MAP_AHEAD images are advised     */
+/* MADV_WILLNEED, and again each time the reader gets halfway        */
+/* through them.                                                     */
+/*                                                                   */
+/* Updates are made in place.  The updated range is msync'ed with    */
+/* MS_ASYNC when the device moves off the image, and the whole       */
+/* mapping with MS_SYNC every "wbsync=n" seconds, when the device is */
+/* closed and by the "cckd wbflush" command.                         */
+/*                                                                   */
+/* A read-only image is only mapped if the device rejects writes.    */
+/*-------------------------------------------------------------------*/
+
+/*-------------------------------------------------------------------*/
+/* Parse the mmap device option                                      */
+/*                                                                   */
+/* Returns 1 for "mmap", 0 for any other option and -1 if mapping is */
+/* not supported on this host.                                       */
+/*-------------------------------------------------------------------*/
+int dasd_map_parm( DEVBLK *dev, const char *parm )
+{
+    if (strcasecmp( "mmap", parm ) != 0)
+        return 0;
+#if !defined( HAVE_SYS_MMAN_H )
+    UNREFERENCED( dev );
+    return -1;
+#else
+    dasd_wb_init();
+    dev->dasdmapreq = 1;
+    return 1;
+#endif
+}
+
+#if defined( HAVE_SYS_MMAN_H )
+/*-------------------------------------------------------------------*/
+/* madvise `len' bytes at offset `off' of mapping `f'                */
+/*-------------------------------------------------------------------*/
+static void dasd_map_advise( DEVBLK *dev, int f, U64 off, U64 len,
+                             int advice )
+{
+static long     pagesz;                 /* Host page size            */
+U64             lo;                     /* Page aligned offset       */
+
+    if (!pagesz)
+        pagesz = sysconf( _SC_PAGESIZE );
+
+    if (off >= dev->dasdmaplen[f])
+        return;
+    if (off + len > dev->dasdmaplen[f])
+        len = dev->dasdmaplen[f] - off;
+
+    lo = off & ~((U64)pagesz - 1);
+    madvise( dev->dasdmap[f] + lo, (size_t)(off + len - lo), advice );
+}
+
+/*-------------------------------------------------------------------*/
+/* msync the image files (caller holds dasdwb.lock)                  */
+/*-------------------------------------------------------------------*/
+static void dasd_map_msync( DEVBLK *dev )
+{
+int     f;                              /* Mapping index             */
+
+    for (f = 0; f < CKD_MAXFILES; f++)
+        if (dev->dasdmap[f])
+            msync( dev->dasdmap[f], (size_t)dev->dasdmaplen[f], MS_SYNC );
+
+    dev->dasdmapdirty = 0;
+    dev->wbsynctime = time( NULL );
+}
+#endif // defined( HAVE_SYS_MMAN_H )
+
+/*-------------------------------------------------------------------*/
+/* Map the device's image file(s) if the mmap option was specified   */
+/*                                                                   */
+/* `type' is DEVBUF_TYPE_CKD or DEVBUF_TYPE_FBA.  The device is left */
+/* unmapped, with a warning, if any file cannot be mapped.           */
+/*-------------------------------------------------------------------*/
+void dasd_map_open( DEVBLK *dev, BYTE type )
+{
+#if !defined( HAVE_SYS_MMAN_H )
+    UNREFERENCED( dev );
+    UNREFERENCED( type );
+#else
+int     nfd;                            /* Number of image files     */
+int     f;                              /* File index                */
+int     fd;                             /* File descriptor           */
+int     prot;                           /* Mapping protection        */
+off_t   len;                            /* File length               */
+void   *map;                            /* -> Mapping                */
+const char *why = NULL;                 /* Reason not mapped         */
+
+    dev->dasdmapped = 0;
+    dev->dasdmapnext = dev->dasdmapseq = dev->dasdmapwill = 0;
+    dev->dasdmapdirty = 0;
+
+    if (!dev->dasdmapreq)
+        return;
+
+    nfd = type == DEVBUF_TYPE_FBA ? 1 : dev->ckdnumfd;
+
+    for (f = 0; f < nfd && !why; f++)
+    {
+        fd = type == DEVBUF_TYPE_FBA ? dev->fd : dev->ckdfd[f];
+
+        prot = PROT_READ | PROT_WRITE;
+        if ((fcntl( fd, F_GETFL ) & O_ACCMODE) == O_RDONLY)
+        {
+            if (type != DEVBUF_TYPE_CKD || !dev->ckdrdonly)
+            {
+                why = "file opened read-only";
+                break;
+            }
+            prot = PROT_READ;
+        }
+
+        if ((len = lseek( fd, 0, SEEK_END )) <= 0)
+        {
+            why = len < 0 ? strerror( errno ) : "empty file";
+            break;
+        }
+
+        map = mmap( NULL, (size_t)len, prot, MAP_SHARED, fd, 0 );
+        if (map == MAP_FAILED)
+        {
+            why = strerror( errno );
+            break;
+        }
+
+        dev->dasdmap[f] = map;
+        dev->dasdmaplen[f] = (U64)len;
+        dasd_map_advise( dev, f, 0, (U64)len, MADV_RANDOM );
+    }
+
+    if (why)
+    {
+        // "%1d:%04X %s file %s: not mapped: %s"
+        WRMSG( HHC00477, "W", LCSS_DEVNUM,
+               type == DEVBUF_TYPE_FBA ? "FBA" : "CKD", dev->filename, why );
+        dasd_map_close( dev );
+        return;
+    }
+
+    dev->dasdmapped = type;
+    dev->wbsynctime = time( NULL );
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/* Return a pointer to the `len' byte image `img' at offset `off' of */
+/* mapped file `f', or NULL if it is not within the mapping          */
+/*-------------------------------------------------------------------*/
+BYTE *dasd_map_image( DEVBLK *dev, int f, U64 off, int len, int img )
+{
+#if !defined( HAVE_SYS_MMAN_H )
+    UNREFERENCED( dev ); UNREFERENCED( f ); UNREFERENCED( off );
+    UNREFERENCED( len ); UNREFERENCED( img );
+    return NULL;
+#else
+U64     ahead;                          /* First image to advise     */
+
+    if (!dev->dasdmapped || !dev->dasdmap[f]
+     || off + len > dev->dasdmaplen[f])
+        return NULL;
+
+    /* Read ahead while the images are read in order */
+    if (img == dev->dasdmapnext)
+        dev->dasdmapseq++;
+    else
+        dev->dasdmapseq = dev->dasdmapwill = 0;
+    dev->dasdmapnext = img + 1;
+
+    if (dev->dasdmapseq >= DASD_MAP_SEQ
+     && img + DASD_MAP_AHEAD / 2 >= dev->dasdmapwill)
+    {
+        ahead = img + 1 > dev->dasdmapwill ? img + 1 : dev->dasdmapwill;
+        dasd_map_advise( dev, f, off + (ahead - img) * len,
+                         (U64)(img + 1 + DASD_MAP_AHEAD - ahead) * len,
+                         MADV_WILLNEED );
+        dev->dasdmapwill = img + 1 + DASD_MAP_AHEAD;
+    }
+
+    return dev->dasdmap[f] + off;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/* Schedule the write of `len' updated bytes at `buf' in a mapping   */
+/*-------------------------------------------------------------------*/
+void dasd_map_update( DEVBLK *dev, BYTE *buf, int len )
+{
+#if !defined( HAVE_SYS_MMAN_H )
+    UNREFERENCED( dev ); UNREFERENCED( buf ); UNREFERENCED( len );
+#else
+static long     pagesz;                 /* Host page size            */
+BYTE           *lo;                     /* Page aligned address      */
+
+    if (!pagesz)
+        pagesz = sysconf( _SC_PAGESIZE );
+
+    lo = (BYTE*)((uintptr_t)buf & ~((uintptr_t)pagesz - 1));
+    msync( lo, (size_t)(buf + len - lo), MS_ASYNC );
+
+    obtain_lock( &dasdwb.lock );
+    dev->dasdmapdirty = 1;
+    if (time( NULL ) - dev->wbsynctime >= dev->wbsync)
+    {
+        dasd_map_msync( dev );
+        dasdwb.syncs++;
+    }
+    release_lock( &dasdwb.lock );
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/* msync the device's mapped image file(s) if they were updated      */
+/*-------------------------------------------------------------------*/
+void dasd_map_sync( DEVBLK *dev )
+{
+#if !defined( HAVE_SYS_MMAN_H )
+    UNREFERENCED( dev );
+#else
+    if (!dev->dasdmapped)
+        return;
+
+    obtain_lock( &dasdwb.lock );
+    if (dev->dasdmapped && dev->dasdmapdirty)
+    {
+        dasd_map_msync( dev );
+        dasdwb.syncs++;
+    }
+    release_lock( &dasdwb.lock );
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/* Sync and unmap the device's image file(s)                         */
+/*-------------------------------------------------------------------*/
+void dasd_map_close( DEVBLK *dev )
+{
+#if !defined( HAVE_SYS_MMAN_H )
+    UNREFERENCED( dev );
+#else
+int     f;                              /* Mapping index             */
+
+    dasd_map_sync( dev );
+
+    obtain_lock( &dasdwb.lock );
+    for (f = 0; f < CKD_MAXFILES; f++)
+    {
+        if (dev->dasdmap[f])
+            munmap( dev->dasdmap[f], (size_t)dev->dasdmaplen[f] );
+        dev->dasdmap[f] = NULL;
+        dev->dasdmaplen[f] = 0;
+    }
+    dev->dasdmapped = 0;
+    release_lock( &dasdwb.lock );
+#endif
+}
 
 static int ckd_dasd_read_track (DEVBLK *dev, int trk, BYTE *unitstat);
 /*-------------------------------------------------------------------*/
@@ -724,6 +1796,17 @@ BYTE    unitstat;                       /* Unit Status               */
     /* Write the last track image if it's modified */
     (dev->hnd->read) (dev, -1, &unitstat);
 
+    /* Wait for the track images still being written back */
+    if (dev->wback)
+    {
+        dasd_wb_flush( dev );
+        dev->wback = 0;
+    }
+
+    /* Sync and unmap mapped image files */
+    if (dev->dasdmapped)
+        dasd_map_close( dev );
+
     /* Free the cache */
     cache_lock(CACHE_DEVBUF);
     cache_scan(CACHE_DEVBUF, ckddasd_purge_cache, dev);
@@ -787,6 +1870,65 @@ int ckd_trklen (DEVBLK *dev, BYTE *buf)
     return sz;
 }
 
+/*-------------------------------------------------------------------*/
+/* Point dev->buf at a track image in the mapped image file          */
+/*                                                                   */
+/* Returns 1 if the track is not within the mapping, in which case   */
+/* it is read into the cache as usual.                               */
+/*-------------------------------------------------------------------*/
+static
+int ckd_dasd_map_track (DEVBLK *dev, int trk, BYTE *unitstat)
+{
+int             cyl, head;              /* Cylinder and head         */
+int             f;                      /* File index                */
+BYTE           *buf;                    /* -> Mapped track image     */
+CKD_TRKHDR     *trkhdr;                 /* -> Track header           */
+
+    /* Set the file descriptor */
+    for (f = 0; f < dev->ckdnumfd; f++)
+        if (trk < dev->ckdhitrk[f]) break;
+    if (f >= dev->ckdnumfd)
+        return 1;
+
+    /* Calculate the track offset */
+    dev->fd = dev->ckdfd[f];
+    dev->ckdtrkoff = (U64)(CKD_DEVHDR_SIZE +
+         ((U64)(trk - (f ? dev->ckdhitrk[f-1] : 0))) * dev->ckdtrksz);
+
+    buf = dasd_map_image (dev, f, dev->ckdtrkoff, dev->ckdtrksz, trk);
+    if (buf == NULL)
+        return 1;
+
+    /* Validate the track header */
+    cyl  = trk / dev->ckdheads;
+    head = trk % dev->ckdheads;
+    trkhdr = (CKD_TRKHDR*)buf;
+    if (0
+        || trkhdr->bin              != 0
+        || fetch_hw( trkhdr->cyl  ) != cyl
+        || fetch_hw( trkhdr->head ) != head
+    )
+    {
+        // "%1d:%04X CKD file %s: invalid track header for cyl %d head %d %02X %02X%02X %02X%02X"
+        WRMSG( HHC00418, "E", LCSS_DEVNUM,
+               dev->filename, cyl, head, trkhdr->bin,
+               trkhdr->cyl[0], trkhdr->cyl[1],
+               trkhdr->head[0], trkhdr->head[1] );
+        ckd_build_sense (dev, 0, SENSE1_ITF, 0, 0, 0);
+        *unitstat = CSW_CE | CSW_DE | CSW_UC;
+        return -1;
+    }
+
+    dev->buf = buf;
+    dev->bufcur = trk;
+    dev->bufoff = 0;
+    dev->bufoffhi = dev->ckdtrksz;
+    dev->buflen = ckd_trklen (dev, dev->buf);
+    dev->bufsize = dev->ckdtrksz;
+
+    return 0;
+} /* end function ckd_dasd_map_track */
+
 /*-------------------------------------------------------------------*/
 /* Read a track image                                                */
 /*-------------------------------------------------------------------*/
@@ -821,6 +1963,23 @@ CKD_TRKHDR     *trkhdr;                 /* -> New track header       */
     if (trk >= 0 && trk == dev->bufcur)
         return 0;
 
+    /* The previous track image was updated in the mapping */
+    if (dev->bufupd && dev->dasdmapped && dev->cache < 0)
+    {
+        dev->bufupd = 0;
+        dasd_map_update( dev, dev->buf + dev->bufupdlo,
+                         dev->bufupdhi - dev->bufupdlo );
+        dev->bufupdlo = dev->bufupdhi = 0;
+    }
+
+    /* Leave the previous track image to the write-back threads */
+    if (dev->bufupd && dev->wback)
+    {
+        dev->bufupd = 0;
+        dev->bufupdlo = dev->bufupdhi = 0;
+        dasd_wb_queue( dev, dev->cache );
+    }
+
     /* Write the previous track image if modified */
     if (dev->bufupd)
     {
@@ -889,6 +2048,16 @@ CKD_TRKHDR     *trkhdr;                 /* -> New track header       */
         return 0;
     }
 
+    /* Point into the mapped image file if there is one */
+    if (dev->dasdmapped && !dev->dasdcopy)
+    {
+        cache_unlock (CACHE_DEVBUF);
+        rc = ckd_dasd_map_track (dev, trk, unitstat);
+        if (rc <= 0)
+            return rc;
+        cache_lock (CACHE_DEVBUF);
+    }
+
 ckd_read_track_retry:
 
     /* Search the cache */
@@ -897,6 +2066,15 @@ ckd_read_track_retry:
     /* Cache hit */
     if (i >= 0)
     {
+        /* Wait if the track image is being written back */
+        if (cache_getflag(CACHE_DEVBUF, i) & CKD_CACHE_WRITING)
+        {
+            cache_unlock(CACHE_DEVBUF);
+            dasd_wb_wait(i);
+            cache_lock(CACHE_DEVBUF);
+            goto ckd_read_track_retry;
+        }
+
         cache_setflag(CACHE_DEVBUF, i, ~0, CKD_CACHE_ACTIVE);
         cache_setage(CACHE_DEVBUF, i);
         cache_unlock(CACHE_DEVBUF);
@@ -1084,6 +2262,15 @@ int             rc;                     /* Return code               */
         return -1;
     }
 
+    /* Equipment check if a track image could not be written back */
+    if (dasd_wb_error (dev))
+    {
+        ckd_build_sense (dev, SENSE_EC, 0, 0,
+                        FORMAT_1, MESSAGE_0);
+        *unitstat = CSW_CE | CSW_DE | CSW_UC;
+        return -1;
+    }
+
     /* Read the track if it's not current */
     if (trk != dev->bufcur)
     {
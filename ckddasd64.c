@@ -124,9 +124,23 @@ BYTE            serial[12+1] = {0};     /* Dasd serial number        */
     sfxptr--;
     sfxchar = *sfxptr;
 
+    /* Write-back and mapping are off unless requested */
+    dev->wback = 0;
+    dev->wbsync = DASD_WB_DEF_SYNC;
+    dev->dasdmapreq = dev->dasdmapped = 0;
+
     /* process the remaining arguments */
     for (i = 1; i < argc; i++)
     {
+        if ((rc = dasd_wb_parm( dev, DEVBUF_TYPE_CKD, argv[i] )) > 0
+         || (rc = dasd_map_parm( dev, argv[i] )) > 0)
+            continue;
+        if (rc < 0)
+        {
+            // "%1d:%04X CKD file: parameter %s in argument %d is invalid"
+            WRMSG( HHC00402, "E", LCSS_DEVNUM, argv[i], i + 1 );
+            return -1;
+        }
         if (strcasecmp ("lazywrite", argv[i]) == 0)
         {
             dev->ckdnolazywr = 0;
@@ -501,6 +515,18 @@ BYTE            serial[12+1] = {0};     /* Dasd serial number        */
     /* default for device cache is on */
     dev->devcache = TRUE;
 
+    /* Write-back only for uncompressed images that can be updated */
+    if (cckd || dev->ckdrdonly)
+        dev->wback = 0;
+
+    /* Map uncompressed images instead of caching them if requested */
+    if (!cckd && dev->dasdmapreq)
+    {
+        dasd_map_open (dev, DEVBUF_TYPE_CKD);
+        if (dev->dasdmapped)
+            dev->wback = 0;
+    }
+
     if (!cckd) return 0;
     else return cckd64_dasd_init_handler(dev, argc, argv);
 
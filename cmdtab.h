@@ -108,6 +108,27 @@
   "double quotes.\n"
 
 #define aea_cmd_desc            "Display AEA tables"
+#define affinity_cmd_desc       "Bind CPU, device and service threads to host CPUs"
+#define affinity_cmd_help       \
+                                \
+  "Format:\n"                                                                   \
+  "\n"                                                                          \
+  "     AFFINITY  CPU {n|ALL}  {list|NONE}\n"                                   \
+  "     AFFINITY  {DEV|TOD|SRV}  {list|NONE}\n"                                 \
+  "     AFFINITY  MAINSTOR  {INTERLEAVE|BIND} nodes\n"                          \
+  "     AFFINITY  MAINSTOR  DEFAULT\n"                                          \
+  "\n"                                                                          \
+  "Restricts the emulated CPU threads ('n' is the hexadecimal CPU number),\n"   \
+  "the device (I/O) threads, the TOD clock/timer threads and the CCKD\n"        \
+  "readahead, writer and garbage collector threads (SRV) to the given set\n"    \
+  "of host CPUs. 'list' is a list of host CPU numbers and ranges such as\n"     \
+  "0-3,8,10-11. NONE lets the threads run on any host CPU again.\n"             \
+  "\n"                                                                          \
+  "MAINSTOR places main storage on the given host NUMA nodes, either\n"         \
+  "interleaved across them or bound to them. Storage already in use is\n"       \
+  "migrated. DEFAULT restores the host's first-touch placement.\n"              \
+  "\n"                                                                          \
+  "Enter AFFINITY without arguments to display the current settings.\n"
 #define aia_cmd_desc            "Display AIA fields"
 #define alrf_cmd_desc           "Command deprecated. Use facility command instead"
 #define ar_cmd_desc             "Display access registers"
@@ -396,10 +417,11 @@
   "cancelled. Otherwise the specific script 'id' is canceled. The 'script'\n"   \
   "command may be used to display a list of all currently running scripts.\n"
 
-#define ctc_cmd_desc            "Enable/Disable CTC debugging"
+#define ctc_cmd_desc            "Enable/Disable CTC debugging or benchmark CTCE"
 #define ctc_cmd_help            \
                                 \
   "Format:  \"ctc  debug  [ on | off | startup  [ <devnum> | ALL ]]\".\n"       \
+  "         \"ctc  bench  [ <count> ]\".\n"                                     \
   "\n"                                                                          \
   "Enables/disables debug packet tracing for the specified CTCI/LCS/PTP/CTCE\n" \
   "device group(s) identified by <devnum> or for all CTCI/LCS/PTP/CTCE device\n"\
@@ -408,7 +430,24 @@
   "Note: only CTCE devices support 'startup' debugging.\n"                      \
   "\n"                                                                          \
   "Use the command \"ctc debug\" (without any other operands) to list the\n"    \
-  "current CTC debugging state for all CTC devices.\n"
+  "current CTC debugging state for all CTC devices.\n"                          \
+  "\n"                                                                          \
+  "\"ctc bench\" times <count> (default 10000) CTCE-sized round trips and\n"    \
+  "maximum size writes over a TCP loopback connection and, on Linux, over\n"    \
+  "the shared memory rings used by CTCE devices defined with SHM.\n"
+
+#define d250stats_cmd_desc      "Display DIAGNOSE X'250' block I/O statistics"
+#define d250stats_cmd_help      \
+                                \
+  "Format:  \"d250stats  [ <devnum> | ALL ]\"\n"                                \
+  "\n"                                                                          \
+  "Displays, for the specified device or for all devices that have done\n"      \
+  "DIAGNOSE X'250' block I/O, the number of block I/O requests and how\n"       \
+  "many of them were asynchronous, the number of asynchronous requests\n"       \
+  "queued now and at most, and the average time they spent queued before\n"     \
+  "a block I/O worker thread started them.  The number of blocks read and\n"    \
+  "written is shown with the number of device driver calls it took, the\n"      \
+  "blocks of BIOE's for contiguous blocks being read or written together.\n"
 
 #define define_cmd_desc         "Rename device"
 #define define_cmd_help         \
@@ -625,9 +664,13 @@
   "Format: \"hao  tgt <tgt> | cmd <cmd> | list <n> | del <n> | clear \".\n"     \
   "  hao tgt <tgt> : define target rule (regex pattern) to react on\n"          \
   "  hao cmd <cmd> : define command for previously defined rule\n"              \
-  "  hao list <n>  : list all rules/commands or only at index <n>\n"            \
+  "  hao list <n>  : list all rules/commands/hits or only at index <n>\n"       \
   "  hao del <n>   : delete the rule at index <n>\n"                            \
-  "  hao clear     : delete all rules (stops automatic operator)\n"
+  "  hao clear     : delete all rules (stops automatic operator)\n"              \
+  "\n"                                                                          \
+  "There is no limit on the number of rules. Each message is first checked\n"  \
+  "against the literal text that every match of a target must contain, and\n" \
+  "only the targets whose text occurs in it are evaluated as a regex.\n"
 
 #define help_cmd_desc           "list all commands / command specific help"
 #define help_cmd_help           \
@@ -718,6 +761,17 @@
   "machine because we may present an I/O interrupt sooner than a\n"             \
   "real machine.\n"
 
+#define iointq_cmd_desc         "Display I/O interrupt queue statistics"
+#define iointq_cmd_help         \
+                                \
+  "Format: \"IOINTQ  [RESET]\"\n"                                               \
+  "\n"                                                                          \
+  "Displays the number of I/O interrupts queued, presented to a CPU and\n"      \
+  "presented by the CPU that took the device's previous interrupt, the\n"       \
+  "current and maximum queue depth, the interrupts now queued for each\n"       \
+  "interruption subclass, and histograms of the queue depth at the time\n"      \
+  "each interrupt was queued and of the time each waited before being\n"        \
+  "presented. RESET zeroes the statistics.\n"
 #define ipending_cmd_desc       "Display pending interrupts"
 #define ipl_cmd_desc            "IPL from device or file"
 #define ipl_cmd_help            \
@@ -806,13 +860,23 @@
 #define logopt_cmd_desc         "Set/Display logging options"
 #define logopt_cmd_help         \
                                 \
-  "Format: \"LOGOPT [DATESTAMP | NODATESTAMP] [TIMESTAMP | NOTIMESTAMP]\".\n\n" \
+  "Format: \"LOGOPT [DATESTAMP | NODATESTAMP] [TIMESTAMP | NOTIMESTAMP]\n"     \
+  "                [ROTSIZE=n[K|M|G]] [ROTTIME=n[S|M|H]]\n"                     \
+  "                [COMPRESS | NOCOMPRESS] [WAIT | DROP]\".\n\n"                \
   "Sets logfile options. \"TIMESTAMP\" inserts a time stamp in front of\n"     \
   "each log message. \"NOTIMESTAMP\" logs messages without time stamps.\n"      \
   "Similarly, \"DATESTAMP\" and \"NODATESTAMP\" prefixes logfile messages\n"    \
   "with or without the current date. Entering the command with no arguments\n"  \
   "displays current logging options. The current resolution of the stamp\n"     \
-  "is one second.\n"
+  "is one second.\n\n"                                                          \
+  "\"ROTSIZE\" and \"ROTTIME\" rotate the logfile (set by the \"log\" command\n" \
+  "or -l option) once it reaches the given size or age: the file is renamed\n"  \
+  "to <name>.<yyyymmdd-hhmmss> and a new logfile is started. Zero (the\n"       \
+  "default) disables either limit. \"COMPRESS\" gzips rotated logfiles.\n\n"    \
+  "\"WAIT\" (the default) makes a thread issuing a message wait briefly\n"     \
+  "when the logger's message buffer is full. \"DROP\" discards the message\n"  \
+  "immediately instead. Either way the number of discarded messages is\n"      \
+  "reported in the log.\n"
 
 #define lparname_cmd_desc       "Set LPAR name"
 #define lparname_cmd_help       \
@@ -1095,6 +1159,29 @@
   "to display the current value. Use the'cpu' command beforehand to choose\n"   \
   "which processor's prefix register should be displayed or altered.\n"
 
+#define prof_cmd_desc           "Guest code sampling profiler"
+#define prof_cmd_help           \
+                                \
+  "Format: \"prof [start [usecs] | stop | reset | map <file>|off |\n"          \
+  "                dump <file> [folded|flat] | top [n]]\"\n"                    \
+  "  prof              : display the profiler status\n"                        \
+  "  prof start [usecs]: start sampling every usecs microseconds (default\n"   \
+  "                      1000, minimum the timer interval, maximum 1000000)\n" \
+  "  prof stop         : stop sampling (samples are kept)\n"                   \
+  "  prof reset        : discard all samples\n"                                \
+  "  prof map <file>   : load a load map used to symbolize addresses\n"        \
+  "  prof map off      : discard the load map\n"                               \
+  "  prof dump <file>  : write the profile to a file, either in folded\n"      \
+  "                      stack format for flame graph tools (the default)\n"   \
+  "                      or as a flat listing with opcode histograms\n"        \
+  "  prof top [n]      : display the n (default 10) hottest locations\n"       \
+  "\n"                                                                          \
+  "Every online CPU is sampled by the timer thread: the instruction\n"         \
+  "address, primary ASN, problem/supervisor state, SIE guest execution and\n"  \
+  "the opcode. The CPUs themselves are not slowed down. Each line of a load\n" \
+  "map holds a hex address, a hex length and a symbol name, optionally\n"      \
+  "followed by a hex ASN. Lines starting with '#' are ignored.\n"
+
 #define psw_cmd_desc            "Display or alter program status word"
 #define psw_cmd_help            \
                                 \
@@ -1188,7 +1275,8 @@
 #define qeth_cmd_help           \
                                 \
   "Format:  \"QETH  DEBUG {ON|OFF}  [ [<devnum>|ALL] [mask ...] ]\"\n"          \
-  "         \"QETH  ADDR              [<devnum>|ALL]\"\n\n"                     \
+  "         \"QETH  ADDR              [<devnum>|ALL]\"\n"                       \
+  "         \"QETH  STATS             [<devnum>|ALL]\"\n\n"                     \
   "Enables/disables debug tracing for the QETH (OSA) device groups iden-\n"     \
   "tified by <devnum>, or for all QETH (OSA) device groups if <devnum> is\n"    \
   "not specified or specified as 'ALL', or displays all MAC addresses\n"        \
@@ -1196,7 +1284,10 @@
   "device groups if <devnum> is not specified or specified as 'ALL'.  The\n"    \
   "optional 'mask' value may be specified more than once. Mask values are\n"    \
   "'Ccw', 'DAta', 'DRopped', 'Expand', 'Interupts', 'Packet', 'Queues',\n"      \
-  "'SBale', 'SIga', 'Updown' or 0xhhhhhhhh hexadecimal value.\n"
+  "'SBale', 'SIga', 'Updown' or 0xhhhhhhhh hexadecimal value.\n\n"            \
+  "STATS displays the SIGA, doorbell, queue polling and virtual switch\n"     \
+  "counts of the QETH (OSA) device groups, with their rates per second\n"      \
+  "since the previous QETH STATS command.\n"
 
 #define qpfkeys_cmd_desc        "Display the current PF Key settings"
 #define qpid_cmd_desc           "Display Process ID of Hercules"
@@ -1570,8 +1661,9 @@
 #define shrd_cmd_desc           "shrd command"
 #define shrd_cmd_help           \
                                 \
-  "Format: \"SHRD [TRACE[=nnnn]|[DTAX=0|1]]\" where 'nnnn' is the desired\n"    \
-  "number of trace table entries, and DTAX is either 0 or 1. Specifying a\n"    \
+  "Format: \"SHRD [TRACE[=nnnn]|[DTAX=0|1]|MAXSYS=n|WORKERS=n|BENCH=devnum[,count]]\"\n" \
+  "where 'nnnn' is the desired number of trace table entries, and DTAX\n"     \
+  "is either 0 or 1. Specifying a\n"                                          \
   "non-zero TRACE= value enables debug tracing of the Shared Device Server.\n"  \
   "Specifying a value of 0 disables tracing. DTAX is a boolean true/false\n"    \
   "value indicating whether or not to automatically dump the trace table\n"     \
@@ -1579,7 +1671,13 @@
   "via separate commands. They cannot both be specified on the same command.\n" \
   "Entering the SHRD command by itself with no arguments displays current\n"    \
   "values. Entering \"SHRD TRACE\" by itself (without defining any value)\n"    \
-  "prints the current trace table. SEE ALSO: the 'shrdport' command.\n"
+  "prints the current trace table.\n"                                           \
+  "MAXSYS= limits the number of remote systems that may connect to each\n"     \
+  "device (0, the default, means no limit). WORKERS= sets the number of\n"    \
+  "server threads processing remote requests (default 4). BENCH= times\n"     \
+  "'count' (default 1000) channel programs against the server of remote\n"   \
+  "shared device 'devnum', both with and without pipelining.\n"              \
+  "SEE ALSO: the 'shrdport' command.\n"
 
 #define shrdport_cmd_desc       "Set shrdport value"
 #define shrdport_cmd_help       \
@@ -1596,6 +1694,23 @@
 
 #endif // defined( OPTION_SHARED_DEVICES )
 
+#define siecache_cmd_desc       "SIE state cache control and statistics"
+#define siecache_cmd_help       \
+                                \
+  "Format: \"siecache  [ENABLE | DISABLE | RESET]\"\n"                          \
+  "\n"                                                                          \
+  "With no arguments, displays whether the SIE state cache is enabled\n"        \
+  "followed by the number of times each SIE state descriptor was entered,\n"    \
+  "how often its previously decoded state was reused and its guest TLB\n"       \
+  "kept, and its interceptions grouped by interception code.\n"                 \
+  "\n"                                                                          \
+  "ENABLE lets each CPU reuse the decoded storage, SCA and facility list\n"     \
+  "state of a state descriptor whose relevant fields have not changed,\n"       \
+  "and keep the guest TLB when the same state descriptor is dispatched\n"       \
+  "again on the same CPU.  DISABLE (the default) decodes the state\n"           \
+  "descriptor and purges the guest TLB on every SIE entry.  The counts\n"       \
+  "are maintained in either case.  RESET clears the cache and counts.\n"
+
 #define sizeof_cmd_desc         "Display size of structures"
 #define spm_cmd_desc            "SIE performance monitor"
 #define ssd_cmd_desc            "Signal shutdown"
@@ -1872,6 +1987,37 @@
   "the current PSW mode, which is the default.\n"
 
 #define version_cmd_desc        "Display version information"
+#define waitspin_cmd_desc       "Set CPU wait spin limit or display wakeup latency"
+#define waitspin_cmd_help       \
+                                \
+  "Format:\n"                                                                   \
+  "\n"                                                                          \
+  "     WAITSPIN  [usecs | RESET]\n"                                            \
+  "\n"                                                                          \
+  "A started CPU that enters the wait state first polls for a wakeup for up\n"  \
+  "to 'usecs' microseconds (0 - 10000, default 0) before it sleeps. The\n"      \
+  "actual spin adapts per CPU: it grows while wakeups keep arriving within\n"   \
+  "that interval and shrinks while the CPU stays idle longer. Spinning\n"       \
+  "trades host CPU time for lower interrupt latency and is never done on\n"     \
+  "a uniprocessor host.\n"                                                      \
+  "\n"                                                                          \
+  "Enter WAITSPIN without arguments to display the limit and each CPU's\n"      \
+  "wakeup count, wakeups taken before sleeping, average and maximum wakeup\n"   \
+  "latency and current spin. RESET clears the wakeup statistics.\n"
+
+#define xpndmove_cmd_desc       "Set or display expanded storage page move method"
+#define xpndmove_cmd_help       \
+                                \
+  "Format:\n"                                                                   \
+  "\n"                                                                          \
+  "     XPNDMOVE  [STREAM | COPY]\n"                                            \
+  "\n"                                                                          \
+  "Specifies how PGOUT and MVPG copy a page from main storage into\n"           \
+  "expanded storage. STREAM (the default) uses non-temporal host stores\n"      \
+  "where available so the page written to expanded storage does not evict\n"    \
+  "the guest\'s working set from the host cache. COPY uses an ordinary\n"       \
+  "memory copy. Enter XPNDMOVE without an argument to display the setting.\n"
+
 #define xpndsize_cmd_desc       "Define/Display xpndsize parameter"
 #define xpndsize_cmd_help       \
                                 \
@@ -1957,6 +2103,7 @@ COMMAND( "stop",                    stop_cmd,               SYSCMD,
 
 COMMAND( "abs",                     abs_or_r_cmd,           SYSCMDNOPER,        abs_cmd_desc,           abs_cmd_help        )
 COMMAND( "aea",                     aea_cmd,                SYSCMDNOPER,        aea_cmd_desc,           NULL                )
+COMMAND( "affinity",                affinity_cmd,           SYSCMDNOPER,        affinity_cmd_desc,      affinity_cmd_help   )
 COMMAND( "aia",                     aia_cmd,                SYSCMDNOPER,        aia_cmd_desc,           NULL                )
 COMMAND( "ar",                      ar_cmd,                 SYSCMDNOPER,        ar_cmd_desc,            NULL                )
 COMMAND( "autoinit",                autoinit_cmd,           SYSCMDNOPER,        autoinit_cmd_desc,      autoinit_cmd_help   )
@@ -1983,6 +2130,7 @@ COMMAND( "fpr",                     fpr_cmd,                SYSCMDNOPER,
 COMMAND( "g",                       g_cmd,                  SYSCMDNOPER,        g_cmd_desc,             NULL                )
 COMMAND( "gpr",                     gpr_cmd,                SYSCMDNOPER,        gpr_cmd_desc,           gpr_cmd_help        )
 COMMAND( "herclogo",                herclogo_cmd,           SYSCMDNOPER,        herclogo_cmd_desc,      herclogo_cmd_help   )
+COMMAND( "iointq",                  iointq_cmd,             SYSCMDNOPER,        iointq_cmd_desc,        iointq_cmd_help     )
 COMMAND( "ipending",                ipending_cmd,           SYSCMDNOPER,        ipending_cmd_desc,      NULL                )
 COMMAND( "k",                       k_cmd,                  SYSCMDNOPER,        k_cmd_desc,             NULL                )
 COMMAND( "loadcore",                loadcore_cmd,           SYSCMDNOPER,        loadcore_cmd_desc,      loadcore_cmd_help   )
@@ -1996,6 +2144,7 @@ COMMAND( "osa",                     qeth_cmd,               SYSCMDNOPER,
 COMMAND( "ostailor",                ostailor_cmd,           SYSCMDNOPER,        ostailor_cmd_desc,      ostailor_cmd_help   )
 COMMAND( "pgmtrace",                pgmtrace_cmd,           SYSCMDNOPER,        pgmtrace_cmd_desc,      pgmtrace_cmd_help   )
 COMMAND( "pr",                      pr_cmd,                 SYSCMDNOPER,        pr_cmd_desc,            pr_cmd_help         )
+COMMAND( "prof",                    prof_cmd,               SYSCMDNOPER,        prof_cmd_desc,          prof_cmd_help       )
 COMMAND( "psw",                     psw_cmd,                SYSCMDNOPER,        psw_cmd_desc,           psw_cmd_help        )
 COMMAND( "ptp",                     ptp_cmd,                SYSCMDNOPER,        ptp_cmd_desc,           ptp_cmd_help        )
 COMMAND( "ptt",                     EXTCMD( ptt_cmd ),      SYSCMDNOPER,        ptt_cmd_desc,           ptt_cmd_help        )
@@ -2013,6 +2162,9 @@ COMMAND( "s+",                      trace_cmd,              SYSCMDNOPER,
 COMMAND( "savecore",                savecore_cmd,           SYSCMDNOPER,        savecore_cmd_desc,      savecore_cmd_help   )
 COMMAND( "script",                  script_cmd,             SYSCMDNOPER,        script_cmd_desc,        script_cmd_help     )
 COMMAND( "sh",                      sh_cmd,                 SYSCMDNOPER,        sh_cmd_desc,            sh_cmd_help         )
+#if defined( _FEATURE_SIE )
+COMMAND( "siecache",                siecache_cmd,           SYSCMDNOPER,        siecache_cmd_desc,      siecache_cmd_help   )
+#endif
 COMMAND( "suspend",                 suspend_cmd,            SYSCMDNOPER,        suspend_cmd_desc,       NULL                )
 COMMAND( "symptom",                 traceopt_cmd,           SYSCMDNOPER,        symptom_cmd_desc,       NULL                )
 
@@ -2031,6 +2183,7 @@ COMMAND( "toddrag",                 toddrag_cmd,            SYSCMDNOPER,
 COMMAND( "traceopt",                traceopt_cmd,           SYSCMDNOPER,        traceopt_cmd_desc,      traceopt_cmd_help   )
 COMMAND( "u",                       u_cmd,                  SYSCMDNOPER,        u_cmd_desc,             u_cmd_help          )
 COMMAND( "v",                       v_cmd,                  SYSCMDNOPER,        v_cmd_desc,             v_cmd_help          )
+COMMAND( "waitspin",                waitspin_cmd,           SYSCMDNOPER,        waitspin_cmd_desc,      waitspin_cmd_help   )
 
 COMMAND( "i",                       i_cmd,                  SYSCMDNDIAG8,       i_cmd_desc,             NULL                )
 COMMAND( "ipl",                     ipl_cmd,                SYSCMDNDIAG8,       ipl_cmd_desc,           ipl_cmd_help        )
@@ -2059,6 +2212,7 @@ COMMAND( "shcmdopt",                shcmdopt_cmd,           SYSCFGNDIAG8,
 COMMAND( "sysepoch",                sysepoch_cmd,           SYSCFGNDIAG8,       sysepoch_cmd_desc,      NULL                )
 COMMAND( "sysgport",                sysgport_cmd,           SYSCFGNDIAG8,       sysgport_cmd_desc,      NULL                )
 COMMAND( "tzoffset",                tzoffset_cmd,           SYSCFGNDIAG8,       tzoffset_cmd_desc,      NULL                )
+COMMAND( "xpndmove",                xpndmove_cmd,           SYSCFGNDIAG8,       xpndmove_cmd_desc,      xpndmove_cmd_help   )
 COMMAND( "xpndsize",                xpndsize_cmd,           SYSCFGNDIAG8,       xpndsize_cmd_desc,      xpndsize_cmd_help   )
 COMMAND( "yroffset",                yroffset_cmd,           SYSCFGNDIAG8,       yroffset_cmd_desc,      NULL                )
 
@@ -2117,6 +2271,9 @@ COMMAND( "hwldr",                   hwldr_cmd,              SYSCMDNOPER,
 COMMAND( "loaddev",                 lddev_cmd,              SYSCMD,             loaddev_cmd_desc,       loaddev_cmd_help    )
 COMMAND( "dumpdev",                 lddev_cmd,              SYSCMD,             dumpdev_cmd_desc,       dumpdev_cmd_help    )
 #endif
+#if defined( _FEATURE_VM_BLOCKIO )
+COMMAND( "d250stats",               d250stats_cmd,          SYSCMDNOPER,        d250stats_cmd_desc,     d250stats_cmd_help  )
+#endif
 #if !defined( _FW_REF )
 
         // PROGRAMMING NOTE: the following "+/-" commands ("f+adr", "t+dev",
@@ -12,6 +12,11 @@
 
 #include "hstdinc.h"
 
+#if defined( __linux__ )
+  #include <sys/syscall.h>              /* SYS_mbind                 */
+  #include <linux/mempolicy.h>          /* MPOL_INTERLEAVE, etc      */
+#endif
+
 DISABLE_GCC_UNUSED_FUNCTION_WARNING;
 
 #define _CONFIG_C_
@@ -226,6 +231,53 @@ PUSH_GCC_WARNINGS()
 DISABLE_GCC_WARNING( "-Wpointer-to-int-cast" )
 DISABLE_GCC_WARNING( "-Wint-to-pointer-cast" )
 
+/*-------------------------------------------------------------------*/
+/* configure_numa - apply AFFINITY MAINSTOR NUMA policy to storage   */
+/*-------------------------------------------------------------------*/
+int configure_numa( void )
+{
+    if (!sysblk.mainstor || !sysblk.mainsize)
+        return 0;
+
+#if defined( __linux__ ) && defined( SYS_mbind )
+    {
+        unsigned long  flags  = 0;
+        int            mode;
+
+        switch (sysblk.numapolicy)
+        {
+            case NUMA_POLICY_INTERLEAVE: mode = MPOL_INTERLEAVE; break;
+            case NUMA_POLICY_BIND:       mode = MPOL_BIND;       break;
+            default:                     mode = MPOL_DEFAULT;    break;
+        }
+
+        /* Migrate any pages already touched (e.g. by a prior IPL) */
+        if (mode != MPOL_DEFAULT)
+            flags = MPOL_MF_MOVE;
+
+        if (syscall( SYS_mbind, sysblk.mainstor,
+            (unsigned long) sysblk.mainsize, mode,
+            mode == MPOL_DEFAULT ? NULL : sysblk.numanodes.bits,
+            mode == MPOL_DEFAULT ? 0UL  : (unsigned long) HCPUSET_MAX + 1,
+            flags ) != 0)
+        {
+            // "Error in function %s: %s"
+            WRMSG( HHC01430, "E", "mbind()", strerror( errno ));
+            return -1;
+        }
+    }
+#else
+    if (sysblk.numapolicy != NUMA_POLICY_DEFAULT)
+    {
+        // "Error in function %s: %s"
+        WRMSG( HHC01430, "E", "mbind()", strerror( ENOTSUP ));
+        return -1;
+    }
+#endif
+
+    return 0;
+}
+
 /*-------------------------------------------------------------------*/
 /* configure_storage - configure MAIN storage                        */
 /*-------------------------------------------------------------------*/
@@ -377,6 +429,10 @@ int configure_storage( U64 mainsize /* number of 4K pages */ )
     if (dofree)
         free( dofree );
 
+    /* Place storage on the requested NUMA nodes before first touch */
+    if (sysblk.numapolicy != NUMA_POLICY_DEFAULT)
+        configure_numa();
+
     /* Initial power-on reset for main storage */
     storage_clear();  /* only clears if needed */
 
@@ -659,6 +715,7 @@ char      buf[32];
         initialize_condition ( &dev->kbcond             );
 #if defined( OPTION_SHARED_DEVICES )
         initialize_condition ( &dev->shiocond           );
+        initialize_condition ( &dev->rmtcond            );
 #endif // defined( OPTION_SHARED_DEVICES )
 #if defined(OPTION_SCSI_TAPE)
         initialize_condition ( &dev->stape_sstat_cond   );
@@ -68,6 +68,7 @@
 #if !defined( FWD_REFS)
     #define   FWD_REFS
   static void  CPU_Wait( REGS* regs );
+  static void  CPU_Wait_Adaptive( REGS* regs );
   static void* cpu_uninit( int cpu, REGS* regs );
 #endif
 
@@ -2356,6 +2357,10 @@ int   rc;
     /* Set CPU thread priority */
     set_thread_priority( sysblk.cpuprio);
 
+    /* Bind to this CPU's host CPU set if AFFINITY was specified */
+    if (sysblk.affgen)
+        set_thread_affinity( &sysblk.cpuaff[ cpu ] );
+
     /* Display thread started message on control panel */
 
     MSGBUF( thread_name, "Processor %s%02X", PTYPSTR( cpu ), cpu );
@@ -2565,6 +2570,9 @@ static void *cpu_uninit (int cpu, REGS *regs)
 
     /* Free the REGS structure */
     TXF_FREEMAP( regs );
+#if defined( _FEATURE_SIE )
+    free( regs->siecache );
+#endif
     free_aligned( regs );
 
     return NULL;
@@ -2614,12 +2622,89 @@ static void CPU_Wait( REGS* regs )
     }
 
     /* Wait for interrupt */
-    wait_condition (&regs->intcond, &sysblk.intlock);
+    if (regs->cpustate == CPUSTATE_STARTED)
+        CPU_Wait_Adaptive( regs );
+    else
+        wait_condition (&regs->intcond, &sysblk.intlock);
 
     /* And we're the owner of intlock once again */
     sysblk.intowner = regs->cpuad;
 }
 
+/*-------------------------------------------------------------------*/
+/* CPU Wait Adaptive - spin-then-sleep wait for a started CPU        */
+/*                                                                   */
+/* The CPU polls its wakeup word for up to regs->spinlimit usecs     */
+/* without holding intlock, then sleeps on the word. wakeup_cpu()    */
+/* only has to post the word (and wake the host thread if it went    */
+/* to sleep). The spin limit adapts between zero and WAITSPIN: it    */
+/* grows while wakeups keep arriving within the WAITSPIN interval    */
+/* and halves each time the CPU stays idle longer than that.         */
+/*                                                                   */
+/* Locks Held                                                        */
+/*      sysblk.intlock                                               */
+/*-------------------------------------------------------------------*/
+static void CPU_Wait_Adaptive( REGS* regs )
+{
+    TOD     start = host_tod();         /* Wait start time           */
+    TOD     spinend;                    /* Spin deadline             */
+    TOD     latency;                    /* Wakeup latency            */
+    U32     old = CPU_WAKE_SPINNING;    /* Wakeup word state         */
+    bool    spun;                       /* Woken while spinning      */
+    bool    nofutex = false;            /* Fall back to intcond      */
+
+    /* Spinning only helps if another host CPU can post the word */
+    if (regs->spinlimit > sysblk.waitspin || hostinfo.num_procs < 2)
+        regs->spinlimit = (hostinfo.num_procs < 2) ? 0 : sysblk.waitspin;
+
+    /* Wakers hold intlock while posting the interrupt they wake us
+       for, so re-arming the word under intlock cannot lose one */
+    regs->wakeword = CPU_WAKE_SPINNING;
+    release_lock( &sysblk.intlock );
+
+    /* Poll for a wakeup for up to the current spin limit */
+    if (regs->spinlimit)
+    {
+        spinend = start + (TOD) regs->spinlimit * ETOD_USEC;
+
+        while (regs->wakeword == CPU_WAKE_SPINNING && host_tod() < spinend)
+            ;   /* (do nothing, we are only polling) */
+    }
+
+    /* Then sleep on the word until it is posted, unless it already
+       was (the compare-and-swap fails) */
+    spun = cmpxchg4( &old, CPU_WAKE_SLEEPING, (void*) &regs->wakeword ) != 0;
+
+    while (!spun && !nofutex && regs->wakeword == CPU_WAKE_SLEEPING)
+        nofutex = hthread_wait_word( &regs->wakeword, CPU_WAKE_SLEEPING ) == ENOTSUP;
+
+    obtain_lock( &sysblk.intlock );
+
+    /* Without futexes, wakeup_cpu() signals intcond after posting */
+    while (regs->wakeword == CPU_WAKE_SLEEPING)
+        wait_condition( &regs->intcond, &sysblk.intlock );
+
+    /* Update the wakeup latency statistics */
+    latency = host_tod();
+    latency = (latency > regs->waketod) ? latency - regs->waketod : 0;
+
+    regs->wakecount++;
+    regs->waketotal += latency;
+    if (latency > regs->wakemax)
+        regs->wakemax = latency;
+    if (spun)
+        regs->wakespin++;
+
+    /* Adapt the spin limit to how long we actually waited */
+    if (sysblk.waitspin && hostinfo.num_procs > 1)
+    {
+        if (regs->waketod - start < (TOD) sysblk.waitspin * ETOD_USEC)
+            regs->spinlimit = MIN( sysblk.waitspin, regs->spinlimit * 2 + 1 );
+        else
+            regs->spinlimit >>= 1;
+    }
+}
+
 /*-------------------------------------------------------------------*/
 /* Copy program status word                                          */
 /*-------------------------------------------------------------------*/
@@ -103,8 +103,9 @@ static void     ctc_halt_or_clear( DEVBLK* pDEVBLK );
 
 static void*    CTCI_ReadThread( void* arg /*PCTCBLK pCTCBLK */ );
 
-static int      CTCI_EnqueueIPFrame( DEVBLK* pDEVBLK,
-                                     BYTE*   pData, size_t iSize );
+static void     CTCI_SignalRead( PCTCBLK pCTCBLK );
+
+static void     CTCI_DrainRing( PCTCBLK pCTCBLK );
 
 static int      ParseArgs( DEVBLK* pDEVBLK, PCTCBLK pCTCBLK,
                            int argc, char** argv );
@@ -230,6 +231,15 @@ int  CTCI_Init( DEVBLK* pDEVBLK, int argc, char *argv[] )
     initialize_lock( &pDevCTCBLK->EventLock );
     initialize_condition( &pDevCTCBLK->Event );
 
+    if( netring_init( &pDevCTCBLK->Ring ) != 0 )
+    {
+        char buf[40];
+        MSGBUF(buf, "malloc(%d)", NETRING_SIZE);
+        // "%1d:%04X %s: error in function %s: %s"
+        WRMSG(HHC00900, "E", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum, "CTCI", buf, strerror(errno) );
+        return -1;
+    }
+
     // Give both Herc devices a reasonable name...
 
     STRLCPY( pDevCTCBLK->pDEVBLK[ CTC_READ_SUBCHANN  ]->filename, pDevCTCBLK->szTUNCharDevName );
@@ -247,7 +257,11 @@ int  CTCI_Init( DEVBLK* pDEVBLK, int argc, char *argv[] )
                                  &pDevCTCBLK->fd,
                                  pDevCTCBLK->szTUNIfName );
 
-    if( rc < 0 ) return -1;
+    if( rc < 0 )
+    {
+        netring_term( &pDevCTCBLK->Ring );
+        return -1;
+    }
 
     // HHC00901 "%1d:%04X %s: interface %s, type %s opened"
     WRMSG(HHC00901, "I", SSID_TO_LCSS(pDevCTCBLK->pDEVBLK[CTC_READ_SUBCHANN]->ssid), pDevCTCBLK->pDEVBLK[CTC_READ_SUBCHANN]->devnum,
@@ -607,12 +621,14 @@ int  CTCI_Close( DEVBLK* pDEVBLK )
 
         TID tid = pCTCBLK->tid;
         pCTCBLK->fCloseInProgress = 1;  // (ask read thread to exit)
-#if defined(_MSVC_)
         join_thread( tid, NULL );       // (wait for thread to end)
-#endif
         detach_thread( tid );           // (wait for thread to end)
     }
 
+    // The read thread is gone, so its frame ring can be released
+    // (only the first of the two devices to be closed releases it)
+    netring_term( &pCTCBLK->Ring );
+
     pDEVBLK->fd = -1;           // indicate we're now closed
 
     return 0;
@@ -652,11 +668,15 @@ void  CTCI_Query( DEVBLK* pDEVBLK, char** ppszClass,
     else
        pDriveIP = "-";
 
-    snprintf( pBuffer, iBufLen, "CTCI %s/%s (%s)%s IO[%"PRIu64"]",
+    snprintf( pBuffer, iBufLen, "CTCI %s/%s (%s)%s rq[%u/%u] bp[%"PRIu64"] dr[%"PRIu64"] IO[%"PRIu64"]",
               pGuestIP,
               pDriveIP,
               pCTCBLK->szTUNIfName,
               pCTCBLK->fDebug ? " -d" : "",
+              netring_count( &pCTCBLK->Ring ),
+              pCTCBLK->Ring.uHiWater,
+              pCTCBLK->Ring.uFull,
+              pCTCBLK->Ring.uDrops,
               pDEVBLK->excps );
     pBuffer[iBufLen-1] = '\0';
 
@@ -714,13 +734,15 @@ void  CTCI_Read( DEVBLK* pDEVBLK,   U32   sCount,
     PCTCBLK     pCTCBLK  = (PCTCBLK)pDEVBLK->dev_data;
     PCTCIHDR    pFrame   = NULL;
     size_t      iLength  = 0;
-    int         rc       = 0;
     BYTE        haltorclear = FALSE;
 
     for ( ; ; )
     {
         obtain_lock( &pCTCBLK->Lock );
 
+        // Move whatever CTCI_ReadThread has queued into the buffer
+        CTCI_DrainRing( pCTCBLK );
+
         if (!pCTCBLK->fDataPending)
         {
             release_lock( &pCTCBLK->Lock );
@@ -733,12 +755,17 @@ void  CTCI_Read( DEVBLK* pDEVBLK,   U32   sCount,
                 waittime.tv_sec  = now.tv_sec  + DEF_NET_READ_TIMEOUT_SECS;
                 waittime.tv_nsec = now.tv_usec * 1000;
 
+                // (CTCI_SignalRead holds EventLock when signalling,
+                // so a frame queued since we looked can't be missed)
                 obtain_lock( &pCTCBLK->EventLock );
-                pCTCBLK->fReadWaiting = 1;
-                rc = timed_wait_condition( &pCTCBLK->Event,
-                                           &pCTCBLK->EventLock,
-                                           &waittime );
-                pCTCBLK->fReadWaiting = 0;
+                if (!netring_count( &pCTCBLK->Ring ))
+                {
+                    pCTCBLK->fReadWaiting = 1;
+                    timed_wait_condition( &pCTCBLK->Event,
+                                               &pCTCBLK->EventLock,
+                                               &waittime );
+                    pCTCBLK->fReadWaiting = 0;
+                }
             }
             // check for halt condition
             if (pCTCBLK->fHaltOrClear)
@@ -763,10 +790,7 @@ void  CTCI_Read( DEVBLK* pDEVBLK,   U32   sCount,
                 return;
             }
 
-            if (rc == ETIMEDOUT || rc == EINTR)
-                continue;
-
-            obtain_lock( &pCTCBLK->Lock );
+            continue;
         }
 
         // Sanity check
@@ -1002,7 +1026,8 @@ void  CTCI_Write( DEVBLK* pDEVBLK,   U32   sCount,
 // --------------------------------------------------------------------
 //
 // When an IP frame is received from the TUN/TAP interface, the frame
-// is enqueued on the device frame buffer.
+// is added to the device's frame ring (see NETRING in netsupp.h),
+// from which CTCI_Read moves it onto the device frame buffer.
 //
 // The device frame buffer is a chain of blocks. The first 2 bytes of
 // a block (CTCIHDR) specify the offset in the buffer of the next block.
@@ -1014,15 +1039,19 @@ void  CTCI_Write( DEVBLK* pDEVBLK,   U32   sCount,
 // a 2 byte frame type field (always 0x0800 = IPv4), and a 2 byte
 // reserved area (always 0000), followed by the actual frame data.
 //
-// The CTCI_ReadThread reads the IP frame, then CTCI_EnqueueIPFrame
-// function is called to add it to the frame buffer (which precedes
-// each one with a CTCISEG and adjusts the block header (CTCIHDR)
-// offset value as appropriate.
+// The CTCI_ReadThread reads the IP frame and adds it to the ring
+// without taking any lock. Once it has read all of the frames that
+// were waiting (up to NETRING_BATCH of them) it wakes CTCI_Read,
+// which calls CTCI_DrainRing to add each frame to the frame buffer
+// (preceding each one with a CTCISEG and adjusting the block header
+// (CTCIHDR) offset value as appropriate). When the ring is full the
+// CTCI_ReadThread waits for CTCI_Read to make room, leaving any more
+// frames queued in the TUN/TAP interface meanwhile.
 //
 // Oddly, it is the CTCI_Read function (called by CCW processing in
 // response to a guest SIO request) that adds the CTCIHDR with the
 // 000 offset value marking the end of the buffer's chain of blocks,
-// and not the CTCI_EnqueueIPFrame nor the CTCI_ReadThread as would
+// and not the CTCI_DrainRing nor the CTCI_ReadThread as would
 // be expected.
 //
 // Also note that the iFrameOffset field in the CTCI device's CTCBLK
@@ -1036,6 +1065,7 @@ static void*  CTCI_ReadThread( void* arg )
     PCTCBLK  pCTCBLK = (PCTCBLK) arg;
     DEVBLK*  pDEVBLK = pCTCBLK->pDEVBLK[CTC_READ_SUBCHANN];
     int      iLength;
+    int      iBatch = 0;                // Frames not yet signalled
     BYTE     szBuff[2048];
 
     // ZZ FIXME: Try to avoid race condition at startup with hercifc
@@ -1045,10 +1075,19 @@ static void*  CTCI_ReadThread( void* arg )
 
     pCTCBLK->pid = getpid();
 
+#if !defined( OPTION_W32_CTCI )
+    // So frames already waiting can be read without a select
+    socket_set_blocking_mode( pCTCBLK->fd, 0 );
+#endif
+
     while( pCTCBLK->fd != -1 && !pCTCBLK->fCloseInProgress )
     {
-        // Read frame from the TUN/TAP interface
-        iLength = read_tuntap( pCTCBLK->fd, szBuff, sizeof( szBuff ), DEF_NET_READ_TIMEOUT_SECS );
+        // Read frame from the TUN/TAP interface, but only wait
+        // for one if there are none waiting to be signalled
+        if( iBatch )
+            iLength = read_tuntap_nowait( pCTCBLK->fd, szBuff, sizeof( szBuff ) );
+        else
+            iLength = read_tuntap( pCTCBLK->fd, szBuff, sizeof( szBuff ), DEF_NET_READ_TIMEOUT_SECS );
 
         // Check for error condition
         if( iLength < 0 )
@@ -1062,8 +1101,15 @@ static void*  CTCI_ReadThread( void* arg )
             break;
         }
 
-        if( iLength == 0 )      // (probably EINTR; ignore)
+        if( iLength == 0 )      // (nothing more waiting, or EINTR)
+        {
+            if( iBatch )
+            {
+                CTCI_SignalRead( pCTCBLK );
+                iBatch = 0;
+            }
             continue;
+        }
 
         if( pCTCBLK->fDebug )
         {
@@ -1073,26 +1119,35 @@ static void*  CTCI_ReadThread( void* arg )
             net_data_trace( pDEVBLK, szBuff, iLength, '>', 'D', "packet", 0 );
         }
 
-        // Enqueue frame on buffer, if buffer is full, keep trying
-        while( CTCI_EnqueueIPFrame( pDEVBLK, szBuff, iLength ) < 0
-            && pCTCBLK->fd != -1 && !pCTCBLK->fCloseInProgress )
+        // Will frame NEVER fit into buffer??
+        if( iLength > (int)MAX_CTCI_FRAME_SIZE( pCTCBLK ) || iLength > 9000 )
         {
-            if( EMSGSIZE == errno )     // (if too large for buffer)
+            pCTCBLK->Ring.uDrops++;
+            if( pCTCBLK->fDebug )
             {
-                if( pCTCBLK->fDebug )
-                {
-                    // "%1d:%04X CTC: packet frame too big, dropped"
-                    WRMSG(HHC00914, "W", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum );
-                }
-                break;                  // (discard it...)
+                // "%1d:%04X CTC: packet frame too big, dropped"
+                WRMSG(HHC00914, "W", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum );
             }
+            continue;                   // (discard it...)
+        }
 
-            ASSERT( ENOBUFS == errno );
+        // Add frame to the ring. If the ring is full, let CTCI_Read
+        // have what we've got so far and wait for it to make room.
+        while( netring_put( &pCTCBLK->Ring, szBuff, iLength ) < 0
+            && pCTCBLK->fd != -1 && !pCTCBLK->fCloseInProgress )
+        {
+            if( iBatch )
+            {
+                CTCI_SignalRead( pCTCBLK );
+                iBatch = 0;
+            }
+            netring_wait( &pCTCBLK->Ring, iLength, NETRING_WAIT_MSECS );
+        }
 
-            // Don't use sched_yield() here; use an actual non-dispatchable
-            // delay instead so as to allow another [possibly lower priority]
-            // thread to 'read' (remove) some packet(s) from our frame buffer.
-            usleep( CTC_DELAY_USECS );  // (wait a bit before retrying...)
+        if( ++iBatch >= NETRING_BATCH )
+        {
+            CTCI_SignalRead( pCTCBLK );
+            iBatch = 0;
         }
     }
 
@@ -1105,85 +1160,83 @@ static void*  CTCI_ReadThread( void* arg )
 }
 
 // --------------------------------------------------------------------
-// CTCI_EnqueueIPFrame
+// CTCI_SignalRead
 // --------------------------------------------------------------------
 //
-// Places the provided IP frame in the next available frame slot in
-// the adapter buffer. For details regarding the actual buffer layout
-// please refer to the comments preceding the CTCI_ReadThread function.
+// Wakes CTCI_Read to collect the frames CTCI_ReadThread has added to
+// the ring.
 //
-// Returns:
+
+static void  CTCI_SignalRead( PCTCBLK pCTCBLK )
+{
+    pCTCBLK->Ring.uBatches++;
+
+    obtain_lock( &pCTCBLK->EventLock );
+    signal_condition( &pCTCBLK->Event );
+    release_lock( &pCTCBLK->EventLock );
+}
+
+// --------------------------------------------------------------------
+// CTCI_DrainRing
+// --------------------------------------------------------------------
 //
-//  0 == Success
-// -1 == Failure; errno = ENOBUFS:  No buffer space available
-//                        EMSGSIZE: Message too long
+// Moves as many IP frames from the ring as will fit into the next
+// available frame slots in the adapter buffer. For details regarding
+// the actual buffer layout please refer to the comments preceding the
+// CTCI_ReadThread function. The caller must hold pCTCBLK->Lock.
 //
-static int  CTCI_EnqueueIPFrame( DEVBLK* pDEVBLK,
-                                 BYTE*   pData, size_t iSize )
+
+static void  CTCI_DrainRing( PCTCBLK pCTCBLK )
 {
     PCTCIHDR pFrame;
     PCTCISEG pSegment;
-    PCTCBLK  pCTCBLK = (PCTCBLK)pDEVBLK->dev_data;
-
-    // Will frame NEVER fit into buffer??
-    if( iSize > MAX_CTCI_FRAME_SIZE( pCTCBLK ) || iSize > 9000 )
-    {
-        errno = EMSGSIZE;   // Message too long
-        return -1;          // (-1==failure)
-    }
-
-    obtain_lock( &pCTCBLK->Lock );
-
-    // Ensure we dont overflow the buffer
-    if( ( pCTCBLK->iFrameOffset +         // Current buffer Offset
-          sizeof( CTCIHDR ) +             // Size of Block Header
-          sizeof( CTCISEG ) +             // Size of Segment Header
-          iSize +                         // Size of Ethernet packet
-          sizeof(pFrame->hwOffset) )      // Size of Block terminator
-        > pCTCBLK->iMaxFrameBufferSize )  // Size of Frame buffer
-    {
-        release_lock( &pCTCBLK->Lock );
-        errno = ENOBUFS;    // No buffer space available
-        return -1;          // (-1==failure)
-    }
+    BYTE*    pData;
+    int      iSize;
 
     // Fix-up Frame pointer
     pFrame = (PCTCIHDR)pCTCBLK->bFrameBuffer;
 
-    // Fix-up Segment pointer
-    pSegment = (PCTCISEG)( pCTCBLK->bFrameBuffer +
-                           sizeof( CTCIHDR ) +
-                           pCTCBLK->iFrameOffset );
+    while( (iSize = netring_peek( &pCTCBLK->Ring, &pData )) > 0 )
+    {
+        // Ensure we dont overflow the buffer
+        if( ( pCTCBLK->iFrameOffset +         // Current buffer Offset
+              sizeof( CTCIHDR ) +             // Size of Block Header
+              sizeof( CTCISEG ) +             // Size of Segment Header
+              iSize +                         // Size of Ethernet packet
+              sizeof(pFrame->hwOffset) )      // Size of Block terminator
+            > pCTCBLK->iMaxFrameBufferSize )  // Size of Frame buffer
+            break;                            // (leave it for next time)
 
-    // Initialize segment
-    memset( pSegment, 0, iSize + sizeof( CTCISEG ) );
+        // Fix-up Segment pointer
+        pSegment = (PCTCISEG)( pCTCBLK->bFrameBuffer +
+                               sizeof( CTCIHDR ) +
+                               pCTCBLK->iFrameOffset );
 
-    // Increment offset
-    pCTCBLK->iFrameOffset += (U16)(sizeof( CTCISEG ) + iSize);
+        // Initialize segment
+        memset( pSegment, 0, iSize + sizeof( CTCISEG ) );
 
-    // Update next frame offset
-    STORE_HW( pFrame->hwOffset,
-              pCTCBLK->iFrameOffset + sizeof( CTCIHDR ) );
+        // Increment offset
+        pCTCBLK->iFrameOffset += (U16)(sizeof( CTCISEG ) + iSize);
 
-    // Store segment length
-    STORE_HW( pSegment->hwLength, (U16)(sizeof( CTCISEG ) + iSize) );
+        // Update next frame offset
+        STORE_HW( pFrame->hwOffset,
+                  pCTCBLK->iFrameOffset + sizeof( CTCIHDR ) );
 
-    // Store Frame type
-    STORE_HW( pSegment->hwType, ETH_TYPE_IP );
+        // Store segment length
+        STORE_HW( pSegment->hwLength, (U16)(sizeof( CTCISEG ) + iSize) );
 
-    // Copy data
-    memcpy( pSegment->bData, pData, iSize );
+        // Store Frame type
+        STORE_HW( pSegment->hwType, ETH_TYPE_IP );
 
-    // Mark data pending
-    pCTCBLK->fDataPending = 1;
+        // Copy data
+        memcpy( pSegment->bData, pData, iSize );
 
-    release_lock( &pCTCBLK->Lock );
+        // Let CTCI_ReadThread reuse the space
+        netring_pop( &pCTCBLK->Ring );
 
-    obtain_lock( &pCTCBLK->EventLock );
-    signal_condition( &pCTCBLK->Event );
-    release_lock( &pCTCBLK->EventLock );
-
-    return 0;       // (0==success)
+        // Mark data pending
+        pCTCBLK->fDataPending = 1;
+    }
 }
 
 //
@@ -127,7 +127,8 @@ static void*    LCS_PortThread( void* arg /* PLCSPORT pLCSPORT */ );
 static void*    LCS_AttnThread( void* arg /* PLCSBLK pLCSBLK */ );
 
 static void     LCS_EnqueueEthFrame     ( PLCSPORT pLCSPORT, PLCSDEV pLCSDEV, BYTE* pData, size_t iSize );
-static int      LCS_DoEnqueueEthFrame   ( PLCSPORT pLCSPORT, PLCSDEV pLCSDEV, BYTE* pData, size_t iSize );
+static void     LCS_SignalReads         ( PLCSPORT pLCSPORT );
+static void     LCS_DrainRing           ( PLCSDEV pLCSDEV );
 
 static void     LCS_EnqueueReplyFrame   ( PLCSDEV pLCSDEV, PLCSCMDHDR pReply, size_t iSize );
 static int      LCS_DoEnqueueReplyFrame ( PLCSDEV pLCSDEV, PLCSCMDHDR pReply, size_t iSize );
@@ -428,6 +429,17 @@ int  LCS_Init( DEVBLK* pDEVBLK, int argc, char *argv[] )
         initialize_lock( &pLCSDev->LCSCONNChainLock );
         initialize_lock( &pLCSDev->InOutLock );
 
+        if (netring_init( &pLCSDev->Ring ) != 0)
+        {
+            char buf[40];
+            MSGBUF( buf, "malloc(%d)", NETRING_SIZE );
+            // "%1d:%04X %s: error in function %s: %s"
+            WRMSG( HHC00900, "E", SSID_TO_LCSS( pLCSDev->pDEVBLK[LCS_READ_SUBCHANN]->ssid),
+                pLCSDev->pDEVBLK[LCS_READ_SUBCHANN]->devnum, pLCSDev->pDEVBLK[LCS_READ_SUBCHANN]->typname,
+                buf, strerror( errno ));
+            return -1;
+        }
+
         // Create the TAP interface (if not already created by a
         // previous pass. More than one interface can exist on a port.
 
@@ -1137,6 +1149,8 @@ int  LCS_Close( DEVBLK* pDEVBLK )
                     pCurrLCSDev->pszIPAddress = NULL;
                 }
 
+                netring_term( &pCurrLCSDev->Ring );
+
                 free( pLCSDEV );
                 pLCSDEV = NULL;
                 break;
@@ -1208,13 +1222,26 @@ void  LCS_Query( DEVBLK* pDEVBLK, char** ppszClass,
         return;
     }
 
-    snprintf( pBuffer, iBufLen, "LCS Port %2.2X %s%s (%s)%s IO[%"PRIu64"]",
-              pLCSDEV->bPort,
-              pLCSDEV->bMode == LCSDEV_MODE_IP ? "IP" : "SNA",
-              sType[pLCSDEV->bType],
-              pLCSDEV->pLCSBLK->Port[pLCSDEV->bPort].szNetIfName,
-              pLCSDEV->pLCSBLK->fDebug ? " -d" : "",
-              pDEVBLK->excps );
+    if (pLCSDEV->bMode == LCSDEV_MODE_IP)
+        snprintf( pBuffer, iBufLen, "LCS Port %2.2X %s%s (%s)%s rq[%u/%u] bp[%"PRIu64"] dr[%"PRIu64"] IO[%"PRIu64"]",
+                  pLCSDEV->bPort,
+                  "IP",
+                  sType[pLCSDEV->bType],
+                  pLCSDEV->pLCSBLK->Port[pLCSDEV->bPort].szNetIfName,
+                  pLCSDEV->pLCSBLK->fDebug ? " -d" : "",
+                  netring_count( &pLCSDEV->Ring ),
+                  pLCSDEV->Ring.uHiWater,
+                  pLCSDEV->Ring.uFull,
+                  pLCSDEV->Ring.uDrops,
+                  pDEVBLK->excps );
+    else
+        snprintf( pBuffer, iBufLen, "LCS Port %2.2X %s%s (%s)%s IO[%"PRIu64"]",
+                  pLCSDEV->bPort,
+                  "SNA",
+                  sType[pLCSDEV->bType],
+                  pLCSDEV->pLCSBLK->Port[pLCSDEV->bPort].szNetIfName,
+                  pLCSDEV->pLCSBLK->fDebug ? " -d" : "",
+                  pDEVBLK->excps );
 }
 
 // ====================================================================
@@ -1423,6 +1450,8 @@ void  LCS_Write( DEVBLK* pDEVBLK,   U32   sCount,
                 return;
             }
             PTT_TIMING( "af write", 0, iEthLen, 1 );
+            pDEVBLK->nettxpkts++;
+            pDEVBLK->nettxbytes += iEthLen;
             break;
 
         case LCS_FRMTYP_CMD:    // LCS Command Frame
@@ -2289,6 +2318,7 @@ static void*  LCS_PortThread( void* arg)
     PIP4FRM     pIPFrame   = NULL;
     PARPFRM     pARPFrame  = NULL;
     int         iLength;
+    int         iBatch = 0;             // Frames not yet signalled
     U32         lIPAddress;             // (network byte order)
     BYTE*       pMAC;
     BYTE        szBuff[2048];
@@ -2305,10 +2335,23 @@ static void*  LCS_PortThread( void* arg)
 
     pLCSPORT->pid = getpid();
 
+#if !defined( OPTION_W32_CTCI )
+    // So frames already waiting can be read without a select
+    socket_set_blocking_mode( pLCSPORT->fd, 0 );
+#endif
+
     PTT_DEBUG(            "PORTHRD: ENTRY    ", 000, pDEVBLK->devnum, pLCSPORT->bPort );
 
     for (;;)
     {
+        // Don't leave frames unannounced while we wait to be started
+
+        if (iBatch && !pLCSPORT->fPortStarted)
+        {
+            LCS_SignalReads( pLCSPORT );
+            iBatch = 0;
+        }
+
         PTT_DEBUG(        "GET  PortEventLock", 000, pDEVBLK->devnum, pLCSPORT->bPort );
         obtain_lock( &pLCSPORT->PortEventLock );
         PTT_DEBUG(        "GOT  PortEventLock", 000, pDEVBLK->devnum, pLCSPORT->bPort );
@@ -2373,13 +2416,24 @@ static void*  LCS_PortThread( void* arg)
         if ( pLCSPORT->fd < 0 || pLCSPORT->fCloseInProgress )
             break;
 
-        // Read an IP packet from the TAP device
+        // Read an IP packet from the TAP device, but only wait
+        // for one if there are none waiting to be signalled
         PTT_TIMING( "b4 tt read", 0, 0, 0 );
-        iLength = read_tuntap( pLCSPORT->fd, szBuff, sizeof( szBuff ), DEF_NET_READ_TIMEOUT_SECS );
+        if (iBatch)
+            iLength = read_tuntap_nowait( pLCSPORT->fd, szBuff, sizeof( szBuff ) );
+        else
+            iLength = read_tuntap( pLCSPORT->fd, szBuff, sizeof( szBuff ), DEF_NET_READ_TIMEOUT_SECS );
         PTT_TIMING( "af tt read", 0, 0, iLength );
 
-        if (iLength == 0)      // (probably EINTR; ignore)
+        if (iLength == 0)      // (nothing more waiting, or EINTR)
+        {
+            if (iBatch)
+            {
+                LCS_SignalReads( pLCSPORT );
+                iBatch = 0;
+            }
             continue;
+        }
 
         // Check for other error condition
         if (iLength < 0)
@@ -2391,6 +2445,9 @@ static void*  LCS_PortThread( void* arg)
             break;
         }
 
+        pDEVBLK->netrxpkts++;
+        pDEVBLK->netrxbytes += iLength;
+
         // Point to ethernet frame and determine frame type
         pEthFrame = (PETHFRM)szBuff;
 
@@ -2685,6 +2742,12 @@ static void*  LCS_PortThread( void* arg)
         if (pMatchingLCSDEV->bMode == LCSDEV_MODE_IP)
         {
             LCS_EnqueueEthFrame( pLCSPORT, pMatchingLCSDEV, szBuff, iLength );
+
+            if (++iBatch >= NETRING_BATCH)
+            {
+                LCS_SignalReads( pLCSPORT );
+                iBatch = 0;
+            }
         }
         else  //  (pMatchingLCSDEV->bMode == LCSDEV_MODE_SNA)
         {
@@ -2735,9 +2798,11 @@ static void*  LCS_PortThread( void* arg)
 //                       LCS_EnqueueEthFrame
 // ====================================================================
 //
-// Places the provided ethernet frame in the next available frame
-// slot in the adapter buffer. If buffer is full, keep trying.
-// The LCS device data lock must NOT be held when called!
+// Adds the provided ethernet frame to the device's frame ring, from
+// which LCS_Read moves it into the adapter buffer. If the ring is
+// full, LCS_Read is told about the frames already there and we wait
+// for it to make room. Called only by LCS_PortThread, which must call
+// LCS_SignalReads once it has no more frames to add for the moment.
 //
 // --------------------------------------------------------------------
 
@@ -2753,26 +2818,28 @@ static void LCS_EnqueueEthFrame( PLCSPORT pLCSPORT, PLCSDEV pLCSDEV, BYTE* pData
 
     PTT_DEBUG( "ENQ EthFrame ENTRY", 000, pDEVBLK->devnum, bPort );
 
+    // Will frame NEVER fit into buffer??
+    if (iSize > MAX_LCS_ETH_FRAME_SIZE( pLCSDEV ) || iSize > 9000)
+    {
+        pLCSDEV->Ring.uDrops++;
+        // "CTC: lcs device port %2.2X: packet frame too big, dropped"
+        WRMSG( HHC00953, "W", bPort );
+        PTT_TIMING( "*enq drop", 0, iSize, 0 );
+        return;
+    }
+
     time( &t1 );
 
     PTT_TIMING( "b4 enqueue", 0, iSize, 0 );
 
-    // While port open, not close in progress, and frame buffer full...
+    // While port open, not close in progress, and frame ring full...
 
     while (1
         &&  pLCSPORT->fd != -1
         && !pLCSPORT->fCloseInProgress
-        && LCS_DoEnqueueEthFrame( pLCSPORT, pLCSDEV, pData, iSize ) < 0
+        && netring_put( &pLCSDEV->Ring, pData, (int)iSize ) < 0
     )
     {
-        if (EMSGSIZE == errno)
-        {
-            // "CTC: lcs device port %2.2X: packet frame too big, dropped"
-            WRMSG( HHC00953, "W", bPort );
-            PTT_TIMING( "*enq drop", 0, iSize, 0 );
-            break;
-        }
-
         if (pLCSDEV->pLCSBLK->fDebug)
         {
             // Limit message rate to only once every few seconds...
@@ -2795,56 +2862,76 @@ static void LCS_EnqueueEthFrame( PLCSPORT pLCSPORT, PLCSDEV pLCSDEV, BYTE* pData
         }
         PTT_TIMING( "*enq wait", 0, iSize, 0 );
 
-        // Wait for LCS_Read to empty the buffer...
+        // Wait for LCS_Read to empty the ring...
 
-        ASSERT( ENOBUFS == errno );
-        usleep( CTC_DELAY_USECS );
+        LCS_SignalReads( pLCSPORT );
+        netring_wait( &pLCSDEV->Ring, (int)iSize, NETRING_WAIT_MSECS );
     }
+
+    pLCSDEV->iRingBatch++;
+
     PTT_TIMING( "af enqueue", 0, iSize, 0 );
     PTT_DEBUG( "ENQ EthFrame EXIT ", 000, pDEVBLK->devnum, bPort );
 }
 
 // ====================================================================
-//                       LCS_DoEnqueueEthFrame
+//                       LCS_SignalReads
 // ====================================================================
 //
-// Places the provided ethernet frame in the next available frame
-// slot in the adapter buffer.
-//
-//   pData       points the the Ethernet packet just received
-//   iSize       is the size of the Ethernet packet
+// Wakes the LCS_Read function of each device on the port to which
+// LCS_PortThread has added frames since the last call.
 //
-// Returns:
+// --------------------------------------------------------------------
+
+static void LCS_SignalReads( PLCSPORT pLCSPORT )
+{
+    PLCSDEV   pLCSDEV;
+    DEVBLK*   pDEVBLK;
+    BYTE      bPort = pLCSPORT->bPort;
+
+
+    for (pLCSDEV = pLCSPORT->pLCSBLK->pDevices; pLCSDEV; pLCSDEV = pLCSDEV->pNext)
+    {
+        if (pLCSDEV->bPort != bPort || !pLCSDEV->iRingBatch)
+            continue;
+
+        pLCSDEV->iRingBatch = 0;
+        pLCSDEV->Ring.uBatches++;
+
+        pDEVBLK = pLCSDEV->pDEVBLK[ LCS_READ_SUBCHANN ];
+
+        // (wake up "LCS_Read" function)
+        PTT_DEBUG(       "GET  DevEventLock ", 000, pDEVBLK->devnum, bPort );
+        obtain_lock( &pLCSDEV->DevEventLock );
+        PTT_DEBUG(       "GOT  DevEventLock ", 000, pDEVBLK->devnum, bPort );
+        {
+            PTT_DEBUG(            "SIG  DevEvent     ", 000, pDEVBLK->devnum, bPort );
+            signal_condition( &pLCSDEV->DevEvent );
+        }
+        PTT_DEBUG(        "REL  DevEventLock ", 000, pDEVBLK->devnum, bPort );
+        release_lock( &pLCSDEV->DevEventLock );
+    }
+}
+
+// ====================================================================
+//                       LCS_DrainRing
+// ====================================================================
 //
-//  0 == Success
-// -1 == Failure; errno = ENOBUFS:  No buffer space available
-//                        EMSGSIZE: Message too long
+// Moves as many ethernet frames from the device's frame ring as will
+// fit into the next available frame slots in the adapter buffer.
 //
-// The LCS device data lock must NOT be held when called!
+// The LCS device data lock MUST be held when called!
 //
 // --------------------------------------------------------------------
 
-static int  LCS_DoEnqueueEthFrame( PLCSPORT pLCSPORT, PLCSDEV pLCSDEV, BYTE* pData, size_t iSize )
+static void  LCS_DrainRing( PLCSDEV pLCSDEV )
 {
     PLCSETHFRM  pLCSEthFrame;
-    DEVBLK*     pDEVBLK;
-    BYTE        bPort;
-
+    BYTE*       pData;
+    int         iSize;
 
-    pDEVBLK = pLCSDEV->pDEVBLK[ LCS_READ_SUBCHANN ];
-    bPort   = pLCSPORT->bPort;
 
-    // Will frame NEVER fit into buffer??
-    if (iSize > MAX_LCS_ETH_FRAME_SIZE( pLCSDEV ) || iSize > 9000)
-    {
-        PTT_DEBUG( "*DoENQEth EMSGSIZE", 000, pDEVBLK->devnum, bPort );
-        errno = EMSGSIZE;   // Message too long
-        return -1;          // (-1==failure)
-    }
-
-    PTT_DEBUG(       "GET  DevDataLock  ", 000, pDEVBLK->devnum, bPort );
-    obtain_lock( &pLCSDEV->DevDataLock );
-    PTT_DEBUG(       "GOT  DevDataLock  ", 000, pDEVBLK->devnum, bPort );
+    while ((iSize = netring_peek( &pLCSDEV->Ring, &pData )) > 0)
     {
         // Ensure we dont overflow the buffer
         if (( pLCSDEV->iFrameOffset +                   // Current buffer Offset
@@ -2852,13 +2939,7 @@ static int  LCS_DoEnqueueEthFrame( PLCSPORT pLCSPORT, PLCSDEV pLCSDEV, BYTE* pDa
               iSize +                                   // Size of Ethernet packet
               sizeof(pLCSEthFrame->bLCSHdr.hwOffset) )  // Size of Frame terminator
             > pLCSDEV->iMaxFrameBufferSize)             // Size of Frame buffer
-        {
-            PTT_DEBUG( "*DoENQEth ENOBUFS ", 000, pDEVBLK->devnum, bPort );
-            PTT_DEBUG(        "REL  DevDataLock  ", 000, pDEVBLK->devnum, bPort );
-            release_lock( &pLCSDEV->DevDataLock );
-            errno = ENOBUFS;    // No buffer space available
-            return -1;          // (-1==failure)
-        }
+            break;                                      // (leave it for next time)
 
         // Point to next available LCS Frame slot in our buffer
         pLCSEthFrame = (PLCSETHFRM)( pLCSDEV->bFrameBuffer +
@@ -2872,30 +2953,17 @@ static int  LCS_DoEnqueueEthFrame( PLCSPORT pLCSPORT, PLCSDEV pLCSDEV, BYTE* pDa
 
         // Finish building the LCS Ethernet Passthru frame header
         pLCSEthFrame->bLCSHdr.bType = LCS_FRMTYP_ENET;
-        pLCSEthFrame->bLCSHdr.bSlot = bPort;
+        pLCSEthFrame->bLCSHdr.bSlot = pLCSDEV->bPort;
 
         // Copy Ethernet packet to LCS Ethernet Passthru frame
         memcpy( pLCSEthFrame->bData, pData, iSize );
 
+        // Let LCS_PortThread reuse the space
+        netring_pop( &pLCSDEV->Ring );
+
         // Tell "LCS_Read" function that data is available for reading
-        PTT_DEBUG( "SET  DataPending  ", 1, pDEVBLK->devnum, bPort );
         pLCSDEV->fDataPending = 1;
     }
-    PTT_DEBUG(        "REL  DevDataLock  ", 000, pDEVBLK->devnum, bPort );
-    release_lock( &pLCSDEV->DevDataLock );
-
-    // (wake up "LCS_Read" function)
-    PTT_DEBUG(       "GET  DevEventLock ", 000, pDEVBLK->devnum, bPort );
-    obtain_lock( &pLCSDEV->DevEventLock );
-    PTT_DEBUG(       "GOT  DevEventLock ", 000, pDEVBLK->devnum, bPort );
-    {
-        PTT_DEBUG(            "SIG  DevEvent     ", 000, pDEVBLK->devnum, bPort );
-        signal_condition( &pLCSDEV->DevEvent );
-    }
-    PTT_DEBUG(        "REL  DevEventLock ", 000, pDEVBLK->devnum, bPort );
-    release_lock( &pLCSDEV->DevEventLock );
-
-    return 0;       // (success)
 }
 
 // ====================================================================
@@ -2953,6 +3021,9 @@ void  LCS_Read( DEVBLK* pDEVBLK,   U32   sCount,
         obtain_lock( &pLCSDEV->DevDataLock );
         PTT_DEBUG(       "GOT  DevDataLock  ", 000, pDEVBLK->devnum, -1 );
         {
+            // Move whatever LCS_PortThread has queued into the buffer
+            LCS_DrainRing( pLCSDEV );
+
             if (pLCSDEV->fDataPending || pLCSDEV->fReplyPending)
                 break;
         }
@@ -2970,12 +3041,17 @@ void  LCS_Read( DEVBLK* pDEVBLK,   U32   sCount,
         obtain_lock( &pLCSDEV->DevEventLock );
         PTT_DEBUG(       "GOT  DevEventLock ", 000, pDEVBLK->devnum, -1 );
         {
-            PTT_DEBUG( "WAIT DevEventLock ", 000, pDEVBLK->devnum, -1 );
-            pLCSDEV->fReadWaiting = 1;
-            timed_wait_condition( &pLCSDEV->DevEvent,
-                                  &pLCSDEV->DevEventLock,
-                                  &waittime );
-            pLCSDEV->fReadWaiting = 0;
+            // (LCS_SignalReads holds DevEventLock when signalling,
+            // so a frame queued since we looked can't be missed)
+            if (!netring_count( &pLCSDEV->Ring ))
+            {
+                PTT_DEBUG( "WAIT DevEventLock ", 000, pDEVBLK->devnum, -1 );
+                pLCSDEV->fReadWaiting = 1;
+                timed_wait_condition( &pLCSDEV->DevEvent,
+                                      &pLCSDEV->DevEventLock,
+                                      &waittime );
+                pLCSDEV->fReadWaiting = 0;
+            }
         }
 
         PTT_DEBUG(        "WOKE DevEventLock ", 000, pDEVBLK->devnum, -1 );
@@ -7919,9 +7995,8 @@ HDL_REGISTER_SECTION;       // ("Register" our entry-points)
 #if defined( WIN32 )
   HDL_REGISTER ( debug_tt32_stats,   display_tt32_stats        );
   HDL_REGISTER ( debug_tt32_tracing, enable_tt32_debug_tracing );
-#else
-  UNREFERENCED( regsym );   // (HDL_REGISTER_SECTION parameter)
 #endif
+  HDL_REGISTER ( ctce_bench,         CTCE_Bench                );
 
 END_REGISTER_SECTION
 
@@ -99,6 +99,8 @@ static void     read_chain_buffer( DEVBLK* pDEVBLK,   U32  uCount,
                                    U32*    pResidual, PTPHDR* pPTPHDR );
 
 static void*    ptp_read_thread( void* arg /* PTPBLK* pPTPBLK */ );
+static void     signal_read_event( PTPBLK* pPTPBLK );
+static void     drain_read_ring( DEVBLK* pDEVBLK, PTPBLK* pPTPBLK );
 
 static void*    add_buffer_to_chain_and_signal_event( PTPATH* pPTPATH, PTPHDR* pPTPHDR );
 static void*    add_buffer_to_chain( PTPATH* pPTPATH, PTPHDR* pPTPHDR );
@@ -471,6 +473,26 @@ int  ptp_init( DEVBLK* pDEVBLK, int argc, char *argv[] )
     initialize_lock( &pPTPATHwr->UnsolEventLock );
     initialize_condition( &pPTPATHwr->UnsolEvent );
 
+    // Allocate the ring between the read thread and the Read path.
+    if (netring_init( &pPTPBLK->Ring ) != 0)
+    {
+        char buf[40];
+        MSGBUF( buf, "malloc(%d)", NETRING_SIZE );
+        // HHC00900 "%1d:%04X %s: error in function %s: %s"
+        WRMSG(HHC00900, "E", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum,
+                             pDEVBLK->typname, buf, strerror( errno ) );
+        // Disconnect the DEVGRP from the PTPBLK.
+        pDEVBLK->group->grp_data = NULL;
+        // Disconnect the DEVBLKs from the PTPATHs.
+        pPTPBLK->pDEVBLKRead->dev_data = NULL;
+        pPTPBLK->pDEVBLKWrite->dev_data = NULL;
+        // Free the PTPATHs and PTPBLK
+        free( pPTPATHwr );
+        free( pPTPATHre );
+        free( pPTPBLK );
+        return -1;
+    }
+
     // Create the TUN interface.
     rc = TUNTAP_CreateInterface( pPTPBLK->szTUNCharDevName,
 #if defined(BUILD_HERCIFC)
@@ -481,6 +503,8 @@ int  ptp_init( DEVBLK* pDEVBLK, int argc, char *argv[] )
                                  pPTPBLK->szTUNIfName );
     if (rc < 0)
     {
+        // Free the ring.
+        netring_term( &pPTPBLK->Ring );
         // Disconnect the DEVGRP from the PTPBLK.
         pDEVBLK->group->grp_data = NULL;
         // Disconnect the DEVBLKs from the PTPATHs.
@@ -583,6 +607,8 @@ int  ptp_init( DEVBLK* pDEVBLK, int argc, char *argv[] )
         // Close the TUN interface.
         VERIFY( pPTPBLK->fd == -1 || TUNTAP_Close( pPTPBLK->fd ) == 0 );
         pPTPBLK->fd = -1;
+        // Free the ring.
+        netring_term( &pPTPBLK->Ring );
         // Disconnect the DEVGRP from the PTPBLK.
         pDEVBLK->group->grp_data = NULL;
         // Disconnect the DEVBLKs from the PTPATHs.
@@ -859,12 +885,14 @@ int  ptp_close( DEVBLK* pDEVBLK )
 
         TID tid = pPTPBLK->tid;
         pPTPBLK->fCloseInProgress = 1;  // (ask read thread to exit)
-#if defined(_MSVC_)
         join_thread( tid, NULL );       // (wait for thread to end)
-#endif
         detach_thread( tid );           // (wait for thread to end)
     }
 
+    // The read thread is gone, so its packet ring can be released
+    // (only the first of the two devices to be closed releases it)
+    netring_term( &pPTPBLK->Ring );
+
     pDEVBLK->fd = -1;           // indicate we're now closed
 
     return 0;
@@ -926,7 +954,7 @@ void  ptp_query( DEVBLK* pDEVBLK, char** ppszClass,
 
     if (pPTPBLK->fIPv4Spec && pPTPBLK->fIPv6Spec)
     {
-        snprintf( pBuffer, iBufLen, "%s %s/%s %s/%s (%s)%s IO[%"PRIu64"]",
+        snprintf( pBuffer, iBufLen, "%s %s/%s %s/%s (%s)%s rq[%u/%u] bp[%"PRIu64"] dr[%"PRIu64"] IO[%"PRIu64"]",
                   pPTPBLK->pDEVBLKRead->typname,
                   pGuestIP4,
                   pDriveIP4,
@@ -934,28 +962,40 @@ void  ptp_query( DEVBLK* pDEVBLK, char** ppszClass,
                   pDriveIP6,
                   pPTPBLK->szTUNIfName,
                   pPTPBLK->uDebugMask ? " -d" : "",
+                  netring_count( &pPTPBLK->Ring ),
+                  pPTPBLK->Ring.uHiWater,
+                  pPTPBLK->Ring.uFull,
+                  pPTPBLK->Ring.uDrops,
                   pDEVBLK->excps );
     }
     else if (pPTPBLK->fIPv4Spec)
     {
 #endif /* defined(ENABLE_IPV6) */
-        snprintf( pBuffer, iBufLen, "%s %s/%s (%s)%s IO[%"PRIu64"]",
+        snprintf( pBuffer, iBufLen, "%s %s/%s (%s)%s rq[%u/%u] bp[%"PRIu64"] dr[%"PRIu64"] IO[%"PRIu64"]",
                   pPTPBLK->pDEVBLKRead->typname,
                   pGuestIP4,
                   pDriveIP4,
                   pPTPBLK->szTUNIfName,
                   pPTPBLK->uDebugMask ? " -d" : "",
+                  netring_count( &pPTPBLK->Ring ),
+                  pPTPBLK->Ring.uHiWater,
+                  pPTPBLK->Ring.uFull,
+                  pPTPBLK->Ring.uDrops,
                   pDEVBLK->excps );
 #if defined(ENABLE_IPV6)
     }
     else
     {
-        snprintf( pBuffer, iBufLen, "%s %s/%s (%s)%s IO[%"PRIu64"]",
+        snprintf( pBuffer, iBufLen, "%s %s/%s (%s)%s rq[%u/%u] bp[%"PRIu64"] dr[%"PRIu64"] IO[%"PRIu64"]",
                   pPTPBLK->pDEVBLKRead->typname,
                   pGuestIP6,
                   pDriveIP6,
                   pPTPBLK->szTUNIfName,
                   pPTPBLK->uDebugMask ? " -d" : "",
+                  netring_count( &pPTPBLK->Ring ),
+                  pPTPBLK->Ring.uHiWater,
+                  pPTPBLK->Ring.uFull,
+                  pPTPBLK->Ring.uDrops,
                   pDEVBLK->excps );
     }
 #endif /* defined(ENABLE_IPV6) */
@@ -1566,6 +1606,9 @@ void  ptp_read( DEVBLK* pDEVBLK, U32  uCount,
             // Obtain the read buffer lock.
             obtain_lock( &pPTPBLK->ReadBufferLock );
 
+            // Move whatever ptp_read_thread has queued into the buffer.
+            drain_read_ring( pDEVBLK, pPTPBLK );
+
             pPTPHDR = pPTPBLK->pReadBuffer;
             if (pPTPHDR && pPTPHDR->iDataLen > LEN_OF_PAGE_ONE)
             {
@@ -1591,12 +1634,17 @@ void  ptp_read( DEVBLK* pDEVBLK, U32  uCount,
             // Obtain the event lock
             obtain_lock( &pPTPBLK->ReadEventLock );
 
-            // Use a calculated wait
-            pPTPBLK->fReadWaiting = 1;
-            rc = timed_wait_condition( &pPTPBLK->ReadEvent,
-                                       &pPTPBLK->ReadEventLock,
-                                       &waittime );
-            pPTPBLK->fReadWaiting = 0;
+            // Use a calculated wait, unless ptp_read_thread has queued
+            // a packet since we looked. (signal_read_event() holds the
+            // event lock when signalling, so the signal can't be missed.)
+            if (!netring_count( &pPTPBLK->Ring ))
+            {
+                pPTPBLK->fReadWaiting = 1;
+                rc = timed_wait_condition( &pPTPBLK->ReadEvent,
+                                           &pPTPBLK->ReadEventLock,
+                                           &waittime );
+                pPTPBLK->fReadWaiting = 0;
+            }
 
             // check for halt condition
             if (pPTPBLK->fHaltOrClear)
@@ -1974,9 +2022,13 @@ void  read_chain_buffer( DEVBLK* pDEVBLK,   U32  uCount,
 /* ------------------------------------------------------------------ */
 /* ptp_read_thread()                                                  */
 /* ------------------------------------------------------------------ */
-// The ptp_read_thread() reads data from the TUN interface, stores
-// the data in the path read buffer, from where the data is read by
-// the read path of the MPCPTP/MPCPTP6 connection.
+// The ptp_read_thread() reads data from the TUN interface and adds
+// it to the packet ring, from where drain_read_ring() moves it to the
+// path read buffer, from where the data is read by the read path of
+// the MPCPTP/MPCPTP6 connection. The ptp_read_thread() reads all of
+// the packets that are waiting (up to NETRING_BATCH of them) before
+// waking ptp_read(), and when the ring is full it waits for ptp_read()
+// to make room rather than retrying.
 //
 // The size of the read buffer is determined by the maximum read
 // length reported by the y-side during handshaking. The y-side
@@ -2043,11 +2095,7 @@ void*  ptp_read_thread( void* arg )
     PIP6FRM    pIP6FRM;                        // IPv6 packet in TUN read buffer
     int        iTunLen;                        // TUN read length
     int        iLength;                        // Length of data in TUN read buffer
-    PTPHDR*    pPTPHDR;                        // PTPHDR of the path read buffer
-    MPC_TH*    pMPC_TH;                        // MPC_TH follows the PTPHDR
-//  MPC_RRH*   pMPC_RRH;                       // MPC_RRH follows the MPC_TH
-//  MPC_PH*    pMPC_PH;                        // MPC_PH follows the MPC_RRH
-    BYTE*      pData;                          //
+    int        iBatch = 0;                     // Packets not yet signalled
     U16        uPayLen;
     int        iPktVer;
     char       cPktVer[8];
@@ -2074,12 +2122,21 @@ void*  ptp_read_thread( void* arg )
 
     pPTPBLK->pid = getpid();
 
+#if !defined( OPTION_W32_CTCI )
+    // So packets already waiting can be read without a select.
+    socket_set_blocking_mode( pPTPBLK->fd, 0 );
+#endif
+
     // Keep going until we have to stop.
     while( pPTPBLK->fd != -1 && !pPTPBLK->fCloseInProgress )
     {
 
-        // Read an IP packet from the TUN interface.
-        iLength = TUNTAP_Read( pPTPBLK->fd, (void*)pTunBuf, iTunLen );
+        // Read an IP packet from the TUN interface, but only wait for
+        // one if there are none waiting to be signalled.
+        if (iBatch)
+            iLength = read_tuntap_nowait( pPTPBLK->fd, pTunBuf, iTunLen );
+        else
+            iLength = read_tuntap( pPTPBLK->fd, pTunBuf, iTunLen, PTP_READ_TIMEOUT_SECS );
 
         // Check for error conditions...
         if (iLength < 0)
@@ -2093,8 +2150,15 @@ void*  ptp_read_thread( void* arg )
             break;
         }
 
-        if (iLength == 0)       // (probably EINTR; ignore)
+        if (iLength == 0)       // (nothing more waiting, or EINTR)
+        {
+            if (iBatch)
+            {
+                signal_read_event( pPTPBLK );
+                iBatch = 0;
+            }
             continue;
+        }
 
         // Check the IP packet version. The first 4-bits of the first
         // byte of the IP header contains the version number.
@@ -2171,153 +2235,166 @@ void*  ptp_read_thread( void* arg )
             continue;
         }
 
-        // Enqueue IP packet.
-        while( pPTPBLK->fd != -1 && !pPTPBLK->fCloseInProgress )
+        // Check whether the interface is ready for data from the TUN interface.
+        if (iPktVer == 4)
         {
+            if (!pPTPBLK->fActive4)
+                continue;
+        }
+        else
+        {
+            if (!pPTPBLK->fActive6)
+                continue;
+        }
 
-            // Obtain the read buffer lock.
-            obtain_lock( &pPTPBLK->ReadBufferLock );
-
-            // Check whether the interface is ready for data from the TUN interface.
-            if (iPktVer == 4)
-            {
-                if (!pPTPBLK->fActive4)
-                {
-                    // Release the read buffer lock.
-                    release_lock( &pPTPBLK->ReadBufferLock );
-                    break;
-                }
-            }
-            else
+        // Check whether the IP packet is larger than y-side's actual MTU.
+        // If it is then it is dropped.
+        if (iLength > pPTPBLK->yActMTU)
+        {
+            pPTPBLK->Ring.uDrops++;
+            // HHC03923 "%1d:%04X PTP: Packet of size %d bytes from device '%s' is larger than the guests actual MTU of %d bytes, packet dropped"
+            WRMSG(HHC03923, "W", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum,
+                                 iLength, pPTPBLK->szTUNIfName,
+                                 (int)pPTPBLK->yActMTU );
+            iTraceLen = iLength;
+            if (iTraceLen > 128)
             {
-                if (!pPTPBLK->fActive6)
-                {
-                    // Release the read buffer lock.
-                    release_lock( &pPTPBLK->ReadBufferLock );
-                    break;
-                }
+                iTraceLen = 128;
+                // HHC00980 "%1d:%04X PTP: Data of size %d bytes displayed, data of size %d bytes not displayed"
+                WRMSG(HHC00980, "I", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum, pDEVBLK->typname,
+                                     iTraceLen, iLength - iTraceLen );
             }
+            net_data_trace( pDEVBLK, (BYTE*)pTunBuf, iTraceLen, TO_GUEST, 'I', "data", 0 );
+            continue;
+        }
 
-            // Check that there is a read buffer.
-            pPTPHDR = pPTPBLK->pReadBuffer;
-            if (!pPTPHDR)
-            {
-                // Release the read buffer lock.
-                release_lock( &pPTPBLK->ReadBufferLock );
-                break;
-            }
+        // Display the IP packet just read, if the device group is being debugged.
+        if (pPTPBLK->uDebugMask & DBGPTPPACKET)
+        {
+            // HHC00913 "%1d:%04X %s: Receive%s packet of size %d bytes from device %s"
+            WRMSG(HHC00913, "D", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum, pDEVBLK->typname,
+                                 cPktVer, iLength, pPTPBLK->szTUNIfName );
+            net_data_trace( pDEVBLK, (BYTE*)pTunBuf, iLength, TO_GUEST, 'D', "packet", 0 );
+        }
 
-            // Check whether the IP packet is larger than y-side's actual MTU.
-            // If it is then it is dropped.
-            if (iLength > pPTPBLK->yActMTU)
+        // Enqueue IP packet. If the ring is full, let ptp_read() have
+        // what we've got so far and wait for it to make room.
+        while( netring_put( &pPTPBLK->Ring, pTunBuf, iLength ) < 0
+            && pPTPBLK->fd != -1 && !pPTPBLK->fCloseInProgress )
+        {
+            if (iBatch)
             {
-                // Release the read buffer lock.
-                release_lock( &pPTPBLK->ReadBufferLock );
-                // HHC03923 "%1d:%04X PTP: Packet of size %d bytes from device '%s' is larger than the guests actual MTU of %d bytes, packet dropped"
-                WRMSG(HHC03923, "W", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum,
-                                     iLength, pPTPBLK->szTUNIfName,
-                                     (int)pPTPBLK->yActMTU );
-                iTraceLen = iLength;
-                if (iTraceLen > 128)
-                {
-                    iTraceLen = 128;
-                    // HHC00980 "%1d:%04X PTP: Data of size %d bytes displayed, data of size %d bytes not displayed"
-                    WRMSG(HHC00980, "I", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum, pDEVBLK->typname,
-                                         iTraceLen, iLength - iTraceLen );
-                }
-                net_data_trace( pDEVBLK, (BYTE*)pTunBuf, iTraceLen, TO_GUEST, 'I', "data", 0 );
-                break;
+                signal_read_event( pPTPBLK );
+                iBatch = 0;
             }
+            netring_wait( &pPTPBLK->Ring, iLength, NETRING_WAIT_MSECS );
+        }
 
-            // Check whether the IP packet will ever fit into the read buffer.
-            // If it will not then it is dropped.
-            if (iLength > (pPTPHDR->iAreaLen - LEN_OF_PAGE_ONE))
-            {
-                // Release the read buffer lock.
-                release_lock( &pPTPBLK->ReadBufferLock );
-                // HHC03924 "%1d:%04X PTP: Packet of size %d bytes from device '%s' is too large for read buffer area of %d bytes, packet dropped"
-                WRMSG(HHC03924, "W", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum,
-                                     iLength, pPTPBLK->szTUNIfName,
-                                     pPTPHDR->iAreaLen - LEN_OF_PAGE_ONE );
-                iTraceLen = iLength;
-                if (iTraceLen > 128)
-                {
-                    iTraceLen = 128;
-                    // HHC00980 "%1d:%04X PTP: Data of size %d bytes displayed, data of size %d bytes not displayed"
-                    WRMSG(HHC00980, "I", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum, pDEVBLK->typname,
-                                         iTraceLen, iLength - iTraceLen );
-                }
-                net_data_trace( pDEVBLK, (BYTE*)pTunBuf, iTraceLen, TO_GUEST, 'I', "data", 0 );
-                break;
-            }
+        if (++iBatch >= NETRING_BATCH)
+        {
+            signal_read_event( pPTPBLK );
+            iBatch = 0;
+        }
 
-            // Check whether the IP packet will fit into the read buffer.
-            if (iLength > (pPTPHDR->iAreaLen - pPTPHDR->iDataLen))
-            {
-                // The IP packet will not fit into the read buffer at the
-                // moment, presumably there are IP packets waiting to be read.
+    }   /* while( pPTPBLK->fd != -1 && !pPTPBLK->fCloseInProgress ) */
 
-                // Release the read buffer lock.
-                release_lock( &pPTPBLK->ReadBufferLock );
+    // We must do the close since we were the one doing the i/o...
+    VERIFY( pPTPBLK->fd == -1 || TUNTAP_Close( pPTPBLK->fd ) == 0 );
+    pPTPBLK->fd = -1;
 
-                // Don't use schedyield() here; use an actual non-dispatchable
-                // delay instead so as to allow another [possibly lower priority]
-                // thread to 'read' (remove) the packet(s) from the read buffer.
-                usleep( PTP_DELAY_USECS );  // (wait a bit before retrying...)
+    // Release the TUN read buffer.
+    free( pTunBuf );
+    pTunBuf = NULL;
+    iTunLen = 0;
 
-                continue;
+    return NULL;
+}   /* End function  ptp_read_thread() */
 
-            }
-            else
-            {
-                // The IP packet will fit into the read buffer.
 
-                // Display the IP packet just read, if the device group is being debugged.
-                if (pPTPBLK->uDebugMask & DBGPTPPACKET)
-                {
-                    // HHC00913 "%1d:%04X %s: Receive%s packet of size %d bytes from device %s"
-                    WRMSG(HHC00913, "D", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum, pDEVBLK->typname,
-                                         cPktVer, iLength, pPTPBLK->szTUNIfName );
-                    net_data_trace( pDEVBLK, (BYTE*)pTunBuf, iLength, TO_GUEST, 'D', "packet", 0 );
-                }
+/* ------------------------------------------------------------------ */
+/* signal_read_event(): Wake ptp_read() for queued packets            */
+/* ------------------------------------------------------------------ */
 
-                // Fix-up various pointers
-                pMPC_TH = (MPC_TH*)((BYTE*)pPTPHDR + SIZE_HDR);
-                pData   = (BYTE*)pMPC_TH + pPTPHDR->iDataLen;
+void  signal_read_event( PTPBLK* pPTPBLK )
+{
+    pPTPBLK->Ring.uBatches++;
 
-                // Copy the IP packet from the TUN/TAP read buffer
-                memcpy( pData, pTunBuf, iLength );
+    obtain_lock( &pPTPBLK->ReadEventLock );
+    signal_condition( &pPTPBLK->ReadEvent );
+    release_lock( &pPTPBLK->ReadEventLock );
+}   /* End function  signal_read_event() */
 
-                // Increment length field in PTPHDR
-                pPTPHDR->iDataLen += iLength;
 
-                // Release the read buffer lock.
-                release_lock( &pPTPBLK->ReadBufferLock );
+/* ------------------------------------------------------------------ */
+/* drain_read_ring(): Move queued packets to the path read buffer     */
+/* ------------------------------------------------------------------ */
+// Moves as many IP packets from the ring as will fit into the path
+// read buffer. Packets that can no longer be delivered, because the
+// connection is no longer active or they will never fit into the
+// read buffer, are dropped. The read buffer lock must be held.
 
-                //
-                obtain_lock( &pPTPBLK->ReadEventLock );
-                signal_condition( &pPTPBLK->ReadEvent );
-                release_lock( &pPTPBLK->ReadEventLock );
+void  drain_read_ring( DEVBLK* pDEVBLK, PTPBLK* pPTPBLK )
+{
+    PTPHDR*    pPTPHDR = pPTPBLK->pReadBuffer; // PTPHDR of the path read buffer
+    MPC_TH*    pMPC_TH;                        // MPC_TH follows the PTPHDR
+    BYTE*      pPacket;                        // IP packet in the ring
+    int        iLength;                        // Length of IP packet
+    int        iPktVer;
+    int        iTraceLen;
 
-                break;
 
-            }   /* if (iLength > (pPTPHDR->iAreaLen - pPTPHDR->iDataLen)) */
+    while ((iLength = netring_peek( &pPTPBLK->Ring, &pPacket )) > 0)
+    {
 
-        }   /* while( pPTPBLK->fd != -1 && !pPTPBLK->fCloseInProgress ) */
+        // Check whether the interface is still ready for the data.
+        iPktVer = ( ( pPacket[0] & 0xF0 ) >> 4 );
+        if (!pPTPHDR || !(iPktVer == 4 ? pPTPBLK->fActive4 : pPTPBLK->fActive6))
+        {
+            netring_pop( &pPTPBLK->Ring );
+            continue;
+        }
 
-    }   /* while( pPTPBLK->fd != -1 && !pPTPBLK->fCloseInProgress ) */
+        // Check whether the IP packet will ever fit into the read buffer.
+        // If it will not then it is dropped.
+        if (iLength > (pPTPHDR->iAreaLen - LEN_OF_PAGE_ONE))
+        {
+            pPTPBLK->Ring.uDrops++;
+            // HHC03924 "%1d:%04X PTP: Packet of size %d bytes from device '%s' is too large for read buffer area of %d bytes, packet dropped"
+            WRMSG(HHC03924, "W", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum,
+                                 iLength, pPTPBLK->szTUNIfName,
+                                 pPTPHDR->iAreaLen - LEN_OF_PAGE_ONE );
+            iTraceLen = iLength;
+            if (iTraceLen > 128)
+            {
+                iTraceLen = 128;
+                // HHC00980 "%1d:%04X PTP: Data of size %d bytes displayed, data of size %d bytes not displayed"
+                WRMSG(HHC00980, "I", SSID_TO_LCSS(pDEVBLK->ssid), pDEVBLK->devnum, pDEVBLK->typname,
+                                     iTraceLen, iLength - iTraceLen );
+            }
+            net_data_trace( pDEVBLK, pPacket, iTraceLen, TO_GUEST, 'I', "data", 0 );
+            netring_pop( &pPTPBLK->Ring );
+            continue;
+        }
 
-    // We must do the close since we were the one doing the i/o...
-    VERIFY( pPTPBLK->fd == -1 || TUNTAP_Close( pPTPBLK->fd ) == 0 );
-    pPTPBLK->fd = -1;
+        // Check whether the IP packet will fit into the read buffer. If
+        // not, it stays in the ring until the buffer has been read.
+        if (iLength > (pPTPHDR->iAreaLen - pPTPHDR->iDataLen))
+            break;
 
-    // Release the TUN read buffer.
-    free( pTunBuf );
-    pTunBuf = NULL;
-    iTunLen = 0;
+        // Copy the IP packet from the ring to the read buffer.
+        pMPC_TH = (MPC_TH*)((BYTE*)pPTPHDR + SIZE_HDR);
+        memcpy( (BYTE*)pMPC_TH + pPTPHDR->iDataLen, pPacket, iLength );
 
-    return NULL;
-}   /* End function  ptp_read_thread() */
+        // Increment length field in PTPHDR
+        pPTPHDR->iDataLen += iLength;
+
+        // Let ptp_read_thread reuse the space.
+        netring_pop( &pPTPBLK->Ring );
+
+    }
+
+    return;
+}   /* End function  drain_read_ring() */
 
 
 /* ------------------------------------------------------------------ */
@@ -90,6 +90,8 @@ struct  _PTPBLK
     PPTPHDR     pReadBuffer;               // Read buffer
     int         iReadBufferGen;            // Read buffer generation
 
+    NETRING     Ring;                      // Packets from ptp_read_thread
+
     LOCK        ReadEventLock;             // Condition LOCK
     COND        ReadEvent;                 // Condition signal
 
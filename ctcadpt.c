@@ -165,7 +165,8 @@ static int      CTCE_Get_Socket( DEVBLK*                   dev,
                                  const enum CTCE_Sok_Use   eCTCE_Sok_Use );
 
 static int      CTCE_Write_Init( DEVBLK*                   dev,
-                                 const int                 fd );
+                                 const int                 fd,
+                                 const int                 shm );
 
 static int      CTCE_Recovery( DEVBLK*                     dev );
 
@@ -606,6 +607,72 @@ static const CTCE_FSM_CELL CTCE_Fsm[16][8] = {
 /* status information.                                                   */
 #define CTCE_HERC_ONLY          ( 0x8000 )
 #define CTCE_HERC_RECV          ( 0x8001 )
+#define CTCE_HERC_SHM           ( 0x4000 )   /* Sender offers SHM ring */
+
+// --------------------------------------------------------------------
+// CTCE Shared Memory transport between co-located Hercules instances
+// --------------------------------------------------------------------
+//
+// When both sides specify SHM, each side's ConnectThread creates a
+// ring for the data it sends in a file in /dev/shm named after its
+// connect() port, and sets CTCE_HERC_SHM in the initial record.  The
+// other side's ListenThread maps that ring and replies one byte on
+// the connection: 'S' to use the ring, 'T' to stay on TCP.  The TCP
+// connections remain open; they detect the loss of the other side.
+// The ring carries exactly the bytes that would have been written to
+// the socket, so the CTCE protocol itself is unchanged.
+
+#if defined( __linux__ ) && defined( HAVE_SYS_MMAN_H )
+  #define CTCE_SHM_SUPPORT
+#endif
+
+#define CTCE_SHM_MAGIC          ( 0x43544345 )      /* "CTCE"         */
+#define CTCE_SHM_SIZE           ( 256 * 1024 )      /* Power of 2     */
+#define CTCE_SHM_WAIT_MSECS     ( 1000 )            /* Futex timeout  */
+#define CTCE_SHM_SPIN_USECS     ( 50 )              /* Poll, then wait*/
+#define CTCE_SHM_ACK_MSECS      ( 2000 )            /* Wait for reply */
+#define CTCE_SHM_PATH           "/dev/shm/hercules-ctce-%d"
+#define CTCE_BENCH_COUNT        ( 10000 )           /* ctc bench dflt */
+
+typedef struct _CTCE_SHMRING
+{
+    U32                 magic;         /* CTCE_SHM_MAGIC once ready  */
+    U32                 size;          /* Size of data[]             */
+    volatile U32        closed;        /* Either side has gone       */
+    BYTE                _pad1[52];
+    volatile U32        head;          /* Bytes written (sender)     */
+    volatile U32        rwait;         /* Receiver sleeps on head    */
+    BYTE                _pad2[56];
+    volatile U32        tail;          /* Bytes read (receiver)      */
+    volatile U32        wwait;         /* Sender sleeps on tail      */
+    BYTE                _pad3[56];
+    BYTE                data[ CTCE_SHM_SIZE ];
+}
+CTCE_SHMRING;
+
+static int      CTCE_Write(      int                       fd,
+                                 CTCE_SHMRING*             ring,
+                                 const BYTE*               buf,
+                                 int                       len );
+
+static int      CTCE_Read(       int                       fd,
+                                 CTCE_SHMRING*             ring,
+                                 BYTE*                     buf,
+                                 int                       len );
+
+#if defined( CTCE_SHM_SUPPORT )
+static int      CTCE_Shm_Is_Local( struct in_addr          addr );
+
+static CTCE_SHMRING*
+                CTCE_Shm_Map(    const char*               path,
+                                 const int                 create );
+
+static void     CTCE_Shm_Close(  CTCE_SHMRING*             ring );
+
+static void     CTCE_Shm_Unmap(  CTCE_SHMRING*             ring );
+
+static int      CTCE_Shm_Recv_Ack( int                     fd );
+#endif
 
 
 /**********************************************************************/
@@ -1519,12 +1586,13 @@ void  CTCE_Query( DEVBLK* pDEVBLK,
 
     BEGIN_DEVICE_CLASS_QUERY( "CTCA", pDEVBLK, ppszClass, iBufLen, pBuffer );
 
-    snprintf( pBuffer, iBufLen, "CTCE %05d/%d %s%s%s %s IO[%"PRIu64"]",
+    snprintf( pBuffer, iBufLen, "CTCE %05d/%d %s%s%s %s IO[%"PRIu64"]%s",
         pDEVBLK->ctce_lport, pDEVBLK->ctce_connect_lport,
         ( pDEVBLK->ctcefd > 0           ) ? "<" : "!",
         ( pDEVBLK->ctce_contention_loser) ? "-" : "=",
         ( pDEVBLK->fd     > 0           ) ? ">" : "!",
-        filename     , pDEVBLK->excps );
+        filename     , pDEVBLK->excps,
+        ( pDEVBLK->ctce_shm_tx || pDEVBLK->ctce_shm_rx ) ? " SHM" : "" );
 }
 
 // -------------------------------------------------------------------
@@ -1554,6 +1622,21 @@ int  CTCE_Close( DEVBLK* pDEVBLK )
         pDEVBLK->ctcefd = -1;
     }
 
+#if defined( CTCE_SHM_SUPPORT )
+    // The shared memory rings are marked closed for the other side.
+    // Our receive ring belongs to the RecvThread, which unmaps it.
+    if ( pDEVBLK->ctce_shm_tx )
+    {
+        CTCE_Shm_Close( pDEVBLK->ctce_shm_tx );
+        CTCE_Shm_Unmap( pDEVBLK->ctce_shm_tx );
+        pDEVBLK->ctce_shm_tx = NULL;
+    }
+    if ( pDEVBLK->ctce_shm_rx )
+    {
+        CTCE_Shm_Close( pDEVBLK->ctce_shm_rx );
+    }
+#endif
+
     return 0;
 }
 
@@ -1595,8 +1678,8 @@ int  CTCE_Close( DEVBLK* pDEVBLK )
 //   possible formats (noting that items between [] brackets are optional, and
 //   the items between <> brackets require actual values to be given):
 //
-//      <ldevnum>     CTCE <lport> [<rdevnum>=]<raddress>  <rport>  [[<mtu>] <sml>] [FICON]
-//      <ldevnum>[.n] CTCE <lport> [<rdevnum>]=<raddress> [<rport>] [[<mtu>] <sml>] [FICON]
+//      <ldevnum>     CTCE <lport> [<rdevnum>=]<raddress>  <rport>  [[<mtu>] <sml>] [SHM] [FICON]
+//      <ldevnum>[.n] CTCE <lport> [<rdevnum>]=<raddress> [<rport>] [[<mtu>] <sml>] [SHM] [FICON]
 //
 //   where:
 //
@@ -1613,6 +1696,8 @@ int  CTCE_Close( DEVBLK* pDEVBLK )
 //                   consecutive addresses starting with <ldevnum>.
 //                   (Only possible in the 2nd format, which implies the
 //                   equal sign (=) in front of <raddress>.)
+//      SHM          optional parameter requesting the shared memory transport
+//                   when <raddress> is an address of this host.
 //      FICON        optional parameter specifying a FICON Channel-to-Channel adapter
 //                   to be emulated (i.e. a FCTC instead of a CTCA)
 //
@@ -1686,6 +1771,25 @@ int  CTCE_Close( DEVBLK* pDEVBLK )
 //   a fiber channel CTC adapter (FCTC) is being emulated, instead of a
 //   regular CTCA.
 //
+//   The optional keyword SHM applies to Hercules instances on the same Linux
+//   host.  When both sides of a CTCE link specify it, the CTC commands and
+//   data are passed through a pair of shared memory rings in /dev/shm
+//   instead of the TCP sockets, which are still connected as usual to
+//   detect the loss of the other side.  When <raddress> is not local, or
+//   the other side does not specify SHM, TCP is used as before.  As both
+//   instances listen on the same host, their <lport>'s must differ :
+//
+//      # Hercules instance A:
+//
+//      0E40  CTCE  30880  127.0.0.1  30890  SHM
+//
+//      # Hercules instance B:
+//
+//      0E40  CTCE  30890  127.0.0.1  30880  SHM
+//
+//   The command "ctc bench [<count>]" compares the latency and throughput
+//   of both transports on this host.
+//
 //   CTCE connected Hercules instances can be hosted on any Hercules supported
 //   platform (Windows, Linux, MacOS ...).  Both sides do not need to be the same.
 //
@@ -1977,6 +2081,15 @@ static int  CTCE_Init( DEVBLK *dev, int argc, char *argv[] )
         SetCIWInfo( dev, 0, 0, 0xC4, 0x0080 );
     }
 
+    // The next trailing optional keyword SHM requests the shared memory
+    // transport, which is verified once the remote IP address is known.
+    dev->ctce_shm = 0;
+    if ( argc_updated > 1 && strcasecmp( argv[argc_updated - 1], "SHM" ) == 0 )
+    {
+        dev->ctce_shm = 1;
+        argc_updated--;
+    }
+
     // We check for the next trailing optional parameter ATTNDELAY <nnn> which
     // can be used to insert a delay of <nnn> msec prior to ATTN interrupts.
     // This was found to be needed for circumventing a probable VM/SP VTAM 3 bug.
@@ -2084,6 +2197,32 @@ static int  CTCE_Init( DEVBLK *dev, int argc, char *argv[] )
         }
     }
 
+    // The shared memory transport is only possible with a partner on this host.
+    if ( dev->ctce_shm )
+    {
+#if defined( CTCE_SHM_SUPPORT )
+        U32  word = 0;                  // Futex probe word
+        char why[48];                   // Reason SHM is ignored
+        if ( hthread_wait_shared_word( &word, 1, 0 ) == ENOTSUP )
+        {
+            dev->ctce_shm = 0;
+            WRMSG( HHC05088, "W",  // CTCE: SHM ignored: %s"
+                CTCX_DEVNUM( dev ), "no futex support" );
+        }
+        else if ( !CTCE_Shm_Is_Local( dev->ctce_ipaddr ) )
+        {
+            dev->ctce_shm = 0;
+            MSGBUF( why, "%s is not local", inet_ntoa( dev->ctce_ipaddr ) );
+            WRMSG( HHC05088, "W",  // CTCE: SHM ignored: %s"
+                CTCX_DEVNUM( dev ), why );
+        }
+#else
+        dev->ctce_shm = 0;
+        WRMSG( HHC05088, "W",  // CTCE: SHM ignored: %s"
+            CTCX_DEVNUM( dev ), "not supported on this platform" );
+#endif
+    }
+
     // The next argument is the remote destination port number.
     if ( next_arg < argc_updated )
     {
@@ -2297,6 +2436,12 @@ static void*  CTCE_ListenThread( void* argp )
 #if defined( HAVE_BASIC_KEEPALIVE )
     int            rc;                           // set_socket_keepalive Return Code
 #endif // defined( HAVE_BASIC_KEEPALIVE )
+#if defined( CTCE_SHM_SUPPORT )
+    CTCE_SHMRING  *rx;                           // Shared memory receive ring
+    char           path[64];                     // Shared memory ring file
+    char           why[80];                      // Reason the ring is not used
+    BYTE           ack;                          // Shared memory reply 'S' or 'T'
+#endif
 
     // Set up the parameters passed via create_thread.
     parm_listen = *( ( CTCE_PARMBLK* ) argp );
@@ -2403,6 +2548,36 @@ static void*  CTCE_ListenThread( void* argp )
   #endif // defined( HAVEHAVE_FULL_KEEPALIVE )
 #endif // defined( HAVE_BASIC_KEEPALIVE )
 
+#if defined( CTCE_SHM_SUPPORT )
+                            // A sender offering its shared memory ring gets a one byte
+                            // reply, 'S' if we mapped the ring and 'T' to stay on TCP.
+                            // The RecvThread started below takes over the mapping.
+                            dev->ctce_shm_rx = NULL;
+                            if ( pSokBuf->ctce_herc & CTCE_HERC_SHM )
+                            {
+                                rx = NULL;
+                                MSGBUF( path, CTCE_SHM_PATH, ntohs( parm_listen.addr.sin_port ) );
+                                if ( dev->ctce_shm && !( rx = CTCE_Shm_Map( path, 0 ) ) )
+                                {
+                                    MSGBUF( why, "%s: %s", path, strerror( errno ) );
+                                    WRMSG( HHC05087, "W",  // CTCE: Shared memory %s ring not used: %s; using TCP"
+                                        CTCX_DEVNUM( dev ), "receive", why );
+                                }
+                                ack = rx ? 'S' : 'T';
+                                if ( write_socket( connect_fd, &ack, 1 ) != 1 && rx )
+                                {
+                                    CTCE_Shm_Unmap( rx );
+                                    rx = NULL;
+                                }
+                                if ( rx )
+                                {
+                                    dev->ctce_shm_rx = rx;
+                                    WRMSG( HHC05084, "I",  // CTCE: Using shared memory %s ring %s"
+                                        CTCX_DEVNUM( dev ), "receive", path );
+                                }
+                            }
+#endif
+
                             // The all-important connect socket descriptor is now established.
                             dev->ctcefd = connect_fd;
 
@@ -2542,7 +2717,7 @@ static void     CTCE_Send(        DEVBLK*             pDEVBLK,
     }
 
     // Write all of this to the other (y-)side.
-    rc = write_socket( pDEVBLK->fd, ( BYTE * ) pSokBuf, pSokBuf->SndLen );
+    rc = CTCE_Write( pDEVBLK->fd, pDEVBLK->ctce_shm_tx, ( BYTE * ) pSokBuf, pSokBuf->SndLen );
 
     if( rc < 0 )
     {
@@ -2688,10 +2863,14 @@ static void*  CTCE_RecvThread( void* argp )
     U64            ctceBytCnt = 0;               // Recvd Byte Count
     BYTE           ctce_recv_mods_UnitStat;      // UnitStat modifications
     int            i = 0;                        // temporary variable
+    CTCE_SHMRING  *rx;                           // Shared memory ring, if used
 
     // When the receiver thread is (re-)started, the CTCE devblk is (re-)initialized
     obtain_lock( &pDEVBLK->lock );
 
+    // The shared memory ring mapped by the ListenThread is ours to unmap.
+    rx = pDEVBLK->ctce_shm_rx;
+
     // Enhanced CTC adapter intiialization for y-side command register.
     pDEVBLK->ctceyCmd = 0x00;
 
@@ -2715,11 +2894,11 @@ static void*  CTCE_RecvThread( void* argp )
     {
         // We read whatever the other (y-)side of the CTC has sent us,
         // which by now won't block until the complete buffer is received.
-        iLength = read_socket( pDEVBLK->ctcefd, ( BYTE * ) pSokBuf, pDEVBLK->ctceSndSml );
+        iLength = CTCE_Read( pDEVBLK->ctcefd, rx, ( BYTE * ) pSokBuf, pDEVBLK->ctceSndSml );
 
         // Followed by the receiving the rest if the default SndLen was too small.
         if( ( pDEVBLK->ctceSndSml < pSokBuf->SndLen ) && ( iLength != 0 ) )
-            iLength += read_socket( pDEVBLK->ctcefd, ( BYTE * ) pSokBuf + pDEVBLK->ctceSndSml,
+            iLength += CTCE_Read( pDEVBLK->ctcefd, rx, ( BYTE * ) pSokBuf + pDEVBLK->ctceSndSml,
                 pSokBuf->SndLen - pDEVBLK->ctceSndSml );
 
         // Commands sent by the other (y-)side most likely cause DEVBLK
@@ -2749,6 +2928,17 @@ static void*  CTCE_RecvThread( void* argp )
                 CTCE_Close( pDEVBLK );
             }
 
+#if defined( CTCE_SHM_SUPPORT )
+            // The shared memory ring is released before any recovery.
+            if( rx )
+            {
+                if( pDEVBLK->ctce_shm_rx == rx )
+                    pDEVBLK->ctce_shm_rx = NULL;
+                CTCE_Shm_Close( rx );
+                CTCE_Shm_Unmap( rx );
+            }
+#endif
+
             // A CTCE Recovery (i.e. a devinit) is done in either case, error
             // or partner shutdown, as long as we are not shutting down.
             if( !sysblk.shutdown )
@@ -3599,6 +3789,12 @@ static void*  CTCE_ConnectThread( void* argp )
     BYTE                renewed;                      // When renewing a CTCE connection
     char*               remaddr;                      // Remote IP address
     char                address[20]="";               // temp space for IP address
+    CTCE_SHMRING*       tx = NULL;                    // Shared memory send ring
+#if defined( CTCE_SHM_SUPPORT )
+    char                path[64];                     // Shared memory ring file
+    char                why[80];                      // Reason the ring is not used
+    int                 ack = -1;                     // Shared memory reply
+#endif
 
 
     // Obtain a socket to connect to the other end.
@@ -3635,7 +3831,46 @@ static void*  CTCE_ConnectThread( void* argp )
         // A successful connect() is immediately followed by a initial write.
         if ( rc == 0 )
         {
-            rc = CTCE_Write_Init( dev, fd );
+#if defined( CTCE_SHM_SUPPORT )
+            // With SHM we offer the other side a ring for the data we send,
+            // named after our connect() port, and await its one byte reply.
+            // The file is removed either way; a mapping stays valid.
+            if ( dev->ctce_shm )
+            {
+                MSGBUF( path, CTCE_SHM_PATH, dev->ctce_connect_lport );
+                if ( !( tx = CTCE_Shm_Map( path, 1 ) ) )
+                {
+                    MSGBUF( why, "%s: %s", path, strerror( errno ) );
+                    WRMSG( HHC05087, "W",  // CTCE: Shared memory %s ring not used: %s; using TCP"
+                        CTCX_DEVNUM( dev ), "send", why );
+                }
+            }
+#endif
+            rc = CTCE_Write_Init( dev, fd, tx != NULL );
+#if defined( CTCE_SHM_SUPPORT )
+            if ( tx )
+            {
+                if ( rc == 0 )
+                {
+                    release_lock( &dev->lock );
+                    ack = CTCE_Shm_Recv_Ack( fd );
+                    obtain_lock( &dev->lock );
+                    if ( ack != 'S' )
+                    {
+                        WRMSG( HHC05087, "W",  // CTCE: Shared memory %s ring not used: %s; using TCP"
+                            CTCX_DEVNUM( dev ), "send", ( ack == 'T' ) ?
+                            "declined by the other side" : "no reply from the other side" );
+                    }
+                }
+                unlink( path );
+                if ( rc != 0 || ack != 'S' )
+                {
+                    CTCE_Shm_Close( tx );   // (in case of a late 'S')
+                    CTCE_Shm_Unmap( tx );
+                    tx = NULL;
+                }
+            }
+#endif
         }
 
         // The first message appears just once after (each re-)initialisation,
@@ -3666,6 +3901,21 @@ static void*  CTCE_ConnectThread( void* argp )
         renewed = ( dev->fd != -1 ) ? 1 : 0;
         dev->fd = fd;
 
+#if defined( CTCE_SHM_SUPPORT )
+        // A renewed connection replaces any previous shared memory ring.
+        if ( dev->ctce_shm_tx )
+        {
+            CTCE_Shm_Close( dev->ctce_shm_tx );
+            CTCE_Shm_Unmap( dev->ctce_shm_tx );
+        }
+        dev->ctce_shm_tx = tx;
+        if ( tx )
+        {
+            WRMSG( HHC05084, "I",  // CTCE: Using shared memory %s ring %s"
+                CTCX_DEVNUM( dev ), "send", path );
+        }
+#endif
+
         WRMSG( HHC05054, "I",  // CTCE: %s outbound connection :%5d -> %1d:%04X=%s:%d"
             CTCX_DEVNUM( dev ), ( renewed ? "Renewed" : "Started" ),
             dev->ctce_connect_lport, SSID_TO_LCSS( dev->ssid ),
@@ -3797,7 +4047,8 @@ static int      CTCE_Get_Socket( DEVBLK*                   dev,
 // ---------------------------------------------------------------------
 
 static int      CTCE_Write_Init( DEVBLK*                   dev,
-                                 const int                 fd )
+                                 const int                 fd,
+                                 const int                 shm )
 {
     int                 rc;                           // Return Code
     CTCE_SOKPFX*        pSokBuf;                      // The buffer to be written
@@ -3809,6 +4060,8 @@ static int      CTCE_Write_Init( DEVBLK*                   dev,
     pSokBuf->devnum      = dev->devnum;
     pSokBuf->ssid        = dev->ssid;
     pSokBuf->ctce_herc   = ( dev->ctcefd > 0 ) ? CTCE_HERC_RECV : 0 ; // 0 = we're not yet receiving
+    if ( shm )
+        pSokBuf->ctce_herc |= CTCE_HERC_SHM;
     if ( ( rc = write_socket( fd, pSokBuf, pSokBuf->SndLen ) ) == pSokBuf->SndLen )
     {
         rc = 0;
@@ -3846,6 +4099,568 @@ static int    CTCE_Recovery( DEVBLK* dev )
 
 } // CTCE_Recovery
 
+// ---------------------------------------------------------------------
+// CTCE_Write and CTCE_Read : the data transport, TCP or shared memory
+// ---------------------------------------------------------------------
+
+#if defined( CTCE_SHM_SUPPORT )
+static int      CTCE_Shm_Write(  CTCE_SHMRING*             ring,
+                                 int                       fd,
+                                 const BYTE*               buf,
+                                 int                       len );
+
+static int      CTCE_Shm_Read(   CTCE_SHMRING*             ring,
+                                 int                       fd,
+                                 BYTE*                     buf,
+                                 int                       len );
+#endif
+
+static int      CTCE_Write(      int                       fd,
+                                 CTCE_SHMRING*             ring,
+                                 const BYTE*               buf,
+                                 int                       len )
+{
+#if defined( CTCE_SHM_SUPPORT )
+    if ( ring )
+        return CTCE_Shm_Write( ring, fd, buf, len );
+#else
+    UNREFERENCED( ring );
+#endif
+    return write_socket( fd, buf, len );
+
+} // CTCE_Write
+
+static int      CTCE_Read(       int                       fd,
+                                 CTCE_SHMRING*             ring,
+                                 BYTE*                     buf,
+                                 int                       len )
+{
+#if defined( CTCE_SHM_SUPPORT )
+    if ( ring )
+        return CTCE_Shm_Read( ring, fd, buf, len );
+#else
+    UNREFERENCED( ring );
+#endif
+    return read_socket( fd, buf, len );
+
+} // CTCE_Read
+
+#if defined( CTCE_SHM_SUPPORT )
+
+// ---------------------------------------------------------------------
+// CTCE_Shm_Is_Local : whether an IP address belongs to this host
+// ---------------------------------------------------------------------
+
+static int      CTCE_Shm_Is_Local( struct in_addr          addr )
+{
+    struct sockaddr_in  sa;                           // address to bind to
+    int                 fd;                           // UDP socket
+    int                 rc;                           // bind() Return Code
+
+    if ( ( fd = socket( AF_INET, SOCK_DGRAM, 0 ) ) < 0 )
+        return 0;
+    memset( &sa, 0, sizeof( sa ) );
+    sa.sin_family = AF_INET;
+    sa.sin_port   = htons( 0 );
+    sa.sin_addr   = addr;
+    rc = bind( fd, ( struct sockaddr * )&sa, sizeof( sa ) );
+    close_socket( fd );
+    return ( rc == 0 );
+
+} // CTCE_Shm_Is_Local
+
+// ---------------------------------------------------------------------
+// CTCE_Shm_Map : create (sender) or open (receiver) a ring file and
+// map it; returns NULL with errno set upon failure.  The path is known
+// in advance, so a file left there (or planted there) is removed and
+// the ring is always created anew; symbolic links are never followed.
+// ---------------------------------------------------------------------
+
+static CTCE_SHMRING*
+                CTCE_Shm_Map(    const char*               path,
+                                 const int                 create )
+{
+    CTCE_SHMRING*       ring;                         // mapped ring
+    struct stat         st;                           // ring file status
+    int                 fd;                           // ring file descriptor
+    int                 err;                          // saved errno
+
+    if ( create )
+    {
+        if ( unlink( path ) < 0 && errno != ENOENT )
+            return NULL;
+        fd = open( path, O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW, S_IRUSR | S_IWUSR );
+    }
+    else
+        fd = open( path, O_RDWR | O_NOFOLLOW );
+    if ( fd < 0 )
+        return NULL;
+
+    // A newly created ring is all zeroes, i.e. empty and not closed.
+    if ( create )
+        err = ( ftruncate( fd, sizeof( CTCE_SHMRING ) ) < 0 ) ? errno : 0;
+    else if ( fstat( fd, &st ) < 0 )
+        err = errno;
+    else
+        err = ( st.st_size != sizeof( CTCE_SHMRING ) ) ? EINVAL : 0;
+
+    ring = MAP_FAILED;
+    if ( !err )
+    {
+        ring = mmap( NULL, sizeof( CTCE_SHMRING ), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0 );
+        err = ( ring == MAP_FAILED ) ? errno : 0;
+    }
+    close( fd );
+
+    if ( err )
+    {
+        if ( create )
+            unlink( path );
+        errno = err;
+        return NULL;
+    }
+
+    if ( create )
+    {
+        ring->size = CTCE_SHM_SIZE;
+        __atomic_store_n( &ring->magic, CTCE_SHM_MAGIC, __ATOMIC_RELEASE );
+    }
+    else if ( __atomic_load_n( &ring->magic, __ATOMIC_ACQUIRE ) != CTCE_SHM_MAGIC
+           || ring->size != CTCE_SHM_SIZE )
+    {
+        munmap( ring, sizeof( CTCE_SHMRING ) );
+        errno = EINVAL;
+        return NULL;
+    }
+    return ring;
+
+} // CTCE_Shm_Map
+
+// ---------------------------------------------------------------------
+// CTCE_Shm_Close : mark a ring closed and wake either side
+// ---------------------------------------------------------------------
+
+static void     CTCE_Shm_Close(  CTCE_SHMRING*             ring )
+{
+    __atomic_store_n( &ring->closed, 1, __ATOMIC_SEQ_CST );
+    hthread_wake_shared_word( &ring->head );
+    hthread_wake_shared_word( &ring->tail );
+
+} // CTCE_Shm_Close
+
+// ---------------------------------------------------------------------
+// CTCE_Shm_Unmap
+// ---------------------------------------------------------------------
+
+static void     CTCE_Shm_Unmap(  CTCE_SHMRING*             ring )
+{
+    munmap( ring, sizeof( CTCE_SHMRING ) );
+
+} // CTCE_Shm_Unmap
+
+// ---------------------------------------------------------------------
+// CTCE_Shm_Recv_Ack : the ListenThread's reply to our ring offer
+// ---------------------------------------------------------------------
+
+static int      CTCE_Shm_Recv_Ack( int                     fd )
+{
+    struct pollfd       pfd;                          // poll() argument
+    BYTE                ack;                          // 'S' or 'T'
+
+    pfd.fd      = fd;
+    pfd.events  = POLLIN;
+    pfd.revents = 0;
+    if ( poll( &pfd, 1, CTCE_SHM_ACK_MSECS ) != 1
+        || recv( fd, &ack, 1, 0 ) != 1 )
+    {
+        return -1;
+    }
+    return ack;
+
+} // CTCE_Shm_Recv_Ack
+
+// ---------------------------------------------------------------------
+// CTCE_Shm_Peer_Gone : whether the TCP connection alongside a ring was
+// closed by the other side.  Nothing else is ever sent on it, so any
+// readable state means end-of-file or an error.
+// ---------------------------------------------------------------------
+
+static int      CTCE_Shm_Peer_Gone( int                    fd )
+{
+    struct pollfd       pfd;                          // poll() argument
+    BYTE                b;                            // recv() peek byte
+    int                 rc;                           // recv() Return Code
+
+    if ( fd < 0 )
+        return 0;
+    pfd.fd      = fd;
+    pfd.events  = POLLIN;
+    pfd.revents = 0;
+    if ( poll( &pfd, 1, 0 ) != 1 )
+        return 0;
+    if ( pfd.revents & ( POLLERR | POLLHUP | POLLNVAL ) )
+        return 1;
+    rc = recv( fd, &b, 1, MSG_PEEK | MSG_DONTWAIT );
+    return ( rc == 0 ) || ( rc < 0 && errno != EAGAIN && errno != EWOULDBLOCK );
+
+} // CTCE_Shm_Peer_Gone
+
+// ---------------------------------------------------------------------
+// CTCE_Shm_Write : copy len bytes into the ring, waiting for room when
+// it is full.  The receiver is only woken when it sleeps on the head.
+// ---------------------------------------------------------------------
+
+static int      CTCE_Shm_Write(  CTCE_SHMRING*             ring,
+                                 int                       fd,
+                                 const BYTE*               buf,
+                                 int                       len )
+{
+    U32                 head = ring->head;            // only we update it
+    U32                 tail;                         // receiver position
+    U32                 room;                         // free bytes
+    U32                 off;                          // head offset in data
+    U32                 n, n1;                        // bytes to copy
+    int                 done = 0;                     // bytes copied
+
+    while ( done < len )
+    {
+        if ( __atomic_load_n( &ring->closed, __ATOMIC_ACQUIRE ) )
+        {
+            errno = EPIPE;
+            return -1;
+        }
+
+        tail = __atomic_load_n( &ring->tail, __ATOMIC_ACQUIRE );
+        if ( head - tail > CTCE_SHM_SIZE )
+        {
+            // The other side's position is not to be trusted.
+            __atomic_store_n( &ring->closed, 1, __ATOMIC_SEQ_CST );
+            errno = EPIPE;
+            return -1;
+        }
+        room = CTCE_SHM_SIZE - ( head - tail );
+        if ( room == 0 )
+        {
+            __atomic_store_n( &ring->wwait, 1, __ATOMIC_SEQ_CST );
+            if ( hthread_wait_shared_word( &ring->tail, tail, CTCE_SHM_WAIT_MSECS ) == ETIMEDOUT
+                && CTCE_Shm_Peer_Gone( fd ) )
+            {
+                __atomic_store_n( &ring->closed, 1, __ATOMIC_SEQ_CST );
+            }
+            __atomic_store_n( &ring->wwait, 0, __ATOMIC_SEQ_CST );
+            continue;
+        }
+
+        n   = MIN( room, (U32)( len - done ) );
+        off = head & ( CTCE_SHM_SIZE - 1 );
+        n1  = MIN( n, CTCE_SHM_SIZE - off );
+        memcpy( ring->data + off, buf + done, n1 );
+        memcpy( ring->data, buf + done + n1, n - n1 );
+        head += n;
+        done += n;
+
+        __atomic_store_n( &ring->head, head, __ATOMIC_SEQ_CST );
+        if ( __atomic_load_n( &ring->rwait, __ATOMIC_SEQ_CST ) )
+            hthread_wake_shared_word( &ring->head );
+    }
+    return len;
+
+} // CTCE_Shm_Write
+
+// ---------------------------------------------------------------------
+// CTCE_Shm_Read : copy len bytes out of the ring, waiting for them to
+// arrive.  An empty ring is polled for CTCE_SHM_SPIN_USECS before we
+// sleep, as a reply usually follows within that time.  Like read_socket
+// it returns fewer bytes, possibly 0, when the ring was closed (or the
+// other side has gone).
+// ---------------------------------------------------------------------
+
+static int      CTCE_Shm_Read(   CTCE_SHMRING*             ring,
+                                 int                       fd,
+                                 BYTE*                     buf,
+                                 int                       len )
+{
+    U32                 tail = ring->tail;            // only we update it
+    U32                 head;                         // sender position
+    U32                 avail;                        // bytes available
+    U32                 off;                          // tail offset in data
+    U32                 n, n1;                        // bytes to copy
+    int                 done = 0;                     // bytes copied
+    TOD                 spinend;                      // end of polling
+
+    while ( done < len )
+    {
+        head  = __atomic_load_n( &ring->head, __ATOMIC_ACQUIRE );
+        avail = head - tail;
+        if ( avail == 0 && hostinfo.num_procs > 1 )
+        {
+            spinend = host_tod() + (TOD) CTCE_SHM_SPIN_USECS * ETOD_USEC;
+            while ( ( head = __atomic_load_n( &ring->head, __ATOMIC_ACQUIRE ) ) == tail
+                && !ring->closed && host_tod() < spinend )
+                ;   /* (do nothing, we are only polling) */
+            avail = head - tail;
+        }
+        if ( avail > CTCE_SHM_SIZE )
+        {
+            // The other side's position is not to be trusted.
+            __atomic_store_n( &ring->closed, 1, __ATOMIC_SEQ_CST );
+            break;
+        }
+        if ( avail == 0 )
+        {
+            if ( __atomic_load_n( &ring->closed, __ATOMIC_ACQUIRE ) )
+                break;
+            __atomic_store_n( &ring->rwait, 1, __ATOMIC_SEQ_CST );
+            if ( hthread_wait_shared_word( &ring->head, head, CTCE_SHM_WAIT_MSECS ) == ETIMEDOUT
+                && CTCE_Shm_Peer_Gone( fd ) )
+            {
+                __atomic_store_n( &ring->closed, 1, __ATOMIC_SEQ_CST );
+            }
+            __atomic_store_n( &ring->rwait, 0, __ATOMIC_SEQ_CST );
+            continue;
+        }
+
+        n   = MIN( avail, (U32)( len - done ) );
+        off = tail & ( CTCE_SHM_SIZE - 1 );
+        n1  = MIN( n, CTCE_SHM_SIZE - off );
+        memcpy( buf + done, ring->data + off, n1 );
+        memcpy( buf + done + n1, ring->data, n - n1 );
+        tail += n;
+        done += n;
+
+        __atomic_store_n( &ring->tail, tail, __ATOMIC_SEQ_CST );
+        if ( __atomic_load_n( &ring->wwait, __ATOMIC_SEQ_CST ) )
+            hthread_wake_shared_word( &ring->tail );
+    }
+    return done;
+
+} // CTCE_Shm_Read
+
+#endif // defined( CTCE_SHM_SUPPORT )
+
+// ---------------------------------------------------------------------
+// CTCE_Bench : "ctc bench [<count>]" compares the TCP and the shared
+// memory transports within this process.  An echo thread returns each
+// small message (the round trip latency) and then receives a series
+// of maximum size messages (the throughput) before one final reply.
+// ---------------------------------------------------------------------
+
+typedef struct _CTCE_BENCH
+{
+    int                 fd;            /* Echo side socket           */
+    CTCE_SHMRING*       rx;            /* Echo side receive ring     */
+    CTCE_SHMRING*       tx;            /* Echo side send ring        */
+    int                 count;         /* Messages per measurement   */
+    int                 small;         /* Round trip message size    */
+    int                 large;         /* Throughput message size    */
+    BYTE*               buf;           /* Echo side buffer           */
+}
+CTCE_BENCH;
+
+static void*    CTCE_Bench_Echo( void* argp )
+{
+    CTCE_BENCH         *pb = (CTCE_BENCH*) argp;      // benchmark parameters
+    BYTE                ack = 'A';                    // final reply
+    int                 i;                            // message counter
+
+    for ( i = 0; i < pb->count; i++ )
+    {
+        if ( CTCE_Read(  pb->fd, pb->rx, pb->buf, pb->small ) != pb->small
+          || CTCE_Write( pb->fd, pb->tx, pb->buf, pb->small ) != pb->small )
+            return NULL;
+    }
+    for ( i = 0; i < pb->count; i++ )
+    {
+        if ( CTCE_Read(  pb->fd, pb->rx, pb->buf, pb->large ) != pb->large )
+            return NULL;
+    }
+    CTCE_Write( pb->fd, pb->tx, &ack, 1 );
+    return NULL;
+
+} // CTCE_Bench_Echo
+
+static int      CTCE_Bench_Run(  const char*               what,
+                                 int                       fd,
+                                 CTCE_SHMRING*             tx,
+                                 CTCE_SHMRING*             rx,
+                                 CTCE_BENCH*               pb )
+{
+    TID                 tid;                          // echo thread
+    BYTE               *buf;                          // message buffer
+    struct timeval      beg, mid, end;                // timestamps
+    char                lat[32];                      // usec per round trip
+    char                rate[32];                     // MB per second
+    double              secs;                         // elapsed time
+    int                 i;                            // message counter
+    int                 rc = -1;                      // Return Code
+
+    if ( !( buf = calloc( 1, pb->large ) ) )
+    {
+        WRMSG( HHC05090, "E",  // CTCE: Benchmark %s error: %s"
+            what, strerror( errno ) );
+        return -1;
+    }
+    if ( create_thread( &tid, JOINABLE, CTCE_Bench_Echo, pb, "CTCE bench echo" ) != 0 )
+    {
+        WRMSG( HHC05090, "E",  // CTCE: Benchmark %s error: %s"
+            what, strerror( errno ) );
+        free( buf );
+        return -1;
+    }
+
+    gettimeofday( &beg, NULL );
+    for ( i = 0; i < pb->count; i++ )
+    {
+        if ( CTCE_Write( fd, tx, buf, pb->small ) != pb->small
+          || CTCE_Read(  fd, rx, buf, pb->small ) != pb->small )
+            break;
+    }
+    gettimeofday( &mid, NULL );
+    for ( ; i < 2 * pb->count; i++ )
+    {
+        if ( CTCE_Write( fd, tx, buf, pb->large ) != pb->large )
+            break;
+    }
+    if ( i == 2 * pb->count && CTCE_Read( fd, rx, buf, 1 ) == 1 )
+        rc = 0;
+    gettimeofday( &end, NULL );
+
+    // Make sure the echo thread ends when we did not.
+    if ( rc != 0 )
+    {
+        WRMSG( HHC05090, "E",  // CTCE: Benchmark %s error: %s"
+            what, strerror( errno ) );
+#if defined( CTCE_SHM_SUPPORT )
+        if ( tx )
+        {
+            CTCE_Shm_Close( tx );
+            CTCE_Shm_Close( rx );
+        }
+        else
+#endif
+        shutdown( fd, SHUT_RDWR );
+    }
+    join_thread( tid, NULL );
+
+    if ( rc == 0 )
+    {
+        secs = ( mid.tv_sec - beg.tv_sec ) + ( mid.tv_usec - beg.tv_usec ) / 1000000.0;
+        MSGBUF( lat, "%.2f", secs * 1000000.0 / pb->count );
+        secs = ( end.tv_sec - mid.tv_sec ) + ( end.tv_usec - mid.tv_usec ) / 1000000.0;
+        MSGBUF( rate, "%.0f", secs > 0 ? (double) pb->count * pb->large / secs / ONE_MEGABYTE : 0.0 );
+        WRMSG( HHC05089, "I",  // CTCE: Benchmark %-3s: %d round trips of %d bytes, %s usec each; %d writes of %d bytes, %s MB/s"
+            what, pb->count, pb->small, lat, pb->count, pb->large, rate );
+    }
+    free( buf );
+    return rc;
+
+} // CTCE_Bench_Run
+
+static int      CTCE_Bench_Tcp_Pair( int*                  fds )
+{
+    struct sockaddr_in  addr;                         // loopback address
+    socklen_t           addrlen = sizeof( addr );     // for getsockname()
+    const int           so_value_1 = 1;               // argument for setsockopt
+    int                 lfd;                          // listening socket
+
+    fds[0] = fds[1] = -1;
+    if ( ( lfd = socket( AF_INET, SOCK_STREAM, 0 ) ) < 0 )
+        return -1;
+    memset( &addr, 0, sizeof( addr ) );
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons( 0 );
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    if ( 0
+        || bind( lfd, ( struct sockaddr * )&addr, sizeof( addr ) ) < 0
+        || listen( lfd, 1 ) < 0
+        || getsockname( lfd, ( struct sockaddr * )&addr, &addrlen ) < 0
+        || ( fds[0] = socket( AF_INET, SOCK_STREAM, 0 ) ) < 0
+        || connect( fds[0], ( struct sockaddr * )&addr, sizeof( addr ) ) < 0
+        || ( fds[1] = accept( lfd, NULL, NULL ) ) < 0
+    )
+    {
+        close_socket( lfd );
+        if ( fds[0] >= 0 )
+            close_socket( fds[0] );
+        return -1;
+    }
+    close_socket( lfd );
+
+    // As with CTCE_DISABLE_NAGLE on the real connections.
+    setsockopt( fds[0], IPPROTO_TCP, TCP_NODELAY,
+        ( GETSET_SOCKOPT_T* )&so_value_1, sizeof( so_value_1 ) );
+    setsockopt( fds[1], IPPROTO_TCP, TCP_NODELAY,
+        ( GETSET_SOCKOPT_T* )&so_value_1, sizeof( so_value_1 ) );
+    return 0;
+
+} // CTCE_Bench_Tcp_Pair
+
+int             CTCE_Bench(      int                       count )
+{
+    CTCE_BENCH          bench;                        // benchmark parameters
+    int                 fds[2];                       // TCP connection
+    int                 rc = 0;                       // Return Code
+#if defined( CTCE_SHM_SUPPORT )
+    CTCE_SHMRING       *ring[2];                      // send and reply rings
+    char                path[64];                     // ring file name
+#endif
+
+    memset( &bench, 0, sizeof( bench ) );
+    bench.count = ( count > 0 ) ? count : CTCE_BENCH_COUNT;
+    bench.small = sizeof( CTCE_SOKPFX );
+    bench.large = CTCE_MTU_MIN;
+    if ( !( bench.buf = malloc( bench.large ) ) )
+    {
+        WRMSG( HHC05090, "E",  // CTCE: Benchmark %s error: %s"
+            "buffer", strerror( errno ) );
+        return -1;
+    }
+
+    if ( CTCE_Bench_Tcp_Pair( fds ) < 0 )
+    {
+        WRMSG( HHC05090, "E",  // CTCE: Benchmark %s error: %s"
+            "TCP", strerror( HSO_errno ) );
+        rc = -1;
+    }
+    else
+    {
+        bench.fd = fds[1];
+        rc |= CTCE_Bench_Run( "TCP", fds[0], NULL, NULL, &bench );
+        close_socket( fds[0] );
+        close_socket( fds[1] );
+    }
+
+#if defined( CTCE_SHM_SUPPORT )
+    MSGBUF( path, "/dev/shm/hercules-ctce-bench-%d", (int) getpid() );
+    if ( ( ring[0] = CTCE_Shm_Map( path, 1 ) ) )
+        unlink( path );
+    if ( ( ring[1] = CTCE_Shm_Map( path, 1 ) ) )
+        unlink( path );
+    if ( !ring[0] || !ring[1] )
+    {
+        WRMSG( HHC05090, "E",  // CTCE: Benchmark %s error: %s"
+            "SHM", strerror( errno ) );
+        rc = -1;
+    }
+    else
+    {
+        bench.fd = -1;
+        bench.rx = ring[0];
+        bench.tx = ring[1];
+        rc |= CTCE_Bench_Run( "SHM", -1, ring[0], ring[1], &bench );
+    }
+    if ( ring[0] )
+        CTCE_Shm_Unmap( ring[0] );
+    if ( ring[1] )
+        CTCE_Shm_Unmap( ring[1] );
+#endif
+
+    free( bench.buf );
+    return rc;
+
+} // CTCE_Bench
+
 // ---------------------------------------------------------------------
 // CTCE_Build_RCD
 // ---------------------------------------------------------------------
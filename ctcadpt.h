@@ -118,6 +118,7 @@ extern void     CTCX_ExecuteCCW( DEVBLK* pDEVBLK, BYTE  bCode,
 extern int      CTCE_Close( DEVBLK* pDEVBLK );
 extern void     CTCE_Query( DEVBLK* pDEVBLK, char** ppszClass,
                             int     iBufLen, char*  pBuffer );
+extern int      CTCE_Bench( int count );
 
 extern int      CTCI_Init( DEVBLK* pDEVBLK, int argc, char *argv[] );
 extern int      CTCI_Close( DEVBLK* pDEVBLK );
@@ -333,6 +334,8 @@ struct  _CTCBLK
     U16         iFrameOffset;             // Curr Offset into Buffer
     U16         sMTU;                     // Max MTU
 
+    NETRING     Ring;                     // Frames from CTCI_ReadThread
+
     LOCK        Lock;                     // Data LOCK
     LOCK        EventLock;                // Condition LOCK
     COND        Event;                    // Condition signal
@@ -729,6 +732,10 @@ struct  _LCSDEV
 
     LOCK        InOutLock;              // SNA Inbound Outbound LOCK
 
+    NETRING     Ring;                   // Frames from LCS_PortThread
+    int         iRingBatch;             // Frames not yet signalled
+                                        // (LCS_PortThread use only)
+
     LOCK        DevDataLock;            // Data LOCK. This lock is used to
                                         // serialize data being added to or
                                         // removed from bFrameBuffer.
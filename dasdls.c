@@ -43,6 +43,7 @@ int  end_of_track        (BYTE *p);
 int  list_contents       (CIFBLK *cif, char *volser, DSXTENT *extent );
 int  do_ls_cif           (CIFBLK *cif);
 int  do_ls               (char *file, char *sfile);
+int  do_bench            (char *file, int count);
 
 /*********************************************************************/
 /* globals                                                           */
@@ -58,6 +59,8 @@ static int runflgs   = 0;       /* run flags set from command line   */
 #define rf_refdate   0x04       /*     show last-referenced dates    */
 #define rf_header    0x08       /*     show header                   */
 #define rf_info      0x10       /*     show F1 info                  */
+#define rf_bench     0x20       /*     time track reads instead      */
+static int benchcnt  = 0;       /* tracks read per pass (0=all)      */
 
 /*********************************************************************/
 /* sort by dsname support                                            */
@@ -646,6 +649,105 @@ int do_ls( char *file, char *sfile )
     return 0;
 }
 
+/*********************************************************************/
+/* Time reading tracks in order and at random, through the track     */
+/* cache and with the image file mapped.  The image is read once     */
+/* first so that every pass finds it in the host page cache.         */
+
+static double seconds( void )
+{
+    struct timeval tv;
+
+    gettimeofday( &tv, NULL );
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static int bench_pass( char *file, char *opt, int random, int count,
+                       double *secs, U64 *bytes )
+{
+    CIFBLK*  bcif;
+    DEVBLK*  dev;
+    U32      seed = 1;
+    U32      sum  = 0;
+    double   t0;
+    int      trks, trk, i, j;
+
+    if (!(bcif = open_ckd_image( file, opt, O_RDONLY | O_BINARY, IMAGE_OPEN_QUIET )))
+        return -1;
+
+    dev   = &bcif->devblk;
+    trks  = dev->ckdtrks;
+    *bytes = 0;
+
+    if (!count)
+        count = trks;
+
+    t0 = seconds();
+
+    for (i=0; i < count; ++i)
+    {
+        if (random)
+        {
+            seed = seed * 1103515245 + 12345;
+            trk = (seed >> 8) % trks;
+        }
+        else
+            trk = i % trks;
+
+        if (read_track( bcif, trk / bcif->heads, trk % bcif->heads ) != 0)
+        {
+            close_ckd_image( bcif );
+            return -1;
+        }
+
+        /* (touch the track the way the channel would) */
+        for (j=0; j < dev->buflen; j += 64)
+            sum += bcif->trkbuf[j];
+        *bytes += dev->buflen;
+    }
+
+    *secs = seconds() - t0;
+
+    /* (keep the compiler from dropping the loop above) */
+    if (sum == 0xFFFFFFFF)
+        LOGMSG( "%u\n", sum );
+
+    return close_ckd_image( bcif ) != 0 ? -1 : count;
+}
+
+int do_bench( char *file, int count )
+{
+    static const char* pattern[] = { "sequential", "random" };
+    static const char* mode[]    = { "cache", "mmap" };
+    static char        mmap[]    = "mmap";
+
+    double  secs;
+    U64     bytes;
+    int     m, r, n;
+
+    LOGMSG("\n");
+
+    if (bench_pass( file, NULL, FALSE, 0, &secs, &bytes ) < 0)
+        return -1;
+
+    for (m=0; m < 2; ++m)
+    {
+        for (r=0; r < 2; ++r)
+        {
+            if ((n = bench_pass( file, m ? mmap : NULL, r, count, &secs, &bytes )) < 0)
+                return -1;
+
+            secs = MAX( secs, 1e-6 );
+
+            // "%-5s %-10s: %d tracks in %.3f seconds, %.0f tracks/sec, %.1f MB/sec"
+            WRMSG( HHC02492, "I", mode[m], pattern[r], n, secs,
+                   n / secs, bytes / (1024.0 * 1024.0) / secs );
+        }
+    }
+
+    return 0;
+}
+
 /*********************************************************************/
 
 int main( int argc, char **argv )
@@ -728,6 +830,20 @@ char           *fn, *sfn;
             yroffs = 28;
             continue;
         }
+        if (1
+            && strlen( *argv )   >     7
+            && !memcmp( fn, "-bench=", 7 )) /* benchmark (custom count) */
+        {
+            runflgs |= rf_bench;
+            benchcnt = atoi( fn + 7 );
+            continue;
+        }
+        if (strcmp( fn, "-bench" ) == 0)    /* benchmark (all tracks) */
+        {
+            runflgs |= rf_bench;
+            benchcnt = 0;
+            continue;
+        }
 
         /* Check for shadow file */
         if (1
@@ -738,7 +854,12 @@ char           *fn, *sfn;
              sfn = *++argv;
         else sfn = NULL;
 
-        if (do_ls( fn, sfn ))
+        if (runflgs & rf_bench)
+        {
+            if (do_bench( fn, benchcnt ))
+                rc = 1;
+        }
+        else if (do_ls( fn, sfn ))
             rc = 1;
     }
 
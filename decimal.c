@@ -48,520 +48,393 @@
 #define MAX_DECIMAL_DIGITS      (((MAX_DECIMAL_LENGTH)*2)-1)
 
 /*-------------------------------------------------------------------*/
-/* Convert packed decimal number to binary                           */
+/* Binary packed decimal engine                                      */
 /*                                                                   */
-/* This subroutine is called by the CVB/CVBY/CVBG instructions.      */
-/* It performs the conversion of a 8-byte or 16-byte packed          */
-/* decimal number into a 64-bit SIGNED binary result.                */
-/* This routine is not architecture-dependent; all of its operands   */
-/* are contained in work areas passed by the architecture-dependent  */
-/* instruction routines which handle all main-storage accesses and   */
-/* possible program checks.                                          */
-/*                                                                   */
-/* Input:                                                            */
-/*      dec     An 8 or 16 byte area containing a copy of the        */
-/*              packed decimal storage operand.                      */
-/*      len     Length-1 (in bytes) of the packed decimal input      */
-/*              (7 for CVB/CVBY or 15 for CVBG).                     */
-/* Output:                                                           */
-/*      result  Points to an U64 field which will receive the        */
-/*              result as a 64-bit SIGNED binary number.             */
-/*      ovf     Points to an int field which will be set to 1 if     */
-/*              the result overflows 63 bits plus sign, else 0.      */
-/*              If overflow occurs, the result field will contain    */
-/*              the rightmost 64 bits of the result.                 */
-/*      dxf     Points to an int field which will be set to 1 if     */
-/*              invalid digits or sign were detected, else 0.        */
-/*              The result field is not set if the dxf is set to 1.  */
+/* The decimal instructions convert their packed decimal operands    */
+/* into binary, do the arithmetic in 64-bit host integers, and       */
+/* convert the result back.  A packed operand of up to 31 digits is  */
+/* held as two binary limbs whose value is hi * 10**16 + lo, with    */
+/* hi < 10**15 and lo < 10**16.  The digits are validated and        */
+/* converted sixteen at a time with SWAR (SIMD within a register)    */
+/* arithmetic on the nibbles, and converted back with a 100-entry    */
+/* table of two-digit BCD bytes.                                     */
 /*-------------------------------------------------------------------*/
-void packed_to_binary (BYTE *dec, int len, U64 *result,
-                        int *ovf, int *dxf)
+typedef struct _PACKBIN {
+    U64     hi;                         /* Digits 16-30 in binary    */
+    U64     lo;                         /* Digits 0-15 in binary     */
+} PACKBIN;
+
+#define PACKBIN_LIMB    10000000000000000ULL    /* 10**16            */
+
+static const U64 packbin_pow10[17] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL };
+
+/* Binary 0-99 to two BCD digits */
+#define PACKBIN_ROW(_t) \
+    (_t)<<4|0, (_t)<<4|1, (_t)<<4|2, (_t)<<4|3, (_t)<<4|4, \
+    (_t)<<4|5, (_t)<<4|6, (_t)<<4|7, (_t)<<4|8, (_t)<<4|9
+static const BYTE packbin_bcd[100] = {
+    PACKBIN_ROW(0), PACKBIN_ROW(1), PACKBIN_ROW(2), PACKBIN_ROW(3),
+    PACKBIN_ROW(4), PACKBIN_ROW(5), PACKBIN_ROW(6), PACKBIN_ROW(7),
+    PACKBIN_ROW(8), PACKBIN_ROW(9) };
+
+/*-------------------------------------------------------------------*/
+/* Return nonzero if any of the 16 nibbles of x is not a digit       */
+/*-------------------------------------------------------------------*/
+static INLINE U64 bcd16_invalid (U64 x)
 {
-U64     dreg;                           /* 64-bit result accumulator */
-int     i;                              /* Loop counter              */
-int     h, d=0;                         /* Decimal digits            */
-U64     inter_u64max_div10;
-int     inter_u64max_rem10;
-U64     pos_u64max = 9223372036854775807ULL;  // (LLONG_MAX)
-U64     neg_u64max = 9223372036854775808ULL;  // (LLONG_MIN)
+    /* Adding 6 to a nibble carries into bit 4 of its byte if > 9 */
+    return ((( x       & 0x0F0F0F0F0F0F0F0FULL) + 0x0606060606060606ULL)
+          | (((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) + 0x0606060606060606ULL))
+          & 0x1010101010101010ULL;
+}
 
-    /* Initialize result flags */
-    *ovf = 0;
-    *dxf = 0;
+/*-------------------------------------------------------------------*/
+/* Convert 16 BCD digits to binary                                   */
+/*-------------------------------------------------------------------*/
+static INLINE U64 bcd16_to_bin (U64 x)
+{
+    /* Combine digit pairs, then pairs of pairs, and so on */
+    x = (x & 0x0F0F0F0F0F0F0F0FULL) + ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) * 10;
+    x = (x & 0x00FF00FF00FF00FFULL) + ((x >> 8) & 0x00FF00FF00FF00FFULL) * 100;
+    x = (x & 0x0000FFFF0000FFFFULL) + ((x >> 16) & 0x0000FFFF0000FFFFULL) * 10000;
+    return (x & 0xFFFFFFFFULL) + (x >> 32) * 100000000ULL;
+}
 
-    /* Initialize 64-bit result accumulator */
-    dreg = 0;
+/*-------------------------------------------------------------------*/
+/* Convert a binary number less than 10**16 to 16 BCD digits         */
+/*-------------------------------------------------------------------*/
+static INLINE U64 bin_to_bcd16 (U64 x)
+{
+U64     bcd = 0;                        /* BCD result                */
+U32     h, l;                           /* Eight-digit halves        */
+int     i;                              /* Two-digit group number    */
 
-    /* Initialize max unsigned intermediate value for overflow check */
-    if ((dec[len] & 0x0F) == 0x0B ||
-        (dec[len] & 0x0F) == 0x0D)
-    {
-        inter_u64max_div10 =       (neg_u64max / 10);
-        inter_u64max_rem10 = (int) (neg_u64max % 10);
-    }
-    else if ((dec[len] & 0x0F) < 0x0A)
-    {
-        *dxf = 1;
-        return;
-    }
-    else
+    h = (U32)(x / 100000000ULL);
+    l = (U32)(x % 100000000ULL);
+    for (i = 0; i < 32; i += 8, h /= 100, l /= 100)
     {
-        inter_u64max_div10 =       (pos_u64max / 10);
-        inter_u64max_rem10 = (int) (pos_u64max % 10);
+        bcd |= (U64)packbin_bcd[l % 100] << i;
+        bcd |= (U64)packbin_bcd[h % 100] << (i + 32);
     }
+    return bcd;
+}
 
-    /* Convert decimal digits to binary */
-    for (i = 0; i <= len; i++)
-    {
-        /* Isolate high-order and low-order digits */
-        h = (dec[i] & 0xF0) >> 4;
-        d = dec[i] & 0x0F;
+/*-------------------------------------------------------------------*/
+/* Convert a packed decimal number to binary                         */
+/*                                                                   */
+/* Input:                                                            */
+/*      pack    A 16-byte area containing the packed decimal number, */
+/*              padded to the left with zeroes.                      */
+/* Output:                                                           */
+/*      v       Points to the binary magnitude.                      */
+/*      sign    Points to an integer which will be set to -1 if the  */
+/*              sign is negative (X'B' or X'D'), else to +1.         */
+/*      Returns 1 if an invalid digit or sign was found, else 0.     */
+/*-------------------------------------------------------------------*/
+static int packed_to_packbin (BYTE *pack, PACKBIN *v, int *sign)
+{
+U64     hi, lo;                         /* Digits without the sign   */
+int     s;                              /* Sign nibble               */
 
-        /* Data exception if high-order digit is invalid */
-        if (h > 9)
-        {
-            *dxf = 1;
-            return;
-        }
+    hi = fetch_dw (pack);
+    lo = fetch_dw (pack + 8);
+    s = lo & 0x0F;
 
-        /* Check for overflow before accumulating */
-        if ( dreg >  inter_u64max_div10 ||
-            (dreg == inter_u64max_div10 &&
-                h >  inter_u64max_rem10)) // (NOTE: 'h', not 'd')
-        {
-            *ovf = 1;
-        }
+    /* Shift out the sign, leaving 15 and 16 digits */
+    lo = (lo >> 4) | (hi << 60);
+    hi >>= 4;
 
-        /* Accumulate high-order digit into result */
-        dreg *= 10;
-        dreg += h;
+    /* The outputs are set even when the operand is invalid */
+    v->hi = bcd16_to_bin (hi);
+    v->lo = bcd16_to_bin (lo);
+    *sign = (s == 0x0B || s == 0x0D) ? -1 : 1;
 
-        /* Check for valid low-order digit or sign */
-        if (i < len)
-        {
-            /* Data exception if low-order digit is invalid */
-            if (d > 9)
-            {
-                *dxf = 1;
-                return;
-            }
+    return (s < 0x0A || bcd16_invalid (hi) || bcd16_invalid (lo));
 
-            /* Check for overflow before accumulating */
-            if ( dreg >  inter_u64max_div10 ||
-                (dreg == inter_u64max_div10 &&
-                    d >  inter_u64max_rem10)) // (NOTE: 'd', not 'h')
-            {
-                *ovf = 1;
-            }
+} /* end function packed_to_packbin */
 
-            /* Accumulate low-order digit into result */
-            dreg *= 10;
-            dreg += d;
-        }
-        else
-        {
-            /* Data exception if sign is invalid */
-            if (d < 10)
-            {
-                *dxf = 1;
-                return;
-            }
-        }
+/*-------------------------------------------------------------------*/
+/* Convert a binary magnitude and sign to packed decimal             */
+/*                                                                   */
+/* The result is 31 digits and a preferred sign (X'C' or X'D') in a  */
+/* 16-byte area.  Digits beyond the 31st are lost.                   */
+/*-------------------------------------------------------------------*/
+static void packbin_to_packed (PACKBIN *v, int sign, BYTE *pack)
+{
+U64     hi, lo;                         /* BCD digits                */
 
-    } /* end for(i) */
+    hi = bin_to_bcd16 (v->hi % packbin_pow10[15]);
+    lo = bin_to_bcd16 (v->lo);
+    store_dw (pack, (hi << 4) | (lo >> 60));
+    store_dw (pack + 8, (lo << 4) | (sign < 0 ? 0x0D : 0x0C));
 
-    /* Result is negative if sign is X'B' or X'D' */
-    if (d == 0x0B || d == 0x0D)
-    {
-        /* Check for UNDERflow (less than min negative) */
-        if ( dreg > neg_u64max )
-            *ovf = 1;
-        else
-        dreg = -((S64)dreg);
-    }
-    else
-    {
-        /* Check for OVERflow (greater than max positive) */
-        if ( dreg > pos_u64max )
-            *ovf = 1;
-    }
+} /* end function packbin_to_packed */
 
-    /* Set result field and return */
-    *result = dreg;
+/*-------------------------------------------------------------------*/
+/* Return the number of significant digits of a binary magnitude     */
+/*-------------------------------------------------------------------*/
+static int packbin_digits (PACKBIN *v)
+{
+U64     x;                              /* Most significant limb     */
+int     n;                              /* Digit count               */
 
-} /* end function packed_to_binary */
+    x = v->hi ? v->hi : v->lo;
+    for (n = 0; n < 16 && x >= packbin_pow10[n]; n++);
+    return v->hi ? n + 16 : n;
+}
 
 /*-------------------------------------------------------------------*/
-/* Convert binary number to packed decimal                           */
-/*                                                                   */
-/* This subroutine is called by the CVD/CVDY/CVDG instructions.      */
-/* It performs the conversion of a 64-bit signed binary number       */
-/* to a 16-byte packed decimal result. Since the maximum 63 bit      */
-/* number is less than 31 decimal digits, overflow cannot occur.     */
-/* Similarly, the maximum 31 bit number is less than 15 decimal      */
-/* digits, therefore CVD/CVDY can safely use the rightmost eight     */
-/* bytes of the packed decimal result without risk of overflow.      */
-/*                                                                   */
-/* This routine is not architecture-dependent; all of its operands   */
-/* are contained in work areas passed by the architecture-dependent  */
-/* instruction routines which handle all main-storage accesses and   */
-/* possible program checks.                                          */
+/* Return 1 if a binary magnitude fits in the given number of digits */
+/*-------------------------------------------------------------------*/
+static INLINE int packbin_fits (PACKBIN *v, int digits)
+{
+    if (digits >= 16)
+        return v->hi < packbin_pow10[digits - 16];
+    return v->hi == 0 && v->lo < packbin_pow10[digits];
+}
+
+/*-------------------------------------------------------------------*/
+/* Compare two binary magnitudes, returning -1, 0 or 1               */
+/*-------------------------------------------------------------------*/
+static INLINE int packbin_compare (PACKBIN *a, PACKBIN *b)
+{
+    if (a->hi != b->hi)
+        return a->hi < b->hi ? -1 : 1;
+    if (a->lo != b->lo)
+        return a->lo < b->lo ? -1 : 1;
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* Add or subtract signed binary values                              */
 /*                                                                   */
 /* Input:                                                            */
-/*      bin     Binary number (63 bits plus sign)                    */
+/*      a, sa   First operand magnitude and sign                     */
+/*      b, sb   Second operand magnitude and sign (already inverted  */
+/*              by the caller for a subtraction)                     */
 /* Output:                                                           */
-/*      result  Points to a 16-byte field which will receive the     */
-/*              result as a packed decimal number (31 digits + sign) */
+/*      r, sr   Result magnitude and sign.  A zero result is         */
+/*              positive.  A result of 32 digits has hi >= 10**15.   */
 /*-------------------------------------------------------------------*/
-void binary_to_packed (S64 bin, BYTE *result)
+static void packbin_add (PACKBIN *a, int sa, PACKBIN *b, int sb,
+                         PACKBIN *r, int *sr)
 {
-int     i;                              /* Array subscript           */
-int     d;                              /* Decimal digit or sign     */
+PACKBIN *h, *l;                         /* Larger and smaller        */
 
-    /* Special case when input is maximum negative value */
-    if ((U64)bin == 0x8000000000000000ULL)
+    if (sa == sb)
     {
-        memcpy (result,
-                "\x00\x00\x00\x00\x00\x00\x92\x23"
-                "\x37\x20\x36\x85\x47\x75\x80\x8D",
-                16);
+        r->lo = a->lo + b->lo;
+        r->hi = a->hi + b->hi;
+        if (r->lo >= PACKBIN_LIMB)
+        {
+            r->lo -= PACKBIN_LIMB;
+            r->hi++;
+        }
+        *sr = sa;
     }
     else
     {
-        /* Load absolute value and generate sign */
-        if ((U64)bin < 0x8000000000000000ULL)
-        {
-            /* Value is positive */
-            d = 0x0C;
-        }
+        if (packbin_compare (a, b) >= 0)
+            h = a, l = b, *sr = sa;
         else
-        {
-            /* Value is negative */
-            bin = -bin;
-            d = 0x0D;
-        }
+            h = b, l = a, *sr = sb;
 
-        /* Store sign and decimal digits from right to left */
-        memset (result, 0, 16);
-        for (i = 16 - 1; d != 0 || bin != 0; i--)
+        r->hi = h->hi - l->hi;
+        if (h->lo >= l->lo)
+            r->lo = h->lo - l->lo;
+        else
         {
-            result[i] = d;
-            d = bin % 10;
-            bin /= 10;
-            result[i] |= (d << 4);
-            d = bin % 10;
-            bin /= 10;
+            r->lo = h->lo + PACKBIN_LIMB - l->lo;
+            r->hi--;
         }
     }
 
-} /* end function(binary_to_packed) */
+    if (r->hi == 0 && r->lo == 0)
+        *sr = 1;
+
+} /* end function packbin_add */
 
 /*-------------------------------------------------------------------*/
-/* Add two decimal byte strings as unsigned decimal numbers          */
+/* Multiply a binary magnitude by one of at most 15 digits           */
 /*                                                                   */
-/* Input:                                                            */
-/*      dec1    A 31-byte area containing the decimal digits of      */
-/*              the first operand.  Each byte contains one decimal   */
-/*              digit in the low-order 4 bits of the byte.           */
-/*      dec2    A 31-byte area containing the decimal digits of      */
-/*              the second operand.  Each byte contains one decimal  */
-/*              digit in the low-order 4 bits of the byte.           */
-/* Output:                                                           */
-/*      result  Points to a 31-byte area to contain the result       */
-/*              digits. One decimal digit is placed in the low-order */
-/*              4 bits of each byte.                                 */
-/*      count   Points to an integer to receive the number of        */
-/*              digits in the result excluding leading zeroes.       */
-/*              This field is set to zero if the result is all zero, */
-/*              or to MAX_DECIMAL_DIGITS+1 if overflow occurred.     */
+/* The caller ensures that the product has at most 31 digits.  The   */
+/* operands are split into eight-digit pieces so that no partial     */
+/* product or sum of partial products exceeds 64 bits.               */
 /*-------------------------------------------------------------------*/
-static void add_decimal (BYTE *dec1, BYTE *dec2,
-                        BYTE *result, int *count)
+static void packbin_multiply (PACKBIN *a, PACKBIN *b, PACKBIN *r)
 {
-int     d;                              /* Decimal digit             */
-int     i;                              /* Array subscript           */
-int     n = 0;                          /* Significant digit counter */
-int     carry = 0;                      /* Carry indicator           */
+U64     x[4], y[2], z[6];               /* Base 10**8 digits         */
+U64     carry;                          /* Carry to next digit       */
+int     i, j;                           /* Digit subscripts          */
 
-    /* Add digits from right to left */
-    for (i = MAX_DECIMAL_DIGITS - 1; i >= 0; i--)
+    x[0] = a->lo % 100000000ULL;  x[1] = a->lo / 100000000ULL;
+    x[2] = a->hi % 100000000ULL;  x[3] = a->hi / 100000000ULL;
+    y[0] = b->lo % 100000000ULL;  y[1] = b->lo / 100000000ULL;
+
+    memset (z, 0, sizeof(z));
+    for (j = 0; j < 2; j++)
     {
-        /* Add digits from first and second operands */
-        d = dec1[i] + dec2[i] + carry;
-
-        /* Check for carry into next digit */
-        if (d > 9) {
-            d -= 10;
-            carry = 1;
-        } else {
-            carry = 0;
+        if (y[j] == 0)
+            continue;
+        for (i = 0, carry = 0; i < 4; i++)
+        {
+            carry += z[i+j] + x[i] * y[j];
+            z[i+j] = carry % 100000000ULL;
+            carry /= 100000000ULL;
         }
+        z[i+j] += carry;
+    }
 
-        /* Check for significant digit */
-        if (d != 0)
-            n = MAX_DECIMAL_DIGITS - i;
-
-        /* Store digit in result */
-        result[i] = d;
-
-    } /* end for */
-
-    /* Check for carry out of leftmost digit */
-    if (carry)
-        n = MAX_DECIMAL_DIGITS + 1;
-
-    /* Return significant digit counter */
-    *count = n;
+    r->lo = z[1] * 100000000ULL + z[0];
+    r->hi = z[3] * 100000000ULL + z[2];
 
-} /* end function add_decimal */
+} /* end function packbin_multiply */
 
 /*-------------------------------------------------------------------*/
-/* Subtract two decimal byte strings as unsigned decimal numbers     */
+/* Divide a binary magnitude by one of at most 15 digits             */
 /*                                                                   */
-/* Input:                                                            */
-/*      dec1    A 31-byte area containing the decimal digits of      */
-/*              the first operand.  Each byte contains one decimal   */
-/*              digit in the low-order 4 bits of the byte.           */
-/*      dec2    A 31-byte area containing the decimal digits of      */
-/*              the second operand.  Each byte contains one decimal  */
-/*              digit in the low-order 4 bits of the byte.           */
-/* Output:                                                           */
-/*      result  Points to a 31-byte area to contain the result       */
-/*              digits. One decimal digit is placed in the low-order */
-/*              4 bits of each byte.                                 */
-/*      count   Points to an integer to receive the number of        */
-/*              digits in the result excluding leading zeroes.       */
-/*              This field is set to zero if the result is all zero. */
-/*      sign    -1 if the result is negative (operand2 > operand1)   */
-/*              +1 if the result is positive (operand2 <= operand1)  */
+/* The dividend is processed four digits at a time, which keeps the  */
+/* partial dividend (remainder * 10**4 + four digits) below 10**19.  */
+/* The caller ensures that the divisor is not zero.                  */
 /*-------------------------------------------------------------------*/
-static void subtract_decimal (BYTE *dec1, BYTE *dec2,
-                        BYTE *result, int *count, int *sign)
+static void packbin_divide (PACKBIN *a, PACKBIN *b, PACKBIN *quot,
+                            PACKBIN *rem)
 {
-int     d;                              /* Decimal digit             */
-int     i;                              /* Array subscript           */
-int     n = 0;                          /* Significant digit counter */
-int     borrow = 0;                     /* Borrow indicator          */
-int     rc;                             /* Return code               */
-BYTE   *higher;                         /* -> Higher value operand   */
-BYTE   *lower;                          /* -> Lower value operand    */
-
-    /* Compare digits to find which operand has higher numeric value */
-    rc = memcmp (dec1, dec2, MAX_DECIMAL_DIGITS);
-
-    /* Return positive zero result if both operands are equal */
-    if (rc == 0) {
-        memset (result, 0, MAX_DECIMAL_DIGITS);
-        *count = 0;
-        *sign = +1;
-        return;
-    }
+U64     d = b->lo;                      /* Divisor                   */
+U64     r = 0;                          /* Running remainder         */
+U64     q[2];                           /* Quotient limbs            */
+U64     limb;                           /* Dividend limb             */
+int     i, k;                           /* Limb and group numbers    */
 
-    /* Point to higher and lower value operands and set sign */
-    if (rc > 0) {
-        higher = dec1;
-        lower = dec2;
-       *sign = +1;
-    } else {
-        lower = dec1;
-        higher = dec2;
-       *sign = -1;
-    }
-
-    /* Subtract digits from right to left */
-    for (i = MAX_DECIMAL_DIGITS - 1; i >= 0; i--)
+    for (i = 0; i < 2; i++)
     {
-        /* Subtract lower operand digit from higher operand digit */
-        d = higher[i] - lower[i] - borrow;
-
-        /* Check for borrow from next digit */
-        if (d < 0) {
-            d += 10;
-            borrow = 1;
-        } else {
-            borrow = 0;
+        limb = i == 0 ? a->hi : a->lo;
+        q[i] = 0;
+        for (k = 12; k >= 0; k -= 4)
+        {
+            r = r * 10000 + (limb / packbin_pow10[k]) % 10000;
+            q[i] = q[i] * 10000 + r / d;
+            r %= d;
         }
+    }
 
-        /* Check for significant digit */
-        if (d != 0)
-            n = MAX_DECIMAL_DIGITS - i;
-
-        /* Store digit in result */
-        result[i] = d;
-
-    } /* end for */
-
-    /* Return significant digit counter */
-    *count = n;
+    quot->hi = q[0];
+    quot->lo = q[1];
+    rem->hi = 0;
+    rem->lo = r;
 
-} /* end function subtract_decimal */
+} /* end function packbin_divide */
 
 /*-------------------------------------------------------------------*/
-/* Divide two decimal byte strings as unsigned decimal numbers       */
+/* Convert packed decimal number to binary                           */
+/*                                                                   */
+/* This subroutine is called by the CVB/CVBY/CVBG instructions.      */
+/* It performs the conversion of a 8-byte or 16-byte packed          */
+/* decimal number into a 64-bit SIGNED binary result.                */
+/* This routine is not architecture-dependent; all of its operands   */
+/* are contained in work areas passed by the architecture-dependent  */
+/* instruction routines which handle all main-storage accesses and   */
+/* possible program checks.                                          */
 /*                                                                   */
 /* Input:                                                            */
-/*      dec1    A 31-byte area containing the decimal digits of      */
-/*              the dividend.  Each byte contains one decimal        */
-/*              digit in the low-order 4 bits of the byte.           */
-/*      count1  The number of significant digits in the dividend.    */
-/*      dec2    A 31-byte area containing the decimal digits of      */
-/*              the divisor.  Each byte contains one decimal         */
-/*              digit in the low-order 4 bits of the byte.           */
-/*      count2  The number of significant digits in the divisor.     */
+/*      dec     An 8 or 16 byte area containing a copy of the        */
+/*              packed decimal storage operand.                      */
+/*      len     Length-1 (in bytes) of the packed decimal input      */
+/*              (7 for CVB/CVBY or 15 for CVBG).                     */
 /* Output:                                                           */
-/*      quot    Points to a 31-byte area to contain the quotient     */
-/*              digits. One decimal digit is placed in the low-order */
-/*              4 bits of each byte.                                 */
-/*      rem     Points to a 31-byte area to contain the remainder    */
-/*              digits. One decimal digit is placed in the low-order */
-/*              4 bits of each byte.                                 */
-/* Restrictions:                                                     */
-/*      It is assumed that the caller has already verified that      */
-/*      divide overflow cannot occur, that the divisor is not zero,  */
-/*      and that the dividend has at least one high order zero.      */
+/*      result  Points to an U64 field which will receive the        */
+/*              result as a 64-bit SIGNED binary number.             */
+/*      ovf     Points to an int field which will be set to 1 if     */
+/*              the result overflows 63 bits plus sign, else 0.      */
+/*              If overflow occurs, the result field will contain    */
+/*              the rightmost 64 bits of the result.                 */
+/*      dxf     Points to an int field which will be set to 1 if     */
+/*              invalid digits or sign were detected, else 0.        */
+/*              The result field is not set if the dxf is set to 1.  */
 /*-------------------------------------------------------------------*/
-static void divide_decimal (BYTE *dec1, int count1, BYTE *dec2,
-                        int count2, BYTE *quot, BYTE *rem)
+void packed_to_binary (BYTE *dec, int len, U64 *result,
+                        int *ovf, int *dxf)
 {
-BYTE   *num1;                           /* -> dividend digits        */
-BYTE   *num2;                           /* -> divisor digits         */
-int     div, flag, scale;               /* Work areas for algorithm  */
-int     index, index1, index2;          /* Work areas for algorithm  */
-int     indexq, indexr, temp1, temp2;   /* Work areas for algorithm  */
-int     temp3, temp4, temp5, qtest;     /* Work areas for algorithm  */
-
-    /* Clear the result fields */
-    memset (quot, 0, MAX_DECIMAL_DIGITS);
-    memset (rem, 0, MAX_DECIMAL_DIGITS);
-
-    /* If dividend is zero then return zero quotient and remainder */
-    if (count1 == 0)
-        return;
+BYTE    pack[MAX_DECIMAL_LENGTH];       /* Packed decimal work area  */
+PACKBIN v;                              /* Binary magnitude          */
+int     sign;                           /* Sign of operand           */
+U64     dreg;                           /* 64-bit result             */
+U64     max;                            /* Largest magnitude allowed */
 
-    /* If dividend is less than divisor then return zero quotient
-       and set remainder equal to dividend */
-    if (memcmp (dec1, dec2, MAX_DECIMAL_DIGITS) < 0)
+    /* Initialize result flags */
+    *ovf = 0;
+    *dxf = 0;
+
+    /* Validate and convert the operand */
+    memset (pack, 0, sizeof(pack));
+    memcpy (pack + sizeof(pack) - len - 1, dec, len + 1);
+    if (packed_to_packbin (pack, &v, &sign))
     {
-        memcpy (rem, dec1, MAX_DECIMAL_DIGITS);
+        *dxf = 1;
         return;
     }
 
-    /* Adjust dividend digit count to give one leading zero */
-    count1++;
-
-    /* Point to significant digits of dividend with leading zero */
-    num1 = dec1 + MAX_DECIMAL_DIGITS - count1;
+    /* The rightmost 64 bits of the magnitude, which are exact
+       unless the magnitude has 20 or more digits */
+    dreg = v.hi * PACKBIN_LIMB + v.lo;
 
-    /* Point to significant digits of divisor */
-    num2 = dec2 + MAX_DECIMAL_DIGITS - count2;
+    /* Overflow if the magnitude exceeds 2**63-1, or 2**63 if the
+       result is negative */
+    max = sign < 0 ? 0x8000000000000000ULL : 0x7FFFFFFFFFFFFFFFULL;
+    if (v.hi >= 1000 || dreg > max)
+        *ovf = 1;
 
-    scale = 10 / (num2[0] + 1);
-    if (scale > 1)
-    {
-        for (index1 = count1-1, flag = 0; index1 >= 0; index1--)
-        {
-            div = flag + scale*num1[index1];
-            num1[index1] = div % 10;
-            flag = div / 10;
-        } /* end for(index1) */
-
-        for (index2 = count2-1, flag = 0; index2 >= 0; index2--)
-        {
-            div = flag + scale*num2[index2];
-            num2[index2] = div % 10;
-            flag = div / 10;
-        } /* end for(index2) */
-
-    } /* end if(scale>1) */
+    /* Negate the result if negative, unless it has overflowed into
+       the sign bit, in which case the rightmost 64 bits are kept */
+    if (sign < 0 && !(*ovf && dreg > max))
+        dreg = -((S64)dreg);
 
-    for (index1 = 0; index1 < count1-count2; index1++)
-    {
-        if (num2[0] == num1[index1])
-            qtest = 9;
-        else
-        {
-            temp2 = (index1+1 < count1) ? num1[index1+1] : 0;
-            qtest = (10*num1[index1] + temp2) / num2[0];
-        }
-        temp2 = num1[index1];
-        temp4 = num2[0];
-        temp1 = (count2 >= 2) ? num2[1] : 0;
-        if (index1+1 < count1)
-        {
-            temp3 = num1[index1+1];
-            temp5 = (index1+2 < count1) ? num1[index1+2] : 0;
-        }
-        else
-        {
-            temp3 = 0;
-            temp5 = 0;
-        }
-        while (qtest*temp1 > (10*(10*temp2 + temp3
-                            - qtest*temp4) + temp5))
-            --qtest;
+    /* Set result field and return */
+    *result = dreg;
 
-        for (index = index1+count2, index2 = count2-1, flag = 0;
-                index >= index1; index--, index2--)
-        {
-            if (index2 >= 0)
-                flag -= qtest*num2[index2];
-            div = flag + num1[index];
-            if (div < 0)
-            {
-                flag = div / 10;
-                div %= 10;
-                if (div < 0)
-                {
-                    div += 10;
-                    --flag;
-                }
-            }
-            else
-                flag = 0;
-            num1[index] = div;
-        } /* end for(index) */
+} /* end function packed_to_binary */
 
-        indexq = MAX_DECIMAL_DIGITS - (count1-count2) + index1;
-        if (flag != 0)
-        {
-            quot[indexq] = qtest - 1;
-            for (index = index1+count2, index2 = count2-1, flag = 0;
-                    index >= index1; index--, index2--)
-            {
-                if (index2 >= 0)
-                    flag += num2[index2];
-                div = flag + num1[index];
-                if (div > 9)
-                {
-                    div -= 10;
-                    flag = 1;
-                }
-                else
-                    flag = 0;
-                num1[index] = div;
-            } /* end for(index) */
-        }
-        else
-            quot[indexq] = qtest;
-    } /* end for(index1) */
+/*-------------------------------------------------------------------*/
+/* Convert binary number to packed decimal                           */
+/*                                                                   */
+/* This subroutine is called by the CVD/CVDY/CVDG instructions.      */
+/* It performs the conversion of a 64-bit signed binary number       */
+/* to a 16-byte packed decimal result. Since the maximum 63 bit      */
+/* number is less than 31 decimal digits, overflow cannot occur.     */
+/* Similarly, the maximum 31 bit number is less than 15 decimal      */
+/* digits, therefore CVD/CVDY can safely use the rightmost eight     */
+/* bytes of the packed decimal result without risk of overflow.      */
+/*                                                                   */
+/* This routine is not architecture-dependent; all of its operands   */
+/* are contained in work areas passed by the architecture-dependent  */
+/* instruction routines which handle all main-storage accesses and   */
+/* possible program checks.                                          */
+/*                                                                   */
+/* Input:                                                            */
+/*      bin     Binary number (63 bits plus sign)                    */
+/* Output:                                                           */
+/*      result  Points to a 16-byte field which will receive the     */
+/*              result as a packed decimal number (31 digits + sign) */
+/*-------------------------------------------------------------------*/
+void binary_to_packed (S64 bin, BYTE *result)
+{
+PACKBIN v;                              /* Binary magnitude          */
+U64     mag;                            /* Absolute value            */
 
-    for (index1 = count1-count2,
-            indexr = MAX_DECIMAL_DIGITS-count2, flag = 0;
-            index1 < count1; index1++, indexr++)
-    {
-        div = num1[index1] + 10*flag;
-        rem[indexr] = div / scale;
-        flag = div % scale;
-    } /* end for(index1) */
+    /* Load absolute value; the maximum negative value is fine
+       since the negation is done unsigned */
+    mag = bin < 0 ? 0 - (U64)bin : (U64)bin;
+    v.hi = mag / PACKBIN_LIMB;
+    v.lo = mag % PACKBIN_LIMB;
 
-    for (index2 = 0, flag = 0; index2 < count2; index2++)
-    {
-        div = num2[index2] + 10*flag;
-        num2[index2] = div / scale;
-        flag = div % scale;
-    } /* end for(index2) */
+    /* Convert to packed decimal */
+    packbin_to_packed (&v, bin < 0 ? -1 : 1, result);
 
-} /* end function divide_decimal */
+} /* end function(binary_to_packed) */
 
 #endif /*!defined(_DECIMAL_C)*/
 
@@ -599,6 +472,10 @@ int     i, j;                           /* Array subscripts          */
 int     n;                              /* Significant digit counter */
 BYTE    pack[MAX_DECIMAL_LENGTH];       /* Packed decimal work area  */
 
+    /* Outputs are defined even if a program check is taken */
+    *count = 0;
+    *sign = 1;
+
     /* Fetch the packed decimal operand into work area */
     memset( pack, 0, sizeof(pack) );
     ARCH_DEP(vfetchc) (pack+sizeof(pack)-len-1, len, addr, arn, regs);
@@ -691,6 +568,75 @@ BYTE    pack[MAX_DECIMAL_LENGTH];       /* Packed decimal work area  */
 
 } /* end function ARCH_DEP(store_decimal) */
 
+/*-------------------------------------------------------------------*/
+/* Load a packed decimal storage operand in binary                   */
+/*                                                                   */
+/* Input:                                                            */
+/*      addr    Logical address of packed decimal storage operand    */
+/*      len     Length minus one of storage operand (range 0-15)     */
+/*      arn     Access register number associated with operand       */
+/*      regs    CPU register context                                 */
+/* Output:                                                           */
+/*      v       Points to the binary magnitude of the operand.       */
+/*      sign    Points to an integer which will be set to -1 if a    */
+/*              negative sign was loaded from the operand, or +1 if  */
+/*              a positive sign was loaded from the operand.         */
+/*                                                                   */
+/*      A program check may be generated if the logical address      */
+/*      causes an addressing, translation, or fetch protection       */
+/*      exception, or if the operand causes a data exception         */
+/*      because of invalid decimal digits or sign.                   */
+/*-------------------------------------------------------------------*/
+static INLINE void ARCH_DEP(load_packbin) (VADR addr, int len, int arn,
+                        REGS *regs, PACKBIN *v, int *sign)
+{
+BYTE    pack[MAX_DECIMAL_LENGTH];       /* Packed decimal work area  */
+
+    /* Fetch the packed decimal operand into work area */
+    memset( pack, 0, sizeof(pack) );
+    ARCH_DEP(vfetchc) (pack+sizeof(pack)-len-1, len, addr, arn, regs);
+
+    /* Validate and convert it */
+    if (packed_to_packbin (pack, v, sign))
+    {
+        regs->dxc = DXC_DECIMAL;
+        ARCH_DEP(program_interrupt) (regs, PGM_DATA_EXCEPTION);
+    }
+
+} /* end function ARCH_DEP(load_packbin) */
+
+/*-------------------------------------------------------------------*/
+/* Store a binary magnitude into packed decimal storage operand      */
+/*                                                                   */
+/* Input:                                                            */
+/*      addr    Logical address of packed decimal storage operand    */
+/*      len     Length minus one of storage operand (range 0-15)     */
+/*      arn     Access register number associated with operand       */
+/*      regs    CPU register context                                 */
+/*      v       The binary magnitude to be stored.  Digits which do  */
+/*              not fit in the operand are lost.                     */
+/*      sign    -1 if a negative sign is to be stored, or +1 if a    */
+/*              positive sign is to be stored.                       */
+/*                                                                   */
+/*      A program check may be generated if the logical address      */
+/*      causes an addressing, translation, or protection exception.  */
+/*-------------------------------------------------------------------*/
+static INLINE void ARCH_DEP(store_packbin) (VADR addr, int len, int arn,
+                        REGS *regs, PACKBIN *v, int sign)
+{
+BYTE    pack[MAX_DECIMAL_LENGTH];       /* Packed decimal work area  */
+
+    /* if operand crosses page, make sure both pages are accessible */
+    if((addr & PAGEFRAME_PAGEMASK) !=
+        ((addr + len) & PAGEFRAME_PAGEMASK))
+        ARCH_DEP(validate_operand) (addr, arn, len, ACCTYPE_WRITE_SKP, regs);
+
+    /* Convert to packed decimal and store the rightmost bytes */
+    packbin_to_packed (v, sign, pack);
+    ARCH_DEP(vstorec) (pack+sizeof(pack)-len-1, len, addr, arn, regs);
+
+} /* end function ARCH_DEP(store_packbin) */
+
 
 /*-------------------------------------------------------------------*/
 /* FA   AP    - Add Decimal                                   [SS-b] */
@@ -702,61 +648,29 @@ int     b1, b2;                         /* Base register numbers     */
 VADR    effective_addr1,
         effective_addr2;                /* Effective addresses       */
 int     cc;                             /* Condition code            */
-BYTE    dec1[MAX_DECIMAL_DIGITS];       /* Work area for operand 1   */
-BYTE    dec2[MAX_DECIMAL_DIGITS];       /* Work area for operand 2   */
-BYTE    dec3[MAX_DECIMAL_DIGITS];       /* Work area for result      */
-int     count1, count2, count3;         /* Significant digit counters*/
+PACKBIN v1, v2, v3;                     /* Operands and result       */
 int     sign1, sign2, sign3;            /* Sign of operands & result */
 
     SS(inst, regs, l1, l2, b1, effective_addr1, b2, effective_addr2);
     PER_ZEROADDR_XCHECK2( regs, b1, b2 );
     TXFC_INSTR_CHECK( regs );
 
-    /* Load operands into work areas */
-    ARCH_DEP(load_decimal) (effective_addr1, l1, b1, regs, dec1, &count1, &sign1);
-    ARCH_DEP(load_decimal) (effective_addr2, l2, b2, regs, dec2, &count2, &sign2);
+    /* Load operands */
+    ARCH_DEP(load_packbin) (effective_addr1, l1, b1, regs, &v1, &sign1);
+    ARCH_DEP(load_packbin) (effective_addr2, l2, b2, regs, &v2, &sign2);
 
-    /* Add or subtract operand values */
-    if (count2 == 0)
-    {
-        /* If second operand is zero then result is first operand */
-        memcpy (dec3, dec1, MAX_DECIMAL_DIGITS);
-        count3 = count1;
-        sign3 = sign1;
-    }
-    else if (count1 == 0)
-    {
-        /* If first operand is zero then result is second operand */
-        memcpy (dec3, dec2, MAX_DECIMAL_DIGITS);
-        count3 = count2;
-        sign3 = sign2;
-    }
-    else if (sign1 == sign2)
-    {
-        /* If signs are equal then add operands */
-        add_decimal (dec1, dec2, dec3, &count3);
-        sign3 = sign1;
-    }
-    else
-    {
-        /* If signs are opposite then subtract operands */
-        subtract_decimal (dec1, dec2, dec3, &count3, &sign3);
-        if (sign1 < 0) sign3 = -sign3;
-    }
+    /* Add operand values */
+    packbin_add (&v1, sign1, &v2, sign2, &v3, &sign3);
 
-    /* Set condition code */
-    cc = (count3 == 0) ? 0 : (sign3 < 1) ? 1 : 2;
+    /* Set condition code; a zero result has a positive sign */
+    cc = (v3.hi == 0 && v3.lo == 0) ? 0 : (sign3 < 1) ? 1 : 2;
 
     /* Overflow if result exceeds first operand length */
-    if (count3 > (l1+1) * 2 - 1)
+    if (!packbin_fits (&v3, (l1+1) * 2 - 1))
         cc = 3;
 
-    /* Set positive sign if result is zero */
-    if (count3 == 0)
-        sign3 = 1;
-
     /* Store result into first operand location */
-    ARCH_DEP(store_decimal) (effective_addr1, l1, b1, regs, dec3, sign3);
+    ARCH_DEP(store_packbin) (effective_addr1, l1, b1, regs, &v3, sign3);
 
     /* Set condition code */
     regs->psw.cc = cc;
@@ -777,9 +691,7 @@ int     l1, l2;                         /* Length values             */
 int     b1, b2;                         /* Base register numbers     */
 VADR    effective_addr1,
         effective_addr2;                /* Effective addresses       */
-BYTE    dec1[MAX_DECIMAL_DIGITS];       /* Work area for operand 1   */
-BYTE    dec2[MAX_DECIMAL_DIGITS];       /* Work area for operand 2   */
-int     count1, count2;                 /* Significant digit counters*/
+PACKBIN v1, v2;                         /* Operand magnitudes        */
 int     sign1, sign2;                   /* Sign of each operand      */
 int     rc;                             /* Return code               */
 
@@ -787,12 +699,12 @@ int     rc;                             /* Return code               */
     PER_ZEROADDR_XCHECK2( regs, b1, b2 );
     TXFC_INSTR_CHECK( regs );
 
-    /* Load operands into work areas */
-    ARCH_DEP(load_decimal) (effective_addr1, l1, b1, regs, dec1, &count1, &sign1);
-    ARCH_DEP(load_decimal) (effective_addr2, l2, b2, regs, dec2, &count2, &sign2);
+    /* Load operands */
+    ARCH_DEP(load_packbin) (effective_addr1, l1, b1, regs, &v1, &sign1);
+    ARCH_DEP(load_packbin) (effective_addr2, l2, b2, regs, &v2, &sign2);
 
     /* Result is equal if both operands are zero */
-    if (count1 == 0 && count2 == 0)
+    if (!(v1.hi | v1.lo | v2.hi | v2.lo))
     {
         regs->psw.cc = 0;
         return;
@@ -812,8 +724,8 @@ int     rc;                             /* Return code               */
         return;
     }
 
-    /* If signs are equal then compare the digits */
-    rc = memcmp (dec1, dec2, MAX_DECIMAL_DIGITS);
+    /* If signs are equal then compare the magnitudes */
+    rc = packbin_compare (&v1, &v2);
 
     /* Return low or high (depending on sign) if digits are unequal */
     if (rc < 0)
@@ -836,11 +748,10 @@ int     l1, l2;                         /* Length values             */
 int     b1, b2;                         /* Base register numbers     */
 VADR    effective_addr1,
         effective_addr2;                /* Effective addresses       */
-BYTE    dec1[MAX_DECIMAL_DIGITS];       /* Operand 1 (dividend)      */
-BYTE    dec2[MAX_DECIMAL_DIGITS];       /* Operand 2 (divisor)       */
-BYTE    quot[MAX_DECIMAL_DIGITS];       /* Quotient                  */
-BYTE    rem[MAX_DECIMAL_DIGITS];        /* Remainder                 */
-int     count1, count2;                 /* Significant digit counters*/
+PACKBIN v1;                             /* Operand 1 (dividend)      */
+PACKBIN v2;                             /* Operand 2 (divisor)       */
+PACKBIN quot;                           /* Quotient                  */
+PACKBIN rem;                            /* Remainder                 */
 int     sign1, sign2;                   /* Sign of operands          */
 int     signq, signr;                   /* Sign of quotient/remainder*/
 
@@ -853,28 +764,24 @@ int     signq, signr;                   /* Sign of quotient/remainder*/
     if (l2 > 7 || l2 >= l1)
         ARCH_DEP(program_interrupt) (regs, PGM_SPECIFICATION_EXCEPTION);
 
-    /* Load operands into work areas */
-    ARCH_DEP(load_decimal) (effective_addr1, l1, b1, regs, dec1, &count1, &sign1);
-    ARCH_DEP(load_decimal) (effective_addr2, l2, b2, regs, dec2, &count2, &sign2);
+    /* Load operands */
+    ARCH_DEP(load_packbin) (effective_addr1, l1, b1, regs, &v1, &sign1);
+    ARCH_DEP(load_packbin) (effective_addr2, l2, b2, regs, &v2, &sign2);
 
     /* Program check if second operand value is zero */
-    if (count2 == 0)
+    if (v2.lo == 0)
         ARCH_DEP(program_interrupt) (regs, PGM_DECIMAL_DIVIDE_EXCEPTION);
 
-    /* Perform trial comparison to determine potential overflow.
-       The leftmost digit of the divisor is aligned one digit to
-       the right of the leftmost dividend digit.  When the divisor,
-       so aligned, is less than or equal to the dividend, ignoring
-       signs, a divide exception is indicated.  As a result of this
-       comparison, it is also certain that the leftmost digit of the
-       dividend must be zero, and that the divisor cannot be zero */
-    if (memcmp(dec2 + (MAX_DECIMAL_DIGITS - l2*2 - 2),
-                dec1 + (MAX_DECIMAL_DIGITS - l1*2 - 1),
-                l2*2 + 2) <= 0)
-        ARCH_DEP(program_interrupt) (regs, PGM_DECIMAL_DIVIDE_EXCEPTION);
+    /* Perform binary division */
+    packbin_divide (&v1, &v2, &quot, &rem);
 
-    /* Perform decimal division */
-    divide_decimal (dec1, count1, dec2, count2, quot, rem);
+    /* A divide exception is indicated when the quotient does not fit
+       in the leftmost l1-l2 bytes of the first operand.  This is the
+       same as the architected trial comparison, in which the divisor
+       is aligned one digit to the right of the leftmost dividend
+       digit and must be greater than the dividend so aligned */
+    if (!packbin_fits (&quot, (l1-l2) * 2 - 1))
+        ARCH_DEP(program_interrupt) (regs, PGM_DECIMAL_DIVIDE_EXCEPTION);
 
     /* Quotient is positive if operand signs are equal, and negative
        if operand signs are opposite, even if quotient is zero */
@@ -887,10 +794,10 @@ int     signq, signr;                   /* Sign of quotient/remainder*/
        field will be filled in order to check for store protection.
        Subsequently the quotient will be stored in the leftmost bytes
        of the first operand location, overwriting high order zeroes */
-    ARCH_DEP(store_decimal) (effective_addr1, l1, b1, regs, rem, signr);
+    ARCH_DEP(store_packbin) (effective_addr1, l1, b1, regs, &rem, signr);
 
     /* Store quotient in leftmost bytes of first operand location */
-    ARCH_DEP(store_decimal) (effective_addr1, l1-l2-1, b1, regs, quot, signq);
+    ARCH_DEP(store_packbin) (effective_addr1, l1-l2-1, b1, regs, &quot, signq);
 
 } /* end DEF_INST(divide_decimal) */
 
@@ -1098,14 +1005,9 @@ int     l1, l2;                         /* Length values             */
 int     b1, b2;                         /* Base register numbers     */
 VADR    effective_addr1,
         effective_addr2;                /* Effective addresses       */
-BYTE    dec1[MAX_DECIMAL_DIGITS];       /* Work area for operand 1   */
-BYTE    dec2[MAX_DECIMAL_DIGITS];       /* Work area for operand 2   */
-BYTE    dec3[MAX_DECIMAL_DIGITS];       /* Work area for result      */
-int     count1, count2;                 /* Significant digit counters*/
+PACKBIN v1, v2, v3;                     /* Operands and result       */
+int     count1;                         /* Significant digit counter */
 int     sign1, sign2, sign3;            /* Sign of operands & result */
-int     d;                              /* Decimal digit             */
-int     i1, i2, i3;                     /* Array subscripts          */
-int     carry;                          /* Carry indicator           */
 
     SS(inst, regs, l1, l2, b1, effective_addr1, b2, effective_addr2);
     PER_ZEROADDR_XCHECK2( regs, b1, b2 );
@@ -1116,43 +1018,29 @@ int     carry;                          /* Carry indicator           */
     if (l2 > 7 || l2 >= l1)
         ARCH_DEP(program_interrupt) (regs, PGM_SPECIFICATION_EXCEPTION);
 
-    /* Load operands into work areas */
-    ARCH_DEP(load_decimal) (effective_addr1, l1, b1, regs, dec1, &count1, &sign1);
-    ARCH_DEP(load_decimal) (effective_addr2, l2, b2, regs, dec2, &count2, &sign2);
+    /* Load operands */
+    ARCH_DEP(load_packbin) (effective_addr1, l1, b1, regs, &v1, &sign1);
+    ARCH_DEP(load_packbin) (effective_addr2, l2, b2, regs, &v2, &sign2);
 
     /* Program check if the number of bytes in the second operand
        is less than the number of bytes of high-order zeroes in the
        first operand; this ensures that overflow cannot occur */
+    count1 = packbin_digits (&v1);
     if (l2 > l1 - (count1/2 + 1))
     {
         regs->dxc = DXC_DECIMAL;
         ARCH_DEP(program_interrupt) (regs, PGM_DATA_EXCEPTION);
     }
 
-    /* Clear the result field */
-    memset( dec3, 0, MAX_DECIMAL_DIGITS );
-
-    /* Perform decimal multiplication */
-    for (i2 = MAX_DECIMAL_DIGITS-1; i2 >= 0; i2--)
-    {
-        if (dec2[i2] != 0)
-        {
-            for (i1 = MAX_DECIMAL_DIGITS - 1, i3 = i2, carry = 0;
-                        i3 >= 0; i1--, i3--)
-            {
-                d = carry + dec1[i1]*dec2[i2] + dec3[i3];
-                dec3[i3] = d % 10;
-                carry = d / 10;
-            }
-        }
-    } /* end for(i2) */
+    /* Perform binary multiplication */
+    packbin_multiply (&v1, &v2, &v3);
 
     /* Result is positive if operand signs are equal, and negative
        if operand signs are opposite, even if result is zero */
     sign3 = (sign1 == sign2) ? 1 : -1;
 
     /* Store result into first operand location */
-    ARCH_DEP(store_decimal) (effective_addr1, l1, b1, regs, dec3, sign3);
+    ARCH_DEP(store_packbin) (effective_addr1, l1, b1, regs, &v3, sign3);
 
 } /* end DEF_INST(multiply_decimal) */
 
@@ -1268,61 +1156,29 @@ int     b1, b2;                         /* Base register numbers     */
 VADR    effective_addr1,
         effective_addr2;                /* Effective addresses       */
 int     cc;                             /* Condition code            */
-BYTE    dec1[MAX_DECIMAL_DIGITS];       /* Work area for operand 1   */
-BYTE    dec2[MAX_DECIMAL_DIGITS];       /* Work area for operand 2   */
-BYTE    dec3[MAX_DECIMAL_DIGITS];       /* Work area for result      */
-int     count1, count2, count3;         /* Significant digit counters*/
+PACKBIN v1, v2, v3;                     /* Operands and result       */
 int     sign1, sign2, sign3;            /* Sign of operands & result */
 
     SS(inst, regs, l1, l2, b1, effective_addr1, b2, effective_addr2);
     PER_ZEROADDR_XCHECK2( regs, b1, b2 );
     TXFC_INSTR_CHECK( regs );
 
-    /* Load operands into work areas */
-    ARCH_DEP(load_decimal) (effective_addr1, l1, b1, regs, dec1, &count1, &sign1);
-    ARCH_DEP(load_decimal) (effective_addr2, l2, b2, regs, dec2, &count2, &sign2);
+    /* Load operands */
+    ARCH_DEP(load_packbin) (effective_addr1, l1, b1, regs, &v1, &sign1);
+    ARCH_DEP(load_packbin) (effective_addr2, l2, b2, regs, &v2, &sign2);
 
-    /* Add or subtract operand values */
-    if (count2 == 0)
-    {
-        /* If second operand is zero then result is first operand */
-        memcpy (dec3, dec1, MAX_DECIMAL_DIGITS);
-        count3 = count1;
-        sign3 = sign1;
-    }
-    else if (count1 == 0)
-    {
-        /* If first operand is zero then result is -second operand */
-        memcpy (dec3, dec2, MAX_DECIMAL_DIGITS);
-        count3 = count2;
-        sign3 = -sign2;
-    }
-    else if (sign1 != sign2)
-    {
-        /* If signs are opposite then add operands */
-        add_decimal (dec1, dec2, dec3, &count3);
-        sign3 = sign1;
-    }
-    else
-    {
-        /* If signs are equal then subtract operands */
-        subtract_decimal (dec1, dec2, dec3, &count3, &sign3);
-        if (sign1 < 0) sign3 = -sign3;
-    }
+    /* Add the negated second operand to the first */
+    packbin_add (&v1, sign1, &v2, -sign2, &v3, &sign3);
 
-    /* Set condition code */
-    cc = (count3 == 0) ? 0 : (sign3 < 1) ? 1 : 2;
+    /* Set condition code; a zero result has a positive sign */
+    cc = (v3.hi == 0 && v3.lo == 0) ? 0 : (sign3 < 1) ? 1 : 2;
 
     /* Overflow if result exceeds first operand length */
-    if (count3 > (l1+1) * 2 - 1)
+    if (!packbin_fits (&v3, (l1+1) * 2 - 1))
         cc = 3;
 
-    /* Set positive sign if result is zero */
-    if (count3 == 0)
-        sign3 = 1;
-
     /* Store result into first operand location */
-    ARCH_DEP(store_decimal) (effective_addr1, l1, b1, regs, dec3, sign3);
+    ARCH_DEP(store_packbin) (effective_addr1, l1, b1, regs, &v3, sign3);
 
     /* Return condition code */
     regs->psw.cc = cc;
@@ -1344,30 +1200,29 @@ int     b1, b2;                         /* Base register numbers     */
 VADR    effective_addr1,
         effective_addr2;                /* Effective addresses       */
 int     cc;                             /* Condition code            */
-BYTE    dec[MAX_DECIMAL_DIGITS];        /* Work area for operand     */
-int     count;                          /* Significant digit counter */
+PACKBIN v;                              /* Operand magnitude         */
 int     sign;                           /* Sign                      */
 
     SS(inst, regs, l1, l2, b1, effective_addr1, b2, effective_addr2);
     PER_ZEROADDR_XCHECK2( regs, b1, b2 );
     TXFC_INSTR_CHECK( regs );
 
-    /* Load second operand into work area */
-    ARCH_DEP(load_decimal) (effective_addr2, l2, b2, regs, dec, &count, &sign);
+    /* Load second operand */
+    ARCH_DEP(load_packbin) (effective_addr2, l2, b2, regs, &v, &sign);
 
     /* Set condition code */
-    cc = (count == 0) ? 0 : (sign < 1) ? 1 : 2;
+    cc = (v.hi == 0 && v.lo == 0) ? 0 : (sign < 1) ? 1 : 2;
 
     /* Overflow if result exceeds first operand length */
-    if (count > (l1+1) * 2 - 1)
+    if (!packbin_fits (&v, (l1+1) * 2 - 1))
         cc = 3;
 
     /* Set positive sign if result is zero */
-    if (count == 0)
+    if (cc == 0)
         sign = +1;
 
     /* Store result into first operand location */
-    ARCH_DEP(store_decimal) (effective_addr1, l1, b1, regs, dec, sign);
+    ARCH_DEP(store_packbin) (effective_addr1, l1, b1, regs, &v, sign);
 
     /* Return condition code */
     regs->psw.cc = cc;
@@ -836,6 +836,607 @@ int             exp;                    /* Adjusted exponent         */
 
 } /* end function dfp_test_data_group */
 
+/*-------------------------------------------------------------------*/
+/* Integer coefficient fast path                                     */
+/*                                                                   */
+/* Finite operands whose coefficients fit comfortably in a U64 are   */
+/* unpacked into sign, biased exponent and binary coefficient using  */
+/* table-driven DPD conversion.  Add, subtract, multiply, compare    */
+/* and quantize are then done in host integer arithmetic when the    */
+/* result is exact, or (quantize only) when rounding sets nothing    */
+/* but the inexact flag.  In every other case the functions return   */
+/* zero and the instruction falls back to the decNumber library,     */
+/* so that they never produce a result which decNumber would not.    */
+/*-------------------------------------------------------------------*/
+typedef struct _DFPFAST {
+    U64     coef;                       /* Binary coefficient        */
+    int     exp;                        /* Biased exponent           */
+    int     sign;                       /* 1=negative                */
+} DFPFAST;
+
+#define DFP64_FAST_LIMIT    10000000000000000ULL    /* 10**16        */
+#define DFP64_FAST_BIAS     398         /* Long DFP exponent bias    */
+#define DFP64_FAST_MAXEXP   767         /* Maximum biased exponent   */
+#define DFP64_FAST_MINEXP   15          /* No tiny results from here */
+
+#define DFP128_FAST_LIMIT   1000000000000000000ULL  /* 10**18        */
+#define DFP128_FAST_BIAS    6176        /* Ext DFP exponent bias     */
+#define DFP128_FAST_MAXEXP  12287       /* Maximum biased exponent   */
+#define DFP128_FAST_MINEXP  33          /* No tiny results from here */
+
+/* Decimal rounding mode from a rounding mask or the FPC register */
+#define DFP_FAST_DRM(_mask, _regs) \
+        (((_mask) & 0x08) ? ((_mask) & 0x07) : \
+            (int)(((_regs)->fpc & FPC_DRM) >> FPC_DRM_SHIFT))
+
+/* Condition code for a fast path result */
+#define DFP_FAST_CC(_f) ((_f)->coef == 0 ? 0 : (_f)->sign ? 1 : 2)
+
+static const U64
+dfp_fast_pow10[19] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL };
+
+/* DPD declet to binary 0-999 (the 24 non-canonical declets decode  */
+/* as if bits 0-1 were zero), and binary 0-999 to DPD declet         */
+static const U16
+dfp_dpd2bin[1024] = {
+      0,   1,   2,   3,   4,   5,   6,   7,  /* 0x000 */
+      8,   9,  80,  81, 800, 801, 880, 881,  /* 0x008 */
+     10,  11,  12,  13,  14,  15,  16,  17,  /* 0x010 */
+     18,  19,  90,  91, 810, 811, 890, 891,  /* 0x018 */
+     20,  21,  22,  23,  24,  25,  26,  27,  /* 0x020 */
+     28,  29,  82,  83, 820, 821, 808, 809,  /* 0x028 */
+     30,  31,  32,  33,  34,  35,  36,  37,  /* 0x030 */
+     38,  39,  92,  93, 830, 831, 818, 819,  /* 0x038 */
+     40,  41,  42,  43,  44,  45,  46,  47,  /* 0x040 */
+     48,  49,  84,  85, 840, 841,  88,  89,  /* 0x048 */
+     50,  51,  52,  53,  54,  55,  56,  57,  /* 0x050 */
+     58,  59,  94,  95, 850, 851,  98,  99,  /* 0x058 */
+     60,  61,  62,  63,  64,  65,  66,  67,  /* 0x060 */
+     68,  69,  86,  87, 860, 861, 888, 889,  /* 0x068 */
+     70,  71,  72,  73,  74,  75,  76,  77,  /* 0x070 */
+     78,  79,  96,  97, 870, 871, 898, 899,  /* 0x078 */
+    100, 101, 102, 103, 104, 105, 106, 107,  /* 0x080 */
+    108, 109, 180, 181, 900, 901, 980, 981,  /* 0x088 */
+    110, 111, 112, 113, 114, 115, 116, 117,  /* 0x090 */
+    118, 119, 190, 191, 910, 911, 990, 991,  /* 0x098 */
+    120, 121, 122, 123, 124, 125, 126, 127,  /* 0x0A0 */
+    128, 129, 182, 183, 920, 921, 908, 909,  /* 0x0A8 */
+    130, 131, 132, 133, 134, 135, 136, 137,  /* 0x0B0 */
+    138, 139, 192, 193, 930, 931, 918, 919,  /* 0x0B8 */
+    140, 141, 142, 143, 144, 145, 146, 147,  /* 0x0C0 */
+    148, 149, 184, 185, 940, 941, 188, 189,  /* 0x0C8 */
+    150, 151, 152, 153, 154, 155, 156, 157,  /* 0x0D0 */
+    158, 159, 194, 195, 950, 951, 198, 199,  /* 0x0D8 */
+    160, 161, 162, 163, 164, 165, 166, 167,  /* 0x0E0 */
+    168, 169, 186, 187, 960, 961, 988, 989,  /* 0x0E8 */
+    170, 171, 172, 173, 174, 175, 176, 177,  /* 0x0F0 */
+    178, 179, 196, 197, 970, 971, 998, 999,  /* 0x0F8 */
+    200, 201, 202, 203, 204, 205, 206, 207,  /* 0x100 */
+    208, 209, 280, 281, 802, 803, 882, 883,  /* 0x108 */
+    210, 211, 212, 213, 214, 215, 216, 217,  /* 0x110 */
+    218, 219, 290, 291, 812, 813, 892, 893,  /* 0x118 */
+    220, 221, 222, 223, 224, 225, 226, 227,  /* 0x120 */
+    228, 229, 282, 283, 822, 823, 828, 829,  /* 0x128 */
+    230, 231, 232, 233, 234, 235, 236, 237,  /* 0x130 */
+    238, 239, 292, 293, 832, 833, 838, 839,  /* 0x138 */
+    240, 241, 242, 243, 244, 245, 246, 247,  /* 0x140 */
+    248, 249, 284, 285, 842, 843, 288, 289,  /* 0x148 */
+    250, 251, 252, 253, 254, 255, 256, 257,  /* 0x150 */
+    258, 259, 294, 295, 852, 853, 298, 299,  /* 0x158 */
+    260, 261, 262, 263, 264, 265, 266, 267,  /* 0x160 */
+    268, 269, 286, 287, 862, 863, 888, 889,  /* 0x168 */
+    270, 271, 272, 273, 274, 275, 276, 277,  /* 0x170 */
+    278, 279, 296, 297, 872, 873, 898, 899,  /* 0x178 */
+    300, 301, 302, 303, 304, 305, 306, 307,  /* 0x180 */
+    308, 309, 380, 381, 902, 903, 982, 983,  /* 0x188 */
+    310, 311, 312, 313, 314, 315, 316, 317,  /* 0x190 */
+    318, 319, 390, 391, 912, 913, 992, 993,  /* 0x198 */
+    320, 321, 322, 323, 324, 325, 326, 327,  /* 0x1A0 */
+    328, 329, 382, 383, 922, 923, 928, 929,  /* 0x1A8 */
+    330, 331, 332, 333, 334, 335, 336, 337,  /* 0x1B0 */
+    338, 339, 392, 393, 932, 933, 938, 939,  /* 0x1B8 */
+    340, 341, 342, 343, 344, 345, 346, 347,  /* 0x1C0 */
+    348, 349, 384, 385, 942, 943, 388, 389,  /* 0x1C8 */
+    350, 351, 352, 353, 354, 355, 356, 357,  /* 0x1D0 */
+    358, 359, 394, 395, 952, 953, 398, 399,  /* 0x1D8 */
+    360, 361, 362, 363, 364, 365, 366, 367,  /* 0x1E0 */
+    368, 369, 386, 387, 962, 963, 988, 989,  /* 0x1E8 */
+    370, 371, 372, 373, 374, 375, 376, 377,  /* 0x1F0 */
+    378, 379, 396, 397, 972, 973, 998, 999,  /* 0x1F8 */
+    400, 401, 402, 403, 404, 405, 406, 407,  /* 0x200 */
+    408, 409, 480, 481, 804, 805, 884, 885,  /* 0x208 */
+    410, 411, 412, 413, 414, 415, 416, 417,  /* 0x210 */
+    418, 419, 490, 491, 814, 815, 894, 895,  /* 0x218 */
+    420, 421, 422, 423, 424, 425, 426, 427,  /* 0x220 */
+    428, 429, 482, 483, 824, 825, 848, 849,  /* 0x228 */
+    430, 431, 432, 433, 434, 435, 436, 437,  /* 0x230 */
+    438, 439, 492, 493, 834, 835, 858, 859,  /* 0x238 */
+    440, 441, 442, 443, 444, 445, 446, 447,  /* 0x240 */
+    448, 449, 484, 485, 844, 845, 488, 489,  /* 0x248 */
+    450, 451, 452, 453, 454, 455, 456, 457,  /* 0x250 */
+    458, 459, 494, 495, 854, 855, 498, 499,  /* 0x258 */
+    460, 461, 462, 463, 464, 465, 466, 467,  /* 0x260 */
+    468, 469, 486, 487, 864, 865, 888, 889,  /* 0x268 */
+    470, 471, 472, 473, 474, 475, 476, 477,  /* 0x270 */
+    478, 479, 496, 497, 874, 875, 898, 899,  /* 0x278 */
+    500, 501, 502, 503, 504, 505, 506, 507,  /* 0x280 */
+    508, 509, 580, 581, 904, 905, 984, 985,  /* 0x288 */
+    510, 511, 512, 513, 514, 515, 516, 517,  /* 0x290 */
+    518, 519, 590, 591, 914, 915, 994, 995,  /* 0x298 */
+    520, 521, 522, 523, 524, 525, 526, 527,  /* 0x2A0 */
+    528, 529, 582, 583, 924, 925, 948, 949,  /* 0x2A8 */
+    530, 531, 532, 533, 534, 535, 536, 537,  /* 0x2B0 */
+    538, 539, 592, 593, 934, 935, 958, 959,  /* 0x2B8 */
+    540, 541, 542, 543, 544, 545, 546, 547,  /* 0x2C0 */
+    548, 549, 584, 585, 944, 945, 588, 589,  /* 0x2C8 */
+    550, 551, 552, 553, 554, 555, 556, 557,  /* 0x2D0 */
+    558, 559, 594, 595, 954, 955, 598, 599,  /* 0x2D8 */
+    560, 561, 562, 563, 564, 565, 566, 567,  /* 0x2E0 */
+    568, 569, 586, 587, 964, 965, 988, 989,  /* 0x2E8 */
+    570, 571, 572, 573, 574, 575, 576, 577,  /* 0x2F0 */
+    578, 579, 596, 597, 974, 975, 998, 999,  /* 0x2F8 */
+    600, 601, 602, 603, 604, 605, 606, 607,  /* 0x300 */
+    608, 609, 680, 681, 806, 807, 886, 887,  /* 0x308 */
+    610, 611, 612, 613, 614, 615, 616, 617,  /* 0x310 */
+    618, 619, 690, 691, 816, 817, 896, 897,  /* 0x318 */
+    620, 621, 622, 623, 624, 625, 626, 627,  /* 0x320 */
+    628, 629, 682, 683, 826, 827, 868, 869,  /* 0x328 */
+    630, 631, 632, 633, 634, 635, 636, 637,  /* 0x330 */
+    638, 639, 692, 693, 836, 837, 878, 879,  /* 0x338 */
+    640, 641, 642, 643, 644, 645, 646, 647,  /* 0x340 */
+    648, 649, 684, 685, 846, 847, 688, 689,  /* 0x348 */
+    650, 651, 652, 653, 654, 655, 656, 657,  /* 0x350 */
+    658, 659, 694, 695, 856, 857, 698, 699,  /* 0x358 */
+    660, 661, 662, 663, 664, 665, 666, 667,  /* 0x360 */
+    668, 669, 686, 687, 866, 867, 888, 889,  /* 0x368 */
+    670, 671, 672, 673, 674, 675, 676, 677,  /* 0x370 */
+    678, 679, 696, 697, 876, 877, 898, 899,  /* 0x378 */
+    700, 701, 702, 703, 704, 705, 706, 707,  /* 0x380 */
+    708, 709, 780, 781, 906, 907, 986, 987,  /* 0x388 */
+    710, 711, 712, 713, 714, 715, 716, 717,  /* 0x390 */
+    718, 719, 790, 791, 916, 917, 996, 997,  /* 0x398 */
+    720, 721, 722, 723, 724, 725, 726, 727,  /* 0x3A0 */
+    728, 729, 782, 783, 926, 927, 968, 969,  /* 0x3A8 */
+    730, 731, 732, 733, 734, 735, 736, 737,  /* 0x3B0 */
+    738, 739, 792, 793, 936, 937, 978, 979,  /* 0x3B8 */
+    740, 741, 742, 743, 744, 745, 746, 747,  /* 0x3C0 */
+    748, 749, 784, 785, 946, 947, 788, 789,  /* 0x3C8 */
+    750, 751, 752, 753, 754, 755, 756, 757,  /* 0x3D0 */
+    758, 759, 794, 795, 956, 957, 798, 799,  /* 0x3D8 */
+    760, 761, 762, 763, 764, 765, 766, 767,  /* 0x3E0 */
+    768, 769, 786, 787, 966, 967, 988, 989,  /* 0x3E8 */
+    770, 771, 772, 773, 774, 775, 776, 777,  /* 0x3F0 */
+    778, 779, 796, 797, 976, 977, 998, 999   /* 0x3F8 */
+};
+
+static const U16
+dfp_bin2dpd[1000] = {
+    0x000, 0x001, 0x002, 0x003, 0x004, 0x005, 0x006, 0x007,  /*   0 */
+    0x008, 0x009, 0x010, 0x011, 0x012, 0x013, 0x014, 0x015,  /*   8 */
+    0x016, 0x017, 0x018, 0x019, 0x020, 0x021, 0x022, 0x023,  /*  16 */
+    0x024, 0x025, 0x026, 0x027, 0x028, 0x029, 0x030, 0x031,  /*  24 */
+    0x032, 0x033, 0x034, 0x035, 0x036, 0x037, 0x038, 0x039,  /*  32 */
+    0x040, 0x041, 0x042, 0x043, 0x044, 0x045, 0x046, 0x047,  /*  40 */
+    0x048, 0x049, 0x050, 0x051, 0x052, 0x053, 0x054, 0x055,  /*  48 */
+    0x056, 0x057, 0x058, 0x059, 0x060, 0x061, 0x062, 0x063,  /*  56 */
+    0x064, 0x065, 0x066, 0x067, 0x068, 0x069, 0x070, 0x071,  /*  64 */
+    0x072, 0x073, 0x074, 0x075, 0x076, 0x077, 0x078, 0x079,  /*  72 */
+    0x00A, 0x00B, 0x02A, 0x02B, 0x04A, 0x04B, 0x06A, 0x06B,  /*  80 */
+    0x04E, 0x04F, 0x01A, 0x01B, 0x03A, 0x03B, 0x05A, 0x05B,  /*  88 */
+    0x07A, 0x07B, 0x05E, 0x05F, 0x080, 0x081, 0x082, 0x083,  /*  96 */
+    0x084, 0x085, 0x086, 0x087, 0x088, 0x089, 0x090, 0x091,  /* 104 */
+    0x092, 0x093, 0x094, 0x095, 0x096, 0x097, 0x098, 0x099,  /* 112 */
+    0x0A0, 0x0A1, 0x0A2, 0x0A3, 0x0A4, 0x0A5, 0x0A6, 0x0A7,  /* 120 */
+    0x0A8, 0x0A9, 0x0B0, 0x0B1, 0x0B2, 0x0B3, 0x0B4, 0x0B5,  /* 128 */
+    0x0B6, 0x0B7, 0x0B8, 0x0B9, 0x0C0, 0x0C1, 0x0C2, 0x0C3,  /* 136 */
+    0x0C4, 0x0C5, 0x0C6, 0x0C7, 0x0C8, 0x0C9, 0x0D0, 0x0D1,  /* 144 */
+    0x0D2, 0x0D3, 0x0D4, 0x0D5, 0x0D6, 0x0D7, 0x0D8, 0x0D9,  /* 152 */
+    0x0E0, 0x0E1, 0x0E2, 0x0E3, 0x0E4, 0x0E5, 0x0E6, 0x0E7,  /* 160 */
+    0x0E8, 0x0E9, 0x0F0, 0x0F1, 0x0F2, 0x0F3, 0x0F4, 0x0F5,  /* 168 */
+    0x0F6, 0x0F7, 0x0F8, 0x0F9, 0x08A, 0x08B, 0x0AA, 0x0AB,  /* 176 */
+    0x0CA, 0x0CB, 0x0EA, 0x0EB, 0x0CE, 0x0CF, 0x09A, 0x09B,  /* 184 */
+    0x0BA, 0x0BB, 0x0DA, 0x0DB, 0x0FA, 0x0FB, 0x0DE, 0x0DF,  /* 192 */
+    0x100, 0x101, 0x102, 0x103, 0x104, 0x105, 0x106, 0x107,  /* 200 */
+    0x108, 0x109, 0x110, 0x111, 0x112, 0x113, 0x114, 0x115,  /* 208 */
+    0x116, 0x117, 0x118, 0x119, 0x120, 0x121, 0x122, 0x123,  /* 216 */
+    0x124, 0x125, 0x126, 0x127, 0x128, 0x129, 0x130, 0x131,  /* 224 */
+    0x132, 0x133, 0x134, 0x135, 0x136, 0x137, 0x138, 0x139,  /* 232 */
+    0x140, 0x141, 0x142, 0x143, 0x144, 0x145, 0x146, 0x147,  /* 240 */
+    0x148, 0x149, 0x150, 0x151, 0x152, 0x153, 0x154, 0x155,  /* 248 */
+    0x156, 0x157, 0x158, 0x159, 0x160, 0x161, 0x162, 0x163,  /* 256 */
+    0x164, 0x165, 0x166, 0x167, 0x168, 0x169, 0x170, 0x171,  /* 264 */
+    0x172, 0x173, 0x174, 0x175, 0x176, 0x177, 0x178, 0x179,  /* 272 */
+    0x10A, 0x10B, 0x12A, 0x12B, 0x14A, 0x14B, 0x16A, 0x16B,  /* 280 */
+    0x14E, 0x14F, 0x11A, 0x11B, 0x13A, 0x13B, 0x15A, 0x15B,  /* 288 */
+    0x17A, 0x17B, 0x15E, 0x15F, 0x180, 0x181, 0x182, 0x183,  /* 296 */
+    0x184, 0x185, 0x186, 0x187, 0x188, 0x189, 0x190, 0x191,  /* 304 */
+    0x192, 0x193, 0x194, 0x195, 0x196, 0x197, 0x198, 0x199,  /* 312 */
+    0x1A0, 0x1A1, 0x1A2, 0x1A3, 0x1A4, 0x1A5, 0x1A6, 0x1A7,  /* 320 */
+    0x1A8, 0x1A9, 0x1B0, 0x1B1, 0x1B2, 0x1B3, 0x1B4, 0x1B5,  /* 328 */
+    0x1B6, 0x1B7, 0x1B8, 0x1B9, 0x1C0, 0x1C1, 0x1C2, 0x1C3,  /* 336 */
+    0x1C4, 0x1C5, 0x1C6, 0x1C7, 0x1C8, 0x1C9, 0x1D0, 0x1D1,  /* 344 */
+    0x1D2, 0x1D3, 0x1D4, 0x1D5, 0x1D6, 0x1D7, 0x1D8, 0x1D9,  /* 352 */
+    0x1E0, 0x1E1, 0x1E2, 0x1E3, 0x1E4, 0x1E5, 0x1E6, 0x1E7,  /* 360 */
+    0x1E8, 0x1E9, 0x1F0, 0x1F1, 0x1F2, 0x1F3, 0x1F4, 0x1F5,  /* 368 */
+    0x1F6, 0x1F7, 0x1F8, 0x1F9, 0x18A, 0x18B, 0x1AA, 0x1AB,  /* 376 */
+    0x1CA, 0x1CB, 0x1EA, 0x1EB, 0x1CE, 0x1CF, 0x19A, 0x19B,  /* 384 */
+    0x1BA, 0x1BB, 0x1DA, 0x1DB, 0x1FA, 0x1FB, 0x1DE, 0x1DF,  /* 392 */
+    0x200, 0x201, 0x202, 0x203, 0x204, 0x205, 0x206, 0x207,  /* 400 */
+    0x208, 0x209, 0x210, 0x211, 0x212, 0x213, 0x214, 0x215,  /* 408 */
+    0x216, 0x217, 0x218, 0x219, 0x220, 0x221, 0x222, 0x223,  /* 416 */
+    0x224, 0x225, 0x226, 0x227, 0x228, 0x229, 0x230, 0x231,  /* 424 */
+    0x232, 0x233, 0x234, 0x235, 0x236, 0x237, 0x238, 0x239,  /* 432 */
+    0x240, 0x241, 0x242, 0x243, 0x244, 0x245, 0x246, 0x247,  /* 440 */
+    0x248, 0x249, 0x250, 0x251, 0x252, 0x253, 0x254, 0x255,  /* 448 */
+    0x256, 0x257, 0x258, 0x259, 0x260, 0x261, 0x262, 0x263,  /* 456 */
+    0x264, 0x265, 0x266, 0x267, 0x268, 0x269, 0x270, 0x271,  /* 464 */
+    0x272, 0x273, 0x274, 0x275, 0x276, 0x277, 0x278, 0x279,  /* 472 */
+    0x20A, 0x20B, 0x22A, 0x22B, 0x24A, 0x24B, 0x26A, 0x26B,  /* 480 */
+    0x24E, 0x24F, 0x21A, 0x21B, 0x23A, 0x23B, 0x25A, 0x25B,  /* 488 */
+    0x27A, 0x27B, 0x25E, 0x25F, 0x280, 0x281, 0x282, 0x283,  /* 496 */
+    0x284, 0x285, 0x286, 0x287, 0x288, 0x289, 0x290, 0x291,  /* 504 */
+    0x292, 0x293, 0x294, 0x295, 0x296, 0x297, 0x298, 0x299,  /* 512 */
+    0x2A0, 0x2A1, 0x2A2, 0x2A3, 0x2A4, 0x2A5, 0x2A6, 0x2A7,  /* 520 */
+    0x2A8, 0x2A9, 0x2B0, 0x2B1, 0x2B2, 0x2B3, 0x2B4, 0x2B5,  /* 528 */
+    0x2B6, 0x2B7, 0x2B8, 0x2B9, 0x2C0, 0x2C1, 0x2C2, 0x2C3,  /* 536 */
+    0x2C4, 0x2C5, 0x2C6, 0x2C7, 0x2C8, 0x2C9, 0x2D0, 0x2D1,  /* 544 */
+    0x2D2, 0x2D3, 0x2D4, 0x2D5, 0x2D6, 0x2D7, 0x2D8, 0x2D9,  /* 552 */
+    0x2E0, 0x2E1, 0x2E2, 0x2E3, 0x2E4, 0x2E5, 0x2E6, 0x2E7,  /* 560 */
+    0x2E8, 0x2E9, 0x2F0, 0x2F1, 0x2F2, 0x2F3, 0x2F4, 0x2F5,  /* 568 */
+    0x2F6, 0x2F7, 0x2F8, 0x2F9, 0x28A, 0x28B, 0x2AA, 0x2AB,  /* 576 */
+    0x2CA, 0x2CB, 0x2EA, 0x2EB, 0x2CE, 0x2CF, 0x29A, 0x29B,  /* 584 */
+    0x2BA, 0x2BB, 0x2DA, 0x2DB, 0x2FA, 0x2FB, 0x2DE, 0x2DF,  /* 592 */
+    0x300, 0x301, 0x302, 0x303, 0x304, 0x305, 0x306, 0x307,  /* 600 */
+    0x308, 0x309, 0x310, 0x311, 0x312, 0x313, 0x314, 0x315,  /* 608 */
+    0x316, 0x317, 0x318, 0x319, 0x320, 0x321, 0x322, 0x323,  /* 616 */
+    0x324, 0x325, 0x326, 0x327, 0x328, 0x329, 0x330, 0x331,  /* 624 */
+    0x332, 0x333, 0x334, 0x335, 0x336, 0x337, 0x338, 0x339,  /* 632 */
+    0x340, 0x341, 0x342, 0x343, 0x344, 0x345, 0x346, 0x347,  /* 640 */
+    0x348, 0x349, 0x350, 0x351, 0x352, 0x353, 0x354, 0x355,  /* 648 */
+    0x356, 0x357, 0x358, 0x359, 0x360, 0x361, 0x362, 0x363,  /* 656 */
+    0x364, 0x365, 0x366, 0x367, 0x368, 0x369, 0x370, 0x371,  /* 664 */
+    0x372, 0x373, 0x374, 0x375, 0x376, 0x377, 0x378, 0x379,  /* 672 */
+    0x30A, 0x30B, 0x32A, 0x32B, 0x34A, 0x34B, 0x36A, 0x36B,  /* 680 */
+    0x34E, 0x34F, 0x31A, 0x31B, 0x33A, 0x33B, 0x35A, 0x35B,  /* 688 */
+    0x37A, 0x37B, 0x35E, 0x35F, 0x380, 0x381, 0x382, 0x383,  /* 696 */
+    0x384, 0x385, 0x386, 0x387, 0x388, 0x389, 0x390, 0x391,  /* 704 */
+    0x392, 0x393, 0x394, 0x395, 0x396, 0x397, 0x398, 0x399,  /* 712 */
+    0x3A0, 0x3A1, 0x3A2, 0x3A3, 0x3A4, 0x3A5, 0x3A6, 0x3A7,  /* 720 */
+    0x3A8, 0x3A9, 0x3B0, 0x3B1, 0x3B2, 0x3B3, 0x3B4, 0x3B5,  /* 728 */
+    0x3B6, 0x3B7, 0x3B8, 0x3B9, 0x3C0, 0x3C1, 0x3C2, 0x3C3,  /* 736 */
+    0x3C4, 0x3C5, 0x3C6, 0x3C7, 0x3C8, 0x3C9, 0x3D0, 0x3D1,  /* 744 */
+    0x3D2, 0x3D3, 0x3D4, 0x3D5, 0x3D6, 0x3D7, 0x3D8, 0x3D9,  /* 752 */
+    0x3E0, 0x3E1, 0x3E2, 0x3E3, 0x3E4, 0x3E5, 0x3E6, 0x3E7,  /* 760 */
+    0x3E8, 0x3E9, 0x3F0, 0x3F1, 0x3F2, 0x3F3, 0x3F4, 0x3F5,  /* 768 */
+    0x3F6, 0x3F7, 0x3F8, 0x3F9, 0x38A, 0x38B, 0x3AA, 0x3AB,  /* 776 */
+    0x3CA, 0x3CB, 0x3EA, 0x3EB, 0x3CE, 0x3CF, 0x39A, 0x39B,  /* 784 */
+    0x3BA, 0x3BB, 0x3DA, 0x3DB, 0x3FA, 0x3FB, 0x3DE, 0x3DF,  /* 792 */
+    0x00C, 0x00D, 0x10C, 0x10D, 0x20C, 0x20D, 0x30C, 0x30D,  /* 800 */
+    0x02E, 0x02F, 0x01C, 0x01D, 0x11C, 0x11D, 0x21C, 0x21D,  /* 808 */
+    0x31C, 0x31D, 0x03E, 0x03F, 0x02C, 0x02D, 0x12C, 0x12D,  /* 816 */
+    0x22C, 0x22D, 0x32C, 0x32D, 0x12E, 0x12F, 0x03C, 0x03D,  /* 824 */
+    0x13C, 0x13D, 0x23C, 0x23D, 0x33C, 0x33D, 0x13E, 0x13F,  /* 832 */
+    0x04C, 0x04D, 0x14C, 0x14D, 0x24C, 0x24D, 0x34C, 0x34D,  /* 840 */
+    0x22E, 0x22F, 0x05C, 0x05D, 0x15C, 0x15D, 0x25C, 0x25D,  /* 848 */
+    0x35C, 0x35D, 0x23E, 0x23F, 0x06C, 0x06D, 0x16C, 0x16D,  /* 856 */
+    0x26C, 0x26D, 0x36C, 0x36D, 0x32E, 0x32F, 0x07C, 0x07D,  /* 864 */
+    0x17C, 0x17D, 0x27C, 0x27D, 0x37C, 0x37D, 0x33E, 0x33F,  /* 872 */
+    0x00E, 0x00F, 0x10E, 0x10F, 0x20E, 0x20F, 0x30E, 0x30F,  /* 880 */
+    0x06E, 0x06F, 0x01E, 0x01F, 0x11E, 0x11F, 0x21E, 0x21F,  /* 888 */
+    0x31E, 0x31F, 0x07E, 0x07F, 0x08C, 0x08D, 0x18C, 0x18D,  /* 896 */
+    0x28C, 0x28D, 0x38C, 0x38D, 0x0AE, 0x0AF, 0x09C, 0x09D,  /* 904 */
+    0x19C, 0x19D, 0x29C, 0x29D, 0x39C, 0x39D, 0x0BE, 0x0BF,  /* 912 */
+    0x0AC, 0x0AD, 0x1AC, 0x1AD, 0x2AC, 0x2AD, 0x3AC, 0x3AD,  /* 920 */
+    0x1AE, 0x1AF, 0x0BC, 0x0BD, 0x1BC, 0x1BD, 0x2BC, 0x2BD,  /* 928 */
+    0x3BC, 0x3BD, 0x1BE, 0x1BF, 0x0CC, 0x0CD, 0x1CC, 0x1CD,  /* 936 */
+    0x2CC, 0x2CD, 0x3CC, 0x3CD, 0x2AE, 0x2AF, 0x0DC, 0x0DD,  /* 944 */
+    0x1DC, 0x1DD, 0x2DC, 0x2DD, 0x3DC, 0x3DD, 0x2BE, 0x2BF,  /* 952 */
+    0x0EC, 0x0ED, 0x1EC, 0x1ED, 0x2EC, 0x2ED, 0x3EC, 0x3ED,  /* 960 */
+    0x3AE, 0x3AF, 0x0FC, 0x0FD, 0x1FC, 0x1FD, 0x2FC, 0x2FD,  /* 968 */
+    0x3FC, 0x3FD, 0x3BE, 0x3BF, 0x08E, 0x08F, 0x18E, 0x18F,  /* 976 */
+    0x28E, 0x28F, 0x38E, 0x38F, 0x0EE, 0x0EF, 0x09E, 0x09F,  /* 984 */
+    0x19E, 0x19F, 0x29E, 0x29F, 0x39E, 0x39F, 0x0FE, 0x0FF   /* 992 */
+};
+
+/*-------------------------------------------------------------------*/
+/* Unpack a decimal64/decimal128 structure for the fast path         */
+/*                                                                   */
+/* Returns zero if the value is an infinity or NaN, or (extended     */
+/* only) if its coefficient has more than 18 digits.                 */
+/*-------------------------------------------------------------------*/
+static inline int
+dfp64_fast_unpack(decimal64 *xp, DFPFAST *fp)
+{
+U32     hi = ((DW*)xp)->F.H.F;          /* Bits 0-31                 */
+U64     ccf;                            /* Coefficient continuation  */
+unsigned int cf;                        /* Combination field         */
+int     k;                              /* Declet number             */
+U64     coef;                           /* Binary coefficient        */
+
+    cf = (hi >> 26) & 0x1F;
+    if (cf >= 0x1E)
+        return 0;
+
+    fp->sign = hi >> 31;
+    fp->exp = (((cf >> 3) == 3 ? (cf >> 1) & 3 : cf >> 3) << 8)
+            | ((hi >> 18) & 0xFF);
+    coef = dfp_lmdtable[cf];
+
+    ccf = ((U64)(hi & 0x3FFFF) << 32) | ((DW*)xp)->F.L.F;
+    for (k = 40; k >= 0; k -= 10)
+        coef = coef * 1000 + dfp_dpd2bin[(ccf >> k) & 0x3FF];
+    fp->coef = coef;
+
+    return 1;
+
+} /* end function dfp64_fast_unpack */
+
+static inline int
+dfp128_fast_unpack(decimal128 *xp, DFPFAST *fp)
+{
+U32     hh = ((QW*)xp)->F.HH.F;         /* Bits 0-31                 */
+U64     lo;                             /* Bits 64-127               */
+unsigned int cf;                        /* Combination field         */
+int     k;                              /* Declet number             */
+U64     coef;                           /* Binary coefficient        */
+
+    /* Only the six rightmost declets may be nonzero */
+    cf = (hh >> 26) & 0x1F;
+    lo = ((U64)((QW*)xp)->F.LH.F << 32) | ((QW*)xp)->F.LL.F;
+    if (cf >= 0x1E || dfp_lmdtable[cf] != 0
+     || (hh & 0x3FFF) != 0 || ((QW*)xp)->F.HL.F != 0
+     || (lo >> 60) != 0)
+        return 0;
+
+    fp->sign = hh >> 31;
+    fp->exp = ((cf >> 3) << 12) | ((hh >> 14) & 0xFFF);
+
+    for (coef = 0, k = 50; k >= 0; k -= 10)
+        coef = coef * 1000 + dfp_dpd2bin[(lo >> k) & 0x3FF];
+    fp->coef = coef;
+
+    return 1;
+
+} /* end function dfp128_fast_unpack */
+
+/*-------------------------------------------------------------------*/
+/* Pack a fast path result into a decimal64/decimal128 structure     */
+/*-------------------------------------------------------------------*/
+static inline void
+dfp64_fast_pack(decimal64 *xp, DFPFAST *fp)
+{
+unsigned int lmd, cf;                   /* Leftmost digit, CF        */
+U64     rest, ccf;                      /* Trailing digits, CCF      */
+int     k;                              /* Declet number             */
+
+    lmd = (unsigned int)(fp->coef / 1000000000000000ULL);
+    rest = fp->coef % 1000000000000000ULL;
+    cf = lmd < 8 ? ((fp->exp >> 8) << 3) | lmd
+                 : 0x18 | ((fp->exp >> 8) << 1) | (lmd & 1);
+
+    for (ccf = 0, k = 0; k < 50; k += 10, rest /= 1000)
+        ccf |= (U64)dfp_bin2dpd[rest % 1000] << k;
+
+    ((DW*)xp)->F.H.F = ((U32)fp->sign << 31) | (cf << 26)
+                     | ((fp->exp & 0xFF) << 18) | (U32)(ccf >> 32);
+    ((DW*)xp)->F.L.F = (U32)ccf;
+
+} /* end function dfp64_fast_pack */
+
+static inline void
+dfp128_fast_pack(decimal128 *xp, DFPFAST *fp)
+{
+U64     rest, ccf;                      /* Trailing digits, CCF      */
+int     k;                              /* Declet number             */
+
+    for (rest = fp->coef, ccf = 0, k = 0; k < 60; k += 10, rest /= 1000)
+        ccf |= (U64)dfp_bin2dpd[rest % 1000] << k;
+
+    ((QW*)xp)->F.HH.F = ((U32)fp->sign << 31)
+                      | ((U32)(fp->exp >> 12) << 29)
+                      | ((fp->exp & 0xFFF) << 14);
+    ((QW*)xp)->F.HL.F = 0;
+    ((QW*)xp)->F.LH.F = (U32)(ccf >> 32);
+    ((QW*)xp)->F.LL.F = (U32)ccf;
+
+} /* end function dfp128_fast_pack */
+
+/*-------------------------------------------------------------------*/
+/* Fast path add (sub=0) or subtract (sub=1) of b to/from a         */
+/*                                                                   */
+/* The result has the smaller of the two exponents, which is the     */
+/* exponent decNumber gives an exact sum.                            */
+/*-------------------------------------------------------------------*/
+static inline int
+dfp_fast_add(DFPFAST *r, DFPFAST *a, DFPFAST *b, int sub, int drm,
+             U64 limit)
+{
+DFPFAST *h, *l;                         /* Higher and lower exponent */
+U64     hc;                             /* Aligned coefficient of h  */
+int     d;                              /* Exponent difference       */
+
+    if (sub)
+        b->sign ^= 1;
+
+    if (a->exp >= b->exp) h = a, l = b;
+    else                  h = b, l = a;
+
+    d = h->exp - l->exp;
+    hc = h->coef;
+    if (hc != 0)
+    {
+        if (d > 18 || hc >= limit / dfp_fast_pow10[d])
+            return 0;
+        hc *= dfp_fast_pow10[d];
+    }
+
+    r->exp = l->exp;
+    if (h->sign == l->sign)
+    {
+        r->coef = hc + l->coef;
+        r->sign = h->sign;
+        if (r->coef >= limit)
+            return 0;
+    }
+    else if (hc >= l->coef)
+    {
+        r->coef = hc - l->coef;
+        r->sign = h->sign;
+        if (r->coef == 0)
+            r->sign = (drm == DRM_RTMI);
+    }
+    else
+    {
+        r->coef = l->coef - hc;
+        r->sign = l->sign;
+    }
+
+    return 1;
+
+} /* end function dfp_fast_add */
+
+/*-------------------------------------------------------------------*/
+/* Fast path multiply                                                */
+/*-------------------------------------------------------------------*/
+static inline int
+dfp_fast_multiply(DFPFAST *r, DFPFAST *a, DFPFAST *b,
+                  int bias, int maxexp, U64 limit)
+{
+    r->exp = a->exp + b->exp - bias;
+    if (r->exp < 0 || r->exp > maxexp)
+        return 0;
+
+    if (a->coef != 0 && b->coef > (limit - 1) / a->coef)
+        return 0;
+
+    r->coef = a->coef * b->coef;
+    r->sign = a->sign ^ b->sign;
+
+    return 1;
+
+} /* end function dfp_fast_multiply */
+
+/*-------------------------------------------------------------------*/
+/* Fast path compare                                                 */
+/*                                                                   */
+/* Returns the condition code (0 equal, 1 low, 2 high).              */
+/*-------------------------------------------------------------------*/
+static inline int
+dfp_fast_compare(DFPFAST *a, DFPFAST *b, U64 limit)
+{
+U64     ac, bc;                         /* Aligned coefficients      */
+int     d;                              /* Exponent difference       */
+
+    if (a->coef == 0 && b->coef == 0)
+        return 0;
+
+    if (a->sign != b->sign)
+        return a->sign ? 1 : 2;
+
+    ac = a->coef;
+    bc = b->coef;
+    if (a->exp > b->exp && ac != 0)
+    {
+        d = a->exp - b->exp;
+        if (d > 18 || ac > (limit - 1) / dfp_fast_pow10[d])
+            ac = limit;                 /* Larger than any bc        */
+        else
+            ac *= dfp_fast_pow10[d];
+    }
+    else if (b->exp > a->exp && bc != 0)
+    {
+        d = b->exp - a->exp;
+        if (d > 18 || bc > (limit - 1) / dfp_fast_pow10[d])
+            bc = limit;                 /* Larger than any ac        */
+        else
+            bc *= dfp_fast_pow10[d];
+    }
+
+    if (ac == bc)
+        return 0;
+
+    return ((ac < bc) != a->sign) ? 1 : 2;
+
+} /* end function dfp_fast_compare */
+
+/*-------------------------------------------------------------------*/
+/* Fast path quantize                                                */
+/*                                                                   */
+/* Rounds the value a to the exponent of b.  An inexact result is    */
+/* only produced if noinex is zero and the result cannot be tiny;    */
+/* *inexact is then set to one.                                      */
+/*-------------------------------------------------------------------*/
+static inline int
+dfp_fast_quantize(DFPFAST *r, DFPFAST *a, DFPFAST *b, int drm,
+                  int minexp, U64 limit, int noinex, int *inexact)
+{
+U64     q, rem, half;                   /* Quotient, remainder, half */
+int     d, up;                          /* Digits dropped, round up  */
+
+    *inexact = 0;
+    r->sign = a->sign;
+    r->exp = b->exp;
+
+    if (b->exp <= a->exp || a->coef == 0)
+    {
+        /* Exact: the coefficient is scaled up (if at all) */
+        d = a->exp - b->exp;
+        q = a->coef;
+        if (q != 0)
+        {
+            if (d > 18 || q > (limit - 1) / dfp_fast_pow10[d])
+                return 0;
+            q *= dfp_fast_pow10[d];
+        }
+        r->coef = q;
+        return 1;
+    }
+
+    /* Digits are dropped: round them according to the DRM */
+    d = b->exp - a->exp;
+    if (d > 18)
+    {
+        q = 0;
+        rem = a->coef;
+        half = limit;                   /* Remainder below one half  */
+    }
+    else
+    {
+        q = a->coef / dfp_fast_pow10[d];
+        rem = a->coef % dfp_fast_pow10[d];
+        half = dfp_fast_pow10[d] / 2;
+    }
+
+    if (rem == 0)
+    {
+        r->coef = q;
+        return 1;
+    }
+
+    if (noinex || b->exp < minexp)
+        return 0;
+
+    switch (drm) {
+    case DRM_RNE:  up = rem > half || (rem == half && (q & 1)); break;
+    case DRM_RTPI: up = !a->sign; break;
+    case DRM_RTMI: up = a->sign; break;
+    case DRM_RNAZ: up = rem >= half; break;
+    case DRM_RNTZ: up = rem > half; break;
+    case DRM_RAFZ: up = 1; break;
+    default:       up = 0; break;       /* RTZ, and RFSP like it     */
+    } /* end switch(drm) */
+
+    r->coef = q + up;
+    *inexact = 1;
+    return 1;
+
+} /* end function dfp_fast_quantize */
+
 #define _DFP_ARCH_INDEPENDENT_
 #endif /*!defined(_DFP_ARCH_INDEPENDENT_)*/
 
@@ -1982,6 +2583,7 @@ DEF_INST(add_dfp_ext_reg)
 {
 int             r1, r2, r3;             /* Values of R fields        */
 decimal128      x1, x2, x3;             /* Extended DFP values       */
+DFPFAST         f1, f2, f3;             /* Fast path operands        */
 decNumber       d1, d2, d3;             /* Working decimal numbers   */
 decContext      set;                    /* Working context           */
 BYTE            dxc;                    /* Data exception code       */
@@ -1999,6 +2601,18 @@ BYTE            dxc;                    /* Data exception code       */
     /* Add FP register r3 to FP register r2 */
     ARCH_DEP(dfp_reg_to_decimal128)(r2, &x2, regs);
     ARCH_DEP(dfp_reg_to_decimal128)(r3, &x3, regs);
+
+    /* Try the integer coefficient fast path first */
+    if (dfp128_fast_unpack(&x2, &f2) && dfp128_fast_unpack(&x3, &f3)
+     && dfp_fast_add(&f1, &f2, &f3, 0, DFP_FAST_DRM(0, regs),
+                     DFP128_FAST_LIMIT))
+    {
+        dfp128_fast_pack(&x1, &f1);
+        ARCH_DEP(dfp_reg_from_decimal128)(r1, &x1, regs);
+        regs->psw.cc = DFP_FAST_CC(&f1);
+        return;
+    }
+
     decimal128ToNumber(&x2, &d2);
     decimal128ToNumber(&x3, &d3);
     decNumberAdd(&d1, &d2, &d3, &set);
@@ -2032,6 +2646,7 @@ DEF_INST(add_dfp_long_reg)
 {
 int             r1, r2, r3;             /* Values of R fields        */
 decimal64       x1, x2, x3;             /* Long DFP values           */
+DFPFAST         f1, f2, f3;             /* Fast path operands        */
 decNumber       d1, d2, d3;             /* Working decimal numbers   */
 decContext      set;                    /* Working context           */
 BYTE            dxc;                    /* Data exception code       */
@@ -2048,6 +2663,18 @@ BYTE            dxc;                    /* Data exception code       */
     /* Add FP register r3 to FP register r2 */
     ARCH_DEP(dfp_reg_to_decimal64)(r2, &x2, regs);
     ARCH_DEP(dfp_reg_to_decimal64)(r3, &x3, regs);
+
+    /* Try the integer coefficient fast path first */
+    if (dfp64_fast_unpack(&x2, &f2) && dfp64_fast_unpack(&x3, &f3)
+     && dfp_fast_add(&f1, &f2, &f3, 0, DFP_FAST_DRM(0, regs),
+                     DFP64_FAST_LIMIT))
+    {
+        dfp64_fast_pack(&x1, &f1);
+        ARCH_DEP(dfp_reg_from_decimal64)(r1, &x1, regs);
+        regs->psw.cc = DFP_FAST_CC(&f1);
+        return;
+    }
+
     decimal64ToNumber(&x2, &d2);
     decimal64ToNumber(&x3, &d3);
     decNumberAdd(&d1, &d2, &d3, &set);
@@ -2081,6 +2708,7 @@ DEF_INST(compare_dfp_ext_reg)
 {
 int             r1, r2;                 /* Values of R fields        */
 decimal128      x1, x2;                 /* Extended DFP values       */
+DFPFAST         f1, f2;                 /* Fast path operands        */
 decNumber       d1, d2, dr;             /* Working decimal numbers   */
 decContext      set;                    /* Working context           */
 BYTE            dxc;                    /* Data exception code       */
@@ -2097,6 +2725,14 @@ BYTE            dxc;                    /* Data exception code       */
     /* Compare FP register r1 with FP register r2 */
     ARCH_DEP(dfp_reg_to_decimal128)(r1, &x1, regs);
     ARCH_DEP(dfp_reg_to_decimal128)(r2, &x2, regs);
+
+    /* Try the integer coefficient fast path first */
+    if (dfp128_fast_unpack(&x1, &f1) && dfp128_fast_unpack(&x2, &f2))
+    {
+        regs->psw.cc = dfp_fast_compare(&f1, &f2, DFP128_FAST_LIMIT);
+        return;
+    }
+
     decimal128ToNumber(&x1, &d1);
     decimal128ToNumber(&x2, &d2);
     decNumberCompare(&dr, &d1, &d2, &set);
@@ -2126,6 +2762,7 @@ DEF_INST(compare_dfp_long_reg)
 {
 int             r1, r2;                 /* Values of R fields        */
 decimal64       x1, x2;                 /* Long DFP values           */
+DFPFAST         f1, f2;                 /* Fast path operands        */
 decNumber       d1, d2, dr;             /* Working decimal numbers   */
 decContext      set;                    /* Working context           */
 BYTE            dxc;                    /* Data exception code       */
@@ -2141,6 +2778,14 @@ BYTE            dxc;                    /* Data exception code       */
     /* Compare FP register r1 with FP register r2 */
     ARCH_DEP(dfp_reg_to_decimal64)(r1, &x1, regs);
     ARCH_DEP(dfp_reg_to_decimal64)(r2, &x2, regs);
+
+    /* Try the integer coefficient fast path first */
+    if (dfp64_fast_unpack(&x1, &f1) && dfp64_fast_unpack(&x2, &f2))
+    {
+        regs->psw.cc = dfp_fast_compare(&f1, &f2, DFP64_FAST_LIMIT);
+        return;
+    }
+
     decimal64ToNumber(&x1, &d1);
     decimal64ToNumber(&x2, &d2);
     decNumberCompare(&dr, &d1, &d2, &set);
@@ -2170,6 +2815,7 @@ DEF_INST(compare_and_signal_dfp_ext_reg)
 {
 int             r1, r2;                 /* Values of R fields        */
 decimal128      x1, x2;                 /* Extended DFP values       */
+DFPFAST         f1, f2;                 /* Fast path operands        */
 decNumber       d1, d2, dr;             /* Working decimal numbers   */
 decContext      set;                    /* Working context           */
 BYTE            dxc;                    /* Data exception code       */
@@ -2186,6 +2832,14 @@ BYTE            dxc;                    /* Data exception code       */
     /* Compare FP register r1 with FP register r2 */
     ARCH_DEP(dfp_reg_to_decimal128)(r1, &x1, regs);
     ARCH_DEP(dfp_reg_to_decimal128)(r2, &x2, regs);
+
+    /* Try the integer coefficient fast path first */
+    if (dfp128_fast_unpack(&x1, &f1) && dfp128_fast_unpack(&x2, &f2))
+    {
+        regs->psw.cc = dfp_fast_compare(&f1, &f2, DFP128_FAST_LIMIT);
+        return;
+    }
+
     decimal128ToNumber(&x1, &d1);
     decimal128ToNumber(&x2, &d2);
     decNumberCompare(&dr, &d1, &d2, &set);
@@ -2219,6 +2873,7 @@ DEF_INST(compare_and_signal_dfp_long_reg)
 {
 int             r1, r2;                 /* Values of R fields        */
 decimal64       x1, x2;                 /* Long DFP values           */
+DFPFAST         f1, f2;                 /* Fast path operands        */
 decNumber       d1, d2, dr;             /* Working decimal numbers   */
 decContext      set;                    /* Working context           */
 BYTE            dxc;                    /* Data exception code       */
@@ -2234,6 +2889,14 @@ BYTE            dxc;                    /* Data exception code       */
     /* Compare FP register r1 with FP register r2 */
     ARCH_DEP(dfp_reg_to_decimal64)(r1, &x1, regs);
     ARCH_DEP(dfp_reg_to_decimal64)(r2, &x2, regs);
+
+    /* Try the integer coefficient fast path first */
+    if (dfp64_fast_unpack(&x1, &f1) && dfp64_fast_unpack(&x2, &f2))
+    {
+        regs->psw.cc = dfp_fast_compare(&f1, &f2, DFP64_FAST_LIMIT);
+        return;
+    }
+
     decimal64ToNumber(&x1, &d1);
     decimal64ToNumber(&x2, &d2);
     decNumberCompare(&dr, &d1, &d2, &set);
@@ -4841,6 +5504,7 @@ DEF_INST(multiply_dfp_ext_reg)
 {
 int             r1, r2, r3;             /* Values of R fields        */
 decimal128      x1, x2, x3;             /* Extended DFP values       */
+DFPFAST         f1, f2, f3;             /* Fast path operands        */
 decNumber       d1, d2, d3;             /* Working decimal numbers   */
 decContext      set;                    /* Working context           */
 BYTE            dxc;                    /* Data exception code       */
@@ -4858,6 +5522,17 @@ BYTE            dxc;                    /* Data exception code       */
     /* Multiply FP register r2 by FP register r3 */
     ARCH_DEP(dfp_reg_to_decimal128)(r2, &x2, regs);
     ARCH_DEP(dfp_reg_to_decimal128)(r3, &x3, regs);
+
+    /* Try the integer coefficient fast path first */
+    if (dfp128_fast_unpack(&x2, &f2) && dfp128_fast_unpack(&x3, &f3)
+     && dfp_fast_multiply(&f1, &f2, &f3, DFP128_FAST_BIAS, DFP128_FAST_MAXEXP,
+                          DFP128_FAST_LIMIT))
+    {
+        dfp128_fast_pack(&x1, &f1);
+        ARCH_DEP(dfp_reg_from_decimal128)(r1, &x1, regs);
+        return;
+    }
+
     decimal128ToNumber(&x2, &d2);
     decimal128ToNumber(&x3, &d3);
     decNumberMultiply(&d1, &d2, &d3, &set);
@@ -4886,6 +5561,7 @@ DEF_INST(multiply_dfp_long_reg)
 {
 int             r1, r2, r3;             /* Values of R fields        */
 decimal64       x1, x2, x3;             /* Long DFP values           */
+DFPFAST         f1, f2, f3;             /* Fast path operands        */
 decNumber       d1, d2, d3;             /* Working decimal numbers   */
 decContext      set;                    /* Working context           */
 BYTE            dxc;                    /* Data exception code       */
@@ -4902,6 +5578,17 @@ BYTE            dxc;                    /* Data exception code       */
     /* Multiply FP register r2 by FP register r3 */
     ARCH_DEP(dfp_reg_to_decimal64)(r2, &x2, regs);
     ARCH_DEP(dfp_reg_to_decimal64)(r3, &x3, regs);
+
+    /* Try the integer coefficient fast path first */
+    if (dfp64_fast_unpack(&x2, &f2) && dfp64_fast_unpack(&x3, &f3)
+     && dfp_fast_multiply(&f1, &f2, &f3, DFP64_FAST_BIAS, DFP64_FAST_MAXEXP,
+                          DFP64_FAST_LIMIT))
+    {
+        dfp64_fast_pack(&x1, &f1);
+        ARCH_DEP(dfp_reg_from_decimal64)(r1, &x1, regs);
+        return;
+    }
+
     decimal64ToNumber(&x2, &d2);
     decimal64ToNumber(&x3, &d3);
     decNumberMultiply(&d1, &d2, &d3, &set);
@@ -4930,6 +5617,8 @@ DEF_INST(quantize_dfp_ext_reg)
 {
 int             r1, r2, r3, m4;         /* Values of R and M fields  */
 decimal128      x1, x2, x3;             /* Extended DFP values       */
+DFPFAST         f1, f2, f3;             /* Fast path operands        */
+int             inexact;                /* 1=fast path result inexact*/
 decNumber       d1, d2, d3;             /* Working decimal numbers   */
 decContext      set;                    /* Working context           */
 BYTE            dxc;                    /* Data exception code       */
@@ -4947,6 +5636,20 @@ BYTE            dxc;                    /* Data exception code       */
     /* Quantize FP register r3 using FP register r2 */
     ARCH_DEP(dfp_reg_to_decimal128)(r2, &x2, regs);
     ARCH_DEP(dfp_reg_to_decimal128)(r3, &x3, regs);
+
+    /* Try the integer coefficient fast path first */
+    if (dfp128_fast_unpack(&x2, &f2) && dfp128_fast_unpack(&x3, &f3)
+     && dfp_fast_quantize(&f1, &f2, &f3, DFP_FAST_DRM(m4, regs),
+                          DFP128_FAST_MINEXP, DFP128_FAST_LIMIT,
+                          (regs->fpc & FPC_MASK_IMX) != 0, &inexact))
+    {
+        if (inexact)
+            regs->fpc |= FPC_FLAG_SFX;
+        dfp128_fast_pack(&x1, &f1);
+        ARCH_DEP(dfp_reg_from_decimal128)(r1, &x1, regs);
+        return;
+    }
+
     decimal128ToNumber(&x2, &d2);
     decimal128ToNumber(&x3, &d3);
     decNumberQuantize(&d1, &d2, &d3, &set);
@@ -4975,6 +5678,8 @@ DEF_INST(quantize_dfp_long_reg)
 {
 int             r1, r2, r3, m4;         /* Values of R and M fields  */
 decimal64       x1, x2, x3;             /* Long DFP values           */
+DFPFAST         f1, f2, f3;             /* Fast path operands        */
+int             inexact;                /* 1=fast path result inexact*/
 decNumber       d1, d2, d3;             /* Working decimal numbers   */
 decContext      set;                    /* Working context           */
 BYTE            dxc;                    /* Data exception code       */
@@ -4991,6 +5696,20 @@ BYTE            dxc;                    /* Data exception code       */
     /* Quantize FP register r3 using FP register r2 */
     ARCH_DEP(dfp_reg_to_decimal64)(r2, &x2, regs);
     ARCH_DEP(dfp_reg_to_decimal64)(r3, &x3, regs);
+
+    /* Try the integer coefficient fast path first */
+    if (dfp64_fast_unpack(&x2, &f2) && dfp64_fast_unpack(&x3, &f3)
+     && dfp_fast_quantize(&f1, &f2, &f3, DFP_FAST_DRM(m4, regs),
+                          DFP64_FAST_MINEXP, DFP64_FAST_LIMIT,
+                          (regs->fpc & FPC_MASK_IMX) != 0, &inexact))
+    {
+        if (inexact)
+            regs->fpc |= FPC_FLAG_SFX;
+        dfp64_fast_pack(&x1, &f1);
+        ARCH_DEP(dfp_reg_from_decimal64)(r1, &x1, regs);
+        return;
+    }
+
     decimal64ToNumber(&x2, &d2);
     decimal64ToNumber(&x3, &d3);
     decNumberQuantize(&d1, &d2, &d3, &set);
@@ -5382,6 +6101,7 @@ DEF_INST(subtract_dfp_ext_reg)
 {
 int             r1, r2, r3;             /* Values of R fields        */
 decimal128      x1, x2, x3;             /* Extended DFP values       */
+DFPFAST         f1, f2, f3;             /* Fast path operands        */
 decNumber       d1, d2, d3;             /* Working decimal numbers   */
 decContext      set;                    /* Working context           */
 BYTE            dxc;                    /* Data exception code       */
@@ -5399,6 +6119,18 @@ BYTE            dxc;                    /* Data exception code       */
     /* Subtract FP register r3 from FP register r2 */
     ARCH_DEP(dfp_reg_to_decimal128)(r2, &x2, regs);
     ARCH_DEP(dfp_reg_to_decimal128)(r3, &x3, regs);
+
+    /* Try the integer coefficient fast path first */
+    if (dfp128_fast_unpack(&x2, &f2) && dfp128_fast_unpack(&x3, &f3)
+     && dfp_fast_add(&f1, &f2, &f3, 1, DFP_FAST_DRM(0, regs),
+                     DFP128_FAST_LIMIT))
+    {
+        dfp128_fast_pack(&x1, &f1);
+        ARCH_DEP(dfp_reg_from_decimal128)(r1, &x1, regs);
+        regs->psw.cc = DFP_FAST_CC(&f1);
+        return;
+    }
+
     decimal128ToNumber(&x2, &d2);
     decimal128ToNumber(&x3, &d3);
     decNumberSubtract(&d1, &d2, &d3, &set);
@@ -5432,6 +6164,7 @@ DEF_INST(subtract_dfp_long_reg)
 {
 int             r1, r2, r3;             /* Values of R fields        */
 decimal64       x1, x2, x3;             /* Long DFP values           */
+DFPFAST         f1, f2, f3;             /* Fast path operands        */
 decNumber       d1, d2, d3;             /* Working decimal numbers   */
 decContext      set;                    /* Working context           */
 BYTE            dxc;                    /* Data exception code       */
@@ -5448,6 +6181,18 @@ BYTE            dxc;                    /* Data exception code       */
     /* Subtract FP register r3 from FP register r2 */
     ARCH_DEP(dfp_reg_to_decimal64)(r2, &x2, regs);
     ARCH_DEP(dfp_reg_to_decimal64)(r3, &x3, regs);
+
+    /* Try the integer coefficient fast path first */
+    if (dfp64_fast_unpack(&x2, &f2) && dfp64_fast_unpack(&x3, &f3)
+     && dfp_fast_add(&f1, &f2, &f3, 1, DFP_FAST_DRM(0, regs),
+                     DFP64_FAST_LIMIT))
+    {
+        dfp64_fast_pack(&x1, &f1);
+        ARCH_DEP(dfp_reg_from_decimal64)(r1, &x1, regs);
+        regs->psw.cc = DFP_FAST_CC(&f1);
+        return;
+    }
+
     decimal64ToNumber(&x2, &d2);
     decimal64ToNumber(&x3, &d3);
     decNumberSubtract(&d1, &d2, &d3, &set);
@@ -6606,6 +6606,135 @@ int     cc;                             /* Condition code            */
 #endif /* defined( FEATURE_016_EXT_TRANSL_FACILITY_2 ) */
 
 
+#if defined( FEATURE_016_EXT_TRANSL_FACILITY_2 )
+/*-------------------------------------------------------------------*/
+/* Translate loop common to TROO, TROT, TRTO and TRTT                */
+/*                                                                   */
+/* Translates ssz-byte source characters through the table at trtab */
+/* into dsz-byte destination characters. Runs of characters which   */
+/* lie on the current source and destination pages are translated   */
+/* directly in main storage with the most recently used table page  */
+/* kept translated, and only a character straddling a page boundary */
+/* goes through the usual storage accessors. The registers are       */
+/* committed before every access which might cause an exception, so */
+/* the unit of operation is the same as when translating one        */
+/* character at a time.                                              */
+/*-------------------------------------------------------------------*/
+static void ARCH_DEP( translate_etf2 )( int r1, int r2, int ssz, int dsz,
+                                        VADR addr1, VADR addr2, GREG len,
+                                        VADR trtab, U16 tvalue, bool tccc,
+                                        REGS* regs )
+{
+BYTE   *main1, *main2;                  /* Operand mainstor addrs    */
+BYTE   *tab = NULL;                     /* Table page mainstor addr  */
+VADR    tabpage = 0;                    /* Table page address        */
+VADR    taddr;                          /* Table entry address       */
+VADR    start1;                         /* Operand-1 run address     */
+U16     svalue, dvalue;                 /* Source and dest values    */
+int     n, k;                           /* Character counts          */
+
+    while (len)
+    {
+        /* Whole characters left on the current operand pages */
+        n = (int) min( (PAGEFRAME_PAGESIZE - (addr2 & PAGEFRAME_BYTEMASK)) / ssz,
+                       (PAGEFRAME_PAGESIZE - (addr1 & PAGEFRAME_BYTEMASK)) / dsz );
+        n = (int) min( (GREG) n, len / ssz );
+
+        if (!n)
+        {
+            /* Translate a character straddling a page boundary */
+            svalue = ssz == 1 ? ARCH_DEP( vfetchb )( addr2, r2, regs )
+                              : ARCH_DEP( vfetch2 )( addr2, r2, regs );
+            taddr = (trtab + svalue * dsz) & ADDRESS_MAXWRAP( regs );
+            dvalue = dsz == 1 ? ARCH_DEP( vfetchb )( taddr, 1, regs )
+                              : ARCH_DEP( vfetch2 )( taddr, 1, regs );
+
+            /* If the test value was found then exit with cc1 */
+            if (!tccc && dvalue == tvalue)
+            {
+                regs->psw.cc = 1;
+                return;
+            }
+
+            if (dsz == 1)
+                ARCH_DEP( vstoreb )( (BYTE) dvalue, addr1, r1, regs );
+            else
+                ARCH_DEP( vstore2 )( dvalue, addr1, r1, regs );
+
+            addr1 += dsz;
+            addr2 += ssz;
+            len   -= ssz;
+        }
+        else
+        {
+            main2 = MADDRL( addr2, n * ssz, r2, regs, ACCTYPE_READ, regs->psw.pkey );
+            main1 = NULL;
+            start1 = addr1;
+
+            for (k=0; k < n; k++)
+            {
+                svalue = ssz == 1 ? main2[k] : fetch_hw( main2 + 2*k );
+                taddr = (trtab + svalue * dsz) & ADDRESS_MAXWRAP( regs );
+
+                /* Translate a new table page, committing the
+                   characters done so far in case it is inaccessible */
+                if (!tab || (taddr & PAGEFRAME_PAGEMASK) != tabpage)
+                {
+                    SET_GR_A( r1,     regs, addr1 );
+                    SET_GR_A( r1 + 1, regs, len   );
+                    SET_GR_A( r2,     regs, addr2 );
+                    tabpage = taddr & PAGEFRAME_PAGEMASK;
+                    tab = MADDRL( tabpage, 1, 1, regs, ACCTYPE_READ, regs->psw.pkey );
+                }
+                dvalue = dsz == 1 ? tab[ taddr - tabpage ]
+                                  : fetch_hw( tab + (taddr - tabpage) );
+
+                /* If the test value was found then exit with cc1 */
+                if (!tccc && dvalue == tvalue)
+                {
+                    if (k)
+                    {
+                        ITIMER_UPDATE( start1, k * dsz - 1, regs );
+                    }
+                    SET_GR_A( r1,     regs, addr1 );
+                    SET_GR_A( r1 + 1, regs, len   );
+                    SET_GR_A( r2,     regs, addr2 );
+                    regs->psw.cc = 1;
+                    return;
+                }
+
+                if (!main1)
+                    main1 = MADDRL( addr1, n * dsz, r1, regs, ACCTYPE_WRITE, regs->psw.pkey );
+                if (dsz == 1)
+                    main1[k] = (BYTE) dvalue;
+                else
+                    store_hw( main1 + 2*k, dvalue );
+
+                addr1 += dsz;
+                addr2 += ssz;
+                len   -= ssz;
+            }
+            ITIMER_UPDATE( start1, n * dsz - 1, regs );
+        }
+
+        /* Update the registers */
+        addr1 &= ADDRESS_MAXWRAP( regs );
+        addr2 &= ADDRESS_MAXWRAP( regs );
+        SET_GR_A( r1,     regs, addr1 );
+        SET_GR_A( r1 + 1, regs, len   );
+        SET_GR_A( r2,     regs, addr2 );
+
+        /* Set cc0 when all values have been processed */
+        regs->psw.cc = len ? 3 : 0;
+
+        /* exit on the cpu determined number of bytes */
+        if (len && (!(addr1 & 0xfff) || !(addr2 & 0xfff)))
+            break;
+    }
+}
+#endif /* defined( FEATURE_016_EXT_TRANSL_FACILITY_2 ) */
+
+
 #if defined( FEATURE_016_EXT_TRANSL_FACILITY_2 )
 /*-------------------------------------------------------------------*/
 /* B993 TROO  - Translate One to One                         [RRF-c] */
@@ -6616,10 +6745,8 @@ int     r1, r2;                         /* Values of R fields        */
 int     m3;                             /* Mask                      */
 VADR    addr1, addr2, trtab;            /* Effective addresses       */
 GREG    len;
-BYTE    svalue, dvalue, tvalue;
-#ifdef FEATURE_024_ETF2_ENHANCEMENT_FACILITY
-bool    tccc;                   /* Test-Character-Comparison Control */
-#endif
+BYTE    tvalue;
+bool    tccc = false;           /* Test-Character-Comparison Control */
 
     RRF_M(inst, regs, r1, r2, m3);
     PER_ZEROADDR_CHECK( regs, r1 );
@@ -6651,50 +6778,8 @@ bool    tccc;                   /* Test-Character-Comparison Control */
     if(!len)
         regs->psw.cc = 0;
 
-    while(len)
-    {
-        svalue = ARCH_DEP(vfetchb) (addr2, r2, regs);
-
-        /* Fetch value from translation table */
-        dvalue = ARCH_DEP(vfetchb) (((trtab + svalue)
-                                   & ADDRESS_MAXWRAP(regs) ), 1, regs);
-
-#ifdef FEATURE_024_ETF2_ENHANCEMENT_FACILITY
-        /* Test-Character-Comparison Control */
-        if(!tccc)
-        {
-#endif
-          /* If the testvalue was found then exit with cc1 */
-          if(dvalue == tvalue)
-          {
-            regs->psw.cc = 1;
-            break;
-          }
-#ifdef FEATURE_024_ETF2_ENHANCEMENT_FACILITY
-        }
-#endif
-
-        /* Store destination value */
-        ARCH_DEP(vstoreb) (dvalue, addr1, r1, regs);
-
-        /* Adjust source addr, destination addr and length */
-        addr1++; addr1 &= ADDRESS_MAXWRAP(regs);
-        addr2++; addr2 &= ADDRESS_MAXWRAP(regs);
-        len--;
-
-        /* Update the registers */
-        SET_GR_A(r1, regs, addr1);
-        SET_GR_A(r1 + 1, regs, len);
-        SET_GR_A(r2, regs, addr2);
-
-        /* Set cc0 when all values have been processed */
-        regs->psw.cc = len ? 3 : 0;
-
-        /* exit on the cpu determined number of bytes */
-        if((len != 0) && (!(addr1 & 0xfff) || !(addr2 & 0xfff)))
-            break;
-
-    } /* end while */
+    ARCH_DEP( translate_etf2 )( r1, r2, 1, 1, addr1, addr2, len,
+                                trtab, tvalue, tccc, regs );
 
 } /* end DEF_INST(translate_one_to_one) */
 #endif /* defined( FEATURE_016_EXT_TRANSL_FACILITY_2 ) */
@@ -6710,11 +6795,8 @@ int     r1, r2;                         /* Values of R fields        */
 int     m3;                             /* Mask                      */
 VADR    addr1, addr2, trtab;            /* Effective addresses       */
 GREG    len;
-BYTE    svalue;
-U16     dvalue, tvalue;
-#ifdef FEATURE_024_ETF2_ENHANCEMENT_FACILITY
-bool    tccc;                   /* Test-Character-Comparison Control */
-#endif
+U16     tvalue;
+bool    tccc = false;           /* Test-Character-Comparison Control */
 
     RRF_M(inst, regs, r1, r2, m3);
     PER_ZEROADDR_CHECK( regs, r1 );
@@ -6746,50 +6828,8 @@ bool    tccc;                   /* Test-Character-Comparison Control */
     if(!len)
         regs->psw.cc = 0;
 
-    while(len)
-    {
-        svalue = ARCH_DEP(vfetchb) (addr2, r2, regs);
-
-        /* Fetch value from translation table */
-        dvalue = ARCH_DEP(vfetch2) (((trtab + (svalue << 1))
-                                   & ADDRESS_MAXWRAP(regs) ), 1, regs);
-
-#ifdef FEATURE_024_ETF2_ENHANCEMENT_FACILITY
-        /* Test-Character-Comparison Control */
-        if(!tccc)
-        {
-#endif
-          /* If the testvalue was found then exit with cc1 */
-          if(dvalue == tvalue)
-          {
-            regs->psw.cc = 1;
-            break;
-          }
-#ifdef FEATURE_024_ETF2_ENHANCEMENT_FACILITY
-        }
-#endif
-
-        /* Store destination value */
-        ARCH_DEP(vstore2) (dvalue, addr1, r1, regs);
-
-        /* Adjust source addr, destination addr and length */
-        addr1 += 2; addr1 &= ADDRESS_MAXWRAP(regs);
-        addr2++; addr2 &= ADDRESS_MAXWRAP(regs);
-        len--;
-
-        /* Update the registers */
-        SET_GR_A(r1, regs, addr1);
-        SET_GR_A(r1 + 1, regs, len);
-        SET_GR_A(r2, regs, addr2);
-
-        /* Set cc0 when all values have been processed */
-        regs->psw.cc = len ? 3 : 0;
-
-        /* exit on the cpu determined number of bytes */
-        if((len != 0) && (!(addr1 & 0xfff) || !(addr2 & 0xfff)))
-            break;
-
-    } /* end while */
+    ARCH_DEP( translate_etf2 )( r1, r2, 1, 2, addr1, addr2, len,
+                                trtab, tvalue, tccc, regs );
 
 } /* end DEF_INST(translate_one_to_two) */
 #endif /* defined( FEATURE_016_EXT_TRANSL_FACILITY_2 ) */
@@ -6805,11 +6845,8 @@ int     r1, r2;                         /* Values of R fields        */
 int     m3;                             /* Mask                      */
 VADR    addr1, addr2, trtab;            /* Effective addresses       */
 GREG    len;
-U16     svalue;
-BYTE    dvalue, tvalue;
-#ifdef FEATURE_024_ETF2_ENHANCEMENT_FACILITY
-bool    tccc;                   /* Test-Character-Comparison Control */
-#endif
+BYTE    tvalue;
+bool    tccc = false;           /* Test-Character-Comparison Control */
 
     RRF_M(inst, regs, r1, r2, m3);
     PER_ZEROADDR_CHECK( regs, r1 );
@@ -6847,50 +6884,8 @@ bool    tccc;                   /* Test-Character-Comparison Control */
     if(!len)
         regs->psw.cc = 0;
 
-    while(len)
-    {
-        svalue = ARCH_DEP(vfetch2) (addr2, r2, regs);
-
-        /* Fetch value from translation table */
-        dvalue = ARCH_DEP(vfetchb) (((trtab + svalue)
-                                   & ADDRESS_MAXWRAP(regs) ), 1, regs);
-
-#ifdef FEATURE_024_ETF2_ENHANCEMENT_FACILITY
-        /* Test-Character-Comparison Control */
-        if(!tccc)
-        {
-#endif
-          /* If the testvalue was found then exit with cc1 */
-          if(dvalue == tvalue)
-          {
-            regs->psw.cc = 1;
-            break;
-          }
-#ifdef FEATURE_024_ETF2_ENHANCEMENT_FACILITY
-        }
-#endif
-
-        /* Store destination value */
-        ARCH_DEP(vstoreb) (dvalue, addr1, r1, regs);
-
-        /* Adjust source addr, destination addr and length */
-        addr1++; addr1 &= ADDRESS_MAXWRAP(regs);
-        addr2 += 2; addr2 &= ADDRESS_MAXWRAP(regs);
-        len -= 2;
-
-        /* Update the registers */
-        SET_GR_A(r1, regs, addr1);
-        SET_GR_A(r1 + 1, regs, len);
-        SET_GR_A(r2, regs, addr2);
-
-        /* Set cc0 when all values have been processed */
-        regs->psw.cc = len ? 3 : 0;
-
-        /* exit on the cpu determined number of bytes */
-        if((len != 0) && (!(addr1 & 0xfff) || !(addr2 & 0xfff)))
-            break;
-
-    } /* end while */
+    ARCH_DEP( translate_etf2 )( r1, r2, 2, 1, addr1, addr2, len,
+                                trtab, tvalue, tccc, regs );
 
 } /* end DEF_INST(translate_two_to_one) */
 #endif /* defined( FEATURE_016_EXT_TRANSL_FACILITY_2 ) */
@@ -6906,10 +6901,8 @@ int     r1, r2;                         /* Values of R fields        */
 int     m3;                             /* Mask                      */
 VADR    addr1, addr2, trtab;            /* Effective addresses       */
 GREG    len;
-U16     svalue, dvalue, tvalue;
-#ifdef FEATURE_024_ETF2_ENHANCEMENT_FACILITY
-bool    tccc;                   /* Test-Character-Comparison Control */
-#endif
+U16     tvalue;
+bool    tccc = false;           /* Test-Character-Comparison Control */
 
     RRF_M(inst, regs, r1, r2, m3);
     PER_ZEROADDR_CHECK( regs, r1 );
@@ -6947,50 +6940,8 @@ bool    tccc;                   /* Test-Character-Comparison Control */
     if(!len)
         regs->psw.cc = 0;
 
-    while(len)
-    {
-        svalue = ARCH_DEP(vfetch2) (addr2, r2, regs);
-
-        /* Fetch value from translation table */
-        dvalue = ARCH_DEP(vfetch2) (((trtab + (svalue << 1))
-                                   & ADDRESS_MAXWRAP(regs) ), 1, regs);
-
-#ifdef FEATURE_024_ETF2_ENHANCEMENT_FACILITY
-        /* Test-Character-Comparison Control */
-        if(!tccc)
-        {
-#endif
-          /* If the testvalue was found then exit with cc1 */
-          if(dvalue == tvalue)
-          {
-            regs->psw.cc = 1;
-            break;
-          }
-#ifdef FEATURE_024_ETF2_ENHANCEMENT_FACILITY
-        }
-#endif
-
-        /* Store destination value */
-        ARCH_DEP(vstore2) (dvalue, addr1, r1, regs);
-
-        /* Adjust source addr, destination addr and length */
-        addr1 += 2; addr1 &= ADDRESS_MAXWRAP(regs);
-        addr2 += 2; addr2 &= ADDRESS_MAXWRAP(regs);
-        len -= 2;
-
-        /* Update the registers */
-        SET_GR_A(r1, regs, addr1);
-        SET_GR_A(r1 + 1, regs, len);
-        SET_GR_A(r2, regs, addr2);
-
-        /* Set cc0 when all values have been processed */
-        regs->psw.cc = len ? 3 : 0;
-
-        /* exit on the cpu determined number of bytes */
-        if((len != 0) && (!(addr1 & 0xfff) || !(addr2 & 0xfff)))
-            break;
-
-    } /* end while */
+    ARCH_DEP( translate_etf2 )( r1, r2, 2, 2, addr1, addr2, len,
+                                trtab, tvalue, tccc, regs );
 
 } /* end DEF_INST(translate_two_to_two) */
 #endif /* defined( FEATURE_016_EXT_TRANSL_FACILITY_2 ) */
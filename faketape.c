@@ -37,6 +37,7 @@
 /*-------------------------------------------------------------------*/
 void close_faketape (DEVBLK *dev)
 {
+    tapestrm_close( dev );
     if( dev->fd >= 0 )
     {
         WRMSG (HHC00201, "I", LCSS_DEVNUM, dev->filename, "fake");
@@ -46,6 +47,7 @@ void close_faketape (DEVBLK *dev)
     dev->fd=-1;
     dev->blockid = 0;
     dev->fenced = 0;
+    tapeidx_free( dev );
     return;
 }
 
@@ -56,6 +58,8 @@ void close_faketape (DEVBLK *dev)
 int rewind_faketape (DEVBLK *dev,BYTE *unitstat,BYTE code)
 {
     off_t rcoff;
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0)
+        return -1;
     rcoff=lseek(dev->fd,0,SEEK_SET);
     if(rcoff<0)
     {
@@ -184,6 +188,7 @@ int open_faketape( DEVBLK* dev, BYTE* unitstat, BYTE code )
     /* Open success. Save file descriptor and rewind to load-point */
 
     dev->fd = rc;
+    tapestrm_open( dev );
     rc = rewind_faketape( dev, unitstat, code );
     return rc;
 
@@ -223,7 +228,10 @@ int             xorblkl;                /* XOR check of block lens   */
     }
 
     /* Read the 12-ASCII-hex-character block header */
-    rc = read (dev->fd, &fakehdr, sizeof(FAKETAPE_BLKHDR));
+    if (dev->tapestrm)
+        rc = tapestrm_pread (dev, &fakehdr, sizeof(FAKETAPE_BLKHDR), blkpos);
+    else
+        rc = read (dev->fd, &fakehdr, sizeof(FAKETAPE_BLKHDR));
 
     /* Handle read error condition */
     if (rc < 0)
@@ -292,6 +300,10 @@ int             rc;                     /* Return code               */
 off_t           blkpos;                 /* Offset of block header    */
 U16             curblkl;                /* Current block length      */
 
+    /* Present any deferred write error first */
+    if (tapestrm_flush( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Initialize current block position */
     blkpos = dev->nxtblkpos;
 
@@ -305,7 +317,10 @@ U16             curblkl;                /* Current block length      */
     /* If not a tapemark, read the data block */
     if (curblkl > 0)
     {
-        rc = read (dev->fd, buf, curblkl);
+        if (dev->tapestrm)
+            rc = tapestrm_pread (dev, buf, curblkl, blkpos - curblkl);
+        else
+            rc = read (dev->fd, buf, curblkl);
 
         /* Handle read error condition */
         if (rc < 0)
@@ -334,6 +349,7 @@ U16             curblkl;                /* Current block length      */
 
     /* Increment the block number */
     dev->blockid++;
+    tapeidx_note( dev, curblkl == 0, false );
 
     /* Increment file number and return zero if tapemark was read */
     if (curblkl == 0)
@@ -386,7 +402,10 @@ char            sblklen[5];             /* work buffer               */
     memcpy( fakehdr.sxorblkl, sblklen, sizeof(fakehdr.sxorblkl) );
 
     /* Write the block header */
-    rc = write (dev->fd, &fakehdr, sizeof(FAKETAPE_BLKHDR));
+    if (dev->tapestrm)
+        rc = tapestrm_pwrite (dev, &fakehdr, sizeof(FAKETAPE_BLKHDR), blkpos);
+    else
+        rc = write (dev->fd, &fakehdr, sizeof(FAKETAPE_BLKHDR));
     if (rc < (int)sizeof(FAKETAPE_BLKHDR))
     {
         WRMSG (HHC00204, "E", LCSS_DEVNUM, dev->filename, "fake", "write()", blkpos, strerror(errno));
@@ -466,7 +485,10 @@ U16             prvblkl;                /* Length of previous block  */
     dev->prvblkpos = blkpos;
 
     /* Write the data block */
-    rc = write (dev->fd, buf, blklen);
+    if (dev->tapestrm)
+        rc = tapestrm_pwrite (dev, buf, blklen, blkpos + sizeof(FAKETAPE_BLKHDR));
+    else
+        rc = write (dev->fd, buf, blklen);
     if (rc < (int)blklen)
     {
         WRMSG (HHC00204, "E", LCSS_DEVNUM, dev->filename, "fake", "write()", blkpos, strerror(errno));
@@ -484,10 +506,16 @@ U16             prvblkl;                /* Length of previous block  */
 
     /* Increment the block number */
     dev->blockid++;
+    tapeidx_note( dev, false, true );
 
     /* Set new physical EOF */
-    do rc = ftruncate( dev->fd, dev->nxtblkpos );
-    while (EINTR == rc);
+    if (dev->tapestrm)
+        rc = tapestrm_ftruncate( dev, dev->nxtblkpos );
+    else
+    {
+        do rc = ftruncate( dev->fd, dev->nxtblkpos );
+        while (EINTR == rc);
+    }
 
     if (rc != 0)
     {
@@ -563,10 +591,16 @@ U16             prvblkl;                /* Length of previous block  */
     /* Calculate the offsets of the next and previous blocks */
     dev->nxtblkpos = blkpos + sizeof(FAKETAPE_BLKHDR);
     dev->prvblkpos = blkpos;
+    tapeidx_note( dev, true, true );
 
     /* Set new physical EOF */
-    do rc = ftruncate( dev->fd, dev->nxtblkpos );
-    while (EINTR == rc);
+    if (dev->tapestrm)
+        rc = tapestrm_ftruncate( dev, dev->nxtblkpos );
+    else
+    {
+        do rc = ftruncate( dev->fd, dev->nxtblkpos );
+        while (EINTR == rc);
+    }
 
     if (rc != 0)
     {
@@ -578,8 +612,8 @@ U16             prvblkl;                /* Length of previous block  */
         return -1;
     }
 
-    /* Return normal status */
-    return 0;
+    /* Tapemarks are written out immediately */
+    return tapestrm_flush( dev, unitstat, code );
 
 } /* end function write_fakemark */
 
@@ -598,6 +632,10 @@ int sync_faketape (DEVBLK *dev, BYTE *unitstat,BYTE code)
         return -1;
     }
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_flush( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Perform sync. Return error on failure. */
     if (fdatasync( dev->fd ) < 0)
     {
@@ -627,6 +665,10 @@ int             rc;                     /* Return code               */
 off_t           blkpos;                 /* Offset of block header    */
 U16             blklen;                 /* Block length              */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Initialize current block position */
     blkpos = dev->nxtblkpos;
 
@@ -647,6 +689,7 @@ U16             blklen;                 /* Block length              */
 
     /* Increment the block number */
     dev->blockid++;
+    tapeidx_note( dev, blklen == 0, false );
 
     /* Return block length or zero if tapemark */
     return blklen;
@@ -668,6 +711,10 @@ U16             curblkl;                /* Length of current block   */
 U16             prvblkl;                /* Length of previous block  */
 off_t           blkpos;                 /* Offset of block header    */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Unit check if already at start of tape */
     if (dev->nxtblkpos == 0)
     {
@@ -712,6 +759,15 @@ int fsf_faketape (DEVBLK *dev, BYTE *unitstat,BYTE code)
 {
 int             rc;                     /* Return code               */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0)
+        return -1;
+
+    /* Find the next tapemark in the block index if possible,
+       otherwise continue from the highest indexed block */
+    if (tapeidx_fsf( dev ) > 0)
+        return 0;
+
     while (1)
     {
         /* Forward space over next block */
@@ -743,6 +799,20 @@ int bsf_faketape (DEVBLK *dev, BYTE *unitstat,BYTE code)
 {
 int             rc;                     /* Return code               */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0)
+        return -1;
+
+    /* Find the previous tapemark in the block index if possible */
+    switch (tapeidx_bsf( dev ))
+    {
+    case 1:
+        return 0;
+    case 0:
+        build_senseX(TAPE_BSENSE_LOADPTERR,dev,unitstat,code);
+        return -1;
+    }
+
     while (1)
     {
         /* Exit if now at start of tape */
@@ -115,6 +115,11 @@ CCKD_DEVHDR     cdevhdr;                /* Compressed device header  */
             return rc;
     }
 
+    /* Write-back and mapping are off unless requested */
+    dev->wback = 0;
+    dev->wbsync = DASD_WB_DEF_SYNC;
+    dev->dasdmapreq = dev->dasdmapped = 0;
+
     /* Open the device file */
     dev->fd = HOPEN (dev->filename, O_RDWR|O_BINARY);
     if (dev->fd < 0)
@@ -180,6 +185,10 @@ CCKD_DEVHDR     cdevhdr;                /* Compressed device header  */
         /* process the remaining arguments */
         for (i = 1; i < argc; i++)
         {
+            /* (accepted, but the cckd writers are used instead) */
+            if (dasd_wb_parm( dev, DEVBUF_TYPE_FBA, argv[i] ) > 0
+             || dasd_map_parm( dev, argv[i] ) > 0)
+                continue;
             if (strlen (argv[i]) > 3
              && memcmp ("sf=", argv[i], 3) == 0)
             {
@@ -254,6 +263,22 @@ CCKD_DEVHDR     cdevhdr;                /* Compressed device header  */
             dev->fbanumblk = (int)(statbuf.st_size / dev->fbablksiz);
         }
 
+        /* Write-back and mmap options follow the origin and block count */
+        while (argc >= 2
+            && ((rc = dasd_wb_parm( dev, DEVBUF_TYPE_FBA, argv[argc-1] )) != 0
+             || (rc = dasd_map_parm( dev, argv[argc-1] )) != 0))
+        {
+            if (rc < 0)
+            {
+                // "%1d:%04X %s file: parameter %s in argument %d is invalid"
+                WRMSG( HHC00503, "E", LCSS_DEVNUM, FBATYP( cfba, 0 ), argv[argc-1], argc );
+                close (dev->fd);
+                dev->fd = -1;
+                return -1;
+            }
+            argc--;
+        }
+
         /* The second argument is the device origin block number */
         if (argc >= 2)
         {
@@ -320,6 +345,18 @@ CCKD_DEVHDR     cdevhdr;                /* Compressed device header  */
     /* Activate I/O tracing */
 //  dev->ccwtrace = 1;
 
+    /* Write-back only for uncompressed images that can be updated */
+    if (cfba)
+        dev->wback = 0;
+
+    /* Map uncompressed images instead of caching them if requested */
+    if (!cfba && dev->dasdmapreq)
+    {
+        dasd_map_open (dev, DEVBUF_TYPE_FBA);
+        if (dev->dasdmapped)
+            dev->wback = 0;
+    }
+
     /* Call the compressed init handler if compressed fba */
     if (cfba)
         return cckd_dasd_init_handler (dev, argc, argv);
@@ -508,11 +545,29 @@ int             rc;                     /* Return code               */
 int             i, o;                   /* Cache indexes             */
 int             len;                    /* Length to read            */
 off_t           offset;                 /* File offsets              */
+BYTE           *buf;                    /* -> Mapped block group     */
 
     /* Return if reading the same block group */
     if (blkgrp >= 0 && blkgrp == dev->bufcur)
         return 0;
 
+    /* The previous block group was updated in the mapping */
+    if (dev->bufupd && dev->dasdmapped && dev->cache < 0)
+    {
+        dev->bufupd = 0;
+        dasd_map_update (dev, dev->buf + dev->bufupdlo,
+                         dev->bufupdhi - dev->bufupdlo);
+        dev->bufupdlo = dev->bufupdhi = 0;
+    }
+
+    /* Leave the previous block group to the write-back threads */
+    if (dev->bufupd && dev->wback)
+    {
+        dev->bufupd = 0;
+        dev->bufupdlo = dev->bufupdhi = 0;
+        dasd_wb_queue (dev, dev->cache);
+    }
+
     /* Write the previous block group if modified */
     if (dev->bufupd)
     {
@@ -573,6 +628,25 @@ off_t           offset;                 /* File offsets              */
         return 0;
     }
 
+    /* Point into the mapped image file if there is one */
+    if (dev->dasdmapped)
+    {
+        len = fba_blkgrp_len (dev, blkgrp);
+        buf = dasd_map_image (dev, 0, (U64)blkgrp * CFBA_BLKGRP_SIZE,
+                              len, blkgrp);
+        if (buf)
+        {
+            cache_unlock (CACHE_DEVBUF);
+            dev->buf = buf;
+            dev->bufcur = blkgrp;
+            dev->bufoff = 0;
+            dev->bufoffhi = len;
+            dev->buflen = len;
+            dev->bufsize = len;
+            return 0;
+        }
+    }
+
 fba_read_blkgrp_retry:
 
     /* Search the cache */
@@ -581,6 +655,15 @@ fba_read_blkgrp_retry:
     /* Cache hit */
     if (i >= 0)
     {
+        /* Wait if the block group is being written back */
+        if (cache_getflag(CACHE_DEVBUF, i) & CKD_CACHE_WRITING)
+        {
+            cache_unlock(CACHE_DEVBUF);
+            dasd_wb_wait(i);
+            cache_lock(CACHE_DEVBUF);
+            goto fba_read_blkgrp_retry;
+        }
+
         cache_setflag(CACHE_DEVBUF, i, ~0, FBA_CACHE_ACTIVE);
         cache_setage(CACHE_DEVBUF, i);
         cache_unlock(CACHE_DEVBUF);
@@ -694,6 +777,14 @@ int fba_dasd_update_blkgrp (DEVBLK *dev, int blkgrp, int off,
 {
 int             rc;                     /* Return code               */
 
+    /* Equipment check if a block group could not be written back */
+    if (dasd_wb_error (dev))
+    {
+        dev->sense[0] = SENSE_EC;
+        *unitstat = CSW_CE | CSW_DE | CSW_UC;
+        return -1;
+    }
+
     /* Read the block group */
     if (blkgrp != dev->bufcur)
     {
@@ -762,6 +853,17 @@ BYTE            unitstat;
     /* Forces updated buffer to be written */
     (dev->hnd->read) (dev, -1, &unitstat);
 
+    /* Wait for the block groups still being written back */
+    if (dev->wback)
+    {
+        dasd_wb_flush (dev);
+        dev->wback = 0;
+    }
+
+    /* Sync and unmap the mapped image file */
+    if (dev->dasdmapped)
+        dasd_map_close (dev);
+
     /* Free the cache */
     cache_lock(CACHE_DEVBUF);
     cache_scan(CACHE_DEVBUF, fbadasd_purge_cache, dev);
@@ -62,6 +62,15 @@
 #define VECTOR_PARTIAL_SUM_NUMBER     1 /* Vector partial sum number */
 
 #define CKD_MAXFILES                 27 /* Max files per CKD volume  */
+#define DASD_WB_DEF_SYNC              5 /* Write-back fdatasync secs */
+#define DASD_WB_DEF_WRITER            2 /* Write-back writer threads */
+#define DASD_WB_MAX_WRITER            8 /* Max write-back writers    */
+#define DASD_WB_MAX_IOV              64 /* Max images per pwritev    */
+#define DASD_WB_RETRY                 5 /* Failed write-back retry
+                                           interval (secs)           */
+#define DASD_MAP_SEQ                  2 /* Images read in order before
+                                           mapped read-ahead starts  */
+#define DASD_MAP_AHEAD               16 /* Mapped images read ahead  */
 
 #define PANEL_REFRESH_RATE_MIN    (1000 / CLK_TCK)  /* (likely 1ms!) */
 #define PANEL_REFRESH_RATE_MAX     5000 /* Arbitrary, but reasonable */
@@ -3744,7 +3744,15 @@ BYTE    termchar;                       /* Terminating character     */
             main1 = MADDRL(addr1, usable, r1, regs, ACCTYPE_READ, regs->psw.pkey );
             main2 = MADDRL(addr2, usable, r2, regs, ACCTYPE_READ, regs->psw.pkey );
 
-            for (i=0; i < usable; i++)
+            /* Skip the bytes which are equal and not the terminating
+               character; the loop below decides on the first other */
+            i = (int) hsimd_clst( main1, main2, usable, termchar );
+            main1 += i;
+            main2 += i;
+            addr1 = (addr1 + i) & ADDRESS_MAXWRAP( regs );
+            addr2 = (addr2 + i) & ADDRESS_MAXWRAP( regs );
+
+            for (; i < usable; i++)
             {
                 /* If both bytes are the terminating character, then
                    the strings are equal, so return CC=0 and leave
@@ -3834,7 +3842,15 @@ BYTE    termchar;                       /* Terminating character     */
     main1 = MADDRL(addr1, cpu_length, r1, regs, ACCTYPE_READ, regs->psw.pkey );
     main2 = MADDRL(addr2, cpu_length, r2, regs, ACCTYPE_READ, regs->psw.pkey );
 
-    for (i=0; i < cpu_length; i++)
+    /* Skip the bytes which are equal and not the terminating
+       character; the loop below decides on the first other one */
+    i = (int) hsimd_clst( main1, main2, cpu_length, termchar );
+    main1 += i;
+    main2 += i;
+    addr1 = (addr1 + i) & ADDRESS_MAXWRAP( regs );
+    addr2 = (addr2 + i) & ADDRESS_MAXWRAP( regs );
+
+    for (; i < cpu_length; i++)
     {
         /* If both bytes are the terminating character, then
            the strings are equal, so return CC=0 and leave
@@ -3938,40 +3954,27 @@ int ARCH_DEP( mem_cmp_first_equ )
 )
 {
     BYTE   *m1,   *m2;          // operand mainstor addresses
-    BYTE   *m1pg, *m2pg;        // operand page
+    VADR   a1,    a2;           // operand addresses
     U32    i;                   // loop index
+    U32    n;                   // on-page length
+    U32    k;                   // kernel result
 
-    /* fast exit */
-    if (len == 0) return MEM_CMP_NPOS;
+    /* Compare the operands one page span at a time, the span
+       ending at whichever operand's page boundary comes first */
+    for (i = 0; i < len; i += n)
+    {
+        a1 = (ea1 + i) & ADDRESS_MAXWRAP( regs );
+        a2 = (ea2 + i) & ADDRESS_MAXWRAP( regs );
 
-    // Translate left most byte of each operand
-    m1 = MADDRL(ea1 & ADDRESS_MAXWRAP( regs ), PAGEBYTES( ea1 ), b1, regs, ACCTYPE_READ, regs->psw.pkey );
-    m2 = MADDRL(ea2 & ADDRESS_MAXWRAP( regs ), PAGEBYTES( ea2 ), b2, regs, ACCTYPE_READ, regs->psw.pkey );
+        n = min( PAGEBYTES( a1 ), PAGEBYTES( a2 ));
+        n = min( n, len - i );
 
-    m1pg = MAINSTOR_PAGEBASE ( m1 );
-    m2pg = MAINSTOR_PAGEBASE ( m2 );
+        m1 = MADDRL( a1, n, b1, regs, ACCTYPE_READ, regs->psw.pkey );
+        m2 = MADDRL( a2, n, b2, regs, ACCTYPE_READ, regs->psw.pkey );
 
-    for (i = 0; i < len ; i++)
-    {
         /* compare bytes */
-        if (*m1 == *m2)
-            return i;
-
-        /* update mainstore addresses */
-        m1++;
-        m2++;
-
-        /* check for page cross */
-        if (MAINSTOR_PAGEBASE ( m1 ) != m1pg)
-        {
-            m1 = MADDRL((ea1 + (i+1)) & ADDRESS_MAXWRAP( regs ), PAGEFRAME_PAGESIZE, b1, regs, ACCTYPE_READ, regs->psw.pkey );
-            m1pg = MAINSTOR_PAGEBASE ( m1 );
-        }
-        if (MAINSTOR_PAGEBASE ( m2 ) != m2pg)
-        {
-            m2 = MADDRL((ea2 + (i+1)) & ADDRESS_MAXWRAP( regs ), PAGEFRAME_PAGESIZE, b2, regs, ACCTYPE_READ, regs->psw.pkey );
-            m2pg = MAINSTOR_PAGEBASE ( m2 );
-        }
+        if ((k = (U32) hsimd_first_equ( m1, m2, n )) < n)
+            return i + k;
     }
 
     /* no equ byte in memory */
@@ -4153,40 +4156,27 @@ int ARCH_DEP( mem_cmp_last_neq )
 )
 {
     BYTE   *m1,   *m2;          // operand mainstor addresses
-    BYTE   *m1pg, *m2pg;        // operand page
-    int    i;                   // loop index
+    VADR   a1,    a2;           // operand addresses
+    int    i;                   // bytes left to compare
+    int    n;                   // on-page length
+    int    k;                   // kernel result
 
-    /* fast exit */
-    if (len <= 0) return MEM_CMP_NPOS;
+    /* Compare the operands right to left one page span at a time,
+       the span ending at whichever page boundary comes first */
+    for (i = len; i > 0; i -= n)
+    {
+        a1 = (ea1 + (i-1)) & ADDRESS_MAXWRAP( regs );
+        a2 = (ea2 + (i-1)) & ADDRESS_MAXWRAP( regs );
 
-    // Translate righttmost byte of each operand
-    m1 = MADDRL((ea1 + (len-1)) & ADDRESS_MAXWRAP( regs ), 1, b1, regs, ACCTYPE_READ, regs->psw.pkey );
-    m2 = MADDRL((ea2 + (len-1)) & ADDRESS_MAXWRAP( regs ), 1, b2, regs, ACCTYPE_READ, regs->psw.pkey );
+        n = (int) min( a1 & PAGEFRAME_BYTEMASK, a2 & PAGEFRAME_BYTEMASK ) + 1;
+        n = min( n, i );
 
-    m1pg = MAINSTOR_PAGEBASE ( m1 );
-    m2pg = MAINSTOR_PAGEBASE ( m2 );
+        m1 = MADDRL( (a1 - (n-1)) & ADDRESS_MAXWRAP( regs ), n, b1, regs, ACCTYPE_READ, regs->psw.pkey );
+        m2 = MADDRL( (a2 - (n-1)) & ADDRESS_MAXWRAP( regs ), n, b2, regs, ACCTYPE_READ, regs->psw.pkey );
 
-    for (i = (len-1); i >= 0 ; i--)
-    {
         /* compare bytes */
-        if (*m1 != *m2)
-            return i;
-
-        /* update mainstore addresses */
-        m1--;
-        m2--;
-
-        /* check for page cross */
-        if (MAINSTOR_PAGEBASE ( m1 ) != m1pg)
-        {
-            m1 = MADDRL((ea1 + (i-1)) & ADDRESS_MAXWRAP( regs ), 1, b1, regs, ACCTYPE_READ, regs->psw.pkey );
-            m1pg = MAINSTOR_PAGEBASE ( m1 );
-        }
-        if (MAINSTOR_PAGEBASE ( m2 ) != m2pg)
-        {
-            m2 = MADDRL((ea2 + (i-1)) & ADDRESS_MAXWRAP( regs ), 1, b2, regs, ACCTYPE_READ, regs->psw.pkey );
-            m2pg = MAINSTOR_PAGEBASE ( m2 );
-        }
+        if ((k = (int) hsimd_last_neq( m1, m2, n )) < n)
+            return i - 1 - k;
     }
 
     /* no neq bytes; memory is equal */
@@ -4784,6 +4774,7 @@ DEF_INST(convert_utf16_to_utf8)
 int     r1, r2;                         /* Register numbers          */
 int     m3;                             /* Mask                      */
 int     i;                              /* Loop counter              */
+int     k;                              /* Characters converted      */
 int     cc = 0;                         /* Condition code            */
 VADR    addr1, addr2;                   /* Operand addresses         */
 GREG    len1, len2;                     /* Operand lengths           */
@@ -4834,6 +4825,17 @@ bool    wfc;                            /* Well-Formedness-Checking  */
         /* Exit if fewer than 2 bytes remain in source operand */
         if (len2 < 2) break;
 
+        /* Convert a run of single-byte characters in main storage */
+        if ((k = ARCH_DEP( unicode_span )( r1, &addr1, &len1, 1,
+                                           r2, &addr2, &len2, 2,
+                                           4096 - i, regs )) > 0)
+        {
+            i += k - 1;
+            if (len1 == 0 && len2 != 0)
+                cc = 1;
+            continue;
+        }
+
         /* Fetch two bytes from source operand */
         unicode1 = ARCH_DEP(vfetch2) ( addr2, r2, regs );
         naddr2 = addr2 + 2;
@@ -4938,6 +4940,7 @@ DEF_INST(convert_utf8_to_utf16)
 int     r1, r2;                         /* Register numbers          */
 int     m3;                             /* Mask                      */
 int     i;                              /* Loop counter              */
+int     k;                              /* Characters converted      */
 int     cc = 0;                         /* Condition code            */
 VADR    addr1, addr2;                   /* Operand addresses         */
 GREG    len1, len2;                     /* Operand lengths           */
@@ -4984,6 +4987,17 @@ bool    wfc;                            /* WellFormednessChecking    */
             break;
         }
 
+        /* Convert a run of single-byte characters in main storage */
+        if ((k = ARCH_DEP( unicode_span )( r1, &addr1, &len1, 2,
+                                           r2, &addr2, &len2, 1,
+                                           4096 - i, regs )) > 0)
+        {
+            i += k - 1;
+            if (len1 == 0 && len2 != 0)
+                cc = 1;
+            continue;
+        }
+
         /* Fetch first UTF-8 byte from source operand */
         utf[0] = ARCH_DEP(vfetchb) ( addr2, r2, regs );
 
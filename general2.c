@@ -546,6 +546,7 @@ int     i;                              /* Loop counter              */
 int     dist;                           /* length working distance   */
 int     cpu_length;                     /* CPU determined length     */
 VADR    addr1, addr2;                   /* End/start addresses       */
+BYTE    *main1;                         /* Terminating char address  */
 BYTE    *main2;                         /* Operand-2 mainstor addr   */
 BYTE    termchar;                       /* Terminating character     */
 
@@ -661,39 +662,33 @@ BYTE    termchar;                       /* Terminating character     */
         return;
     }
 
+    /* Limit the search to the operand end address should it lie
+       within the remainder of the page, then search the whole span
+       at once (memchr is vectorized by the host C library) */
+    dist = cpu_length;
+    if (addr1 > addr2 && addr1 - addr2 < (VADR) cpu_length)
+        dist = (int)(addr1 - addr2);
+
     main2 = MADDRL(addr2, cpu_length, r2, regs, ACCTYPE_READ, regs->psw.pkey );
-    for (i=0; i < cpu_length; i++)
+    if ((main1 = memchr( main2, termchar, dist )))
     {
-        /* If operand end address has been reached, return
-           CC=2 and leave the R1 and R2 registers unchanged
-        */
-        /* NOTE: "When the address in general register R1 is less
-           than the address in general register R2, condition code
-           2 can be set only if the operand wraps around from the
-           top of storage to location 0."  The below comparison
-           for == is thus correct.
-        */
-        if (addr2 == addr1)
-        {
-            regs->psw.cc = 2;
-            return;
-        }
-
         /* If the terminating character was found, return
            CC=1 and load the address of the character in R1 */
-        if (*main2 == termchar)
-        {
-            SET_GR_A( r1, regs, addr2 );
-            regs->psw.cc = 1;
-            return;
-        }
+        SET_GR_A( r1, regs, addr2 + (main1 - main2) );
+        regs->psw.cc = 1;
+        return;
+    }
 
-        /* Bump operand-2 */
-        main2++;
-        addr2++;
-        addr2 &= ADDRESS_MAXWRAP( regs );
+    /* If operand end address has been reached, return
+       CC=2 and leave the R1 and R2 registers unchanged */
+    if (dist < cpu_length)
+    {
+        regs->psw.cc = 2;
+        return;
+    }
 
-    } /* end for(i) */
+    addr2 += cpu_length;
+    addr2 &= ADDRESS_MAXWRAP( regs );
 
     /* The CPU determine number of bytes has been reached.
        Set R2 to point to next character of operand-2 and
@@ -1943,9 +1938,8 @@ bool    op1crosses, op2crosses;         /* Operand crosses Page Bdy  */
        }
        else /* BEST case: NEITHER operand crosses a page boundary */
        {
-            for (i=0; i <= len; i++)
-                if ((sbyte = op2[ op1[i] ]))
-                    break;
+            if ((i = (int) hsimd_trt( op1, len+1, op2 )) <= len)
+                sbyte = op2[ op1[i] ];
        }
     }
 
@@ -2002,6 +1996,7 @@ CACHE_ALIGN BYTE  trtab[256];       /* Translate table               */
 GREG    len;                        /* on page translate length      */
 int     translen = 0;               /* translated length             */
 BYTE   *main1;                      /* Mainstor addresses            */
+BYTE   *tbytep;                     /* Test byte address             */
 
     RRE(inst, regs, r1, r2);
     PER_ZEROADDR_LCHECK( regs, r1, r1+1 );
@@ -2058,22 +2053,18 @@ BYTE   *main1;                      /* Mainstor addresses            */
     /* Get operand 1 on page address */
     main1 = MADDRL( addr1, len, r1, regs, ACCTYPE_WRITE, regs->psw.pkey );
 
-    /* translate on page data */
-    for (i = 0; i < len; i++)
+    /* Locate the test byte first; only the bytes to its left
+       are translated. If found, exit with condition code 1 */
+    if ((tbytep = memchr( main1, tbyte, len )))
     {
-        /* If equal to test byte, exit with condition code 1 */
-        if (*main1 == tbyte)
-        {
-            cc = 1;
-            break;
-        }
-
-        /* Load indicated byte from translate table */
-        *main1 = trtab[ *main1 ];
+        len = tbytep - main1;
+        cc = 1;
+    }
 
-        main1++;
-        translen++;
-    } /* end for(i) */
+    /* translate on page data */
+    for (i = 0; i < len; i++)
+        main1[i] = trtab[ main1[i] ];
+    translen = (int) len;
 
     /* Update the registers */
     addr1 += translen;
@@ -2327,6 +2318,65 @@ U16     rmask = 0x0000;
 #endif
 }
 
+/*-------------------------------------------------------------------*/
+/* Convert a run of single-unit characters for the CUxx instructions */
+/*                                                                   */
+/* Converts up to max leading characters of the second operand which */
+/* occupy a single unit in both formats (see hsimd_utf) directly in  */
+/* main storage, limited to what fits in both operands and on their  */
+/* current pages. Updates the operand addresses and lengths and the  */
+/* R1, R1+1, R2 and R2+1 registers exactly as the per-character loop */
+/* would and returns the number of characters converted, which is   */
+/* zero when the first character needs the general path.            */
+/*-------------------------------------------------------------------*/
+int ARCH_DEP( unicode_span )( int r1, VADR* addr1, GREG* len1, int dsz,
+                              int r2, VADR* addr2, GREG* len2, int ssz,
+                              int max, REGS* regs )
+{
+    BYTE*   main1;                      /* Operand-1 mainstor addr   */
+    BYTE*   main2;                      /* Operand-2 mainstor addr   */
+    int     n, k;                       /* Character counts          */
+
+    /* Whole characters available in both operands on this page */
+    n = max;
+    n = (int) min( (GREG) n, *len2 / ssz );
+    n = (int) min( (GREG) n, *len1 / dsz );
+    n = min( n, (int)((PAGEFRAME_PAGESIZE - (*addr2 & PAGEFRAME_BYTEMASK)) / ssz) );
+    n = min( n, (int)((PAGEFRAME_PAGESIZE - (*addr1 & PAGEFRAME_BYTEMASK)) / dsz) );
+    if (n <= 0)
+        return 0;
+
+    /* Leave anything but a run of single-unit characters to the
+       caller, so that its exceptions and condition codes are
+       recognized in the same order as before */
+    main2 = MADDRL( *addr2, n * ssz, r2, regs, ACCTYPE_READ, regs->psw.pkey );
+    if (ssz == 1 || dsz == 1)
+    {
+        if (main2[ ssz - 1 ] >= 0x80 || (ssz == 2 && main2[0])
+         || (ssz == 4 && (main2[0] | main2[1] | main2[2])))
+            return 0;
+    }
+    else if ((main2[ ssz - 2 ] & 0xFC) == 0xD8 || (ssz == 4 && (main2[0] | main2[1])))
+        return 0;
+
+    main1 = MADDRL( *addr1, n * dsz, r1, regs, ACCTYPE_WRITE, regs->psw.pkey );
+    k = (int) hsimd_utf( main1, dsz, main2, ssz, n );
+    ITIMER_UPDATE( *addr1, k * dsz - 1, regs );
+
+    /* Commit the operand addresses and lengths */
+    *addr1 = (*addr1 + k * dsz) & ADDRESS_MAXWRAP( regs );
+    *len1 -= k * dsz;
+    *addr2 = (*addr2 + k * ssz) & ADDRESS_MAXWRAP( regs );
+    *len2 -= k * ssz;
+
+    SET_GR_A( r1,     regs, *addr1 );
+    SET_GR_A( r1 + 1, regs, *len1  );
+    SET_GR_A( r2,     regs, *addr2 );
+    SET_GR_A( r2 + 1, regs, *len2  );
+
+    return k;
+}
+
 #if defined( FEATURE_022_EXT_TRANSL_FACILITY_3 )
 /*-------------------------------------------------------------------*/
 /* B9B0 CU14  - Convert UTF-8 to UTF-32                      [RRF-c] */
@@ -2346,6 +2396,7 @@ DEF_INST(convert_utf8_to_utf32)
 #if defined( FEATURE_030_ETF3_ENHANCEMENT_FACILITY )
     bool wfc;                      /* Well-Formedness-Checking (W)   */
 #endif
+    int k;                         /* Characters converted           */
     int xlated;                    /* characters translated          */
 
     RRF_M(inst, regs, r1, r2, m3);
@@ -2383,6 +2434,15 @@ DEF_INST(convert_utf8_to_utf32)
         return;
         }
 
+        /* Convert a run of single-unit characters in main storage */
+        if ((k = ARCH_DEP( unicode_span )( r1, &dest, &destlen, 4,
+                                           r2, &srce, &srcelen, 1,
+                                           4096 - xlated, regs )) > 0)
+        {
+            xlated += k;
+            continue;
+        }
+
         /* Fetch a byte */
         utf8[0] = ARCH_DEP(vfetchb)(srce, r2, regs);
         if(utf8[0] < 0x80)
@@ -2615,6 +2675,7 @@ DEF_INST(convert_utf16_to_utf32)
 #if defined( FEATURE_030_ETF3_ENHANCEMENT_FACILITY )
     bool wfc;                      /* Well-Formedness-Checking (W)   */
 #endif
+    int k;                         /* Characters converted           */
     int xlated;                    /* characters translated          */
 
     RRF_M(inst, regs, r1, r2, m3);
@@ -2652,6 +2713,15 @@ DEF_INST(convert_utf16_to_utf32)
             return;
         }
 
+        /* Convert a run of single-unit characters in main storage */
+        if ((k = ARCH_DEP( unicode_span )( r1, &dest, &destlen, 4,
+                                           r2, &srce, &srcelen, 2,
+                                           (4096 - xlated + 1) / 2, regs )) > 0)
+        {
+            xlated += k * 2;
+            continue;
+        }
+
         /* Fetch 2 bytes */
         ARCH_DEP(vfetchc)(utf16, 1, srce, r2, regs);
         if(utf16[0] <= 0xd7 || utf16[0] >= 0xdc)
@@ -2724,6 +2794,7 @@ DEF_INST(convert_utf32_to_utf8)
     BYTE utf32[4];                 /* utf32 character(s)             */
     BYTE utf8[4];                  /* utf8 character(s)              */
     int write;                     /* Bytes written                  */
+    int k;                         /* Characters converted           */
     int xlated;                    /* characters translated          */
 
     RRE(inst, regs, r1, r2);
@@ -2753,6 +2824,15 @@ DEF_INST(convert_utf32_to_utf8)
             return;
         }
 
+        /* Convert a run of single-unit characters in main storage */
+        if ((k = ARCH_DEP( unicode_span )( r1, &dest, &destlen, 1,
+                                           r2, &srce, &srcelen, 4,
+                                           (4096 - xlated + 3) / 4, regs )) > 0)
+        {
+            xlated += k * 4;
+            continue;
+        }
+
         /* Get 4 bytes */
         ARCH_DEP(vfetchc)(utf32, 3, srce, r2, regs);
 
@@ -2861,6 +2941,7 @@ DEF_INST(convert_utf32_to_utf16)
     BYTE utf16[4];                 /* utf16 character(s)             */
     BYTE utf32[4];                 /* utf32 character(s)             */
     int write;                     /* Bytes written                  */
+    int k;                         /* Characters converted           */
     int xlated;                    /* characters translated          */
     BYTE zabcd;                    /* Work value                     */
 
@@ -2890,6 +2971,15 @@ DEF_INST(convert_utf32_to_utf16)
             return;
         }
 
+        /* Convert a run of single-unit characters in main storage */
+        if ((k = ARCH_DEP( unicode_span )( r1, &dest, &destlen, 2,
+                                           r2, &srce, &srcelen, 4,
+                                           (4096 - xlated + 3) / 4, regs )) > 0)
+        {
+            xlated += k * 4;
+            continue;
+        }
+
         /* Get 4 bytes */
         ARCH_DEP(vfetchc)(utf32, 3, srce, r2, regs);
 
@@ -2952,8 +3042,9 @@ DEF_INST( search_string_unicode )
 {
     VADR addr1, addr2;                  /* End/start addresses       */
     int i;                              /* Loop counter              */
+    int n, dist, k;                     /* On-page character counts  */
     int r1, r2;                         /* Values of R fields        */
-    U16 sbyte;                          /* String character          */
+    BYTE *main2;                        /* Operand-2 mainstor addr   */
     U16 termchar;                       /* Terminating character     */
 
     RRE( inst, regs, r1, r2 );
@@ -2987,7 +3078,7 @@ DEF_INST( search_string_unicode )
 #define SRSTU_MAX   _4K     /* (Sheesh! 256 bytes is WAY too small!) */
 
     /* Search up to CPU-determined bytes or until end of operand */
-    for (i=0; i < SRSTU_MAX; i++)
+    for (i=0; i < SRSTU_MAX; i += n)
     {
         /* If operand end address has been reached, return condition
            code 2 and leave the R1 and R2 registers unchanged
@@ -3003,22 +3094,47 @@ DEF_INST( search_string_unicode )
             return;
         }
 
-        /* Fetch 2 bytes from the operand */
-        sbyte = ARCH_DEP( vfetch2 )( addr2, r2, regs );
+        /* Number of whole characters left on this page. A character
+           straddling the page boundary is fetched on its own. */
+        n = (int)((PAGEFRAME_PAGESIZE - (addr2 & PAGEFRAME_BYTEMASK)) / 2);
+        if (!n)
+        {
+            n = 1;
+            if (ARCH_DEP( vfetch2 )( addr2, r2, regs ) == termchar)
+            {
+                SET_GR_A( r1, regs, addr2 );
+                regs->psw.cc = 1;
+                return;
+            }
+            addr2 += 2;
+            addr2 &= ADDRESS_MAXWRAP( regs );
+            continue;
+        }
+        n = min( n, SRSTU_MAX - i );
 
-        /* If the terminating character was found, return condition
-           code 1 and load the address of the character into R1 */
-        if (sbyte == termchar)
+        /* Stop short of the operand end address if it lies within */
+        dist = n;
+        if (addr1 > addr2 && addr1 - addr2 < (VADR)( 2 * n ))
+            dist = (int)((addr1 - addr2) / 2);
+
+        /* Search the on-page characters for the terminating one */
+        main2 = MADDRL( addr2, 2 * dist, r2, regs, ACCTYPE_READ, regs->psw.pkey );
+        if ((k = (int) hsimd_find_hw( main2, dist, termchar )) < dist)
         {
-            SET_GR_A( r1, regs, addr2 );
+            SET_GR_A( r1, regs, addr2 + 2 * k );
             regs->psw.cc = 1;
             return;
         }
 
         /* Increment operand address */
-        addr2 += 2;
+        addr2 += 2 * dist;
         addr2 &= ADDRESS_MAXWRAP( regs );
 
+        /* If the operand end was reached, the test at the top of
+           the loop sets condition code 2 */
+        if (dist < n)
+            n = dist;
+
     } /* end for(i) */
 
     /* Set R2 to point to next character of operand */
@@ -3029,9 +3145,6 @@ DEF_INST( search_string_unicode )
 }
 
 
-#undef  MAINSTOR_PAGEBASE
-#define MAINSTOR_PAGEBASE( _ma )  ((BYTE*) ((uintptr_t) ( _ma ) & PAGEFRAME_PAGEMASK))
-
 /*-------------------------------------------------------------------*/
 /* D0   TRTR  - Translate and Test Reverse                    [SS-a] */
 /*-------------------------------------------------------------------*/
@@ -3048,7 +3161,7 @@ DEF_INST(translate_and_test_reverse)
     CACHE_ALIGN BYTE  trtab[256];      // Translate table - copy
     BYTE*   p_fct;                     // ptr to FC Table
     BYTE*   m1;                        // operand mainstor addresses
-    BYTE   *m1pg;                      // operand page
+    int     n, k;                      // on-page length, bytes passed
 
     SS_L(inst, regs, len, b1, effective_addr1, b2, effective_addr2);
     PER_ZEROADDR_XCHECK2( regs, b1, b2 );
@@ -3066,24 +3179,26 @@ DEF_INST(translate_and_test_reverse)
         p_fct = MADDRL( effective_addr2, 256, b2, regs, ACCTYPE_READ, regs->psw.pkey );
     }
 
-    /* Get mainstor address to test byte */
-    m1 = MADDRL( effective_addr1, 1, b1, regs, ACCTYPE_READ, regs->psw.pkey );
-    m1pg = MAINSTOR_PAGEBASE ( m1 );
-
-    /* Process first operand from right to left*/
-    for(i = 0; i <= len; i++)
+    /* Process first operand from right to left, one page at a time */
+    for (i = 0; i <= len; i += n)
     {
-        /* Fetch argument byte from first operand */
-        // dbyte = ARCH_DEP(vfetchb)(effective_addr1, b1, regs);
-
-        /* Fetch function byte from second operand */
-        // sbyte = ARCH_DEP(vfetchb)((effective_addr2 + dbyte) & ADDRESS_MAXWRAP(regs), b2, regs);
+        /* Bytes of the operand on this page, right to left */
+        n = min( len + 1 - i, (int)(effective_addr1 & PAGEFRAME_BYTEMASK) + 1 );
 
-        sbyte = p_fct[ *m1 ];
+        /* Get mainstor address of the leftmost of them */
+        m1 = MADDRL( (effective_addr1 - (n - 1)) & ADDRESS_MAXWRAP( regs ),
+                     n, b1, regs, ACCTYPE_READ, regs->psw.pkey );
 
         /* Test for non-zero function byte */
-        if(sbyte != 0)
+        if ((k = (int) hsimd_trtr( m1, n, p_fct )) < n)
         {
+            effective_addr1 -= k;
+            effective_addr1 &= ADDRESS_MAXWRAP( regs );
+            i += k;
+
+            /* Fetch function byte from second operand */
+            sbyte = p_fct[ m1[ n - 1 - k ] ];
+
             /* Store address of argument byte in register 1 */
 #if defined( FEATURE_001_ZARCH_INSTALLED_FACILITY )
             if(regs->psw.amode64)
@@ -3113,19 +3228,9 @@ DEF_INST(translate_and_test_reverse)
         } /* end if(sbyte) */
 
         /* Decrement first operand address */
-        effective_addr1--; /* Another difference with TRT */
+        effective_addr1 -= n; /* Another difference with TRT */
         effective_addr1 &= ADDRESS_MAXWRAP(regs);
 
-        /* update mainstor address */
-        m1--;
-
-        /* check for page cross */
-        if ( MAINSTOR_PAGEBASE ( m1 ) != m1pg )
-        {
-            m1 = MADDRL(effective_addr1, 1, b1, regs, ACCTYPE_READ, regs->psw.pkey );
-            m1pg = MAINSTOR_PAGEBASE ( m1 );
-        }
-
     } /* end for(i) */
 
     /* Update the condition code */
@@ -3173,6 +3278,7 @@ DEF_INST( translate_and_test_xxx_extended )
     VADR  buf_addr;             /* First argument address            */
     GREG  buf_len;              /* First argument length             */
     BYTE* buf_main_addr;        /* Buffer real address */
+    BYTE* fct;                  /* One page FC table mainstor address*/
 
     VADR  fc_page_no;           /* Function-Code - page number       */
     VADR  fc_addr;              /* Function-Code - address           */
@@ -3272,6 +3378,34 @@ DEF_INST( translate_and_test_xxx_extended )
 
     fc = 0;
     processed = 0;
+
+    /* With one byte arguments and function codes, and the table all
+       within one page, scan the on-page part of the buffer at once */
+    if (!a_bit && !f_bit && (fct_addr & PAGEFRAME_BYTEMASK) <= PAGEFRAME_PAGESIZE - 256)
+    {
+        fct = fct_main_page_addr[0] + (fct_addr & PAGEFRAME_BYTEMASK);
+
+        if ((GREG) max_process > buf_len)
+            max_process = (int) buf_len;
+
+        if (isReverse)
+        {
+            processed = (int) hsimd_trtr( buf_main_addr - (max_process - 1), max_process, fct );
+            if (processed < max_process)
+                fc = fct[ *(buf_main_addr - processed) ];
+            buf_addr -= processed;
+        }
+        else
+        {
+            processed = (int) hsimd_trt( buf_main_addr, max_process, fct );
+            if (processed < max_process)
+                fc = fct[ buf_main_addr[ processed ]];
+            buf_addr += processed;
+        }
+        buf_addr &= ADDRESS_MAXWRAP( regs );
+        buf_len  -= processed;
+    }
+
     while (buf_len && !fc && processed < max_process)
     {
         if (a_bit)
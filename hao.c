@@ -27,17 +27,65 @@
 /* constants                                                                 */
 /*---------------------------------------------------------------------------*/
 #define HAO_WKLEN    256    /* (maximum message length able to tolerate) */
-#define HAO_MAXRULE  64     /* (purely arbitrary and easily increasable) */
+#define HAO_MINRULE  64     /* (initial rule table size; grows as needed) */
 #define HAO_MAXCAPT  9      /* (maximum number of capturing groups)      */
 
+/*---------------------------------------------------------------------------*/
+/* rule table entry                                                          */
+/*---------------------------------------------------------------------------*/
+typedef struct HAORULE
+{
+    char       *tgt;        /* target (regular expression) as entered    */
+    char       *cmd;        /* command to issue or NULL if not yet given */
+    regex_t     preg;       /* compiled target                           */
+    char       *lit;        /* literal every match must contain, or NULL */
+    U64         hits;       /* number of times the rule has fired        */
+    U32         gen;        /* message generation it was last a candidate*/
+}
+HAORULE;
+
+/*---------------------------------------------------------------------------*/
+/* Aho-Corasick automaton built from the rules' literals                     */
+/*                                                                           */
+/* Each rule's target is reduced to the longest literal string that every    */
+/* match of it must contain (see hao_literal). All literals are compiled     */
+/* into a single automaton which finds every literal occurring in a message  */
+/* in one pass over it. Only rules whose literal occurs (or which have no    */
+/* usable literal, e.g. because of alternation) are then checked with        */
+/* regexec, so the cost per message no longer grows with the number of       */
+/* rules. The automaton is rebuilt lazily on the first message following a  */
+/* change to the rules, so that loading thousands of rules stays cheap.      */
+/*                                                                           */
+/* Bytes are first mapped to classes (one per distinct byte used in any      */
+/* literal plus class 0 for all other bytes) to keep the fully expanded      */
+/* transition table small.                                                   */
+/*---------------------------------------------------------------------------*/
+typedef struct HAOAC
+{
+    BYTE        cls[256];   /* byte -> class                             */
+    int         ncls;       /* number of classes                         */
+    int         nnodes;     /* number of states                          */
+    int        *delta;      /* transitions, nnodes * ncls                */
+    int        *out;        /* first rule whose literal ends here or -1  */
+    int        *dict;       /* next state on fail chain with output or 0 */
+    int        *next;       /* next rule with the same literal state     */
+    int        *always;     /* rules without a literal                   */
+    int         nalways;
+    int        *cand;       /* candidate rules for the current message   */
+    U32         gen;        /* current message generation                */
+}
+HAOAC;
+
 /*---------------------------------------------------------------------------*/
 /* local variables                                                           */
 /*---------------------------------------------------------------------------*/
 static TID      haotid;                         /* Herc Auto-Oper thread-id  */
 static LOCK     ao_lock;
-static regex_t  ao_preg[HAO_MAXRULE];
-static char    *ao_cmd[HAO_MAXRULE];
-static char    *ao_tgt[HAO_MAXRULE];
+static HAORULE **ao_rule;                       /* rule table (NULL = free)  */
+static int      ao_size;                        /* rule table size           */
+static int      ao_pending = -1;                /* rule awaiting its command */
+static HAOAC    ao_ac;                          /* literal prefilter         */
+static int      ao_acdirty;                     /* prefilter must be rebuilt */
 static char     ao_msgbuf[LOG_DEFSIZE+1];   /* (plus+1 for NULL termination) */
 
 /*---------------------------------------------------------------------------*/
@@ -65,7 +113,6 @@ static int hao_initialize()
 {
     static int already_did_this = FALSE;
     static int rc;
-    int i = 0;
 
     /* PROGRAMMING NOTE: this is a ONE TIME initialization function.
      * If initialization fails for any reason we DO NOT try again.
@@ -80,11 +127,11 @@ static int hao_initialize()
     obtain_lock( &ao_lock );
 
     /* initialize variables */
-    for(i=0; i < HAO_MAXRULE; i++)
-    {
-        ao_cmd[i] = NULL;
-        ao_tgt[i] = NULL;
-    }
+    ao_rule    = NULL;
+    ao_size    = 0;
+    ao_pending = -1;
+    ao_acdirty = TRUE;
+    memset( &ao_ac, 0, sizeof( ao_ac ));
 
     /* initialize message buffer */
     memset( ao_msgbuf, 0, sizeof( ao_msgbuf ));
@@ -212,6 +259,365 @@ static void hao_cpstrp(char *dest, char *src)
     dest[i] = 0;
 }
 
+/*---------------------------------------------------------------------------*/
+/* char *hao_literal(const char *re)                                         */
+/*                                                                           */
+/* This function returns (in malloc'ed storage) the longest string of        */
+/* literal characters that must appear in any string matched by the given    */
+/* POSIX extended regular expression, or NULL if no such string could be     */
+/* determined. It errs on the safe side: alternation anywhere in the         */
+/* pattern, or a literal of less than two characters, yields NULL, and       */
+/* characters inside groups, bracket expressions or followed by an optional */
+/* quantifier are never considered.                                          */
+/*---------------------------------------------------------------------------*/
+static char *hao_literal(const char *re)
+{
+    char   run[HAO_WKLEN];          /* literal run being collected       */
+    char   best[HAO_WKLEN+1];       /* longest run found so far          */
+    size_t nrun = 0, nbest = 0;
+    int    depth = 0;               /* group nesting level               */
+    const char *p;
+
+    if (strchr(re, '|'))
+        return NULL;
+
+#define HAO_ENDRUN()                                                        \
+    do {                                                                    \
+        if (nrun > nbest) { memcpy(best, run, nrun); nbest = nrun; }        \
+        nrun = 0;                                                           \
+    } while (0)
+
+    for (p = re; *p; p++)
+    {
+        switch (*p)
+        {
+        case '\\':
+            /* escaped special character is a literal, anything else */
+            /* (back references and the like) ends the literal run   */
+            if (p[1] && strchr(".[]()*+?{}|^$\\", p[1]))
+            {
+                p++;
+                if (!depth && nrun < sizeof(run))
+                    run[nrun++] = *p;
+            }
+            else
+            {
+                HAO_ENDRUN();
+                if (p[1])
+                    p++;
+            }
+            break;
+
+        case '*':
+        case '?':
+        case '{':
+            /* the preceding character is optional: drop it */
+            if (nrun)
+                nrun--;
+            HAO_ENDRUN();
+            if (*p == '{')
+                while (p[1] && *p != '}')
+                    p++;
+            break;
+
+        case '+':
+            /* the preceding character occurs at least once */
+            HAO_ENDRUN();
+            break;
+
+        case '[':
+            /* skip the bracket expression */
+            HAO_ENDRUN();
+            p++;
+            if (*p == '^')
+                p++;
+            if (*p == ']')
+                p++;
+            while (*p && *p != ']')
+            {
+                if (*p == '[' && (p[1] == ':' || p[1] == '.' || p[1] == '='))
+                {
+                    char delim = p[1];
+                    for (p += 2; *p && !(*p == delim && p[1] == ']'); p++);
+                    if (*p)
+                        p++;
+                }
+                if (*p)
+                    p++;
+            }
+            if (!*p)
+                p--;
+            break;
+
+        case '(':
+            HAO_ENDRUN();
+            depth++;
+            break;
+
+        case ')':
+            HAO_ENDRUN();
+            if (depth)
+                depth--;
+            break;
+
+        case '.':
+        case '^':
+        case '$':
+            HAO_ENDRUN();
+            break;
+
+        default:
+            if (!depth && nrun < sizeof(run))
+                run[nrun++] = *p;
+            else if (depth)
+                HAO_ENDRUN();
+            break;
+        }
+    }
+    HAO_ENDRUN();
+
+#undef HAO_ENDRUN
+
+    if (nbest < 2)
+        return NULL;
+
+    best[nbest] = 0;
+    return strdup(best);
+}
+
+/*---------------------------------------------------------------------------*/
+/* void hao_acfree(void)                                                     */
+/*                                                                           */
+/* This function releases the literal prefilter automaton.                  */
+/*---------------------------------------------------------------------------*/
+static void hao_acfree(void)
+{
+    free(ao_ac.delta);
+    free(ao_ac.out);
+    free(ao_ac.dict);
+    free(ao_ac.next);
+    free(ao_ac.always);
+    free(ao_ac.cand);
+    memset(&ao_ac, 0, sizeof(ao_ac));
+}
+
+/*---------------------------------------------------------------------------*/
+/* int hao_acbuild(void)                                                     */
+/*                                                                           */
+/* This function (re)builds the literal prefilter automaton from all         */
+/* complete rules. It is called with ao_lock held. Returns FALSE if there    */
+/* was not enough storage, in which case every complete rule is treated as  */
+/* a candidate for every message.                                            */
+/*---------------------------------------------------------------------------*/
+static int hao_acbuild(void)
+{
+    int  i, j, k, c, u, v, maxnodes, head, tail;
+    int *fail = NULL, *queue = NULL;
+    const BYTE *s;
+
+    hao_acfree();
+    ao_acdirty = FALSE;
+
+    /* assign byte classes and count the trie states needed */
+    ao_ac.ncls = 1;
+    maxnodes   = 1;
+    for (i = 0; i < ao_size; i++)
+    {
+        if (ao_rule[i] && ao_rule[i]->cmd && ao_rule[i]->lit)
+        {
+            for (s = (const BYTE *) ao_rule[i]->lit; *s; s++, maxnodes++)
+                if (!ao_ac.cls[*s])
+                    ao_ac.cls[*s] = (BYTE) ao_ac.ncls++;
+        }
+    }
+
+    ao_ac.delta  = calloc((size_t) maxnodes * ao_ac.ncls, sizeof(int));
+    ao_ac.out    = malloc(maxnodes * sizeof(int));
+    ao_ac.dict   = calloc(maxnodes, sizeof(int));
+    ao_ac.next   = malloc((ao_size + 1) * sizeof(int));
+    ao_ac.always = malloc((ao_size + 1) * sizeof(int));
+    ao_ac.cand   = malloc((ao_size + 1) * sizeof(int));
+    fail         = calloc(maxnodes, sizeof(int));
+    queue        = malloc(maxnodes * sizeof(int));
+
+    if (!ao_ac.delta || !ao_ac.out || !ao_ac.dict || !ao_ac.next
+     || !ao_ac.always || !ao_ac.cand || !fail || !queue)
+    {
+        free(fail);
+        free(queue);
+        hao_acfree();
+        return FALSE;
+    }
+
+    for (i = 0; i < maxnodes; i++)
+        ao_ac.out[i] = -1;
+
+    /* build the trie of all literals */
+    ao_ac.nnodes = 1;
+    for (i = ao_size - 1; i >= 0; i--)
+    {
+        if (!ao_rule[i] || !ao_rule[i]->cmd)
+            continue;
+
+        if (!ao_rule[i]->lit)
+        {
+            ao_ac.always[ao_ac.nalways++] = i;
+            continue;
+        }
+
+        for (u = 0, s = (const BYTE *) ao_rule[i]->lit; *s; s++)
+        {
+            k = u * ao_ac.ncls + ao_ac.cls[*s];
+            if (!ao_ac.delta[k])
+                ao_ac.delta[k] = ao_ac.nnodes++;
+            u = ao_ac.delta[k];
+        }
+        ao_ac.next[i] = ao_ac.out[u];
+        ao_ac.out[u]  = i;
+    }
+
+    /* (always list was built backwards; put it in index order) */
+    for (j = 0, k = ao_ac.nalways - 1; j < k; j++, k--)
+    {
+        c = ao_ac.always[j];
+        ao_ac.always[j] = ao_ac.always[k];
+        ao_ac.always[k] = c;
+    }
+
+    /* compute failure links breadth first and turn the trie into a */
+    /* complete transition table (a row of a state is only filled   */
+    /* once the state itself is dequeued, so up to that point any   */
+    /* non-zero entry in it is a trie edge)                         */
+    head = tail = 0;
+    queue[tail++] = 0;
+    while (head < tail)
+    {
+        u = queue[head++];
+        for (c = 0; c < ao_ac.ncls; c++)
+        {
+            k = u * ao_ac.ncls + c;
+            v = ao_ac.delta[k];
+            if (v)
+            {
+                fail[v] = u ? ao_ac.delta[fail[u] * ao_ac.ncls + c] : 0;
+                ao_ac.dict[v] = ao_ac.out[fail[v]] >= 0 ? fail[v] : ao_ac.dict[fail[v]];
+                queue[tail++] = v;
+            }
+            else
+                ao_ac.delta[k] = u ? ao_ac.delta[fail[u] * ao_ac.ncls + c] : 0;
+        }
+    }
+
+    free(fail);
+    free(queue);
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+/* int hao_intcmp(const void *a, const void *b)                              */
+/*                                                                           */
+/* qsort comparison function for rule indexes.                               */
+/*---------------------------------------------------------------------------*/
+static int hao_intcmp(const void *a, const void *b)
+{
+    return *(const int *) a - *(const int *) b;
+}
+
+/*---------------------------------------------------------------------------*/
+/* int hao_candidates(const char *msg)                                       */
+/*                                                                           */
+/* This function runs the message through the literal prefilter and leaves   */
+/* the indexes of all rules that might match it, in ascending order, in      */
+/* ao_ac.cand. It is called with ao_lock held and returns the number of      */
+/* candidates, or -1 if there is no prefilter (all rules are candidates).    */
+/*---------------------------------------------------------------------------*/
+static int hao_candidates(const char *msg)
+{
+    const BYTE *s;
+    int  u, n, r, ncand = 0;
+
+    if (ao_acdirty && !hao_acbuild())
+        return -1;
+
+    if (!ao_ac.cand)
+        return -1;
+
+    /* new generation: no rule is a candidate yet */
+    if (!++ao_ac.gen)
+    {
+        for (r = 0; r < ao_size; r++)
+            if (ao_rule[r])
+                ao_rule[r]->gen = 0;
+        ao_ac.gen = 1;
+    }
+
+    if (ao_ac.nnodes > 1)
+    {
+        for (u = 0, s = (const BYTE *) msg; *s; s++)
+        {
+            u = ao_ac.delta[u * ao_ac.ncls + ao_ac.cls[*s]];
+
+            for (n = ao_ac.out[u] >= 0 ? u : ao_ac.dict[u]; n; n = ao_ac.dict[n])
+            {
+                for (r = ao_ac.out[n]; r >= 0; r = ao_ac.next[r])
+                {
+                    if (ao_rule[r]->gen != ao_ac.gen)
+                    {
+                        ao_rule[r]->gen = ao_ac.gen;
+                        ao_ac.cand[ncand++] = r;
+                    }
+                }
+            }
+        }
+    }
+
+    /* rules without a literal are always candidates */
+    memcpy(&ao_ac.cand[ncand], ao_ac.always, ao_ac.nalways * sizeof(int));
+    ncand += ao_ac.nalways;
+
+    if (ncand > 1)
+        qsort(ao_ac.cand, ncand, sizeof(int), hao_intcmp);
+
+    return ncand;
+}
+
+/*---------------------------------------------------------------------------*/
+/* int hao_maymatch(HAORULE *rule, const char *str)                          */
+/*                                                                           */
+/* Returns TRUE if the string matches the rule's target. The rule's literal  */
+/* is checked first so most non-matching strings never reach regexec.        */
+/*---------------------------------------------------------------------------*/
+static int hao_maymatch(HAORULE *rule, const char *str)
+{
+    if (rule->lit && !strstr(str, rule->lit))
+        return FALSE;
+    return !regexec(&rule->preg, str, 0, NULL, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+/* void hao_freerule(int i)                                                  */
+/*                                                                           */
+/* This function frees the rule at index i. Called with ao_lock held.        */
+/*---------------------------------------------------------------------------*/
+static void hao_freerule(int i)
+{
+    HAORULE *rule = ao_rule[i];
+
+    if (!rule)
+        return;
+
+    regfree(&rule->preg);
+    free(rule->tgt);
+    free(rule->cmd);
+    free(rule->lit);
+    free(rule);
+
+    ao_rule[i] = NULL;
+    if (ao_pending == i)
+        ao_pending = -1;
+    ao_acdirty = TRUE;
+}
+
 /*---------------------------------------------------------------------------*/
 /* void hao_tgt(char *arg)                                                   */
 /*                                                                           */
@@ -224,34 +630,20 @@ static void hao_tgt(char *arg)
     int j;
     int rc;
     char work[HAO_WKLEN];
+    HAORULE *rule;
 
     /* serialize */
     obtain_lock(&ao_lock);
 
-    /* find a free slot */
-    for(i = 0; ao_tgt[i] && i < HAO_MAXRULE; i++)
-
-    /* check for table full */
-    if(i == HAO_MAXRULE)
+    /* check if not command is expected */
+    if (ao_pending >= 0)
     {
         release_lock(&ao_lock);
-        // "The %s was not added because table is full; table size is %02d"
-        WRMSG(HHC00071, "E", "target", HAO_MAXRULE);
+        // "The command %s given, but the command %s was expected"
+        WRMSG(HHC00072, "E", "tgt", "cmd");
         return;
     }
 
-    /* check if not command is expected */
-    for(j = 0; j < HAO_MAXRULE; j++)
-    {
-        if(ao_tgt[j] && !ao_cmd[j])
-        {
-            release_lock(&ao_lock);
-            // "The command %s given, but the command %s was expected"
-            WRMSG(HHC00072, "E", "tgt", "cmd");
-            return;
-        }
-    }
-
     /* check for empty target */
     if(!strlen(arg))
     {
@@ -262,9 +654,9 @@ static void hao_tgt(char *arg)
     }
 
     /* check for duplicate targets */
-    for(j = 0; j < HAO_MAXRULE; j++)
+    for(j = 0; j < ao_size; j++)
     {
-        if(ao_tgt[j] && !strcmp(arg, ao_tgt[j]))
+        if(ao_rule[j] && !strcmp(arg, ao_rule[j]->tgt))
         {
             release_lock(&ao_lock);
             // "The target was not added because a duplicate was found in the table at %02d"
@@ -273,8 +665,37 @@ static void hao_tgt(char *arg)
         }
     }
 
+    /* find a free slot */
+    for(i = 0; i < ao_size && ao_rule[i]; i++);
+
+    /* grow the table if full */
+    if(i == ao_size)
+    {
+        int newsize = ao_size ? ao_size * 2 : HAO_MINRULE;
+        HAORULE **newrule = realloc(ao_rule, newsize * sizeof(HAORULE *));
+
+        if(!newrule)
+        {
+            release_lock(&ao_lock);
+            // "Error in function %s: %s"
+            WRMSG(HHC00075, "E", "realloc()", strerror(ENOMEM));
+            return;
+        }
+        memset(&newrule[ao_size], 0, (newsize - ao_size) * sizeof(HAORULE *));
+        ao_rule = newrule;
+        ao_size = newsize;
+    }
+
+    if(!(rule = calloc(1, sizeof(HAORULE))))
+    {
+        release_lock(&ao_lock);
+        // "Error in function %s: %s"
+        WRMSG(HHC00075, "E", "calloc()", strerror(ENOMEM));
+        return;
+    }
+
     /* compile the target string */
-    rc = regcomp(&ao_preg[i], arg, REG_EXTENDED);
+    rc = regcomp(&rule->preg, arg, REG_EXTENDED);
 
     /* check for error */
     if(rc)
@@ -282,38 +703,49 @@ static void hao_tgt(char *arg)
         release_lock(&ao_lock);
 
         /* place error in work */
-        regerror(rc, (const regex_t *) &ao_preg[i], work, HAO_WKLEN);
+        regerror(rc, (const regex_t *) &rule->preg, work, HAO_WKLEN);
+        free(rule);
         // "Error in function %s: %s"
         WRMSG(HHC00075, "E", "regcomp()", work);
         return;
     }
 
+    /* extract the literal for the prefilter */
+    rule->lit = hao_literal(arg);
+
     /* check for possible loop */
-    for(j = 0; j < HAO_MAXRULE; j++)
+    for(j = 0; j < ao_size; j++)
     {
-        if(ao_cmd[j] && !regexec(&ao_preg[i], ao_cmd[j], 0, NULL, 0))
+        if(ao_rule[j] && ao_rule[j]->cmd && hao_maymatch(rule, ao_rule[j]->cmd))
         {
             release_lock(&ao_lock);
-            regfree(&ao_preg[i]);
+            regfree(&rule->preg);
+            free(rule->lit);
+            free(rule);
             // "The %s was not added because it causes a loop with the %s at index %02d"
-            WRMSG(HHC00076, "E", "target", "command", i);
+            WRMSG(HHC00076, "E", "target", "command", j);
             return;
         }
     }
 
     /* duplicate the target */
-    ao_tgt[i] = strdup(arg);
+    rule->tgt = strdup(arg);
 
     /* check duplication */
-    if(!ao_tgt[i])
+    if(!rule->tgt)
     {
         release_lock(&ao_lock);
-        regfree(&ao_preg[i]);
+        regfree(&rule->preg);
+        free(rule->lit);
+        free(rule);
         // "Error in function %s: %s"
         WRMSG(HHC00075, "E", "strdup()", strerror(ENOMEM));
         return;
     }
 
+    ao_rule[i] = rule;
+    ao_pending = i;
+
     release_lock(&ao_lock);
 
     // "The %s was placed at index %d"
@@ -335,20 +767,8 @@ static void hao_cmd(char *arg)
     /* serialize */
     obtain_lock(&ao_lock);
 
-    /* find the free slot */
-    for(i = 0; ao_cmd[i] && i < HAO_MAXRULE; i++);
-
-    /* check for table full -> so tgt cmd expected */
-    if(i == HAO_MAXRULE)
-    {
-        release_lock(&ao_lock);
-        // "The %s was not added because table is full; table size is %02d"
-        WRMSG(HHC00071, "E", "command", HAO_MAXRULE);
-        return;
-    }
-
     /* check if target is given */
-    if(!ao_tgt[i])
+    if((i = ao_pending) < 0)
     {
         release_lock(&ao_lock);
         // "The command %s given, but the command %s was expected"
@@ -376,9 +796,9 @@ static void hao_cmd(char *arg)
     }
 
     /* check for possible loop */
-    for(j = 0; j < HAO_MAXRULE; j++)
+    for(j = 0; j < ao_size; j++)
     {
-        if(ao_tgt[j] && !regexec(&ao_preg[j], arg, 0, NULL, 0))
+        if(ao_rule[j] && hao_maymatch(ao_rule[j], arg))
         {
             release_lock(&ao_lock);
             // "The %s was not added because it causes a loop with the %s at index %02d"
@@ -388,10 +808,10 @@ static void hao_cmd(char *arg)
     }
 
     /* duplicate the string */
-    ao_cmd[i] = strdup(arg);
+    ao_rule[i]->cmd = strdup(arg);
 
     /* check duplication */
-    if(!ao_cmd[i])
+    if(!ao_rule[i]->cmd)
     {
         release_lock(&ao_lock);
         // "Error in function %s: %s"
@@ -399,6 +819,10 @@ static void hao_cmd(char *arg)
         return;
     }
 
+    /* the rule is complete now */
+    ao_pending = -1;
+    ao_acdirty = TRUE;
+
     release_lock(&ao_lock);
 
     // "The %s was placed at index %d"
@@ -425,19 +849,21 @@ static void hao_del(char *arg)
         return;
     }
 
+    /* serialize */
+    obtain_lock(&ao_lock);
+
     /* check if index is valid */
-    if(i < 0 || i >= HAO_MAXRULE)
+    if(i < 0 || i >= ao_size)
     {
+        rc = ao_size ? ao_size - 1 : 0;
+        release_lock(&ao_lock);
         // "Invalid index; index must be between 0 and %02d"
-        WRMSG(HHC00084, "E", HAO_MAXRULE - 1);
+        WRMSG(HHC00084, "E", rc);
         return;
     }
 
-    /* serialize */
-    obtain_lock(&ao_lock);
-
     /* check if entry exists */
-    if(!ao_tgt[i])
+    if(!ao_rule[i])
     {
         release_lock(&ao_lock);
         // "Rule at index %d not deleted, already empty"
@@ -446,15 +872,7 @@ static void hao_del(char *arg)
     }
 
     /* delete the entry */
-    free(ao_tgt[i]);
-    ao_tgt[i] = NULL;
-    regfree(&ao_preg[i]);
-
-    if(ao_cmd[i])
-    {
-        free(ao_cmd[i]);
-        ao_cmd[i] = NULL;
-    }
+    hao_freerule(i);
 
     release_lock(&ao_lock);
 
@@ -483,17 +901,18 @@ static void hao_list(char *arg)
         /* serialize */
         obtain_lock(&ao_lock);
 
-        for(i = 0; i < HAO_MAXRULE; i++)
+        for(i = 0; i < ao_size; i++)
         {
-            if(ao_tgt[i])
+            if(ao_rule[i])
             {
                 if(!size)
                 {
                     // "The defined Hercules Automatic Operator rule(s) are:"
                     WRMSG(HHC00087, "I");
                 }
-                // "Index %02d: target %s -> command %s"
-                WRMSG(HHC00088, "I", i, ao_tgt[i], (ao_cmd[i] ? ao_cmd[i] : "not specified"));
+                // "Index %02d: target %s -> command %s, hits %"PRIu64
+                WRMSG(HHC00088, "I", i, ao_rule[i]->tgt,
+                    (ao_rule[i]->cmd ? ao_rule[i]->cmd : "not specified"), ao_rule[i]->hits);
                 size++;
             }
         }
@@ -512,30 +931,29 @@ static void hao_list(char *arg)
     }
     else
     {
+        /* serialize */
+        obtain_lock(&ao_lock);
+
         /* list specific index */
-        if(i < 0 || i >= HAO_MAXRULE)
+        if(i < 0 || i >= ao_size)
         {
+            rc = ao_size ? ao_size - 1 : 0;
             // "Invalid index; index must be between 0 and %02d"
-            WRMSG(HHC00084, "E", HAO_MAXRULE - 1);
+            WRMSG(HHC00084, "E", rc);
+        }
+        else if(!ao_rule[i])
+        {
+            // "No rule defined at index %02d"
+            WRMSG(HHC00079, "E", i);
         }
         else
         {
-            /* serialize */
-            obtain_lock(&ao_lock);
-
-            if(!ao_tgt[i])
-            {
-                // "No rule defined at index %02d"
-                WRMSG(HHC00079, "E", i);
-            }
-            else
-            {
-                // "Index %02d: target %s -> command %s"
-                WRMSG(HHC00088, "I", i, ao_tgt[i], (ao_cmd[i] ? ao_cmd[i] : "not specified"));
-            }
-
-            release_lock(&ao_lock);
+            // "Index %02d: target %s -> command %s, hits %"PRIu64
+            WRMSG(HHC00088, "I", i, ao_rule[i]->tgt,
+                (ao_rule[i]->cmd ? ao_rule[i]->cmd : "not specified"), ao_rule[i]->hits);
         }
+
+        release_lock(&ao_lock);
     }
 }
 
@@ -554,20 +972,13 @@ static void hao_clear(void)
     obtain_lock(&ao_lock);
 
     /* clear all defined rules */
-    for(i = 0; i < HAO_MAXRULE; i++)
-    {
-        if(ao_tgt[i])
-        {
-            free(ao_tgt[i]);
-            ao_tgt[i] = NULL;
-            regfree(&ao_preg[i]);
-        }
-        if(ao_cmd[i])
-        {
-            free(ao_cmd[i]);
-            ao_cmd[i] = NULL;
-        }
-    }
+    for(i = 0; i < ao_size; i++)
+        hao_freerule(i);
+
+    free(ao_rule);
+    ao_rule = NULL;
+    ao_size = 0;
+    hao_acfree();
 
     release_lock(&ao_lock);
 
@@ -745,14 +1156,18 @@ static size_t hao_subst(char *str, size_t soff, size_t eoff,
 /*                                                                           */
 /* This function is called by hao_thread whenever a message is about to be   */
 /* printed. Here we check if a rule applies to the message. If so we fire    */
-/* the command within the rule.                                              */
+/* the command within the rule. Only the rules picked by the literal         */
+/* prefilter are evaluated, and the commands are issued after ao_lock has    */
+/* been released so that rules can be changed while they are executing.     */
 /*---------------------------------------------------------------------------*/
 static void hao_message(char *buf)
 {
     char work[HAO_WKLEN];
     char cmd[HAO_WKLEN];
     regmatch_t rm[HAO_MAXCAPT+1];
-    int i, j, k, numcapt;
+    int i, j, k, c, numcapt, ncand, nfire = 0;
+    int *fire_idx = NULL;
+    char **fire_cmd = NULL;
     size_t n;
     char *p;
 
@@ -770,20 +1185,31 @@ static void hao_message(char *buf)
     /* serialize */
     obtain_lock(&ao_lock);
 
-    /* check all defined rules */
-    for(i = 0; i < HAO_MAXRULE; i++)
+    if (!ao_size)
+    {
+        release_lock(&ao_lock);
+        return;
+    }
+
+    /* find the rules that might match */
+    ncand = hao_candidates(work);
+
+    /* check all candidate rules */
+    for(c = 0; c < (ncand < 0 ? ao_size : ncand); c++)
     {
-        if(ao_tgt[i] && ao_cmd[i])  /* complete rule defined in this slot? */
+        i = ncand < 0 ? c : ao_ac.cand[c];
+
+        if(ao_rule[i] && ao_rule[i]->cmd)  /* complete rule defined in this slot? */
         {
             /* does this rule match our message? */
-            if (regexec(&ao_preg[i], work, HAO_MAXCAPT+1, rm, 0) == 0)
+            if (regexec(&ao_rule[i]->preg, work, HAO_MAXCAPT+1, rm, 0) == 0)
             {
                 /* count the capturing group matches */
                 for (j = 0; j <= HAO_MAXCAPT && rm[j].rm_so >= 0; j++);
                 numcapt = j - 1;
 
                 /* copy the command and process replacement patterns */
-                for (n=0, p=ao_cmd[i]; *p && n < sizeof(cmd)-1; )
+                for (n=0, p=ao_rule[i]->cmd; *p && n < sizeof(cmd)-1; )
                 {
                     /* replace $$ by $ */
                     if (*p == '$' && p[1] == '$')
@@ -831,13 +1257,33 @@ static void hao_message(char *buf)
                 }
                 cmd[n] = '\0';
 
-                // "Match at index %02d, executing command %s"
-                WRMSG(HHC00081, "I", i, cmd);
-                panel_command(cmd);
+                ao_rule[i]->hits++;
+
+                /* remember the command; it is issued further below */
+                if (!fire_cmd)
+                {
+                    k = ncand < 0 ? ao_size : ncand;
+                    fire_idx = malloc(k * sizeof(int));
+                    fire_cmd = malloc(k * sizeof(char *));
+                }
+                if (fire_idx && fire_cmd && (fire_cmd[nfire] = strdup(cmd)))
+                    fire_idx[nfire++] = i;
             }
         }
     }
     release_lock(&ao_lock);
+
+    /* issue the commands of all matching rules */
+    for (c = 0; c < nfire; c++)
+    {
+        // "Match at index %02d, executing command %s"
+        WRMSG(HHC00081, "I", fire_idx[c], fire_cmd[c]);
+        panel_command(fire_cmd[c]);
+        free(fire_cmd[c]);
+    }
+
+    free(fire_idx);
+    free(fire_cmd);
 }
 
 #endif /* defined(OPTION_HAO) */
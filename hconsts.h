@@ -127,6 +127,21 @@
 #define MAX_390_MAINSIZE_PAGES      (MAX_390_MAINSIZE_BYTES  >> SHIFT_4K)
 #define MAX_900_MAINSIZE_PAGES      (MAX_900_MAINSIZE_BYTES  >> SHIFT_4K)
 
+/*-------------------------------------------------------------------*/
+/*          Hercules "AFFINITY MAINSTOR" NUMA placement policies     */
+/*-------------------------------------------------------------------*/
+
+#define NUMA_POLICY_DEFAULT         0   // host default (first touch)
+#define NUMA_POLICY_INTERLEAVE      1   // interleave across nodes
+#define NUMA_POLICY_BIND            2   // bind to nodes
+
+/*-------------------------------------------------------------------*/
+/*          Hercules "WAITSPIN" CPU wait state spin limit            */
+/*-------------------------------------------------------------------*/
+
+#define DEF_WAITSPIN                0   // usecs (sleep immediately)
+#define MAX_WAITSPIN            10000   // usecs
+
 /*-------------------------------------------------------------------*/
 /* Miscellaneous system related constants we could be missing...     */
 /*-------------------------------------------------------------------*/
@@ -63,6 +63,7 @@ main( int argc, char *argv[] )
     int             o_iehinitt;
     int             o_nl;
     int             o_compress;
+    int             o_method;
     int             o_faketape;
     char           *o_filename;
     char           *o_owner;
@@ -77,12 +78,13 @@ main( int argc, char *argv[] )
     o_iehinitt = TRUE;
     o_nl = FALSE;
     o_compress = TRUE;
+    o_method = HETDFLT_METHOD;
     o_owner = NULL;
     o_volser = NULL;
 
     while( TRUE )
     {
-        rc = getopt( argc, argv, "dhin" );
+        rc = getopt( argc, argv, "bdhinzZ" );
         if( rc == -1 )
         {
             break;
@@ -90,6 +92,10 @@ main( int argc, char *argv[] )
 
         switch( rc )
         {
+            case 'b':
+                o_method = HETMETH_BZLIB;
+            break;
+
             case 'd':
                 o_compress = FALSE;
             break;
@@ -108,6 +114,14 @@ main( int argc, char *argv[] )
                 o_nl = TRUE;
             break;
 
+            case 'z':
+                o_method = HETMETH_ZLIB;
+            break;
+
+            case 'Z':
+                o_method = HETMETH_ZSTD;
+            break;
+
             default:
                 usage( pgm );
                 goto exit;
@@ -190,6 +204,14 @@ main( int argc, char *argv[] )
             FWRMSG( stderr, HHC00075, "E", "het_cntl()", het_error( rc ) );
             goto exit;
         }
+
+        rc = het_cntl( hetb, HETCNTL_SET | HETCNTL_METHOD, o_method );
+        if( rc < 0 )
+        {
+            // "Error in function %s: %s"
+            FWRMSG( stderr, HHC00075, "E", "het_cntl()", het_error( rc ) );
+            goto exit;
+        }
     }
 
     if( o_iehinitt )
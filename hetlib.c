@@ -58,10 +58,174 @@ static const char *het_errstr[] =
     "Inconsistent compression flags",
     "Block is short",
     "Location error",
+    "Bad compression thread count",
     "Invalid error code",
 };
 #define HET_ERRSTR_MAX ( sizeof( het_errstr) / sizeof( het_errstr[ 0 ] ) )
 
+/*
+|| Initial number of block index entries (doubled as needed)
+*/
+#define HET_IDXINIT 1024
+
+/*
+|| Compression worker pool (see het_write())
+*/
+#define HETJOB_QUEUED   0               /* Waiting for a worker             */
+#define HETJOB_BUSY     1               /* Being compressed                 */
+#define HETJOB_DONE     2               /* Ready to be written              */
+
+typedef struct _hetcjob
+{
+    char           *ubuf;               /* Uncompressed data                */
+    char           *cbuf;               /* Compressed data                  */
+    uint32_t        ubufsz;             /* Size of ubuf                     */
+    uint32_t        cbufsz;             /* Size of cbuf                     */
+    int             ulen;               /* Uncompressed length              */
+    int             clen;               /* Compressed length or error       */
+    int             flags;              /* Compression method used, 0=none  */
+    int             method;             /* Method requested                 */
+    int             level;              /* Level requested                  */
+    int             state;              /* HETJOB_xxx                       */
+    int             err;                /* errno when clen < 0              */
+} HETCJOB;
+
+struct _hetcpool
+{
+    LOCK            lock;               /* Protects everything below        */
+    COND            cond;               /* Signalled on any state change    */
+    TID            *tids;               /* Worker threads                   */
+    int             nthreads;           /* Number of worker threads         */
+    int             njobs;              /* Number of jobs in the ring       */
+    HETCJOB        *jobs;               /* The ring                         */
+    int             head;               /* Oldest job not yet written       */
+    int             count;              /* Jobs not yet written             */
+    int             next;               /* Next job for a worker            */
+    int             pending;            /* Jobs not yet taken by a worker   */
+    int             stop;               /* TRUE = workers should exit       */
+    int             rc;                 /* Deferred error, 0 = none         */
+    int             err;                /* errno for deferred error         */
+};
+
+static int het_cpool_init( HETB *hetb, int nthreads );
+static int het_cpool_free( HETB *hetb );
+
+/*
+|| Extend the block index when the chunk header just read or written ends the
+|| highest block indexed so far.  Headers are only ever passed in order going
+|| forward, so the index always covers blocks 0 to idxcnt-1 without gaps.  If
+|| it can't grow, positioning beyond it simply falls back to spacing blocks.
+*/
+static void
+het_index_add( HETB *hetb )
+{
+    HETIDX *tidx;
+    off_t   pos;
+
+    /*
+    || Create the index when the first block has been passed
+    */
+    if( hetb->idxcnt == 0 )
+    {
+        if( hetb->cblk != 1 )
+        {
+            return;
+        }
+
+        hetb->idx = malloc( HET_IDXINIT * sizeof( HETIDX ) );
+        if( hetb->idx == NULL )
+        {
+            return;
+        }
+
+        hetb->idxmax = HET_IDXINIT;
+        hetb->idx[ 0 ].hdrpos = 0;
+        hetb->idx[ 0 ].tapemarks = 0;
+        hetb->idxcnt = 1;
+    }
+
+    /*
+    || Only a block just past the end of the index is of interest
+    */
+    if( hetb->cblk != hetb->idxcnt )
+    {
+        return;
+    }
+
+    if( hetb->idxcnt == hetb->idxmax )
+    {
+        tidx = realloc( hetb->idx, 2 * hetb->idxmax * sizeof( HETIDX ) );
+        if( tidx == NULL )
+        {
+            return;
+        }
+        hetb->idx = tidx;
+        hetb->idxmax *= 2;
+    }
+
+    pos = ftell( hetb->fh );
+    if( pos < 0 )
+    {
+        return;
+    }
+
+    tidx = &hetb->idx[ hetb->idxcnt ];
+    tidx->hdrpos    = pos - sizeof( HETHDR );
+    tidx->tapemarks = tidx[ -1 ].tapemarks;
+    if( hetb->chdr.flags1 & HETHDR_FLAGS1_TAPEMARK )
+    {
+        tidx->tapemarks++;
+    }
+    hetb->idxcnt++;
+}
+
+/*
+|| Position directly to the start of an indexed block.  The chunk header that
+|| ends the previous block is reloaded so that the chdr in the HETB is exactly
+|| what it would have been had the block been reached by spacing forward.
+*/
+static int
+het_index_seek( HETB *hetb, uint32_t block )
+{
+    int rc;
+
+    if( block == 0 )
+    {
+        return( het_rewind( hetb ) );
+    }
+
+    rc = fseek( hetb->fh,
+                hetb->idx[ block ].hdrpos,
+                SEEK_SET );
+    if( rc == -1 )
+    {
+        return( HETE_ERROR );
+    }
+
+    /*
+    || Reading the header bumps the block number to the requested one
+    */
+    hetb->cblk = block - 1;
+    rc = het_read_header( hetb );
+    if( rc < 0 && rc != HETE_TAPEMARK )
+    {
+        return( rc );
+    }
+
+    rc = fseek( hetb->fh,
+                HETHDR_CLEN( hetb ),
+                SEEK_CUR );
+    if( rc == -1 )
+    {
+        return( HETE_ERROR );
+    }
+
+    hetb->cblk = block;
+    hetb->truncated = FALSE;
+
+    return( hetb->cblk );
+}
+
 /*==DOC==
 
     NAME
@@ -330,12 +494,21 @@ het_open( HETB **hetb, const char *filename, int flags )
 DLL_EXPORT int
 het_close( HETB **hetb )
 {
+    int rc = 0;
 
     /*
     || Only free the HETB if we have one
     */
     if( *(hetb) != NULL )
     {
+        /*
+        || Write out blocks still being compressed
+        */
+        if( (*hetb)->cpool != NULL )
+        {
+            rc = het_cpool_free( *hetb );
+        }
+
         /*
         || Only close the file if opened
         */
@@ -343,6 +516,7 @@ het_close( HETB **hetb )
         {
             fclose( (*hetb)->fh );
         }
+        free( (*hetb)->idx );
         free( *(hetb) );
     }
 
@@ -351,7 +525,7 @@ het_close( HETB **hetb )
     */
     *hetb = NULL;
 
-    return( 0 );
+    return( rc );
 }
 
 /*==DOC==
@@ -392,11 +566,14 @@ het_close( HETB **hetb )
             HETCNTL_METHOD      val=Compression method to use
                                 Values:     HETMETH_ZLIB (1)
                                             HETMETH_BZLIB (2)
+                                            HETMETH_ZSTD (3)
+                                            (only if compiled in)
                                 Default:    HETDFLT_METHOD (HETMETH_ZLIB)
 
             HETCNTL_LEVEL       val=Level of compression
                                 Min:        HETMIN_LEVEL (1)
                                 Max:        HETMAX_LEVEL (9)
+                                            HETMAX_ZSTD_LEVEL (19) for ZSTD
                                 Default:    HETDFLT_LEVEL (4)
 
             HETCNTL_CHUNKSIZE   val=Size of output chunks (see notes)
@@ -404,6 +581,11 @@ het_close( HETB **hetb )
                                 Max:        HETMAX_CHUNKSIZE (65535)
                                 Default:    HETDFLT_CHUNKSIZE (65535)
 
+            HETCNTL_THREADS     val=Number of compression threads (see notes)
+                                Min:        0 (compress in het_write())
+                                Max:        HETMAX_THREADS (64)
+                                Default:    0
+
     RETURN VALUE
             If no errors are detected then the return value will be either
             the current setting for a "get" request or >= 0 for a "set"
@@ -418,6 +600,8 @@ het_close( HETB **hetb )
 
             HETE_BADCHUNKSIZE   Specified chunk size out of range
 
+            HETE_BADTHREADS     Specified thread count out of range
+
             HETE_BADFUNC        Unrecognized function code
 
     NOTES
@@ -427,6 +611,11 @@ het_close( HETB **hetb )
             If you wish to create an AWSTAPE compatible file, specify a chunk
             size of 4096 and disable write compression.
 
+            With HETCNTL_THREADS > 0 blocks are compressed by that many
+            threads while het_write() returns right away.  Blocks are still
+            written in order, but errors are only reported by a later call
+            (see het_flush()).
+
     EXAMPLE
             //
             // Create an NL tape and write an uncompressed string to it
@@ -509,12 +698,23 @@ het_cntl( HETB *hetb, int func, unsigned long val )
                 return( hetb->method );
             }
 
-            if( val < HETMIN_METHOD || val > HETMAX_METHOD )
+            /*
+            || Only the methods compiled in can be used
+            */
+            if( !HET_METHOD_OK( val ) )
             {
                 return( HETE_BADMETHOD );
             }
 
             hetb->method = val;
+
+            /*
+            || Only ZSTD goes past level 9
+            */
+            if( hetb->level > HETMAX_METHOD_LEVEL( val ) )
+            {
+                hetb->level = HETMAX_METHOD_LEVEL( val );
+            }
         break;
 
         case HETCNTL_LEVEL:
@@ -523,7 +723,7 @@ het_cntl( HETB *hetb, int func, unsigned long val )
                 return( hetb->level );
             }
 
-            if( val < HETMIN_LEVEL || val > HETMAX_LEVEL )
+            if( val < HETMIN_LEVEL || val > HETMAX_METHOD_LEVEL( hetb->method ) )
             {
                 return( HETE_BADLEVEL );
             }
@@ -545,6 +745,35 @@ het_cntl( HETB *hetb, int func, unsigned long val )
             hetb->chksize = val;
         break;
 
+        case HETCNTL_THREADS:
+            if( mode == HETCNTL_GET )
+            {
+                return( hetb->cpool ? hetb->cpool->nthreads : 0 );
+            }
+
+            if( val > HETMAX_THREADS )
+            {
+                return( HETE_BADTHREADS );
+            }
+
+            /*
+            || Replace the workers, writing out what the old ones have done
+            */
+            if( hetb->cpool )
+            {
+                int rc = het_cpool_free( hetb );
+                if( rc < 0 )
+                {
+                    return( rc );
+                }
+            }
+
+            if( val > 0 )
+            {
+                return( het_cpool_init( hetb, (int)val ) );
+            }
+        break;
+
         default:
             return( HETE_BADFUNC );
     }
@@ -664,6 +893,7 @@ het_read_header( HETB *hetb )
     if( hetb->chdr.flags1 & ( HETHDR_FLAGS1_EOR | HETHDR_FLAGS1_TAPEMARK ) )
     {
         hetb->cblk++;
+        het_index_add( hetb );
     }
 
     /*
@@ -780,6 +1010,14 @@ het_read( HETB *hetb, void *sbuf )
     int flags1, flags2;
     char *tbuf;
 
+    /*
+    || Write out blocks still being compressed
+    */
+    if( hetb->cpool && ( rc = het_flush( hetb ) ) < 0 )
+    {
+        return( rc );
+    }
+
     /*
     || Initialize
     */
@@ -998,6 +1236,21 @@ het_read( HETB *hetb, void *sbuf )
             break;
 #endif /* defined( HET_BZIP2 ) */
 
+#if defined( HAVE_ZSTD )
+            case HETHDR_FLAGS1_ZSTD:
+            {
+                size_t zrc = ZSTD_decompress( sbuf, HETMAX_BLOCKSIZE, tbuf, tlen );
+                if( ZSTD_isError( zrc ) )
+                {
+                    free_aligned( tbuf );
+                    return( HETE_DECERR );
+                }
+
+                tlen = (unsigned long) zrc;
+            }
+            break;
+#endif /* defined( HAVE_ZSTD ) */
+
             default:
                 free_aligned( tbuf );
                 return( HETE_UNKMETH );
@@ -1154,6 +1407,14 @@ het_write_header( HETB *hetb, int len, int flags1, int flags2 )
             return( HETE_ERROR );
         }
 
+        /*
+        || Blocks past this one are gone
+        */
+        if( hetb->idxcnt > hetb->cblk + 1 )
+        {
+            hetb->idxcnt = hetb->cblk + 1;
+        }
+
         hetb->truncated = TRUE;
     }
 
@@ -1182,6 +1443,7 @@ het_write_header( HETB *hetb, int len, int flags1, int flags2 )
     if( hetb->chdr.flags1 & ( HETHDR_FLAGS1_EOR | HETHDR_FLAGS1_TAPEMARK ) )
     {
         hetb->cblk++;
+        het_index_add( hetb );
     }
 
     /*
@@ -1190,192 +1452,109 @@ het_write_header( HETB *hetb, int len, int flags1, int flags2 )
     return 0;
 }
 
-/*==DOC==
-
-    NAME
-            het_write - Write a block to an HET file
-
-    SYNOPSIS
-            #include "hetlib.h"
-
-            int het_write( HETB *hetb, void *sbuf, int slen )
-
-    DESCRIPTION
-            Writes a block of data specified by "sbuf" with a length of "slen"
-            to an HET file.  Depending on the current HETCNTL_COMPRESS setting,
-            the data may be compressed prior to writing.
-
-    RETURN VALUE
-            If no errors are detected then the return value will be the
-            size of the block written.  This will be either the compressed or
-            uncompressed length depending on the current AWSCNTL_COMPRESS
-            setting.
-
-            If an error occurs, then the return value will be < 0 and can be
-            one of the following:
-
-            HETE_ERROR          File system error - check errno(3)
-
-            HETE_BADLEN         "slen" parameter out of range
-
-            HETE_BADCOMPRESS    Compression mismatch between related chunks
+/*
+|| Size of the buffer needed to compress a block of "len" bytes: the worst
+|| case expansion of zlib (0.1% + 12), bzip2 (1% + 600) and zstd (0.4% + a
+|| few bytes), rounded up
+*/
+#define HET_CBUFSIZE( len ) ( (len) + ( (len) / 64 ) + 1024 )
 
-            HETE_NOMEM          Insufficient memory to allocate I/O buffer
+/*
+|| Compress a block with the given method and level.  Returns the compressed
+|| length and sets "flags" to the method when the data got smaller, otherwise
+|| returns "slen" and leaves "flags" zero (store the data as is).
+*/
+static int
+het_compress( int method, int level, const void *sbuf, int slen,
+              char *tbuf, unsigned long tsiz, int *flags )
+{
+    int rc;
 
-            For other possible errors, see:
-                het_write_header()
+    unsigned long tlen;
 
-    EXAMPLE
-            //
-            // Create an NL tape and write a string to it
-            //
+#if defined( HET_BZIP2 )
+    unsigned int bz_tlen;
+#endif
 
-            #include "hetlib.h"
+    *flags = 0;
 
-            char data[] = "This is a test";
+    switch( method )
+    {
+#if defined( HAVE_ZLIB )
+        case HETHDR_FLAGS1_ZLIB:
+            tlen = tsiz;
 
-            int main( int argc, char *argv[] )
+            rc = compress2( (unsigned char *)tbuf, &tlen, (void *)sbuf, slen, level );
+            if( rc != Z_OK )
             {
-                HETB *hetb;
-                int rc;
-
-                rc = het_open( &hetb, argv[ 1 ], HETOPEN_CREATE );
-                if( rc >= 0 )
-                {
-                    rc = het_write( hetb, data, sizeof( data ) );
-                    if( rc >= 0 )
-                    {
-                        printf( "Block written - length: %d\n", rc );
-                    }
-                }
-
-                if( rc < 0 )
-                {
-                    printf( "HETLIB error: %d\n", rc );
-                }
+                return( HETE_COMPERR );
+            }
+        break;
+#endif
 
-                het_close( &hetb );
+#if defined( HET_BZIP2 )
+        case HETHDR_FLAGS1_BZLIB:
+            bz_tlen = (unsigned int) tsiz;
+
+            rc = BZ2_bzBuffToBuffCompress( tbuf,
+                                           (void *) &bz_tlen,
+                                           (void *)sbuf,
+                                           slen,
+                                           level,
+                                           0,
+                                           0 );
+            tlen = (unsigned long) bz_tlen;
+
+            if( rc != BZ_OK )
+            {
+                return( HETE_COMPERR );
+            }
+        break;
+#endif /* defined( HET_BZIP2 ) */
 
-                return( 0 );
+#if defined( HAVE_ZSTD )
+        case HETHDR_FLAGS1_ZSTD:
+        {
+            size_t zrc = ZSTD_compress( tbuf, tsiz, sbuf, slen, level );
+            if( ZSTD_isError( zrc ) )
+            {
+                return( HETE_COMPERR );
             }
+            tlen = (unsigned long) zrc;
+        }
+        break;
+#endif /* defined( HAVE_ZSTD ) */
 
-    SEE ALSO
-            het_open(), het_write_header(), het_close()
+        default:
+            return( slen );
+    }
 
-==DOC==*/
+    if( (int)tlen >= slen )
+    {
+        return( slen );
+    }
 
-DLL_EXPORT int
-het_write( HETB *hetb, const void *sbuf, int slen )
+    *flags = method;
+    return( (int)tlen );
+}
+
+/*
+|| Write a (possibly compressed) block, breaking it into "chksize" chunks
+*/
+static int
+het_write_chunks( HETB *hetb, const char *sbuf, int slen, int flags )
 {
     int rc;
-    int flags;
 
     unsigned long tlen;
 
-#if defined( HET_BZIP2 )
-    unsigned int bz_tlen;
-#endif
-
-    char *tbuf = NULL;
-#if defined( HAVE_ZLIB ) || defined( HET_BZIP2 )
-    size_t tsiz = ((((HETMAX_BLOCKSIZE * 1001) + 999) / 1000) + 12);
-    tbuf = malloc_aligned( tsiz, 4096 );
-    if (!tbuf)
-    {
-        return( HETE_NOMEM );
-    }
-#endif
-
-    /*
-    || Validate
-    */
-    if( slen > HETMAX_BLOCKSIZE )
-    {
-        if (tbuf) free_aligned( tbuf );
-        return( HETE_BADLEN );
-    }
+    flags |= HETHDR_FLAGS1_BOR;
 
     /*
-    || Initialize
+    || Save compressed length
     */
-    flags = HETHDR_FLAGS1_BOR;
+    hetb->cblksize = slen;
 
-    /*
-    || Save uncompressed length
-    */
-    hetb->ublksize = slen;
-
-    /*
-    || Compress data if requested
-    */
-    if( hetb->compress )
-    {
-        switch( hetb->method )
-        {
-#if defined( HAVE_ZLIB )
-            case HETHDR_FLAGS1_ZLIB:
-                tlen = tsiz;
-
-                rc = compress2( (unsigned char *)tbuf, &tlen, (void *)sbuf, slen, hetb->level );
-                if( rc != Z_OK )
-                {
-                    rc = errno;
-                    if (tbuf) free_aligned( tbuf );
-                    errno = rc;
-                    return( HETE_COMPERR );
-                }
-
-                if( (int)tlen < slen )
-                {
-                    sbuf = tbuf;
-                    slen = tlen;
-                    flags |= HETHDR_FLAGS1_ZLIB;
-                }
-            break;
-#endif
-
-#if defined( HET_BZIP2 )
-            case HETHDR_FLAGS1_BZLIB:
-                tlen = tsiz;
-
-                bz_tlen = (unsigned int) tlen;
-
-                rc = BZ2_bzBuffToBuffCompress( tbuf,
-                                               (void *) &bz_tlen,
-                                               (void *)sbuf,
-                                               slen,
-                                               hetb->level,
-                                               0,
-                                               0 );
-                tlen = (unsigned long) bz_tlen;
-
-                if( rc != BZ_OK )
-                {
-                    rc = errno;
-                    if (tbuf) free_aligned( tbuf );
-                    errno = rc;
-                    return( HETE_COMPERR );
-                }
-
-                if( (int)tlen < slen )
-                {
-                    sbuf = tbuf;
-                    slen = tlen;
-                    flags |= HETHDR_FLAGS1_BZLIB;
-                }
-            break;
-#endif /* defined( HET_BZIP2 ) */
-        }
-    }
-
-    /*
-    || Save compressed length
-    */
-    hetb->cblksize = slen;
-
-    /*
-    || Write block, breaking it into "chksize" chunks
-    */
     do
     {
         /*
@@ -1397,7 +1576,6 @@ het_write( HETB *hetb, const void *sbuf, int slen )
         rc = het_write_header( hetb, tlen, flags, 0 );
         if( rc < 0 )
         {
-            if (tbuf) free_aligned( tbuf );
             return( rc );
         }
 
@@ -1407,19 +1585,13 @@ het_write( HETB *hetb, const void *sbuf, int slen )
         rc = (int)fwrite( sbuf, 1, tlen, hetb->fh );
         if( rc != (int)tlen )
         {
-            if (tbuf) free_aligned( tbuf );
             return( HETE_ERROR );
         }
 
         /*
-        || Bump pointers and turn off BOR flag
+        || Bump pointer and turn off BOR flag
         */
-        {
-            char    *csbuf;
-            csbuf=(char *)sbuf;
-            csbuf+=tlen;
-            sbuf=(void *)csbuf;
-        }
+        sbuf += tlen;
         slen -= tlen;
         flags &= (~HETHDR_FLAGS1_BOR);
     }
@@ -1432,14 +1604,432 @@ het_write( HETB *hetb, const void *sbuf, int slen )
     while (EINTR == rc);
     if (rc != 0)
     {
-        if (tbuf) free_aligned( tbuf );
         return( HETE_ERROR );
     }
 
+    return( 0 );
+}
+
+/*
+|| Compression worker pool.
+||
+|| het_write() copies each block into the next free job of a ring and
+|| returns.  The workers compress the jobs in the order they were queued
+|| but may finish them in any order; only the thread calling het_write()
+|| writes to the file, always starting with the oldest job, so the file is
+|| exactly what it would have been without the pool.  Every other function
+|| that moves or uses the file position first writes out all queued jobs
+|| by way of het_flush().
+||
+|| An error compressing or writing a job is remembered and returned by the
+|| next het_write() or het_flush(); the jobs queued behind it are dropped.
+*/
+static void *
+het_cpool_thread( void *arg )
+{
+    HETCPOOL *pool = arg;
+    HETCJOB  *job;
+
+    obtain_lock( &pool->lock );
+
+    while( TRUE )
+    {
+        while( !pool->stop && !pool->pending )
+        {
+            wait_condition( &pool->cond, &pool->lock );
+        }
+
+        if( pool->stop )
+        {
+            break;
+        }
+
+        job = &pool->jobs[ pool->next ];
+        pool->next = ( pool->next + 1 ) % pool->njobs;
+        pool->pending--;
+        job->state = HETJOB_BUSY;
+
+        release_lock( &pool->lock );
+
+        job->clen = het_compress( job->method, job->level, job->ubuf,
+                                  job->ulen, job->cbuf, job->cbufsz,
+                                  &job->flags );
+        job->err = errno;
+
+        obtain_lock( &pool->lock );
+
+        job->state = HETJOB_DONE;
+        broadcast_condition( &pool->cond );
+    }
+
+    release_lock( &pool->lock );
+
+    return( NULL );
+}
+
+/*
+|| Write out finished jobs, oldest first, until no more than "keep" are left
+|| (waiting for them if need be), then any others already finished.  Called
+|| with the pool lock held.
+*/
+static void
+het_cpool_put( HETB *hetb, int keep )
+{
+    HETCPOOL *pool = hetb->cpool;
+    HETCJOB  *job;
+    int       rc;
+
+    while( pool->count > 0 )
+    {
+        job = &pool->jobs[ pool->head ];
+
+        if( job->state != HETJOB_DONE )
+        {
+            if( pool->count <= keep )
+            {
+                break;
+            }
+            wait_condition( &pool->cond, &pool->lock );
+            continue;
+        }
+
+        release_lock( &pool->lock );
+
+        /*
+        || Nothing more is written once an error has been found
+        */
+        rc = pool->rc;
+        if( rc == 0 )
+        {
+            if( job->clen < 0 )
+            {
+                rc = job->clen;
+                errno = job->err;
+            }
+            else
+            {
+                hetb->ublksize = job->ulen;
+                if( job->flags )
+                {
+                    rc = het_write_chunks( hetb, job->cbuf, job->clen, job->flags );
+                }
+                else
+                {
+                    rc = het_write_chunks( hetb, job->ubuf, job->ulen, 0 );
+                }
+            }
+        }
+
+        obtain_lock( &pool->lock );
+
+        if( rc < 0 && pool->rc == 0 )
+        {
+            pool->rc  = rc;
+            pool->err = errno;
+        }
+
+        pool->head = ( pool->head + 1 ) % pool->njobs;
+        pool->count--;
+    }
+}
+
+/*
+|| Queue a block for the workers
+*/
+static int
+het_cpool_write( HETB *hetb, const void *sbuf, int slen )
+{
+    HETCPOOL *pool = hetb->cpool;
+    HETCJOB  *job;
+    int       rc;
+
+    obtain_lock( &pool->lock );
+
+    /*
+    || Make room for this block, writing out whatever is ready
+    */
+    het_cpool_put( hetb, pool->njobs - 1 );
+
+    /*
+    || Report an error from an earlier block
+    */
+    if( pool->rc < 0 )
+    {
+        rc = pool->rc;
+        errno = pool->err;
+        pool->rc = 0;
+        release_lock( &pool->lock );
+        return( rc );
+    }
+
+    job = &pool->jobs[ ( pool->head + pool->count ) % pool->njobs ];
+
+    release_lock( &pool->lock );
+
+    /*
+    || Job buffers only ever grow
+    */
+    if( job->ubufsz < (uint32_t)slen )
+    {
+        free_aligned( job->ubuf );
+        free_aligned( job->cbuf );
+        job->ubufsz = job->cbufsz = 0;
+        job->ubuf = malloc_aligned( slen, 4096 );
+        job->cbuf = malloc_aligned( HET_CBUFSIZE( slen ), 4096 );
+        if( !job->ubuf || !job->cbuf )
+        {
+            free_aligned( job->ubuf );
+            free_aligned( job->cbuf );
+            job->ubuf = job->cbuf = NULL;
+            return( HETE_NOMEM );
+        }
+        job->ubufsz = slen;
+        job->cbufsz = HET_CBUFSIZE( slen );
+    }
+
+    memcpy( job->ubuf, sbuf, slen );
+    job->ulen   = slen;
+    job->method = hetb->method;
+    job->level  = hetb->level;
+
+    obtain_lock( &pool->lock );
+
+    job->state = HETJOB_QUEUED;
+    pool->count++;
+    pool->pending++;
+    signal_condition( &pool->cond );
+
+    release_lock( &pool->lock );
+
+    return( slen );
+}
+
+/*
+|| Write out everything queued and stop the workers
+*/
+static int
+het_cpool_free( HETB *hetb )
+{
+    HETCPOOL *pool = hetb->cpool;
+    void     *trc;
+    int       rc;
+    int       i;
+
+    rc = het_flush( hetb );
+
+    obtain_lock( &pool->lock );
+    pool->stop = TRUE;
+    broadcast_condition( &pool->cond );
+    release_lock( &pool->lock );
+
+    for( i = 0; i < pool->nthreads; i++ )
+    {
+        join_thread( pool->tids[ i ], &trc );
+    }
+
+    for( i = 0; i < pool->njobs; i++ )
+    {
+        free_aligned( pool->jobs[ i ].ubuf );
+        free_aligned( pool->jobs[ i ].cbuf );
+    }
+
+    destroy_condition( &pool->cond );
+    destroy_lock( &pool->lock );
+
+    free( pool->jobs );
+    free( pool->tids );
+    free( pool );
+
+    hetb->cpool = NULL;
+
+    return( rc );
+}
+
+/*
+|| Start "nthreads" compression workers
+*/
+static int
+het_cpool_init( HETB *hetb, int nthreads )
+{
+    HETCPOOL *pool;
+    char      name[ 32 ];
+    int       i;
+
+    pool = calloc( 1, sizeof( HETCPOOL ) );
+    if( pool == NULL )
+    {
+        return( HETE_NOMEM );
+    }
+
+    /*
+    || Two jobs per worker so there is always one to be compressed while
+    || the other is written
+    */
+    pool->njobs = nthreads * 2;
+    pool->jobs  = calloc( pool->njobs, sizeof( HETCJOB ) );
+    pool->tids  = calloc( nthreads, sizeof( TID ) );
+    if( pool->jobs == NULL || pool->tids == NULL )
+    {
+        free( pool->jobs );
+        free( pool->tids );
+        free( pool );
+        return( HETE_NOMEM );
+    }
+
+    initialize_lock( &pool->lock );
+    initialize_condition( &pool->cond );
+
+    hetb->cpool = pool;
+
+    for( i = 0; i < nthreads; i++ )
+    {
+        MSGBUF( name, "hetcomp %d", i );
+        if( create_thread( &pool->tids[ i ], JOINABLE,
+                           het_cpool_thread, pool, name ) != 0 )
+        {
+            het_cpool_free( hetb );
+            return( HETE_ERROR );
+        }
+        pool->nthreads++;
+    }
+
+    return( 0 );
+}
+
+/*==DOC==
+
+    NAME
+            het_write - Write a block to an HET file
+
+    SYNOPSIS
+            #include "hetlib.h"
+
+            int het_write( HETB *hetb, void *sbuf, int slen )
+
+    DESCRIPTION
+            Writes a block of data specified by "sbuf" with a length of "slen"
+            to an HET file.  Depending on the current HETCNTL_COMPRESS setting,
+            the data may be compressed prior to writing.
+
+    RETURN VALUE
+            If no errors are detected then the return value will be the
+            size of the block written.  This will be either the compressed or
+            uncompressed length depending on the current AWSCNTL_COMPRESS
+            setting.
+
+            If an error occurs, then the return value will be < 0 and can be
+            one of the following:
+
+            HETE_ERROR          File system error - check errno(3)
+
+            HETE_BADLEN         "slen" parameter out of range
+
+            HETE_BADCOMPRESS    Compression mismatch between related chunks
+
+            HETE_NOMEM          Insufficient memory to allocate I/O buffer
+
+            For other possible errors, see:
+                het_write_header()
+
+    EXAMPLE
+            //
+            // Create an NL tape and write a string to it
+            //
+
+            #include "hetlib.h"
+
+            char data[] = "This is a test";
+
+            int main( int argc, char *argv[] )
+            {
+                HETB *hetb;
+                int rc;
+
+                rc = het_open( &hetb, argv[ 1 ], HETOPEN_CREATE );
+                if( rc >= 0 )
+                {
+                    rc = het_write( hetb, data, sizeof( data ) );
+                    if( rc >= 0 )
+                    {
+                        printf( "Block written - length: %d\n", rc );
+                    }
+                }
+
+                if( rc < 0 )
+                {
+                    printf( "HETLIB error: %d\n", rc );
+                }
+
+                het_close( &hetb );
+
+                return( 0 );
+            }
+
+    SEE ALSO
+            het_open(), het_write_header(), het_close()
+
+==DOC==*/
+
+DLL_EXPORT int
+het_write( HETB *hetb, const void *sbuf, int slen )
+{
+    int rc;
+    int flags;
+
+    char *tbuf;
+
+    /*
+    || Validate
+    */
+    if( slen > HETMAX_BLOCKSIZE )
+    {
+        return( HETE_BADLEN );
+    }
+
+    /*
+    || Hand the block to the compression workers if there are any
+    */
+    if( hetb->compress && hetb->cpool )
+    {
+        return( het_cpool_write( hetb, sbuf, slen ) );
+    }
+
+    /*
+    || Save uncompressed length
+    */
+    hetb->ublksize = slen;
+
+    /*
+    || Compress data if requested
+    */
+    if( !hetb->compress )
+    {
+        rc = het_write_chunks( hetb, sbuf, slen, 0 );
+        return( rc < 0 ? rc : (int)hetb->cblksize );
+    }
+
+    tbuf = malloc_aligned( HET_CBUFSIZE( slen ), 4096 );
+    if (!tbuf)
+    {
+        return( HETE_NOMEM );
+    }
+
+    rc = het_compress( hetb->method, hetb->level, sbuf, slen,
+                       tbuf, HET_CBUFSIZE( slen ), &flags );
+    if( rc >= 0 )
+    {
+        rc = het_write_chunks( hetb, flags ? tbuf : sbuf, rc, flags );
+    }
+
     /*
     || Cleanup
     */
-    if (tbuf) free_aligned( tbuf );
+    free_aligned( tbuf );
+
+    if( rc < 0 )
+    {
+        return( rc );
+    }
 
     /*
     || Success
@@ -1509,6 +2099,14 @@ het_tapemark( HETB *hetb )
 {
     int rc;
 
+    /*
+    || Write out blocks still being compressed
+    */
+    if( hetb->cpool && ( rc = het_flush( hetb ) ) < 0 )
+    {
+        return( rc );
+    }
+
     /*
     || Just write a tapemark header
     */
@@ -1612,6 +2210,14 @@ het_sync( HETB *hetb )
 {
     int rc;
 
+    /*
+    || Write out blocks still being compressed
+    */
+    if( hetb->cpool && ( rc = het_flush( hetb ) ) < 0 )
+    {
+        return( rc );
+    }
+
     /*
     || Can't sync to readonly media
     */
@@ -1636,6 +2242,65 @@ het_sync( HETB *hetb )
     return( 0 );
 }
 
+/*==DOC==
+
+    NAME
+            het_flush - Write out blocks queued for compression
+
+    SYNOPSIS
+            #include "hetlib.h"
+
+            int het_flush( HETB *hetb )
+
+    DESCRIPTION
+            When compression threads are in use (see HETCNTL_THREADS),
+            het_write() only queues the block and returns.  het_flush()
+            waits until every queued block has been compressed and written
+            to the file.  All other functions that use the file position do
+            this first by themselves.
+
+            Without compression threads this function does nothing.
+
+    RETURN VALUE
+            If no errors are detected then the return value will be >= 0.
+
+            If compressing or writing any of the queued blocks failed, then
+            the return value will be < 0 and will be the error of the first
+            block that failed; the blocks queued after it were not written.
+            See het_write() for the possible errors.
+
+    SEE ALSO
+            het_write(), het_cntl()
+
+==DOC==*/
+
+DLL_EXPORT int
+het_flush( HETB *hetb )
+{
+    HETCPOOL *pool = hetb->cpool;
+    int rc;
+
+    if( pool == NULL )
+    {
+        return( 0 );
+    }
+
+    obtain_lock( &pool->lock );
+
+    het_cpool_put( hetb, 0 );
+
+    rc = pool->rc;
+    if( rc < 0 )
+    {
+        errno = pool->err;
+        pool->rc = 0;
+    }
+
+    release_lock( &pool->lock );
+
+    return( rc );
+}
+
 /*==DOC==
 
     NAME
@@ -1650,6 +2315,10 @@ het_sync( HETB *hetb )
             Repositions the HET file to the start of the block specified by
             the "block" parameter.
 
+            Blocks that have already been passed are located directly
+            through the block index.  Otherwise the search continues
+            forward from the highest indexed block, extending the index.
+
     RETURN VALUE
             If no errors are detected then the return value will be >= 0 and
             represents the new current block number.
@@ -1705,9 +2374,29 @@ het_locate( HETB *hetb, int block )
     int rc;
 
     /*
-    || Start the search from the beginning
+    || Write out blocks still being compressed
+    */
+    if( hetb->cpool && ( rc = het_flush( hetb ) ) < 0 )
+    {
+        return( rc );
+    }
+
+    /*
+    || Go straight to the block if it is indexed, otherwise start the search
+    || from the highest block that is
     */
-    rc = het_rewind( hetb );
+    if( hetb->idxcnt > 0 )
+    {
+        if( block >= 0 && (uint32_t)block < hetb->idxcnt )
+        {
+            return( het_index_seek( hetb, block ) );
+        }
+        rc = het_index_seek( hetb, hetb->idxcnt - 1 );
+    }
+    else
+    {
+        rc = het_rewind( hetb );
+    }
     if( rc < 0 )
     {
         return( rc );
@@ -1809,6 +2498,14 @@ het_bsb( HETB *hetb )
                     //  since we only ever seek from SEEK_CUR)
     int tapemark = FALSE;
 
+    /*
+    || Write out blocks still being compressed
+    */
+    if( hetb->cpool && ( rc = het_flush( hetb ) ) < 0 )
+    {
+        return( rc );
+    }
+
     /*
     || Error if at BOT
     */
@@ -1830,6 +2527,23 @@ het_bsb( HETB *hetb )
         return( het_rewind( hetb ) );
     }
 
+    /*
+    || If the current block is indexed, so is the previous one
+    */
+    if( hetb->cblk < hetb->idxcnt )
+    {
+        tapemark = ( hetb->idx[ hetb->cblk ].tapemarks !=
+                     hetb->idx[ newblk ].tapemarks );
+
+        rc = het_index_seek( hetb, newblk );
+        if( rc < 0 )
+        {
+            return( rc );
+        }
+
+        return( tapemark ? HETE_TAPEMARK : (int)hetb->cblk );
+    }
+
     /*
     || Calculate offset to get back to beginning of current block
     */
@@ -1998,6 +2712,14 @@ het_fsb( HETB *hetb )
 {
     int rc;
 
+    /*
+    || Write out blocks still being compressed
+    */
+    if( hetb->cpool && ( rc = het_flush( hetb ) ) < 0 )
+    {
+        return( rc );
+    }
+
     /*
     || Loop until we've processed an entire block
     */
@@ -2102,6 +2824,34 @@ DLL_EXPORT int
 het_bsf( HETB *hetb )
 {
     int rc;
+    uint32_t blk;
+
+    /*
+    || Write out blocks still being compressed
+    */
+    if( hetb->cpool && ( rc = het_flush( hetb ) ) < 0 )
+    {
+        return( rc );
+    }
+
+    /*
+    || If the current block is indexed, find the previous tapemark in the
+    || index.  As with het_bsb(), a tapemark in block 0 is not reported.
+    */
+    if( hetb->cblk < hetb->idxcnt )
+    {
+        for( blk = hetb->cblk; blk > 1; blk-- )
+        {
+            if( hetb->idx[ blk ].tapemarks != hetb->idx[ blk - 1 ].tapemarks )
+            {
+                rc = het_index_seek( hetb, blk - 1 );
+                return( rc < 0 ? rc : HETE_TAPEMARK );
+            }
+        }
+
+        rc = het_rewind( hetb );
+        return( rc < 0 ? rc : HETE_BOT );
+    }
 
     /*
     || Backspace block until we either BSB over a tapemark or reach BOT
@@ -2182,6 +2932,39 @@ DLL_EXPORT int
 het_fsf( HETB *hetb )
 {
     int rc;
+    uint32_t blk;
+
+    /*
+    || Write out blocks still being compressed
+    */
+    if( hetb->cpool && ( rc = het_flush( hetb ) ) < 0 )
+    {
+        return( rc );
+    }
+
+    /*
+    || Look for the next tapemark in the index first.  If there isn't one,
+    || continue spacing forward from the highest indexed block.
+    */
+    if( hetb->cblk < hetb->idxcnt )
+    {
+        for( blk = hetb->cblk + 1; blk < hetb->idxcnt; blk++ )
+        {
+            if( hetb->idx[ blk ].tapemarks != hetb->idx[ blk - 1 ].tapemarks )
+            {
+                return( het_index_seek( hetb, blk ) );
+            }
+        }
+
+        if( hetb->cblk < hetb->idxcnt - 1 )
+        {
+            rc = het_index_seek( hetb, hetb->idxcnt - 1 );
+            if( rc < 0 )
+            {
+                return( rc );
+            }
+        }
+    }
 
     /*
     || Forward space until we hit a tapemark
@@ -2271,6 +3054,14 @@ het_rewind( HETB *hetb )
 {
     int rc;
 
+    /*
+    || Write out blocks still being compressed
+    */
+    if( hetb->cpool && ( rc = het_flush( hetb ) ) < 0 )
+    {
+        return( rc );
+    }
+
     /*
     || Just seek to the beginning of the file
     */
@@ -2430,10 +3221,99 @@ DLL_EXPORT
 off_t
 het_tell( HETB *hetb )
 {
-    off_t rwptr = ftell( hetb->fh );
+    off_t rwptr;
+    int   rc;
+
+    /*
+    || Write out blocks still being compressed
+    */
+    if( hetb->cpool && ( rc = het_flush( hetb ) ) < 0 )
+    {
+        return( rc );
+    }
+
+    rwptr = ftell( hetb->fh );
     if ( rwptr < 0 )
     {
         return HETE_ERROR;
     }
     return rwptr;
 }
+
+/*==DOC==
+
+    NAME
+            het_tapemarks - Count the tapemarks preceding a block
+
+    SYNOPSIS
+            #include "hetlib.h"
+
+            int het_tapemarks( HETB *hetb, int block )
+
+    DESCRIPTION
+            Returns the number of tapemarks in blocks 0 through "block"-1,
+            as recorded in the block index.  Adding one gives the file
+            number of the file containing "block".
+
+    RETURN VALUE
+            If the block is covered by the block index then the return
+            value will be >= 0 and is the number of tapemarks.
+
+            If the block has not yet been passed (and so is not indexed),
+            the return value will be HETE_BADLOC.
+
+    NOTES
+            Every block up to the highest one read, written or spaced
+            over since the file was opened is indexed.
+
+    EXAMPLE
+            //
+            // Determine the file number after locating block #4
+            //
+
+            #include "hetlib.h"
+
+            int main( int argc, char *argv[] )
+            {
+                HETB *hetb;
+                int rc;
+
+                rc = het_open( &hetb, argv[ 1 ], 0 );
+                if( rc >= 0 )
+                {
+                    rc = het_locate( hetb, 4 );
+                    if( rc >= 0 )
+                    {
+                        rc = het_tapemarks( hetb, rc );
+                        if( rc >= 0 )
+                        {
+                            printf( "File number: %d\n", rc + 1 );
+                        }
+                    }
+                }
+
+                if( rc < 0 )
+                {
+                    printf( "HETLIB error: %d\n", rc );
+                }
+
+                het_close( &hetb );
+
+                return( 0 );
+            }
+
+    SEE ALSO
+            het_open(), het_locate(), het_close()
+
+==DOC==*/
+
+DLL_EXPORT int
+het_tapemarks( HETB *hetb, int block )
+{
+    if( block < 0 || (uint32_t)block >= hetb->idxcnt )
+    {
+        return( HETE_BADLOC );
+    }
+
+    return( (int)hetb->idx[ block ].tapemarks );
+}
@@ -51,6 +51,7 @@ typedef struct _hethdr
 #define HETHDR_FLAGS1_TAPEMARK  0x40    /* Tape mark                        */
 #define HETHDR_FLAGS1_EOR       0x20    /* End of record                    */
 #define HETHDR_FLAGS1_COMPRESS  0x03    /* Compression method mask          */
+#define HETHDR_FLAGS1_ZSTD      0x03    /* ZSTD compression                 */
 #define HETHDR_FLAGS1_BZLIB     0x02    /* BZLIB compression                */
 #define HETHDR_FLAGS1_ZLIB      0x01    /* ZLIB compression                 */
 
@@ -60,6 +61,21 @@ typedef struct _hethdr
 #define HETHDR_FLAGS2_COMPRESS     0x80 /* Compression method mask          */
 #define HETHDR_FLAGS2_ZLIB_BUSTECH 0x80 /* Bus-Tech ZLIB compression        */
 
+/*
+|| Block index entry.  Entry n locates block n by way of the chunk header that
+|| ends block n-1, which must be reloaded to keep the chdr in the HETB valid.
+*/
+typedef struct _hetidx
+{
+    off_t           hdrpos;             /* Offset of last header of blk n-1 */
+    uint32_t        tapemarks;          /* Tapemarks in blocks 0 to n-1     */
+} HETIDX;
+
+/*
+|| Compression worker pool (see het_cntl() HETCNTL_THREADS)
+*/
+typedef struct _hetcpool HETCPOOL;
+
 /*
 || Control block for Hercules Emulated Tape files
 */
@@ -77,9 +93,14 @@ typedef struct _hetb
     u_int           truncated:1;        /* TRUE=file truncated              */
     u_int           compress:1;         /* TRUE=compress written data       */
     u_int           decompress:1;       /* TRUE=decompress read data        */
-    u_int           method:2;           /* 1=ZLIB, 2=BZLIB compresion       */
-    u_int           level:4;            /* 1=<n<=9 compression level        */
+    u_int           method:2;           /* 1=ZLIB, 2=BZLIB, 3=ZSTD          */
+    u_int           level:5;            /* 1=<n<=9 (ZSTD 19) compress level */
     u_int           created:1;          /* TRUE = CREATED                   */
+    HETIDX         *idx;                /* Block index, built as blocks are */
+                                        /* passed; NULL until first block   */
+    uint32_t        idxcnt;             /* Blocks 0 to idxcnt-1 are indexed */
+    uint32_t        idxmax;             /* Entries allocated in idx         */
+    HETCPOOL       *cpool;              /* Compression workers, NULL=none   */
 } HETB;
 
 /*
@@ -87,22 +108,47 @@ typedef struct _hetb
 */
 #define HETMETH_ZLIB            1       /* ZLIB compression                 */
 #define HETMETH_BZLIB           2       /* BZLIB compression                */
+#define HETMETH_ZSTD            3       /* ZSTD compression                 */
 
 /*
 || Limits
 */
 #define HETMIN_METHOD           1       /* Minimum compression method       */
-#if defined( HET_BZIP2 )
-#define HETMAX_METHOD           2       /* Maximum compression method       */
-#else
-#define HETMAX_METHOD           1       /* Maximum compression method       */
-#endif /* defined( HET_BZIP2 ) */
+#define HETMAX_METHOD           3       /* Maximum compression method       */
 #define HETMIN_LEVEL            1       /* Minimum compression level        */
 #define HETMAX_LEVEL            9       /* Maximum compression level        */
+#define HETMAX_ZSTD_LEVEL       19      /* Maximum ZSTD compression level   */
 #define HETMIN_CHUNKSIZE        4096    /* Minimum chunksize                */
 #define HETMAX_CHUNKSIZE        65535   /* Maximum chunksize                */
 #define HETMIN_BLOCKSIZE        1       /* Minimum blocksize                */
 #define HETMAX_BLOCKSIZE        2097152 /* Maximum blocksize = 2MB          */
+#define HETMAX_THREADS          64      /* Maximum compression threads      */
+
+/*
+|| Compression methods compiled in, and the highest level of each
+*/
+#if defined( HAVE_ZLIB )
+#define HET_HAVE_ZLIB           1
+#else
+#define HET_HAVE_ZLIB           0
+#endif
+#if defined( HET_BZIP2 )
+#define HET_HAVE_BZLIB          1
+#else
+#define HET_HAVE_BZLIB          0
+#endif
+#if defined( HAVE_ZSTD )
+#define HET_HAVE_ZSTD           1
+#else
+#define HET_HAVE_ZSTD           0
+#endif
+
+#define HET_METHOD_OK( m )      ( ( (m) == HETMETH_ZLIB  && HET_HAVE_ZLIB  ) \
+                               || ( (m) == HETMETH_BZLIB && HET_HAVE_BZLIB ) \
+                               || ( (m) == HETMETH_ZSTD  && HET_HAVE_ZSTD  ) )
+
+#define HETMAX_METHOD_LEVEL( m ) ( (m) == HETMETH_ZSTD ? HETMAX_ZSTD_LEVEL \
+                                                      : HETMAX_LEVEL )
 
 /*
 || Default settings
@@ -133,6 +179,7 @@ typedef struct _hetb
 #define HETCNTL_METHOD          3       /* Compression method               */
 #define HETCNTL_LEVEL           4       /* Compression level                */
 #define HETCNTL_CHUNKSIZE       5       /* Chunk size                       */
+#define HETCNTL_THREADS         6       /* Compression threads, 0=none      */
 
 /*
 || Error definitions
@@ -161,7 +208,8 @@ typedef struct _hetb
 #define HETE_BADHDR             -21     /* Couldn't read block header       */
 #define HETE_BADCOMPRESS        -22     /* Inconsistent compression flags   */
 #define HETE_BADBLOCK           -23     // unused
-#define HETE_BADLOC             -24     // unused
+#define HETE_BADLOC             -24     /* Block not in index               */
+#define HETE_BADTHREADS         -25     /* Bad compression thread count     */
 
 /*
 || Public functions
@@ -174,6 +222,7 @@ HET_DLL_IMPORT int het_write_header( HETB *hetb, int len, int flags1, int flags2
 HET_DLL_IMPORT int het_write( HETB *hetb, const void *sbuf, int slen );
 HET_DLL_IMPORT int het_tapemark( HETB *hetb );
 HET_DLL_IMPORT int het_sync( HETB *hetb );
+HET_DLL_IMPORT int het_flush( HETB *hetb );
 HET_DLL_IMPORT int het_cntl( HETB *hetb, int func, unsigned long val );
 HET_DLL_IMPORT int het_locate( HETB *hetb, int block );
 HET_DLL_IMPORT int het_bsb( HETB *hetb );
@@ -183,5 +232,6 @@ HET_DLL_IMPORT int het_fsf( HETB *hetb );
 HET_DLL_IMPORT int het_rewind( HETB *hetb );
 HET_DLL_IMPORT const char *het_error( int rc );
 HET_DLL_IMPORT off_t het_tell ( HETB *hetb );
+HET_DLL_IMPORT int het_tapemarks( HETB *hetb, int block );
 
 #endif /* defined( _HETLIB_H_ ) */
@@ -209,6 +209,8 @@ main( int argc, char *argv[] )
     U32  totblocks;
     U64  totubytes;
     U64  totcbytes;
+    U32  fblock;
+    off_t fpos;
     U32  opts = 0;
     SInt32  lResidue    = max_bytes_dsply;  /* amount of space left to print */
     char *pgm;
@@ -331,6 +333,9 @@ main( int argc, char *argv[] )
     totubytes = 0;
     totcbytes = 0;
 
+    fblock = 0;
+    fpos = 0;
+
     while( TRUE )
     {
         if( extgui )
@@ -379,6 +384,8 @@ main( int argc, char *argv[] )
             {
                 printf ( "%s", sep );
                 printf ( "%-20.20s: %d\n", "File #", (int)fileno );
+                printf ( "%-20.20s: %u\n", "First block id", (unsigned)fblock );
+                printf ( "%-20.20s: %"PRId64"\n", "File offset", (U64)fpos );
                 printf ( "%-20.20s: %d\n", "Blocks", (int)gBlkCount );
                 printf ( "%-20.20s: %d\n", "Min Blocksize", (int)uminsz );
                 printf ( "%-20.20s: %d\n", "Max Blocksize", (int)umaxsz );
@@ -398,6 +405,18 @@ main( int argc, char *argv[] )
             gPrevBlkCnt = gBlkCount;
             gBlkCount = 0;
 
+            /* Where the next file starts, for Locate Block */
+            if ( i_faketape )
+            {
+                fblock = fetb->blockid;
+                fpos = fetb->nxtblkpos;
+            }
+            else
+            {
+                fblock = hetb->cblk;
+                fpos = het_tell( hetb );
+            }
+
             uminsz = 0;
             umaxsz = 0;
             ubytes = 0;
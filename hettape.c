@@ -83,6 +83,12 @@ DLL_EXPORT int open_het( DEVBLK* dev, BYTE* unitstat, BYTE code )
                 {
                     rc = het_cntl( dev->hetb, HETCNTL_SET | HETCNTL_CHUNKSIZE,
                         dev->tdparms.chksize );
+
+                    if (rc >= 0)
+                    {
+                        rc = het_cntl( dev->hetb, HETCNTL_SET | HETCNTL_THREADS,
+                            dev->tdparms.cthreads );
+                    }
                 }
             }
         }
@@ -121,10 +127,42 @@ DLL_EXPORT int open_het( DEVBLK* dev, BYTE* unitstat, BYTE code )
             // "%1d:%04X Tape file %s, type %s: tape created"
             WRMSG( HHC00235, "I", LCSS_DEVNUM, dev->filename, "het" );
     }
+    tapestrm_open( dev );
     return 0;
 
 } /* end function open_het */
 
+/*-------------------------------------------------------------------*/
+/* Write out blocks still queued for compression ("cthreads=n")      */
+/*                                                                   */
+/* If a queued block could not be written the error is reported and  */
+/* the return value is -1, with unitstat set to CE+DE+UC if given.   */
+/*-------------------------------------------------------------------*/
+static int flush_het( DEVBLK* dev, BYTE* unitstat, BYTE code )
+{
+int             rc;                     /* Return code               */
+int             err;                    /* errno from het_flush      */
+
+    if (!dev->hetb || !dev->hetb->cpool)
+        return 0;
+
+    if ((rc = het_flush( dev->hetb )) < 0)
+    {
+        char msgbuf[128];
+        err = errno;
+        MSGBUF( msgbuf, "Het error '%s': '%s'", het_error( rc ), strerror( err ));
+        // "%1d:%04X Tape file %s, type %s: error in function %s, offset 0x%16.16"PRIX64": %s"
+        WRMSG( HHC00204, "E", LCSS_DEVNUM, dev->filename, "het", "het_write()", (off_t) dev->hetb->cblk, msgbuf );
+
+        if (unitstat)
+            build_senseX( ENOSPC == err ? TAPE_BSENSE_ENDOFTAPE
+                                        : TAPE_BSENSE_WRITEFAIL, dev, unitstat, code );
+        return -1;
+    }
+
+    return 0;
+}
+
 /*-------------------------------------------------------------------*/
 /* Close an HET format file                                          */
 /*                                                                   */
@@ -132,6 +170,9 @@ DLL_EXPORT int open_het( DEVBLK* dev, BYTE* unitstat, BYTE code )
 /*-------------------------------------------------------------------*/
 DLL_EXPORT void close_het( DEVBLK* dev )
 {
+    tapestrm_close( dev );
+    flush_het( dev, NULL, 0 );
+
     if (dev->fd >= 0)
     {
         if (!dev->batch || !dev->quiet)
@@ -156,6 +197,9 @@ DLL_EXPORT void close_het( DEVBLK* dev )
 DLL_EXPORT int rewind_het(DEVBLK *dev,BYTE *unitstat,BYTE code)
 {
 int rc;
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0
+     || flush_het( dev, unitstat, code ) < 0)
+        return -1;
     rc = het_rewind (dev->hetb);
     if (rc < 0)
     {
@@ -187,7 +231,15 @@ DLL_EXPORT int read_het (DEVBLK *dev, BYTE *buf, BYTE *unitstat,BYTE code)
 {
 int             rc;                     /* Return code               */
 
-    rc = het_read (dev->hetb, buf);
+    /* Present any deferred write error first */
+    if (tapestrm_flush( dev, unitstat, code ) < 0
+     || flush_het( dev, unitstat, code ) < 0)
+        return -1;
+
+    if (dev->tapestrm)
+        rc = tapestrm_het_read (dev, buf);
+    else
+        rc = het_read (dev->hetb, buf);
     if (rc < 0)
     {
         /* Increment file number and return zero if tapemark was read */
@@ -250,8 +302,13 @@ off_t           cursize;                /* Current size for size chk */
         }
     }
 
-    /* Write the data block */
-    if ((rc = het_write( dev->hetb, buf, blklen )) < 0)
+    /* Write the data block (queued for the helper when streaming) */
+    if (dev->tapestrm)
+        rc = tapestrm_het_write( dev, buf, blklen );
+    else
+        rc = het_write( dev->hetb, buf, blklen );
+
+    if (rc < 0)
     {
         /* Handle write error condition */
         char msgbuf[128];
@@ -313,6 +370,11 @@ int             rc;                     /* Return code               */
         return -1;
     }
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0
+     || flush_het( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Write the tape mark */
     rc = het_tapemark (dev->hetb);
     if (rc < 0)
@@ -344,6 +406,11 @@ DLL_EXPORT int sync_het(DEVBLK *dev, BYTE *unitstat,BYTE code)
 {
 int             rc;                     /* Return code               */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0
+     || flush_het( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Perform the flush */
     rc = het_sync (dev->hetb);
     if (rc < 0)
@@ -376,6 +443,11 @@ DLL_EXPORT int fsb_het (DEVBLK *dev, BYTE *unitstat,BYTE code)
 {
 int             rc;                     /* Return code               */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0
+     || flush_het( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Forward space one block */
     rc = het_fsb (dev->hetb);
 
@@ -430,6 +502,11 @@ DLL_EXPORT int bsb_het (DEVBLK *dev, BYTE *unitstat,BYTE code)
 {
 int             rc;                     /* Return code               */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0
+     || flush_het( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Back space one block */
     rc = het_bsb (dev->hetb);
     if (rc < 0)
@@ -477,6 +554,11 @@ DLL_EXPORT int fsf_het (DEVBLK *dev, BYTE *unitstat,BYTE code)
 {
 int             rc;                     /* Return code               */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0
+     || flush_het( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Forward space to start of next file */
     rc = het_fsf (dev->hetb);
     if (rc < 0)
@@ -542,6 +624,11 @@ DLL_EXPORT int bsf_het (DEVBLK *dev, BYTE *unitstat,BYTE code)
 {
 int             rc;                     /* Return code               */
 
+    /* Write out any buffered blocks first */
+    if (tapestrm_quiesce( dev, unitstat, code ) < 0
+     || flush_het( dev, unitstat, code ) < 0)
+        return -1;
+
     /* Error if already at load point */
     if (dev->curfilen == 1 && dev->hetb->cblk == 0)
     {
@@ -44,6 +44,8 @@ static int o_decompress = HETDFLT_DECOMPRESS;
 static int o_compress   = HETDFLT_COMPRESS;
 static int o_level      = HETDFLT_LEVEL;
 static int o_method     = HETDFLT_METHOD;
+static int o_threads    = 0;
+static int o_bench      = FALSE;
 static int o_verbose    = FALSE;
 static char *o_sname    = NULL;
 static char *o_dname    = NULL;
@@ -54,6 +56,7 @@ static HETB *s_hetb     = NULL;
 static FETB *s_fetb     = NULL;
 static HETB *d_hetb     = NULL;
 static FETB *d_fetb     = NULL;
+static U64 u_bytes      = 0;
 
 /* Previous reported file position */
 static off_t prevpos = 0;
@@ -67,12 +70,17 @@ static void
 usage( char *name )
 {
 #if defined( HET_BZIP2 )
-    char *bufbz = "                -b    use BZLIB compression\n";
+    char *bufbz = "      -b    use BZLIB compression\n";
 #else
-    char *bufbz = "";
+    char *bufbz = "\n";
+#endif
+#if defined( HAVE_ZSTD )
+    char *bufzs = "      -Z    use ZSTD compression\n";
+#else
+    char *bufzs = "\n";
 #endif
     // "Usage: %s ...
-    WRMSG( HHC02730, "I", name, bufbz );
+    WRMSG( HHC02730, "I", name, bufbz, bufzs );
 }
 
 /*
@@ -190,6 +198,8 @@ copytape( void )
             break;
         }
 
+        u_bytes += rc;
+
         if ( o_faketape )
             rc = fet_write( d_fetb, buf, rc );
         else
@@ -205,6 +215,13 @@ copytape( void )
         }
     }
 
+    /* Write out blocks still being compressed */
+    if( rc >= 0 && !o_faketape && ( rc = het_flush( d_hetb ) ) < 0 )
+    {
+        // "Error in function %s: %s"
+        FWRMSG( stderr, HHC00075, "E", "het_write()", het_error( rc ) );
+    }
+
     return( rc );
 }
 
@@ -335,6 +352,23 @@ opentapes( void )
                 FWRMSG( stderr, HHC00075, "E", "het_cntl()", het_error( rc ) );
             goto exit;
         }
+
+        if ( o_verbose )
+        {
+            char msgbuf[16];
+            MSGBUF( msgbuf, "%d", o_threads );
+            // "HET: Setting option %s to %s"
+            WRMSG( HHC02755, "I", "threads", msgbuf );
+        }
+
+        rc = het_cntl( d_hetb, HETCNTL_SET | HETCNTL_THREADS, o_threads );
+        if( rc < 0 )
+        {
+            if ( o_verbose )
+                // "Error in function %s: %s"
+                FWRMSG( stderr, HHC00075, "E", "het_cntl()", het_error( rc ) );
+            goto exit;
+        }
     }
 
     if( o_verbose )
@@ -360,6 +394,8 @@ opentapes( void )
             WRMSG( HHC02757, "I", msgbuf );
             MSGBUF( msgbuf, "Compression level  : %d", het_cntl( d_hetb, HETCNTL_LEVEL, 0 ) );
             WRMSG( HHC02757, "I", msgbuf );
+            MSGBUF( msgbuf, "Compress threads   : %d", het_cntl( d_hetb, HETCNTL_THREADS, 0 ) );
+            WRMSG( HHC02757, "I", msgbuf );
         }
     }
 
@@ -368,6 +404,108 @@ exit:
     return( rc );
 }
 
+/*
+|| Seconds since the epoch, for the benchmark
+*/
+static double
+seconds( void )
+{
+    struct timeval tv;
+
+    gettimeofday( &tv, NULL );
+    return( tv.tv_sec + tv.tv_usec / 1000000.0 );
+}
+
+/*
+|| Copy the source with each compression method in turn, read the copy back
+|| and report the compression ratio and both speeds (uncompressed MB/s)
+*/
+static int
+benchtape( void )
+{
+    static const struct
+    {
+        const char *name;
+        int         compress;
+        int         method;
+    }
+    meths[] =
+    {
+        { "none",  FALSE, HETMETH_ZLIB  },
+#if defined( HAVE_ZLIB )
+        { "zlib",  TRUE,  HETMETH_ZLIB  },
+#endif
+#if defined( HET_BZIP2 )
+        { "bzip2", TRUE,  HETMETH_BZLIB },
+#endif
+#if defined( HAVE_ZSTD )
+        { "zstd",  TRUE,  HETMETH_ZSTD  },
+#endif
+    };
+
+    double  t0, t1, t2;
+    U64     c_bytes;
+    int     level;
+    int     rc = 0;
+    int     i;
+
+    level = o_level;
+
+    for( i = 0; i < (int)_countof( meths ); i++ )
+    {
+        o_compress = meths[ i ].compress;
+        o_method   = meths[ i ].method;
+        o_level    = ( o_method != HETMETH_ZSTD && level > HETMAX_LEVEL )
+                   ? HETMAX_LEVEL : level;
+        u_bytes    = 0;
+
+        rc = opentapes();
+        if( rc < 0 )
+        {
+            // "HET: HETLIB reported error %s files; %s"
+            FWRMSG( stderr, HHC02756, "E", "opening", het_error( rc ) );
+            break;
+        }
+
+        /* Write the copy */
+        t0 = seconds();
+        rc = copytape();
+        t1 = seconds();
+
+        c_bytes = (U64) het_tell( d_hetb );
+
+        /* Read it back */
+        if( rc >= 0 )
+            rc = het_rewind( d_hetb );
+
+        while( rc >= 0 || rc == HETE_TAPEMARK )
+            rc = het_read( d_hetb, buf );
+
+        t2 = seconds();
+
+        if( rc == HETE_EOT )
+            rc = 0;
+
+        closetapes( rc );
+        remove( o_dname );
+
+        if( rc < 0 )
+        {
+            // "HET: HETLIB reported error %s files; %s"
+            FWRMSG( stderr, HHC02756, "E", "copying", het_error( rc ) );
+            break;
+        }
+
+        // "%-5s level %2d: %"PRIu64" bytes to %"PRIu64" (ratio %.2f), write %.1f MB/s, read %.1f MB/s"
+        WRMSG( HHC02734, "I", meths[ i ].name, o_compress ? o_level : 0,
+            u_bytes, c_bytes, c_bytes ? (double) u_bytes / c_bytes : 0.0,
+            u_bytes / ( 1024.0 * 1024.0 ) / MAX( t1 - t0, 1e-6 ),
+            u_bytes / ( 1024.0 * 1024.0 ) / MAX( t2 - t1, 1e-6 ));
+    }
+
+    return( rc );
+}
+
 /*
 || Standard main
 */
@@ -382,11 +520,14 @@ main( int argc, char *argv[] )
 
     while( TRUE )
     {
+        rc = getopt( argc, argv, "c:dhl:rst:vz0123456789B"
 #if defined( HET_BZIP2 )
-        rc = getopt( argc, argv, "bc:dhrsvz0123456789" );
-#else
-        rc = getopt( argc, argv, "c:dhrsvz0123456789" );
-#endif /* defined( HET_BZIP2 ) */
+                                 "b"
+#endif
+#if defined( HAVE_ZSTD )
+                                 "Z"
+#endif
+                   );
         if( rc == -1 )
         {
             break;
@@ -421,6 +562,10 @@ main( int argc, char *argv[] )
                 usage( pgm );
                 return 1;
 
+            case 'l':                               /* Compression level    */
+                o_level = atoi( optarg );
+            break;
+
             case 'r':                               /* Rechunk              */
                 o_compress = FALSE;
                 o_decompress = FALSE;
@@ -432,6 +577,10 @@ main( int argc, char *argv[] )
                 o_decompress = TRUE;
             break;
 
+            case 't':                               /* Compression threads  */
+                o_threads = atoi( optarg );
+            break;
+
             case 'v':                               /* Be chatty            */
                 o_verbose = TRUE;
             break;
@@ -442,6 +591,18 @@ main( int argc, char *argv[] )
                 o_decompress = TRUE;
             break;
 
+#if defined( HAVE_ZSTD )
+            case 'Z':                               /* Use ZSTD compression */
+                o_method = HETMETH_ZSTD;
+                o_compress = TRUE;
+                o_decompress = TRUE;
+            break;
+#endif /* defined( HAVE_ZSTD ) */
+
+            case 'B':                               /* Benchmark methods    */
+                o_bench = TRUE;
+            break;
+
             default:                                /* Print usage          */
                 usage( pgm );
                 return 1;
@@ -455,10 +616,15 @@ main( int argc, char *argv[] )
         case 1:
             sprintf( toname, "%s.%010d", argv[ optind ], rand() );
             o_dname = toname;
-            dorename = TRUE;
+            dorename = !o_bench;
         break;
 
         case 2:
+            if( o_bench )                   /* (uses a scratch copy)    */
+            {
+                usage( pgm );
+                return 1;
+            }
             o_dname = argv[ optind + 1 ];
         break;
 
@@ -468,6 +634,12 @@ main( int argc, char *argv[] )
     }
     o_sname = argv[ optind ] ;
 
+    if( o_bench )
+    {
+        benchtape();
+        return 0;
+    }
+
     rc = opentapes();
     if( rc < 0 )
     {
@@ -66,6 +66,7 @@ int  configure_maxcpu (int maxcpu);
 int  configure_memlock(int);
 int  configure_memfree(int);
 int  configure_storage( U64 /* number of 4K pages */ );
+int  configure_numa( void );
 int  configure_xstorage(U64);
 U64  adjust_mainsize( int archnum, U64 mainsize );
 
@@ -255,6 +256,21 @@ void* timer_thread( void* argp );
 void* rubato_thread( void* argp );
 #endif
 
+/* Functions in module hprof.c */
+void hprof_sample( U64 now );
+int  hprof_command( int argc, char* argv[] );
+
+/* Functions in module hsimd.c */
+void   hsimd_init();
+size_t hsimd_clst( const BYTE* a, const BYTE* b, size_t n, BYTE term );
+size_t hsimd_first_equ( const BYTE* a, const BYTE* b, size_t n );
+size_t hsimd_last_neq( const BYTE* a, const BYTE* b, size_t n );
+size_t hsimd_find_hw( const BYTE* p, size_t n, U16 c );
+size_t hsimd_trt( const BYTE* p, size_t n, const BYTE* fct );
+size_t hsimd_trtr( const BYTE* p, size_t n, const BYTE* fct );
+size_t hsimd_utf( BYTE* d, int dsz, const BYTE* s, int ssz, size_t n );
+void   hsimd_stream_page( BYTE* d, const BYTE* s );
+
 /* Functions in module clock.c */
 void update_TOD_clock (void);
 int configure_epoch(int);
@@ -298,6 +314,20 @@ void ckd_dasd_query_device (DEVBLK *dev, char **devclass,
                 int buflen, char *buffer);
 int ckd_dasd_hsuspend ( DEVBLK *dev, void *file );
 int ckd_dasd_hresume  ( DEVBLK *dev, void *file );
+int  dasd_wb_parm     ( DEVBLK *dev, BYTE type, const char *parm );
+void dasd_wb_queue    ( DEVBLK *dev, int ix );
+int  dasd_wb_error    ( DEVBLK *dev );
+void dasd_wb_flush    ( DEVBLK *dev );
+void dasd_wb_wait     ( int ix );
+void dasd_wb_flush_all();
+int  dasd_wb_writers  ( int wrmax );
+void dasd_wb_stats    ( U64 *writes, U64 *images, U64 *bytes, U64 *syncs );
+int  dasd_map_parm    ( DEVBLK *dev, const char *parm );
+void dasd_map_open    ( DEVBLK *dev, BYTE type );
+BYTE *dasd_map_image  ( DEVBLK *dev, int f, U64 off, int len, int img );
+void dasd_map_update  ( DEVBLK *dev, BYTE *buf, int len );
+void dasd_map_sync    ( DEVBLK *dev );
+void dasd_map_close   ( DEVBLK *dev );
 
 /* Functions in module fbadasd.c */
 FBA_DLL_IMPORT void fbadasd_syncblk_io (DEVBLK *dev, BYTE type, int blknum,
@@ -448,6 +478,8 @@ CHAN_DLL_IMPORT int  Dequeue_IO_Interrupt         (IOINT* io,            const c
 CHAN_DLL_IMPORT int  Dequeue_IO_Interrupt_QLocked (IOINT* io,            const char* location);
 CHAN_DLL_IMPORT void Update_IC_IOPENDING          ();
 CHAN_DLL_IMPORT void Update_IC_IOPENDING_QLocked  ();
+CHAN_DLL_IMPORT IOINT* Next_IO_Interrupt_QLocked  (IOINT* io);
+CHAN_DLL_IMPORT void Sample_IO_Interrupt_QLocked  (IOINT* io);
 
 #define QUEUE_IO_INTERRUPT( io, clrbsy )          (void)Queue_IO_Interrupt( (IOINT*)(io), (U8)(clrbsy), PTT_LOC )
 #define QUEUE_IO_INTERRUPT_QLOCKED( io, clrbsy )  (void)Queue_IO_Interrupt_QLocked( (IOINT*)(io), (U8)(clrbsy), PTT_LOC )
@@ -455,6 +487,7 @@ CHAN_DLL_IMPORT void Update_IC_IOPENDING_QLocked  ();
 #define DEQUEUE_IO_INTERRUPT_QLOCKED( io )        (int)Dequeue_IO_Interrupt_QLocked( (IOINT*)(io), PTT_LOC )
 #define UPDATE_IC_IOPENDING()                     (void)Update_IC_IOPENDING()
 #define UPDATE_IC_IOPENDING_QLOCKED()             (void)Update_IC_IOPENDING_QLocked()
+#define NEXT_IO_INTERRUPT_QLOCKED( io )           Next_IO_Interrupt_QLocked( (IOINT*)(io) )
 
 /* Functions in module dat.c */
 
@@ -266,6 +266,24 @@ static inline void synchronize_cpus( REGS* regs, const char* location )
 
 static inline void wakeup_cpu( REGS* regs, const char* location )
 {
+    U32  old = regs->wakeword;
+
+    /* Post the wakeup word of a CPU in the adaptive wait, noting when
+     * it was first posted. Only a CPU which has stopped spinning and
+     * gone to sleep on the word needs a system call to wake it.
+     */
+    if (old != CPU_WAKE_POSTED)
+    {
+        regs->waketod = host_tod();
+
+        while (old != CPU_WAKE_POSTED
+            && cmpxchg4( &old, CPU_WAKE_POSTED, (void*) &regs->wakeword ));
+
+        if (old == CPU_WAKE_SLEEPING)
+            hthread_wake_word( &regs->wakeword );
+    }
+
+    /* Stopped, stepping and SIE-waiting CPUs use the condition */
     hthread_signal_condition( &regs->intcond, location );
 }
 
@@ -463,7 +481,7 @@ static inline void stop_all_cpus_intlock_held()
             regs->opinterv = 1;
             regs->cpustate = CPUSTATE_STOPPING;
             ON_IC_INTERRUPT( regs );
-            signal_condition( &regs->intcond );
+            WAKEUP_CPU( regs );
         }
          mask >>= 1;
     }
@@ -488,7 +506,7 @@ static inline void start_all_cpus_intlock_held()
             regs->opinterv = 0;
             regs->cpustate = CPUSTATE_STARTED;
             ON_IC_INTERRUPT( regs );
-            signal_condition( &regs->intcond );
+            WAKEUP_CPU( regs );
         }
         mask >>= 1;
     }
@@ -492,6 +492,21 @@ typedef int CMPFUNC(const void*, const void*);
        sched_yield(); \
  } while (0)
 
+/*-------------------------------------------------------------------*/
+/*      Re-apply a thread's host CPU set after an AFFINITY change    */
+/*-------------------------------------------------------------------*/
+/* '_gen' is the caller's copy of sysblk.affgen, initially zero, so  */
+/* threads are never bound until an AFFINITY statement is processed. */
+
+#define UPDATE_THREAD_AFFINITY( _set, _gen )        \
+  do {                                              \
+    if ((_gen) != sysblk.affgen)                    \
+    {                                               \
+      (_gen) = sysblk.affgen;                       \
+      set_thread_affinity( _set );                  \
+    }                                               \
+  } while (0)
+
 /*-------------------------------------------------------------------*/
 /*      CRASH                       (with hopefully a dump)          */
 /*-------------------------------------------------------------------*/
@@ -0,0 +1,765 @@
+/* HPROF.C      (C) and others 2026                                  */
+/*              Guest code sampling profiler                         */
+/*                                                                   */
+/*   Released under "The Q Public License Version 1"                 */
+/*   (http://www.hercules-390.org/herclic.html) as modifications to  */
+/*   Hercules.                                                       */
+
+/*-------------------------------------------------------------------*/
+/* The profiler periodically samples every online CPU from the timer */
+/* thread: the instruction address, the primary ASCE and ASN, the    */
+/* problem state bit, whether the CPU is running an SIE guest, and   */
+/* the opcode about to be executed. Samples are aggregated into one  */
+/* hash table per CPU keyed by address space and address, together   */
+/* with a per-CPU opcode histogram.                                  */
+/*                                                                   */
+/* The CPU threads themselves are never touched: when the profiler   */
+/* is not active the only cost is a test of sysblk.profint in the    */
+/* timer thread. The collected profile can be displayed ("prof top") */
+/* or written to a file in folded stack format suitable as input to  */
+/* flame graph tools, or as a flat listing. Addresses are optionally */
+/* symbolized using a load map supplied by the user.                 */
+/*-------------------------------------------------------------------*/
+
+#include "hstdinc.h"
+
+#define _HPROF_C_
+#define _HENGINE_DLL_
+
+#include "hercules.h"
+
+/*-------------------------------------------------------------------*/
+/*                         Constants                                 */
+/*-------------------------------------------------------------------*/
+#define HPROF_DEFUSECS      1000        /* Default sampling interval */
+#define HPROF_MAXUSECS      1000000     /* Maximum sampling interval */
+#define HPROF_TABSIZE       65536       /* Hash entries per CPU      */
+#define HPROF_MAXUSED       (HPROF_TABSIZE / 4 * 3)
+#define HPROF_DEFTOP        10          /* Default "prof top" count  */
+#define HPROF_MAXSYMLEN     64          /* Maximum symbol length     */
+
+#define HPF_PROB            0x01        /* Problem state             */
+#define HPF_SIE             0x02        /* SIE guest                 */
+#define HPF_REAL            0x04        /* DAT off                   */
+
+/*-------------------------------------------------------------------*/
+/*                         Structures                                */
+/*-------------------------------------------------------------------*/
+typedef struct HPENTRY                  /* Aggregated sample         */
+{
+    U64     ia;                         /* Instruction address       */
+    U64     asce;                       /* Primary ASCE (CR1)        */
+    U64     count;                      /* Number of samples (0=free)*/
+    U16     asn;                        /* Primary ASN               */
+    U16     opcode;                     /* First two opcode bytes    */
+    BYTE    flags;                      /* HPF_xxx flags             */
+    BYTE    cpu;                        /* CPU (filled in for top)   */
+}
+HPENTRY;
+
+typedef struct HPCPU                    /* Per-CPU profile           */
+{
+    HPENTRY *tab;                       /* Hash table or NULL        */
+    int      used;                      /* Entries in use            */
+    U64      samples;                   /* Total samples taken       */
+    U64      waits;                     /* ... of which in wait state*/
+    U64      stopped;                   /* ... of which CPU stopped  */
+    U64      lost;                      /* ... not recorded (full)   */
+    U64      ophist[256];               /* Opcode histogram          */
+}
+HPCPU;
+
+typedef struct HPSYM                    /* Load map entry            */
+{
+    U64     addr;                       /* Start address             */
+    U64     len;                        /* Length                    */
+    int     asn;                        /* ASN or -1 for any         */
+    char    name[HPROF_MAXSYMLEN];      /* Symbol name               */
+}
+HPSYM;
+
+typedef struct HPSNAP                   /* Snapshot of one CPU       */
+{
+    HPENTRY e;                          /* Key fields                */
+    BYTE    state;                      /* see below                 */
+#define HPS_OFFLINE  0
+#define HPS_RUNNING  1
+#define HPS_WAITING  2
+#define HPS_STOPPED  3
+}
+HPSNAP;
+
+/*-------------------------------------------------------------------*/
+/*                       Local variables                             */
+/*-------------------------------------------------------------------*/
+static LOCK     hp_lock;                /* Serializes everything     */
+static int      hp_inited;              /* hp_lock initialized       */
+static U64      hp_last;                /* TOD of last sample        */
+static HPCPU    hp_cpu[ MAX_CPU_ENGS ]; /* Per-CPU profiles          */
+static HPSYM   *hp_sym;                 /* Load map, sorted by addr  */
+static int      hp_nsym;                /* Number of load map entries*/
+static char    *hp_mapname;             /* Load map file name        */
+
+/*-------------------------------------------------------------------*/
+/*                     Hash a sample key                             */
+/*-------------------------------------------------------------------*/
+static inline U32 hprof_hash( const HPENTRY* e )
+{
+    U64  h = (e->ia >> 1) ^ (e->asce * 0x9E3779B97F4A7C15ULL)
+           ^ ((U64)e->asn << 48) ^ ((U64)e->flags << 40);
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 32;
+    return (U32) h & (HPROF_TABSIZE - 1);
+}
+
+/*-------------------------------------------------------------------*/
+/*             Record one sample in a CPU's profile                  */
+/*-------------------------------------------------------------------*/
+static void hprof_record( HPCPU* pc, const HPENTRY* s )
+{
+    HPENTRY*  e;
+    U32       i;
+
+    pc->ophist[ s->opcode >> 8 ]++;
+
+    if (!pc->tab && !(pc->tab = calloc( HPROF_TABSIZE, sizeof( HPENTRY ))))
+    {
+        pc->lost++;
+        return;
+    }
+
+    for (i = hprof_hash( s );; i = (i + 1) & (HPROF_TABSIZE - 1))
+    {
+        e = &pc->tab[i];
+
+        if (!e->count)
+        {
+            /* Keep some room free so probe sequences stay short */
+            if (pc->used >= HPROF_MAXUSED)
+            {
+                pc->lost++;
+                return;
+            }
+            *e = *s;
+            e->count = 1;
+            pc->used++;
+            return;
+        }
+
+        if (1
+            && e->ia    == s->ia
+            && e->asce  == s->asce
+            && e->asn   == s->asn
+            && e->flags == s->flags
+        )
+        {
+            e->count++;
+            e->opcode = s->opcode;
+            return;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*                 Take a snapshot of one CPU                        */
+/*-------------------------------------------------------------------*/
+/* Called with the intlock held so the REGS cannot go away. The CPU  */
+/* keeps running; the values read may be slightly stale, which does  */
+/* not matter for statistical sampling. The opcode is only fetched   */
+/* through the instruction fetch accelerator when 'ip' lies within   */
+/* the currently mapped page, so mainstor is never addressed wildly. */
+/*-------------------------------------------------------------------*/
+static void hprof_snap( REGS* regs, HPSNAP* sn )
+{
+    BYTE   *ip, *aip, *aie;
+
+    memset( sn, 0, sizeof( *sn ));
+
+    if (regs->cpustate != CPUSTATE_STARTED)
+    {
+        sn->state = HPS_STOPPED;
+        return;
+    }
+
+#if defined( _FEATURE_SIE )
+    if (regs->sie_active && regs->guestregs)
+    {
+        regs = regs->guestregs;
+        sn->e.flags |= HPF_SIE;
+    }
+#endif
+
+    if (WAITSTATE( &regs->psw ))
+    {
+        sn->state = HPS_WAITING;
+        return;
+    }
+
+    sn->state = HPS_RUNNING;
+
+    if (PROBSTATE( &regs->psw ))
+        sn->e.flags |= HPF_PROB;
+
+    if ((regs->psw.sysmask & PSW_DATMODE) == 0)
+        sn->e.flags |= HPF_REAL;
+    else
+    {
+        sn->e.asce = regs->arch_mode == ARCH_900_IDX ? regs->CR_G(1)
+                                                     : regs->CR_L(1);
+        sn->e.asn  = regs->CR_LHL(4);
+    }
+
+    ip  = regs->ip;
+    aip = regs->aip;
+    aie = regs->aie;
+
+    if (aie && ip >= aip && ip < aie)
+    {
+        sn->e.ia     = regs->AIV_G + (U64)(ip - aip);
+        sn->e.opcode = fetch_hw( ip );
+    }
+    else
+        sn->e.ia     = regs->psw.IA_G;
+
+    if (regs->arch_mode != ARCH_900_IDX)
+        sn->e.ia &= 0x7FFFFFFF;
+}
+
+/*-------------------------------------------------------------------*/
+/*        Sample all CPUs (called by the timer thread)               */
+/*-------------------------------------------------------------------*/
+void hprof_sample( U64 now )
+{
+    HPSNAP  snap[ MAX_CPU_ENGS ];
+    HPCPU*  pc;
+    int     cpu, hicpu;
+
+    if (now - hp_last < (U64) sysblk.profint * ETOD_USEC)
+        return;
+    hp_last = now;
+
+    /* Snapshot every CPU with the intlock held as briefly as possible */
+    OBTAIN_INTLOCK( NULL );
+    {
+        hicpu = sysblk.hicpu;
+
+        for (cpu = 0; cpu < hicpu; cpu++)
+        {
+            if (!IS_CPU_ONLINE( cpu ))
+                snap[ cpu ].state = HPS_OFFLINE;
+            else
+                hprof_snap( sysblk.regs[ cpu ], &snap[ cpu ]);
+        }
+    }
+    RELEASE_INTLOCK( NULL );
+
+    obtain_lock( &hp_lock );
+    {
+        /* The profiler may have been stopped meanwhile */
+        if (sysblk.profint)
+        {
+            for (cpu = 0; cpu < hicpu; cpu++)
+            {
+                pc = &hp_cpu[ cpu ];
+
+                switch (snap[ cpu ].state)
+                {
+                case HPS_OFFLINE:                       continue;
+                case HPS_STOPPED: pc->stopped++;        break;
+                case HPS_WAITING: pc->waits++;          break;
+                default:          hprof_record( pc, &snap[ cpu ].e );
+                }
+                pc->samples++;
+            }
+        }
+    }
+    release_lock( &hp_lock );
+}
+
+/*-------------------------------------------------------------------*/
+/*           Discard all samples (hp_lock held)                      */
+/*-------------------------------------------------------------------*/
+static void hprof_reset()
+{
+    int  cpu;
+
+    for (cpu = 0; cpu < MAX_CPU_ENGS; cpu++)
+    {
+        free( hp_cpu[ cpu ].tab );
+        memset( &hp_cpu[ cpu ], 0, sizeof( HPCPU ));
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*                   Load map sort / lookup                          */
+/*-------------------------------------------------------------------*/
+static int hprof_symcmp( const void* a, const void* b )
+{
+    const HPSYM*  sa = a;
+    const HPSYM*  sb = b;
+
+    return sa->addr < sb->addr ? -1 : sa->addr > sb->addr ? 1 : 0;
+}
+
+static const HPSYM* hprof_lookup( const HPENTRY* e )
+{
+    int  lo = 0, hi = hp_nsym - 1, mid, i, n;
+
+    /* Find the last entry starting at or below the address */
+    while (lo <= hi)
+    {
+        mid = (lo + hi) / 2;
+        if (hp_sym[ mid ].addr <= e->ia)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+
+    /* Ranges of different address spaces may overlap, so look
+       back a few entries for one that covers the address */
+    for (i = hi, n = 0; i >= 0 && n < 16; i--, n++)
+    {
+        if (1
+            && e->ia < hp_sym[i].addr + hp_sym[i].len
+            && (hp_sym[i].asn < 0 || hp_sym[i].asn == e->asn)
+        )
+            return &hp_sym[i];
+    }
+    return NULL;
+}
+
+/*-------------------------------------------------------------------*/
+/*                     Load a load map file                          */
+/*-------------------------------------------------------------------*/
+/* Each line contains a hexadecimal start address and length and a   */
+/* symbol name, optionally followed by a hexadecimal ASN restricting */
+/* the entry to one address space. Empty lines and lines beginning   */
+/* with '#' are ignored.                                             */
+/*-------------------------------------------------------------------*/
+static int hprof_loadmap( const char* fname )
+{
+    char    line[ 256 ];
+    char    name[ HPROF_MAXSYMLEN ];
+    char    pathname[ MAX_PATH ];
+    HPSYM  *sym = NULL, *tmp;
+    int     nsym = 0, maxsym = 0, lineno = 0, asn, n;
+    U64     addr, len;
+    FILE   *fp;
+
+    hostpath( pathname, fname, sizeof( pathname ));
+
+    if (!(fp = fopen( pathname, "r" )))
+    {
+        // "Profiler: error in function %s: %s"
+        WRMSG( HHC00178, "E", "fopen()", strerror( errno ));
+        return -1;
+    }
+
+    while (fgets( line, sizeof( line ), fp ))
+    {
+        lineno++;
+
+        n = 0;
+        sscanf( line, " %n", &n );
+        if (!line[n] || line[n] == '#')
+            continue;
+
+        asn = -1;
+        n = sscanf( line, "%"SCNx64" %"SCNx64" %63s %x", &addr, &len, name, &asn );
+        if (n < 3 || !len || asn > 0xFFFF)
+        {
+            // "Profiler load map %s: line %d: invalid entry"
+            WRMSG( HHC00175, "E", fname, lineno );
+            fclose( fp );
+            free( sym );
+            return -1;
+        }
+
+        if (nsym >= maxsym)
+        {
+            maxsym = maxsym ? maxsym * 2 : 256;
+            if (!(tmp = realloc( sym, maxsym * sizeof( HPSYM ))))
+            {
+                // "Profiler: error in function %s: %s"
+                WRMSG( HHC00178, "E", "realloc()", strerror( errno ));
+                fclose( fp );
+                free( sym );
+                return -1;
+            }
+            sym = tmp;
+        }
+
+        sym[ nsym ].addr = addr;
+        sym[ nsym ].len  = len;
+        sym[ nsym ].asn  = asn;
+        STRLCPY( sym[ nsym ].name, name );
+        nsym++;
+    }
+    fclose( fp );
+
+    qsort( sym, nsym, sizeof( HPSYM ), hprof_symcmp );
+
+    obtain_lock( &hp_lock );
+    {
+        free( hp_sym );
+        free( hp_mapname );
+        hp_sym     = sym;
+        hp_nsym    = nsym;
+        hp_mapname = strdup( fname );
+    }
+    release_lock( &hp_lock );
+
+    // "Profiler load map %s: %d symbols loaded"
+    WRMSG( HHC00174, "I", fname, nsym );
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*                 Format a sample's location                        */
+/*-------------------------------------------------------------------*/
+static void hprof_where( const HPENTRY* e, char* buf, size_t bufsz )
+{
+    const HPSYM*  s;
+
+    if (hp_nsym && (s = hprof_lookup( e )))
+        snprintf( buf, bufsz, "%s+%"PRIX64, s->name, e->ia - s->addr );
+    else
+        snprintf( buf, bufsz, "%016"PRIX64, e->ia );
+}
+
+static const char* hprof_mode( const HPENTRY* e )
+{
+    return (e->flags & HPF_SIE)
+         ? ((e->flags & HPF_PROB) ? "SIE-PROB" : "SIE-SUP")
+         : ((e->flags & HPF_PROB) ? "PROB"     : "SUP");
+}
+
+/*-------------------------------------------------------------------*/
+/*        Gather all entries of all CPUs (hp_lock held)              */
+/*-------------------------------------------------------------------*/
+static int hprof_cntcmp( const void* a, const void* b )
+{
+    const HPENTRY*  ea = a;
+    const HPENTRY*  eb = b;
+
+    return ea->count > eb->count ? -1 : ea->count < eb->count ? 1 : 0;
+}
+
+static HPENTRY* hprof_gather( int* count, U64* total )
+{
+    HPENTRY  *all;
+    int       cpu, i, n = 0;
+
+    *total = 0;
+    for (cpu = 0; cpu < MAX_CPU_ENGS; cpu++)
+    {
+        n      += hp_cpu[ cpu ].used;
+        *total += hp_cpu[ cpu ].samples;
+    }
+
+    if (!(all = malloc( (n ? n : 1) * sizeof( HPENTRY ))))
+        return NULL;
+
+    for (n = 0, cpu = 0; cpu < MAX_CPU_ENGS; cpu++)
+    {
+        if (!hp_cpu[ cpu ].tab)
+            continue;
+        for (i = 0; i < HPROF_TABSIZE; i++)
+        {
+            if (hp_cpu[ cpu ].tab[i].count)
+            {
+                all[n] = hp_cpu[ cpu ].tab[i];
+                all[n++].cpu = cpu;
+            }
+        }
+    }
+
+    qsort( all, n, sizeof( HPENTRY ), hprof_cntcmp );
+    *count = n;
+    return all;
+}
+
+/*-------------------------------------------------------------------*/
+/*                  Write the profile to a file                      */
+/*-------------------------------------------------------------------*/
+/* The folded format has one line per distinct stack with its frames */
+/* separated by semicolons followed by the sample count, e.g.        */
+/*                                                                   */
+/*     CP00;SUP;ASN 0001;IEAVEDS0+1A2 1234                           */
+/*                                                                   */
+/* The flat format lists every entry with its opcode, sorted by      */
+/* descending sample count.                                          */
+/*-------------------------------------------------------------------*/
+static int hprof_dump( const char* fname, bool folded )
+{
+    char      pathname[ MAX_PATH ];
+    char      where[ HPROF_MAXSYMLEN + 32 ];
+    HPENTRY  *all;
+    HPCPU    *pc;
+    FILE     *fp;
+    U64       total;
+    int       n, i, cpu, lines = 0;
+
+    hostpath( pathname, fname, sizeof( pathname ));
+
+    if (!(fp = fopen( pathname, "w" )))
+    {
+        // "Profiler: error in function %s: %s"
+        WRMSG( HHC00178, "E", "fopen()", strerror( errno ));
+        return -1;
+    }
+
+    obtain_lock( &hp_lock );
+
+    if (!(all = hprof_gather( &n, &total )))
+    {
+        release_lock( &hp_lock );
+        fclose( fp );
+        // "Profiler: error in function %s: %s"
+        WRMSG( HHC00178, "E", "malloc()", strerror( errno ));
+        return -1;
+    }
+
+    if (!folded)
+        fprintf( fp, "# %"PRIu64" samples\n"
+                     "# CPU  count      pct   mode     ASN  address          opcode  location\n",
+                 total );
+
+    for (i = 0; i < n; i++, lines++)
+    {
+        hprof_where( &all[i], where, sizeof( where ));
+
+        if (folded)
+        {
+            if (all[i].flags & HPF_REAL)
+                fprintf( fp, "CP%02X;%s;real;%s %"PRIu64"\n",
+                    all[i].cpu, hprof_mode( &all[i] ), where, all[i].count );
+            else
+                fprintf( fp, "CP%02X;%s;ASN %04X;%s %"PRIu64"\n",
+                    all[i].cpu, hprof_mode( &all[i] ), all[i].asn, where,
+                    all[i].count );
+        }
+        else
+            fprintf( fp, "CP%02X %10"PRIu64" %6.2f%% %-8s %04X %016"PRIX64" %04X    %s\n",
+                all[i].cpu, all[i].count,
+                total ? (100.0 * all[i].count) / total : 0.0,
+                hprof_mode( &all[i] ), all[i].asn, all[i].ia,
+                all[i].opcode, where );
+    }
+
+    /* Wait and stopped time appear as stacks of their own */
+    for (cpu = 0; cpu < MAX_CPU_ENGS; cpu++)
+    {
+        pc = &hp_cpu[ cpu ];
+        if (folded)
+        {
+            if (pc->waits)   fprintf( fp, "CP%02X;wait %"PRIu64"\n",    cpu, pc->waits   ), lines++;
+            if (pc->stopped) fprintf( fp, "CP%02X;stopped %"PRIu64"\n", cpu, pc->stopped ), lines++;
+            if (pc->lost)    fprintf( fp, "CP%02X;lost %"PRIu64"\n",    cpu, pc->lost    ), lines++;
+        }
+        else if (pc->samples)
+        {
+            fprintf( fp, "# CP%02X: %"PRIu64" samples, %"PRIu64" wait, %"PRIu64" stopped, %"PRIu64" lost\n",
+                cpu, pc->samples, pc->waits, pc->stopped, pc->lost );
+
+            /* Opcode histogram (first opcode byte) */
+            for (i = 0; i < 256; i++)
+                if (pc->ophist[i])
+                    fprintf( fp, "# CP%02X: opcode %02X %10"PRIu64"\n",
+                        cpu, i, pc->ophist[i] );
+        }
+    }
+
+    release_lock( &hp_lock );
+
+    free( all );
+    fclose( fp );
+
+    // "Profiler %s profile written to %s: %d entries"
+    WRMSG( HHC00176, "I", folded ? "folded" : "flat", fname, lines );
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*                 Display the hottest locations                     */
+/*-------------------------------------------------------------------*/
+static void hprof_top( int top )
+{
+    char      where[ HPROF_MAXSYMLEN + 32 ];
+    HPENTRY  *all;
+    U64       total;
+    int       n, i;
+
+    obtain_lock( &hp_lock );
+
+    if (!(all = hprof_gather( &n, &total )))
+    {
+        release_lock( &hp_lock );
+        // "Profiler: error in function %s: %s"
+        WRMSG( HHC00178, "E", "malloc()", strerror( errno ));
+        return;
+    }
+
+    for (i = 0; i < n && i < top; i++)
+    {
+        hprof_where( &all[i], where, sizeof( where ));
+
+        // "CP%02X %5.1f%% %10"PRIu64" %-8s ASN %04X IA %016"PRIX64" op %04X %s"
+        WRMSG( HHC00177, "I", all[i].cpu,
+            total ? (100.0 * all[i].count) / total : 0.0, all[i].count,
+            hprof_mode( &all[i] ), all[i].asn, all[i].ia, all[i].opcode,
+            where );
+    }
+
+    release_lock( &hp_lock );
+    free( all );
+}
+
+/*-------------------------------------------------------------------*/
+/*                     Display the status                            */
+/*-------------------------------------------------------------------*/
+static void hprof_status()
+{
+    U64  samples = 0, waits = 0, stopped = 0, lost = 0;
+    int  cpu;
+
+    obtain_lock( &hp_lock );
+    {
+        for (cpu = 0; cpu < MAX_CPU_ENGS; cpu++)
+        {
+            samples += hp_cpu[ cpu ].samples;
+            waits   += hp_cpu[ cpu ].waits;
+            stopped += hp_cpu[ cpu ].stopped;
+            lost    += hp_cpu[ cpu ].lost;
+        }
+
+        // "Profiler is %s; interval %d usecs, %"PRIu64" samples, %"PRIu64" wait, %"PRIu64" stopped, %"PRIu64" lost, map %s"
+        WRMSG( HHC00170, "I", sysblk.profint ? "active" : "inactive",
+            sysblk.profint ? sysblk.profint : HPROF_DEFUSECS,
+            samples, waits, stopped, lost,
+            hp_mapname ? hp_mapname : "(none)" );
+    }
+    release_lock( &hp_lock );
+}
+
+/*-------------------------------------------------------------------*/
+/*                      prof command                                 */
+/*-------------------------------------------------------------------*/
+/*   prof                          display status                    */
+/*   prof start [usecs]            start sampling                    */
+/*   prof stop                     stop sampling                     */
+/*   prof reset                    discard all samples               */
+/*   prof map file | off           load or discard a load map        */
+/*   prof dump file [folded|flat]  write the profile to a file       */
+/*   prof top [n]                  display the n hottest locations   */
+/*-------------------------------------------------------------------*/
+int hprof_command( int argc, char* argv[] )
+{
+    int   usecs;
+    char  c;
+
+    if (!hp_inited)
+    {
+        initialize_lock( &hp_lock );
+        hp_inited = TRUE;
+    }
+
+    if (argc < 2)
+    {
+        hprof_status();
+        return 0;
+    }
+
+    if (CMD( argv[1], START, 3 ))
+    {
+        usecs = HPROF_DEFUSECS;
+        if (argc > 3
+            || (argc == 3 && (sscanf( argv[2], "%d%c", &usecs, &c ) != 1
+                              || usecs < sysblk.timerint
+                              || usecs > HPROF_MAXUSECS)))
+        {
+            // "Invalid argument %s%s"
+            WRMSG( HHC02205, "E", argv[ argc - 1 ], "" );
+            return -1;
+        }
+        hp_last = 0;
+        sysblk.profint = usecs;
+
+        // "Profiler started; sampling every %d usecs"
+        WRMSG( HHC00171, "I", usecs );
+        return 0;
+    }
+
+    if (argc == 2 && CMD( argv[1], STOP, 3 ))
+    {
+        obtain_lock( &hp_lock );
+        sysblk.profint = 0;
+        release_lock( &hp_lock );
+
+        // "Profiler stopped"
+        WRMSG( HHC00172, "I" );
+        return 0;
+    }
+
+    if (argc == 2 && CMD( argv[1], RESET, 3 ))
+    {
+        obtain_lock( &hp_lock );
+        hprof_reset();
+        release_lock( &hp_lock );
+
+        // "Profiler samples reset"
+        WRMSG( HHC00173, "I" );
+        return 0;
+    }
+
+    if (argc == 3 && CMD( argv[1], MAP, 3 ))
+    {
+        if (strcasecmp( argv[2], "off" ) != 0)
+            return hprof_loadmap( argv[2] );
+
+        obtain_lock( &hp_lock );
+        {
+            free( hp_sym );
+            free( hp_mapname );
+            hp_sym     = NULL;
+            hp_nsym    = 0;
+            hp_mapname = NULL;
+        }
+        release_lock( &hp_lock );
+
+        // "Profiler load map %s: %d symbols loaded"
+        WRMSG( HHC00174, "I", "(none)", 0 );
+        return 0;
+    }
+
+    if ((argc == 3 || argc == 4) && CMD( argv[1], DUMP, 3 ))
+    {
+        if (argc == 4
+            && strcasecmp( argv[3], "folded" ) != 0
+            && strcasecmp( argv[3], "flat"   ) != 0)
+        {
+            // "Invalid argument %s%s"
+            WRMSG( HHC02205, "E", argv[3], "" );
+            return -1;
+        }
+        return hprof_dump( argv[2], argc == 3 || !strcasecmp( argv[3], "folded" ));
+    }
+
+    if (argc <= 3 && CMD( argv[1], TOP, 3 ))
+    {
+        usecs = HPROF_DEFTOP;
+        if (argc == 3 && (sscanf( argv[2], "%d%c", &usecs, &c ) != 1 || usecs < 1))
+        {
+            // "Invalid argument %s%s"
+            WRMSG( HHC02205, "E", argv[2], "" );
+            return -1;
+        }
+        hprof_top( usecs );
+        return 0;
+    }
+
+    // "Invalid command usage. Type 'help %s' for assistance."
+    WRMSG( HHC02299, "E", argv[0] );
+    return -1;
+}
@@ -914,25 +914,44 @@ int log_cmd(int argc, char *argv[], char *cmdline)
     return rc;
 }
 
+/*-------------------------------------------------------------------*/
+/* logopt command helper: format current log options                 */
+/*-------------------------------------------------------------------*/
+static void logopt_fmt( char* buf, size_t bufsz,
+                        bool bDateStamp, bool bTimeStamp )
+{
+    char size[32];
+
+    snprintf( buf, bufsz, "%s %s ROTSIZE=%s ROTTIME=%d %s %s"
+        , bDateStamp ? "DATESTAMP" : "NODATESTAMP"
+        , bTimeStamp ? "TIMESTAMP" : "NOTIMESTAMP"
+        , fmt_memsize( sysblk.logrotsize, size, sizeof( size ))
+        , sysblk.logrottime
+        , sysblk.logoptcompress ? "COMPRESS" : "NOCOMPRESS"
+        , sysblk.logoptdrop     ? "DROP"     : "WAIT"
+    );
+}
+
 /*-------------------------------------------------------------------*/
 /* logopt command - change log options                               */
 /*-------------------------------------------------------------------*/
 int logopt_cmd( int argc, char* argv[], char* cmdline)
 {
     int i, rc = 0;
-    char buf[64];
+    char buf[128];
     bool bDateStamp = !sysblk.logoptnodate;
     bool bTimeStamp = !sysblk.logoptnotime;
+    bool bCompress  = sysblk.logoptcompress;
+    bool bDrop      = sysblk.logoptdrop;
+    U64  rotsize    = sysblk.logrotsize;
+    int  rottime    = sysblk.logrottime;
 
     UNREFERENCED( cmdline );
     UPPER_ARGV_0( argv );
 
     if (argc <= 1)
     {
-        MSGBUF( buf, "%s %s"
-            , bDateStamp ? "DATESTAMP" : "NODATESTAMP"
-            , bTimeStamp ? "TIMESTAMP" : "NOTIMESTAMP"
-        );
+        logopt_fmt( buf, sizeof( buf ), bDateStamp, bTimeStamp );
 
         // "%-14s: %s"
         WRMSG( HHC02203, "I", argv[0], buf );
@@ -963,19 +982,92 @@ int logopt_cmd( int argc, char* argv[], char* cmdline)
             bTimeStamp = false;
             continue;
         }
+        if (CMD( argv[i], COMPRESS, 4 ))
+        {
+#if defined( HAVE_ZLIB )
+            bCompress = true;
+            continue;
+#else
+            // "Invalid argument %s%s"
+            WRMSG( HHC02205, "E", argv[i], "; not supported on this platform" );
+            return -1;
+#endif
+        }
+        if (CMD( argv[i], NOCOMPRESS, 6 ))
+        {
+            bCompress = false;
+            continue;
+        }
+        if (CMD( argv[i], WAIT, 4 ))
+        {
+            bDrop = false;
+            continue;
+        }
+        if (CMD( argv[i], DROP, 4 ))
+        {
+            bDrop = true;
+            continue;
+        }
+        if (strncasecmp( argv[i], "ROTSIZE=", 8 ) == 0)
+        {
+            char* p;
+            U64   mult = 1;
+
+            rotsize = strtoull( argv[i] + 8, &p, 10 );
+
+            switch (toupper( (unsigned char) *p ))
+            {
+                case 'K': mult = ONE_KILOBYTE; p++; break;
+                case 'M': mult = ONE_MEGABYTE; p++; break;
+                case 'G': mult = ONE_GIGABYTE; p++; break;
+            }
+
+            if (p == argv[i] + 8 || *p)
+            {
+                // "Invalid argument %s%s"
+                WRMSG( HHC02205, "E", argv[i], "" );
+                return -1;
+            }
+
+            rotsize *= mult;
+            continue;
+        }
+        if (strncasecmp( argv[i], "ROTTIME=", 8 ) == 0)
+        {
+            char* p;
+            long  secs = strtol( argv[i] + 8, &p, 10 );
+
+            switch (toupper( (unsigned char) *p ))
+            {
+                case 'S':                   p++; break;
+                case 'M': secs *= 60;       p++; break;
+                case 'H': secs *= 60 * 60;  p++; break;
+            }
+
+            if (p == argv[i] + 8 || *p || secs < 0 || secs > INT_MAX)
+            {
+                // "Invalid argument %s%s"
+                WRMSG( HHC02205, "E", argv[i], "" );
+                return -1;
+            }
+
+            rottime = (int) secs;
+            continue;
+        }
 
         // "Invalid argument %s%s"
         WRMSG( HHC02205, "E", argv[i], "" );
         return -1;
     }
 
-    sysblk.logoptnodate = !bDateStamp;
-    sysblk.logoptnotime = !bTimeStamp;
+    sysblk.logoptnodate   = !bDateStamp;
+    sysblk.logoptnotime   = !bTimeStamp;
+    sysblk.logoptcompress = bCompress;
+    sysblk.logoptdrop     = bDrop;
+    sysblk.logrotsize     = rotsize;
+    sysblk.logrottime     = rottime;
 
-    MSGBUF( buf, "%s %s"
-        , bDateStamp ? "DATESTAMP" : "NODATESTAMP"
-        , bTimeStamp ? "TIMESTAMP" : "NOTIMESTAMP"
-    );
+    logopt_fmt( buf, sizeof( buf ), bDateStamp, bTimeStamp );
 
     // "%-14s set to %s"
     WRMSG( HHC02204, "I", argv[0], buf );
@@ -2207,6 +2299,32 @@ int ctc_cmd( int argc, char *argv[], char *cmdline )
 
     UPPER_ARGV_0( argv );
 
+    // Format:  "ctc  bench  [ <count> ]"
+
+    if (argc >= 2 && CMD(argv[1],bench,5))
+    {
+        int   (*ctce_bench)( int );
+        int   count = 0;
+        char  c;
+
+        if (argc > 3 || (argc == 3
+            && (sscanf( argv[2], "%d%c", &count, &c ) != 1 || count <= 0)))
+        {
+            // "Invalid command usage. Type 'help %s' for assistance."
+            WRMSG( HHC02299, "E", argv[0] );
+            return -1;
+        }
+
+        // The benchmark is in the CTC module, loaded with the first CTC device
+        if (!(ctce_bench = (int (*)( int )) hdl_getsym( "ctce_bench" )))
+        {
+            // "Error in function %s: %s"
+            WRMSG( HHC02219, "E", "ctce_bench()", "module hdt3088 is not loaded" );
+            return -1;
+        }
+        return ctce_bench( count );
+    }
+
     // Format:  "ctc  debug  { on | off }  [ <devnum> | ALL ]"
 
     /* Check that there are at least two tokens */
@@ -2527,6 +2645,83 @@ int ctc_cmd( int argc, char *argv[], char *cmdline )
     return 0;
 }
 
+#if defined( _FEATURE_VM_BLOCKIO )
+/*-------------------------------------------------------------------*/
+/* d250stats command - display DIAGNOSE X'250' block I/O statistics  */
+/*-------------------------------------------------------------------*/
+int d250stats_cmd( int argc, char *argv[], char *cmdline )
+{
+    DEVBLK*  dev;
+    U16      lcss;
+    U16      devnum;
+    BYTE     all = TRUE;
+    BYTE     found = FALSE;
+    U64      blks, per;
+
+    UNREFERENCED( cmdline );
+
+    // Format:  "d250stats  [ <devnum> | ALL ]"
+
+    if (argc > 2)
+    {
+        // "Invalid command usage. Type 'help %s' for assistance."
+        WRMSG( HHC02299, "E", argv[0] );
+        return -1;
+    }
+
+    if (argc == 2 && !CMD( argv[1], ALL, 3 ))
+    {
+        if (parse_single_devnum( argv[1], &lcss, &devnum ) != 0)
+        {
+            // "Invalid command usage. Type 'help %s' for assistance."
+            WRMSG( HHC02299, "E", argv[0] );
+            return -1;
+        }
+        if (!find_device_by_devnum( lcss, devnum ))
+        {
+            // "%1d:%04X device not found"
+            devnotfound_msg( lcss, devnum );
+            return -1;
+        }
+        all = FALSE;
+    }
+
+    for (dev = sysblk.firstdev; dev; dev = dev->nextdev)
+    {
+        if (0
+            || !dev->allocated
+            || (all && !dev->vmd250reqs)
+            || (!all && (SSID_TO_LCSS( dev->ssid ) != lcss || dev->devnum != devnum))
+        )
+            continue;
+
+        found = TRUE;
+
+        // "%1d:%04X D250 requests %"PRIu64" async %"PRIu64" queued %u max %u avg queue wait %"PRIu64" usec"
+        WRMSG( HHC01946, "I", LCSS_DEVNUM,
+            dev->vmd250reqs, dev->vmd250async,
+            dev->vmd250qdepth, dev->vmd250qmax,
+            dev->vmd250async ? dev->vmd250qwait / dev->vmd250async : 0 );
+
+        blks = dev->vmd250rdblks + dev->vmd250wrblks;
+        per  = dev->vmd250ios ? blks * 100 / dev->vmd250ios : 0;
+
+        // "%1d:%04X D250 blocks read %"PRIu64" written %"PRIu64" in %"PRIu64" I/Os, %"PRIu64".%02"PRIu64" blocks per I/O"
+        WRMSG( HHC01947, "I", LCSS_DEVNUM,
+            dev->vmd250rdblks, dev->vmd250wrblks, dev->vmd250ios,
+            per / 100, per % 100 );
+    }
+
+    if (!found)
+    {
+        // "No DIAGNOSE X'250' block I/O has been done"
+        WRMSG( HHC01948, "I" );
+    }
+
+    return 0;
+}
+#endif /* defined( _FEATURE_VM_BLOCKIO ) */
+
 /*-------------------------------------------------------------------*/
 /* ptp command - enable/disable PTP debugging                        */
 /*-------------------------------------------------------------------*/
@@ -2736,6 +2931,7 @@ int qeth_cmd( int argc, char *argv[], char *cmdline )
 
     // Format:  "QETH  DEBUG  {ON|OFF}  [ [<devnum>|ALL] [mask ...] ]"
     // Format:  "QETH  ADDR             [ [<devnum>|ALL]            ]"
+    // Format:  "QETH  STATS            [ [<devnum>|ALL]            ]"
 
     if ( argc >= 2 && CMD(argv[1],debug,5) )
     {
@@ -3075,6 +3271,106 @@ int qeth_cmd( int argc, char *argv[], char *cmdline )
         return 0;
     }
 
+    if ( CMD(argv[1],stats,5) )
+    {
+        static const char* names[9] = { "SIGA-r", "SIGA-w", "SIGA-s",
+                                        "rings", "wakeups", "polls", "pollhits",
+                                        "switched", "swdrops" };
+        struct timeval now;
+        U64      nowus, elapsed, cur[9];
+
+        if ( argc > 3 )
+        {
+            // "Invalid command usage. Type 'help %s' for assistance."
+            WRMSG( HHC02299, "E", argv[0] );
+            return -1;
+        }
+
+        all = TRUE;
+        pDEVGRP = NULL;
+
+        if ( argc == 3 && !CMD(argv[2],all,3) )
+        {
+            if ( parse_single_devnum( argv[2], &lcss, &devnum) != 0 )
+            {
+                // "Invalid command usage. Type 'help %s' for assistance."
+                WRMSG( HHC02299, "E", argv[0] );
+                return -1;
+            }
+            if ( !(dev = find_device_by_devnum( lcss, devnum )) )
+            {
+                // "%1d:%04X device not found"
+                devnotfound_msg( lcss, devnum );
+                return -1;
+            }
+            if ( !dev->allocated ||
+                 dev->devtype != 0x1731 )
+            {
+                // "%1d:%04X device is not a '%s'"
+                WRMSG(HHC02209, "E", lcss, devnum, "QETH" );
+                return -1;
+            }
+            all = FALSE;
+            pDEVGRP = dev->group;
+        }
+
+        gettimeofday( &now, NULL );
+        nowus = (U64)now.tv_sec * 1000000 + now.tv_usec;
+
+        grp = NULL;
+        found = FALSE;
+
+        for ( dev = sysblk.firstdev; dev; dev = dev->nextdev )
+        {
+            /* Display each complete QETH group once */
+            if (0
+                || !dev->allocated
+                || dev->devtype != 0x1731
+                || (all == FALSE && pDEVGRP != dev->group)
+                || grp == dev->group->grp_data
+                || dev->group->members != dev->group->acount
+            )
+                continue;
+
+            grp = dev->group->grp_data;
+            found = TRUE;
+
+            cur[0] = grp->sigar;
+            cur[1] = grp->sigaw;
+            cur[2] = grp->sigas;
+            cur[3] = grp->rings;
+            cur[4] = grp->wakeups;
+            cur[5] = grp->polls;
+            cur[6] = grp->pollhits;
+            cur[7] = grp->vswout;
+            cur[8] = grp->vswdrop;
+
+            elapsed = grp->statsus && nowus > grp->statsus ? nowus - grp->statsus : 0;
+
+            for (i = 0; i < 9; i++)
+            {
+                // "%s device %1d:%04X group %-8s %12"PRIu64" %10"PRIu64"/s"
+                WRMSG( HHC02348, "I", dev->typname, LCSS_DEVNUM, names[i], cur[i],
+                    elapsed ? (cur[i] - grp->statsold[i]) * 1000000 / elapsed : 0 );
+                grp->statsold[i] = cur[i];
+            }
+            grp->statsus = nowus;
+
+            // "%s device %1d:%04X group poll %d usecs (window %d usecs), doorbell %s"
+            WRMSG( HHC02349, "I", dev->typname, LCSS_DEVNUM, grp->pollmax,
+                grp->pollus, grp->efd >= 0 ? "eventfd" : "pipe" );
+        }
+
+        if (!found)
+        {
+            // "No %s devices found"
+            WRMSG( HHC02347, "E", "QETH" );
+            return -1;
+        }
+
+        return 0;
+    }
+
     // "Invalid command usage. Type 'help %s' for assistance."
     WRMSG( HHC02299, "E", argv[0] );
     return -1;
@@ -3847,6 +4143,333 @@ u_int   locktype = 0;
     return rc;
 }
 
+/*-------------------------------------------------------------------*/
+/* xpndmove command - how pages are moved to expanded storage        */
+/*-------------------------------------------------------------------*/
+int xpndmove_cmd( int argc, char* argv[], char* cmdline )
+{
+    UNREFERENCED( cmdline );
+
+    UPPER_ARGV_0( argv );
+
+    if (argc > 2)
+    {
+        // "Invalid argument(s). Type 'help %s' for assistance."
+        WRMSG( HHC02211, "E", argv[0] );
+        return -1;
+    }
+
+    if (argc == 1)
+    {
+        // "%-14s: %s"
+        WRMSG( HHC02203, "I", argv[0], sysblk.xpndstream ? "STREAM" : "COPY" );
+        return 0;
+    }
+
+    if (CMD( argv[1], STREAM, 1 ))
+        sysblk.xpndstream = true;
+    else if (CMD( argv[1], COPY, 1 ))
+        sysblk.xpndstream = false;
+    else
+    {
+        // "Invalid argument %s%s"
+        WRMSG( HHC02205, "E", argv[1], "; expected STREAM or COPY" );
+        return -1;
+    }
+
+    if (MLVL( VERBOSE ))
+    {
+        // "%-14s set to %s"
+        WRMSG( HHC02204, "I", argv[0], sysblk.xpndstream ? "STREAM" : "COPY" );
+    }
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* affinity command helper: display one host CPU set                 */
+/*-------------------------------------------------------------------*/
+static void affinity_display( const char* name, const HCPUSET* set )
+{
+    char  list[256];
+
+    // "%-8s host CPUs %s"
+    WRMSG( HHC17016, "I", name, hthread_format_cpuset( set, list, sizeof( list )));
+}
+
+/*-------------------------------------------------------------------*/
+/* affinity command - bind threads and storage to host CPUs/nodes    */
+/*-------------------------------------------------------------------*/
+int affinity_cmd( int argc, char* argv[], char* cmdline )
+{
+    static const char* numapol[] = { "DEFAULT", "INTERLEAVE", "BIND" };
+
+    HCPUSET  set;
+    HCPUSET* pset = NULL;
+    char     name[16];
+    char     list[256];
+    char*    end;
+    int      i, lo, hi;
+
+    UNREFERENCED( cmdline );
+
+    UPPER_ARGV_0( argv );
+
+    /* Display the current host CPU sets and NUMA policy */
+    if (argc == 1)
+    {
+        for (i=0; i < sysblk.maxcpu; i++)
+        {
+            if (IS_CPU_ONLINE( i ) || !hthread_cpuset_isempty( &sysblk.cpuaff[i] ))
+            {
+                MSGBUF( name, "%s%02X", PTYPSTR( i ), i );
+                affinity_display( name, &sysblk.cpuaff[i] );
+            }
+        }
+        affinity_display( "DEV", &sysblk.devaff );
+        affinity_display( "TOD", &sysblk.todaff );
+        affinity_display( "SRV", &sysblk.srvaff );
+
+        // "MAINSTOR NUMA policy %s, nodes %s"
+        WRMSG( HHC17017, "I", numapol[ sysblk.numapolicy ],
+            hthread_format_cpuset( &sysblk.numanodes, list, sizeof( list )));
+        return 0;
+    }
+
+    /* AFFINITY MAINSTOR { DEFAULT | INTERLEAVE nodes | BIND nodes } */
+    if (CMD( argv[1], MAINSTOR, 4 ))
+    {
+        int policy;
+
+        if (argc == 3 && CMD( argv[2], DEFAULT, 3 ))
+            policy = NUMA_POLICY_DEFAULT;
+        else if (argc == 4 && CMD( argv[2], INTERLEAVE, 5 ))
+            policy = NUMA_POLICY_INTERLEAVE;
+        else if (argc == 4 && CMD( argv[2], BIND, 4 ))
+            policy = NUMA_POLICY_BIND;
+        else
+        {
+            // "Invalid argument(s). Type 'help %s' for assistance."
+            WRMSG( HHC02211, "E", argv[0] );
+            return -1;
+        }
+
+        memset( &set, 0, sizeof( set ));
+
+        if (argc == 4 && !hthread_parse_cpuset( argv[3], &set ))
+        {
+            // "Invalid argument %s%s"
+            WRMSG( HHC02205, "E", argv[3], "; expected host node list" );
+            return -1;
+        }
+
+        OBTAIN_INTLOCK( NULL );
+        {
+            sysblk.numapolicy = policy;
+            sysblk.numanodes  = set;
+        }
+        RELEASE_INTLOCK( NULL );
+
+        if (configure_numa() != 0)
+            return -1;
+
+        if (MLVL( VERBOSE ))
+        {
+            // "MAINSTOR NUMA policy %s, nodes %s"
+            WRMSG( HHC17017, "I", numapol[ sysblk.numapolicy ],
+                hthread_format_cpuset( &sysblk.numanodes, list, sizeof( list )));
+        }
+        return 0;
+    }
+
+    /* Determine which host CPU set(s) are being changed */
+    lo = hi = -1;
+
+    if (argc == 4 && CMD( argv[1], CPU, 3 ))
+    {
+        if (CMD( argv[2], ALL, 3 ))
+        {
+            lo = 0;
+            hi = sysblk.maxcpu - 1;
+        }
+        else
+        {
+            lo = hi = strtol( argv[2], &end, 16 );
+
+            if (*end || lo < 0 || lo >= sysblk.maxcpu)
+            {
+                // "Invalid argument %s%s"
+                WRMSG( HHC02205, "E", argv[2], "; CPU must be < MAXCPU" );
+                return -1;
+            }
+        }
+    }
+    else if (argc == 3 && CMD( argv[1], DEV, 3 )) pset = &sysblk.devaff;
+    else if (argc == 3 && CMD( argv[1], TOD, 3 )) pset = &sysblk.todaff;
+    else if (argc == 3 && CMD( argv[1], SRV, 3 )) pset = &sysblk.srvaff;
+    else
+    {
+        // "Invalid argument(s). Type 'help %s' for assistance."
+        WRMSG( HHC02211, "E", argv[0] );
+        return -1;
+    }
+
+    /* Parse the host CPU list; NONE lets the threads float again */
+    memset( &set, 0, sizeof( set ));
+
+    if (1
+        && !CMD( argv[ argc-1 ], NONE, 4 )
+        && !hthread_parse_cpuset( argv[ argc-1 ], &set )
+    )
+    {
+        // "Invalid argument %s%s"
+        WRMSG( HHC02205, "E", argv[ argc-1 ], "; expected host CPU list" );
+        return -1;
+    }
+
+    OBTAIN_INTLOCK( NULL );
+    {
+        if (pset)
+            *pset = set;
+        else
+            for (i = lo; i <= hi; i++)
+                sysblk.cpuaff[i] = set;
+
+        /* Device, timer and service threads notice the new
+           generation; running CPU threads are rebound now. */
+        if (!++sysblk.affgen)
+            sysblk.affgen = 1;
+
+        for (i = lo; i >= 0 && i <= hi; i++)
+            if (IS_CPU_ONLINE( i ))
+                set_thread_affinity_id( sysblk.cputid[i], &set );
+    }
+    RELEASE_INTLOCK( NULL );
+
+    if (MLVL( VERBOSE ))
+    {
+        if (pset)
+        {
+            STRLCPY( name, argv[1] );
+            string_to_upper( name );
+            affinity_display( name, pset );
+        }
+        else
+        {
+            for (i = lo; i <= hi; i++)
+            {
+                if (IS_CPU_ONLINE( i ) || !hthread_cpuset_isempty( &sysblk.cpuaff[i] ))
+                {
+                    MSGBUF( name, "%s%02X", PTYPSTR( i ), i );
+                    affinity_display( name, &sysblk.cpuaff[i] );
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* waitspin command - CPU wait state spin limit and wakeup latency   */
+/*-------------------------------------------------------------------*/
+int waitspin_cmd( int argc, char* argv[], char* cmdline )
+{
+    REGS*   regs;
+    char    buf[16];
+    char*   end;
+    long    usecs;
+    int     i;
+
+    UNREFERENCED( cmdline );
+
+    UPPER_ARGV_0( argv );
+
+    if (argc > 2)
+    {
+        // "Invalid argument(s). Type 'help %s' for assistance."
+        WRMSG( HHC02211, "E", argv[0] );
+        return -1;
+    }
+
+    /* Display the spin limit and each CPU's wakeup statistics */
+    if (argc == 1)
+    {
+        // "CPU wait spin limit %u usecs%s"
+        WRMSG( HHC17018, "I", sysblk.waitspin, hostinfo.num_procs < 2 ?
+            " (not used on a uniprocessor host)" : "" );
+
+        OBTAIN_INTLOCK( NULL );
+        {
+            for (i=0; i < sysblk.maxcpu; i++)
+            {
+                if (!IS_CPU_ONLINE( i ))
+                    continue;
+
+                regs = sysblk.regs[i];
+
+                // "%s%02X: wakeups %"PRIu64", %"PRIu64" before sleeping, latency avg %"PRIu64" max %"PRIu64" usecs, spin %u usecs"
+                WRMSG( HHC17019, "I", PTYPSTR( i ), i,
+                    regs->wakecount, regs->wakespin,
+                    (U64)(regs->wakecount ? regs->waketotal / regs->wakecount / ETOD_USEC : 0),
+                    (U64)(regs->wakemax / ETOD_USEC), regs->spinlimit );
+            }
+        }
+        RELEASE_INTLOCK( NULL );
+        return 0;
+    }
+
+    /* WAITSPIN RESET clears the wakeup statistics */
+    if (CMD( argv[1], RESET, 5 ))
+    {
+        OBTAIN_INTLOCK( NULL );
+        {
+            for (i=0; i < sysblk.maxcpu; i++)
+            {
+                if (IS_CPU_ONLINE( i ))
+                {
+                    regs = sysblk.regs[i];
+                    regs->wakecount = regs->wakespin = 0;
+                    regs->waketotal = regs->wakemax  = 0;
+                }
+            }
+        }
+        RELEASE_INTLOCK( NULL );
+
+        // "%-14s set to %s"
+        WRMSG( HHC02204, "I", argv[0], "RESET" );
+        return 0;
+    }
+
+    /* WAITSPIN usecs sets the upper limit of the adaptive spin */
+    errno = 0;
+    usecs = strtol( argv[1], &end, 10 );
+
+    if (errno || end == argv[1] || *end || usecs < 0 || usecs > MAX_WAITSPIN)
+    {
+        // "%s value is invalid; valid range is %d - %d"
+        WRMSG( HHC17014, "E", argv[0], 0, MAX_WAITSPIN );
+        return -1;
+    }
+
+    /* Each CPU starts adapting again from the new limit */
+    OBTAIN_INTLOCK( NULL );
+    {
+        sysblk.waitspin = (U32) usecs;
+
+        for (i=0; i < sysblk.maxcpu; i++)
+            if (IS_CPU_ONLINE( i ))
+                sysblk.regs[i]->spinlimit = sysblk.waitspin;
+    }
+    RELEASE_INTLOCK( NULL );
+
+    if (MLVL( VERBOSE ))
+    {
+        MSGBUF( buf, "%u", sysblk.waitspin );
+        // "%-14s set to %s"
+        WRMSG( HHC02204, "I", argv[0], buf );
+    }
+    return 0;
+}
+
 /*-------------------------------------------------------------------*/
 /* Deprecated 'xxxPRIO' and HERCNICE commands                        */
 /*-------------------------------------------------------------------*/
@@ -8871,6 +9494,16 @@ int hao_cmd(int argc, char *argv[], char *cmdline)
 }
 #endif /* defined( OPTION_HAO ) */
 
+/*-------------------------------------------------------------------*/
+/* prof - guest code sampling profiler                               */
+/*-------------------------------------------------------------------*/
+int prof_cmd( int argc, char* argv[], char* cmdline )
+{
+    UNREFERENCED( cmdline );
+    UPPER_ARGV_0( argv );
+    return hprof_command( argc, argv );  /* (actual code in hprof.c) */
+}
+
 /*-------------------------------------------------------------------*/
 /* conkpalv - set console session TCP keepalive values               */
 /*-------------------------------------------------------------------*/
@@ -9353,6 +9986,7 @@ int qproc_cmd( int argc, char* argv[], char* cmdline )
     int   cpupct = 0;
     U32   mipsrate = 0;
     char  msgbuf[128] = "";
+    char  affbuf[208];
 
     UNREFERENCED( cmdline );
     UNREFERENCED( argv );
@@ -9404,6 +10038,9 @@ int qproc_cmd( int argc, char* argv[], char* cmdline )
         if (IS_CPU_ONLINE( i ))
         {
             char*          pmsg     = msgbuf;
+
+            msgbuf[0] = 0;      /* (no suffix left over from the last CPU) */
+
 // This usage of getrusage() is only valid with the version
 // supplied in w32util.c. The Unix/Linux version does not
 // accept a thread ID as the first argument. Since it will
@@ -9470,6 +10107,17 @@ int qproc_cmd( int argc, char* argv[], char* cmdline )
             }
 #endif // defined(WIN32) || defined(WIN64)
 
+            /* Report the host CPUs this CPU thread is bound to */
+            if (!hthread_cpuset_isempty( &sysblk.cpuaff[i] ))
+            {
+                char  list[64];
+
+                MSGBUF( affbuf, "%s - Host CPUs(%s)", pmsg,
+                    hthread_format_cpuset( &sysblk.cpuaff[i],
+                    list, sizeof( list )));
+                pmsg = affbuf;
+            }
+
             mipsrate = sysblk.regs[i]->mipsrate;
 
             // "PROC %s%2.2X %c %3.3d%%; MIPS[%4d.%2.2d]; SIOS[%6d]%s"
@@ -509,6 +509,173 @@ int spm_cmd(int argc, char *argv[], char *cmdline)
 #endif
 
 
+#if defined( _FEATURE_SIE )
+/*-------------------------------------------------------------------*/
+/* siecache command - SIE state cache control and guest statistics   */
+/*-------------------------------------------------------------------*/
+int siecache_cmd( int argc, char* argv[], char* cmdline )
+{
+    static const char* code_name[ SIE_CACHE_CODES ] =
+    {
+        "none", "inst", "pgm", "both", "extreq", "extint", "ioreq",
+        "wait", "valid", "c24", "stop", "operexc", "alert", "c34",
+        "pix", "ioint", "ioinst", "exprun", "exptimer", "other"
+    };
+    SIECENT*  tot;                      /* Totals by state descriptor*/
+    SIECENT*  ce;
+    SIECACHE* sc;
+    REGS*     regs;
+    int       ntot = 0;
+    int       cpu, i, j, k;
+    char      buf[ 256 ];
+    size_t    len;
+
+    UNREFERENCED( cmdline );
+
+    UPPER_ARGV_0( argv );
+
+    if (argc > 1)
+    {
+        if (argc > 2)
+        {
+            // "Invalid argument(s). Type 'help %s' for assistance."
+            WRMSG( HHC02211, "E", argv[0] );
+            return -1;
+        }
+        if (0
+            || CMD( argv[1], ENABLE, 1 )
+            || CMD( argv[1], ON,     2 )
+        )
+        {
+            sysblk.siecache = true;
+            // "%-14s set to %s"
+            WRMSG( HHC02204, "I", argv[0], "ENABLE" );
+            return 0;
+        }
+        if (0
+            || CMD( argv[1], DISABLE, 1 )
+            || CMD( argv[1], OFF,     2 )
+        )
+        {
+            sysblk.siecache = false;
+            // "%-14s set to %s"
+            WRMSG( HHC02204, "I", argv[0], "DISABLE" );
+            return 0;
+        }
+        if (0
+            || CMD( argv[1], RESET, 1 )
+            || CMD( argv[1], ZERO,  1 )
+        )
+        {
+            /* (each CPU discards its entries on its next SIE) */
+            sysblk.siecache_gen++;
+            // "%-14s set to %s"
+            WRMSG( HHC02204, "I", argv[0], "ZERO" );
+            return 0;
+        }
+        // "Invalid argument %s%s"
+        WRMSG( HHC02205, "E", argv[1], "" );
+        return -1;
+    }
+
+    // "%-14s: %s"
+    WRMSG( HHC02203, "I", argv[0], sysblk.siecache ? "ENABLE" : "DISABLE" );
+
+    if (!(tot = calloc( MAX_CPU_ENGS * SIE_CACHE_ENTRIES, sizeof( SIECENT ))))
+    {
+        // "Error in function %s: %s"
+        WRMSG( HHC02219, "E", "calloc()", strerror( errno ));
+        return -1;
+    }
+
+    /* Combine the statistics each CPU keeps per state descriptor */
+    for (cpu=0; cpu < sysblk.maxcpu; cpu++)
+    {
+        obtain_lock( &sysblk.cpulock[ cpu ]);
+
+        regs = sysblk.regs[ cpu ];
+        sc = (IS_CPU_ONLINE( cpu ) && regs->guestregs) ?
+            regs->guestregs->siecache : NULL;
+
+        if (sc && sc->gen == sysblk.siecache_gen)
+        {
+            for (i=0, ce = sc->ent; i < SIE_CACHE_ENTRIES; i++, ce++)
+            {
+                if (!ce->sd)
+                    continue;
+
+                for (j=0; j < ntot && tot[j].sd != ce->sd; j++);
+
+                if (j == ntot)
+                    tot[ ntot++ ].sd = ce->sd;
+
+                tot[j].entries += ce->entries;
+                tot[j].hits    += ce->hits;
+                tot[j].tlbkept += ce->tlbkept;
+
+                for (k=0; k < SIE_CACHE_CODES; k++)
+                    tot[j].codes[k] += ce->codes[k];
+            }
+        }
+
+        release_lock( &sysblk.cpulock[ cpu ]);
+    }
+
+    if (!ntot)
+    {
+        // "No SIE state descriptors have been dispatched"
+        WRMSG( HHC02288, "I" );
+    }
+    else
+    {
+        // "%-16s %12s %12s %12s"
+        WRMSG( HHC02295, "I", "SIEBK", "Entries", "Reused", "TLB kept" );
+
+        for (j=0; j < ntot; j++)
+        {
+            char sd[ 24 ], e[ 24 ], h[ 24 ], t[ 24 ];
+
+            MSGBUF( sd, "%16.16"PRIX64, (U64) tot[j].sd );
+            MSGBUF( e,  "%"PRIu64, tot[j].entries );
+            MSGBUF( h,  "%"PRIu64, tot[j].hits    );
+            MSGBUF( t,  "%"PRIu64, tot[j].tlbkept );
+
+            // "%-16s %12s %12s %12s"
+            WRMSG( HHC02295, "I", sd, e, h, t );
+
+            /* Followed by its non-zero exit counts by reason */
+            len = 0;
+            buf[0] = 0;
+            for (k=0; k < SIE_CACHE_CODES; k++)
+            {
+                if (!tot[j].codes[k])
+                    continue;
+
+                len += snprintf( buf + len, sizeof( buf ) - len, " %s=%"PRIu64,
+                    code_name[k], tot[j].codes[k] );
+
+                if (len > 64 || len >= sizeof( buf ))
+                {
+                    // "%-16s exits:%s"
+                    WRMSG( HHC02296, "I", "", buf );
+                    len = 0;
+                    buf[0] = 0;
+                }
+            }
+            if (len)
+            {
+                // "%-16s exits:%s"
+                WRMSG( HHC02296, "I", "", buf );
+            }
+        }
+    }
+
+    free( tot );
+    return 0;
+}
+#endif /* defined( _FEATURE_SIE ) */
+
+
 /*-------------------------------------------------------------------*/
 /* ar command - display access registers                             */
 /*-------------------------------------------------------------------*/
@@ -2280,12 +2447,14 @@ int ipending_cmd(int argc, char *argv[], char *cmdline)
     /* I/O Interrupt Queue */
     /*---------------------*/
 
-    if (!sysblk.iointq)
+    obtain_lock( &sysblk.iointqlk );
+
+    if (!sysblk.iointqmask)
         WRMSG( HHC00881, "I", " (NULL)");
     else
         WRMSG( HHC00881, "I", "");
 
-    for (io = sysblk.iointq; io; io = io->next)
+    for (io = NEXT_IO_INTERRUPT_QLOCKED( NULL ); io; io = NEXT_IO_INTERRUPT_QLOCKED( io ))
     {
         WRMSG( HHC00882, "I", SSID_TO_LCSS(io->dev->ssid), io->dev->devnum
                 ,io->pending      ? " normal, " : ""
@@ -2299,6 +2468,105 @@ int ipending_cmd(int argc, char *argv[], char *cmdline)
                  );
     }
 
+    release_lock( &sysblk.iointqlk );
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* iointq command - display I/O interrupt queue statistics           */
+/*-------------------------------------------------------------------*/
+int iointq_cmd( int argc, char* argv[], char* cmdline )
+{
+    IOINTSTAT  stat;
+    char       range[32];
+    int        depth[ IOINTQ_BUCKETS ];
+    IOINT*     io;
+    int        i;
+
+    UNREFERENCED( cmdline );
+
+    UPPER_ARGV_0( argv );
+
+    if (argc > 2)
+    {
+        // "Invalid argument(s). Type 'help %s' for assistance."
+        WRMSG( HHC02211, "E", argv[0] );
+        return -1;
+    }
+
+    if (argc == 2)
+    {
+        if (!CMD( argv[1], RESET, 5 ))
+        {
+            // "Invalid argument %s%s"
+            WRMSG( HHC02205, "E", argv[1], "" );
+            return -1;
+        }
+
+        obtain_lock( &sysblk.iointqlk );
+        {
+            i = sysblk.iointstat.depth;
+            memset( &sysblk.iointstat, 0, sizeof( sysblk.iointstat ));
+            sysblk.iointstat.depth = sysblk.iointstat.maxdepth = i;
+        }
+        release_lock( &sysblk.iointqlk );
+
+        // "%-14s set to %s"
+        WRMSG( HHC02204, "I", argv[0], "RESET" );
+        return 0;
+    }
+
+    /* Take a consistent snapshot of the statistics */
+    obtain_lock( &sysblk.iointqlk );
+    {
+        stat = sysblk.iointstat;
+
+        for (i=0; i < IOINTQ_BUCKETS; i++)
+            for (depth[i] = 0, io = sysblk.iointq[i].head; io; io = io->next)
+                depth[i]++;
+    }
+    release_lock( &sysblk.iointqlk );
+
+    // "I/O interrupts: queued %"PRIu64", presented %"PRIu64", hinted %"PRIu64", depth %d, max %d"
+    WRMSG( HHC00887, "I", stat.queued, stat.presented, stat.hinted,
+        stat.depth, stat.maxdepth );
+
+    for (i=0; i < IOINTQ_BUCKETS; i++)
+    {
+        if (depth[i])
+        {
+            if (i < 8) MSGBUF( range, "ISC %d", i );
+            else       STRLCPY( range, "no ISC" );
+
+            // "%-8s %-12s %12"PRIu64
+            WRMSG( HHC00888, "I", "queued", range, (U64) depth[i] );
+        }
+    }
+
+    for (i=0; i < IOINTQ_DEPTH_BINS; i++)
+    {
+        if (stat.depthbin[i])
+        {
+            MSGBUF( range, "%d-%d", 1 << i, (2 << i) - 1 );
+
+            // "%-8s %-12s %12"PRIu64
+            WRMSG( HHC00888, "I", "depth", range, stat.depthbin[i] );
+        }
+    }
+
+    for (i=0; i < IOINTQ_LAT_BINS; i++)
+    {
+        if (stat.latbin[i])
+        {
+            if (i == 0) STRLCPY( range, "<1us" );
+            else        MSGBUF( range, "<%uus", 1U << i );
+
+            // "%-8s %-12s %12"PRIu64
+            WRMSG( HHC00888, "I", "latency", range, stat.latbin[i] );
+        }
+    }
+
     return 0;
 }
 
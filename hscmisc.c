@@ -1415,6 +1415,10 @@ static void do_shutdown_now()
     sysblk.shutfini = FALSE;      // (shutdown NOT finished yet)
     sysblk.shutdown = TRUE;       // (system shutdown initiated)
 
+    /* Write all messages issued so far to the hardcopy file now,
+       as from here on they may no longer be written in daemon mode */
+    logger_flush();
+
     /* Wakeup I/O subsystem to start I/O subsystem shutdown */
     {
         int  n;
@@ -118,7 +118,7 @@ int startall_cmd(int argc, char *argv[], char *cmdline)
                 REGS *regs = sysblk.regs[i];
                 regs->opinterv = 0;
                 regs->cpustate = CPUSTATE_STARTED;
-                signal_condition(&regs->intcond);
+                WAKEUP_CPU(regs);
             }
             mask >>= 1;
         }
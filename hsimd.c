@@ -0,0 +1,1086 @@
+/* HSIMD.C      (C) and others 2026                                  */
+/*              String and translate instruction kernels             */
+/*                                                                   */
+/*   Released under "The Q Public License Version 1"                 */
+/*   (http://www.hercules-390.org/herclic.html) as modifications to  */
+/*   Hercules.                                                       */
+
+/*-------------------------------------------------------------------*/
+/* Host vector kernels used by the string and translate instructions */
+/* CLST, CUSE, SRSTU, TRT, TRTR, TRTE and TRTRE and by the Unicode   */
+/* conversion instructions CU12, CU14, CU21, CU24, CU41 and CU42,    */
+/* and the page copy used by PGOUT and MVPG to expanded storage.     */
+/* Every kernel works on a span of host storage which the caller has */
+/* already translated and which never crosses a guest page boundary, */
+/* so that the order in which access exceptions are recognized and  */
+/* the CPU-determined lengths remain entirely under the control of   */
+/* the instruction.                                                  */
+/*                                                                   */
+/* Each kernel exists in a portable version and, where the host has  */
+/* them, in SSE2/SSSE3 and AVX2 (x86-64) or NEON (AArch64) versions. */
+/* The best version is selected once by hsimd_init at startup from   */
+/* the host CPU's feature bits; until then the portable versions are */
+/* used. SRST and TRE use memchr which the C library already         */
+/* vectorizes.                                                       */
+/*-------------------------------------------------------------------*/
+
+#include "hstdinc.h"
+
+#define _HSIMD_C_
+#define _HENGINE_DLL_
+
+#include "hercules.h"
+
+#if defined( _MSVC_ ) && defined( _M_X64 )
+  #define HSIMD_X86
+  #define HSIMD_TARGET( _isa )
+  #include <intrin.h>
+#elif defined( __GNUC__ ) && defined( __x86_64__ )
+  #define HSIMD_X86
+  #define HSIMD_TARGET( _isa )  __attribute__(( target( _isa )))
+  #include <immintrin.h>
+#elif defined( __GNUC__ ) && defined( __aarch64__ ) && defined( __ARM_NEON )
+  #define HSIMD_NEON
+  #include <arm_neon.h>
+#endif
+
+/*-------------------------------------------------------------------*/
+/*                         Constants                                 */
+/*-------------------------------------------------------------------*/
+#define HSIMD_ONES      0x0101010101010101ULL
+#define HSIMD_HIGHS     0x8080808080808080ULL
+#define HSIMD_TRTMIN    64          /* Shortest vectorized TRT scan  */
+
+/* Nonzero if any byte of the 64-bit word is zero */
+#define HSIMD_HASZERO( _w )  (((_w) - HSIMD_ONES) & ~(_w) & HSIMD_HIGHS)
+
+/*-------------------------------------------------------------------*/
+/*                   Kernel dispatch pointers                        */
+/*-------------------------------------------------------------------*/
+typedef size_t HSIMD_CMP  ( const BYTE* a, const BYTE* b, size_t n );
+typedef size_t HSIMD_CLST ( const BYTE* a, const BYTE* b, size_t n, BYTE term );
+typedef size_t HSIMD_HW   ( const BYTE* p, size_t n, U16 c );
+typedef size_t HSIMD_TRT  ( const BYTE* p, size_t n, const BYTE* fct );
+typedef size_t HSIMD_UTF  ( BYTE* d, const BYTE* s, size_t n );
+typedef void   HSIMD_PAGE ( BYTE* d, const BYTE* s );
+
+static HSIMD_CLST  clst_generic;
+static HSIMD_CMP   first_equ_generic;
+static HSIMD_CMP   last_neq_generic;
+static HSIMD_HW    find_hw_generic;
+static HSIMD_TRT   trt_generic;
+static HSIMD_TRT   trtr_generic;
+static HSIMD_UTF   utf8_16_generic;
+static HSIMD_UTF   utf8_32_generic;
+static HSIMD_UTF   utf16_8_generic;
+static HSIMD_UTF   utf16_32_generic;
+static HSIMD_UTF   utf32_8_generic;
+static HSIMD_UTF   utf32_16_generic;
+static HSIMD_PAGE  stream_page_generic;
+
+static HSIMD_CLST* p_clst       = clst_generic;
+static HSIMD_CMP*  p_first_equ  = first_equ_generic;
+static HSIMD_CMP*  p_last_neq   = last_neq_generic;
+static HSIMD_HW*   p_find_hw    = find_hw_generic;
+static HSIMD_TRT*  p_trt        = trt_generic;
+static HSIMD_TRT*  p_trtr       = trtr_generic;
+static HSIMD_PAGE* p_stream_page = stream_page_generic;
+
+/* Unicode kernels indexed by source and destination unit size / 2 */
+static HSIMD_UTF*  p_utf[3][3]  =
+{
+    { NULL,             utf8_16_generic,  utf8_32_generic  },
+    { utf16_8_generic,  NULL,             utf16_32_generic },
+    { utf32_8_generic,  utf32_16_generic, NULL             },
+};
+
+/*-------------------------------------------------------------------*/
+/*                   Portable kernels                                */
+/*-------------------------------------------------------------------*/
+static size_t clst_generic( const BYTE* a, const BYTE* b, size_t n, BYTE term )
+{
+    U64     t = HSIMD_ONES * term;
+    U64     x, y;
+    size_t  i;
+
+    for (i=0; i + 8 <= n; i += 8)
+    {
+        memcpy( &x, a + i, 8 );
+        memcpy( &y, b + i, 8 );
+        if (x != y || HSIMD_HASZERO( x ^ t ))
+            break;
+    }
+    for (; i < n && a[i] == b[i] && a[i] != term; i++);
+    return i;
+}
+
+static size_t first_equ_generic( const BYTE* a, const BYTE* b, size_t n )
+{
+    U64     x, y;
+    size_t  i;
+
+    for (i=0; i + 8 <= n; i += 8)
+    {
+        memcpy( &x, a + i, 8 );
+        memcpy( &y, b + i, 8 );
+        if (HSIMD_HASZERO( x ^ y ))
+            break;
+    }
+    for (; i < n && a[i] != b[i]; i++);
+    return i;
+}
+
+static size_t last_neq_generic( const BYTE* a, const BYTE* b, size_t n )
+{
+    U64     x, y;
+    size_t  k;
+
+    for (k=0; k + 8 <= n; k += 8)
+    {
+        memcpy( &x, a + n - k - 8, 8 );
+        memcpy( &y, b + n - k - 8, 8 );
+        if (x != y)
+            break;
+    }
+    for (; k < n && a[n-k-1] == b[n-k-1]; k++);
+    return k;
+}
+
+static size_t find_hw_generic( const BYTE* p, size_t n, U16 c )
+{
+    size_t  i;
+
+    for (i=0; i < n && (U16)((p[2*i] << 8) | p[2*i+1]) != c; i++);
+    return i;
+}
+
+static size_t trt_generic( const BYTE* p, size_t n, const BYTE* fct )
+{
+    size_t  i;
+
+    for (i=0; i < n && !fct[ p[i] ]; i++);
+    return i;
+}
+
+static size_t trtr_generic( const BYTE* p, size_t n, const BYTE* fct )
+{
+    size_t  k;
+
+    for (k=0; k < n && !fct[ p[n-k-1] ]; k++);
+    return k;
+}
+
+/*-------------------------------------------------------------------*/
+/* Unicode conversion kernels. Each converts the leading characters  */
+/* which need one unit in both formats: ASCII between UTF-8 and the  */
+/* other formats, and any BMP character other than a high surrogate  */
+/* (D800-DBFF) between UTF-16 and UTF-32. The operands are big-endian */
+/* and n is the number of source characters available.               */
+/*-------------------------------------------------------------------*/
+static size_t utf8_16_generic( BYTE* d, const BYTE* s, size_t n )
+{
+    size_t  i;
+
+    for (i=0; i < n && s[i] < 0x80; i++)
+    {
+        d[2*i]   = 0;
+        d[2*i+1] = s[i];
+    }
+    return i;
+}
+
+static size_t utf8_32_generic( BYTE* d, const BYTE* s, size_t n )
+{
+    size_t  i;
+
+    for (i=0; i < n && s[i] < 0x80; i++)
+    {
+        d[4*i]   = 0;
+        d[4*i+1] = 0;
+        d[4*i+2] = 0;
+        d[4*i+3] = s[i];
+    }
+    return i;
+}
+
+static size_t utf16_8_generic( BYTE* d, const BYTE* s, size_t n )
+{
+    size_t  i;
+
+    for (i=0; i < n && !s[2*i] && s[2*i+1] < 0x80; i++)
+        d[i] = s[2*i+1];
+    return i;
+}
+
+static size_t utf16_32_generic( BYTE* d, const BYTE* s, size_t n )
+{
+    size_t  i;
+
+    for (i=0; i < n && (s[2*i] & 0xFC) != 0xD8; i++)
+    {
+        d[4*i]   = 0;
+        d[4*i+1] = 0;
+        d[4*i+2] = s[2*i];
+        d[4*i+3] = s[2*i+1];
+    }
+    return i;
+}
+
+static size_t utf32_8_generic( BYTE* d, const BYTE* s, size_t n )
+{
+    size_t  i;
+
+    for (i=0; i < n && !s[4*i] && !s[4*i+1] && !s[4*i+2] && s[4*i+3] < 0x80; i++)
+        d[i] = s[4*i+3];
+    return i;
+}
+
+static size_t utf32_16_generic( BYTE* d, const BYTE* s, size_t n )
+{
+    size_t  i;
+
+    for (i=0; i < n && !s[4*i] && !s[4*i+1] && (s[4*i+2] & 0xFC) != 0xD8; i++)
+    {
+        d[2*i]   = s[4*i+2];
+        d[2*i+1] = s[4*i+3];
+    }
+    return i;
+}
+
+/*-------------------------------------------------------------------*/
+/* Copy a 4K page whose destination will not be referenced soon      */
+/*-------------------------------------------------------------------*/
+static void stream_page_generic( BYTE* d, const BYTE* s )
+{
+    memcpy( d, s, 4096 );
+}
+
+/*-------------------------------------------------------------------*/
+/* Function code set bitmaps for the vectorized TRT scans. The byte  */
+/* value v has a nonzero function code if bit (v >> 4) & 7 is on in  */
+/* lo[v & 15] (v < 128) or hi[v & 15] (v >= 128).                    */
+/*-------------------------------------------------------------------*/
+#if defined( HSIMD_X86 ) || defined( HSIMD_NEON )
+static const BYTE hsimd_bits[16] =
+{
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+};
+
+static void trt_bitmaps( const BYTE* fct, BYTE* lo, BYTE* hi )
+{
+    int     v;
+
+    memset( lo, 0, 16 );
+    memset( hi, 0, 16 );
+    for (v=0; v < 256; v++)
+        if (fct[v])
+        {
+            if (v < 128) lo[ v & 15 ] |= hsimd_bits[ v >> 4 ];
+            else         hi[ v & 15 ] |= hsimd_bits[ v >> 4 ];
+        }
+}
+#endif
+
+#if defined( HSIMD_X86 )
+/*-------------------------------------------------------------------*/
+/*                   x86-64 kernels                                  */
+/*-------------------------------------------------------------------*/
+#if defined( _MSVC_ )
+static INLINE int hsimd_ctz( U32 m )
+{
+    unsigned long r;
+    _BitScanForward( &r, m );
+    return (int) r;
+}
+static INLINE int hsimd_msb( U32 m )
+{
+    unsigned long r;
+    _BitScanReverse( &r, m );
+    return (int) r;
+}
+#else
+#define hsimd_ctz( _m )     __builtin_ctz( _m )
+#define hsimd_msb( _m )     (31 - __builtin_clz( _m ))
+#endif
+
+/* SSE2 is part of the x86-64 base architecture */
+
+static size_t clst_sse2( const BYTE* a, const BYTE* b, size_t n, BYTE term )
+{
+    __m128i t = _mm_set1_epi8( (char) term );
+    __m128i x, y;
+    U32     m;
+    size_t  i;
+
+    for (i=0; i + 16 <= n; i += 16)
+    {
+        x = _mm_loadu_si128( (const __m128i*)(a + i) );
+        y = _mm_loadu_si128( (const __m128i*)(b + i) );
+        m = (U32) _mm_movemask_epi8( _mm_andnot_si128( _mm_cmpeq_epi8( x, t ),
+                                                       _mm_cmpeq_epi8( x, y )));
+        if (m != 0xFFFF)
+            return i + hsimd_ctz( ~m );
+    }
+    return i + clst_generic( a + i, b + i, n - i, term );
+}
+
+static size_t first_equ_sse2( const BYTE* a, const BYTE* b, size_t n )
+{
+    __m128i x, y;
+    U32     m;
+    size_t  i;
+
+    for (i=0; i + 16 <= n; i += 16)
+    {
+        x = _mm_loadu_si128( (const __m128i*)(a + i) );
+        y = _mm_loadu_si128( (const __m128i*)(b + i) );
+        if ((m = (U32) _mm_movemask_epi8( _mm_cmpeq_epi8( x, y ))))
+            return i + hsimd_ctz( m );
+    }
+    return i + first_equ_generic( a + i, b + i, n - i );
+}
+
+static size_t last_neq_sse2( const BYTE* a, const BYTE* b, size_t n )
+{
+    __m128i x, y;
+    U32     m;
+    size_t  k;
+
+    for (k=0; k + 16 <= n; k += 16)
+    {
+        x = _mm_loadu_si128( (const __m128i*)(a + n - k - 16) );
+        y = _mm_loadu_si128( (const __m128i*)(b + n - k - 16) );
+        if ((m = ~(U32) _mm_movemask_epi8( _mm_cmpeq_epi8( x, y )) & 0xFFFF))
+            return k + 15 - hsimd_msb( m );
+    }
+    return k + last_neq_generic( a, b, n - k );
+}
+
+static size_t find_hw_sse2( const BYTE* p, size_t n, U16 c )
+{
+    /* Compare the big-endian halfwords against the swapped character */
+    __m128i t = _mm_set1_epi16( (short)(U16)((c >> 8) | (c << 8)) );
+    U32     m;
+    size_t  i;
+
+    for (i=0; i + 8 <= n; i += 8)
+    {
+        m = (U32) _mm_movemask_epi8( _mm_cmpeq_epi16( t,
+                  _mm_loadu_si128( (const __m128i*)(p + 2*i) )));
+        if (m)
+            return i + hsimd_ctz( m ) / 2;
+    }
+    return i + find_hw_generic( p + 2*i, n - i, c );
+}
+
+/* Mask of the bytes of x having a nonzero function code */
+/* Unicode conversions: the vector loads are little-endian, so each  */
+/* 16 or 32 bit lane holds its big-endian character byte-swapped     */
+
+static size_t utf8_16_sse2( BYTE* d, const BYTE* s, size_t n )
+{
+    __m128i z = _mm_setzero_si128();
+    __m128i x;
+    size_t  i;
+
+    for (i=0; i + 16 <= n; i += 16)
+    {
+        x = _mm_loadu_si128( (const __m128i*)(s + i) );
+        if (_mm_movemask_epi8( x ))
+            break;
+        _mm_storeu_si128( (__m128i*)(d + 2*i),      _mm_unpacklo_epi8( z, x ));
+        _mm_storeu_si128( (__m128i*)(d + 2*i + 16), _mm_unpackhi_epi8( z, x ));
+    }
+    return i + utf8_16_generic( d + 2*i, s + i, n - i );
+}
+
+static size_t utf8_32_sse2( BYTE* d, const BYTE* s, size_t n )
+{
+    __m128i z = _mm_setzero_si128();
+    __m128i x, lo, hi;
+    size_t  i;
+
+    for (i=0; i + 16 <= n; i += 16)
+    {
+        x = _mm_loadu_si128( (const __m128i*)(s + i) );
+        if (_mm_movemask_epi8( x ))
+            break;
+        lo = _mm_unpacklo_epi8( z, x );
+        hi = _mm_unpackhi_epi8( z, x );
+        _mm_storeu_si128( (__m128i*)(d + 4*i),      _mm_unpacklo_epi16( z, lo ));
+        _mm_storeu_si128( (__m128i*)(d + 4*i + 16), _mm_unpackhi_epi16( z, lo ));
+        _mm_storeu_si128( (__m128i*)(d + 4*i + 32), _mm_unpacklo_epi16( z, hi ));
+        _mm_storeu_si128( (__m128i*)(d + 4*i + 48), _mm_unpackhi_epi16( z, hi ));
+    }
+    return i + utf8_32_generic( d + 4*i, s + i, n - i );
+}
+
+static size_t utf16_8_sse2( BYTE* d, const BYTE* s, size_t n )
+{
+    __m128i m = _mm_set1_epi16( (short) 0x80FF );
+    __m128i a, b;
+    size_t  i;
+
+    for (i=0; i + 16 <= n; i += 16)
+    {
+        a = _mm_loadu_si128( (const __m128i*)(s + 2*i) );
+        b = _mm_loadu_si128( (const __m128i*)(s + 2*i + 16) );
+        if (_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_and_si128( _mm_or_si128( a, b ), m ),
+                                               _mm_setzero_si128() )) != 0xFFFF)
+            break;
+        _mm_storeu_si128( (__m128i*)(d + i),
+                          _mm_packus_epi16( _mm_srli_epi16( a, 8 ), _mm_srli_epi16( b, 8 )));
+    }
+    return i + utf16_8_generic( d + i, s + 2*i, n - i );
+}
+
+static size_t utf16_32_sse2( BYTE* d, const BYTE* s, size_t n )
+{
+    __m128i z = _mm_setzero_si128();
+    __m128i m = _mm_set1_epi16( 0x00FC );
+    __m128i h = _mm_set1_epi16( 0x00D8 );
+    __m128i x;
+    size_t  i;
+
+    for (i=0; i + 8 <= n; i += 8)
+    {
+        x = _mm_loadu_si128( (const __m128i*)(s + 2*i) );
+        if (_mm_movemask_epi8( _mm_cmpeq_epi16( _mm_and_si128( x, m ), h )))
+            break;
+        _mm_storeu_si128( (__m128i*)(d + 4*i),      _mm_unpacklo_epi16( z, x ));
+        _mm_storeu_si128( (__m128i*)(d + 4*i + 16), _mm_unpackhi_epi16( z, x ));
+    }
+    return i + utf16_32_generic( d + 4*i, s + 2*i, n - i );
+}
+
+static size_t utf32_8_sse2( BYTE* d, const BYTE* s, size_t n )
+{
+    __m128i m = _mm_set1_epi32( (int) 0x80FFFFFF );
+    __m128i a, b, c, e;
+    size_t  i;
+
+    for (i=0; i + 16 <= n; i += 16)
+    {
+        a = _mm_loadu_si128( (const __m128i*)(s + 4*i) );
+        b = _mm_loadu_si128( (const __m128i*)(s + 4*i + 16) );
+        c = _mm_loadu_si128( (const __m128i*)(s + 4*i + 32) );
+        e = _mm_loadu_si128( (const __m128i*)(s + 4*i + 48) );
+        if (_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_and_si128( _mm_or_si128( _mm_or_si128( a, b ),
+                                                                            _mm_or_si128( c, e )), m ),
+                                               _mm_setzero_si128() )) != 0xFFFF)
+            break;
+        a = _mm_packs_epi32( _mm_srli_epi32( a, 24 ), _mm_srli_epi32( b, 24 ));
+        c = _mm_packs_epi32( _mm_srli_epi32( c, 24 ), _mm_srli_epi32( e, 24 ));
+        _mm_storeu_si128( (__m128i*)(d + i), _mm_packus_epi16( a, c ));
+    }
+    return i + utf32_8_generic( d + i, s + 4*i, n - i );
+}
+
+static size_t utf32_16_sse2( BYTE* d, const BYTE* s, size_t n )
+{
+    __m128i z = _mm_setzero_si128();
+    __m128i m = _mm_set1_epi32( 0x0000FFFF );
+    __m128i hm = _mm_set1_epi32( 0x00FC0000 );
+    __m128i h = _mm_set1_epi32( 0x00D80000 );
+    __m128i a, b, bad;
+    size_t  i;
+
+    for (i=0; i + 8 <= n; i += 8)
+    {
+        a = _mm_loadu_si128( (const __m128i*)(s + 4*i) );
+        b = _mm_loadu_si128( (const __m128i*)(s + 4*i + 16) );
+        bad = _mm_or_si128( _mm_and_si128( _mm_or_si128( a, b ), m ),
+              _mm_or_si128( _mm_cmpeq_epi32( _mm_and_si128( a, hm ), h ),
+                            _mm_cmpeq_epi32( _mm_and_si128( b, hm ), h )));
+        if (_mm_movemask_epi8( _mm_cmpeq_epi8( bad, z )) != 0xFFFF)
+            break;
+        /* The arithmetic shift keeps the halfwords within packs' range */
+        _mm_storeu_si128( (__m128i*)(d + 2*i),
+                          _mm_packs_epi32( _mm_srai_epi32( a, 16 ), _mm_srai_epi32( b, 16 )));
+    }
+    return i + utf32_16_generic( d + 2*i, s + 4*i, n - i );
+}
+
+HSIMD_TARGET( "ssse3" )
+static U32 trt_member_ssse3( __m128i x, __m128i lo, __m128i hi, __m128i tbit )
+{
+    __m128i nib = _mm_set1_epi8( 0x0F );
+    __m128i idx = _mm_and_si128( x, nib );
+    __m128i sel = _mm_cmplt_epi8( x, _mm_setzero_si128() );
+    __m128i row = _mm_or_si128( _mm_and_si128(    sel, _mm_shuffle_epi8( hi, idx )),
+                                _mm_andnot_si128( sel, _mm_shuffle_epi8( lo, idx )));
+    __m128i bit = _mm_shuffle_epi8( tbit, _mm_and_si128( _mm_srli_epi16( x, 4 ), nib ));
+
+    return (U32) _mm_movemask_epi8( _mm_cmpeq_epi8( bit, _mm_and_si128( row, bit )));
+}
+
+HSIMD_TARGET( "ssse3" )
+static size_t trt_ssse3( const BYTE* p, size_t n, const BYTE* fct )
+{
+    CACHE_ALIGN BYTE blo[16], bhi[16];
+    __m128i lo, hi, tbit;
+    U32     m;
+    size_t  i;
+
+    if (n < HSIMD_TRTMIN)
+        return trt_generic( p, n, fct );
+
+    trt_bitmaps( fct, blo, bhi );
+    lo   = _mm_load_si128( (const __m128i*) blo );
+    hi   = _mm_load_si128( (const __m128i*) bhi );
+    tbit = _mm_loadu_si128( (const __m128i*) hsimd_bits );
+
+    for (i=0; i + 16 <= n; i += 16)
+        if ((m = trt_member_ssse3( _mm_loadu_si128( (const __m128i*)(p + i) ), lo, hi, tbit )))
+            return i + hsimd_ctz( m );
+
+    return i + trt_generic( p + i, n - i, fct );
+}
+
+HSIMD_TARGET( "ssse3" )
+static size_t trtr_ssse3( const BYTE* p, size_t n, const BYTE* fct )
+{
+    CACHE_ALIGN BYTE blo[16], bhi[16];
+    __m128i lo, hi, tbit;
+    U32     m;
+    size_t  k;
+
+    if (n < HSIMD_TRTMIN)
+        return trtr_generic( p, n, fct );
+
+    trt_bitmaps( fct, blo, bhi );
+    lo   = _mm_load_si128( (const __m128i*) blo );
+    hi   = _mm_load_si128( (const __m128i*) bhi );
+    tbit = _mm_loadu_si128( (const __m128i*) hsimd_bits );
+
+    for (k=0; k + 16 <= n; k += 16)
+        if ((m = trt_member_ssse3( _mm_loadu_si128( (const __m128i*)(p + n - k - 16) ), lo, hi, tbit )))
+            return k + 15 - hsimd_msb( m );
+
+    return k + trtr_generic( p, n - k, fct );
+}
+
+HSIMD_TARGET( "avx2" )
+static size_t clst_avx2( const BYTE* a, const BYTE* b, size_t n, BYTE term )
+{
+    __m256i t = _mm256_set1_epi8( (char) term );
+    __m256i x, y;
+    U32     m;
+    size_t  i;
+
+    for (i=0; i + 32 <= n; i += 32)
+    {
+        x = _mm256_loadu_si256( (const __m256i*)(a + i) );
+        y = _mm256_loadu_si256( (const __m256i*)(b + i) );
+        m = (U32) _mm256_movemask_epi8( _mm256_andnot_si256( _mm256_cmpeq_epi8( x, t ),
+                                                             _mm256_cmpeq_epi8( x, y )));
+        if (m != 0xFFFFFFFF)
+            return i + hsimd_ctz( ~m );
+    }
+    return i + clst_sse2( a + i, b + i, n - i, term );
+}
+
+HSIMD_TARGET( "avx2" )
+static size_t first_equ_avx2( const BYTE* a, const BYTE* b, size_t n )
+{
+    __m256i x, y;
+    U32     m;
+    size_t  i;
+
+    for (i=0; i + 32 <= n; i += 32)
+    {
+        x = _mm256_loadu_si256( (const __m256i*)(a + i) );
+        y = _mm256_loadu_si256( (const __m256i*)(b + i) );
+        if ((m = (U32) _mm256_movemask_epi8( _mm256_cmpeq_epi8( x, y ))))
+            return i + hsimd_ctz( m );
+    }
+    return i + first_equ_sse2( a + i, b + i, n - i );
+}
+
+HSIMD_TARGET( "avx2" )
+static size_t last_neq_avx2( const BYTE* a, const BYTE* b, size_t n )
+{
+    __m256i x, y;
+    U32     m;
+    size_t  k;
+
+    for (k=0; k + 32 <= n; k += 32)
+    {
+        x = _mm256_loadu_si256( (const __m256i*)(a + n - k - 32) );
+        y = _mm256_loadu_si256( (const __m256i*)(b + n - k - 32) );
+        if ((m = ~(U32) _mm256_movemask_epi8( _mm256_cmpeq_epi8( x, y ))))
+            return k + 31 - hsimd_msb( m );
+    }
+    return k + last_neq_sse2( a, b, n - k );
+}
+
+HSIMD_TARGET( "avx2" )
+static size_t find_hw_avx2( const BYTE* p, size_t n, U16 c )
+{
+    __m256i t = _mm256_set1_epi16( (short)(U16)((c >> 8) | (c << 8)) );
+    U32     m;
+    size_t  i;
+
+    for (i=0; i + 16 <= n; i += 16)
+    {
+        m = (U32) _mm256_movemask_epi8( _mm256_cmpeq_epi16( t,
+                  _mm256_loadu_si256( (const __m256i*)(p + 2*i) )));
+        if (m)
+            return i + hsimd_ctz( m ) / 2;
+    }
+    return i + find_hw_sse2( p + 2*i, n - i, c );
+}
+
+HSIMD_TARGET( "avx2" )
+static U32 trt_member_avx2( __m256i x, __m256i lo, __m256i hi, __m256i tbit )
+{
+    __m256i nib = _mm256_set1_epi8( 0x0F );
+    __m256i idx = _mm256_and_si256( x, nib );
+    __m256i sel = _mm256_cmpgt_epi8( _mm256_setzero_si256(), x );
+    __m256i row = _mm256_blendv_epi8( _mm256_shuffle_epi8( lo, idx ),
+                                      _mm256_shuffle_epi8( hi, idx ), sel );
+    __m256i bit = _mm256_shuffle_epi8( tbit, _mm256_and_si256( _mm256_srli_epi16( x, 4 ), nib ));
+
+    return (U32) _mm256_movemask_epi8( _mm256_cmpeq_epi8( bit, _mm256_and_si256( row, bit )));
+}
+
+HSIMD_TARGET( "avx2" )
+static size_t trt_avx2( const BYTE* p, size_t n, const BYTE* fct )
+{
+    CACHE_ALIGN BYTE blo[16], bhi[16];
+    __m256i lo, hi, tbit;
+    U32     m;
+    size_t  i;
+
+    if (n < HSIMD_TRTMIN)
+        return trt_generic( p, n, fct );
+
+    trt_bitmaps( fct, blo, bhi );
+    lo   = _mm256_broadcastsi128_si256( _mm_load_si128( (const __m128i*) blo ));
+    hi   = _mm256_broadcastsi128_si256( _mm_load_si128( (const __m128i*) bhi ));
+    tbit = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i*) hsimd_bits ));
+
+    for (i=0; i + 32 <= n; i += 32)
+        if ((m = trt_member_avx2( _mm256_loadu_si256( (const __m256i*)(p + i) ), lo, hi, tbit )))
+            return i + hsimd_ctz( m );
+
+    return i + trt_generic( p + i, n - i, fct );
+}
+
+HSIMD_TARGET( "avx2" )
+static size_t trtr_avx2( const BYTE* p, size_t n, const BYTE* fct )
+{
+    CACHE_ALIGN BYTE blo[16], bhi[16];
+    __m256i lo, hi, tbit;
+    U32     m;
+    size_t  k;
+
+    if (n < HSIMD_TRTMIN)
+        return trtr_generic( p, n, fct );
+
+    trt_bitmaps( fct, blo, bhi );
+    lo   = _mm256_broadcastsi128_si256( _mm_load_si128( (const __m128i*) blo ));
+    hi   = _mm256_broadcastsi128_si256( _mm_load_si128( (const __m128i*) bhi ));
+    tbit = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i*) hsimd_bits ));
+
+    for (k=0; k + 32 <= n; k += 32)
+        if ((m = trt_member_avx2( _mm256_loadu_si256( (const __m256i*)(p + n - k - 32) ), lo, hi, tbit )))
+            return k + 31 - hsimd_msb( m );
+
+    return k + trtr_generic( p, n - k, fct );
+}
+
+/* Non-temporal stores bypass the cache: the destination page is     */
+/* written in full, so no line needs to be read for ownership first, */
+/* and the guest's working set is not displaced by expanded storage. */
+static void stream_page_sse2( BYTE* d, const BYTE* s )
+{
+    const __m128i* src = (const __m128i*) s;
+    __m128i*       dst = (__m128i*) d;
+    __m128i        a, b, c, e;
+    int            i;
+
+    for (i=0; i < 4096/16; i += 4)
+    {
+        a = _mm_load_si128( src + i + 0 );
+        b = _mm_load_si128( src + i + 1 );
+        c = _mm_load_si128( src + i + 2 );
+        e = _mm_load_si128( src + i + 3 );
+        _mm_stream_si128( dst + i + 0, a );
+        _mm_stream_si128( dst + i + 1, b );
+        _mm_stream_si128( dst + i + 2, c );
+        _mm_stream_si128( dst + i + 3, e );
+    }
+    _mm_sfence();
+}
+#endif /* defined( HSIMD_X86 ) */
+
+#if defined( HSIMD_NEON )
+/*-------------------------------------------------------------------*/
+/*                   AArch64 NEON kernels                            */
+/*                                                                   */
+/* NEON has no movemask; each kernel skips whole 16 byte blocks and  */
+/* leaves the block holding the decisive byte to the portable code.  */
+/*-------------------------------------------------------------------*/
+static size_t clst_neon( const BYTE* a, const BYTE* b, size_t n, BYTE term )
+{
+    uint8x16_t t = vdupq_n_u8( term );
+    uint8x16_t x, y;
+    size_t     i;
+
+    for (i=0; i + 16 <= n; i += 16)
+    {
+        x = vld1q_u8( a + i );
+        y = vld1q_u8( b + i );
+        if (vminvq_u8( vbicq_u8( vceqq_u8( x, y ), vceqq_u8( x, t ))) != 0xFF)
+            break;
+    }
+    return i + clst_generic( a + i, b + i, n - i, term );
+}
+
+static size_t first_equ_neon( const BYTE* a, const BYTE* b, size_t n )
+{
+    size_t  i;
+
+    for (i=0; i + 16 <= n; i += 16)
+        if (vmaxvq_u8( vceqq_u8( vld1q_u8( a + i ), vld1q_u8( b + i ))))
+            break;
+    return i + first_equ_generic( a + i, b + i, n - i );
+}
+
+static size_t last_neq_neon( const BYTE* a, const BYTE* b, size_t n )
+{
+    size_t  k;
+
+    for (k=0; k + 16 <= n; k += 16)
+        if (vminvq_u8( vceqq_u8( vld1q_u8( a + n - k - 16 ),
+                                 vld1q_u8( b + n - k - 16 ))) != 0xFF)
+            break;
+    return k + last_neq_generic( a, b, n - k );
+}
+
+static size_t find_hw_neon( const BYTE* p, size_t n, U16 c )
+{
+    uint16x8_t t = vdupq_n_u16( (U16)((c >> 8) | (c << 8)) );
+    size_t     i;
+
+    for (i=0; i + 8 <= n; i += 8)
+        if (vmaxvq_u16( vceqq_u16( t, vreinterpretq_u16_u8( vld1q_u8( p + 2*i )))))
+            break;
+    return i + find_hw_generic( p + 2*i, n - i, c );
+}
+
+static INLINE uint8x16_t trt_member_neon( uint8x16_t x, uint8x16_t lo,
+                                          uint8x16_t hi, uint8x16_t tbit )
+{
+    uint8x16_t idx = vandq_u8( x, vdupq_n_u8( 0x0F ));
+    uint8x16_t row = vbslq_u8( vcgeq_u8( x, vdupq_n_u8( 0x80 )),
+                               vqtbl1q_u8( hi, idx ), vqtbl1q_u8( lo, idx ));
+
+    return vtstq_u8( row, vqtbl1q_u8( tbit, vshrq_n_u8( x, 4 )));
+}
+
+static size_t trt_neon( const BYTE* p, size_t n, const BYTE* fct )
+{
+    BYTE       blo[16], bhi[16];
+    uint8x16_t lo, hi, tbit;
+    size_t     i;
+
+    if (n < HSIMD_TRTMIN)
+        return trt_generic( p, n, fct );
+
+    trt_bitmaps( fct, blo, bhi );
+    lo   = vld1q_u8( blo );
+    hi   = vld1q_u8( bhi );
+    tbit = vld1q_u8( hsimd_bits );
+
+    for (i=0; i + 16 <= n; i += 16)
+        if (vmaxvq_u8( trt_member_neon( vld1q_u8( p + i ), lo, hi, tbit )))
+            break;
+    return i + trt_generic( p + i, n - i, fct );
+}
+
+static size_t trtr_neon( const BYTE* p, size_t n, const BYTE* fct )
+{
+    BYTE       blo[16], bhi[16];
+    uint8x16_t lo, hi, tbit;
+    size_t     k;
+
+    if (n < HSIMD_TRTMIN)
+        return trtr_generic( p, n, fct );
+
+    trt_bitmaps( fct, blo, bhi );
+    lo   = vld1q_u8( blo );
+    hi   = vld1q_u8( bhi );
+    tbit = vld1q_u8( hsimd_bits );
+
+    for (k=0; k + 16 <= n; k += 16)
+        if (vmaxvq_u8( trt_member_neon( vld1q_u8( p + n - k - 16 ), lo, hi, tbit )))
+            break;
+    return k + trtr_generic( p, n - k, fct );
+}
+
+static size_t utf8_16_neon( BYTE* d, const BYTE* s, size_t n )
+{
+    uint8x16_t z = vdupq_n_u8( 0 );
+    uint8x16_t x;
+    size_t     i;
+
+    for (i=0; i + 16 <= n; i += 16)
+    {
+        x = vld1q_u8( s + i );
+        if (vmaxvq_u8( x ) >= 0x80)
+            break;
+        vst1q_u8( d + 2*i,      vzip1q_u8( z, x ));
+        vst1q_u8( d + 2*i + 16, vzip2q_u8( z, x ));
+    }
+    return i + utf8_16_generic( d + 2*i, s + i, n - i );
+}
+
+static size_t utf8_32_neon( BYTE* d, const BYTE* s, size_t n )
+{
+    uint8x16_t  z = vdupq_n_u8( 0 );
+    uint16x8_t  z16 = vdupq_n_u16( 0 );
+    uint8x16_t  x;
+    uint16x8_t  lo, hi;
+    size_t      i;
+
+    for (i=0; i + 16 <= n; i += 16)
+    {
+        x = vld1q_u8( s + i );
+        if (vmaxvq_u8( x ) >= 0x80)
+            break;
+        lo = vreinterpretq_u16_u8( vzip1q_u8( z, x ));
+        hi = vreinterpretq_u16_u8( vzip2q_u8( z, x ));
+        vst1q_u8( d + 4*i,      vreinterpretq_u8_u16( vzip1q_u16( z16, lo )));
+        vst1q_u8( d + 4*i + 16, vreinterpretq_u8_u16( vzip2q_u16( z16, lo )));
+        vst1q_u8( d + 4*i + 32, vreinterpretq_u8_u16( vzip1q_u16( z16, hi )));
+        vst1q_u8( d + 4*i + 48, vreinterpretq_u8_u16( vzip2q_u16( z16, hi )));
+    }
+    return i + utf8_32_generic( d + 4*i, s + i, n - i );
+}
+
+static size_t utf16_8_neon( BYTE* d, const BYTE* s, size_t n )
+{
+    uint8x16_t a, b, hi, lo;
+    size_t     i;
+
+    for (i=0; i + 16 <= n; i += 16)
+    {
+        a  = vld1q_u8( s + 2*i );
+        b  = vld1q_u8( s + 2*i + 16 );
+        hi = vuzp1q_u8( a, b );
+        lo = vuzp2q_u8( a, b );
+        if (vmaxvq_u8( vorrq_u8( hi, vandq_u8( lo, vdupq_n_u8( 0x80 )))))
+            break;
+        vst1q_u8( d + i, lo );
+    }
+    return i + utf16_8_generic( d + i, s + 2*i, n - i );
+}
+
+static size_t utf16_32_neon( BYTE* d, const BYTE* s, size_t n )
+{
+    uint16x8_t z = vdupq_n_u16( 0 );
+    uint16x8_t x;
+    size_t     i;
+
+    for (i=0; i + 8 <= n; i += 8)
+    {
+        x = vreinterpretq_u16_u8( vld1q_u8( s + 2*i ));
+        if (vmaxvq_u16( vceqq_u16( vandq_u16( x, vdupq_n_u16( 0x00FC )),
+                                   vdupq_n_u16( 0x00D8 ))))
+            break;
+        vst1q_u8( d + 4*i,      vreinterpretq_u8_u16( vzip1q_u16( z, x )));
+        vst1q_u8( d + 4*i + 16, vreinterpretq_u8_u16( vzip2q_u16( z, x )));
+    }
+    return i + utf16_32_generic( d + 4*i, s + 2*i, n - i );
+}
+
+static size_t utf32_8_neon( BYTE* d, const BYTE* s, size_t n )
+{
+    uint32x4_t a, b, c, e;
+    uint16x8_t ab, ce;
+    size_t     i;
+
+    for (i=0; i + 16 <= n; i += 16)
+    {
+        a = vreinterpretq_u32_u8( vld1q_u8( s + 4*i ));
+        b = vreinterpretq_u32_u8( vld1q_u8( s + 4*i + 16 ));
+        c = vreinterpretq_u32_u8( vld1q_u8( s + 4*i + 32 ));
+        e = vreinterpretq_u32_u8( vld1q_u8( s + 4*i + 48 ));
+        if (vmaxvq_u32( vandq_u32( vorrq_u32( vorrq_u32( a, b ), vorrq_u32( c, e )),
+                                   vdupq_n_u32( 0x80FFFFFF ))))
+            break;
+        ab = vcombine_u16( vmovn_u32( vshrq_n_u32( a, 24 )), vmovn_u32( vshrq_n_u32( b, 24 )));
+        ce = vcombine_u16( vmovn_u32( vshrq_n_u32( c, 24 )), vmovn_u32( vshrq_n_u32( e, 24 )));
+        vst1q_u8( d + i, vcombine_u8( vmovn_u16( ab ), vmovn_u16( ce )));
+    }
+    return i + utf32_8_generic( d + i, s + 4*i, n - i );
+}
+
+static size_t utf32_16_neon( BYTE* d, const BYTE* s, size_t n )
+{
+    uint32x4_t m  = vdupq_n_u32( 0x0000FFFF );
+    uint32x4_t hm = vdupq_n_u32( 0x00FC0000 );
+    uint32x4_t h  = vdupq_n_u32( 0x00D80000 );
+    uint32x4_t a, b;
+    size_t     i;
+
+    for (i=0; i + 8 <= n; i += 8)
+    {
+        a = vreinterpretq_u32_u8( vld1q_u8( s + 4*i ));
+        b = vreinterpretq_u32_u8( vld1q_u8( s + 4*i + 16 ));
+        if (vmaxvq_u32( vorrq_u32( vtstq_u32( vorrq_u32( a, b ), m ),
+                        vorrq_u32( vceqq_u32( vandq_u32( a, hm ), h ),
+                                   vceqq_u32( vandq_u32( b, hm ), h )))))
+            break;
+        vst1q_u8( d + 2*i, vreinterpretq_u8_u16(
+                  vcombine_u16( vmovn_u32( vshrq_n_u32( a, 16 )),
+                                vmovn_u32( vshrq_n_u32( b, 16 )))));
+    }
+    return i + utf32_16_generic( d + 2*i, s + 4*i, n - i );
+}
+#endif /* defined( HSIMD_NEON ) */
+
+/*-------------------------------------------------------------------*/
+/* Select the kernels for the host CPU (called once during startup)  */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT void hsimd_init()
+{
+#if defined( HSIMD_X86 )
+    bool    ssse3, avx2;
+#if defined( _MSVC_ )
+    int     info[4];
+    int     maxleaf;
+    __cpuid( info, 0 );
+    maxleaf = info[0];
+    __cpuid( info, 1 );
+    ssse3 = (info[2] & (1 << 9)) != 0;
+    avx2  = (info[2] & (1 << 27)) != 0                /* OSXSAVE   */
+         && (_xgetbv( 0 ) & 0x06) == 0x06;            /* YMM state */
+    if (maxleaf >= 7)
+    {
+        __cpuidex( info, 7, 0 );
+        avx2 = avx2 && (info[1] & (1 << 5)) != 0;
+    }
+    else
+        avx2 = false;
+#else
+    __builtin_cpu_init();
+    ssse3 = __builtin_cpu_supports( "ssse3" ) ? true : false;
+    avx2  = __builtin_cpu_supports( "avx2"  ) ? true : false;
+#endif
+
+    p_clst      = clst_sse2;
+    p_first_equ = first_equ_sse2;
+    p_last_neq  = last_neq_sse2;
+    p_find_hw   = find_hw_sse2;
+    p_utf[0][1] = utf8_16_sse2;
+    p_utf[0][2] = utf8_32_sse2;
+    p_utf[1][0] = utf16_8_sse2;
+    p_utf[1][2] = utf16_32_sse2;
+    p_utf[2][0] = utf32_8_sse2;
+    p_utf[2][1] = utf32_16_sse2;
+    p_stream_page = stream_page_sse2;
+
+    if (ssse3)
+    {
+        p_trt   = trt_ssse3;
+        p_trtr  = trtr_ssse3;
+    }
+    if (avx2)
+    {
+        p_clst      = clst_avx2;
+        p_first_equ = first_equ_avx2;
+        p_last_neq  = last_neq_avx2;
+        p_find_hw   = find_hw_avx2;
+        p_trt       = trt_avx2;
+        p_trtr      = trtr_avx2;
+    }
+#elif defined( HSIMD_NEON )
+    p_clst      = clst_neon;
+    p_first_equ = first_equ_neon;
+    p_last_neq  = last_neq_neon;
+    p_find_hw   = find_hw_neon;
+    p_trt       = trt_neon;
+    p_trtr      = trtr_neon;
+    p_utf[0][1] = utf8_16_neon;
+    p_utf[0][2] = utf8_32_neon;
+    p_utf[1][0] = utf16_8_neon;
+    p_utf[1][2] = utf16_32_neon;
+    p_utf[2][0] = utf32_8_neon;
+    p_utf[2][1] = utf32_16_neon;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/* Number of leading bytes of a and b which are equal and are not    */
+/* the terminating character (CLST)                                  */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT size_t hsimd_clst( const BYTE* a, const BYTE* b, size_t n, BYTE term )
+{
+    return p_clst( a, b, n, term );
+}
+
+/*-------------------------------------------------------------------*/
+/* Index of the first equal byte of a and b, or n if none (CUSE)     */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT size_t hsimd_first_equ( const BYTE* a, const BYTE* b, size_t n )
+{
+    return p_first_equ( a, b, n );
+}
+
+/*-------------------------------------------------------------------*/
+/* Number of trailing bytes of a and b which are equal (CUSE)        */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT size_t hsimd_last_neq( const BYTE* a, const BYTE* b, size_t n )
+{
+    return p_last_neq( a, b, n );
+}
+
+/*-------------------------------------------------------------------*/
+/* Index of the first of n big-endian halfwords equal to c, or n if  */
+/* none (SRSTU)                                                      */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT size_t hsimd_find_hw( const BYTE* p, size_t n, U16 c )
+{
+    return p_find_hw( p, n, c );
+}
+
+/*-------------------------------------------------------------------*/
+/* Index of the first byte with a nonzero function code in the 256   */
+/* byte table fct, or n if none (TRT, TRTE)                          */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT size_t hsimd_trt( const BYTE* p, size_t n, const BYTE* fct )
+{
+    return p_trt( p, n, fct );
+}
+
+/*-------------------------------------------------------------------*/
+/* Number of trailing bytes with a zero function code (TRTR, TRTRE)  */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT size_t hsimd_trtr( const BYTE* p, size_t n, const BYTE* fct )
+{
+    return p_trtr( p, n, fct );
+}
+
+/*-------------------------------------------------------------------*/
+/* Convert the leading characters of n source characters of ssz      */
+/* bytes each into destination characters of dsz bytes each which   */
+/* need a single unit in both formats; returns how many were done    */
+/* (CU12, CU14, CU21, CU24, CU41, CU42)                              */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT size_t hsimd_utf( BYTE* d, int dsz, const BYTE* s, int ssz, size_t n )
+{
+    return p_utf[ ssz >> 1 ][ dsz >> 1 ]( d, s, n );
+}
+
+/*-------------------------------------------------------------------*/
+/* Copy a 4K page to a destination which will not be referenced soon */
+/* (PGOUT, MVPG to expanded storage); both must be 16-byte aligned   */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT void hsimd_stream_page( BYTE* d, const BYTE* s )
+{
+    p_stream_page( d, s );
+}
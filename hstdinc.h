@@ -173,6 +173,12 @@
 #ifdef HAVE_SYS_MOUNT_H
   #include <sys/mount.h>
 #endif
+#ifdef HAVE_SYS_EVENTFD_H
+  #include <sys/eventfd.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+  #include <sys/mman.h>
+#endif
 #ifdef HAVE_SYS_MTIO_H
   #include <sys/mtio.h>
 #endif
@@ -249,6 +255,12 @@
 #ifdef HAVE_ZLIB_H
   #include <zlib.h>
 #endif
+#if defined(HAVE_ZSTD) && defined(HAVE_ZSTD_H)
+  #include <zstd.h>
+#endif
+#if defined(HAVE_LZ4) && defined(HAVE_LZ4_H)
+  #include <lz4.h>
+#endif
 #ifdef HAVE_SYS_CAPABILITY_H
   #include <sys/capability.h>
 #endif
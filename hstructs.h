@@ -285,6 +285,16 @@ struct REGS {                           /* Processor registers       */
         U64     waittod;                /* Time of day last wait     */
         U64     waittime;               /* Wait time in interval     */
         U64     waittime_accumulated;   /* Wait time accumulated     */
+        U64     waketod;                /* Time of day of wakeup     */
+        U64     wakecount;              /* Wait state wakeups        */
+        U64     wakespin;               /* ...taken while spinning   */
+        U64     waketotal;              /* ...total wakeup latency   */
+        U64     wakemax;                /* ...maximum wakeup latency */
+        U32     spinlimit;              /* Adaptive spin (usecs)     */
+        volatile U32 wakeword;          /* Wait state wakeup word    */
+#define CPU_WAKE_POSTED     0           /* Not waiting or woken      */
+#define CPU_WAKE_SPINNING   1           /* Polling wakeword          */
+#define CPU_WAKE_SLEEPING   2           /* Sleeping on wakeword      */
 
         CACHE_ALIGN
         DAT     dat;                    /* Fields for DAT use        */
@@ -352,6 +362,7 @@ struct REGS {                           /* Processor registers       */
         RADR    sie_rcpo;               /* Ref and Change Preserv.   */
         RADR    sie_scao;               /* System Contol Area        */
         S64     sie_epoch;              /* TOD offset in state desc. */
+        SIECACHE *siecache;             /* SIE state cache   (guest) */
 #endif
         unsigned int
                 sie_active:1,           /* SIE active   (host  only) */
@@ -592,6 +603,48 @@ struct ZPBLK {
 };
 // #endif /*defined(FEATURE_REGION_RELOCATE)*/
 
+#if defined( _FEATURE_SIE )
+/*-------------------------------------------------------------------*/
+/* SIE state descriptor cache     (one per host CPU; see sie.c)      */
+/*-------------------------------------------------------------------*/
+#define SIE_CACHE_ENTRIES   16          /* State descriptors per CPU */
+#define SIE_CACHE_KEYSIZE   128         /* Max raw SIEBK key bytes   */
+#define SIE_CACHE_CODES     20          /* Interception code / 4     */
+
+struct SIECENT {
+        RADR    sd;                     /* State descriptor address  */
+        U64     lastuse;                /* LRU clock of last entry   */
+        U32     keylen;                 /* Key length; 0 = not valid */
+        BYTE    key[ SIE_CACHE_KEYSIZE ];   /* SIEBK fields decoded  */
+        BYTE    hostfac[ STFL_HERC_BY_SIZE ];   /* Host facilities   */
+        BYTE    fldfac [ STFL_HERC_BY_SIZE ];   /* FLD facility list */
+        BYTE    facility_list[ STFL_HERC_BY_SIZE ]; /* Guest result  */
+        BYTE   *mainstor;               /* Decoded guest storage     */
+        BYTE   *storkeys;               /* Decoded guest storkeys    */
+        RADR    mainlim;                /* Decoded guest storage lim */
+        RADR    sie_mso;                /* Decoded main stor. origin */
+        RADR    sie_xso;                /* Decoded exp. stor. origin */
+        RADR    sie_xsl;                /* Decoded exp. stor. limit  */
+        RADR    sie_rcpo;               /* Decoded RCP origin        */
+        RADR    sie_scao;               /* Decoded SCA origin        */
+        bool    sie_pref;               /* Decoded preferred mode    */
+        bool    sie_fld;                /* Decoded FLD present       */
+        U64     entries;                /* SIE entries               */
+        U64     hits;                   /* Decoded state reused      */
+        U64     tlbkept;                /* Guest TLB kept on entry   */
+        U64     codes[ SIE_CACHE_CODES ];   /* Exits by SIEBK c / 4  */
+};
+
+struct SIECACHE {
+        U64     clock;                  /* LRU clock                 */
+        U32     gen;                    /* sysblk.siecache_gen seen  */
+        U32     keylen;                 /* Key built for this entry  */
+        BYTE    key[ SIE_CACHE_KEYSIZE ];   /* (work)                */
+        SIECENT *cur;                   /* Entry of current SIEBK    */
+        SIECENT ent[ SIE_CACHE_ENTRIES ];   /* Cached descriptors    */
+};
+#endif /* defined( _FEATURE_SIE ) */
+
 /*-------------------------------------------------------------------*/
 /* Guest System Information block   EBCDIC DATA                      */
 /*-------------------------------------------------------------------*/
@@ -623,6 +676,36 @@ enum OPERATION_MODE
 };
 
 
+/*-------------------------------------------------------------------*/
+/* I/O interrupt queue                                               */
+/*-------------------------------------------------------------------*/
+/* Interrupts are queued in one bucket per interruption subclass     */
+/* (ISC 0-7 from bits 16-23 of the priority, plus one bucket for no  */
+/* ISC) so that enqueue is normally a tail append and presentation   */
+/* can skip the subclasses a CPU is disabled for in CR6. Within a    */
+/* bucket entries remain ordered by CSS and control unit priority.   */
+/*-------------------------------------------------------------------*/
+
+#define IOINTQ_BUCKETS      9           /* ISC 0-7 and no ISC        */
+#define IOINTQ_DEPTH_BINS   16          /* log2 queue depth bins     */
+#define IOINTQ_LAT_BINS     24          /* log2 microseconds bins    */
+
+struct IOINTQ {                         /* I/O interrupt queue bucket*/
+        IOINT  *head;                   /* -> highest priority entry */
+        IOINT  *tail;                   /* -> lowest priority entry  */
+};
+
+struct IOINTSTAT {                      /* I/O interrupt queue stats */
+        U64     queued;                 /* Interrupts queued         */
+        U64     presented;              /* Interrupts presented      */
+        U64     hinted;                 /* Affinity CPU woken        */
+        int     depth;                  /* Current queue depth       */
+        int     maxdepth;               /* Maximum queue depth       */
+        U64     depthbin[ IOINTQ_DEPTH_BINS ]; /* Depth when queued  */
+        U64     latbin[ IOINTQ_LAT_BINS ];     /* Queued to presented*/
+};
+
+
 /*-------------------------------------------------------------------*/
 /* System configuration block                                        */
 /*-------------------------------------------------------------------*/
@@ -659,6 +742,7 @@ struct SYSBLK {
         BYTE   *xpndstor;               /* -> Expanded storage       */
         u_int   lock_xpndstor:1;        /* Request xpndstor to lock  */
         u_int   xpndstor_locked:1;      /* Expanded storage locked   */
+        bool    xpndstream;             /* Non-temporal xpndstor move*/
         U64     todstart;               /* Time of initialisation    */
         U64     cpuid;                  /* CPU identifier for STIDP  */
         U32     cpuserial;              /* CPU serial number         */
@@ -813,6 +897,8 @@ atomic_update64( &sysblk.txf_stats[ contran ? 1 : 0 ].txf_ ## ctr, +1 )
 #endif
 #if defined(_FEATURE_SIE)
         ZPBLK   zpb[FEATURE_SIE_MAXZONES];  /* SIE Zone Parameter Blk*/
+        bool    siecache;               /* SIE state cache enabled   */
+        U32     siecache_gen;           /* SIE state cache reset gen */
 #endif /*defined(_FEATURE_SIE)*/
 #if defined(OPTION_FOOTPRINT_BUFFER)
         REGS    footprregs[ MAX_CPU_ENGS ][OPTION_FOOTPRINT_BUFFER];
@@ -905,6 +991,7 @@ atomic_update64( &sysblk.txf_stats[ contran ? 1 : 0 ].txf_ ## ctr, +1 )
 
         int     timerint;               /* microsecs timer interval  */
         int     cfg_timerint;           /* (value defined in config) */
+        int     profint;                /* Profiler interval (0=off) */
         char   *pantitle;               /* Alt console panel title   */
 #if defined( OPTION_SCSI_TAPE )
         /* Access to all SCSI fields controlled by sysblk.stape_lock */
@@ -947,7 +1034,9 @@ atomic_update64( &sysblk.txf_stats[ contran ? 1 : 0 ].txf_ ## ctr, +1 )
         U32     crwalloc;               /* #of entries allocated     */
         U32     crwcount;               /* #of entries queued        */
         U32     crwindex;               /* CRW queue index           */
-        IOINT  *iointq;                 /* I/O interrupt queue       */
+        IOINTQ  iointq[ IOINTQ_BUCKETS ];/* I/O interrupt queue by ISC*/
+        U16     iointqmask;             /* Bit n on = bucket n used  */
+        IOINTSTAT iointstat;            /* I/O interrupt queue stats */
         DEVBLK *ioq;                    /* I/O queue                 */
         LOCK    ioqlock;                /* I/O queue lock            */
         COND    ioqcond;                /* I/O queue condition       */
@@ -964,6 +1053,12 @@ atomic_update64( &sysblk.txf_stats[ contran ? 1 : 0 ].txf_ ## ctr, +1 )
         U64     bioparm;                /* Block I/O interrupt parm  */
         DEVBLK  *biodev;                /* Block I/O device          */
         /* Note: biodev is only used to detect BIO interrupt tracing */
+        LOCK    vmd250lock;             /* Block I/O worker LOCK     */
+        COND    vmd250cond;             /* Block I/O worker COND     */
+        DEVBLK *vmd250q;                /* Devices with async reqs   */
+        DEVBLK *vmd250ql;               /* Last device with requests */
+        int     vmd250workers;          /* Block I/O workers started */
+        int     vmd250idle;             /* Block I/O workers waiting */
 #endif /* defined(FEATURE_VM_BLOCKIO) */
         TAMDIR *tamdir;                 /* Acc/Rej AUTOMOUNT dir ctl */
         char   *defdir;                 /* Default AUTOMOUNT dir     */
@@ -1001,12 +1096,16 @@ atomic_update64( &sysblk.txf_stats[ contran ? 1 : 0 ].txf_ ## ctr, +1 )
                 haveiplparm:1,          /* IPL PARM a la VM          */
                 logoptnodate:1,         /* 1 = don't datestamp log   */
                 logoptnotime:1,         /* 1 = don't timestamp log   */
+                logoptcompress:1,       /* 1 = gzip rotated logfiles */
+                logoptdrop:1,           /* 1 = drop msgs if log full */
                 nolrasoe:1,             /* 1 = No trace LRA Special  */
                                         /*     Operation Exceptions  */
                 noch9oflow:1,           /* Suppress CH9 O'Flow trace */
                 devnameonly:1,          /* Display only dev filename */
                 config_processed;       /* config file processed     */
         int     quitmout;               /* quit timeout value        */
+        U64     logrotsize;             /* Rotate logfile at size    */
+        int     logrottime;             /* Rotate logfile after secs */
         U32     ints_state;             /* Common Interrupts Status  */
         CPU_BITMAP config_mask;         /* Configured CPUs           */
         CPU_BITMAP started_mask;        /* Started CPUs              */
@@ -1041,6 +1140,14 @@ atomic_update64( &sysblk.txf_stats[ contran ? 1 : 0 ].txf_ ## ctr, +1 )
         int     cpuprio;                /* CPU thread priority       */
         int     devprio;                /* Device thread priority    */
         int     srvprio;                /* Listeners thread priority */
+        HCPUSET cpuaff[ MAX_CPU_ENGS ]; /* CPU thread host CPU sets  */
+        HCPUSET devaff;                 /* Device thread host CPUs   */
+        HCPUSET todaff;                 /* Timer thread host CPUs    */
+        HCPUSET srvaff;                 /* Service thread host CPUs  */
+        U32     affgen;                 /* Affinity change generation*/
+        int     numapolicy;             /* Mainstor NUMA policy      */
+        HCPUSET numanodes;              /* Mainstor NUMA node set    */
+        U32     waitspin;               /* CPU wait spin limit usecs */
         TID     httptid;                /* HTTP listener thread id   */
 
      /* Fields used by SYNCHRONIZE_CPUS */
@@ -1061,6 +1168,15 @@ atomic_update64( &sysblk.txf_stats[ contran ? 1 : 0 ].txf_ ## ctr, +1 )
         SHRD_TRACE  *shrdtracex;        /* End of trace table        */
         int          shrdtracen;        /* Number of entries         */
         bool         shrddtax;          /* true=dump table at exit   */
+        int     shrdmaxsys;             /* Max clients per device    */
+        int     shrdworkers;            /* Number of worker threads  */
+        int     shrdworking;            /* Worker threads started    */
+        LOCK    shrdwrklock;            /* Worker queue LOCK         */
+        COND    shrdwrkcond;            /* Worker queue COND         */
+        DEVBLK *shrdwrkq;               /* Devices with requests     */
+        DEVBLK *shrdwrkql;              /* Last device with requests */
+        LOCK    shrdmuxlock;            /* Client connections LOCK   */
+        SHRD_MUX *shrdmux;              /* Client connections        */
 #endif
 #ifdef OPTION_IODELAY_KLUDGE
         int     iodelay;                /* I/O delay kludge for linux*/
@@ -1183,12 +1299,16 @@ atomic_update64( &sysblk.txf_stats[ contran ? 1 : 0 ].txf_ ## ctr, +1 )
 
 struct IOINT {                          /* I/O interrupt queue entry */
         IOINT  *next;                   /* -> next interrupt entry   */
+        IOINT  *prev;                   /* -> previous entry         */
         DEVBLK *dev;                    /* -> Device block           */
         int     priority;               /* Device priority           */
+        int     bucket;                 /* sysblk.iointq[] index     */
+        TOD     qtod;                   /* host_tod() when queued    */
         unsigned int
                 pending:1,              /* 1=Normal interrupt        */
                 pcipending:1,           /* 1=PCI interrupt           */
-                attnpending:1;          /* 1=ATTN interrupt          */
+                attnpending:1,          /* 1=ATTN interrupt          */
+                queued:1;               /* 1=On sysblk.iointq        */
 };
 
 /*-------------------------------------------------------------------*/
@@ -1357,6 +1477,33 @@ struct DEVBLK {                         /* Device configuration block*/
         int     cachemisses;            /* Cache misses              */
         int     cachewaits;             /* Cache waits               */
 
+        /*  write-back of uncompressed CKD/FBA images ("writeback")  */
+
+        int     wbpending;              /* Images waiting for write  */
+        int     wbsync;                 /* fdatasync interval (secs)
+                                           0=after every write       */
+        int     wberrno;                /* errno of failed write     */
+        int     wbfailed;               /* Images whose write failed */
+        int     wbwriting;              /* Images being written      */
+        time_t  wbsynctime;             /* Time of last fdatasync    */
+        time_t  wbfailtime;             /* Time of last failed write */
+        BYTE    wback;                  /* DEVBUF_TYPE_CKD/FBA if
+                                           write-back enabled, else 0*/
+        BYTE    wbunsynced;             /* 1=Written since fdatasync */
+
+        /*  memory-mapped uncompressed CKD/FBA images ("mmap")       */
+
+        BYTE   *dasdmap[CKD_MAXFILES];  /* -> Mapped image files     */
+        U64     dasdmaplen[CKD_MAXFILES];/* Length of each mapping   */
+        int     dasdmapnext;            /* Next image if sequential  */
+        int     dasdmapseq;             /* Sequential images read    */
+        int     dasdmapwill;            /* First image not yet
+                                           advised MADV_WILLNEED     */
+        BYTE    dasdmapreq;             /* 1=mmap option specified   */
+        BYTE    dasdmapped;             /* DEVBUF_TYPE_CKD/FBA if
+                                           image files are mapped    */
+        BYTE    dasdmapdirty;           /* 1=Updated since MS_SYNC   */
+
         /*  device compression support                               */
 
         int     comps;                  /* Acceptable compressions   */
@@ -1367,6 +1514,8 @@ struct DEVBLK {                         /* Device configuration block*/
 
         TID     tid;                    /* Thread-id executing CCW   */
         int     priority;               /* I/O q scehduling priority */
+        int     intcpu;                 /* CPU that last took an
+                                           I/O interrupt (hint)      */
         DEVBLK *nextioq;                /* -> next device in I/O q   */
         IOINT   ioint;                  /* Normal i/o interrupt
                                                queue entry           */
@@ -1486,6 +1635,14 @@ struct DEVBLK {                         /* Device configuration block*/
 
         /*  Execute Channel Pgm Counts */
         U64     excps;                  /* Number of channel pgms Ex */
+        U64     excpstod;               /* TOD current chan pgm start*/
+        U64     excptime;               /* Total chan pgm time (ETOD)*/
+
+        /*  Network adapter counts (QETH, LCS)                       */
+        U64     netrxpkts;              /* Packets received          */
+        U64     netrxbytes;             /* Bytes received            */
+        U64     nettxpkts;              /* Packets sent              */
+        U64     nettxbytes;             /* Bytes sent                */
 
         /*  Device dependent data (generic)                          */
         void    *dev_data;
@@ -1496,6 +1653,18 @@ struct DEVBLK {                         /* Device configuration block*/
 #if defined(_FEATURE_VM_BLOCKIO)
         /* VM DIAGNOSE X'250' Emulation Environment                  */
         struct VMBIOENV *vmd250env;     /* Established environment   */
+        struct VMBIOREQ *vmd250rq;      /* Queued async requests     */
+        struct VMBIOREQ *vmd250rql;     /* Last queued async request */
+        DEVBLK *vmd250next;             /* -> Next device with reqs  */
+        BYTE    vmd250sched;            /* 1=Queued for a worker     */
+        U32     vmd250qdepth;           /* Async requests queued     */
+        U32     vmd250qmax;             /* Most async requests queued*/
+        U64     vmd250reqs;             /* Block I/O requests        */
+        U64     vmd250async;            /* ...of which asynchronous  */
+        U64     vmd250qwait;            /* Async usecs spent queued  */
+        U64     vmd250rdblks;           /* Blocks read               */
+        U64     vmd250wrblks;           /* Blocks written            */
+        U64     vmd250ios;              /* Device driver calls       */
 #endif /* defined(FEATURE_VM_BLOCKIO) */
 
         /*  Fields for remote devices                                */
@@ -1518,7 +1687,21 @@ struct DEVBLK {                         /* Device configuration block*/
         int     shrdid;                 /* Id for next client        */
         int     shrdconn;               /* Number connected clients  */
         int     shrdwait;               /* Signal indicator          */
-        SHRD   *shrd[SHARED_MAX_SYS];   /* ->SHRD block              */
+        SHRD  **shrd;                   /* ->SHRD block table        */
+        int     shrdmax;                /* Size of SHRD block table  */
+        int     shrdrr;                 /* Next SHRD block to serve  */
+        bool    shrdsched;              /* true=Queued for a worker  */
+        DEVBLK *shrdnext;               /* -> Next scheduled device  */
+        SHRD_MUX *rmtmux;               /* Multiplexed connection    */
+        DEVBLK *rmtmuxnext;             /* -> Next device on rmtmux  */
+        SHRD_MSG *rmtq;                 /* Received responses        */
+        SHRD_MSG *rmtqlast;             /* Last received response    */
+        COND    rmtcond;                /* Response received COND    */
+        int     rmtcompalg;             /* Remote compression method */
+        int     rmtposted;              /* Unanswered requests       */
+        bool    rmtpurgeall;            /* true=Purge at next request*/
+        BYTE    rmtpostcmd[SHARED_MAX_POSTED]; /* Unanswered cmds    */
+        int     rmtpostrcd[SHARED_MAX_POSTED]; /* Unanswered records */
 #endif
 
         /*  Device dependent fields for console                      */
@@ -1601,6 +1784,9 @@ struct DEVBLK {                         /* Device configuration block*/
         u_int   ctce_system_reset:1;    /* CTCE initialized          */
         u_int   ctce_buf_next_read:1;   /* CTCE alt. buf use RD      */
         u_int   ctce_buf_next_write:1;  /* CTCE alt. buf use WR      */
+        u_int   ctce_shm:1;             /* CTCE SHM transport wanted */
+        void*   ctce_shm_tx;            /* CTCE SHM send ring        */
+        void*   ctce_shm_rx;            /* CTCE SHM receive ring     */
 
         /*  Device dependent fields for printer                      */
 
@@ -1665,12 +1851,16 @@ struct DEVBLK {                         /* Device configuration block*/
         U16     tapssdlen;              /* #of bytes of data prepared
                                            for Read Subsystem Data   */
         HETB   *hetb;                   /* HET control block         */
+        void   *tapeidx;                /* -> TAPEIDX block index    */
+        U32     tapeidxcnt;             /* Blocks 0 to cnt-1 indexed */
+        U32     tapeidxmax;             /* Index entries allocated   */
+        void   *tapestrm;               /* -> TAPESTRM engine        */
 
         struct                          /* TAPE device parms         */
         {
           u_int compress:1;             /* 1=Compression enabled     */
           u_int method:3;               /* Compression method        */
-          u_int level:4;                /* Compression level         */
+          u_int level:5;                /* Compression level         */
           u_int strictsize:1;           /* Strictly enforce MAXSIZE  */
           u_int displayfeat:1;          /* Device has a display      */
                                         /* feature installed         */
@@ -1683,6 +1873,9 @@ struct DEVBLK {                         /* Device configuration block*/
           u_int SL_tape_mounted:1;      /* Tape is SL labeled        */
           u_int AL_tape_mounted:1;      /* Tape is AL labeled        */
           U16   chksize;                /* Chunk size                */
+          U16   stream;                 /* Read-ahead/write-behind
+                                           depth in blocks, 0 = off  */
+          U16   cthreads;               /* HET compression threads   */
           off_t maxsize;                /* Maximum allowed TAPE file
                                            size                      */
 /* These are not obsolete and are being used for new development     */
@@ -13,6 +13,11 @@
 
 #include "hstdinc.h"
 
+#if defined( __linux__ )
+  #include <sys/syscall.h>              /* SYS_futex                 */
+  #include <linux/futex.h>              /* FUTEX_WAIT_PRIVATE, etc   */
+#endif
+
 #define _HTHREAD_C_
 #define _HUTIL_DLL_
 
@@ -54,6 +59,9 @@ struct ILOCK                    /* Hercules internal ILOCK structure */
     const char*  il_cr_locat;   /* Location where lock was created   */
     TIMEVAL      il_cr_time;    /* Time of day when it was created   */
     TID          il_cr_tid;     /* Thread-Id of who created it       */
+    U64          il_obtains;    /* Exclusive obtains (il_locklock)   */
+    U64          il_contended;  /* Obtains which had to wait         */
+    U64          il_waittime;   /* Total time waited (ETOD units)    */
 };
 typedef struct ILOCK ILOCK;     /* Shorter name for the same thing   */
 
@@ -531,6 +539,12 @@ DLL_EXPORT int  hthread_obtain_lock( LOCK* plk, const char* obtain_loc )
             ilk->il_ob_locat = obtain_loc;
             ilk->il_ob_tid = hthread_self();
             memcpy( &ilk->il_ob_time, &tv, sizeof( TIMEVAL ));
+            ilk->il_obtains++;
+            if (waitdur)
+            {
+                ilk->il_contended++;
+                ilk->il_waittime += waitdur;
+            }
         }
         hthread_mutex_unlock( &ilk->il_locklock );
     }
@@ -743,6 +757,17 @@ DLL_EXPORT int  hthread_obtain_rdlock( RWLOCK* plk, const char* obtain_loc )
     hthread_lock_obtained();
     if (rc)
         loglock( ilk, rc, "obtain_rdloc", obtain_loc );
+    else if (waitdur)
+    {
+        /* (uncontended shared obtains are not counted so that
+            readers are never serialized on il_locklock) */
+        hthread_mutex_lock( &ilk->il_locklock );
+        {
+            ilk->il_contended++;
+            ilk->il_waittime += waitdur;
+        }
+        hthread_mutex_unlock( &ilk->il_locklock );
+    }
     return rc;
 }
 
@@ -782,6 +807,12 @@ DLL_EXPORT int  hthread_obtain_wrlock( RWLOCK* plk, const char* obtain_loc )
             ilk->il_ob_locat = obtain_loc;
             ilk->il_ob_tid = hthread_self();
             memcpy( &ilk->il_ob_time, &tv, sizeof( TIMEVAL ));
+            ilk->il_obtains++;
+            if (waitdur)
+            {
+                ilk->il_contended++;
+                ilk->il_waittime += waitdur;
+            }
         }
         hthread_mutex_unlock( &ilk->il_locklock );
     }
@@ -1209,6 +1240,220 @@ DLL_EXPORT int hthread_get_thread_prio( TID tid, const char* prio_loc )
     return prio;
 }
 
+/*-------------------------------------------------------------------*/
+/* Bind a thread to a set of host CPUs           (HTHREADS function) */
+/*-------------------------------------------------------------------*/
+/* An empty set releases the thread to run on any host CPU again.    */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT int hthread_set_thread_affinity( TID tid, const HCPUSET* set, const char* aff_loc )
+{
+    int rc;
+
+    if (equal_threads( tid, 0 ))
+        tid = hthread_self();
+
+#if defined( __linux__ ) && defined( CPU_SETSIZE )
+    {
+        cpu_set_t  cpus;
+        int        n;
+
+        CPU_ZERO( &cpus );
+
+        for (n=0; n < HCPUSET_MAX && n < CPU_SETSIZE; n++)
+            if (hthread_cpuset_isempty( set )
+                || (set->bits[ n / 64 ] & (1ULL << (n % 64))))
+                CPU_SET( n, &cpus );
+
+        rc = pthread_setaffinity_np( tid, sizeof( cpus ), &cpus );
+    }
+#else
+    UNREFERENCED( set );
+    rc = ENOTSUP;
+#endif
+
+    if (rc != 0)
+    {
+        // "'%s' failed at loc=%s: rc=%d: %s"
+        WRMSG( HHC90020, "W", "pthread_setaffinity_np()",
+            TRIMLOC( aff_loc ), rc, strerror( rc ));
+    }
+    return rc;
+}
+
+/*-------------------------------------------------------------------*/
+/* Parse a host CPU list such as "0-3,8,10-11"    (HTHREADS helper)  */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT bool hthread_parse_cpuset( const char* list, HCPUSET* set )
+{
+    const char*  p = list;
+    char*        end;
+    long         lo, hi;
+
+    memset( set, 0, sizeof( HCPUSET ));
+
+    if (!p || !*p)
+        return false;
+
+    while (*p)
+    {
+        if (!isdigit( (unsigned char) *p ))
+            return false;
+
+        lo = hi = strtol( p, &end, 10 );
+        p = end;
+
+        if (*p == '-')
+        {
+            if (!isdigit( (unsigned char) *++p ))
+                return false;
+            hi = strtol( p, &end, 10 );
+            p = end;
+        }
+
+        if (lo > hi || hi >= HCPUSET_MAX)
+            return false;
+
+        for (; lo <= hi; lo++)
+            set->bits[ lo / 64 ] |= (1ULL << (lo % 64));
+
+        if (*p == ',')
+        {
+            if (!*++p)
+                return false;
+        }
+        else if (*p)
+            return false;
+    }
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/* Format a host CPU set as a compact list        (HTHREADS helper)  */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT char* hthread_format_cpuset( const HCPUSET* set, char* buf, size_t bufsz )
+{
+    size_t  len = 0;
+    int     lo, hi;
+
+    #define CPUSET_BIT( n )  (set->bits[ (n) / 64 ] & (1ULL << ((n) % 64)))
+
+    buf[0] = 0;
+
+    for (lo=0; lo < HCPUSET_MAX && len < bufsz; lo = hi + 1)
+    {
+        if (!CPUSET_BIT( lo ))
+        {
+            hi = lo;
+            continue;
+        }
+
+        for (hi = lo; hi+1 < HCPUSET_MAX && CPUSET_BIT( hi+1 ); hi++);
+
+        if (hi == lo)
+            len += snprintf( buf + len, bufsz - len, "%s%d",
+                len ? "," : "", lo );
+        else
+            len += snprintf( buf + len, bufsz - len, "%s%d-%d",
+                len ? "," : "", lo, hi );
+    }
+
+    #undef CPUSET_BIT
+
+    if (!buf[0])
+        strlcpy( buf, "*", bufsz );
+
+    return buf;
+}
+
+/*-------------------------------------------------------------------*/
+/* Return true if no host CPU has been specified  (HTHREADS helper)  */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT bool hthread_cpuset_isempty( const HCPUSET* set )
+{
+    size_t  i;
+
+    for (i=0; i < _countof( set->bits ); i++)
+        if (set->bits[i])
+            return false;
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/* Sleep while a word holds a given value         (HTHREADS function)*/
+/*-------------------------------------------------------------------*/
+/* Returns 0 once woken (possibly spuriously, so the caller must     */
+/* recheck the word) or ENOTSUP if the host has no futex support.    */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT int hthread_wait_word( volatile U32* word, U32 val )
+{
+#if defined( __linux__ ) && defined( SYS_futex )
+    if (syscall( SYS_futex, word, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0 ) != 0
+        && errno == ENOSYS)
+        return ENOTSUP;
+    return 0;
+#else
+    UNREFERENCED( word );
+    UNREFERENCED( val );
+    return ENOTSUP;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/* Wake a thread sleeping in hthread_wait_word    (HTHREADS function)*/
+/*-------------------------------------------------------------------*/
+DLL_EXPORT void hthread_wake_word( volatile U32* word )
+{
+#if defined( __linux__ ) && defined( SYS_futex )
+    syscall( SYS_futex, word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0 );
+#else
+    UNREFERENCED( word );
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/* Sleep while a word in shared memory holds a value (HTHREADS func) */
+/*-------------------------------------------------------------------*/
+/* As hthread_wait_word, but the word may be in memory mapped by     */
+/* another process and the wait ends after 'msecs' milliseconds,     */
+/* returning ETIMEDOUT.                                              */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT int hthread_wait_shared_word( volatile U32* word, U32 val, int msecs )
+{
+#if defined( __linux__ ) && defined( SYS_futex )
+    struct timespec  ts;
+
+    ts.tv_sec  = msecs / 1000;
+    ts.tv_nsec = (msecs % 1000) * 1000000;
+
+    if (syscall( SYS_futex, word, FUTEX_WAIT, val, &ts, NULL, 0 ) != 0)
+    {
+        if (errno == ENOSYS)
+            return ENOTSUP;
+        if (errno == ETIMEDOUT)
+            return ETIMEDOUT;
+    }
+    return 0;
+#else
+    UNREFERENCED( word );
+    UNREFERENCED( val );
+    UNREFERENCED( msecs );
+    return ENOTSUP;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/* Wake a hthread_wait_shared_word sleeper        (HTHREADS function)*/
+/*-------------------------------------------------------------------*/
+DLL_EXPORT void hthread_wake_shared_word( volatile U32* word )
+{
+#if defined( __linux__ ) && defined( SYS_futex )
+    syscall( SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0 );
+#else
+    UNREFERENCED( word );
+#endif
+}
+
 /*-------------------------------------------------------------------*/
 /* locks_cmd helper function: save private copy of all locks in list */
 /*-------------------------------------------------------------------*/
@@ -1786,6 +2031,29 @@ static bool hthread_is_deadlocked_locked( const char* sev, TID tid,
     return true;
 }
 
+/*-------------------------------------------------------------------*/
+/* Report lock usage statistics through a callback for every lock    */
+/*-------------------------------------------------------------------*/
+/* The callback is invoked with the internal locks list locked and   */
+/* so must not obtain or create any Hercules lock itself.            */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT void hthread_lock_stats( LOCKSTATS_FUNC* pfn, void* arg )
+{
+    ILOCK*       ilk;
+    LIST_ENTRY*  ple;
+
+    LockLocksList();
+    {
+        for (ple = locklist.Flink; ple != &locklist; ple = ple->Flink)
+        {
+            ilk = CONTAINING_RECORD( ple, ILOCK, il_link );
+            pfn( ilk->il_name, ilk->il_obtains, ilk->il_contended,
+                 ilk->il_waittime / ETOD_USEC, arg );
+        }
+    }
+    UnlockLocksList();
+}
+
 /*-------------------------------------------------------------------*/
 /* Detect and report deadlocks - return number of deadlocked threads */
 /*-------------------------------------------------------------------*/
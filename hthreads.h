@@ -255,6 +255,8 @@ typedef void* (THREAD_FUNC)( void* );   /* Generic thread function   */
 #define PANEL_THREAD_NAME       "panel_display"
 #define SOCKET_THREAD_NAME      "socket_thread"
 #define LOGGER_THREAD_NAME      "logger_thread"
+#define LOGPIPE_THREAD_NAME     "logger_pipe"
+#define LOGHCPY_THREAD_NAME     "logger_hrdcpy"
 #define SCRIPT_THREAD_NAME      "script_thread"
 #define TIMER_THREAD_NAME       "timer_thread"
 #if defined( _FEATURE_073_TRANSACT_EXEC_FACILITY )
@@ -288,6 +290,17 @@ struct RWLOCK
 };
 typedef struct RWLOCK RWLOCK;
 
+/*-------------------------------------------------------------------*/
+/*             Host CPU set used for thread affinity                 */
+/*-------------------------------------------------------------------*/
+#define HCPUSET_MAX     1024            /* Highest host CPU number+1 */
+
+struct HCPUSET
+{
+    U64     bits[ HCPUSET_MAX / 64 ];   /* Bit n on = host CPU n     */
+};
+typedef struct HCPUSET HCPUSET;         /* All zeros = not specified */
+
 /*-------------------------------------------------------------------*/
 /*                  hthreads exported functions                      */
 /*-------------------------------------------------------------------*/
@@ -329,8 +342,19 @@ HT_DLL_IMPORT void hthread_exit_thread            ( void* rc, const char* locati
 HT_DLL_IMPORT int  hthread_equal_threads          ( TID tid1, TID tid2 );
 HT_DLL_IMPORT int  hthread_set_thread_prio        ( TID tid, int prio, const char* location );
 HT_DLL_IMPORT int  hthread_get_thread_prio        ( TID tid, const char* location );
+HT_DLL_IMPORT int  hthread_set_thread_affinity    ( TID tid, const HCPUSET* set, const char* location );
+HT_DLL_IMPORT bool hthread_parse_cpuset           ( const char* list, HCPUSET* set );
+HT_DLL_IMPORT char* hthread_format_cpuset         ( const HCPUSET* set, char* buf, size_t bufsz );
+HT_DLL_IMPORT bool hthread_cpuset_isempty         ( const HCPUSET* set );
+HT_DLL_IMPORT int  hthread_wait_word              ( volatile U32* word, U32 val );
+HT_DLL_IMPORT void hthread_wake_word              ( volatile U32* word );
+HT_DLL_IMPORT int  hthread_wait_shared_word       ( volatile U32* word, U32 val, int msecs );
+HT_DLL_IMPORT void hthread_wake_shared_word       ( volatile U32* word );
 HT_DLL_IMPORT int  hthread_report_deadlocks       ( const char* sev );
 
+typedef void LOCKSTATS_FUNC( const char* name, U64 obtains, U64 contended, U64 waitusecs, void* arg );
+HT_DLL_IMPORT void hthread_lock_stats             ( LOCKSTATS_FUNC* pfn, void* arg );
+
 HT_DLL_IMPORT void        hthread_set_lock_name   ( LOCK* plk, const char* name );
 HT_DLL_IMPORT const char* hthread_get_lock_name   ( const LOCK* plk );
 HT_DLL_IMPORT void        hthread_set_thread_name ( TID tid, const char* name );
@@ -376,6 +400,8 @@ HT_DLL_IMPORT const char* hthread_get_thread_name ( TID tid, char* buffer16 );
 #define get_thread_priority()                   hthread_get_thread_prio( thread_id(), PTT_LOC )
 #define set_thread_priority_id( tid, prio )     hthread_set_thread_prio( (tid), (prio), PTT_LOC )
 #define get_thread_priority_id( tid )           hthread_get_thread_prio( (tid), PTT_LOC )
+#define set_thread_affinity( set )              hthread_set_thread_affinity( thread_id(), (set), PTT_LOC )
+#define set_thread_affinity_id( tid, set )      hthread_set_thread_affinity( (tid), (set), PTT_LOC )
 
 #define set_lock_name( plk, name )              hthread_set_lock_name( (plk), (name) )
 #define get_lock_name( plk )                    hthread_get_lock_name( (plk) )
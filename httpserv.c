@@ -651,6 +651,10 @@ static void *http_request(void* arg)
     if(!strcasecmp("/",url))
         url = HTTP_WELCOME;
 
+    /* Serve metrics where monitoring systems look for them by default */
+    if(!strcasecmp("/metrics",url))
+        url = "/cgi-bin/metrics";
+
     if(strncasecmp("/cgi-bin/",url,9))
         http_download(webblk,url);
     else
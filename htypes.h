@@ -185,10 +185,14 @@ typedef struct SYSBLK    SYSBLK;    // System configuration block
 typedef struct REGS      REGS;      // CPU register context
 typedef struct VFREGS    VFREGS;    // Vector Facility Registers
 typedef struct ZPBLK     ZPBLK;     // Zone Parameter Block
+typedef struct SIECENT   SIECENT;   // SIE state cache entry
+typedef struct SIECACHE  SIECACHE;  // SIE state cache (per CPU)
 typedef struct TELNET    TELNET;    // Telnet Control Block
 typedef struct DEVBLK    DEVBLK;    // Device configuration block
 typedef struct CHPBLK    CHPBLK;    // Channel Path config block
 typedef struct IOINT     IOINT;     // I/O interrupt queue
+typedef struct IOINTQ    IOINTQ;    // I/O interrupt queue bucket
+typedef struct IOINTSTAT IOINTSTAT; // I/O interrupt queue statistics
 
 typedef struct GSYSINFO  GSYSINFO;  // Ebcdic machine information
 
@@ -503,6 +503,127 @@ static INLINE U32 ieee_exception_test_oux( REGS* regs )
 /*           'SoftFloat' IEEE Binary Floating Point package                  */
 /*****************************************************************************/
 
+/*****************************************************************************/
+/*                                                                           */
+/*           Host FPU fast path for short and long BFP arithmetic            */
+/*                                                                           */
+/* Round to nearest even is what the host FPU does by default, so when the   */
+/* FPC selects it the host result is the IEEE result. With normal (or zero)  */
+/* operands and a normal result, the only exception still possible is        */
+/* inexact, and that changes nothing once its FPC flag is set and its trap   */
+/* is disabled, which is how nearly all code runs. Everything else (NaNs,    */
+/* infinities and subnormals, results that overflow, are zero or could be    */
+/* tiny, any other rounding mode) is left to SoftFloat.                      */
+/*****************************************************************************/
+#include <float.h>
+#if defined( FLT_EVAL_METHOD ) && FLT_EVAL_METHOD == 0
+  #define BFP_HOSTFPU           /* Host evaluates in operand precision   */
+#endif
+
+#define BFP_HOST_ADD    0
+#define BFP_HOST_SUB    1
+#define BFP_HOST_MUL    2
+#define BFP_HOST_DIV    3
+
+/* FPC allows the fast path: RNE, Xx trap disabled, Xx flag already set */
+#define BFP_HOST_FPC_OK( _regs )                                        \
+                                                                        \
+    (((_regs)->fpc & (FPC_BRM_3BIT | FPC_MASK_IMX | FPC_FLAG_SFX)) == FPC_FLAG_SFX)
+
+/* Finite and nonzero with a biased exponent of at least 1 (_min == 1, */
+/* any normal number) or 2 (_min == 2, too large to ever be tiny)      */
+#define F64_NORMAL_MIN( _v, _min )  ((((_v) >> 52) & 0x7FF) - (_min) < 0x7FF - (_min))
+#define F32_NORMAL_MIN( _v, _min )  ((((_v) >> 23) & 0xFF)  - (_min) < 0xFF  - (_min))
+
+#define F64_OPERAND_OK( _v )    (F64_NORMAL_MIN( _v, 1 ) || !((_v) << 1))
+#define F32_OPERAND_OK( _v )    (F32_NORMAL_MIN( _v, 1 ) || !((U32)((_v) << 1)))
+
+#if defined( BFP_HOSTFPU )
+static INLINE bool f64_host_op( REGS* regs, int op, float64_t a, float64_t b, float64_t* r )
+{
+    double  x, y, z;
+
+    if (0
+        || !BFP_HOST_FPC_OK( regs )
+        || !F64_OPERAND_OK( a.v )
+        || !(op == BFP_HOST_DIV ? F64_NORMAL_MIN( b.v, 1 ) : F64_OPERAND_OK( b.v ))
+    )
+        return false;
+
+    memcpy( &x, &a, sizeof( x ));
+    memcpy( &y, &b, sizeof( y ));
+
+    switch (op)
+    {
+    case BFP_HOST_ADD: z = x + y; break;
+    case BFP_HOST_SUB: z = x - y; break;
+    case BFP_HOST_MUL: z = x * y; break;
+    default:           z = x / y; break;
+    }
+
+    memcpy( r, &z, sizeof( z ));
+    return F64_NORMAL_MIN( r->v, 2 );
+}
+
+static INLINE bool f32_host_op( REGS* regs, int op, float32_t a, float32_t b, float32_t* r )
+{
+    float   x, y, z;
+
+    if (0
+        || !BFP_HOST_FPC_OK( regs )
+        || !F32_OPERAND_OK( a.v )
+        || !(op == BFP_HOST_DIV ? F32_NORMAL_MIN( b.v, 1 ) : F32_OPERAND_OK( b.v ))
+    )
+        return false;
+
+    memcpy( &x, &a, sizeof( x ));
+    memcpy( &y, &b, sizeof( y ));
+
+    switch (op)
+    {
+    case BFP_HOST_ADD: z = x + y; break;
+    case BFP_HOST_SUB: z = x - y; break;
+    case BFP_HOST_MUL: z = x * y; break;
+    default:           z = x / y; break;
+    }
+
+    memcpy( r, &z, sizeof( z ));
+    return F32_NORMAL_MIN( r->v, 2 );
+}
+
+/* The square root of a positive normal number is always normal */
+static INLINE bool f64_host_sqrt( REGS* regs, float64_t a, float64_t* r )
+{
+    double  x;
+
+    if (!BFP_HOST_FPC_OK( regs ) || (a.v >> 63) || !F64_NORMAL_MIN( a.v, 1 ))
+        return false;
+
+    memcpy( &x, &a, sizeof( x ));
+    x = sqrt( x );
+    memcpy( r, &x, sizeof( x ));
+    return true;
+}
+
+static INLINE bool f32_host_sqrt( REGS* regs, float32_t a, float32_t* r )
+{
+    float   x;
+
+    if (!BFP_HOST_FPC_OK( regs ) || (a.v >> 31) || !F32_NORMAL_MIN( a.v, 1 ))
+        return false;
+
+    memcpy( &x, &a, sizeof( x ));
+    x = sqrtf( x );
+    memcpy( r, &x, sizeof( x ));
+    return true;
+}
+#else /* !defined( BFP_HOSTFPU ) */
+  #define f64_host_op( _regs, _op, _a, _b, _r )     (false)
+  #define f32_host_op( _regs, _op, _a, _b, _r )     (false)
+  #define f64_host_sqrt( _regs, _a, _r )            (false)
+  #define f32_host_sqrt( _regs, _a, _r )            (false)
+#endif /* defined( BFP_HOSTFPU ) */
+
 struct lbfp
 {
     int     sign;
@@ -1248,7 +1369,8 @@ DEF_INST( add_bfp_long_reg )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f64_add( op1, op2 );
+    if (!f64_host_op( regs, BFP_HOST_ADD, op1, op2, &ans ))
+        ans = f64_add( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -1288,7 +1410,8 @@ DEF_INST( add_bfp_long )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f64_add( op1, op2 );
+    if (!f64_host_op( regs, BFP_HOST_ADD, op1, op2, &ans ))
+        ans = f64_add( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -1325,7 +1448,8 @@ DEF_INST( add_bfp_short_reg )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f32_add( op1, op2 );
+    if (!f32_host_op( regs, BFP_HOST_ADD, op1, op2, &ans ))
+        ans = f32_add( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -1365,7 +1489,8 @@ DEF_INST( add_bfp_short )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f32_add( op1, op2 );
+    if (!f32_host_op( regs, BFP_HOST_ADD, op1, op2, &ans ))
+        ans = f32_add( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -2976,7 +3101,8 @@ DEF_INST( divide_bfp_long_reg )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f64_div( op1, op2 );
+    if (!f64_host_op( regs, BFP_HOST_DIV, op1, op2, &ans ))
+        ans = f64_div( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -3018,7 +3144,8 @@ DEF_INST( divide_bfp_long )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f64_div( op1, op2 );
+    if (!f64_host_op( regs, BFP_HOST_DIV, op1, op2, &ans ))
+        ans = f64_div( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -3058,7 +3185,8 @@ DEF_INST( divide_bfp_short_reg )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f32_div( op1, op2 );
+    if (!f32_host_op( regs, BFP_HOST_DIV, op1, op2, &ans ))
+        ans = f32_div( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -3100,7 +3228,8 @@ DEF_INST( divide_bfp_short )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f32_div( op1, op2 );
+    if (!f32_host_op( regs, BFP_HOST_DIV, op1, op2, &ans ))
+        ans = f32_div( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -4075,7 +4204,8 @@ DEF_INST( multiply_bfp_long_reg )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f64_mul( op1, op2 );
+    if (!f64_host_op( regs, BFP_HOST_MUL, op1, op2, &ans ))
+        ans = f64_mul( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -4115,7 +4245,8 @@ DEF_INST( multiply_bfp_long )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f64_mul( op1, op2 );
+    if (!f64_host_op( regs, BFP_HOST_MUL, op1, op2, &ans ))
+        ans = f64_mul( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -4261,7 +4392,8 @@ DEF_INST( multiply_bfp_short_reg )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f32_mul( op1, op2 );
+    if (!f32_host_op( regs, BFP_HOST_MUL, op1, op2, &ans ))
+        ans = f32_mul( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -4301,7 +4433,8 @@ DEF_INST( multiply_bfp_short )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f32_mul( op1, op2 );
+    if (!f32_host_op( regs, BFP_HOST_MUL, op1, op2, &ans ))
+        ans = f32_mul( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -4711,7 +4844,8 @@ DEF_INST( squareroot_bfp_long_reg )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    op1 = f64_sqrt( op2 );
+    if (!f64_host_sqrt( regs, op2, &op1 ))
+        op1 = f64_sqrt( op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -4745,7 +4879,8 @@ DEF_INST( squareroot_bfp_long )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    op1 = f64_sqrt( op2 );
+    if (!f64_host_sqrt( regs, op2, &op1 ))
+        op1 = f64_sqrt( op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -4777,7 +4912,8 @@ DEF_INST( squareroot_bfp_short_reg )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    op1 = f32_sqrt( op2 );
+    if (!f32_host_sqrt( regs, op2, &op1 ))
+        op1 = f32_sqrt( op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -4811,7 +4947,8 @@ DEF_INST( squareroot_bfp_short )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    op1 = f32_sqrt( op2 );
+    if (!f32_host_sqrt( regs, op2, &op1 ))
+        op1 = f32_sqrt( op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -4883,7 +5020,8 @@ DEF_INST( subtract_bfp_long_reg )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f64_sub( op1, op2 );
+    if (!f64_host_op( regs, BFP_HOST_SUB, op1, op2, &ans ))
+        ans = f64_sub( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -4923,7 +5061,8 @@ DEF_INST( subtract_bfp_long )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f64_sub( op1, op2 );
+    if (!f64_host_op( regs, BFP_HOST_SUB, op1, op2, &ans ))
+        ans = f64_sub( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -4960,7 +5099,8 @@ DEF_INST( subtract_bfp_short_reg )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f32_sub( op1, op2 );
+    if (!f32_host_op( regs, BFP_HOST_SUB, op1, op2, &ans ))
+        ans = f32_sub( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
@@ -5000,7 +5140,8 @@ DEF_INST( subtract_bfp_short )
     softfloat_exceptionFlags = 0;
     SET_SF_RM_FROM_FPC;
 
-    ans = f32_sub( op1, op2 );
+    if (!f32_host_op( regs, BFP_HOST_SUB, op1, op2, &ans ))
+        ans = f32_sub( op1, op2 );
 
     if (softfloat_exceptionFlags)
     {
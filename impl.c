@@ -863,6 +863,9 @@ int     rc;
     /* Initialize 'hostinfo' BEFORE display_version is called */
     init_hostinfo( &hostinfo );
 
+    /* Select the string instruction kernels for this host CPU */
+    hsimd_init();
+
 #ifdef _MSVC_
     /* Initialize sockets package */
     VERIFY( socket_init() == 0 );
@@ -1035,6 +1038,15 @@ int     rc;
     initialize_lock( &sysblk.shrdlock );
     initialize_condition( &sysblk.shrdcond );
     initialize_lock( &sysblk.shrdtracelock );
+    initialize_lock( &sysblk.shrdwrklock );
+    initialize_condition( &sysblk.shrdwrkcond );
+    initialize_lock( &sysblk.shrdmuxlock );
+    sysblk.shrdworkers = SHARED_DEFAULT_WORKERS;
+#endif
+
+#if defined( _FEATURE_VM_BLOCKIO )
+    initialize_lock( &sysblk.vmd250lock );
+    initialize_condition( &sysblk.vmd250cond );
 #endif
 
     sysblk.mainowner = LOCK_OWNER_NONE;
@@ -1122,6 +1134,10 @@ int     rc;
     sysblk.hercprio = DEFAULT_HERC_PRIO  /*     V     */;
     sysblk.todprio  = DEFAULT_TOD_PRIO;  /* (highest) */
 
+    /* Initialize default CPU wait state spin limit */
+    sysblk.waitspin = DEF_WAITSPIN;
+    sysblk.xpndstream = true;
+
     /* Set the priority of the main Hercules thread */
     if ((rc = set_thread_priority( sysblk.hercprio )) != 0)
     {
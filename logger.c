@@ -48,6 +48,296 @@ static FILE *logger_hrdcpy;             /* Hardcopy log or zero      */
 static int   logger_hrdcpyfd;           /* Hardcopt fd or -1         */
 static char  logger_filename[MAX_PATH];
 
+static U64   logger_total;              /* total bytes ever logged   */
+static int   logger_pipe_eof;           /* stdout pipe was closed    */
+static U32   logger_drops_shown;        /* ring drops reported so far*/
+
+/*********************************************************************/
+/* hardcopy writer work variables (all protected by hrdcpy_lock)     */
+/*********************************************************************/
+
+static LOCK   hrdcpy_lock;              /* serializes hardcopy i/o   */
+static U64    hrdcpy_pos;               /* logger_total written      */
+static U64    hrdcpy_bytes;             /* bytes in current logfile  */
+static time_t hrdcpy_opened;            /* when logfile was opened   */
+static bool   hrdcpy_dostamp = true;    /* next write starts a line  */
+static U64    hrdcpy_shutpos = ~0ULL;   /* logger_total at shutdown  */
+static char   hrdcpy_path[MAX_PATH];    /* host path when rotatable  */
+static TID    hrdcpy_tid;               /* hardcopy writer thread    */
+static TID    logpipe_tid;              /* stdout pipe reader thread */
+
+/*********************************************************************/
+/*                    message ring buffer                            */
+/*********************************************************************/
+/*                                                                   */
+/* Messages issued via logmsg/WRMSG are not written to the logger    */
+/* pipe anymore but are placed into an in-process ring buffer which  */
+/* the logger thread drains into logger_buffer.  Any number of       */
+/* threads may produce at the same time: each producer reserves its  */
+/* record by advancing ring_head with a compare-and-swap, copies its */
+/* (already formatted) message into the reserved space and then      */
+/* marks the record committed.  The logger thread consumes records   */
+/* in reservation order, stopping at the first one not yet committed.*/
+/*                                                                   */
+/* Each record is a 4 byte header (commit flag, pad flag and length) */
+/* followed by the message text, rounded up to 8 bytes.  A record    */
+/* never wraps: if it does not fit before the end of the ring then a */
+/* pad record is reserved together with it.  Consumed space is set   */
+/* to zeros before ring_tail is advanced past it so that a producer  */
+/* never finds a stale commit flag where its new header will be.     */
+/*                                                                   */
+/* When the ring is full the producer yields and then waits a short  */
+/* while for space (the same 50ms the logger pipe used to allow) or, */
+/* if "LOGOPT DROP" is in effect, discards the message immediately.  */
+/* Discarded messages are counted and reported by the logger thread. */
+/*                                                                   */
+/* Raw writes to stdout still arrive via the logger pipe, which has  */
+/* its own reader thread feeding the same ring.  Should the ring not */
+/* be available at all, logmsg falls back to the pipe as before.     */
+/*                                                                   */
+/*********************************************************************/
+
+#if defined( _MSVC_ ) || defined( HAVE_ATOMIC_INTRINSICS ) || defined( HAVE_SYNC_BUILTINS )
+  #define HAVE_LOG_RING
+#endif
+
+#define RING_COMMIT     0x80000000      /* record is complete        */
+#define RING_PAD        0x40000000      /* filler to end of ring     */
+#define RING_LENMASK    0x00FFFFFF      /* record data length        */
+#define RING_HDRSIZE    ((U32) sizeof( U32 ))
+#define RING_RECSIZE(n) ((RING_HDRSIZE + (U32)(n) + 7) & ~7)
+#define RING_SPINS      64              /* yields before waiting     */
+#define RING_WAITS      5               /* 10ms waits before drop    */
+
+#if defined( HAVE_LOG_RING )
+
+static BYTE*               ring_buffer;
+static CACHE_ALIGN volatile U64  ring_head;   /* next byte to reserve*/
+static CACHE_ALIGN volatile U64  ring_tail;   /* next byte to drain  */
+static CACHE_ALIGN volatile U32  ring_drops;  /* messages discarded  */
+static volatile U32        ring_idle;         /* consumer sleeping   */
+static volatile U32        ring_full;         /* producers waiting   */
+static LOCK                ring_lock;
+static COND                ring_cond;         /* consumer wakeup     */
+static COND                ring_space_cond;   /* producer wakeup     */
+
+#if defined( _MSVC_ )
+
+static inline U64 ring_load64( volatile U64* p )
+{
+    return (U64) InterlockedCompareExchange64( (volatile LONG64*) p, 0, 0 );
+}
+static inline void ring_store64( volatile U64* p, U64 v )
+{
+    InterlockedExchange64( (volatile LONG64*) p, (LONG64) v );
+}
+static inline bool ring_cas64( volatile U64* p, U64 old, U64 new )
+{
+    return (U64) InterlockedCompareExchange64( (volatile LONG64*) p,
+                                   (LONG64) new, (LONG64) old ) == old;
+}
+static inline U32 ring_load32( volatile U32* p )
+{
+    return (U32) InterlockedCompareExchange( (volatile LONG*) p, 0, 0 );
+}
+static inline void ring_store32( volatile U32* p, U32 v )
+{
+    InterlockedExchange( (volatile LONG*) p, (LONG) v );
+}
+static inline void ring_inc32( volatile U32* p )
+{
+    InterlockedIncrement( (volatile LONG*) p );
+}
+
+#elif defined( HAVE_ATOMIC_INTRINSICS )
+
+static inline U64 ring_load64( volatile U64* p )
+{
+    return __atomic_load_n( p, __ATOMIC_SEQ_CST );
+}
+static inline void ring_store64( volatile U64* p, U64 v )
+{
+    __atomic_store_n( p, v, __ATOMIC_SEQ_CST );
+}
+static inline bool ring_cas64( volatile U64* p, U64 old, U64 new )
+{
+    return __atomic_compare_exchange_n( p, &old, new, false,
+                                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
+}
+static inline U32 ring_load32( volatile U32* p )
+{
+    return __atomic_load_n( p, __ATOMIC_SEQ_CST );
+}
+static inline void ring_store32( volatile U32* p, U32 v )
+{
+    __atomic_store_n( p, v, __ATOMIC_SEQ_CST );
+}
+static inline void ring_inc32( volatile U32* p )
+{
+    __atomic_add_fetch( p, 1, __ATOMIC_SEQ_CST );
+}
+
+#else // HAVE_SYNC_BUILTINS
+
+static inline U64 ring_load64( volatile U64* p )
+{
+    return __sync_fetch_and_add( p, 0 );
+}
+static inline void ring_store64( volatile U64* p, U64 v )
+{
+    __sync_synchronize();
+    *p = v;
+    __sync_synchronize();
+}
+static inline bool ring_cas64( volatile U64* p, U64 old, U64 new )
+{
+    return __sync_bool_compare_and_swap( p, old, new );
+}
+static inline U32 ring_load32( volatile U32* p )
+{
+    return __sync_fetch_and_add( p, 0 );
+}
+static inline void ring_store32( volatile U32* p, U32 v )
+{
+    __sync_synchronize();
+    *p = v;
+    __sync_synchronize();
+}
+static inline void ring_inc32( volatile U32* p )
+{
+    __sync_fetch_and_add( p, 1 );
+}
+
+#endif
+
+/*-------------------------------------------------------------------*/
+/* Wake the logger thread if it is waiting for new records           */
+/*-------------------------------------------------------------------*/
+static void ring_wakeup()
+{
+    if (ring_load32( &ring_idle ))
+    {
+        obtain_lock( &ring_lock );
+        {
+            signal_condition( &ring_cond );
+        }
+        release_lock( &ring_lock );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/* Is there a committed record waiting to be drained?                */
+/*-------------------------------------------------------------------*/
+static bool ring_ready()
+{
+    U64  tail = ring_load64( &ring_tail );
+
+    if (tail == ring_load64( &ring_head ))
+        return false;
+
+    return (ring_load32( (U32*)(ring_buffer + (tail & (LOG_RINGSIZE-1))))
+            & RING_COMMIT) ? true : false;
+}
+
+/*-------------------------------------------------------------------*/
+/* Producer: reserve, fill and commit one record                     */
+/*-------------------------------------------------------------------*/
+static void ring_put( const char* msg, U32 len, bool drop )
+{
+    U32  need = RING_RECSIZE( len );
+    U32  off, pad;
+    U64  head, tail;
+    int  spins = 0, waits = 0;
+
+    for (;;)
+    {
+        head = ring_load64( &ring_head );
+        tail = ring_load64( &ring_tail );
+        off  = (U32)(head & (LOG_RINGSIZE-1));
+        pad  = (off + need > LOG_RINGSIZE) ? (LOG_RINGSIZE - off) : 0;
+
+        if (head + pad + need - tail <= LOG_RINGSIZE)
+        {
+            if (ring_cas64( &ring_head, head, head + pad + need ))
+                break;
+            continue;
+        }
+
+        /* Ring is full: apply backpressure policy */
+        ring_wakeup();
+
+        if (drop || waits >= RING_WAITS)
+        {
+            ring_inc32( &ring_drops );
+            return;
+        }
+
+        if (spins < RING_SPINS)
+        {
+            spins++;
+            sched_yield();
+            continue;
+        }
+
+        waits++;
+        obtain_lock( &ring_lock );
+        {
+            ring_full++;
+            signal_condition( &ring_cond );
+            timed_wait_condition_relative_usecs( &ring_space_cond,
+                &ring_lock, 10000, NULL );
+            ring_full--;
+        }
+        release_lock( &ring_lock );
+    }
+
+    if (pad)
+    {
+        ring_store32( (U32*)(ring_buffer + off),
+            RING_COMMIT | RING_PAD | (pad - RING_HDRSIZE) );
+        off = 0;
+    }
+
+    memcpy( ring_buffer + off + RING_HDRSIZE, msg, len );
+    ring_store32( (U32*)(ring_buffer + off), RING_COMMIT | len );
+
+    ring_wakeup();
+}
+
+#endif // defined( HAVE_LOG_RING )
+
+/*********************************************************************/
+/*        log_ring_write  -  queue message for the logger            */
+/*********************************************************************/
+/* Returns 0 if the message was queued (or discarded because the     */
+/* ring is full and DROP is in effect) and -1 if the caller should   */
+/* write the message to the logger pipe instead.                     */
+/*********************************************************************/
+DLL_EXPORT int log_ring_write( const char* msg, int len )
+{
+#if defined( HAVE_LOG_RING )
+    if (!logger_active || !ring_buffer || len <= 0 || len > LOG_RINGMAXMSG)
+        return -1;
+
+    ring_put( msg, (U32) len, sysblk.logoptdrop );
+    return 0;
+#else
+    UNREFERENCED( msg );
+    UNREFERENCED( len );
+    return -1;
+#endif
+}
+
+/* log_ring_drops - number of messages discarded since startup */
+DLL_EXPORT U32 log_ring_drops()
+{
+#if defined( HAVE_LOG_RING )
+    return ring_load32( &ring_drops );
+#else
+    return 0;
+#endif
+}
+
 /*********************************************************************/
 /*              log_read  -  read system log                         */
 /*********************************************************************/
@@ -224,24 +514,11 @@ static void logger_logfile_write( const void* pBuff, size_t nBytes )
     char* pLeft = (char*) pBuff;
     int   nLeft = (int)   nBytes;
 
-    /* daemon_mode only (wherein both stdout/stderr have both
-       been redirected): don't write to hardcopy during shutdown
-       to prevent duplicate messages from occurring when stderr
-       is redirected to stdout (or vice versa) via the command
-       line (e.g. 2>&1).
-
-       The duplicate messages occur because during shutdown
-       all messages are issued to stderr and we redirect stderr
-       to stdout during shutdown.  This causes log messages
-       (written to stdout) to be written to the logfile as well
-       as to stderr too, which, due to our redirection, ends up
-       being written again to the very same (hardcopy) file.
-       The below test prevents this from happening.
-    */
-    if (nLeft && (!sysblk.daemon_mode || !sysblk.shutdown))
+    if (nLeft)
     {
         /* (ignore any errors; we did the best we could) */
         fwrite( pLeft, nLeft, 1, logger_hrdcpy );
+        hrdcpy_bytes += nLeft;
     }
 
     if (sysblk.shutdown)
@@ -294,50 +571,465 @@ static void logger_logfile_timestamp()
     }
 }
 
-DLL_EXPORT void logger_timestamped_logfile_write( const void* pBuff, size_t nBytes )
+/*-------------------------------------------------------------------*/
+/* Write log data to the hardcopy file, stamping each line if needed */
+/* (caller holds hrdcpy_lock)                                        */
+/*-------------------------------------------------------------------*/
+static void logger_hrdcpy_lines( char* pLeft, int nLeft )
 {
-    if (logger_hrdcpy)
+    char*  pRight = NULL;
+    int    nRight = 0;
+    char*  pNL    = NULL;   /* (pointer to NEWLINE character) */
+
+    if (hrdcpy_dostamp)
     {
         if (STAMPLOG)
             logger_logfile_timestamp();
-        logger_logfile_write( pBuff, nBytes );
+        hrdcpy_dostamp = false;
     }
+
+    while ((pNL = memchr( pLeft, '\n', nLeft )) != NULL)
+    {
+        pRight  = pNL + 1;
+        nRight  = nLeft - ((int)(pRight - pLeft));
+        nLeft  -= nRight;
+
+        if (nLeft)
+            logger_logfile_write( pLeft, nLeft );
+
+        pLeft = pRight;
+        nLeft = nRight;
+
+        if (!nLeft)
+        {
+            hrdcpy_dostamp = true;
+            break;
+        }
+
+        if (STAMPLOG)
+            logger_logfile_timestamp();
+    }
+
+    if (nLeft)
+        logger_logfile_write( pLeft, nLeft );
 }
 
-static void* logger_thread( void* arg )
+/*-------------------------------------------------------------------*/
+/* Write everything logged since the last call to the hardcopy file  */
+/* in batches of up to LOG_HCBATCH bytes (caller holds hrdcpy_lock). */
+/* Data is copied out of logger_buffer under logger_lock so that the */
+/* logger thread is never held up by hardcopy file i/o.              */
+/*                                                                   */
+/* In daemon mode, data logged after logger_flush was called during  */
+/* shutdown is not written (see logger_timestamped_logfile_write),   */
+/* but everything logged before then always is.                      */
+/*-------------------------------------------------------------------*/
+static void logger_hrdcpy_write()
+{
+    static char  batch[ LOG_HCBATCH ];  /* (only used under lock)    */
+    U64   end;
+    U32   lost;
+    int   idx, n;
+    bool  wrote = false;
+
+    for (;;)
+    {
+        lost = 0;
+
+        obtain_lock( &logger_lock );
+        {
+            end = logger_total;
+
+            if (sysblk.daemon_mode && sysblk.shutdown)
+                end = MIN( end, hrdcpy_shutpos );
+
+            /* Discard everything when there is no hardcopy file */
+            if (!logger_hrdcpy || hrdcpy_pos >= end)
+            {
+                hrdcpy_pos = logger_total;
+                end        = logger_total;
+            }
+
+            /* Skip data that has already been overwritten */
+            if (logger_total - hrdcpy_pos > (U64) logger_bufsize)
+            {
+                lost = (U32)(logger_total - hrdcpy_pos - logger_bufsize);
+                hrdcpy_pos = logger_total - logger_bufsize;
+            }
+
+            idx = (int)(hrdcpy_pos % (U64) logger_bufsize);
+            n   = (int) MIN( end - hrdcpy_pos, (U64) sizeof( batch ));
+            n   = MIN( n, logger_bufsize - idx );
+
+            memcpy( batch, logger_buffer + idx, n );
+            hrdcpy_pos += n;
+        }
+        release_lock( &logger_lock );
+
+        if (lost)
+        {
+            char buf[80];
+            // "Logger: hardcopy fell behind, %u bytes not logged"
+            MSGBUF( buf, MSG( HHC02109, "W", lost ));
+            if (!hrdcpy_dostamp)
+                logger_logfile_write( "\n", 1 );
+            if (STAMPLOG)
+                logger_logfile_timestamp();
+            logger_logfile_write( buf, strlen( buf ));
+            hrdcpy_dostamp = true;
+        }
+
+        if (!n)
+            break;
+
+        logger_hrdcpy_lines( batch, n );
+        wrote = true;
+    }
+
+    if (wrote)
+        fflush( logger_hrdcpy );
+}
+
+/*-------------------------------------------------------------------*/
+/* Rotate the hardcopy file if it has reached the size or age limit  */
+/* set via LOGOPT (caller holds hrdcpy_lock).  Only logfiles opened  */
+/* via the "log" command or -l option are rotated, never redirected  */
+/* stdout/stderr.  The current file is renamed to <name>.<datetime>  */
+/* and a new, empty file of the original name is opened in its place.*/
+/*                                                                   */
+/* Returns 0 if nothing was done, 1 if rotated (rotname = new name   */
+/* of the old file) or -1 on error (func and err describe why).      */
+/*-------------------------------------------------------------------*/
+static int logger_hrdcpy_rotate( char* rotname, size_t size,
+                                 const char** func, int* err )
+{
+    char    stamp[32];
+    time_t  now;
+    FILE*   new_hrdcpy;
+    int     new_hrdcpyfd, i, rc = 1;
+
+    if (!logger_hrdcpy || !hrdcpy_path[0])
+        return 0;
+
+    now = time( NULL );
+
+    if (!(0
+        || (sysblk.logrotsize && hrdcpy_bytes >= sysblk.logrotsize)
+        || (sysblk.logrottime && now - hrdcpy_opened >= sysblk.logrottime)
+    ))
+        return 0;
+
+    strftime( stamp, sizeof( stamp ), "%Y%m%d-%H%M%S", localtime( &now ));
+    snprintf( rotname, size, "%s.%s", hrdcpy_path, stamp );
+
+    for (i=1; access( rotname, F_OK ) == 0; i++)
+        snprintf( rotname, size, "%s.%s-%d", hrdcpy_path, stamp, i );
+
+    if (!hrdcpy_dostamp)
+        logger_logfile_write( "\n", 1 );
+
+    fclose( logger_hrdcpy );
+    logger_hrdcpy   = 0;
+    logger_hrdcpyfd = 0;
+
+    if (rename( hrdcpy_path, rotname ) != 0)
+    {
+        /* Could not rename: keep appending to the current file */
+        *func = "rename()";
+        *err  = errno;
+        rc    = -1;
+    }
+
+    new_hrdcpyfd = HOPEN( hrdcpy_path,
+            O_WRONLY | O_CREAT | (rc < 0 ? O_APPEND : O_TRUNC),
+            S_IRUSR  | S_IWUSR | S_IRGRP );
+
+    if (new_hrdcpyfd < 0 || !(new_hrdcpy = fdopen( new_hrdcpyfd, "w" )))
+    {
+        *func = new_hrdcpyfd < 0 ? "open()" : "fdopen()";
+        *err  = errno;
+
+        if (new_hrdcpyfd >= 0)
+            close( new_hrdcpyfd );
+
+        /* Logging to hardcopy is now off */
+        memset( hrdcpy_path,     0, sizeof( hrdcpy_path     ));
+        memset( logger_filename, 0, sizeof( logger_filename ));
+        return -1;
+    }
+
+    logger_hrdcpy   = new_hrdcpy;
+    logger_hrdcpyfd = new_hrdcpyfd;
+    hrdcpy_bytes    = 0;
+    hrdcpy_opened   = now;
+    hrdcpy_dostamp  = true;
+
+    return rc;
+}
+
+#if defined( HAVE_ZLIB )
+/*-------------------------------------------------------------------*/
+/* Compress a rotated logfile to <name>.gz and remove the original   */
+/*-------------------------------------------------------------------*/
+static int logger_gzip( char* pathname, size_t size )
+{
+    char    gzname[ MAX_PATH + 40 ];
+    char    buf[ 32 * 1024 ];
+    FILE*   in;
+    gzFile  out;
+    size_t  n;
+    int     rc = 0;
+
+    MSGBUF( gzname, "%s.gz", pathname );
+
+    if (!(in = fopen( pathname, "rb" )))
+        return errno;
+
+    if (!(out = gzopen( gzname, "wb" )))
+    {
+        rc = errno ? errno : ENOMEM;
+        fclose( in );
+        return rc;
+    }
+
+    while ((n = fread( buf, 1, sizeof( buf ), in )) > 0)
+    {
+        if (gzwrite( out, buf, (unsigned) n ) != (int) n)
+        {
+            rc = EIO;
+            break;
+        }
+    }
+
+    if (!rc && ferror( in ))
+        rc = EIO;
+
+    fclose( in );
+
+    if (gzclose( out ) != Z_OK && !rc)
+        rc = EIO;
+
+    if (rc)
+        remove( gzname );
+    else
+    {
+        remove( pathname );
+        strlcpy( pathname, gzname, size );
+    }
+
+    return rc;
+}
+#endif // defined( HAVE_ZLIB )
+
+/*-------------------------------------------------------------------*/
+/* Hardcopy writer thread: batches log data to the hardcopy file     */
+/*-------------------------------------------------------------------*/
+static void* logger_hrdcpy_thread( void* arg )
 {
-    int bytes_read;
+    char         rotname[ MAX_PATH + 40 ];
+    const char*  func = NULL;
+    int          err  = 0;
+    int          rc;
 
     UNREFERENCED( arg );
 
-#if !defined( _MSVC_ )
-    logger_redirect();
+    while (logger_active)
+    {
+        /* Wait for new log data (or for the next rotation check) */
+        obtain_lock( &logger_lock );
+        {
+            if (hrdcpy_pos == logger_total && logger_active)
+                timed_wait_condition_relative_usecs( &logger_cond,
+                    &logger_lock, 1000000, NULL );
+        }
+        release_lock( &logger_lock );
+
+        obtain_lock( &hrdcpy_lock );
+        {
+            logger_hrdcpy_write();
+            rc = logger_hrdcpy_rotate( rotname, sizeof( rotname ), &func, &err );
+        }
+        release_lock( &hrdcpy_lock );
+
+        if (rc < 0)
+        {
+            // "Logger: error in function %s: %s"
+            WRMSG( HHC02102, "E", func, strerror( err ));
+        }
+        else if (rc > 0)
+        {
+#if defined( HAVE_ZLIB )
+            if (sysblk.logoptcompress && (err = logger_gzip( rotname, sizeof( rotname ))))
+            {
+                // "Logger: error in function %s: %s"
+                WRMSG( HHC02102, "E", "gzwrite()", strerror( err ));
+            }
 #endif
+            // "Logger: log rotated to %s"
+            WRMSG( HHC02107, "I", rotname );
+        }
+    }
 
-    setvbuf( stdout, NULL, _IONBF, 0 );
+    return NULL;
+}
+
+DLL_EXPORT void logger_timestamped_logfile_write( const void* pBuff, size_t nBytes )
+{
+    if (!logger_init_flg)
+        return;
+
+    obtain_lock( &hrdcpy_lock );
+    {
+        /* Write whatever is still pending first to keep order */
+        if (logger_hrdcpy)
+            logger_hrdcpy_write();
+
+        /* daemon_mode only (wherein both stdout/stderr have both
+           been redirected): don't write to hardcopy during shutdown
+           to prevent duplicate messages from occurring when stderr
+           is redirected to stdout (or vice versa) via the command
+           line (e.g. 2>&1).
+
+           The duplicate messages occur because during shutdown
+           all messages are issued to stderr and we redirect stderr
+           to stdout during shutdown.  This causes log messages
+           (written to stdout) to be written to the logfile as well
+           as to stderr too, which, due to our redirection, ends up
+           being written again to the very same (hardcopy) file.
+           The below test prevents this from happening.
+        */
+        if (logger_hrdcpy && (!sysblk.daemon_mode || !sysblk.shutdown))
+        {
+            if (!hrdcpy_dostamp)
+            {
+                logger_logfile_write( "\n", 1 );
+                hrdcpy_dostamp = true;
+            }
+
+            if (STAMPLOG)
+                logger_logfile_timestamp();
+            logger_logfile_write( pBuff, nBytes );
+            fflush( logger_hrdcpy );
+        }
+    }
+    release_lock( &hrdcpy_lock );
+}
+
+/*-------------------------------------------------------------------*/
+/* Append data to logger_buffer (caller holds logger_lock)           */
+/*-------------------------------------------------------------------*/
+static void logger_append( const char* pData, int nData )
+{
+    int  n;
+
+    /* If Hercules is not running in daemon mode and panel
+       initialization is not yet complete, write message
+       to stderr so the user can see it on the terminal */
+    if (!sysblk.daemon_mode && !sysblk.panel_init && nData)
+    {
+        /* (ignore any errors; we did the best we could) */
+        fwrite( pData, nData, 1, stderr );
+    }
+
+    while (nData > 0)
+    {
+        n = MIN( nData, logger_bufsize - logger_currmsg );
+
+        memcpy( logger_buffer + logger_currmsg, pData, n );
+
+        pData          += n;
+        nData          -= n;
+        logger_total   += n;
+
+        /* Increment buffer index to next available position */
+        logger_currmsg += n;
+
+        if (logger_currmsg >= logger_bufsize)
+        {
+            logger_currmsg = 0;
+            logger_wrapped = 1;
+        }
+    }
+}
 
+#if defined( HAVE_LOG_RING )
+/*-------------------------------------------------------------------*/
+/* Move all committed ring records into logger_buffer                */
+/*-------------------------------------------------------------------*/
+static int logger_ring_drain()
+{
+    U64  tail, head;
+    U32  off, hdr, len, drops;
+    int  count = 0;
+
+    /* (logger_lock also keeps logger_flush from draining with us) */
     obtain_lock( &logger_lock );
     {
-        logger_active = 1;
+        tail = ring_load64( &ring_tail );
+        head = ring_load64( &ring_head );
 
-        /* Signal initialization complete */
-        signal_condition( &logger_cond );
+        while (tail != head)
+        {
+            off = (U32)(tail & (LOG_RINGSIZE-1));
+            hdr = ring_load32( (U32*)(ring_buffer + off) );
+
+            /* Stop at the first record still being filled in */
+            if (!(hdr & RING_COMMIT))
+                break;
+
+            len = hdr & RING_LENMASK;
+
+            if (!(hdr & RING_PAD))
+            {
+                logger_append( (char*) ring_buffer + off + RING_HDRSIZE, len );
+                count++;
+            }
+
+            memset( ring_buffer + off, 0, RING_RECSIZE( len ));
+            tail += RING_RECSIZE( len );
+        }
+
+        /* Report any messages the producers had to discard */
+        if ((drops = ring_load32( &ring_drops )) != logger_drops_shown)
+        {
+            char buf[80];
+            // "Logger: %u messages dropped, log buffer full"
+            MSGBUF( buf, MSG( HHC02108, "W", drops - logger_drops_shown ));
+            logger_append( buf, (int) strlen( buf ));
+            logger_drops_shown = drops;
+            count++;
+        }
+
+        /* Hand the drained space back to the producers */
+        ring_store64( &ring_tail, tail );
     }
     release_lock( &logger_lock );
 
+    if (ring_load32( &ring_full ))
+    {
+        obtain_lock( &ring_lock );
+        {
+            broadcast_condition( &ring_space_cond );
+        }
+        release_lock( &ring_lock );
+    }
+
+    return count;
+}
+#endif // defined( HAVE_LOG_RING )
+
+/*-------------------------------------------------------------------*/
+/* Read raw stdout output from the logger pipe and pass it on        */
+/*-------------------------------------------------------------------*/
+static void* logger_pipe_thread( void* arg )
+{
+    char  buf[ 8 * 1024 ];
+    int   bytes_read;
+
+    UNREFERENCED( arg );
+
     /* This read causes logger to exit when the write end is closed */
-    while
-    (
-        (bytes_read =
-            read_pipe   // read the maximum amount possible
-            (
-                logger_syslogfd[ LOG_READ ],
-                 (logger_buffer  + logger_currmsg),
-                ((logger_bufsize - logger_currmsg) < LOG_DEFSIZE ?
-                 (logger_bufsize - logger_currmsg) : LOG_DEFSIZE)
-            )
-        )
-    )
+    while ((bytes_read = read_pipe( logger_syslogfd[ LOG_READ ], buf, sizeof( buf ))))
     {
         if (bytes_read < 0)
         {
@@ -350,7 +1042,7 @@ static void* logger_thread( void* arg )
             if (HSO_EINTR == read_pipe_errno)
                 continue;
 
-            obtain_lock( &logger_lock );
+            obtain_lock( &hrdcpy_lock );
             {
                 if (logger_hrdcpy)
                 {
@@ -359,110 +1051,124 @@ static void* logger_thread( void* arg )
                         "read_pipe()", strerror( read_pipe_errno )));
                 }
             }
-            release_lock( &logger_lock );
-
-            bytes_read = 0;
+            release_lock( &hrdcpy_lock );
+            continue;
         }
 
-        /* If Hercules is not running in daemon mode and panel
-           initialization is not yet complete, write message
-           to stderr so the user can see it on the terminal */
-        if (!sysblk.daemon_mode)
+#if defined( HAVE_LOG_RING )
+        if (ring_buffer)
         {
-            if (!sysblk.panel_init)
-            {
-                char* pLeft2 = logger_buffer + logger_currmsg;
-                int   nLeft2 = bytes_read;
+            ring_put( buf, (U32) bytes_read, false );
+            continue;
+        }
+#endif
+        obtain_lock( &logger_lock );
+        {
+            logger_append( buf, bytes_read );
 
-                /* (ignore any errors; we did the best we could) */
-                if (nLeft2)
-                    fwrite( pLeft2, nLeft2, 1, stderr );
-            }
+            /* Notify all interested parties new log data is available */
+            broadcast_condition( &logger_cond );
         }
+        release_lock( &logger_lock );
+    }
 
-        obtain_lock( &logger_lock );
+    logger_pipe_eof = 1;
+
+#if defined( HAVE_LOG_RING )
+    if (ring_buffer)
+    {
+        obtain_lock( &ring_lock );
         {
-            /* Write log data to hardcopy file */
-            if (logger_hrdcpy)
-            {
-                /* Prefix each line with a date/time stamp if needed */
+            signal_condition( &ring_cond );
+        }
+        release_lock( &ring_lock );
+    }
+#endif
 
-                static bool dostamp = true; // (MAYBE!)
-                char*  pLeft  = logger_buffer + logger_currmsg;
-                int    nLeft  = bytes_read;
-                char*  pRight = NULL;
-                int    nRight = 0;
-                char*  pNL    = NULL;   /* (pointer to NEWLINE character) */
+    return NULL;
+}
 
-                if (dostamp)
-                {
-                    if (STAMPLOG)
-                        logger_logfile_timestamp();
-                    dostamp = false;
-                }
+static void* logger_thread( void* arg )
+{
+    int rc;
 
-                while ((pNL = memchr( pLeft, '\n', nLeft )) != NULL)
-                {
-                    pRight  = pNL + 1;
-                    nRight  = nLeft - ((int)(pRight - pLeft));
-                    nLeft  -= nRight;
+    UNREFERENCED( arg );
 
-                    if (nLeft)
-                        logger_logfile_write( pLeft, nLeft );
+#if !defined( _MSVC_ )
+    logger_redirect();
+#endif
 
-                    pLeft = pRight;
-                    nLeft = nRight;
+    setvbuf( stdout, NULL, _IONBF, 0 );
 
-                    if (!nLeft)
-                    {
-                        dostamp = true;
-                        break;
-                    }
+    obtain_lock( &logger_lock );
+    {
+        logger_active = 1;
 
-                    if (STAMPLOG)
-                        logger_logfile_timestamp();
-                }
+        /* Signal initialization complete */
+        signal_condition( &logger_cond );
+    }
+    release_lock( &logger_lock );
 
-                if (nLeft)
-                    logger_logfile_write( pLeft, nLeft );
-            }
-        }
-        release_lock( &logger_lock );
+    rc = create_thread( &hrdcpy_tid, DETACHED,
+                        logger_hrdcpy_thread, NULL, LOGHCPY_THREAD_NAME );
+    if (rc)
+        fprintf( stderr, MSG( HHC00102, "E", strerror( rc )));
 
-        /* Increment buffer index to next available position */
-        logger_currmsg += bytes_read;
+#if defined( HAVE_LOG_RING )
+    if (ring_buffer)
+    {
+        rc = create_thread( &logpipe_tid, DETACHED,
+                            logger_pipe_thread, NULL, LOGPIPE_THREAD_NAME );
+        if (rc)
+            fprintf( stderr, MSG( HHC00102, "E", strerror( rc )));
 
-        if (logger_currmsg >= logger_bufsize)
+        /* Drain the ring until the logger pipe is closed */
+        while (!rc && (!logger_pipe_eof || ring_ready()))
         {
-            logger_currmsg = 0;
-            logger_wrapped = 1;
-        }
+            if (logger_ring_drain())
+            {
+                /* Notify all interested parties new log data is available */
+                obtain_lock( &logger_lock );
+                {
+                    broadcast_condition( &logger_cond );
+                }
+                release_lock( &logger_lock );
+                continue;
+            }
 
-        /* Notify all interested parties new log data is available */
-        obtain_lock( &logger_lock );
-        {
-            broadcast_condition( &logger_cond );
-        }
-        release_lock( &logger_lock );
+            /* Nothing to do: wait for a producer to wake us up */
+            obtain_lock( &ring_lock );
+            {
+                ring_store32( &ring_idle, 1 );
+
+                if (!ring_ready() && !logger_pipe_eof)
+                    timed_wait_condition_relative_usecs( &ring_cond,
+                        &ring_lock, 100000, NULL );
 
-    } /* end while (...) */
+                ring_store32( &ring_idle, 0 );
+            }
+            release_lock( &ring_lock );
+        }
+    }
+    else
+#endif
+        logger_pipe_thread( NULL );
 
     logger_active = 0;
     sysblk.loggertid = 0;
 
     /* Logger is now terminating */
-    obtain_lock( &logger_lock );
     {
         /* Write final message to hardcopy file */
-        if (logger_hrdcpy)
-        {
-            char buf[128];
-            // "Thread id "TIDPAT", prio %2d, name %s ended"
-            MSGBUF( buf, MSG( HHC00101, "I", TID_CAST( thread_id()),
-                get_thread_priority(), LOGGER_THREAD_NAME ));
-            logger_timestamped_logfile_write( buf, strlen( buf ));
-        }
+        char buf[128];
+        // "Thread id "TIDPAT", prio %2d, name %s ended"
+        MSGBUF( buf, MSG( HHC00101, "I", TID_CAST( thread_id()),
+            get_thread_priority(), LOGGER_THREAD_NAME ));
+        logger_timestamped_logfile_write( buf, strlen( buf ));
+    }
 
+    obtain_lock( &logger_lock );
+    {
         /* Redirect all msgs to stderr */
         logger_syslog   [ LOG_WRITE ] = stderr;
         logger_syslogfd [ LOG_WRITE ] = STDERR_FILENO;
@@ -476,12 +1182,63 @@ static void* logger_thread( void* arg )
     return NULL;
 }
 
+/*-------------------------------------------------------------------*/
+/* Write everything logged so far to the hardcopy file right away.   */
+/* Called at shutdown so that log data still queued in the ring or   */
+/* not yet written by the hardcopy writer thread is not lost.        */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT void logger_flush()
+{
+    if (!logger_init_flg)
+        return;
+
+#if defined( HAVE_LOG_RING )
+    if (ring_buffer)
+    {
+        int  i;
+
+        /* Give producers still filling in a record time to finish */
+        for (i=0; i < 100; i++)
+        {
+            logger_ring_drain();
+
+            if (ring_load64( &ring_tail ) == ring_load64( &ring_head ))
+                break;
+
+            usleep( 1000 );
+        }
+    }
+#endif
+
+    obtain_lock( &hrdcpy_lock );
+    {
+        obtain_lock( &logger_lock );
+        {
+            hrdcpy_shutpos = logger_total;
+
+            /* Notify all interested parties new log data is available */
+            broadcast_condition( &logger_cond );
+        }
+        release_lock( &logger_lock );
+
+        if (logger_hrdcpy)
+            logger_hrdcpy_write();
+    }
+    release_lock( &hrdcpy_lock );
+}
+
 DLL_EXPORT void logger_init( void )
 {
     int rc;
 
     initialize_condition( &logger_cond );
     initialize_lock( &logger_lock );
+    initialize_lock( &hrdcpy_lock );
+#if defined( HAVE_LOG_RING )
+    initialize_lock( &ring_lock );
+    initialize_condition( &ring_cond );
+    initialize_condition( &ring_space_cond );
+#endif
     logger_init_flg = TRUE;
 
     obtain_lock( &logger_lock );
@@ -552,8 +1309,8 @@ DLL_EXPORT void logger_init( void )
                 fprintf( stderr, MSG( HHC02102, "E", "fdopen()", strerror( errno )));
         }
 
-        if (logger_hrdcpy)
-            setvbuf( logger_hrdcpy, NULL, _IONBF, 0 );
+        /* (the hardcopy writer flushes after each batch) */
+        hrdcpy_opened = time( NULL );
     }
     else
     {
@@ -571,6 +1328,17 @@ DLL_EXPORT void logger_init( void )
         exit(1);
     }
 
+#if defined( HAVE_LOG_RING )
+    /* (without a ring buffer messages go through the pipe instead) */
+    if (!(ring_buffer = calloc( 1, LOG_RINGSIZE )))
+    {
+        char buf[40];
+        MSGBUF( buf, "calloc(%d)", LOG_RINGSIZE );
+        // "Logger: error in function %s: %s"
+        fprintf( stderr, MSG( HHC02102, "E", buf, strerror( errno )));
+    }
+#endif
+
     if (create_pipe( logger_syslogfd ))
     {
         // "Logger: error in function %s: %s"
@@ -625,13 +1393,17 @@ DLL_EXPORT void log_sethrdcpy( const char* filename )
         else
         {
             /* Disable logging and close logfile */
-            obtain_lock( &logger_lock );
+            obtain_lock( &hrdcpy_lock );
             {
+                logger_hrdcpy_write();
+
                 old_hrdcpy      = logger_hrdcpy;
                 logger_hrdcpy   = 0;
                 logger_hrdcpyfd = 0;
+
+                memset( hrdcpy_path, 0, sizeof( hrdcpy_path ));
             }
-            release_lock( &logger_lock );
+            release_lock( &hrdcpy_lock );
 
             // "Logger: log closed"
             fprintf( old_hrdcpy, MSG( HHC02101, "I" ));
@@ -673,18 +1445,27 @@ DLL_EXPORT void log_sethrdcpy( const char* filename )
             }
             else
             {
-                /* Set no buffering and switch to using new logfile */
-                setvbuf( new_hrdcpy, NULL, _IONBF, 0 );
+                /* Flush pending data to the old logfile (if any)
+                   and switch to using the new logfile. Buffering
+                   is left on: the hardcopy writer flushes it once
+                   per batch. */
 
-                obtain_lock( &logger_lock );
+                obtain_lock( &hrdcpy_lock );
                 {
+                    logger_hrdcpy_write();
+
                     old_hrdcpy      = logger_hrdcpy;
                     logger_hrdcpy   = new_hrdcpy;
                     logger_hrdcpyfd = new_hrdcpyfd;
 
+                    hrdcpy_bytes    = 0;
+                    hrdcpy_opened   = time( NULL );
+                    hrdcpy_dostamp  = true;
+
+                    STRLCPY( hrdcpy_path, pathname );
                     STRLCPY( logger_filename, filename );
                 }
-                release_lock( &logger_lock );
+                release_lock( &hrdcpy_lock );
 
                 /* Write a message in the old logfile indicating
                    logging was switched to a different logfile,
@@ -33,6 +33,14 @@
   #endif
 #endif
 
+/*-------------------------------------------------------------------*/
+/* Message ring buffer and hardcopy writer sizes                     */
+/*-------------------------------------------------------------------*/
+#define LOG_RINGSIZE    (1 * 1024 * 1024)   // ring size (power of 2)
+#define LOG_RINGMAXMSG  (LOG_RINGSIZE / 4)  // larger msgs use the pipe
+#define LOG_STAGESIZE   (1024)              // logmsg staging buffer
+#define LOG_HCBATCH     (64 * 1024)         // hardcopy write batch
+
 /*-------------------------------------------------------------------*/
 /* log message logging facility                                      */
 /*-------------------------------------------------------------------*/
@@ -47,12 +55,15 @@ LOGR_DLL_IMPORT void   log_sethrdcpy   ( const char* filename );
 LOGR_DLL_IMPORT void   log_wakeup      ( void* arg );
 LOGR_DLL_IMPORT char*  log_dsphrdcpy   ();
 LOGR_DLL_IMPORT int    logger_isactive ();
+LOGR_DLL_IMPORT int    log_ring_write  ( const char* msg, int len );
+LOGR_DLL_IMPORT U32    log_ring_drops  ();
 
 #define TIMESTAMPLOG   (!sysblk.logoptnotime)
 #define DATESTAMPLOG   (!sysblk.logoptnodate)
 #define STAMPLOG       (TIMESTAMPLOG || DATESTAMPLOG)
 
 LOGR_DLL_IMPORT void   logger_timestamped_logfile_write( const void* pBuff, size_t nBytes );
+LOGR_DLL_IMPORT void   logger_flush();
 
 #if !defined( _MSVC_ )
 LOGR_DLL_IMPORT void   logger_unredirect();
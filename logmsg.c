@@ -81,6 +81,33 @@
     }                                                               \
     while (0)
 
+/*-------------------------------------------------------------------*/
+/*                Helper macro "STAGE_VSNPRINTF"                     */
+/*-------------------------------------------------------------------*/
+/*                                                                   */
+/*  Same as BFR_VSNPRINTF but first tries formatting the message     */
+/*  into the calling thread's own staging buffer 'stage' (on its     */
+/*  stack) so the common case of a short message needs no malloc.    */
+/*  'bfr' must only be free()d when it does not point to 'stage'.    */
+/*                                                                   */
+/*-------------------------------------------------------------------*/
+
+#define  STAGE_VSNPRINTF()                                          \
+                                                                    \
+    do                                                              \
+    {                                                               \
+        va_list  staged_vl;                                         \
+        va_copy( staged_vl, vl );                                   \
+        rc = vsnprintf( stage, sizeof( stage ), fmt, staged_vl );   \
+        va_end( staged_vl );                                        \
+                                                                    \
+        if (rc > 0 && rc < (int) sizeof( stage ))                   \
+            bfr = stage;                                            \
+        else                                                        \
+            BFR_VSNPRINTF();                                        \
+    }                                                               \
+    while (0)
+
 /*-------------------------------------------------------------------*/
 /*       panel_command message capturing structs and vars            */
 /*-------------------------------------------------------------------*/
@@ -267,7 +294,8 @@ static int do_write_pipe( int fd, const char *msg, int len)
 /*-------------------------------------------------------------------*/
 static void _flog_write_pipe( FILE* f, const char* msg )
 {
-    /* Send message through logger facility pipe to panel.c,
+    /* Queue message in the logger's ring buffer (or send it through
+       the logger facility pipe if the ring can't take it) to panel.c,
        or display it directly to the terminal via fprintf
        if this is a utility message or we're shutting down
        or we're otherwise unable to send it through the pipe.
@@ -278,7 +306,10 @@ static void _flog_write_pipe( FILE* f, const char* msg )
         || sysblk.shutdown
         || stdout != f
         || !logger_syslogfd[ LOG_WRITE ]
-        || (rc = do_write_pipe( logger_syslogfd[ LOG_WRITE ], msg, len )) < 0
+        || (1
+            && (rc = log_ring_write( msg, len )) < 0
+            && (rc = do_write_pipe( logger_syslogfd[ LOG_WRITE ], msg, len )) < 0
+           )
     )
     {
         // Something went wrong or we're shutting down.
@@ -380,6 +411,7 @@ static void vfwritemsg( BYTE panel, FILE* f,
                         const char* fmt, va_list vl )
 {
     char     prefix[ 32 ]  =  {0};
+    char     stage[ LOG_STAGESIZE ];
     char*    bfr           =  NULL;
     int      rc            =  1;
     int      siz           =  1024;
@@ -392,9 +424,9 @@ static void vfwritemsg( BYTE panel, FILE* f,
 
     // Format just the message part, without the filename and line number
 
-    BFR_VSNPRINTF();  // Note: uses 'vl', 'bfr', 'siz', 'fmt' and 'rc'.
-    if (!bfr)         // If BFR_VSNPRINTF runs out of memory,
-        return;       // then there's nothing more we can do.
+    STAGE_VSNPRINTF(); // Note: uses 'vl', 'bfr', 'siz', 'fmt', 'rc', 'stage'
+    if (!bfr)          // If BFR_VSNPRINTF runs out of memory,
+        return;        // then there's nothing more we can do.
 
     bufsiz = msglen = strlen( bfr ) + 2;
 
@@ -411,6 +443,11 @@ static void vfwritemsg( BYTE panel, FILE* f,
 
         pfxsiz = strlen( prefix );
 
+        if (bfr == stage)       // (the below needs a malloc'ed bfr)
+            bfr = strdup( stage );
+        if (!bfr)
+            return;
+
         // Special handling for multi-line messages: insert the
         // debug prefix (prefix) before each line except the first
         // (which is is handled automatically further below)
@@ -439,9 +476,9 @@ static void vfwritemsg( BYTE panel, FILE* f,
         bufsiz += pfxsiz;
     }
 
-    msgbuf = calloc( 1, bufsiz );
-
-    if (msgbuf)
+    if (!prefix[0])
+        flog_write( panel, f, bfr );
+    else if ((msgbuf = calloc( 1, bufsiz )))
     {
         snprintf( msgbuf, bufsiz, "%s%s", prefix, bfr );
         flog_write( panel, f, msgbuf );
@@ -466,13 +503,18 @@ static void vfwritemsg( BYTE panel, FILE* f,
         FWRMSG( f, HHC00007, "I", func, TRIMLOC( filename ), line );
     }
 
-    free( bfr );
+    if (bfr != stage)
+        free( bfr );
 
   #ifdef NEED_LOGMSG_FFLUSH
     fflush( f );
   #endif
 
-    log_wakeup( NULL );
+    // (the logger thread wakes log readers itself after each batch;
+    //  only messages bypassing the logger during shutdown need this)
+
+    if (sysblk.shutdown)
+        log_wakeup( NULL );
 }
 
 /*-------------------------------------------------------------------*/
@@ -480,6 +522,7 @@ static void vfwritemsg( BYTE panel, FILE* f,
 /*-------------------------------------------------------------------*/
 static void vflogmsg( BYTE panel, FILE* f, const char* fmt, va_list vl )
 {
+    char     stage[ LOG_STAGESIZE ];
     char    *bfr =   NULL;
     int      rc;
     int      siz =   1024;
@@ -488,9 +531,9 @@ static void vflogmsg( BYTE panel, FILE* f, const char* fmt, va_list vl )
     fflush(f);
 #endif
 
-    BFR_VSNPRINTF();  // Note: uses 'vl', 'bfr', 'siz', 'fmt' and 'rc'.
-    if (!bfr)         // If BFR_VSNPRINTF runs out of memory,
-        return;       // then there's nothing more we can do.
+    STAGE_VSNPRINTF(); // Note: uses 'vl', 'bfr', 'siz', 'fmt', 'rc', 'stage'
+    if (!bfr)          // If BFR_VSNPRINTF runs out of memory,
+        return;        // then there's nothing more we can do.
 
     flog_write( panel, f, bfr );
 
@@ -498,7 +541,8 @@ static void vflogmsg( BYTE panel, FILE* f, const char* fmt, va_list vl )
     fflush(f);
 #endif
 
-    free( bfr );
+    if (bfr != stage)
+        free( bfr );
 }
 
 /*-------------------------------------------------------------------*/
@@ -256,7 +256,7 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC00070 "Unknown hao command, valid commands are:\n" \
        "HHC00070I hao tgt <tgt> : define target rule (pattern) to react on\n" \
        "HHC00070I hao cmd <cmd> : define command for previously defined rule\n" \
-       "HHC00070I hao list <n>  : list all rules/commands or only at index <n>\n" \
+       "HHC00070I hao list <n>  : list all rules/commands/hits or only at index <n>\n" \
        "HHC00070I hao del <n>   : delete the rule at index <n>\n" \
        "HHC00070I hao clear     : delete all rules (stops automatic operator)"
 #define HHC00071 "The %s was not added because table is full; table size is %02d"
@@ -276,7 +276,7 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC00085 "Rule at index %d not deleted, already empty"
 #define HHC00086 "Rule at index %d successfully deleted"
 #define HHC00087 "The defined Hercules Automatic Operator rule(s) are:"
-#define HHC00088 "Index %02d: target %s -> command %s"
+#define HHC00088 "Index %02d: target %s -> command %s, hits %"PRIu64
 #define HHC00089 "The are no HAO rules defined"
 #define HHC00090 "HAO thread waiting for logger facility to become active"
 #define HHC00091 "Logger facility now active; HAO thread proceeding"
@@ -338,7 +338,17 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC00167 "%s: Doing %s on %s ..."
 #define HHC00168 "%s: Hercules disappeared!! ... exiting"
 #define HHC00169 "%s: DONE! ... exiting"
-//efine HHC00170 - HHC00199 (available)
+// hprof.c: 170-178
+#define HHC00170 "Profiler is %s; interval %d usecs, %"PRIu64" samples, %"PRIu64" wait, %"PRIu64" stopped, %"PRIu64" lost, map %s"
+#define HHC00171 "Profiler started; sampling every %d usecs"
+#define HHC00172 "Profiler stopped"
+#define HHC00173 "Profiler samples reset"
+#define HHC00174 "Profiler load map %s: %d symbols loaded"
+#define HHC00175 "Profiler load map %s: line %d: invalid entry"
+#define HHC00176 "Profiler %s profile written to %s: %d entries"
+#define HHC00177 "CP%02X %5.1f%% %10"PRIu64" %-8s ASN %04X IA %016"PRIX64" op %04X %s"
+#define HHC00178 "Profiler: error in function %s: %s"
+//efine HHC00179 - HHC00199 (available)
 
 // reserve 002xx for tape device related
 #define HHC00201 "%1d:%04X Tape file %s, type %s: tape closed"
@@ -566,7 +576,8 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC00474 "%1d:%04X FBA64 file %s: creating %4.4X compressed volume %s: %u sectors, %u bytes/sector"
 #define HHC00475 "This might take a while... Please wait..."
 #define HHC00476 "%1d:%04X %s file %s: opened r/o%s"
-//efine HHC00477 - HHC00499 (available)
+#define HHC00477 "%1d:%04X %s file %s: not mapped: %s"
+//efine HHC00478 - HHC00499 (available)
 
 // reserve 005xx for fba dasd device related messages
 #define HHC00500 "%1d:%04X FBA file: name missing or invalid filename length"
@@ -671,7 +682,12 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC00742 "Shared: OPTION_SHARED_DEVICES not defined"
 #define HHC00743 "Shared:  %s" // (trace message)
 #define HHC00744 "Shared: Server already active"
-//efine HHC00745 - HHC00799 (available)
+#define HHC00745 "%1d:%04X Shared: remote error on %s request %2.2X-%2.2X"
+#define HHC00746 "Shared: error in receive from %s: %s"
+#define HHC00747 "%1d:%04X Shared: benchmark %s: %d channel programs in %s seconds, %s per second"
+#define HHC00748 "%1d:%04X Shared: device is not a remote shared device"
+#define HHC00749 "%1d:%04X Shared: benchmark %s not supported by the server"
+//efine HHC00750 - HHC00799 (available)
 
 // reserve 008xx for processor related messages
 #define HHC00800 "Processor %s%02X: loaded wait state PSW %s"
@@ -758,8 +774,8 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC00884 "Channel Report queue: (empty)"
 #define HHC00885 "Channel Report queue:"
 #define HHC00886 "CRW 0x%8.8X: %s"
-//efine HHC00887 (available)
-//efine HHC00888 (available)
+#define HHC00887 "I/O interrupts: queued %"PRIu64", presented %"PRIu64", hinted %"PRIu64", depth %d, max %d"
+#define HHC00888 "%-8s %-12s %12"PRIu64
 #define HHC00889 "Available facilities cannot be changed once system is IPLed"
 #define HHC00890 "Cannot %s facility %s without first %s facility %s"
 #define HHC00891 "%3d %02X %02X %c%c%c%c%c %-27s%c%s"
@@ -793,7 +809,7 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC00916 "%1d:%04X %s: Option %s value %s invalid"
 #define HHC00917 "%1d:%04X %s: Required parameter '%s' missing"
 #define HHC00918 "%1d:%04X %s: Option %s unknown or specified incorrectly"
-//efine HHC00919 (available)
+#define HHC00919 "%1d:%04X %s: Virtual switch %s has no free port"
 #define HHC00920 "%1d:%04X CTC: lcs device %04X not in configuration"
 #define HHC00921 "CTC: lcs device port %2.2X: %s Multicast assist enabled"
 #define HHC00922 "%1d:%04X CTC: lcs command packet received"
@@ -1284,8 +1300,8 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC01909 "%04X d250_preserve pending sense preserved"
 #define HHC01920 "%04X d250_restore pending sense restored"
 #define HHC01921 "%04X d250_remove block I/O environment removed"
-#define HHC01922 "%04X d250_read %d-byte block (rel. to 0): %"PRId64
-#define HHC01923 "%04X d250_read FBA unit status %2.2X residual %d"
+#define HHC01922 "%04X d250_iorun %s %d %d-byte block(s) (rel. to 0): %"PRId64
+#define HHC01923 "%04X d250_iorun FBA unit status %2.2X residual %d"
 #define HHC01924 "%04X async biopl %8.8X entries %d key %2.2X intp %8.8X"
 #define HHC01925 "%04X d250_iorq32 sync bioel %8.8X entries %d key %2.2X"
 #define HHC01926 "%04X d250_iorq32 psc %d succeeded %d failed %d"
@@ -1308,9 +1324,9 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC01943 "%04X d250_list64 xcode %4.4X writebuf "F_RADR"-"F_RADR" store key %2.2X"
 #define HHC01944 "%04X d250_list64 xcode %4.4X status "F_RADR"-"F_RADR" store key %2.2X"
 #define HHC01945 "%04X d250_list64 bioe "F_RADR" status %2.2X"
-//efine HHC01946 (available)
-//efine HHC01947 (available)
-//efine HHC01948 (available)
+#define HHC01946 "%1d:%04X D250 requests %"PRIu64" async %"PRIu64" queued %u max %u avg queue wait %"PRIu64" usec"
+#define HHC01947 "%1d:%04X D250 blocks read %"PRIu64" written %"PRIu64" in %"PRIu64" I/Os, %"PRIu64".%02"PRIu64" blocks per I/O"
+#define HHC01948 "No DIAGNOSE X'250' block I/O has been done"
 //efine HHC01949 (available)
 #define HHC01950 "%s guest issued panel command: %s"
 //efine HHC01951 (available)
@@ -1353,7 +1369,10 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC02104 "Logger: log switched to %s"
 #define HHC02105 "Logger: log to %s"
 #define HHC02106 "Logger: log switched off"
-//efine HHC02107 - HHC02196 (available)
+#define HHC02107 "Logger: log rotated to %s"
+#define HHC02108 "Logger: %u messages dropped, log buffer full"
+#define HHC02109 "Logger: hardcopy fell behind, %u bytes not logged"
+//efine HHC02110 - HHC02196 (available)
 #define HHC02197 "Symbol name %s is reserved"
 // Note HHC02198  is actually in config.c
 #define HHC02198 "Device %04X type %04X subchannel %d:%04X attached"
@@ -1448,15 +1467,15 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC02285 "Counted %5u %s events"
 #define HHC02286 "Average instructions / SIE invocation: %5u"
 #define HHC02287 "No SIE performance data"
-//efine HHC02288 (available)
+#define HHC02288 "No SIE state descriptors have been dispatched"
 #define HHC02289 "%s" // disasm_stor
 #define HHC02290 "%s" // 'abs', 'r' and 'v' commands, and 'dump_abs_page' function
 #define HHC02291 "%s" // 'abs', 'r' and 'v' commands, and 'dump_abs_page' function
 #define HHC02292 "%s" // icount_cmd
 #define HHC02293 "%s" // history.c: command history
 #define HHC02294 "%s" // cachestats_cmd
-//efine HHC02295 (available)
-//efine HHC02296 (available)
+#define HHC02295 "%-16s %12s %12s %12s"
+#define HHC02296 "%-16s exits:%s"
 //efine HHC02297 (available)
 #define HHC02298 "%1d:%04X drive is empty"
 #define HHC02299 "Invalid command usage. Type 'help %s' for assistance."
@@ -1508,8 +1527,8 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC02345 "%s device %1d:%04X group has registered IP address %s"
 #define HHC02346 "%s device %1d:%04X group has no registered MAC or IP addresses"
 #define HHC02347 "No %s devices found"
-//efine HHC02348 (available)
-//efine HHC02349 (available)
+#define HHC02348 "%s device %1d:%04X group %-8s %12"PRIu64" %10"PRIu64"/s"
+#define HHC02349 "%s device %1d:%04X group poll %d usecs (window %d usecs), doorbell %s"
 //efine HHC02350 - HHC02359 (available)
 //efine HHC02360 - HHC02369 (available)
 #define HHC02370 "Automatic tracing started at instrcount %"PRIu64" (BEG+%"PRIu64")"
@@ -1756,6 +1775,8 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
        "HHC02463I   -refdt        show last-reference date\n" \
        "HHC02463I   -expdt        show expiry date\n" \
        "HHC02463I   -yroffs[=n]   year offset\n" \
+       "HHC02463I   -bench[=n]    time n sequential and random track reads\n" \
+       "HHC02463I                 through the track cache and with mmap\n" \
        "HHC02463I Note:\n" \
        "HHC02463I   Multiple images can be processed in the same run,\n" \
        "HHC02463I   but options must be specified ahead of each image."
@@ -1787,7 +1808,7 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC02489 "%s: unable to allocate ASCII buffer"
 #define HHC02490 "%s: convert_tt() track %5.5d/x'%04X', rc %d"
 #define HHC02491 "%s: extent number parameter invalid %d; utility ends"
-//efine HHC02492 (available)
+#define HHC02492 "%-5s %-10s: %d tracks in %.3f seconds, %.0f tracks/sec, %.1f MB/sec"
 //efine HHC02493 (available)
 #define HHC02494 "Requested number of extents %d exceeds maximum %d; utility ends"
 #define HHC02495 "Usage: %s [-f] [-n] file1 [file2 ...]\n" \
@@ -2106,10 +2127,13 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC02729 "Usage: %s [options] outfile [volser] [owner]\n" \
        "HHC02728I   outfile   output file\n" \
        "HHC02729I Options:\n" \
+       "HHC02729I   -b        use BZLIB compression\n" \
        "HHC02729I   -d        disable compression\n" \
        "HHC02729I   -h        display usage summary\n" \
        "HHC02729I   -i        create an IEHINITT formatted tape (default: on)\n" \
-       "HHC02729I   -n        create an NL tape"
+       "HHC02729I   -n        create an NL tape\n" \
+       "HHC02729I   -z        use ZLIB compression (default)\n" \
+       "HHC02729I   -Z        use ZSTD compression"
 #define HHC02730 "Usage: %s [options] source [dest]\n" \
        "HHC02730I\n" \
        "HHC02730I   Options:\n" \
@@ -2120,14 +2144,18 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
        "HHC02730I       -c n  set chunk size to \"n\"\n" \
        "HHC02730I       -d    decompress source tape\n" \
        "HHC02730I       -h    display usage summary\n" \
+       "HHC02730I       -l n  set compression level to \"n\" (1-9, ZSTD 1-19)\n" \
        "HHC02730I       -r    rechunk\n" \
        "HHC02730I       -s    strict AWSTAPE specification (chunksize=4096,no compression)\n" \
+       "HHC02730I       -t n  compress using \"n\" threads\n" \
        "HHC02730I       -v    verbose (debug) information\n" \
-       "HHC02730I       -z    use ZLIB compression\n"
+       "HHC02730I       -z    use ZLIB compression\n" \
+       "HHC02730I %s" \
+       "HHC02730I       -B    benchmark the compression methods on source\n"
 #define HHC02731 "          (tapemark)"
 #define HHC02732 "Bytes read:    %"PRId64" (%3.1f MB), Blocks=%u, avg=%u"
 #define HHC02733 "Bytes written: %"PRId64" (%3.1f MB)"
-//efine HHC02734 (available)
+#define HHC02734 "%-5s level %2d: %"PRIu64" bytes to %"PRIu64" (ratio %.2f), write %.1f MB/s, read %.1f MB/s"
 //efine HHC02735 (available)
 //efine HHC02736 (available)
 //efine HHC02737 (available)
@@ -2166,7 +2194,7 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
     "Usage: %s filename\n"
 #define HHC02760 "%s"
 #define HHC02761 "DCB Attributes used:  RECFM=%-4.4s  LRECL=%-5.5d  BLKSIZE=%d"
-//efine HHC02762 (available)
+#define HHC02762 "File No. %u: First block id=%u, offset=%"PRId64
 //efine HHC02763 (available)
 //efine HHC02764 (available)
 //efine HHC02765 (available)
@@ -2558,11 +2586,14 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC05081 "%1d:%04X CTCE: Already awaiting connection :%5d <- %s"
 #define HHC05082 "%1d:%04X CTCE: TCP set_socket_keepalive RC=%d"
 #define HHC05083 "%1d:%04X CTCE: Error on accept() for listening socket %d (port %d): %s"
-//efine HHC05084 (available)
+#define HHC05084 "%1d:%04X CTCE: Using shared memory %s ring %s"
 #define HHC05085 "%1d:%04X CTCE: Invalid ATTNDELAY value %s ignored"
 #define HHC05086 "%1d:%04X CTCE: Recovery is about to issue Hercules command: %s %s"
-
-//efine HHC05087 - HHC05099 (available)
+#define HHC05087 "%1d:%04X CTCE: Shared memory %s ring not used: %s; using TCP"
+#define HHC05088 "%1d:%04X CTCE: SHM ignored: %s"
+#define HHC05089 "CTCE: Benchmark %-3s: %d round trips of %d bytes, %s usec each; %d writes of %d bytes, %s MB/s"
+#define HHC05090 "CTCE: Benchmark %s error: %s"
+//efine HHC05091 - HHC05099 (available)
 
 // range 05100 - 05199 available
 // range 05200 - 05299 available
@@ -2604,7 +2635,11 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC17013 "Process ID = %d"
 #define HHC17014 "%s value is invalid; valid range is %d - %d"
 #define HHC17015 "%s support not included in this engine build"
-//efine HHC17016 - HHC17099 (available)
+#define HHC17016 "%-8s host CPUs %s"
+#define HHC17017 "MAINSTOR NUMA policy %s, nodes %s"
+#define HHC17018 "CPU wait spin limit %u usecs%s"
+#define HHC17019 "%s%02X: wakeups %"PRIu64", %"PRIu64" before sleeping, latency avg %"PRIu64" max %"PRIu64" usecs, spin %u usecs"
+//efine HHC17020 - HHC17099 (available)
 
 //efine HHC17100 - HHC17198 (available)
 #define HHC17199 "%.4s %s"
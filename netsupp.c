@@ -380,8 +380,205 @@ int read_tuntap( int fd, BYTE* buffer, size_t nBuffLen, int secs )
     if (rc == 0)
         return 0;
 
-#endif // !defined( OPTION_W32_CTCI ) // (i.e. Linux only)
+    nBytesRead = TUNTAP_Read( fd, buffer, nBuffLen );
+    if (nBytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        return 0;           // (non-blocking fd and frame went elsewhere)
+    return nBytesRead;
+
+#else // defined( OPTION_W32_CTCI )
 
     nBytesRead = TUNTAP_Read( fd, buffer, nBuffLen );
     return nBytesRead;
+
+#endif // !defined( OPTION_W32_CTCI )
+}
+
+/*-------------------------------------------------------------------*/
+/*        Read a frame that is already waiting, if there is one      */
+/*-------------------------------------------------------------------*/
+/* The device must be in non-blocking mode. Returns 0 if no frame    */
+/* is waiting, saving the select that read_tuntap would do.          */
+
+int read_tuntap_nowait( int fd, BYTE* buffer, size_t nBuffLen )
+{
+#if !defined( OPTION_W32_CTCI ) // (i.e. Linux only)
+
+    int nBytesRead = TUNTAP_Read( fd, buffer, nBuffLen );
+    if (nBytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return 0;
+    return nBytesRead;
+
+#else // defined( OPTION_W32_CTCI )
+
+    return read_tuntap( fd, buffer, nBuffLen, 0 );
+
+#endif // !defined( OPTION_W32_CTCI )
+}
+
+/*-------------------------------------------------------------------*/
+/*       Frame ring between a TUN/TAP read thread and a Read CCW     */
+/*-------------------------------------------------------------------*/
+/*                                                                   */
+/* Each frame is stored as a 4 byte length followed by the frame,    */
+/* padded to a multiple of 4 bytes. A frame never wraps around the   */
+/* end of the ring: a NETRING_SKIP length sends the consumer back to */
+/* the start instead. uHead and uPut are only ever updated by the    */
+/* producer and uTail and uGot only by the consumer.                 */
+/*                                                                   */
+/*-------------------------------------------------------------------*/
+
+#define NETRING_SKIP        0xFFFFFFFF
+#define NETRING_RECLEN( n ) (4 + (((U32)(n) + 3) & ~3))
+
+#if defined( _MSVC_ )
+  #define NETRING_LOAD( p )         (MemoryBarrier(), *(volatile U32*)(p))
+  #define NETRING_STORE( p, v )     do { MemoryBarrier(); *(volatile U32*)(p) = (v); MemoryBarrier(); } while (0)
+#else // gcc presumed
+  #define NETRING_LOAD( p )         __atomic_load_n( (p), __ATOMIC_SEQ_CST )
+  #define NETRING_STORE( p, v )     __atomic_store_n( (p), (v), __ATOMIC_SEQ_CST )
+#endif
+
+int netring_init( NETRING* pRing )
+{
+    memset( pRing, 0, sizeof( NETRING ));
+    if (!(pRing->pData = malloc( NETRING_SIZE )))
+        return -1;
+    initialize_lock( &pRing->lock );
+    initialize_condition( &pRing->cond );
+    return 0;
+}
+
+void netring_term( NETRING* pRing )
+{
+    if (!pRing->pData)
+        return;
+    destroy_condition( &pRing->cond );
+    destroy_lock( &pRing->lock );
+    free( pRing->pData );
+    /* Leave it empty, so that a late peek finds no frames */
+    memset( pRing, 0, sizeof( NETRING ));
+}
+
+/* (producer) Bytes needed to add a frame of 'iLen' bytes, including
+   any skip to the start of the ring; 0 if there is no room yet */
+static U32 netring_room( NETRING* pRing, int iLen )
+{
+    U32  uOff  = pRing->uHead & (NETRING_SIZE - 1);
+    U32  uNeed = NETRING_RECLEN( iLen );
+
+    if (uOff + uNeed > NETRING_SIZE)
+        uNeed += NETRING_SIZE - uOff;
+    if (pRing->uHead + uNeed - NETRING_LOAD( &pRing->uTail ) > NETRING_SIZE)
+        return 0;
+    return uNeed;
+}
+
+int netring_put( NETRING* pRing, const BYTE* pFrame, int iLen )
+{
+    U32  uHead = pRing->uHead;
+    U32  uOff  = uHead & (NETRING_SIZE - 1);
+    U32  uCount;
+
+    if (iLen <= 0 || NETRING_RECLEN( iLen ) > NETRING_SIZE / 2)
+    {
+        pRing->uDrops++;
+        errno = EMSGSIZE;
+        return -1;
+    }
+    if (!netring_room( pRing, iLen ))
+    {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    /* Skip to the start of the ring if the frame won't fit before
+       the end of it (there is always room for the skip marker) */
+    if (uOff + NETRING_RECLEN( iLen ) > NETRING_SIZE)
+    {
+        *(U32*)(pRing->pData + uOff) = NETRING_SKIP;
+        uHead += NETRING_SIZE - uOff;
+        uOff   = 0;
+    }
+
+    *(U32*)(pRing->pData + uOff) = (U32) iLen;
+    memcpy( pRing->pData + uOff + 4, pFrame, iLen );
+
+    /* Publish the frame */
+    NETRING_STORE( &pRing->uHead, uHead + NETRING_RECLEN( iLen ));
+    NETRING_STORE( &pRing->uPut, pRing->uPut + 1 );
+
+    uCount = netring_count( pRing );
+    if (uCount > pRing->uHiWater)
+        pRing->uHiWater = uCount;
+    return 0;
+}
+
+int netring_wait( NETRING* pRing, int iLen, int msecs )
+{
+    struct timespec  waittime;
+    struct timeval   now;
+    int              rc = 0;
+
+    obtain_lock( &pRing->lock );
+    NETRING_STORE( &pRing->fWaiting, 1 );
+    if (!netring_room( pRing, iLen ))
+    {
+        pRing->uFull++;
+
+        gettimeofday( &now, NULL );
+        now.tv_usec += (msecs % 1000) * 1000;
+        waittime.tv_sec  = now.tv_sec + msecs / 1000 + now.tv_usec / 1000000;
+        waittime.tv_nsec = (now.tv_usec % 1000000) * 1000;
+
+        rc = timed_wait_condition( &pRing->cond, &pRing->lock, &waittime );
+    }
+    NETRING_STORE( &pRing->fWaiting, 0 );
+    release_lock( &pRing->lock );
+    return rc;
+}
+
+int netring_peek( NETRING* pRing, BYTE** ppFrame )
+{
+    U32  uTail = pRing->uTail;
+    U32  uOff;
+    U32  uLen;
+
+    if (uTail == NETRING_LOAD( &pRing->uHead ))
+        return 0;
+
+    uOff = uTail & (NETRING_SIZE - 1);
+    uLen = *(U32*)(pRing->pData + uOff);
+
+    /* A skip marker is always followed by a frame at the start */
+    if (uLen == NETRING_SKIP)
+    {
+        NETRING_STORE( &pRing->uTail, uTail + NETRING_SIZE - uOff );
+        uOff = 0;
+        uLen = *(U32*)pRing->pData;
+    }
+
+    *ppFrame = pRing->pData + uOff + 4;
+    return (int) uLen;
+}
+
+void netring_pop( NETRING* pRing )
+{
+    U32  uTail = pRing->uTail;
+    U32  uLen  = *(U32*)(pRing->pData + (uTail & (NETRING_SIZE - 1)));
+
+    NETRING_STORE( &pRing->uTail, uTail + NETRING_RECLEN( uLen ));
+    NETRING_STORE( &pRing->uGot, pRing->uGot + 1 );
+
+    /* Let the producer know there is room now */
+    if (NETRING_LOAD( &pRing->fWaiting ))
+    {
+        obtain_lock( &pRing->lock );
+        signal_condition( &pRing->cond );
+        release_lock( &pRing->lock );
+    }
+}
+
+U32 netring_count( NETRING* pRing )
+{
+    return NETRING_LOAD( &pRing->uPut ) - NETRING_LOAD( &pRing->uGot );
 }
@@ -172,5 +172,61 @@ extern U16  PseudoHdrCheckSum ( ip_hdr* pIP );
 #define DEF_NET_READ_TIMEOUT_SECS   (5)
 
 extern int read_tuntap( int fd, BYTE* buffer, size_t nBuffLen, int secs );
+extern int read_tuntap_nowait( int fd, BYTE* buffer, size_t nBuffLen );
+
+/*-------------------------------------------------------------------*/
+/*       Frame ring between a TUN/TAP read thread and a Read CCW     */
+/*-------------------------------------------------------------------*/
+/*                                                                   */
+/*  One producer (the adapter's TUN/TAP read thread) and one         */
+/*  consumer (the adapter's Read CCW) share the ring without any     */
+/*  lock. The producer reads up to NETRING_BATCH frames that are     */
+/*  already waiting before it wakes the Read CCW, and when the ring  */
+/*  is full it waits for the Read CCW to make room instead of        */
+/*  dropping frames or retrying on a timer.                          */
+/*                                                                   */
+/*    netring_init:   allocate the ring; returns < 0 upon failure.   */
+/*    netring_term:   free the ring.                                 */
+/*    netring_put:    (producer) add a frame; returns < 0 with       */
+/*                    errno = ENOBUFS if full or EMSGSIZE if the     */
+/*                    frame will never fit.                          */
+/*    netring_wait:   (producer) wait up to 'msecs' for room for a   */
+/*                    frame of 'iLen' bytes.                         */
+/*    netring_peek:   (consumer) return the length of the oldest     */
+/*                    frame and point to it; 0 if the ring is empty. */
+/*    netring_pop:    (consumer) remove the oldest frame.            */
+/*    netring_count:  number of frames in the ring.                  */
+/*                                                                   */
+/*-------------------------------------------------------------------*/
+
+#define NETRING_SIZE        (256*1024)  /* Ring size (power of 2)    */
+#define NETRING_BATCH       (32)        /* Max frames per wakeup     */
+#define NETRING_WAIT_MSECS  (100)       /* Max wait for ring room    */
+
+struct NETRING
+{
+    BYTE*   pData;                  /* Ring storage                  */
+    U32     uHead;                  /* Producer offset (free running)*/
+    U32     uTail;                  /* Consumer offset (free running)*/
+    U32     uPut;                   /* Frames added    (producer)    */
+    U32     uGot;                   /* Frames removed  (consumer)    */
+    U32     uHiWater;               /* Most frames ever in the ring  */
+    U32     fWaiting;               /* Producer is waiting for room  */
+    LOCK    lock;                   /* Lock for the condition below  */
+    COND    cond;                   /* Producer waits here for room  */
+    U64     uBatches;               /* Batches handed to the guest   */
+    U64     uFull;                  /* Times the ring was full       */
+    U64     uDrops;                 /* Frames that could never fit   */
+};
+
+typedef struct NETRING  NETRING, *PNETRING;
+
+extern int   netring_init  ( NETRING* pRing );
+extern void  netring_term  ( NETRING* pRing );
+extern int   netring_put   ( NETRING* pRing, const BYTE* pFrame, int iLen );
+extern int   netring_wait  ( NETRING* pRing, int iLen, int msecs );
+extern int   netring_peek  ( NETRING* pRing, BYTE** ppFrame );
+extern void  netring_pop   ( NETRING* pRing );
+extern U32   netring_count ( NETRING* pRing );
 
 #endif // _NETSUPP_H_
@@ -2629,6 +2629,12 @@ void packed_to_binary (BYTE *dec, int len, U64 *result,
 void binary_to_packed (S64 bin, BYTE *result);
 
 
+/* Functions in module general2.c */
+int  ARCH_DEP( unicode_span )( int r1, VADR* addr1, GREG* len1, int dsz,
+                               int r2, VADR* addr2, GREG* len2, int ssz,
+                               int max, REGS* regs );
+
+
 /* Functions in module diagnose.c */
 void ARCH_DEP( diagnose_call )( REGS* regs, int r1, int r3, int b2, VADR effective_addr2 );
 
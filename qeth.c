@@ -321,7 +321,7 @@ static BYTE qeth_immed_commands [256] =
 
 
 /*-------------------------------------------------------------------*/
-/* Internal socket pipe signals used to request something            */
+/* Internal doorbell signals used to request something               */
 /*-------------------------------------------------------------------*/
 #define QDSIG_RESET     0       /* Used to reset signal flag         */
 #define QDSIG_HALT      1       /* Halt Device signalling            */
@@ -332,6 +332,10 @@ static BYTE qeth_immed_commands [256] =
 #define QDSIG_WRMULT    6       /* SIGA Initiate Output Multiple     */
 #define QDSIG_WAKEUP    7       /* Wakeup signalling                 */
 
+#define QDSIG_BIT(_sig) (1U << (_sig))  /* Signal's bit in grp->dbsig */
+#define QDSIG_SLEEPING  0x80000000      /* Activate Queues loop is
+                                           waiting for the doorbell  */
+
 static const char* qsig2str( BYTE sig ) {
     static const char* sigstr[] = {
     /*0*/ "QDSIG_RESET",
@@ -913,6 +917,275 @@ static int qeth_write_pipe (int fd, BYTE *sig)
 }
 
 
+/*-------------------------------------------------------------------*/
+/* QETH doorbell...                                                  */
+/*                                                                   */
+/* Signals for the Activate Queues loop are posted as bits in the    */
+/* grp->dbsig word.  The loop sets QDSIG_SLEEPING in the (otherwise  */
+/* empty) word before it waits in select, and only a signal that     */
+/* finds QDSIG_SLEEPING set rings the doorbell: an eventfd where the */
+/* host has one, else the signalling pipe.  Signals posted while the */
+/* loop is running or polling cost no system call at all.            */
+/*-------------------------------------------------------------------*/
+static U64 qeth_usecs()
+{
+    struct timeval tv;
+    gettimeofday( &tv, NULL );
+    return ((U64)tv.tv_sec * 1000000) + tv.tv_usec;
+}
+static void qeth_ring( OSA_GRP* grp, BYTE sig )
+{
+    U32  old = grp->dbsig, new, mask;
+    BYTE b = sig;
+
+    /* The latest SIGA-r/SIGA-w decides the packing mode */
+    switch (sig)
+    {
+    case QDSIG_READ:   mask = QDSIG_BIT( QDSIG_RDMULT ); break;
+    case QDSIG_RDMULT: mask = QDSIG_BIT( QDSIG_READ   ); break;
+    case QDSIG_WRIT:   mask = QDSIG_BIT( QDSIG_WRMULT ); break;
+    case QDSIG_WRMULT: mask = QDSIG_BIT( QDSIG_WRIT   ); break;
+    default:           mask = 0;                         break;
+    }
+
+    do new = (old & ~(mask | QDSIG_SLEEPING)) | QDSIG_BIT( sig );
+    while (cmpxchg4( &old, new, &grp->dbsig ));
+
+    if (!(old & QDSIG_SLEEPING))
+        return;
+
+    PTT_QETH_TRACE( "b4 ring", 0,0,sig );
+    grp->rings++;
+#if defined( HAVE_SYS_EVENTFD_H )
+    if (grp->efd >= 0)
+    {
+        eventfd_t one = 1;
+        while (eventfd_write( grp->efd, one ) < 0 && errno == EINTR);
+        return;
+    }
+#endif
+    VERIFY( qeth_write_pipe( grp->ppfd[1], &b ) == 1);
+}
+static int qeth_doorbell_fd( OSA_GRP* grp )
+{
+    return grp->efd >= 0 ? grp->efd : grp->ppfd[0];
+}
+static void qeth_drain_doorbell( OSA_GRP* grp )
+{
+    BYTE sig = QDSIG_RESET;
+#if defined( HAVE_SYS_EVENTFD_H )
+    if (grp->efd >= 0)
+    {
+        eventfd_t count;
+        while (eventfd_read( grp->efd, &count ) < 0 && errno == EINTR);
+        return;
+    }
+#endif
+    VERIFY( qeth_read_pipe( grp->ppfd[0], &sig ) == 1);
+}
+static U32 qeth_take_signals( OSA_GRP* grp )
+{
+    U32 old = grp->dbsig;
+    while (cmpxchg4( &old, 0, &grp->dbsig ));
+    return old & ~QDSIG_SLEEPING;
+}
+
+
+/*-------------------------------------------------------------------*/
+/* Virtual switch: join, leave and forward                           */
+/*-------------------------------------------------------------------*/
+static OSA_VSW* vswitches = NULL;       /* All virtual switches      */
+static LOCK     vswlock;                /* Lock for above chain      */
+
+static int qeth_vsw_join( DEVBLK* dev, OSA_GRP* grp, char* name )
+{
+    OSA_VSW* vsw;
+
+    obtain_lock( &vswlock );
+    for (vsw = vswitches; vsw; vsw = vsw->next)
+        if (!strcasecmp( vsw->name, name ))
+            break;
+    if (!vsw)
+    {
+        char buf[32];
+        vsw = calloc( 1, sizeof( OSA_VSW ));
+        if (!vsw)
+        {
+            release_lock( &vswlock );
+            // HHC00900 "%1d:%04X %s: error in function %s: %s"
+            WRMSG(HHC00900, "E", LCSS_DEVNUM, dev->typname,
+                                 "calloc()", strerror(errno) );
+            return -1;
+        }
+        STRLCPY( vsw->name, name );
+        initialize_lock( &vsw->lock );
+        MSGBUF( buf, "&vsw->lock %s", vsw->name );
+        set_lock_name( &vsw->lock, buf );
+        vsw->next = vswitches;
+        vswitches = vsw;
+    }
+    obtain_lock( &vsw->lock );
+    if (vsw->nports >= OSA_VSW_MAXPORTS)
+    {
+        release_lock( &vsw->lock );
+        release_lock( &vswlock );
+        // HHC00919 "%1d:%04X %s: Virtual switch %s has no free port"
+        WRMSG(HHC00919, "E", LCSS_DEVNUM, dev->typname, name );
+        return -1;
+    }
+    vsw->port[ vsw->nports++ ] = grp;
+    grp->vsw = vsw;
+    release_lock( &vsw->lock );
+    release_lock( &vswlock );
+    return 0;
+}
+
+static void qeth_vsw_leave( OSA_GRP* grp )
+{
+    OSA_VSW*  vsw = grp->vsw;
+    OSA_VSW** pp;
+    int       i;
+
+    if (!vsw)
+        return;
+
+    /* Once out of the port table nobody queues frames for us */
+    obtain_lock( &vswlock );
+    obtain_lock( &vsw->lock );
+    for (i = 0; i < vsw->nports; i++)
+    {
+        if (vsw->port[i] == grp)
+        {
+            vsw->port[i] = vsw->port[ --vsw->nports ];
+            break;
+        }
+    }
+    grp->vsw = NULL;
+    release_lock( &vsw->lock );
+
+    /* The last port out removes the switch */
+    if (!vsw->nports)
+    {
+        for (pp = &vswitches; *pp; pp = &(*pp)->next)
+        {
+            if (*pp == vsw)
+            {
+                *pp = vsw->next;
+                break;
+            }
+        }
+        destroy_lock( &vsw->lock );
+        free( vsw );
+    }
+    release_lock( &vswlock );
+}
+
+/* Queue a copy of a frame for another port and wake its thread */
+static void qeth_vsw_deliver( DEVBLK* dev, OSA_GRP* grp, OSA_GRP* dst,
+                              BYTE* pkt, int pktlen )
+{
+    OSA_BHR* bhr;
+
+    if (dst->vswq.numbhr >= OSA_VSW_MAXQ)
+    {
+        grp->vswdrop++;
+        return;
+    }
+    if (!(bhr = alloc_buffer( dev, pktlen )))
+        return;
+    memcpy( (BYTE*)bhr + SizeBHR, pkt, pktlen );
+    bhr->datalen = pktlen;
+    add_buffer_to_chain( &dst->vswq, bhr );
+    grp->vswout++;
+    qeth_ring( dst, QDSIG_WAKEUP );
+}
+
+/*-------------------------------------------------------------------*/
+/* Switch a frame (L2) or packet (L3) written by the guest to the    */
+/* other ports of its virtual switch.  Unicast to an address one of  */
+/* them has registered goes to that port only and 1 is returned.     */
+/* Broadcast and multicast go to every port of the same layer that   */
+/* accepts it, and 0 is returned so it also leaves via our TUN/TAP,  */
+/* as does anything addressed to no port at all.                     */
+/*-------------------------------------------------------------------*/
+static int qeth_vsw_forward( DEVBLK* dev, OSA_GRP* grp,
+                             BYTE* pkt, int pktlen )
+{
+    OSA_VSW* vsw = grp->vsw;
+    OSA_GRP* dst;
+    BYTE*    dest;
+    int      i, j, len, multi;
+
+    if (!grp->l3)
+    {
+        if (pktlen < (int) sizeof( ETHFRM ))
+            return 0;
+        dest  = ((ETHFRM*)pkt)->bDestMAC;
+        multi = dest[0] & 0x01;         /* (includes broadcast)      */
+        len   = IFHWADDRLEN;
+    }
+    else if ((pkt[0] & 0xF0) == 0x40 && pktlen >= (int) sizeof( IP4FRM ))
+    {
+        static const BYTE bcast[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+        dest  = (BYTE*) &((IP4FRM*)pkt)->lDstIP;
+        multi = (dest[0] & 0xF0) == 0xE0 || !memcmp( dest, bcast, 4 );
+        len   = 4;
+    }
+    else if ((pkt[0] & 0xF0) == 0x60 && pktlen >= (int) sizeof( IP6FRM ))
+    {
+        dest  = ((IP6FRM*)pkt)->bDstAddr;
+        multi = dest[0] == 0xFF;
+        len   = 16;
+    }
+    else
+        return 0;
+
+    obtain_lock( &vsw->lock );
+    for (i = 0; i < vsw->nports; i++)
+    {
+        dst = vsw->port[i];
+        if (dst == grp || dst->l3 != grp->l3)
+            continue;
+
+        if (multi)
+        {
+            /* Every port that would accept it gets a copy */
+            if (grp->l3 || validate_mac( dest, MAC_TYPE_ANY, dst ))
+                qeth_vsw_deliver( dev, grp, dst, pkt, pktlen );
+            continue;
+        }
+
+        /* Look for the port that registered the address */
+        if (!grp->l3)
+            j = validate_mac( dest, MAC_TYPE_UNICST, dst ) & MAC_TYPE_UNICST;
+        else if (len == 4)
+        {
+            for (j = 0; j < OSA_MAXIPV4; j++)
+                if (dst->ipaddr4[j].type == IPV4_TYPE_INUSE
+                 && !memcmp( dst->ipaddr4[j].addr, dest, 4 ))
+                    break;
+            j = j < OSA_MAXIPV4;
+        }
+        else
+        {
+            for (j = 0; j < OSA_MAXIPV6; j++)
+                if (dst->ipaddr6[j].type == IPV6_TYPE_INUSE
+                 && !memcmp( dst->ipaddr6[j].addr, dest, 16 ))
+                    break;
+            j = j < OSA_MAXIPV6;
+        }
+        if (j)
+        {
+            qeth_vsw_deliver( dev, grp, dst, pkt, pktlen );
+            release_lock( &vsw->lock );
+            return 1;
+        }
+    }
+    release_lock( &vsw->lock );
+    return 0;
+}
+
+
 /*-------------------------------------------------------------------*/
 /*  Helper macro to call "qeth_errnum_msg()" function                */
 /*-------------------------------------------------------------------*/
@@ -2720,6 +2993,8 @@ static BYTE more_packets( DEVBLK* dev )
 {
     fd_set readset;
     struct timeval tv = {0,0};
+    if (((OSA_GRP*)dev->group->grp_data)->vswq.firstbhr)
+        return 1;
     FD_ZERO( &readset );
     FD_SET( dev->fd, &readset );
     return (qeth_select( dev->fd+1, &readset, &tv ) > 0);
@@ -2735,6 +3010,20 @@ static QRC read_packet( DEVBLK* dev, OSA_GRP *grp )
     int errnum;
 
     PTT_QETH_TRACE( "rdpack entr", dev->bufsize, 0, 0 );
+
+    /* Frames switched to us by other virtual switch ports first */
+    if (grp->vswq.firstbhr)
+    {
+        OSA_BHR* bhr = remove_buffer_from_chain( &grp->vswq );
+        if (bhr)
+        {
+            dev->buflen = min( bhr->datalen, dev->bufsize );
+            memcpy( dev->buf, (BYTE*)bhr + SizeBHR, dev->buflen );
+            free( bhr );
+            goto received;
+        }
+    }
+
     dev->buflen = TUNTAP_Read( dev->fd, dev->buf, dev->bufsize );
     errnum = errno;
 
@@ -2764,8 +3053,12 @@ static QRC read_packet( DEVBLK* dev, OSA_GRP *grp )
         return QRC_EPKEOF;
     }
 
+received:
+
     /* Count packets received */
     dev->qdio.rxcnt++;
+    dev->netrxpkts++;
+    dev->netrxbytes += dev->buflen;
 
     PTT_QETH_TRACE( "rdpack exit", dev->bufsize, dev->buflen, QRC_SUCCESS );
     return QRC_SUCCESS;
@@ -2787,6 +3080,8 @@ static QRC write_packet( DEVBLK* dev, OSA_GRP *grp,
     if (likely(wrote == pktlen))
     {
         dev->qdio.txcnt++;
+        dev->nettxpkts++;
+        dev->nettxbytes += pktlen;
         PTT_QETH_TRACE( "wrpack exit", 0, pktlen, QRC_SUCCESS );
         return QRC_SUCCESS;
     }
@@ -3506,8 +3801,17 @@ static QRC write_buffered_packets( DEVBLK* dev, OSA_GRP *grp,
             }
         }
 
-        /* Write the packet */
-        qrc = write_packet( dev, grp, pkt, pktlen );
+        /* Write the packet, unless the virtual switch delivered
+           it straight to the one port it was addressed to */
+        if (grp->vsw && qeth_vsw_forward( dev, grp, pkt, pktlen ))
+        {
+            dev->qdio.txcnt++;
+            dev->nettxpkts++;
+            dev->nettxbytes += pktlen;
+            qrc = QRC_SUCCESS;
+        }
+        else
+            qrc = write_packet( dev, grp, pkt, pktlen );
 
 #if defined( ENABLE_IPV6 )
 
@@ -3664,7 +3968,15 @@ int did_read = 0;                       /* Indicates some data read  */
     if (!did_read && more_packets( dev ))
     {
         char buff[4096];
-        int packet_len = TUNTAP_Read( grp->ttfd, buff, sizeof( buff ));
+        OSA_BHR* bhr;
+        int packet_len;
+        if ((bhr = remove_buffer_from_chain( &grp->vswq )))
+        {
+            packet_len = bhr->datalen;
+            free( bhr );
+        }
+        else
+            packet_len = TUNTAP_Read( grp->ttfd, buff, sizeof( buff ));
         if (packet_len)
         {
             dev->qdio.dropcnt++;
@@ -3814,7 +4126,7 @@ static void qeth_halt_data_device( DEVBLK* dev, OSA_GRP* grp )
             {
                 /* Ask, then wait for, the Activate Queues loop to exit */
                 PTT_QETH_TRACE( "b4 halt data", 0,0,0 );
-                VERIFY( qeth_write_pipe( grp->ppfd[1], &sig ) == 1);
+                qeth_ring( grp, sig );
                 wait_condition( &grp->qdcond, &grp->qlock );
                 dev->scsw.flag2 &= ~SCSW2_Q;
                 PTT_QETH_TRACE( "af halt data", 0,0,0 );
@@ -3950,6 +4262,10 @@ U32 mask4;
             MSGBUF( buf,    "&grp->l3r.lockbhr %1d:%04X", LCSS_DEVNUM );
             set_lock_name(   &grp->l3r.lockbhr, buf );
 
+            initialize_lock( &grp->vswq.lockbhr );
+            MSGBUF( buf,    "&grp->vswq.lockbhr %1d:%04X", LCSS_DEVNUM );
+            set_lock_name(   &grp->vswq.lockbhr, buf );
+
             /* Create ACTIVATE QUEUES signalling pipe */
             /* Check your return codes, Jan. */
 
@@ -3960,6 +4276,13 @@ U32 mask4;
             VERIFY( socket_set_blocking_mode( grp->ppfd[0], 0 ) == 0);
             VERIFY( socket_set_blocking_mode( grp->ppfd[1], 0 ) == 0);
 
+            /* Ring an eventfd doorbell instead if the host has them */
+
+            grp->efd = -1;
+#if defined( HAVE_SYS_EVENTFD_H )
+            grp->efd = eventfd( 0, EFD_NONBLOCK );
+#endif
+
             /* Set defaults */
 
             grp->ttdev = strdup( DEF_NETDEV );
@@ -4070,6 +4393,28 @@ U32 mask4;
             grp->ttchpid = strdup(argv[++i]);
             continue;
         }
+        else if(!strcasecmp("vswitch",argv[i]) && (i+1) < argc)
+        {
+            free( grp->ttvswitch );
+            grp->ttvswitch = strdup(argv[++i]);
+            continue;
+        }
+        else if(!strcasecmp("poll",argv[i]) && (i+1) < argc)
+        {
+            int n;
+            char c;
+            if (sscanf( argv[i+1], "%d%c", &n, &c ) != 1
+             || n < 0 || n > OSA_POLLMAXUS)
+            {
+                // HHC00918 "%1d:%04X %s: option %s unknown or specified incorrectly"
+                WRMSG(HHC00918, "E", LCSS_DEVNUM, dev->typname, argv[i] );
+                ++i;
+                continue;
+            }
+            grp->pollmax = n;
+            ++i;
+            continue;
+        }
         else if (!strcasecmp("debug",argv[i]))
         {
             grp->debugmask = DBGQETHPACKET+DBGQETHDATA+DBGQETHUPDOWN;
@@ -4358,6 +4703,20 @@ U32 mask4;
         }
         if(grp->ttpfxlen6)
             makepfxmask6( grp->ttpfxlen6, grp->confpfxmask6 );
+
+        /* Attach to the virtual switch */
+        if (grp->ttvswitch && !grp->vsw)
+        {
+            if (!grp->ttvswitch[0] || strlen( grp->ttvswitch ) > OSA_VSW_NAMELEN)
+            {
+                // HHC00916 "%1d:%04X %s: option %s value %s invalid"
+                WRMSG(HHC00916, "E", LCSS_DEVNUM, dev->typname,
+                                     "vswitch", grp->ttvswitch );
+                retcode = -1;
+            }
+            else if (qeth_vsw_join( dev, grp, grp->ttvswitch ) != 0)
+                retcode = -1;
+        }
     }
 
     return retcode;
@@ -4385,12 +4744,17 @@ OSA_GRP *grp;
 
     if (dev->group->acount == dev->group->members)
     {
-        char ttifname[IFNAMSIZ+2];
+        char ttifname[IFNAMSIZ+OSA_VSW_NAMELEN+3];
         char dropped[17] = {0}; // " dr[%u]"
 
         STRLCPY( ttifname, grp->ttifname );
         if (ttifname[0])
             STRLCAT( ttifname, " " );
+        if (grp->vsw)
+        {
+            STRLCAT( ttifname, grp->vsw->name );
+            STRLCAT( ttifname, " " );
+        }
 
         if (grp->debugmask & DBGQETHDROP)
             MSGBUF( dropped, " dr[%u]", dev->qdio.dropcnt );
@@ -4435,6 +4799,8 @@ OSA_GRP *grp = (OSA_GRP*)(group ? group->grp_data : NULL);
     {
         int i, ttfd = grp->ttfd;
 
+        qeth_vsw_leave( grp );
+
         PTT_QETH_TRACE( "b4 clos halt", 0,0,0 );
         for (i=0; i < dev->group->members; i++)
         {
@@ -4458,6 +4824,8 @@ OSA_GRP *grp = (OSA_GRP*)(group ? group->grp_data : NULL);
             close_pipe(grp->ppfd[0]);
         if(grp->ppfd[1])
             close_pipe(grp->ppfd[1]);
+        if(grp->efd >= 0)
+            close(grp->efd);
         PTT_QETH_TRACE( "af clos pipe", 0,0,0 );
 
         PTT_QETH_TRACE( "b4 clos othr", 0,0,0 );
@@ -4471,11 +4839,13 @@ OSA_GRP *grp = (OSA_GRP*)(group ? group->grp_data : NULL);
         free( grp->ttpfxlen6 );
         free( grp->ttmtu     );
         free( grp->ttchpid   );
+        free( grp->ttvswitch );
 
         PTT_QETH_TRACE( "af clos othr", 0,0,0 );
 
         PTT_QETH_TRACE( "b4 clos fbuf", 0,0,0 );
         remove_and_free_any_buffers_on_chain( &grp->idx );
+        remove_and_free_any_buffers_on_chain( &grp->vswq );
         PTT_QETH_TRACE( "af clos fbuf", 0,0,0 );
 
         destroy_condition( &grp->qrcond );
@@ -4483,6 +4853,7 @@ OSA_GRP *grp = (OSA_GRP*)(group ? group->grp_data : NULL);
         destroy_lock( &grp->qlock );
         destroy_lock( &grp->idx.lockbhr );
         destroy_lock( &grp->l3r.lockbhr );
+        destroy_lock( &grp->vswq.lockbhr );
 
         PTT_QETH_TRACE( "b4 clos fgrp", 0,0,0 );
         free( group->grp_data );
@@ -5154,70 +5525,101 @@ U32 num;                                /* Number of bytes to move   */
     fd_set readset;                         /* select read set       */
     struct timeval tv;                      /* select polling        */
     int fd;                                 /* select fd             */
+    int dbfd;                               /* doorbell fd           */
     int rc=0;                               /* select rc (0=timeout) */
-    BYTE sig;                               /* thread pipe signal    */
+    BYTE sig = QDSIG_RESET;                 /* doorbell signal       */
+    U32 sigs, old;                          /* doorbell signals      */
+    unsigned pkts;                          /* packets before pass   */
+    int polling;                            /* 1=in poll window      */
 
         /*
         ** PROGRAMMING NOTE: we use a relatively short timeout value
         ** for our select so that we can react fairly quickly to the
         ** guest readying (priming) additional output buffers in its
         ** existing Output Queue(s) because a SIGA-w is not required.
+        **
+        ** With the "poll" option the loop does not wait at all for
+        ** a while after it last found work to do; instead it keeps
+        ** checking the TUN/TAP device, the doorbell and the SBALs of
+        ** the Output Queues.  The poll window doubles (up to "poll"
+        ** usecs) each time it finds work and halves when it expires
+        ** without, so an idle adapter soon goes back to waiting.
         */
+        grp->dbsig = 0;                     /* No signals pending    */
+        grp->pollus = grp->pollmax;         /* Start fully polling   */
+        grp->pollend = 0;
+        dbfd = qeth_doorbell_fd( grp );
+
         dev->scsw.flag2 |= SCSW2_Q;         /* Indicate QDIO active  */
         dev->qtype = QTYPE_DATA;            /* Identify ourselves    */
 
         DBGTRC( dev, "Activate Queues: Entry iqm=%8.8x oqm=%8.8x",dev->qdio.i_qmask, dev->qdio.o_qmask);
         PTT_QETH_TRACE( "actq entr", 0,0,0 );
 
-        /* Loop until halt signal is received via notification pipe */
+        /* Loop until halt signal is received via the doorbell */
         while (1)
         {
-            /* Prepare to wait for additional packets or pipe signal */
+            /* Prepare to wait for additional packets or a doorbell */
             FD_ZERO( &readset );
-            FD_SET( grp->ppfd[0], &readset );
-            FD_SET( grp->ttfd,    &readset );
-            fd = max( grp->ppfd[0], grp->ttfd );
+            FD_SET( dbfd,      &readset );
+            FD_SET( grp->ttfd, &readset );
+            fd = max( dbfd, grp->ttfd );
             tv.tv_sec  = 0;
             tv.tv_usec = OSA_TIMEOUTUS;         /* Select timeout usecs  */
 
+            /* Don't wait at all while in the poll window, nor if a
+               signal is already pending; otherwise tell the doorbell
+               that we are about to wait for it */
+            polling = grp->pollend && qeth_usecs() < grp->pollend;
+            old = 0;
+            if (polling)
+            {
+                tv.tv_usec = 0;
+                grp->polls++;
+            }
+            else if (cmpxchg4( &old, QDSIG_SLEEPING, &grp->dbsig ))
+                tv.tv_usec = 0;
+
             /* Wait (but only very briefly) for more work to arrive */
             rc = qeth_select( fd+1, &readset, &tv );
 
-            /* Read pipe signal if one was sent */
-            if (unlikely( rc && FD_ISSET( grp->ppfd[0], &readset )))
+            /* Acknowledge the doorbell if it was rung */
+            if (unlikely( rc > 0 && FD_ISSET( dbfd, &readset )))
             {
-                sig = QDSIG_RESET;
-                VERIFY( qeth_read_pipe( grp->ppfd[0], &sig ) == 1);
-                if (QDSIG_HALT == sig || grp->debugmask & DBGQETHQUEUES)
-                    DBGTRC( dev, "Activate Queues: %s received", qsig2str( sig ));
+                grp->wakeups++;
+                qeth_drain_doorbell( grp );
+            }
+
+            /* Take whatever signals were sent */
+            sigs = qeth_take_signals( grp );
+            if (sigs)
+            {
+                for (sig = QDSIG_HALT; sig <= QDSIG_WAKEUP; sig++)
+                    if (sigs & QDSIG_BIT( sig ))
+                        if (QDSIG_HALT == sig || grp->debugmask & DBGQETHQUEUES)
+                            DBGTRC( dev, "Activate Queues: %s received", qsig2str( sig ));
 
                 /* Exit immediately when requested to do so */
-                if (QDSIG_HALT == sig)
+                if (sigs & QDSIG_BIT( QDSIG_HALT ))
+                {
+                    sig = QDSIG_HALT;
                     break;
+                }
 
-                switch (sig)
-                {
-                case QDSIG_READ:
+                if (sigs & QDSIG_BIT( QDSIG_READ ))
                     grp->rdpack = 0;
-                    break;
-                case QDSIG_RDMULT:
+                if (sigs & QDSIG_BIT( QDSIG_RDMULT ))
                     grp->rdpack = 1;
-                    break;
-                case QDSIG_WRIT:
+                if (sigs & QDSIG_BIT( QDSIG_WRIT ))
                     grp->wrpack = 0;
-                    break;
-                case QDSIG_WRMULT:
+                if (sigs & QDSIG_BIT( QDSIG_WRMULT ))
                     grp->wrpack = 1;
-                    break;
-                case QDSIG_WAKEUP:
-                    break;
-                default:
-                    ASSERT(0);  /* (should NEVER occur) */
-                }
             }
 
+            pkts = dev->qdio.rxcnt + dev->qdio.txcnt + dev->qdio.dropcnt;
+
             /* Check if any new packets have arrived */
-            if ((rc && FD_ISSET( grp->ttfd, &readset )) || grp->l3r.firstbhr)
+            if ((rc > 0 && FD_ISSET( grp->ttfd, &readset )) || grp->l3r.firstbhr || grp->vswq.firstbhr)
             {
                 /* Process packets if Queue is available */
                 if (likely( dev->qdio.i_qmask ))
@@ -5265,6 +5667,28 @@ U32 num;                                /* Number of bytes to move   */
                     raise_adapter_interrupt( dev );
                 }
             }
+
+            /* Adapt the poll window to how busy the adapter is */
+            if (grp->pollmax)
+            {
+                if (sigs || pkts != dev->qdio.rxcnt + dev->qdio.txcnt + dev->qdio.dropcnt)
+                {
+                    /* Work found: (re)open the window, longer if the
+                       last one found work too */
+                    if (polling)
+                    {
+                        grp->pollhits++;
+                        grp->pollus = min( grp->pollus * 2, grp->pollmax );
+                    }
+                    grp->pollend = qeth_usecs() + grp->pollus;
+                }
+                else if (grp->pollend && !polling)
+                {
+                    /* Window expired without work: shorten the next */
+                    grp->pollus = max( grp->pollus / 2, OSA_POLLMINUS );
+                    grp->pollend = 0;
+                }
+            }
         }
         PTT_QETH_TRACE( "actq break", dev->devnum, 0,0 );
 
@@ -5358,6 +5782,7 @@ static int qeth_initiate_input(DEVBLK *dev, U32 qmask)
 OSA_GRP *grp = (OSA_GRP*)dev->group->grp_data;
 int noselrd, rc = 0;
 
+    grp->sigar++;
     if (grp->debugmask & DBGQETHSIGA)
         DBGTRC( dev, "SIGA-r qmask(%8.8x)", qmask );
 
@@ -5397,7 +5822,7 @@ int noselrd, rc = 0;
             BYTE sig = QDSIG_READ;
             if (grp->debugmask & DBGQETHSIGA)
                 DBGTRC( dev, "SIGA-r: sending %s", qsig2str( sig ));
-            VERIFY( qeth_write_pipe( grp->ppfd[1], &sig ) == 1);
+            qeth_ring( grp, sig );
         }
     }
 
@@ -5413,6 +5838,8 @@ static int qeth_do_initiate_output( DEVBLK *dev, U32 qmask, BYTE sig )
 {
 OSA_GRP *grp = (OSA_GRP*)dev->group->grp_data;
 
+    grp->sigaw++;
+
     /* Return CC1 if the device is not QDIO active */
     if(!(dev->scsw.flag2 & SCSW2_Q))
         return 1;
@@ -5439,7 +5866,7 @@ OSA_GRP *grp = (OSA_GRP*)dev->group->grp_data;
     {
         if (grp->debugmask & DBGQETHSIGA)
             DBGTRC( dev, "SIGA-o: sending %s", qsig2str( sig ));
-        VERIFY( qeth_write_pipe( grp->ppfd[1], &sig ) == 1);
+        qeth_ring( grp, sig );
     }
 
     return 0;
@@ -5490,6 +5917,9 @@ static int qeth_initiate_output_mult( DEVBLK *dev, U32 qmask )
 static int qeth_do_sync( DEVBLK *dev, U32 oqmask, U32 iqmask )
 {
     int rc = 0;
+OSA_GRP *grp = (OSA_GRP*)dev->group->grp_data;
+
+    grp->sigas++;
 
     /* Return CC1 if the device is not QDIO active */
     if(!(dev->scsw.flag2 & SCSW2_Q))
@@ -6605,7 +7035,6 @@ static void process_l3_icmpv6_packet(DEVBLK* dev, OSA_GRP* grp, IP6FRM* ip6)
     U16        ip6re_payload_size;  // Response ICMPv6 data size
     char       unspecified[16];
     char       solicitednode[16];
-    BYTE       sig;
 
     // Initialize variables
     memset( unspecified, 0, 16 );
@@ -6681,8 +7110,7 @@ static void process_l3_icmpv6_packet(DEVBLK* dev, OSA_GRP* grp, IP6FRM* ip6)
 
         // Add response buffer to chain.
         add_buffer_to_chain( &grp->l3r, bhrre );
-        sig = QDSIG_WAKEUP;
-        VERIFY( qeth_write_pipe( grp->ppfd[1], &sig ) == 1);
+        qeth_ring( grp, QDSIG_WAKEUP );
         return;
       }
 
@@ -6845,6 +7273,9 @@ HDL_DEPENDENCY_SECTION;
 
     memcpy( (ND*)&node_data[0], &osa_nd[0], sizeof( ND ));
     memcpy( (ND*)&node_data[1], &osa_nq[0], sizeof( NQ ));
+
+    initialize_lock( &vswlock );
+    set_lock_name( &vswlock, "vswlock" );
 }
 END_DEPENDENCY_SECTION
 
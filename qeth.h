@@ -32,6 +32,11 @@
 #define OSA_MAXIPV6            32     /* Max supported IPv6 addresses*/
 #define OSA_MAXMAC             32     /* Max supported MAC addresses */
 #define OSA_TIMEOUTUS       50000     /* Read select timeout (usecs) */
+#define OSA_POLLMINUS          10     /* Min adaptive poll (usecs)   */
+#define OSA_POLLMAXUS       10000     /* Max "poll" option (usecs)   */
+#define OSA_VSW_MAXPORTS       32     /* Max ports on virtual switch */
+#define OSA_VSW_MAXQ          256     /* Max frames queued per port  */
+#define OSA_VSW_NAMELEN         8     /* Max virtual switch name len */
 
 #define QTOKEN1        0xD8C5E3F1     /* QETH token 1 (QET1 ebcdic)  */
 #define QTOKEN2        0xD8C5E3F2     /* QETH token 2 (QET2 ebcdic)  */
@@ -119,6 +124,26 @@ typedef struct _OSA_BAN {
 } OSA_BAN;
 
 
+/*-------------------------------------------------------------------*/
+/* OSA Virtual Switch                                                */
+/*-------------------------------------------------------------------*/
+/* QETH groups naming the same virtual switch are its ports. Frames  */
+/* a guest writes for another port's registered MAC or IP address    */
+/* are queued straight onto that port's vswq chain instead of going  */
+/* through the TUN/TAP devices; all other frames, and copies of any  */
+/* broadcast or multicast, leave through the sender's own TUN/TAP.   */
+/*-------------------------------------------------------------------*/
+struct _OSA_GRP;
+typedef struct _OSA_VSW OSA_VSW;
+struct _OSA_VSW {
+    OSA_VSW*  next;             /* Next virtual switch               */
+    char      name[OSA_VSW_NAMELEN+1]; /* Virtual switch name        */
+    LOCK      lock;             /* Lock for port table               */
+    int       nports;           /* Number of ports in use            */
+    struct _OSA_GRP* port[OSA_VSW_MAXPORTS]; /* Ports (QETH groups)  */
+};
+
+
 /*-------------------------------------------------------------------*/
 /* OSA MAC structure                                                 */
 /*-------------------------------------------------------------------*/
@@ -171,6 +196,12 @@ typedef struct _OSA_GRP {
 
     OSA_BAN  l3r;               /* Layer 3 response buffer anchor    */
 
+    OSA_BAN  vswq;              /* Virtual switch input anchor       */
+    OSA_VSW* vsw;               /* Virtual switch (NULL = none)      */
+    char*    ttvswitch;         /* Virtual switch name option        */
+    U64      vswout;            /* Frames switched to another port   */
+    U64      vswdrop;           /* Frames dropped (port queue full)  */
+
     char *ttdev;                /* Interface path name               */
     char  ttifname[IFNAMSIZ];   /* Interface network name            */
 
@@ -241,6 +272,22 @@ typedef struct _OSA_GRP {
 
     int   ttfd;                 /* File Descriptor TUNTAP Device     */
     int   ppfd[2];              /* Thread signalling socket pipe     */
+    int   efd;                  /* Doorbell eventfd (-1 = use ppfd)  */
+    U32   dbsig;                /* Doorbell: pending QDSIG_xxx bits  */
+
+    int   pollmax;              /* Max adaptive poll (usecs, 0=off)  */
+    int   pollus;               /* Current poll window (usecs)       */
+    U64   pollend;              /* Poll window end (usecs)           */
+
+    U64   sigar;                /* SIGA-r executed                   */
+    U64   sigaw;                /* SIGA-w/SIGA-m executed            */
+    U64   sigas;                /* SIGA-s executed                   */
+    U64   rings;                /* Doorbells rung (thread asleep)    */
+    U64   wakeups;              /* Wakeups by the doorbell           */
+    U64   polls;                /* Loop iterations while polling     */
+    U64   pollhits;             /* Poll windows that found work      */
+    U64   statsus;              /* Time of last QETH STATS (usecs)   */
+    U64   statsold[9];          /* Counters at last QETH STATS       */
 
     U32   seqnumth;             /* MPC_TH sequence number            */
     U32   seqnumis;             /* MPC_RRH sequence number issuer    */
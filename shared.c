@@ -35,38 +35,62 @@ DEVHND  shared_fba_device_hndinfo;
 int shared_update_notify (DEVBLK *dev, int block)
 {
 int      i, j;                          /* Indexes                   */
+int      max;                           /* Max purge entries         */
+SHRD    *shrd;                          /* -> SHRD block             */
+FWORD   *purge;                         /* Reallocated purge list    */
 
     /* Return if no remotes are connected */
     if (dev->shrdconn == 0)
         return 0;
 
-    for (i = 0; i < SHARED_MAX_SYS; i++)
+    obtain_lock (&dev->lock);
+
+    for (i = 0; i < dev->shrdmax; i++)
     {
+        shrd = dev->shrd[i];
 
         /* Ignore the entry if it doesn't exist or if it's ours
            our if it's already maxed out */
-        if (dev->shrd[i] == NULL || dev->shrd[i]->id == dev->shioactive
-         || dev->shrd[i]->purgen < 0)
+        if (shrd == NULL || shrd->id == dev->shioactive
+         || shrd->purgen < 0)
             continue;
 
         /* Check if the block is already entered */
-        for (j = 0; j < dev->shrd[i]->purgen; j++)
-            if (fetch_fw(dev->shrd[i]->purge[j]) == (U32)block) break;
+        for (j = 0; j < shrd->purgen; j++)
+            if (fetch_fw(shrd->purge[j]) == (U32)block) break;
 
         /* Add the block if it's not already there */
-        if (j >= dev->shrd[i]->purgen)
+        if (j >= shrd->purgen)
         {
-            if (dev->shrd[i]->purgen >= SHARED_PURGE_MAX)
-                dev->shrd[i]->purgen = -1;
+            /* Lower release clients get the list in the START
+               response which can only hold SHARED_PURGE_MAX */
+            max = shrd->release < 3 ? SHARED_PURGE_MAX : SHARED_NOTIFY_MAX;
+
+            if (shrd->purgen >= max)
+                shrd->purgen = -1;
             else
-                store_fw (dev->shrd[i]->purge[dev->shrd[i]->purgen++],
-                          block);
+            {
+                if (shrd->purgen >= shrd->purgemax)
+                {
+                    j = shrd->purgemax ? shrd->purgemax * 2 : SHARED_PURGE_MAX;
+                    if (!(purge = realloc (shrd->purge, j * sizeof(FWORD))))
+                    {
+                        shrd->purgen = -1;
+                        continue;
+                    }
+                    shrd->purge = purge;
+                    shrd->purgemax = j;
+                }
+                store_fw (shrd->purge[shrd->purgen++], block);
+            }
            SHRDTRACE("notify %d added for id=%d, n=%d",
-                   block, dev->shrd[i]->id, dev->shrd[i]->purgen);
+                   block, shrd->id, shrd->purgen);
         }
 
     } /* for each possible remote system */
 
+    release_lock (&dev->lock);
+
     return 0;
 
 } /* shared_update_notify */
@@ -96,6 +120,7 @@ char    *strtok_str = NULL;             /* last position             */
     if (!(retry = dev->connecting))
     {
         dev->connected = 0;             /* SHRD_CONNECT not done yet */
+        dev->rmtcompalg = SHRD_LIBZ;    /* Default compression method*/
 
         if (argc < 1 || strlen(argv[0]) >= sizeof(buf))
             return -1;
@@ -171,16 +196,14 @@ char    *strtok_str = NULL;             /* last position             */
                 cu = op;
                 continue;
             }
-#if defined( HAVE_ZLIB )
+#if defined( SHARED_COMPRESS )
             if (strlen (argv[i]) > 5
              && memcmp("comp=", argv[i], 5) == 0)
             {
                 kw = strtok_r (argv[i], "=", &strtok_str );
                 op = strtok_r (NULL, " \t", &strtok_str );
-                dev->rmtcomp = atoi (op);
-                if (dev->rmtcomp < 0 || dev->rmtcomp > 9)
-                    dev->rmtcomp = 0;
-                continue;
+                if (clientCompParm (dev, op) == 0)
+                    continue;
             }
 #endif
             // "Shared: parameter %s in argument %d is invalid"
@@ -197,6 +220,12 @@ char    *strtok_str = NULL;             /* last position             */
 #if defined( CCKD_BZIP2 )
     dev->rmtcomps |= SHRD_BZIP2;
 #endif
+#if defined( HAVE_ZSTD )
+    dev->rmtcomps |= SHRD_ZSTD;
+#endif
+#if defined( HAVE_LZ4 )
+    dev->rmtcomps |= SHRD_LZ4;
+#endif
 
     /* Update the device handler vector */
     dev->hnd = &shared_ckd_device_hndinfo;
@@ -364,8 +393,7 @@ static int shared_ckd_close ( DEVBLK *dev )
     if (dev->fd >= 0)
     {
         clientRequest (dev, NULL, 0, SHRD_DISCONNECT, 0, NULL, NULL);
-        close_socket (dev->fd);
-        dev->fd = -1;
+        clientClose (dev);
     }
 
     return 0;
@@ -390,7 +418,7 @@ FWORD    origin;                        /* FBA origin                */
 FWORD    numblks;                       /* FBA number blocks         */
 FWORD    blksiz;                        /* FBA block size            */
 char    *p, buf[1024];                  /* Work buffer               */
-#if defined( HAVE_ZLIB )
+#if defined( SHARED_COMPRESS )
 char    *strtok_str = NULL;             /* last token                */
 #endif
 
@@ -398,6 +426,7 @@ char    *strtok_str = NULL;             /* last token                */
     if (!(retry = dev->connecting))
     {
         dev->connected = 0;             /* SHRD_CONNECT not done yet */
+        dev->rmtcompalg = SHRD_LIBZ;    /* Default compression method*/
 
         kw = op = NULL;
 
@@ -445,16 +474,14 @@ char    *strtok_str = NULL;             /* last token                */
         rc = 0;
         for (i = 1; i < argc; i++)
         {
-#if defined( HAVE_ZLIB )
+#if defined( SHARED_COMPRESS )
             if (strlen (argv[i]) > 5
              && memcmp("comp=", argv[i], 5) == 0)
             {
                 kw = strtok_r (argv[i], "=", &strtok_str );
                 op = strtok_r (NULL, " \t", &strtok_str );
-                dev->rmtcomp = atoi (op);
-                if (dev->rmtcomp < 0 || dev->rmtcomp > 9)
-                    dev->rmtcomp = 0;
-                continue;
+                if (clientCompParm (dev, op) == 0)
+                    continue;
             }
 #endif
             // "Shared: parameter %s in argument %d is invalid"
@@ -473,6 +500,12 @@ char    *strtok_str = NULL;             /* last token                */
 #if defined( CCKD_BZIP2 )
     dev->rmtcomps |= SHRD_BZIP2;
 #endif
+#if defined( HAVE_ZSTD )
+    dev->rmtcomps |= SHRD_ZSTD;
+#endif
+#if defined( HAVE_LZ4 )
+    dev->rmtcomps |= SHRD_LZ4;
+#endif
 
     /* Update the device handler vector */
     dev->hnd = &shared_fba_device_hndinfo;
@@ -629,8 +662,7 @@ static int shared_fba_close (DEVBLK *dev)
     if (dev->fd >= 0)
     {
         clientRequest (dev, NULL, 0, SHRD_DISCONNECT, 0, NULL, NULL);
-        close_socket (dev->fd);
-        dev->fd = -1;
+        clientClose (dev);
     }
 
     return 0;
@@ -662,6 +694,13 @@ BYTE     buf[SHARED_PURGE_MAX * 4];     /* Purge list                */
         return;
     }
 
+    /* Purge everything if a pipelined request failed */
+    if (dev->rmtpurgeall)
+    {
+        dev->rmtpurgeall = 0;
+        clientPurge (dev, 0, NULL);
+    }
+
     /* Check for purge */
     if (code & SHRD_PURGE)
     {
@@ -707,8 +746,16 @@ int      rc;                            /* Return code               */
         cache_unlock (CACHE_DEVBUF);
     }
 
-    /* Send the END request */
-    rc = clientRequest (dev, NULL, 0, SHRD_END, 0, NULL, NULL);
+    /* Send the END request.  A release 3 server processes our
+       requests in order so we needn't wait for the response */
+    if (dev->rmtrel >= 3)
+    {
+        BYTE hdr[SHRD_HDR_SIZE];        /* END request header        */
+        SHRD_SET_HDR (hdr, SHRD_END, 0, dev->rmtnum, dev->rmtid, 0);
+        rc = clientPost (dev, hdr, NULL, 0, -1);
+    }
+    else
+        rc = clientRequest (dev, NULL, 0, SHRD_END, 0, NULL, NULL);
     if (rc < 0)
     {
         // "%1d:%04X Shared: error during channel program end"
@@ -752,6 +799,13 @@ BYTE     hdr[SHRD_HDR_SIZE + 4];        /* Read request header       */
         clientWrite (dev, dev->bufcur);
     dev->bufupd = 0;
 
+    /* Purge everything if a pipelined request failed */
+    if (dev->rmtpurgeall)
+    {
+        dev->rmtpurgeall = 0;
+        clientPurge (dev, 0, NULL);
+    }
+
     /* Reset buffer offsets */
     dev->bufoff = 0;
     dev->bufoffhi = dev->ckdtrksz;
@@ -964,7 +1018,14 @@ static void shared_reserve (DEVBLK *dev)
 int      rc;                            /* Return code               */
 
     /* Issue reserve request */
-    rc = clientRequest (dev, NULL, 0, SHRD_RESERVE, 0, NULL, NULL);
+    if (dev->rmtrel >= 3)
+    {
+        BYTE hdr[SHRD_HDR_SIZE];        /* RESERVE request header    */
+        SHRD_SET_HDR (hdr, SHRD_RESERVE, 0, dev->rmtnum, dev->rmtid, 0);
+        rc = clientPost (dev, hdr, NULL, 0, -1);
+    }
+    else
+        rc = clientRequest (dev, NULL, 0, SHRD_RESERVE, 0, NULL, NULL);
 
 } /* shared_reserve */
 
@@ -976,7 +1037,14 @@ static void shared_release (DEVBLK *dev)
 int      rc;                            /* Return code               */
 
     /* Issue release request */
-    rc = clientRequest (dev, NULL, 0, SHRD_RELEASE, 0, NULL, NULL);
+    if (dev->rmtrel >= 3)
+    {
+        BYTE hdr[SHRD_HDR_SIZE];        /* RELEASE request header    */
+        SHRD_SET_HDR (hdr, SHRD_RELEASE, 0, dev->rmtnum, dev->rmtid, 0);
+        rc = clientPost (dev, hdr, NULL, 0, -1);
+    }
+    else
+        rc = clientRequest (dev, NULL, 0, SHRD_RELEASE, 0, NULL, NULL);
 
 } /* shared_release */
 
@@ -986,6 +1054,9 @@ int      rc;                            /* Return code               */
  * NOTE - writes are deferred until a switch occurs or the
  *        channel program ends.  We are called from either the
  *        read exit or the end channel program exit.
+ *
+ *        A release 3 server doesn't make us wait for the response;
+ *        errors are reported by clientReap when it arrives.
  *-------------------------------------------------------------------*/
 static int clientWrite (DEVBLK *dev, int block)
 {
@@ -1017,7 +1088,10 @@ write_retry:
     store_hw (hdr + SHRD_HDR_SIZE, dev->bufupdlo);
     store_fw (hdr + SHRD_HDR_SIZE + 2, block);
 
-    rc = clientSend (dev, hdr, dev->buf + dev->bufupdlo, len);
+    if (dev->rmtrel >= 3)
+        rc = clientPost (dev, hdr, dev->buf + dev->bufupdlo, len, block);
+    else
+        rc = clientSend (dev, hdr, dev->buf + dev->bufupdlo, len);
     if (rc < 0)
     {
         // "%1d:%04X Shared: error writing track %d"
@@ -1027,6 +1101,13 @@ write_retry:
         return -1;
     }
 
+    /* Response is collected later */
+    if (dev->rmtrel >= 3)
+    {
+        dev->bufupdlo = dev->bufupdhi = 0;
+        return 0;
+    }
+
     /* Get the response */
     rc = clientRecv (dev, hdr, errmsg, sizeof(errmsg));
     SHRD_GET_HDR (hdr, code, status, devnum, id, len);
@@ -1087,99 +1168,230 @@ DEVBLK         *dev = data;             /* -> device block           */
 } /* clientPurge */
 
 /*-------------------------------------------------------------------
- * Connect to the server (client side)
+ * Process a purge list pushed by the server (client side)
  *-------------------------------------------------------------------*/
-static int clientConnect( DEVBLK* dev, int retry )
+static void clientNotify (DEVBLK *dev, BYTE *hdr, BYTE *buf, int len)
+{
+    UNREFERENCED(hdr);
+
+    SHRDTRACE("notify %d", len / 4);
+
+    /* A zero length list means purge everything */
+    clientPurge (dev, len / 4, len >= 4 ? buf : NULL);
+} /* clientNotify */
+
+/*-------------------------------------------------------------------
+ * Process the 'comp=' parameter (client side)
+ *
+ *   comp=n          compress using zlib parameter 'n' (0 .. 9)
+ *   comp=zstd[:n]   compress using zstd level 'n' (default 3)
+ *   comp=lz4        compress using lz4
+ *
+ * zstd and lz4 are only used with a release 3 server; a lower
+ * release server is asked for zlib instead.
+ *-------------------------------------------------------------------*/
+static int clientCompParm (DEVBLK *dev, char *op)
+{
+    if (op == NULL)
+        return -1;
+
+    if (strncasecmp (op, "zstd", 4) == 0)
+    {
+#if defined( HAVE_ZSTD )
+        dev->rmtcompalg = SHRD_ZSTD;
+        dev->rmtcomp = op[4] == ':' ? atoi (op + 5) : 3;
+        if (op[4] && op[4] != ':')
+            return -1;
+        if (dev->rmtcomp < 1 || dev->rmtcomp > 19)
+            dev->rmtcomp = 3;
+        return 0;
+#else
+        return -1;
+#endif
+    }
+
+    if (strcasecmp (op, "lz4") == 0)
+    {
+#if defined( HAVE_LZ4 )
+        dev->rmtcompalg = SHRD_LZ4;
+        dev->rmtcomp = 1;
+        return 0;
+#else
+        return -1;
+#endif
+    }
+
+#if defined( HAVE_ZLIB )
+    dev->rmtcompalg = SHRD_LIBZ;
+    dev->rmtcomp = atoi (op);
+    if (dev->rmtcomp < 0 || dev->rmtcomp > 9)
+        dev->rmtcomp = 0;
+    return 0;
+#else
+    return -1;
+#endif
+} /* clientCompParm */
+
+/*-------------------------------------------------------------------
+ * Open a new socket to the server (client side)
+ *
+ * Returns the socket, -1 if the connect failed or -2 if no
+ * socket could be obtained.
+ *-------------------------------------------------------------------*/
+static int clientSocket( DEVBLK* dev, int retry )
 {
 int                rc;                  /* Return code               */
+int                fd;                  /* Socket                    */
 struct sockaddr*   server;              /* -> Server descriptor      */
 int                len;                 /* Length server descriptor  */
 struct sockaddr_in iserver;             /* inet server descriptor    */
 #if defined( HAVE_SYS_UN_H )
 struct sockaddr_un userver;             /* Unix server descriptor    */
 #endif
-int                retries = 10;        /* Number of retries         */
-HWORD              id;                  /* Returned identifier       */
-HWORD              comp;                /* Returned compression parm */
-
-    SHRDTRACE( "Beg clientConnect sequence for dev %4.4x retry=%d", dev->devnum, retry );
 
-    do
+    /* Get a new socket */
+    if (dev->localhost)
     {
-        /* Close previous connection */
-        if (dev->fd >= 0)
-            close_socket( dev->fd );
-
-        /* Get a new socket */
-        if (dev->localhost)
-        {
 #if defined( HAVE_SYS_UN_H )
-            dev->fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+        fd = socket( AF_UNIX, SOCK_STREAM, 0 );
 #else
-            dev->fd = -1;
+        fd = -1;
 #endif
-            dev->ckdfd[0] = dev->fd;
-
-            if (dev->fd < 0)
-            {
-                // "%1d:%04X Shared: error in function %s: %s"
-                WRMSG( HHC00720, "E", LCSS_DEVNUM, "socket()", strerror( HSO_errno ));
-                return -1;
-            }
+        if (fd < 0)
+        {
+            // "%1d:%04X Shared: error in function %s: %s"
+            WRMSG( HHC00720, "E", LCSS_DEVNUM, "socket()", strerror( HSO_errno ));
+            return -2;
+        }
 #if defined( HAVE_SYS_UN_H )
-            userver.sun_family = AF_UNIX;
-            sprintf( userver.sun_path, "/tmp/hercules_shared.%d", dev->rmtport );
-            server = (struct sockaddr*) &userver;
-            len = sizeof( userver );
+        userver.sun_family = AF_UNIX;
+        sprintf( userver.sun_path, "/tmp/hercules_shared.%d", dev->rmtport );
+        server = (struct sockaddr*) &userver;
+        len = sizeof( userver );
 #endif
-        }
-        else
+    }
+    else
+    {
+        fd = socket( AF_INET, SOCK_STREAM, 0 );
+
+        if (fd < 0)
         {
-            dev->fd = socket( AF_INET, SOCK_STREAM, 0 );
-            dev->ckdfd[0] = dev->fd;
+            // "%1d:%04X Shared: error in function %s: %s"
+            WRMSG( HHC00720, "E", LCSS_DEVNUM, "socket()", strerror( HSO_errno ));
+            return -2;
+        }
 
-            if (dev->fd < 0)
-            {
-                // "%1d:%04X Shared: error in function %s: %s"
-                WRMSG( HHC00720, "E", LCSS_DEVNUM, "socket()", strerror( HSO_errno ));
-                return -1;
-            }
+        iserver.sin_family = AF_INET;
+        iserver.sin_port   = htons( dev->rmtport );
+        memcpy( &iserver.sin_addr.s_addr, &dev->rmtaddr, sizeof( struct in_addr ));
+        server = (struct sockaddr*) &iserver;
+        len = sizeof( iserver );
+    }
 
-            iserver.sin_family = AF_INET;
-            iserver.sin_port   = htons( dev->rmtport );
-            memcpy( &iserver.sin_addr.s_addr, &dev->rmtaddr, sizeof( struct in_addr ));
-            server = (struct sockaddr*) &iserver;
-            len = sizeof( iserver );
-        }
+    /* Connect to the server */
+    rc = connect( fd, server, len );
+
+    if (rc < 0)
+    {
+        SHRDTRACE( "connect rc=%d errno=%d %s", rc, HSO_errno, strerror( HSO_errno ));
+        if (!retry)
+            // "%1d:%04X Shared: error in connect to file %s: %s"
+            WRMSG( HHC00722, "E", LCSS_DEVNUM, dev->filename, strerror( HSO_errno ));
+        close_socket( fd );
+        return -1;
+    }
 
-        /* Connect to the server */
-        store_hw( id, dev->rmtid );
-        rc = connect( dev->fd, server, len );
+    SHRDTRACE( "connect rc=%d", rc );
 
-        if (rc < 0)
-            SHRDTRACE( "connect rc=%d errno=%d %s", rc, HSO_errno, strerror( HSO_errno ));
-        else
-            SHRDTRACE( "connect rc=%d", rc );
+    /* Requests are small; don't let them wait for each other */
+    if (!dev->localhost)
+        disable_nagle( fd );
+
+    return fd;
+
+} /* clientSocket */
+
+/*-------------------------------------------------------------------
+ * Connect to the server (client side)
+ *-------------------------------------------------------------------*/
+static int clientConnect( DEVBLK* dev, int retry )
+{
+int                rc;                  /* Return code               */
+int                fd;                  /* New socket                */
+int                retries = 10;        /* Number of retries         */
+int                flag;                /* CONNECT flags             */
+int                code;                /* Response code             */
+int                first;               /* 1=First CONNECT           */
+HWORD              id;                  /* Returned identifier       */
+BYTE               comp[3];             /* Returned compression parms*/
+BYTE               parm[2];             /* Preferred compression     */
+int                i;                   /* Index                     */
+
+    SHRDTRACE( "Beg clientConnect sequence for dev %4.4x retry=%d", dev->devnum, retry );
+
+    /* The responses to pipelined requests are lost with the old
+       connection; we can't tell if they completed */
+    for (i = 0; i < dev->rmtposted; i++)
+        clientPostError( dev, i, SHRD_ERROR, 0 );
+    dev->rmtposted = 0;
+
+    do
+    {
+        /* Close previous connection */
+        clientClose( dev );
+
+        /* Use an existing release 3 connection to the server
+           or else open a new one */
+        if (!clientMuxAttach( dev ))
+        {
+            if ((fd = clientSocket( dev, retry )) < -1)
+                return -1;
+            dev->fd = fd;
+        }
+        dev->ckdfd[0] = dev->fd;
+        rc = dev->fd;
 
         if (rc >= 0)
         {
-            /* Request device connection (if we haven't done so yet) */
-            if (!dev->connected)
+            /* Request device connection (if we haven't done so yet).
+               A release 3 server is always told who we are since the
+               connection may be new */
+            if (!dev->connected || dev->rmtrel >= 3 || dev->rmtmux)
             {
-                int flag = (SHARED_VERSION << 4) | SHARED_RELEASE;
-                rc = clientRequest( dev, id, 2, SHRD_CONNECT, flag, NULL, &flag );
+                store_hw( id, dev->rmtid );
+                flag = (SHARED_VERSION << 4) | SHARED_RELEASE;
+                rc = clientRequest( dev, id, 2, SHRD_CONNECT, flag, &code, &flag );
+                if (rc >= 0 && (code & SHRD_ERROR))
+                    rc = -1;
+
+                /* Let the next device connect over the connection */
+                if (dev->rmtmux)
+                {
+                    obtain_lock( &dev->rmtmux->lock );
+                    dev->rmtmux->connecting = NULL;
+                    broadcast_condition( &dev->rmtmux->cond );
+                    release_lock( &dev->rmtmux->lock );
+                }
+
                 if (rc >= 0)
                 {
+                    first = !dev->connected;
                     dev->connected = 1;             // (SHRD_CONNECT success)
-                    dev->rmtid  = fetch_hw( id );   // (must only do ONCE!!!)
+                    dev->rmtid  = fetch_hw( id );   // (same id on reconnect)
                     dev->rmtver = flag >> 4;        // (save server version)
                     dev->rmtrel = flag & 0x0f;      // (save server release)
 
-                    if (!dev->batch)
+                    if (first && !dev->batch)
                         if (MLVL( VERBOSE ))
                             // "%1d:%04X Shared: connected to v%d.%d server id %d file %s"
                             WRMSG( HHC00721, "I", LCSS_DEVNUM, dev->rmtver,
                                 dev->rmtrel, dev->rmtid, dev->filename );
+
+                    /* Let our other devices share a release 3 connection */
+                    if (!dev->rmtmux && !dev->batch
+                     && dev->rmtver == SHARED_VERSION && dev->rmtrel >= 3)
+                        clientMuxCreate( dev );
+
                     /*
                      * Negotiate compression - top 4 bits have the compression
                      * algorithms we support (00010000 -> libz; 00100000 ->bzip2,
@@ -1190,20 +1402,49 @@ HWORD              comp;                /* Returned compression parm */
                      * algorithms we support' means is that if the data source is
                      * cckd or cfba then the server doesn't have to uncompress
                      * the data for us if we support the compression algorithm.
+                     *
+                     * A release 3 server is also sent the method we prefer
+                     * and answers with the method it will use.
                      */
-                    if (dev->rmtcomp || dev->rmtcomps)
+                    if ((dev->rmtcomp || dev->rmtcomps)
+                     && (first || dev->rmtrel >= 3))
                     {
-                        rc = clientRequest( dev, comp, 2, SHRD_COMPRESS,
-                                   (dev->rmtcomps << 4) | dev->rmtcomp, NULL, NULL );
-                        if (rc >= 0)
+                        int cflag = dev->rmtcomp;
+                        int n = 0;
+
+                        if (dev->rmtcomp && dev->rmtcompalg != SHRD_LIBZ)
+                        {
+                            if (dev->rmtrel >= 3)
+                            {
+                                parm[0] = dev->rmtcompalg;
+                                parm[1] = dev->rmtcomp;
+                                n = sizeof( parm );
+                                cflag = 0;
+                            }
+                            else
+                            {
+#if defined( HAVE_ZLIB )
+                                dev->rmtcompalg = SHRD_LIBZ;
+                                cflag = 1;
+#else
+                                cflag = 0;
+#endif
+                            }
+                        }
+
+                        memset( comp, 0, sizeof( comp ));
+                        i = clientRequestData( dev, n ? parm : NULL, n,
+                                comp, sizeof( comp ), SHRD_COMPRESS,
+                                (dev->rmtcomps << 4) | cflag, NULL, NULL );
+                        if (i >= 0)
+                        {
                             dev->rmtcomp = fetch_hw( comp );
+                            dev->rmtcompalg = i >= 3 && comp[2] ? comp[2] : SHRD_LIBZ;
+                        }
                     }
                 }
             }
         }
-        else if (!retry)
-            // "%1d:%04X Shared: error in connect to file %s: %s"
-            WRMSG( HHC00722, "E", LCSS_DEVNUM, dev->filename, strerror( HSO_errno ));
 
         if (rc < 0 && retry)
             usleep( 20000 );    // (20ms between connect retries?!)
@@ -1216,6 +1457,288 @@ HWORD              comp;                /* Returned compression parm */
 
 } /* clientConnect */
 
+/*-------------------------------------------------------------------
+ * Close the connection to the server (client side)
+ *-------------------------------------------------------------------*/
+static void clientClose (DEVBLK *dev)
+{
+    if (dev->rmtmux)
+        clientMuxDetach (dev);
+    else if (dev->fd >= 0)
+        close_socket (dev->fd);
+    dev->fd = -1;
+} /* clientClose */
+
+/*-------------------------------------------------------------------
+ * Attach to an existing connection to the server (client side)
+ *
+ * Returns true if the device now uses the connection, in which case
+ * it must send its CONNECT request before any other device can.
+ *-------------------------------------------------------------------*/
+static bool clientMuxAttach (DEVBLK *dev)
+{
+SHRD_MUX *mux;                          /* -> Shared connection      */
+
+    if (dev->batch)
+        return false;
+
+    obtain_lock (&sysblk.shrdmuxlock);
+    for (mux = sysblk.shrdmux; mux; mux = mux->next)
+        if (!mux->dead
+         && mux->rmtport == dev->rmtport
+         && mux->localhost == (dev->localhost != 0)
+         && (dev->localhost
+          || memcmp (&mux->rmtaddr, &dev->rmtaddr, sizeof(struct in_addr)) == 0))
+            break;
+    if (mux == NULL)
+    {
+        release_lock (&sysblk.shrdmuxlock);
+        return false;
+    }
+    mux->refs++;
+    release_lock (&sysblk.shrdmuxlock);
+
+    obtain_lock (&mux->lock);
+
+    /* Only one device at a time may wait for a CONNECT response
+       since the server doesn't know the id of a new device yet */
+    while (mux->connecting && !mux->dead)
+        wait_condition (&mux->cond, &mux->lock);
+
+    if (mux->dead)
+    {
+        release_lock (&mux->lock);
+        clientMuxRelease (mux);
+        return false;
+    }
+
+    mux->connecting = dev;
+    dev->rmtmuxnext = mux->devs;
+    mux->devs = dev;
+    dev->rmtmux = mux;
+    dev->fd = mux->fd;
+
+    release_lock (&mux->lock);
+
+    SHRDTRACE("mux attach sock %d", dev->fd);
+
+    return true;
+} /* clientMuxAttach */
+
+/*-------------------------------------------------------------------
+ * Make the device's connection available to other devices
+ *-------------------------------------------------------------------*/
+static void clientMuxCreate (DEVBLK *dev)
+{
+SHRD_MUX *mux;                          /* -> Shared connection      */
+TID       tid;                          /* Receiver thread id        */
+
+    if (!(mux = calloc (1, sizeof(SHRD_MUX))))
+        return;
+
+    initialize_lock (&mux->lock);
+    initialize_lock (&mux->sendlock);
+    initialize_condition (&mux->cond);
+    mux->fd = dev->fd;
+    mux->rmtaddr = dev->rmtaddr;
+    mux->rmtport = dev->rmtport;
+    mux->localhost = dev->localhost != 0;
+    mux->refs = 2;
+    mux->devs = dev;
+    dev->rmtmuxnext = NULL;
+    dev->rmtmux = mux;
+
+    if (create_thread (&tid, DETACHED, clientMuxThread, mux, "shrd client"))
+    {
+        // "Error in function create_thread(): %s"
+        WRMSG( HHC00102, "E", strerror( errno ));
+        dev->rmtmux = NULL;
+        destroy_condition (&mux->cond);
+        destroy_lock (&mux->sendlock);
+        destroy_lock (&mux->lock);
+        free (mux);
+        return;
+    }
+
+    obtain_lock (&sysblk.shrdmuxlock);
+    mux->next = sysblk.shrdmux;
+    sysblk.shrdmux = mux;
+    release_lock (&sysblk.shrdmuxlock);
+
+    SHRDTRACE("mux create sock %d", dev->fd);
+} /* clientMuxCreate */
+
+/*-------------------------------------------------------------------
+ * Detach the device from its shared connection
+ *-------------------------------------------------------------------*/
+static void clientMuxDetach (DEVBLK *dev)
+{
+SHRD_MUX *mux = dev->rmtmux;            /* -> Shared connection      */
+DEVBLK  **pdev;                         /* -> Device list link       */
+SHRD_MSG *msg;                          /* -> Queued response        */
+
+    obtain_lock (&mux->lock);
+
+    for (pdev = &mux->devs; *pdev; pdev = &(*pdev)->rmtmuxnext)
+        if (*pdev == dev)
+        {
+            *pdev = dev->rmtmuxnext;
+            break;
+        }
+
+    if (mux->connecting == dev)
+    {
+        mux->connecting = NULL;
+        broadcast_condition (&mux->cond);
+    }
+
+    /* Discard responses nobody will ask for */
+    while ((msg = dev->rmtq))
+    {
+        dev->rmtq = msg->next;
+        free (msg);
+    }
+    dev->rmtqlast = NULL;
+
+    /* Close the connection with the last device */
+    if (mux->devs == NULL)
+        clientMuxShutdown (mux);
+
+    release_lock (&mux->lock);
+
+    dev->rmtmux = NULL;
+    dev->rmtmuxnext = NULL;
+    dev->fd = -1;
+
+    clientMuxRelease (mux);
+} /* clientMuxDetach */
+
+/*-------------------------------------------------------------------
+ * Release a reference to a shared connection
+ *-------------------------------------------------------------------*/
+static void clientMuxRelease (SHRD_MUX *mux)
+{
+SHRD_MUX **pmux;                        /* -> Connection list link   */
+
+    obtain_lock (&sysblk.shrdmuxlock);
+    if (--mux->refs > 0)
+    {
+        release_lock (&sysblk.shrdmuxlock);
+        return;
+    }
+    for (pmux = &sysblk.shrdmux; *pmux; pmux = &(*pmux)->next)
+        if (*pmux == mux)
+        {
+            *pmux = mux->next;
+            break;
+        }
+    release_lock (&sysblk.shrdmuxlock);
+
+    close_socket (mux->fd);
+    destroy_condition (&mux->cond);
+    destroy_lock (&mux->sendlock);
+    destroy_lock (&mux->lock);
+    free (mux);
+} /* clientMuxRelease */
+
+/*-------------------------------------------------------------------
+ * Mark a shared connection as lost; mux->lock *must* be held
+ *-------------------------------------------------------------------*/
+static void clientMuxShutdown (SHRD_MUX *mux)
+{
+    if (mux->dead)
+        return;
+    mux->dead = true;
+    shutdown (mux->fd, SHUT_RDWR);
+} /* clientMuxShutdown */
+
+/*-------------------------------------------------------------------
+ * Shared connection receiver thread (client side)
+ *
+ * Routes each response to the device it is for.  Pushed purge
+ * lists are processed right here.
+ *-------------------------------------------------------------------*/
+static void *clientMuxThread (void *arg)
+{
+SHRD_MUX *mux = arg;                    /* -> Shared connection      */
+DEVBLK   *dev = NULL;                   /* -> Device                 */
+SHRD_MSG *msg;                          /* -> Queued response        */
+int       rc;                           /* Return code               */
+BYTE      code;                         /* Response code             */
+BYTE      status;                       /* Response status           */
+U16       devnum;                       /* Response device number    */
+int       id;                           /* Response identifier       */
+int       len;                          /* Response length           */
+BYTE      hdr[SHRD_HDR_SIZE];           /* Response header           */
+BYTE      buf[65536];                   /* Response data             */
+
+    for (;;)
+    {
+        if ((rc = recvData (mux->fd, hdr, buf, sizeof(buf), 0)) < 0)
+        {
+            if (rc != -HSO_ENOTCONN && !mux->dead)
+                // "Shared: error in receive from %s: %s"
+                WRMSG( HHC00746, "E", "server", strerror( -rc ));
+            break;
+        }
+        SHRD_GET_HDR (hdr, code, status, devnum, id, len);
+        len = rc;
+
+        /* Locate the device; a response without a known id must be
+           for the device that is connecting */
+        obtain_lock (&mux->lock);
+        for (dev = mux->devs; dev; dev = dev->rmtmuxnext)
+            if (dev->rmtnum == devnum && dev->rmtid == id)
+                break;
+        if (dev == NULL && code != SHRD_NOTIFY)
+            dev = mux->connecting;
+        if (dev == NULL)
+        {
+            release_lock (&mux->lock);
+            SHRDHDRTRACE( "mux discard", hdr );
+            continue;
+        }
+
+        if (code == SHRD_NOTIFY)
+        {
+            release_lock (&mux->lock);
+            clientNotify (dev, hdr, buf, len);
+            continue;
+        }
+
+        if ((msg = malloc (sizeof(SHRD_MSG) + len)))
+        {
+            msg->next = NULL;
+            msg->len = len;
+            memcpy (msg->hdr, hdr, SHRD_HDR_SIZE);
+            memcpy (msg->buf, buf, len);
+            if (dev->rmtqlast)
+                dev->rmtqlast->next = msg;
+            else
+                dev->rmtq = msg;
+            dev->rmtqlast = msg;
+            signal_condition (&dev->rmtcond);
+        }
+        release_lock (&mux->lock);
+
+        /* A lost response can't be recovered; start over */
+        if (msg == NULL)
+            break;
+    }
+
+    /* Wake up everyone waiting for a response */
+    obtain_lock (&mux->lock);
+    clientMuxShutdown (mux);
+    for (dev = mux->devs; dev; dev = dev->rmtmuxnext)
+        broadcast_condition (&dev->rmtcond);
+    broadcast_condition (&mux->cond);
+    release_lock (&mux->lock);
+
+    clientMuxRelease (mux);
+
+    return NULL;
+} /* clientMuxThread */
+
 /*-------------------------------------------------------------------
  * Send request to host and get the response
  *
@@ -1229,6 +1752,20 @@ HWORD              comp;                /* Returned compression parm */
  *-------------------------------------------------------------------*/
 static int clientRequest (DEVBLK *dev, BYTE *buf, int len, int cmd,
                           int flags, int *code, int *status)
+{
+    return clientRequestData (dev, NULL, 0, buf, len, cmd, flags,
+                              code, status);
+} /* clientRequest */
+
+/*-------------------------------------------------------------------
+ * Send request with data to host and get the response
+ *
+ * Same as clientRequest but 'slen' bytes at 'sbuf' are sent
+ * with the request.
+ *-------------------------------------------------------------------*/
+static int clientRequestData (DEVBLK *dev, BYTE *sbuf, int slen,
+                              BYTE *buf, int len, int cmd, int flags,
+                              int *code, int *status)
 {
 int      rc;                            /* Return code               */
 int      retries = 10;                  /* Number retries            */
@@ -1243,9 +1780,9 @@ BYTE     temp[256];                     /* Temporary buffer          */
 retry:
 
     /* Send the request */
-    SHRD_SET_HDR(hdr, cmd, flags, dev->rmtnum, dev->rmtid, 0);
+    SHRD_SET_HDR(hdr, cmd, flags, dev->rmtnum, dev->rmtid, slen);
     SHRDHDRTRACE( "client request", hdr );
-    rc = clientSend (dev, hdr, NULL, 0);
+    rc = clientSend (dev, hdr, sbuf, slen);
     if (rc < 0) return rc;
 
     /* Receive the response */
@@ -1279,7 +1816,99 @@ retry:
         memcpy (buf, temp, len < rlen ? len : rlen);
 
     return rlen;
-} /* clientRequest */
+} /* clientRequestData */
+
+/*-------------------------------------------------------------------
+ * Send a request without waiting for the response (client side)
+ *
+ * Only used with a release 3 server, which processes our requests
+ * in order.  The response is collected by clientReap before the
+ * next response we wait for.  'rcd' is the record being written.
+ *-------------------------------------------------------------------*/
+static int clientPost (DEVBLK *dev, BYTE *hdr, BYTE *buf, int buflen,
+                       int rcd)
+{
+int      rc;                            /* Return code               */
+BYTE     cmd;                           /* Header command            */
+BYTE     flag;                          /* Header flags              */
+U16      devnum;                        /* Header device number      */
+int      id;                            /* Header identifier         */
+int      len;                           /* Header length             */
+
+    /* Make room for the response */
+    if (dev->rmtposted >= SHARED_MAX_POSTED)
+        clientReap (dev);
+
+    SHRD_GET_HDR (hdr, cmd, flag, devnum, id, len);
+
+    if ((rc = clientSend (dev, hdr, buf, buflen)) < 0)
+        return rc;
+
+    dev->rmtpostcmd[dev->rmtposted] = cmd;
+    dev->rmtpostrcd[dev->rmtposted] = rcd;
+    dev->rmtposted++;
+
+    return 0;
+} /* clientPost */
+
+/*-------------------------------------------------------------------
+ * Collect the responses to posted requests (client side)
+ *-------------------------------------------------------------------*/
+static void clientReap (DEVBLK *dev)
+{
+int      rc;                            /* Return code               */
+int      i, n;                          /* Indexes                   */
+BYTE     code;                          /* Response code             */
+BYTE     status;                        /* Response status           */
+U16      devnum;                        /* Response device number    */
+int      id;                            /* Response identifier       */
+int      len;                           /* Response length           */
+BYTE     hdr[SHRD_HDR_SIZE];            /* Response header           */
+BYTE     errmsg[SHARED_MAX_MSGLEN+1];   /* Error message             */
+
+    n = dev->rmtposted;
+    dev->rmtposted = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        if ((rc = clientNext (dev, hdr, errmsg, sizeof(errmsg))) < 0)
+        {
+            for (; i < n; i++)
+                clientPostError (dev, i, SHRD_ERROR, 0);
+            break;
+        }
+        SHRD_GET_HDR (hdr, code, status, devnum, id, len);
+        if (code & (SHRD_ERROR | SHRD_IOERR))
+            clientPostError (dev, i, code, status);
+    }
+} /* clientReap */
+
+/*-------------------------------------------------------------------
+ * Report a failed posted request (client side)
+ *
+ * The cache can't be trusted after a failed WRITE or END; it is
+ * purged before the next track is looked up.
+ *-------------------------------------------------------------------*/
+static void clientPostError (DEVBLK *dev, int ix, int code, int status)
+{
+    switch (dev->rmtpostcmd[ix]) {
+    case SHRD_WRITE:
+        // "%1d:%04X Shared: remote error writing track %d %2.2X-%2.2X"
+        WRMSG( HHC00719, "E", LCSS_DEVNUM, dev->rmtpostrcd[ix], code, status );
+        dev->rmtpurgeall = 1;
+        break;
+    case SHRD_END:
+        // "%1d:%04X Shared: error during channel program end"
+        WRMSG( HHC00714, "E", LCSS_DEVNUM );
+        dev->rmtpurgeall = 1;
+        break;
+    default:
+        // "%1d:%04X Shared: remote error on %s request %2.2X-%2.2X"
+        WRMSG( HHC00745, "E", LCSS_DEVNUM,
+               shrdcmd2str( dev->rmtpostcmd[ix] ), code, status );
+        break;
+    }
+} /* clientPostError */
 
 /*-------------------------------------------------------------------
  * Send a request to the host
@@ -1332,7 +1961,7 @@ const char* trcmsg;                     /* Header trace message      */
     hdrlen = SHRD_HDR_SIZE + (len - buflen);
     off = len - buflen;
 
-#if defined( HAVE_ZLIB )
+#if defined( SHARED_COMPRESS )
     /* Compress the buf */
     if (1
         && dev->rmtcomp != 0
@@ -1341,17 +1970,16 @@ const char* trcmsg;                     /* Header trace message      */
         && buflen >= SHARED_COMPRESS_MINLEN
     )
     {
-        unsigned long newlen;
-        newlen = 65536 - hdrlen;
         memcpy( cbuf, hdr, hdrlen );
-        rc = compress2( cbuf + hdrlen, &newlen,
-                        buf, buflen, dev->rmtcomp );
-        if (rc == Z_OK && (int)newlen < buflen)
+        rc = shrdCompress( dev->rmtcompalg, dev->rmtcomp, cbuf + hdrlen,
+                           SHARED_MAX_DATA - off, buf, buflen );
+        if (rc > 0 && rc < buflen)
         {
             cmd |= SHRD_COMP;
-            flag = (SHRD_LIBZ << 4) | off;
+            flag = ((dev->rmtcompalg == SHRD_LIBZ ? SHRD_LIBZ
+                                                  : SHRD_COMP_ALT) << 4) | off;
             hdr = cbuf;
-            hdrlen += newlen;
+            hdrlen += rc;
             buf = NULL;
             buflen = 0;
         }
@@ -1386,11 +2014,30 @@ retry:
     else
         SHRDHDRTRACE(  trcmsg, sendbuf );
 
-    /* Send the header and data */
-    if ((rc = send( dev->fd, sendbuf, sendlen, 0 )) < 0)
+    /* Send the header and data; devices sharing a connection
+       must not interleave their requests */
+    if (dev->rmtmux)
+    {
+        obtain_lock( &dev->rmtmux->sendlock );
+        rc = dev->rmtmux->dead ? -HSO_ENOTCONN
+                               : sendData( dev->fd, sendbuf, sendlen );
+        release_lock( &dev->rmtmux->sendlock );
+    }
+    else
+        rc = sendData( dev->fd, sendbuf, sendlen );
+
+    if (rc < 0)
     {
         /* Trace the socket error */
-        SHRDTRACE( "send rc=%d errno=%d %s", rc, HSO_errno, strerror( HSO_errno ));
+        SHRDTRACE( "send rc=%d errno=%d %s", rc, -rc, strerror( -rc ));
+
+        /* Nobody can use a connection that failed */
+        if (dev->rmtmux)
+        {
+            obtain_lock( &dev->rmtmux->lock );
+            clientMuxShutdown( dev->rmtmux );
+            release_lock( &dev->rmtmux->lock );
+        }
 
         /* If the request we're trying to send to the server
            is a disconnect request, it doesn't make much sense
@@ -1399,13 +2046,15 @@ retry:
         */
         if (SHRD_DISCONNECT != cmd)
         {
-            if ((rc = clientConnect( dev, 0 )) >= 0)
+            int err = rc;
+            if (clientConnect( dev, 0 ) >= 0)
             {
                 /* Pickup new rmtid due to clientConnect */
                 id = dev->rmtid;
                 trcmsg = "client send retry";
                 goto retry;
             }
+            rc = err;
         }
     }
 
@@ -1413,7 +2062,7 @@ retry:
     if (rc < 0 && SHRD_DISCONNECT != cmd)
     {
         // "%1d:%04X Shared: error in send for %2.2X-%2.2X: %s"
-        WRMSG( HHC00723, "E", LCSS_DEVNUM, cmd, flag, strerror( HSO_errno ));
+        WRMSG( HHC00723, "E", LCSS_DEVNUM, cmd, flag, strerror( -rc ));
         return -1;
     }
 
@@ -1423,8 +2072,21 @@ retry:
 
 /*-------------------------------------------------------------------
  * Receive a response (client side)
+ *
+ * The responses to any posted requests are collected first.
  *-------------------------------------------------------------------*/
 static int clientRecv (DEVBLK *dev, BYTE *hdr, BYTE *buf, int buflen)
+{
+    if (dev->rmtposted)
+        clientReap (dev);
+
+    return clientNext (dev, hdr, buf, buflen);
+} /* clientRecv */
+
+/*-------------------------------------------------------------------
+ * Receive the next response for the device (client side)
+ *-------------------------------------------------------------------*/
+static int clientNext (DEVBLK *dev, BYTE *hdr, BYTE *buf, int buflen)
 {
 int      rc;                            /* Return code               */
 BYTE     code;                          /* Response code             */
@@ -1432,6 +2094,9 @@ BYTE     status;                        /* Response status           */
 U16      devnum;                        /* Response device number    */
 int      id;                            /* Response identifier       */
 int      len;                           /* Response length           */
+SHRD_MUX *mux;                          /* -> Shared connection      */
+SHRD_MSG *msg;                          /* -> Queued response        */
+BYTE     temp[65536];                   /* Receive buffer            */
 
     /* Clear the header to zeroes */
     memset( hdr, 0, SHRD_HDR_SIZE );
@@ -1444,17 +2109,56 @@ int      len;                           /* Response length           */
         return -1;
     }
 
-    /* Receive the header */
-    rc = recvData (dev->fd, hdr, buf, buflen, 0);
-    if (rc < 0)
+    if ((mux = dev->rmtmux))
     {
-        if (rc != -ENOTCONN)
-            // "%1d:%04X Shared: error in receive: %s"
-            WRMSG( HHC00725, "E", LCSS_DEVNUM, strerror( -rc ));
-        return rc;
+        /* Wait for the receiver thread to queue our response */
+        obtain_lock( &mux->lock );
+        while (dev->rmtq == NULL && !mux->dead)
+            wait_condition( &dev->rmtcond, &mux->lock );
+        if ((msg = dev->rmtq))
+        {
+            dev->rmtq = msg->next;
+            if (dev->rmtq == NULL)
+                dev->rmtqlast = NULL;
+        }
+        release_lock( &mux->lock );
+
+        if (msg == NULL)
+            return -HSO_ENOTCONN;
+
+        memcpy( hdr, msg->hdr, SHRD_HDR_SIZE );
+        rc = msg->len < buflen ? msg->len : buflen;
+        if (rc > 0)
+            memcpy( buf, msg->buf, rc );
+        free( msg );
+    }
+    else
+    {
+        /* Receive the response, processing any purge lists
+           a release 3 server pushes at us */
+        do
+        {
+            rc = recvData (dev->fd, hdr, temp, sizeof(temp), 0);
+            if (rc < 0)
+            {
+                if (rc != -HSO_ENOTCONN)
+                    // "%1d:%04X Shared: error in receive: %s"
+                    WRMSG( HHC00725, "E", LCSS_DEVNUM, strerror( -rc ));
+                return rc;
+            }
+            if (hdr[0] == SHRD_NOTIFY)
+                clientNotify (dev, hdr, temp, rc);
+        }
+        while (hdr[0] == SHRD_NOTIFY);
+
+        if (rc > buflen)
+            rc = buflen;
+        if (rc > 0)
+            memcpy( buf, temp, rc );
     }
 
     SHRD_GET_HDR(hdr, code, status, devnum, id, len);
+    len = rc;
     SHRDHDRTRACE( "client recv", hdr );
 
     /* Handle remote logical error */
@@ -1476,7 +2180,34 @@ int      len;                           /* Response length           */
     SHRD_SET_HDR(hdr, code, status, devnum, id, len);
 
     return len;
-} /* clientRecv */
+} /* clientNext */
+
+/*-------------------------------------------------------------------
+ * Send data (server or client)
+ *
+ * Returns 'len' or the negative socket error.
+ *-------------------------------------------------------------------*/
+static int sendData (int sock, BYTE *buf, int len)
+{
+int      rc;                            /* Return code               */
+int      sent;                          /* Length sent so far        */
+
+    for (sent = 0; sent < len; sent += rc)
+    {
+        rc = send (sock, buf + sent, len - sent, 0);
+        if (rc < 0)
+        {
+            if (HSO_errno == HSO_EINTR)
+            {
+                rc = 0;
+                continue;
+            }
+            return -HSO_errno;
+        }
+    }
+
+    return len;
+} /* sendData */
 
 /*-------------------------------------------------------------------
  * Receive data (server or client)
@@ -1534,7 +2265,7 @@ BYTE                    cbuf[65536];    /* Compressed buffer         */
     /* Receive the data */
     for (recvlen = 0; recvlen < rlen; recvlen += rc)
     {
-        rc = recv (sock, recvbuf + recvlen, len - recvlen, 0);
+        rc = recv (sock, recvbuf + recvlen, rlen - recvlen, 0);
         if (rc < 0)
             return -HSO_errno;
         else if (rc == 0)
@@ -1553,51 +2284,39 @@ BYTE                    cbuf[65536];    /* Compressed buffer         */
     }
 
     /* Check for compression */
-    if (comp == SHRD_LIBZ) {
-#if defined( HAVE_ZLIB )
-        unsigned long newlen;
+    if (comp)
+    {
+        BYTE *cdata = cbuf + off;       /* Compressed data           */
+        int   clen  = len - off;        /* Compressed data length    */
 
-        if (off > 0)
-            memcpy (buf, cbuf, off);
-        newlen = buflen - off;
-        rc = uncompress(buf + off, &newlen, cbuf + off, len - off);
-        if (rc == Z_OK)
-            recvlen = (int)newlen + off;
-        else
+        /* zstd and lz4 data starts with a byte naming the method */
+        if (comp == SHRD_COMP_ALT)
         {
-            // "Shared: decompress error %d offset %d length %d"
-            WRMSG( HHC00727, "E", rc, off, len - off );
-            recvlen = -1;
+            comp = clen > 0 ? *cdata : 0;
+            cdata++;
+            clen--;
         }
-#else
-        // "Shared: data compressed using method %s is unsupported"
-        WRMSG( HHC00728, "E", "libz" );
-        recvlen = -1;
-#endif
-    }
-    else if (comp == SHRD_BZIP2)
-    {
-#if defined( CCKD_BZIP2 )
-        unsigned int newlen;
 
-        if (off > 0)
-            memcpy (buf, cbuf, off);
-
-        newlen = buflen - off;
-        rc = BZ2_bzBuffToBuffDecompress((void *)(buf + off), &newlen, (void *)(cbuf + off), len - off, 0, 0);
-        if (rc == BZ_OK)
-            recvlen = (int)newlen + off;
-        else
+        if (!shrdCompSupported (comp))
         {
-            // "Shared: decompress error %d offset %d length %d"
-            WRMSG( HHC00727, "E", rc, off, len - off );
+            // "Shared: data compressed using method %s is unsupported"
+            WRMSG( HHC00728, "E", shrdcomp2str( comp ));
             recvlen = -1;
         }
-#else
-        // "Shared: data compressed using method %s is unsupported"
-        WRMSG( HHC00728, "E", "bzip2" );
-        recvlen = -1;
-#endif
+        else
+        {
+            if (off > 0)
+                memcpy (buf, cbuf, off);
+            rc = shrdDecompress (comp, buf + off, buflen - off, cdata, clen);
+            if (rc >= 0)
+                recvlen = rc + off;
+            else
+            {
+                // "Shared: decompress error %d offset %d length %d"
+                WRMSG( HHC00727, "E", rc, off, len - off );
+                recvlen = -1;
+            }
+        }
     }
 
     if (recvlen > 0)
@@ -1611,6 +2330,162 @@ BYTE                    cbuf[65536];    /* Compressed buffer         */
 
 } /* recvData */
 
+/*-------------------------------------------------------------------
+ * Compress data (server or client)
+ *
+ * Returns the compressed length or -1 if the data couldn't be
+ * compressed into 'dstlen' bytes.  zstd and lz4 data is preceded
+ * by a byte naming the method (see SHRD_COMP_ALT).
+ *-------------------------------------------------------------------*/
+static int shrdCompress (int alg, int parm, BYTE *dst, int dstlen,
+                         BYTE *src, int srclen)
+{
+    UNREFERENCED(parm);
+    UNREFERENCED(dst);
+    UNREFERENCED(dstlen);
+    UNREFERENCED(src);
+    UNREFERENCED(srclen);
+
+    switch (alg) {
+#if defined( HAVE_ZLIB )
+    case SHRD_LIBZ:
+    {
+        unsigned long newlen = dstlen;
+        if (compress2 (dst, &newlen, src, srclen, parm) != Z_OK)
+            return -1;
+        return (int)newlen;
+    }
+#endif
+#if defined( HAVE_ZSTD )
+    case SHRD_ZSTD:
+    {
+        size_t newlen;
+        if (dstlen < 2)
+            return -1;
+        dst[0] = SHRD_ZSTD;
+        newlen = ZSTD_compress (dst + 1, dstlen - 1, src, srclen, parm);
+        if (ZSTD_isError (newlen))
+            return -1;
+        return (int)newlen + 1;
+    }
+#endif
+#if defined( HAVE_LZ4 )
+    case SHRD_LZ4:
+    {
+        int newlen;
+        if (dstlen < 2)
+            return -1;
+        dst[0] = SHRD_LZ4;
+        newlen = LZ4_compress_default ((const char *)src, (char *)dst + 1,
+                                       srclen, dstlen - 1);
+        if (newlen <= 0)
+            return -1;
+        return newlen + 1;
+    }
+#endif
+    default:
+        return -1;
+    }
+} /* shrdCompress */
+
+/*-------------------------------------------------------------------
+ * Decompress data (server or client)
+ *
+ * Returns the decompressed length or a negative error code.
+ *-------------------------------------------------------------------*/
+static int shrdDecompress (int alg, BYTE *dst, int dstlen,
+                           BYTE *src, int srclen)
+{
+int      rc = -1;                       /* Return code               */
+
+    UNREFERENCED(dst);
+    UNREFERENCED(dstlen);
+    UNREFERENCED(src);
+    UNREFERENCED(srclen);
+
+    switch (alg) {
+#if defined( HAVE_ZLIB )
+    case SHRD_LIBZ:
+    {
+        unsigned long newlen = dstlen;
+        rc = uncompress (dst, &newlen, src, srclen);
+        if (rc == Z_OK)
+            return (int)newlen;
+        break;
+    }
+#endif
+#if defined( CCKD_BZIP2 )
+    case SHRD_BZIP2:
+    {
+        unsigned int newlen = dstlen;
+        rc = BZ2_bzBuffToBuffDecompress ((void *)dst, &newlen,
+                                         (void *)src, srclen, 0, 0);
+        if (rc == BZ_OK)
+            return (int)newlen;
+        break;
+    }
+#endif
+#if defined( HAVE_ZSTD )
+    case SHRD_ZSTD:
+    {
+        size_t newlen = ZSTD_decompress (dst, dstlen, src, srclen);
+        if (!ZSTD_isError (newlen))
+            return (int)newlen;
+        rc = -1;
+        break;
+    }
+#endif
+#if defined( HAVE_LZ4 )
+    case SHRD_LZ4:
+        rc = LZ4_decompress_safe ((const char *)src, (char *)dst,
+                                  srclen, dstlen);
+        if (rc >= 0)
+            return rc;
+        break;
+#endif
+    default:
+        break;
+    }
+
+    return rc < 0 ? rc : -1;
+} /* shrdDecompress */
+
+/*-------------------------------------------------------------------
+ * Determine if a compression method is supported
+ *-------------------------------------------------------------------*/
+static bool shrdCompSupported (int alg)
+{
+    switch (alg) {
+#if defined( HAVE_ZLIB )
+    case SHRD_LIBZ:     return true;
+#endif
+#if defined( CCKD_BZIP2 )
+    case SHRD_BZIP2:    return true;
+#endif
+#if defined( HAVE_ZSTD )
+    case SHRD_ZSTD:     return true;
+#endif
+#if defined( HAVE_LZ4 )
+    case SHRD_LZ4:      return true;
+#endif
+    default:            return false;
+    }
+} /* shrdCompSupported */
+
+/*-------------------------------------------------------------------
+ * Convert compression method to string for messages
+ *-------------------------------------------------------------------*/
+static const char* shrdcomp2str (int alg)
+{
+    switch (alg) {
+    case SHRD_LIBZ:     return "libz";
+    case SHRD_BZIP2:    return "bzip2";
+    case SHRD_ZSTD:     return "zstd";
+    case SHRD_LZ4:      return "lz4";
+    default:            return "unknown";
+    }
+} /* shrdcomp2str */
+
 /*-------------------------------------------------------------------
  * Convert shared command code to string for tracing purposes
  *-------------------------------------------------------------------*/
@@ -1659,7 +2534,7 @@ static const char* shrdcmd2str( const BYTE cmd )
 /*-------------------------------------------------------------------
  * Process a request (server side)
  *-------------------------------------------------------------------*/
-static void serverRequest (DEVBLK *dev, int ix, BYTE *hdr, BYTE *buf)
+static void serverRequest (DEVBLK *dev, SHRD *shrd, BYTE *hdr, BYTE *buf)
 {
 int      rc;                            /* Return code               */
 int      i;                             /* Loop index                */
@@ -1671,15 +2546,15 @@ int      len;                           /* Header length             */
 int      code;                          /* Response code             */
 int      rcd;                           /* Record to read/write      */
 int      off;                           /* Offset into record        */
-char     trcmsg[32];
+char     trcmsg[32];                    /* Trace message             */
 
     /* Extract header information */
     SHRD_GET_HDR (hdr, cmd, flag, devnum, id, len);
-    MSGBUF( trcmsg, "server request [%d]", ix );
+    MSGBUF( trcmsg, "server request [%d]", shrd->id );
     SHRDHDRTRACE( trcmsg, hdr );
 
     /* Save time of last request (for connection timeout purposes) */
-    dev->shrd[ix]->time = time( NULL );
+    shrd->time = time( NULL );
 
     /* Process the request */
     switch (cmd) {
@@ -1687,26 +2562,26 @@ char     trcmsg[32];
     case SHRD_CONNECT:
         if (dev->connecting)
         {
-            serverError (dev, ix, SHRD_ERROR_NOTINIT, cmd,
+            serverError (dev, shrd, SHRD_ERROR_NOTINIT, cmd,
                          "device not initialized");
             break;
         }
         if ((flag >> 4) != SHARED_VERSION)
         {
-            serverError (dev, ix, SHRD_ERROR_BADVERS, cmd,
+            serverError (dev, shrd, SHRD_ERROR_BADVERS, cmd,
                          "shared version mismatch");
             break;
         }
-        dev->shrd[ix]->release = flag & 0x0f;
+        shrd->release = flag & 0x0f;
         SHRD_SET_HDR (hdr, 0, (SHARED_VERSION << 4) | SHARED_RELEASE, dev->devnum, id, 2);
         store_hw (buf, id);
-        serverSend (dev, ix, hdr, buf, 2);
+        serverSend (dev, shrd, hdr, buf, 2);
         break;
 
     case SHRD_DISCONNECT:
         SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, 0);
-        serverSend (dev, ix, hdr, NULL, 0);
-        dev->shrd[ix]->disconnect = 1;
+        serverSend (dev, shrd, hdr, NULL, 0);
+        shrd->disconnect = 1;
 
         obtain_lock (&dev->lock);
 
@@ -1746,11 +2621,11 @@ char     trcmsg[32];
             {
                 release_lock (&dev->lock);
                 SHRD_SET_HDR (hdr, SHRD_BUSY, 0, dev->devnum, id, 0);
-                serverSend (dev, ix, hdr, NULL, 0);
+                serverSend (dev, shrd, hdr, NULL, 0);
                 break;
             }
 
-            dev->shrd[ix]->waiting = 1;
+            shrd->waiting = 1;
 
             /* Wait while the device is busy by the local system */
             while (dev->shioactive == DEV_SYS_LOCAL && !dev->suspended)
@@ -1767,7 +2642,7 @@ char     trcmsg[32];
                 break;
             }
 
-            dev->shrd[ix]->waiting = 0;
+            shrd->waiting = 0;
         }
 
         /* Make this system active on the device */
@@ -1787,23 +2662,29 @@ char     trcmsg[32];
         else if (cmd == SHRD_RESUME && dev->hnd->resume)
             (dev->hnd->resume) (dev);
 
-        /* Get the purge list */
-        if (dev->shrd[ix]->purgen == 0)
+        /* Push a release 3 client its purge list ahead of the
+           response; a lower release client gets it in the response */
+        if (shrd->release >= 3)
+        {
+            serverNotify (dev, shrd);
+            code = len = 0;
+        }
+        else if (shrd->purgen == 0)
             code = len = 0;
         else
         {
             code = SHRD_PURGE;
-            if (dev->shrd[ix]->purgen < 0)
+            if (shrd->purgen < 0)
                 len = 0;
             else
-                len = 4 * dev->shrd[ix]->purgen;
+                len = 4 * shrd->purgen;
         }
 
         /* Send the response */
         SHRD_SET_HDR (hdr, code, 0, dev->devnum, id, len);
-        rc = serverSend (dev, ix, hdr, (BYTE *)dev->shrd[ix]->purge, len);
+        rc = serverSend (dev, shrd, hdr, (BYTE *)shrd->purge, len);
         if (rc >= 0)
-            dev->shrd[ix]->purgen = 0;
+            shrd->purgen = 0;
         break;
 
     case SHRD_END:
@@ -1811,7 +2692,7 @@ char     trcmsg[32];
         /* Must be active on the device for this command */
         if (dev->shioactive != id)
         {
-            serverError (dev, ix, SHRD_ERROR_NOTACTIVE, cmd,
+            serverError (dev, shrd, SHRD_ERROR_NOTACTIVE, cmd,
                          "not active on this device");
             break;
         }
@@ -1840,7 +2721,7 @@ char     trcmsg[32];
             }
 
             /* Reset any 'waiting' bits */
-            for (i = 0; i < SHARED_MAX_SYS; i++)
+            for (i = 0; i < dev->shrdmax; i++)
                 if (dev->shrd[i])
                     dev->shrd[i]->waiting = 0;
 
@@ -1854,14 +2735,17 @@ char     trcmsg[32];
 
         /* Send response back */
         SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, 0);
-        serverSend (dev, ix, hdr, NULL, 0);
+        serverSend (dev, shrd, hdr, NULL, 0);
+
+        /* Tell the other release 3 clients what was updated */
+        serverNotify (dev, NULL);
         break;
 
     case SHRD_RESERVE:
         /* Must be active on the device for this command */
         if (dev->shioactive != id)
         {
-            serverError (dev, ix, SHRD_ERROR_NOTACTIVE, cmd,
+            serverError (dev, shrd, SHRD_ERROR_NOTACTIVE, cmd,
                          "not active on this device");
             break;
         }
@@ -1877,7 +2761,7 @@ char     trcmsg[32];
 
         /* Send response back */
         SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, 0);
-        serverSend (dev, ix, hdr, NULL, 0);
+        serverSend (dev, shrd, hdr, NULL, 0);
 
         break;
 
@@ -1885,7 +2769,7 @@ char     trcmsg[32];
         /* Must be active on the device for this command */
         if (dev->shioactive != id)
         {
-            serverError (dev, ix, SHRD_ERROR_NOTACTIVE, cmd,
+            serverError (dev, shrd, SHRD_ERROR_NOTACTIVE, cmd,
                          "not active on this device");
             break;
         }
@@ -1901,7 +2785,7 @@ char     trcmsg[32];
 
         /* Send response back */
         SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, 0);
-        serverSend (dev, ix, hdr, NULL, 0);
+        serverSend (dev, shrd, hdr, NULL, 0);
 
         break;
 
@@ -1909,13 +2793,13 @@ char     trcmsg[32];
         /* Must be active on the device for this command */
         if (dev->shioactive != id)
         {
-            serverError (dev, ix, SHRD_ERROR_NOTACTIVE, cmd,
+            serverError (dev, shrd, SHRD_ERROR_NOTACTIVE, cmd,
                          "not active on this device");
             break;
         }
 
         /* Set the compressions client is willing to accept */
-        dev->comps = dev->shrd[ix]->comps;
+        dev->comps = shrd->comps & (SHRD_LIBZ | SHRD_BZIP2);
         dev->comp = dev->compoff = 0;
 
         /* Call the I/O read exit */
@@ -1936,7 +2820,7 @@ char     trcmsg[32];
         dev->comps = dev->comp = dev->compoff = 0;
 
         SHRD_SET_HDR (hdr, code, flag, dev->devnum, id, dev->buflen);
-        serverSend (dev, ix, hdr, dev->buf, dev->buflen);
+        serverSend (dev, shrd, hdr, dev->buf, dev->buflen);
 
         break;
 
@@ -1944,7 +2828,7 @@ char     trcmsg[32];
         /* Must be active on the device for this command */
         if (dev->shioactive != id)
         {
-            serverError (dev, ix, SHRD_ERROR_NOTACTIVE, cmd,
+            serverError (dev, shrd, SHRD_ERROR_NOTACTIVE, cmd,
                          "not active on this device");
             break;
         }
@@ -1964,7 +2848,7 @@ char     trcmsg[32];
 
         /* Send response back */
         SHRD_SET_HDR (hdr, code, flag, dev->devnum, id, 0);
-        serverSend (dev, ix, hdr, NULL, 0);
+        serverSend (dev, shrd, hdr, NULL, 0);
 
         break;
 
@@ -1972,14 +2856,14 @@ char     trcmsg[32];
         /* Must be active on the device for this command */
         if (dev->shioactive != id)
         {
-            serverError (dev, ix, SHRD_ERROR_NOTACTIVE, cmd,
+            serverError (dev, shrd, SHRD_ERROR_NOTACTIVE, cmd,
                          "not active on this device");
             break;
         }
 
         /* Send the sense */
         SHRD_SET_HDR (hdr, 0, CSW_CE | CSW_DE, dev->devnum, id, dev->numsense);
-        serverSend (dev, ix, hdr, dev->sense, dev->numsense);
+        serverSend (dev, shrd, hdr, dev->sense, dev->numsense);
         memset (dev->sense, 0, sizeof(dev->sense));
         dev->sns_pending = 0;
         break;
@@ -1994,109 +2878,201 @@ char     trcmsg[32];
                 rc = 0;
             store_fw (buf, rc);
             SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, 4);
-            serverSend (dev, ix, hdr, buf, 4);
+            serverSend (dev, shrd, hdr, buf, 4);
             break;
 
         case SHRD_DEVCHAR:
             SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, dev->numdevchar);
-            serverSend (dev, ix, hdr, dev->devchar, dev->numdevchar);
+            serverSend (dev, shrd, hdr, dev->devchar, dev->numdevchar);
             break;
 
         case SHRD_DEVID:
             SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, dev->numdevid);
-            serverSend (dev, ix, hdr, dev->devid, dev->numdevid);
+            serverSend (dev, shrd, hdr, dev->devid, dev->numdevid);
             break;
 
         case SHRD_SERIAL:
             SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, sizeof( dev->serial ));
-            serverSend (dev, ix, hdr, dev->serial, (U32)sizeof( dev->serial ));
+            serverSend (dev, shrd, hdr, dev->serial, (U32)sizeof( dev->serial ));
             break;
 
         case SHRD_CKDCYLS:
             store_fw (buf, dev->ckdcyls);
             SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, 4);
-            serverSend (dev, ix, hdr, buf, 4);
+            serverSend (dev, shrd, hdr, buf, 4);
             break;
 
         case SHRD_FBAORIGIN:
             store_dw( buf, dev->fbaorigin );
             SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, 4);
-            serverSend (dev, ix, hdr, buf, 4);
+            serverSend (dev, shrd, hdr, buf, 4);
             break;
 
         case SHRD_FBANUMBLK:
             store_fw (buf, dev->fbanumblk);
             SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, 4);
-            serverSend (dev, ix, hdr, buf, 4);
+            serverSend (dev, shrd, hdr, buf, 4);
             break;
 
         case SHRD_FBABLKSIZ:
             store_fw (buf, dev->fbablksiz);
             SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, 4);
-            serverSend (dev, ix, hdr, buf, 4);
+            serverSend (dev, shrd, hdr, buf, 4);
             break;
 
         default:
-            serverError (dev, ix, SHRD_ERROR_INVALID, cmd,
+            serverError (dev, shrd, SHRD_ERROR_INVALID, cmd,
                          "invalid query request");
             break;
         } /* switch (flag) for SHRD_QUERY */
         break;
 
     case SHRD_COMPRESS:
+        /* A release 3 client may name the method it prefers in the
+           data; otherwise zlib is used with the parameter in 'flag' */
+        shrd->comp = 0;
+        shrd->compalg = SHRD_LIBZ;
 #if defined( HAVE_ZLIB )
-        dev->shrd[ix]->comp = (flag & 0x0f);
-        store_hw (buf, dev->shrd[ix]->comp);
-#else
-        store_hw (buf, 0);
+        shrd->comp = (flag & 0x0f);
 #endif
-        dev->shrd[ix]->comps = (flag & 0xf0) >> 4;
-        SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, 2);
-        serverSend (dev, ix, hdr, buf, 2);
+        if (len >= 2 && buf[1] && shrdCompSupported (buf[0]))
+        {
+            shrd->compalg = buf[0];
+            shrd->comp = buf[1];
+        }
+        shrd->comps = (flag & 0xf0) >> 4;
+        store_hw (buf, shrd->comp);
+        buf[2] = shrd->compalg;
+        len = shrd->release >= 3 ? 3 : 2;
+        SHRD_SET_HDR (hdr, 0, 0, dev->devnum, id, len);
+        serverSend (dev, shrd, hdr, buf, len);
         break;
 
     default:
-        serverError (dev, ix, SHRD_ERROR_INVALID, cmd,
+        serverError (dev, shrd, SHRD_ERROR_INVALID, cmd,
                      "invalid request");
         break;
     } /* switch (cmd) */
 } /* serverRequest */
 
 /*-------------------------------------------------------------------
- * Locate the SHRD block for a socket (server side). Returns index.
+ * Push pending purge lists to release 3 clients (server side)
+ *
+ * If 'shrd' is NULL the lists of all the device's release 3 clients
+ * are pushed.  dev->lock must *not* be held.
  *-------------------------------------------------------------------*/
-static int serverLocate( DEVBLK* dev, int id, int* avail )
+static void serverNotify (DEVBLK *dev, SHRD *shrd)
 {
-    int i;
-
-    if (avail)
-        *avail = -1;
+int      i;                             /* Loop index                */
+int      n;                             /* Number of purge entries   */
+SHRD    *s;                             /* -> SHRD block             */
+FWORD   *purge;                         /* Purge list                */
+BYTE     hdr[SHRD_HDR_SIZE];            /* Header                    */
 
-    for (i=0; i < SHARED_MAX_SYS; i++)
+    for (i = 0; i < dev->shrdmax; i++)
     {
-        // Active slot?
-        if (dev->shrd[i])
-        {
-            // Is this the one they want?
-            if (dev->shrd[i]->id == id)
-                return i;
-        }
-        else // (available slot)
+        obtain_lock (&dev->lock);
+
+        s = shrd ? shrd : (i < dev->shrdmax ? dev->shrd[i] : NULL);
+        if (s == NULL || s->release < 3 || s->purgen == 0)
         {
-            if (avail && *avail < 0)
-                *avail = i;
+            release_lock (&dev->lock);
+            if (shrd) break;
+            continue;
         }
+
+        /* Take the list so updates can start a new one */
+        n = s->purgen;
+        purge = s->purge;
+        s->purgen = 0;
+        s->purge = NULL;
+        s->purgemax = 0;
+
+        release_lock (&dev->lock);
+
+        /* An empty list means purge everything */
+        if (n < 0) n = 0;
+
+        SHRDTRACE("notify %d sent to id=%d", n, s->id);
+        SHRD_SET_HDR (hdr, SHRD_NOTIFY, 0, dev->devnum, s->id, n * 4);
+        serverSend (dev, s, hdr, (BYTE *)purge, n * 4);
+        free (purge);
+
+        if (shrd) break;
     }
+} /* serverNotify */
 
-    return -1;
-}
+/*-------------------------------------------------------------------
+ * Locate the SHRD block for a client (server side)
+ * dev->lock *must* be held
+ *-------------------------------------------------------------------*/
+static SHRD *serverLocate (DEVBLK *dev, int id)
+{
+int      i;                             /* Loop index                */
+
+    for (i = 0; i < dev->shrdmax; i++)
+        if (dev->shrd[i] && dev->shrd[i]->id == id)
+            return dev->shrd[i];
+
+    return NULL;
+} /* serverLocate */
+
+/*-------------------------------------------------------------------
+ * Attach a new client to the device (server side)
+ * dev->lock *must* be held
+ *-------------------------------------------------------------------*/
+static SHRD *serverAttach (DEVBLK *dev, SHRD_CONN *conn, int id)
+{
+int      i;                             /* Loop index                */
+int      n;                             /* New table size            */
+SHRD    *shrd;                          /* -> SHRD block             */
+SHRD   **tab;                           /* -> Reallocated table      */
+
+    /* Find an available slot, growing the table if need be */
+    for (i = 0; i < dev->shrdmax; i++)
+        if (dev->shrd[i] == NULL)
+            break;
+
+    if (i >= dev->shrdmax)
+    {
+        n = dev->shrdmax ? dev->shrdmax * 2 : SHARED_MAX_SYS;
+        if (!(tab = realloc (dev->shrd, n * sizeof(SHRD *))))
+            return NULL;
+        memset (tab + dev->shrdmax, 0, (n - dev->shrdmax) * sizeof(SHRD *));
+        dev->shrd = tab;
+        dev->shrdmax = n;
+    }
+
+    if (!(shrd = calloc (1, sizeof(SHRD))))
+        return NULL;
+
+    shrd->id      = id ? id : serverId (dev);
+    shrd->conn    = conn;
+    shrd->release = conn->release;
+    shrd->time    = time (NULL);
+    shrd->purgen  = -1;
+
+    obtain_lock (&sysblk.shrdwrklock);
+    conn->refs++;
+    conn->nshrd++;
+    conn->dev = dev;
+    release_lock (&sysblk.shrdwrklock);
+
+    dev->shrd[i] = shrd;
+    dev->shrdconn++;
+
+    if (MLVL( VERBOSE ))
+        // "%1d:%04X Shared: %s connected id %d"
+        WRMSG( HHC00733, "I", LCSS_DEVNUM, conn->ipaddr, shrd->id );
+
+    return shrd;
+} /* serverAttach */
 
 /*-------------------------------------------------------------------
  * Return a new Identifier (server side)
  *-------------------------------------------------------------------*/
 static int serverId (DEVBLK *dev)
 {
-int      i;                             /* Loop index                */
 int      id;                            /* Identifier                */
 
     do {
@@ -2107,11 +3083,7 @@ int      id;                            /* Identifier                */
             dev->shrdid = 1;
         id = dev->shrdid;
 
-        for (i = 0; i < SHARED_MAX_SYS; i++)
-            if (dev->shrd[i] && dev->shrd[i]->id == id)
-                break;
-
-    } while (i < SHARED_MAX_SYS);
+    } while (serverLocate (dev, id));
 
     return id;
 } /* serverId */
@@ -2119,7 +3091,7 @@ int      id;                            /* Identifier                */
 /*-------------------------------------------------------------------
  * Respond with an error message (server side)
  *-------------------------------------------------------------------*/
-static int serverError (DEVBLK *dev, int ix, int code, int status,
+static int serverError (DEVBLK *dev, SHRD *shrd, int code, int status,
                         char *msg)
 {
     int rc;                             /* Return code               */
@@ -2131,12 +3103,11 @@ static int serverError (DEVBLK *dev, int ix, int code, int status,
     if (len > SHARED_MAX_MSGLEN)
         len = SHARED_MAX_MSGLEN;
 
-    SHRD_SET_HDR( hdr, code, status, dev ? dev->devnum : 0,
-                  ix < 0 ? 0 : dev->shrd[ix]->id, (U16) len );
+    SHRD_SET_HDR( hdr, code, status, dev->devnum, shrd->id, (U16) len );
 
     SHRDTRACE( "SERVER ERROR! %2.2x %2.2x: %s", code, status, msg );
 
-    rc = serverSend( dev, ix, hdr, (BYTE*) msg, (int) len );
+    rc = serverSend( dev, shrd, hdr, (BYTE*) msg, (int) len );
     return rc;
 
 } /* serverError */
@@ -2144,11 +3115,11 @@ static int serverError (DEVBLK *dev, int ix, int code, int status,
 /*-------------------------------------------------------------------
  * Send data (server side)
  *-------------------------------------------------------------------*/
-static int serverSend (DEVBLK *dev, int ix, BYTE *hdr, BYTE *buf,
+static int serverSend (DEVBLK *dev, SHRD *shrd, BYTE *hdr, BYTE *buf,
                        int buflen)
 {
 int      rc;                            /* Return code               */
-int      sock;                          /* Socket number             */
+SHRD_CONN *conn;                        /* -> Connection             */
 BYTE     code;                          /* Header code               */
 BYTE     status;                        /* Header status             */
 U16      devnum;                        /* Header device number      */
@@ -2179,39 +3150,29 @@ BYTE     cbuf[SHRD_HDR_SIZE + 65536];   /* Combined buffer           */
     /* Send only the header buffer if 'buf' is empty */
     if (buflen == 0)  sendbuf = hdr;
 
-    /* Get socket number; if 'ix' < 0 we don't have a device yet */
-    if (ix >= 0)
-        sock = dev->shrd[ix]->fd;
-    else
-    {
-        sock = -ix;
-        dev = NULL;
-    }
-
     SHRDHDRTRACE( "server send", hdr );
 
-#if defined( HAVE_ZLIB )
+#if defined( SHARED_COMPRESS )
     /* Compress the buf */
-    if (ix >= 0 && dev->shrd[ix]->comp != 0
+    if (shrd->comp != 0
      && code == SHRD_OK && status == 0
      && hdrlen - SHRD_HDR_SIZE <= SHRD_COMP_MAX_OFF
      && buflen >= SHARED_COMPRESS_MINLEN)
     {
-        unsigned long newlen;
         int off = hdrlen - SHRD_HDR_SIZE;
         sendbuf = cbuf;
-        newlen = sizeof(cbuf) - hdrlen;
         memcpy (cbuf, hdr, hdrlen);
-        rc = compress2 (cbuf + hdrlen, &newlen,
-                        buf, buflen, dev->shrd[ix]->comp);
-        if (rc == Z_OK && (int)newlen < buflen)
+        rc = shrdCompress (shrd->compalg, shrd->comp, cbuf + hdrlen,
+                           SHARED_MAX_DATA - off, buf, buflen);
+        if (rc > 0 && rc < buflen)
         {
             /* Setup to use the compressed buffer */
-            sendlen = hdrlen + newlen;
+            sendlen = hdrlen + rc;
             buflen = 0;
             code = SHRD_COMP;
-            status = (SHRD_LIBZ << 4) | off;
-            SHRD_SET_HDR (cbuf, code, status, devnum, id, (U16)(newlen + off));
+            status = ((shrd->compalg == SHRD_LIBZ ? SHRD_LIBZ
+                                                  : SHRD_COMP_ALT) << 4) | off;
+            SHRD_SET_HDR (cbuf, code, status, devnum, id, (U16)(rc + off));
             SHRDHDRTRACE2( "server send", cbuf, "(compressed)" );
         }
     }
@@ -2225,31 +3186,113 @@ BYTE     cbuf[SHRD_HDR_SIZE + 65536];   /* Combined buffer           */
         memcpy (cbuf + hdrlen, buf, buflen);
     }
 
+    /* Hold the connection; the client may be moving to another */
+    obtain_lock (&sysblk.shrdwrklock);
+    conn = shrd->conn;
+    conn->refs++;
+    release_lock (&sysblk.shrdwrklock);
+
     /* Send the combined header and data */
-    rc = send (sock, sendbuf, sendlen, 0);
+    rc = serverConnSend (conn, sendbuf, sendlen);
 
     /* Process return code */
     if (rc < 0)
     {
-        // "%1d:%04X Shared: error in send id %d: %s"
-        WRMSG( HHC00729, "E", LCSS_DEVNUM, id, strerror( HSO_errno ));
-        dev->shrd[ix]->disconnect = 1;
+        if (!conn->dead)
+            // "%1d:%04X Shared: error in send id %d: %s"
+            WRMSG( HHC00729, "E", LCSS_DEVNUM, id, strerror( -rc ));
+        shrd->disconnect = 1;
     }
 
+    serverConnRelease (conn);
+
     return rc;
 
 } /* serverSend */
 
+/*-------------------------------------------------------------------
+ * Send a message on a connection (server side)
+ *
+ * Workers for different devices may be sending on the same
+ * connection.  Returns the negative socket error on failure.
+ *-------------------------------------------------------------------*/
+static int serverConnSend (SHRD_CONN *conn, BYTE *buf, int len)
+{
+int      rc;                            /* Return code               */
+
+    obtain_lock (&conn->sendlock);
+    rc = conn->dead ? -HSO_ENOTCONN : sendData (conn->fd, buf, len);
+    release_lock (&conn->sendlock);
+
+    return rc;
+} /* serverConnSend */
+
+/*-------------------------------------------------------------------
+ * Respond with an error before a device is known (server side)
+ *
+ * The request's device number and id are echoed back so that
+ * a multiplexing client can tell which device the error is for.
+ *-------------------------------------------------------------------*/
+static int serverConnError (SHRD_CONN *conn, BYTE *hdr, int code,
+                            char *msg)
+{
+DEVBLK  *dev = NULL;                    /* For 'SHRDTRACE'           */
+BYTE     cmd;                           /* Request command           */
+BYTE     flag;                          /* Request flags             */
+U16      devnum;                        /* Request device number     */
+int      id;                            /* Request identifier        */
+int      len;                           /* Message length            */
+BYTE     ebuf[SHRD_HDR_SIZE + SHARED_MAX_MSGLEN]; /* Response        */
+
+    SHRD_GET_HDR (hdr, cmd, flag, devnum, id, len);
+
+    len = (int)strlen (msg) + 1;
+    if (len > SHARED_MAX_MSGLEN)
+        len = SHARED_MAX_MSGLEN;
+
+    SHRD_SET_HDR (ebuf, code, cmd, devnum, id, len);
+    memcpy (ebuf + SHRD_HDR_SIZE, msg, len);
+
+    SHRDTRACE( "SERVER ERROR! %2.2x %2.2x: %s", code, cmd, msg );
+
+    /* A lower release client has one connection per device;
+       give up on it like we always have */
+    if (conn->nshrd == 0 && conn->release < 3)
+        conn->dead = true;
+
+    return serverConnSend (conn, ebuf, SHRD_HDR_SIZE + len);
+} /* serverConnError */
+
+/*-------------------------------------------------------------------
+ * Release a reference to a connection (server side)
+ *-------------------------------------------------------------------*/
+static void serverConnRelease (SHRD_CONN *conn)
+{
+int      refs;                          /* Remaining references      */
+
+    obtain_lock (&sysblk.shrdwrklock);
+    refs = --conn->refs;
+    release_lock (&sysblk.shrdwrklock);
+
+    if (refs > 0)
+        return;
+
+    close_socket (conn->fd);
+    destroy_lock (&conn->sendlock);
+    free (conn->ipaddr);
+    free (conn);
+} /* serverConnRelease */
+
 /*-------------------------------------------------------------------
  * Determine if a client can be disconnected (server side)
  *-------------------------------------------------------------------*/
-static bool serverDisconnectable( DEVBLK* dev, int ix )
+static bool serverDisconnectable( DEVBLK* dev, SHRD* shrd )
 {
     return
     (1
-        && !dev->shrd[ix]->waiting
-        && !dev->shrd[ix]->pending
-        && dev->shioactive != dev->shrd[ix]->id
+        && !shrd->waiting
+        && !shrd->rq
+        && dev->shioactive != shrd->id
     );
 }
 
@@ -2257,12 +3300,15 @@ static bool serverDisconnectable( DEVBLK* dev, int ix )
  * Disconnect a client (server side)
  * dev->lock *must* be held
  *-------------------------------------------------------------------*/
-static void serverDisconnect (DEVBLK *dev, int ix)
+static void serverDisconnect (DEVBLK *dev, SHRD *shrd)
 {
     int id;                             /* Client identifier         */
     int i;                              /* Loop index                */
+    SHRD_CONN *conn;                    /* -> Connection             */
+    SHRD_MSG *msg;                      /* -> Queued request         */
 
-    id = dev->shrd[ix]->id;
+    id = shrd->id;
+    conn = shrd->conn;
 
 //FIXME: Handle a disconnected busy client better
 //       Perhaps a disconnect timeout value... this will
@@ -2284,7 +3330,7 @@ static void serverDisconnect (DEVBLK *dev, int ix)
             (dev->hnd->end) (dev);
 
         /* Reset any 'waiting' bits */
-        for (i = 0; i < SHARED_MAX_SYS; i++)
+        for (i = 0; i < dev->shrdmax; i++)
             if (dev->shrd[i])
                 dev->shrd[i]->waiting = 0;
 
@@ -2306,341 +3352,557 @@ static void serverDisconnect (DEVBLK *dev, int ix)
 
     if (MLVL( VERBOSE ))
         // "%1d:%04X Shared: %s disconnected id %d"
-        WRMSG( HHC00731, "I", LCSS_DEVNUM, dev->shrd[ix]->ipaddr, id );
+        WRMSG( HHC00731, "I", LCSS_DEVNUM, conn->ipaddr, id );
 
     /* Release the SHRD block */
-    close_socket (dev->shrd[ix]->fd);
-    free (dev->shrd[ix]->ipaddr);
-    free (dev->shrd[ix]);
-    dev->shrd[ix] = NULL;
+    for (i = 0; i < dev->shrdmax; i++)
+        if (dev->shrd[i] == shrd)
+            dev->shrd[i] = NULL;
+    while ((msg = shrd->rq))
+    {
+        shrd->rq = msg->next;
+        free (msg);
+    }
+    free (shrd->purge);
+    free (shrd);
 
     dev->shrdconn--;
+
+    /* A lower release client's connection goes with its device */
+    obtain_lock (&sysblk.shrdwrklock);
+    if (--conn->nshrd == 0 && conn->release < 3)
+        shutdown (conn->fd, SHUT_RDWR);
+    release_lock (&sysblk.shrdwrklock);
+
+    serverConnRelease (conn);
 } /* serverDisconnect */
 
 /*-------------------------------------------------------------------
- * Return client ip
+ * Queue a device for a worker thread (server side)
+ * dev->lock *must* be held
  *-------------------------------------------------------------------*/
-static char *clientip (int sock)
+static void serverSchedule (DEVBLK *dev)
 {
-int                     rc;             /* Return code               */
-struct sockaddr_in      client;         /* Client address structure  */
-socklen_t               namelen;        /* Length of client structure*/
-
-    namelen = sizeof(client);
-    rc = getpeername (sock, (struct sockaddr *)&client, &namelen);
-    return inet_ntoa(client.sin_addr);
+    if (dev->shrdsched)
+        return;
+    dev->shrdsched = true;
 
-} /* clientip */
+    obtain_lock (&sysblk.shrdwrklock);
+    dev->shrdnext = NULL;
+    if (sysblk.shrdwrkql)
+        sysblk.shrdwrkql->shrdnext = dev;
+    else
+        sysblk.shrdwrkq = dev;
+    sysblk.shrdwrkql = dev;
+    signal_condition (&sysblk.shrdwrkcond);
+    release_lock (&sysblk.shrdwrklock);
+} /* serverSchedule */
 
 /*-------------------------------------------------------------------
- * Find device by device number
+ * Process the requests queued for a device (server side)
+ *
+ * Only one worker at a time processes a device.  The clients are
+ * served round robin, one request at a time, so a busy client
+ * can't starve the others.  A START for a device that is busy on
+ * another remote system stays queued with the 'waiting' bit on
+ * until that system ENDs or goes away.
  *-------------------------------------------------------------------*/
-static DEVBLK *findDevice (U16 devnum)
+static void serverDevice (DEVBLK *dev)
 {
-DEVBLK      *dev;                       /* -> Device block           */
+int      i, n;                          /* Loop indexes              */
+SHRD    *shrd;                          /* -> SHRD block             */
+SHRD_MSG *msg;                          /* -> Queued request         */
 
-    for (dev = sysblk.firstdev; dev != NULL; dev = dev->nextdev)
-        if (dev->devnum == devnum) break;
-    return dev;
+    obtain_lock (&dev->lock);
 
-} /* findDevice */
+    for (n = 0; n < dev->shrdmax; )
+    {
+        i = dev->shrdrr++ % dev->shrdmax;
+        dev->shrdrr %= dev->shrdmax;
+        shrd = dev->shrd[i];
+        n++;
+
+        if (shrd == NULL)
+            continue;
+
+        /* Disconnect if the disconnect bit is set */
+        if (shrd->disconnect && (!shrd->rq || shrd->conn->dead))
+        {
+            serverDisconnect (dev, shrd);
+            n = 0;
+            continue;
+        }
+
+        if (shrd->waiting || !(msg = shrd->rq))
+            continue;
+
+        release_lock (&dev->lock);
+
+        /* Process the request */
+        serverRequest (dev, shrd, msg->hdr, msg->buf);
+
+        obtain_lock (&dev->lock);
+
+        /* Dequeue the request unless it has to wait for the device */
+        if (!shrd->waiting)
+        {
+            shrd->rq = msg->next;
+            if (shrd->rq == NULL)
+                shrd->rqlast = NULL;
+            free (msg);
+        }
+
+        /* Look at everyone again */
+        n = 0;
+    }
+
+    dev->shrdsched = false;
+
+    release_lock (&dev->lock);
+} /* serverDevice */
 
 /*-------------------------------------------------------------------
- * Connect a new client     This is essentially the device thread
+ * Shared device worker thread (server side)
  *-------------------------------------------------------------------*/
-static void *serverConnect (void *psock)
+static void *serverWorker (void *arg)
 {
-int             csock;                  /* Connection socket         */
-int             rc;                     /* Return code               */
-BYTE            cmd;                    /* Request command           */
-BYTE            flag;                   /* Request flag              */
-U16             devnum;                 /* Request device number     */
-int             id;                     /* Request id                */
-int             len;                    /* Request data length       */
-int             ix;                     /* Client index              */
-DEVBLK         *dev=NULL;               /* -> Device block           */
-time_t          now;                    /* Current time              */
-fd_set          selset;                 /* Read bit map for select   */
-int             maxfd;                  /* Max fd for select         */
-struct timeval  wait;                   /* Wait time for select      */
-BYTE            hdr[SHRD_HDR_SIZE + 65536];  /* Header + buffer      */
-BYTE           *buf = hdr + SHRD_HDR_SIZE;   /* Buffer               */
-char           *ipaddr = NULL;          /* IP addr of connected peer */
-char            threadname[16] = {0};
+DEVBLK  *dev;                           /* -> Device block           */
 
-    // We are (or will be) the "dev->shrdtid" thread...
+    UNREFERENCED( arg );
 
-    csock = *(int*)psock;
-    free( psock );
-    ipaddr = clientip( csock );
+    obtain_lock (&sysblk.shrdwrklock);
 
-    SHRDTRACE( "server connect %s sock %d", ipaddr, csock );
+    /* Exit if there are more workers than wanted */
+    while (sysblk.shrdworking <= sysblk.shrdworkers)
+    {
+        if (!(dev = sysblk.shrdwrkq))
+        {
+            wait_condition (&sysblk.shrdwrkcond, &sysblk.shrdwrklock);
+            continue;
+        }
+        sysblk.shrdwrkq = dev->shrdnext;
+        if (sysblk.shrdwrkq == NULL)
+            sysblk.shrdwrkql = NULL;
 
-    rc = recvData( csock, hdr, buf, 65536, 1 );
-    if (rc < 0)
+        release_lock (&sysblk.shrdwrklock);
+        serverDevice (dev);
+        obtain_lock (&sysblk.shrdwrklock);
+    }
+
+    sysblk.shrdworking--;
+
+    release_lock (&sysblk.shrdwrklock);
+
+    return NULL;
+} /* serverWorker */
+
+/*-------------------------------------------------------------------
+ * Start the wanted number of worker threads (server side)
+ *-------------------------------------------------------------------*/
+static void serverWorkers (void)
+{
+int      rc;                            /* Return code               */
+TID      tid;                           /* Worker thread id          */
+
+    obtain_lock (&sysblk.shrdwrklock);
+
+    while (sysblk.shrdworking < sysblk.shrdworkers)
     {
-        // "Shared: connect to IP %s failed"
-        WRMSG( HHC00732, "E", ipaddr );
-        close_socket( csock );
-        return NULL;
+        rc = create_thread (&tid, DETACHED, serverWorker, NULL, "shrd worker");
+        if (rc)
+        {
+            // "Error in function create_thread(): %s"
+            WRMSG( HHC00102, "E", strerror( rc ));
+            break;
+        }
+        sysblk.shrdworking++;
     }
 
-    SHRD_GET_HDR( hdr, cmd, flag, devnum, id, len );
+    /* Let any surplus workers exit */
+    if (sysblk.shrdworking > sysblk.shrdworkers)
+        broadcast_condition (&sysblk.shrdwrkcond);
+
+    release_lock (&sysblk.shrdwrklock);
+} /* serverWorkers */
+
+/*-------------------------------------------------------------------
+ * Queue a request received on a connection (server side)
+ *-------------------------------------------------------------------*/
+static void serverDispatch (SHRD_CONN *conn, BYTE *hdr, BYTE *buf)
+{
+BYTE     cmd;                           /* Request command           */
+BYTE     flag;                          /* Request flags             */
+U16      devnum;                        /* Request device number     */
+int      id;                            /* Request identifier        */
+int      len;                           /* Request data length       */
+DEVBLK  *dev;                           /* -> Device block           */
+SHRD    *shrd;                          /* -> SHRD block             */
+SHRD_CONN *old;                         /* -> Previous connection    */
+SHRD_MSG *msg;                          /* -> Queued request         */
+
+    SHRD_GET_HDR (hdr, cmd, flag, devnum, id, len);
+
+    /* The first CONNECT tells us the client's release */
+    if (cmd == SHRD_CONNECT && conn->nshrd == 0)
+        conn->release = flag & 0x0f;
 
     /* Error if not a connect request */
     if (id == 0 && cmd != SHRD_CONNECT)
     {
-        serverError( NULL, -csock, SHRD_ERROR_NOTCONN, cmd,
-                     "not a connect request" );
-        close_socket( csock );
-        return NULL;
+        serverConnError (conn, hdr, SHRD_ERROR_NOTCONN,
+                         "not a connect request");
+        return;
     }
 
     /* Locate the device */
-    if (!(dev = findDevice( devnum )))
+    if (!(dev = findDevice (devnum)))
     {
-        serverError( NULL, -csock, SHRD_ERROR_NODEVICE, cmd,
-                     "device not found" );
-        close_socket( csock );
-        return NULL;
+        serverConnError (conn, hdr, SHRD_ERROR_NODEVICE,
+                         "device not found");
+        return;
     }
 
-    /* Obtain the device lock */
-    obtain_lock( &dev->lock );
+    obtain_lock (&dev->lock);
 
-    /* Find an available slot for the connection */
-    if ((rc = serverLocate( dev, id, &ix )) >= 0)
+    if (!(shrd = serverLocate (dev, id)))
     {
-        release_lock( &dev->lock );
-        serverError( NULL, -csock, SHRD_ERROR_NODEVICE, cmd,
-                     "already connected" );
-        close_socket( csock );
-        return NULL;
-    }
+        /* Error if no more clients are allowed */
+        if (sysblk.shrdmaxsys && dev->shrdconn >= sysblk.shrdmaxsys)
+        {
+            release_lock (&dev->lock);
+            serverConnError (conn, hdr, SHRD_ERROR_NOTAVAIL,
+                             "too many connections");
+            return;
+        }
 
-    /* Error if no available slot */
-    if (ix < 0)
+        if (!(shrd = serverAttach (dev, conn, id)))
+        {
+            release_lock (&dev->lock);
+            serverConnError (conn, hdr, SHRD_ERROR_NOMEM,
+                             "calloc() failure");
+            return;
+        }
+        id = shrd->id;
+        SHRD_SET_HDR (hdr, cmd, flag, devnum, id, len);
+    }
+    else if (shrd->conn != conn)
     {
-        release_lock( &dev->lock );
-        serverError( NULL, -csock, SHRD_ERROR_NOTAVAIL, cmd,
-                     "too many connections" );
-        close_socket( csock );
-        return NULL;
+        /* The client reconnected; move it to the new connection */
+        obtain_lock (&sysblk.shrdwrklock);
+        old = shrd->conn;
+        conn->refs++;
+        conn->nshrd++;
+        conn->dev = dev;
+        if (--old->nshrd == 0 && old->release < 3)
+            shutdown (old->fd, SHUT_RDWR);
+        shrd->conn = conn;
+        release_lock (&sysblk.shrdwrklock);
+
+        shrd->release = conn->release;
+        shrd->disconnect = 0;
+        serverConnRelease (old);
     }
 
-    /* Obtain SHRD block */
-    if (!(dev->shrd[ix] = calloc( sizeof( SHRD ), 1 )))
+    /* Queue the request; 'buf' has room for the response data */
+    if (!(msg = malloc (sizeof(SHRD_MSG) + (len > 16 ? len : 16))))
     {
-        release_lock( &dev->lock );
-        serverError( NULL, -csock, SHRD_ERROR_NOMEM, cmd,
-                     "calloc() failure" );
-        close_socket( csock );
-        return NULL;
+        release_lock (&dev->lock);
+        serverConnError (conn, hdr, SHRD_ERROR_NOMEM,
+                         "malloc() failure");
+        return;
     }
+    msg->next = NULL;
+    msg->len = len;
+    memcpy (msg->hdr, hdr, SHRD_HDR_SIZE);
+    if (len > 0)
+        memcpy (msg->buf, buf, len);
+
+    if (shrd->rqlast)
+        shrd->rqlast->next = msg;
+    else
+        shrd->rq = msg;
+    shrd->rqlast = msg;
 
-    /* Initialize the SHRD block */
-    dev->shrd[ix]->pending = 1;
-    dev->shrd[ix]->havehdr = 1;
-    if (id == 0) id = serverId( dev );
-    dev->shrd[ix]->id      = id;
-    dev->shrd[ix]->fd      = csock;
-    dev->shrd[ix]->ipaddr  = strdup(ipaddr);
-    dev->shrd[ix]->time    = time (NULL);
-    dev->shrd[ix]->purgen  = -1;
-    dev->shrdconn++;
-    SHRD_SET_HDR( dev->shrd[ix]->hdr, cmd, flag, devnum, id, len );
+    serverSchedule (dev);
 
-    if (MLVL( VERBOSE ))
-        // "%1d:%04X Shared: %s connected id %d"
-        WRMSG( HHC00733, "I", LCSS_DEVNUM, ipaddr, id );
+    release_lock (&dev->lock);
+} /* serverDispatch */
 
-    /* Return if device thread already active */
-    if (dev->shrdtid)
+/*-------------------------------------------------------------------
+ * Determine if an idle connection should be timed out (server side)
+ *
+ * Only lower release clients are timed out, and only when none of
+ * their devices are busy.
+ *-------------------------------------------------------------------*/
+static bool serverIdle (SHRD_CONN *conn)
+{
+DEVBLK  *dev;                           /* -> Device block           */
+bool     idle = true;                   /* true=Can be timed out     */
+int      i;                             /* Loop index                */
+
+    if (conn->release >= 3 || (time (NULL) - conn->time) <= SHARED_TIMEOUT)
+        return false;
+
+    if ((dev = conn->dev))
     {
-        release_lock( &dev->lock );
-        return NULL;
+        obtain_lock (&dev->lock);
+        for (i = 0; i < dev->shrdmax; i++)
+            if (dev->shrd[i] && dev->shrd[i]->conn == conn
+             && !serverDisconnectable (dev, dev->shrd[i]))
+                idle = false;
+        release_lock (&dev->lock);
     }
 
-    /* This thread will be the shared device thread (dev->shrdtid) */
+    return idle;
+} /* serverIdle */
 
-    dev->shrdtid = thread_id();
+/*-------------------------------------------------------------------
+ * Return client ip
+ *-------------------------------------------------------------------*/
+static char *clientip (int sock)
+{
+int                     rc;             /* Return code               */
+struct sockaddr_in      client;         /* Client address structure  */
+socklen_t               namelen;        /* Length of client structure*/
 
-    MSGBUF( threadname, "shrd dev %1d:%04X", LCSS_DEVNUM );
-    if (MLVL( VERBOSE ))
-        LOG_THREAD_BEGIN( threadname  );
+    namelen = sizeof(client);
+    rc = getpeername (sock, (struct sockaddr *)&client, &namelen);
+    return inet_ntoa(client.sin_addr);
+
+} /* clientip */
 
-    /* Keep looping while there are still clients connected to our device */
-    while (dev->shrdconn)
+/*-------------------------------------------------------------------
+ * Find device by device number
+ *-------------------------------------------------------------------*/
+static DEVBLK *findDevice (U16 devnum)
+{
+DEVBLK      *dev;                       /* -> Device block           */
+
+    for (dev = sysblk.firstdev; dev != NULL; dev = dev->nextdev)
+        if (dev->devnum == devnum) break;
+    return dev;
+
+} /* findDevice */
+
+/*-------------------------------------------------------------------
+ * Connection reader thread (server side)
+ *
+ * Receives the requests from a client and queues each on the
+ * device it is for; the worker threads process them.
+ *-------------------------------------------------------------------*/
+static void *serverConnect (void *arg)
+{
+SHRD_CONN      *conn = arg;             /* -> Connection             */
+int             rc;                     /* Return code               */
+int             i;                      /* Loop index                */
+DEVBLK         *dev = NULL;             /* -> Device block           */
+fd_set          selset;                 /* Read bit map for select   */
+struct timeval  wait;                   /* Wait time for select      */
+BYTE            hdr[SHRD_HDR_SIZE + 65536];  /* Header + buffer      */
+BYTE           *buf = hdr + SHRD_HDR_SIZE;   /* Buffer               */
+
+    SHRDTRACE( "server connect %s sock %d", conn->ipaddr, conn->fd );
+
+    while (!conn->dead)
     {
         FD_ZERO( &selset );
-        maxfd = -1;
+        FD_SET( conn->fd, &selset );
+        wait.tv_sec = SHARED_SELECT_WAIT;
+        wait.tv_usec = 0;
 
-        /* Get the current time */
-        now = time( NULL );
+        rc = select( conn->fd + 1, &selset, NULL, NULL, &wait );
 
-        /* For each remote system connected to our device... */
-        for (ix = 0; ix < SHARED_MAX_SYS; ix++)
+        /* Timeout; see if an idle client should be let go */
+        if (rc == 0)
         {
-            /* Is there a client at this slot? */
-            if (dev->shrd[ix])
-            {
-                /* Stop as soon as we find a pending request */
-                if (dev->shrd[ix]->pending && !dev->shrd[ix]->waiting)
-                    break; // (go process pending request)
-
-                /* Disconnect if not a valid socket */
-                if (!socket_is_socket( dev->shrd[ix]->fd ))
-                    dev->shrd[ix]->disconnect = 1;
-
-                /* See if the connection can be timed out */
-                else if (1
-                    && (now - dev->shrd[ix]->time) > SHARED_TIMEOUT
-                    && serverDisconnectable( dev, ix )
-                )
-                    dev->shrd[ix]->disconnect = 1;
-
-                /* Disconnect if the disconnect bit is set */
-                if (dev->shrd[ix]->disconnect)
-                    serverDisconnect( dev, ix );
-
-                /* Otherwise set the fd if not waiting */
-                else if (!dev->shrd[ix]->waiting)
-                {
-                    FD_SET( dev->shrd[ix]->fd, &selset );
+            if (serverIdle( conn ))
+                break;
+            continue;
+        }
 
-                    if (dev->shrd[ix]->fd >= maxfd)
-                        maxfd = dev->shrd[ix]->fd + 1;
+        if (rc < 0)
+        {
+            if (HSO_errno == HSO_EINTR)
+                continue;
 
-                    SHRDTRACE( "select set %d id=%d",
-                        dev->shrd[ix]->fd, dev->shrd[ix]->id );
-                }
-            }
+            // "Shared: error in function %s: %s"
+            WRMSG( HHC00735, "E", "select()", strerror( HSO_errno ));
+            break;
         }
 
-        /* Wait for request if all pending requests were processed */
-        if (ix >= SHARED_MAX_SYS)
+        /* Read the request packet */
+        if ((rc = recvData( conn->fd, hdr, buf, 65536, 1 )) < 0)
         {
-            /* If our select set is empty, there are not any clients
-               connected to our device (and dev->shrdconn SHOULD now
-               be zero) and thus we have nothing to do. If we don't
-               have any clients connected to our device then we are
-               serving no purpose so we should just exit our thread.
-            */
-            if (maxfd < 0)      // (if nothing to select)
-                continue;       // (then exit our thread)
+            if (rc != -HSO_ENOTCONN && !conn->dead)
+                // "Shared: error in receive from %s: %s"
+                WRMSG( HHC00746, "E", conn->ipaddr, strerror( -rc ));
+            break;
+        }
 
-            /* Wait for a client to send us a request */
-            wait.tv_sec = SHARED_SELECT_WAIT;
-            wait.tv_usec = 0;
+        conn->time = time( NULL );
+        serverDispatch( conn, hdr, buf );
+    }
+
+    /* Disconnect the clients that used the connection */
+    conn->dead = true;
 
-            release_lock( &dev->lock );
+    for (dev = sysblk.firstdev; dev; dev = dev->nextdev)
+    {
+        if (!dev->shrdmax)
+            continue;
+
+        obtain_lock( &dev->lock );
+        for (i = 0; i < dev->shrdmax; i++)
+            if (dev->shrd[i] && dev->shrd[i]->conn == conn)
             {
-                dev->shrdwait = 1;
-                {
-                    rc = select( maxfd, &selset, NULL, NULL, &wait );
-                }
-                dev->shrdwait = 0;
+                dev->shrd[i]->disconnect = 1;
+                serverSchedule( dev );
             }
-            obtain_lock( &dev->lock );
+        release_lock( &dev->lock );
+    }
 
-            SHRDTRACE("select rc %d", rc );
+    dev = NULL;
+    SHRDTRACE( "server disconnect %s sock %d", conn->ipaddr, conn->fd );
 
-            /* Timeout; no one has any requests for us at this time */
-            if (rc == 0)
-                continue;
+    serverConnRelease( conn );
 
-            /* Did the select fail? */
-            if (rc < 0 )
-            {
-                /* Try again if temporary error */
-                if (HSO_errno == HSO_EINTR || HSO_errno == HSO_EBADF)
-                    continue;
+    return NULL;
 
-                // "Shared: error in function %s: %s"
-                WRMSG( HHC00735, "E", "select()", strerror( HSO_errno ));
-                break; // (exit our thread)
-            }
+} /* serverConnect */
 
-            /* One or more sockets in our select set is ready, meaning
-               one or more remote clients connected to our device has
-               a request it needs us to process. Loop through our list
-               of connected clients and set the 'pending' request bit
-               for each one whose socket that select said is FD_ISSET.
-            */
-            for (ix = 0; ix < SHARED_MAX_SYS; ix++)
-            {
-                if (1
-                    /* Is there a client at this slot? */
-                    && dev->shrd[ix]
-                    /* Did select() say its socket is set? */
-                    && FD_ISSET( dev->shrd[ix]->fd, &selset )
-                )
-                {
-                    /* Indicate this client has a pending request */
-                    dev->shrd[ix]->pending = 1;
-                    SHRDTRACE("select isset %d id=%d",
-                        dev->shrd[ix]->fd, dev->shrd[ix]->id );
-                }
-            }
-            continue; // (re-iterate to process all pending requests)
-        }
+/*-------------------------------------------------------------------
+ * Benchmark the protocol against a shared device's server
+ *
+ * 'count' START/READ/END channel programs are run as a new client
+ * of the remote device using the given release of the protocol.
+ * At release 2 each request waits for its response; at release 3
+ * each channel program is sent at once and the responses are
+ * collected afterwards, like the client does with posted requests.
+ *-------------------------------------------------------------------*/
+static int shrdBench (DEVBLK *dev, int release, int count)
+{
+int      rc = -1;                       /* Return code               */
+int      err = -HSO_ENOTCONN;           /* Socket error              */
+int      fd;                            /* Socket                    */
+int      i, j;                          /* Loop indexes              */
+int      id;                            /* Our identifier            */
+int      n;                             /* Number of requests        */
+BYTE     code;                          /* Response code             */
+BYTE     status;                        /* Response status           */
+U16      devnum;                        /* Response device number    */
+int      rid;                           /* Response identifier       */
+int      len;                           /* Response length           */
+BYTE     req[3][SHRD_HDR_SIZE + 4];     /* Requests                  */
+int      reqlen[3];                     /* Request lengths           */
+BYTE     hdr[SHRD_HDR_SIZE];            /* Response header           */
+BYTE    *buf;                           /* Response data             */
+char     what[16];                      /* Benchmark name            */
+char     secs[32];                      /* Elapsed seconds           */
+char     rate[32];                      /* Channel programs/second   */
+struct timeval beg, end;                /* Start and end times       */
+double   elapsed;                       /* Elapsed time              */
+
+    MSGBUF( what, "release %d", release );
+
+    if (!(buf = malloc (65536)))
+        return -1;
 
-        /* Found a pending request */
-        release_lock( &dev->lock );
+    if ((fd = clientSocket (dev, 0)) < 0)
+    {
+        free (buf);
+        return -1;
+    }
 
-        SHRDTRACE("select ready %d id=%d",
-            dev->shrd[ix]->fd, dev->shrd[ix]->id );
+    /* Connect as a new client of the remote device */
+    SHRD_SET_HDR (req[0], SHRD_CONNECT, (SHARED_VERSION << 4) | release,
+                  dev->rmtnum, 0, 0);
+    if ((err = sendData (fd, req[0], SHRD_HDR_SIZE)) < 0
+     || (err = recvData (fd, hdr, buf, 65536, 0)) < 0)
+        goto bench_exit;
+    SHRD_GET_HDR (hdr, code, status, devnum, rid, len);
+    if (code & SHRD_ERROR)
+    {
+        // "%1d:%04X Shared: remote error %2.2X-%2.2X: %s"
+        WRMSG( HHC00726, "E", LCSS_DEVNUM, code, status, buf );
+        goto bench_exit;
+    }
+    id = fetch_hw (buf);
+    if ((status & 0x0f) < release)
+    {
+        // "%1d:%04X Shared: benchmark %s not supported by the server"
+        WRMSG( HHC00749, "W", LCSS_DEVNUM, what );
+        rc = 0;
+        goto bench_disconnect;
+    }
 
-        if (dev->shrd[ix]->havehdr)
-        {
-            /* Copy the saved start/resume packet */
-            memcpy( hdr, dev->shrd[ix]->hdr, SHRD_HDR_SIZE );
-            dev->shrd[ix]->havehdr = 0;
-            dev->shrd[ix]->waiting = 0;
-        }
-        else
+    gettimeofday (&beg, NULL);
+
+    for (i = 0; i < count; i++)
+    {
+        SHRD_SET_HDR (req[0], SHRD_START, 0, dev->rmtnum, id, 0);
+        SHRD_SET_HDR (req[1], SHRD_READ,  0, dev->rmtnum, id, 4);
+        store_fw (req[1] + SHRD_HDR_SIZE, i % 16);
+        SHRD_SET_HDR (req[2], SHRD_END,   0, dev->rmtnum, id, 0);
+        reqlen[0] = reqlen[2] = SHRD_HDR_SIZE;
+        reqlen[1] = SHRD_HDR_SIZE + 4;
+
+        /* Send all three requests first at release 3 */
+        if (release >= 3)
+            for (j = 0; j < 3; j++)
+                if ((err = sendData (fd, req[j], reqlen[j])) < 0)
+                    goto bench_exit;
+
+        for (j = 0, n = 0; j < 3; )
         {
-            /* Read the request packet */
-            if ((rc = recvData( dev->shrd[ix]->fd, hdr, buf, 65536, 1 )) < 0)
+            if (release < 3 && n == j)
             {
-                // "%1d:%04X Shared: error in receive from %s id %d"
-                WRMSG( HHC00734, "E", LCSS_DEVNUM, dev->shrd[ix]->ipaddr, dev->shrd[ix]->id );
-                dev->shrd[ix]->disconnect = 1;
-                dev->shrd[ix]->pending = 0;
-                obtain_lock( &dev->lock );
+                if ((err = sendData (fd, req[j], reqlen[j])) < 0)
+                    goto bench_exit;
+                n++;
+            }
+            if ((err = recvData (fd, hdr, buf, 65536, 0)) < 0)
+                goto bench_exit;
+            SHRD_GET_HDR (hdr, code, status, devnum, rid, len);
+            if (code == SHRD_NOTIFY)
                 continue;
+            if (code & SHRD_ERROR)
+            {
+                // "%1d:%04X Shared: remote error on %s request %2.2X-%2.2X"
+                WRMSG( HHC00745, "E", LCSS_DEVNUM,
+                       shrdcmd2str( req[j][0] ), code, status );
+                goto bench_disconnect;
             }
+            j++;
         }
+    }
 
-        /* Process the request */
-        serverRequest( dev, ix, hdr, buf );
+    gettimeofday (&end, NULL);
 
-        obtain_lock( &dev->lock );
+    elapsed = (end.tv_sec - beg.tv_sec)
+            + (end.tv_usec - beg.tv_usec) / 1000000.0;
+    MSGBUF( secs, "%.3f", elapsed );
+    MSGBUF( rate, "%.0f", elapsed > 0 ? count / elapsed : 0.0 );
 
-        /* If the 'waiting' bit is on then the start/resume request
-           failed because the device is busy on some other remote
-           system.  We only need to save the header because the data
-           is ignored for start/resume.
-        */
-        if (dev->shrd[ix]->waiting)
-        {
-            memcpy( dev->shrd[ix]->hdr, hdr, SHRD_HDR_SIZE );
-            dev->shrd[ix]->havehdr = 1;
-        }
-        else
-            dev->shrd[ix]->pending = 0;
+    // "%1d:%04X Shared: benchmark %s: %d channel programs in %s seconds, %s per second"
+    WRMSG( HHC00747, "I", LCSS_DEVNUM, what, count, secs, rate );
+    rc = 0;
 
-    } /* while (dev->shrdconn) */
+bench_disconnect:
 
-    dev->shrdtid = 0;
-    release_lock( &dev->lock );
+    SHRD_SET_HDR (req[0], SHRD_DISCONNECT, 0, dev->rmtnum, id, 0);
+    if (sendData (fd, req[0], SHRD_HDR_SIZE) >= 0)
+        recvData (fd, hdr, buf, 65536, 0);
 
-    if (MLVL( VERBOSE ))
-        LOG_THREAD_END( threadname  );
+bench_exit:
 
-    return NULL;
+    if (rc < 0 && err < 0)
+        // "%1d:%04X Shared: error in receive: %s"
+        WRMSG( HHC00725, "E", LCSS_DEVNUM, strerror( -err ));
 
-} /* serverConnect */
+    close_socket (fd);
+    free (buf);
+    return rc;
+} /* shrdBench */
 
 /*-------------------------------------------------------------------
  * Trace routine for tracing SHRD_HDR
@@ -2765,7 +4027,7 @@ int                     lsock;          /* inet socket for listening */
 int                     usock;          /* unix socket for listening */
 int                     rsock;          /* Ready socket              */
 int                     csock;          /* Socket for conversation   */
-int                    *psock;          /* Pointer to socket         */
+SHRD_CONN              *conn;           /* -> New connection         */
 struct sockaddr_in      server;         /* Server address structure  */
 #if defined( HAVE_SYS_UN_H )
 struct sockaddr_un      userver;        /* Unix address structure    */
@@ -2856,7 +4118,7 @@ struct timeval          timeout = {0};
 #endif // defined( HAVE_SYS_UN_H )
 
     /* Put the sockets into listening state */
-    rc = listen( lsock, SHARED_MAX_SYS );
+    rc = listen( lsock, SOMAXCONN );
 
     if (rc < 0)
     {
@@ -2869,7 +4131,7 @@ struct timeval          timeout = {0};
 
     if (usock >= 0)
     {
-        rc = listen( usock, SHARED_MAX_SYS );
+        rc = listen( usock, SOMAXCONN );
 
         if (rc < 0)
         {
@@ -2949,25 +4211,37 @@ struct timeval          timeout = {0};
                 continue;
             }
 
-            if (!(psock = malloc( sizeof( csock ))))
+            if (!(conn = calloc( 1, sizeof( SHRD_CONN ))))
             {
                 char buf[40];
-                MSGBUF( buf, "malloc(%d)", (int) sizeof( csock ));
+                MSGBUF( buf, "calloc(%d)", (int) sizeof( SHRD_CONN ));
                 // "Shared: error in function %s: %s"
                 WRMSG( HHC00735, "E", buf, strerror( HSO_errno ));
                 close_socket( csock );
                 continue;
             }
-            *psock = csock;
 
-            /* Create a thread to complete the client connection */
+            /* Requests are small; don't let them wait for each other */
+            if (rsock == lsock)
+                disable_nagle( csock );
+
+            initialize_lock( &conn->sendlock );
+            conn->fd     = csock;
+            conn->ipaddr = strdup( clientip( csock ));
+            conn->refs   = 1;
+            conn->time   = time( NULL );
+
+            /* Make sure there are workers to process the requests */
+            serverWorkers();
+
+            /* Create a thread to receive the client's requests */
             rc = create_thread( &tid, DETACHED,
-                                serverConnect, psock, "serverConnect" );
+                                serverConnect, conn, "serverConnect" );
             if (rc)
             {
                 // "Error in function create_thread(): %s"
                 WRMSG( HHC00102, "E", strerror( rc ));
-                close_socket( csock );
+                serverConnRelease( conn );
             }
 
         } /* end if(rsock) */
@@ -3032,7 +4306,9 @@ DLL_EXPORT int shrd_cmd( int argc, char* argv[], char* cmdline )
     {
         OBTAIN_SHRDTRACE_LOCK();
         {
-            MSGBUF( buf, "TRACE=%d DTAX=%d", sysblk.shrdtracen, sysblk.shrddtax );
+            MSGBUF( buf, "TRACE=%d DTAX=%d MAXSYS=%d WORKERS=%d",
+                    sysblk.shrdtracen, sysblk.shrddtax,
+                    sysblk.shrdmaxsys, sysblk.shrdworkers );
         }
         RELEASE_SHRDTRACE_LOCK();
         // "%-14s: %s"
@@ -3156,6 +4432,97 @@ DLL_EXPORT int shrd_cmd( int argc, char* argv[], char* cmdline )
         return 0;
     }
 
+    if (0
+        || strcasecmp( kw, "MAXSYS"  ) == 0
+        || strcasecmp( kw, "WORKERS" ) == 0
+    )
+    {
+        int n;
+        bool workers = strcasecmp( kw, "WORKERS" ) == 0;
+
+        if (!op)
+        {
+            // "Shared: invalid or missing value %s"
+            WRMSG( HHC00740, "E", kw );
+            return -1;
+        }
+        if (0
+            || sscanf( op, "%d%c", &n, &c ) != 1
+            || n < (workers ? 1 : 0)
+            || (workers && n > SHARED_MAX_WORKERS)
+        )
+        {
+            // "Shared: invalid or missing value %s"
+            WRMSG( HHC00740, "E", op );
+            return -1;
+        }
+
+        if (workers)
+        {
+            obtain_lock( &sysblk.shrdwrklock );
+            sysblk.shrdworkers = n;
+            release_lock( &sysblk.shrdwrklock );
+
+            /* Adjust the running workers if the server is up */
+            if (sysblk.shrdtid)
+                serverWorkers();
+
+            MSGBUF( buf, "WORKERS=%d", sysblk.shrdworkers );
+        }
+        else
+        {
+            sysblk.shrdmaxsys = n;
+            MSGBUF( buf, "MAXSYS=%d", sysblk.shrdmaxsys );
+        }
+
+        // "%-14s set to %s"
+        WRMSG( HHC02204, "I", argv[0], buf );
+
+        return 0;
+    }
+
+    if (strcasecmp( kw, "BENCH" ) == 0)
+    {
+        DEVBLK* dev;
+        U16     devnum;
+        int     count = SHARED_BENCH_COUNT;
+        int     n;
+
+        if (0
+            || !op
+            || (n = sscanf( op, "%hx%c%d%c", &devnum, &c, &count, &c )) < 1
+            || (n > 1 && (c != ',' || n != 3))
+            || count < 1
+        )
+        {
+            // "Shared: invalid or missing value %s"
+            WRMSG( HHC00740, "E", op ? op : kw );
+            return -1;
+        }
+
+        if (!(dev = find_device_by_devnum( 0, devnum )))
+        {
+            // "%1d:%04X device not found"
+            WRMSG( HHC02200, "E", 0, devnum );
+            return -1;
+        }
+
+        if (dev->hnd != &shared_ckd_device_hndinfo
+         && dev->hnd != &shared_fba_device_hndinfo)
+        {
+            // "%1d:%04X Shared: device is not a remote shared device"
+            WRMSG( HHC00748, "E", LCSS_DEVNUM );
+            return -1;
+        }
+
+        /* Compare the original protocol with pipelining */
+        if (shrdBench( dev, 2, count ) < 0
+         || shrdBench( dev, 3, count ) < 0)
+            return -1;
+
+        return 0;
+    }
+
     // "Shared: invalid or missing keyword %s"
     WRMSG( HHC00741, "E", kw );
     return -1;
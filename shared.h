@@ -178,14 +178,19 @@
  * 0x4d  FBANUMBLK          Number of FBA blocks
  * 0x4e  FBABLKSIZ          Size of an FBA block
  * 0x3x  COMP           For WRITE, data is compressed at offset 'x':
+ * 0x3x  ALT                using the method named by the first byte
+ *                          of the compressed data (0x04 zstd, 0x08 lz4)
  * 0x2x  BZIP2              using bzip2
  * 0x1x  LIBZ               using zlib
  * 0xxy                 For COMPRESS, identifies the compression
  *                      algorithms supported by the client (0x2y for bzip2,
- *                      0x1y for zlib, 0x3y for both) and the zlib compression
+ *                      0x1y for zlib, 0x3y for both; release 3 adds 0x4y
+ *                      for zstd and 0x8y for lz4) and the zlib compression
  *                      parameter 'y' for sending otherwise uncompressed data
  *                      back and forth.  If 'y' is zero (default) then no
  *                      uncompressed data is compressed between client & server.
+ *                      A release 3 client may send 2 bytes of data naming
+ *                      the method and parameter it prefers instead of zlib.
  *
  * 'devnum' identifies the device by number on the server instance.
  *                     The device number may be different than the
@@ -228,6 +233,10 @@
  *                     starts (0 .. 15).  This bit is only turned on
  *                     when both the 'code' and 'status' bytes would
  *                     otherwise be zero.
+ * 0x04  NOTIFY        Unsolicited (release 3).  A list of 'records' that
+ *                     have been updated by other systems and must be
+ *                     purged from the client's cache.  The format of the
+ *                     data is the same as for PURGE.  See CACHING below.
  * 0x08  PURGE         START request was issued by the client.  A list
  *                     of 'records' to be purged from local cache is
  *                     returned.  These are 'records' that have been
@@ -260,6 +269,35 @@
  * the server will indicate that the client should purge all records for
  * the device.
  *
+ * Release 3 clients are instead sent NOTIFY responses.  The server pushes
+ * them to every other client as soon as a writer's END request has been
+ * processed, and always before the response to the client's own START,
+ * so a client never runs a channel program against stale records.  The
+ * list may hold up to SHARED_NOTIFY_MAX records before it degrades to a
+ * purge of the whole device.
+ *
+ * RELEASE 3
+ *
+ * A client and server that are both at release 3 or later also use the
+ * following.  Lower release peers keep using the original protocol.
+ *
+ * Multiplexing.  All devices a client instance uses on a given server
+ * share one connection.  The first device connects normally; once the
+ * server reports release 3 its socket becomes the shared connection and
+ * a receiver thread routes responses to devices by device number and
+ * id.  Every device still issues its own CONNECT over the connection.
+ *
+ * Pipelining.  The client does not wait for the responses to WRITE, END,
+ * RESERVE and RELEASE requests.  The server processes the requests of
+ * each client in the order they were sent, so the responses are simply
+ * collected (and any errors reported) before the next response the
+ * client actually needs.
+ *
+ * Server threads.  One reader thread per connection queues requests on
+ * the device they are for, and a small pool of worker threads (see the
+ * 'shrd WORKERS=' command) processes each device's queue.  The number of
+ * clients per device is only limited by 'shrd MAXSYS='.
+ *
  * COMPRESSION
  *
  * Data that would normally be transferred uncompressed between client
@@ -306,13 +344,17 @@
  * compressed then the data is sent as is, unless the client has indicated
  * that it does not support that compression algorithm.
  *
+ * When built with zstd or lz4 support and connected to a release 3
+ * server, 'comp=zstd' (or 'comp=zstd:n' for level 'n') and 'comp=lz4'
+ * select those methods instead of zlib.  lz4 costs the least processor
+ * time and is the usual choice for a fast local network.
+ *
  *
  * TODO
  *
  *  1.  More doc (sorry, I got winded)
- *  2.  Delays observed during short transfers (redrive select?)
- *  3.  Better server side behaviour due to disconnect
- *  4.  etc.
+ *  2.  Better server side behaviour due to disconnect
+ *  3.  etc.
  *
  *-------------------------------------------------------------------*/
 
@@ -325,7 +367,7 @@
 /*-------------------------------------------------------------------*/
 
 #define SHARED_VERSION              0   /* Version level  (0 .. 15)  */
-#define SHARED_RELEASE              2   /* Release level  (0 .. 15)  */
+#define SHARED_RELEASE              3   /* Release level  (0 .. 15)  */
 
 /* Constraints                                                       */
 #define SHARED_DEFAULT_PORT      3990   /* Default shared port       */
@@ -334,7 +376,13 @@
 #define SHARED_TIMEOUT            120   /* Disconnect timeout (sec)  */
 #define SHARED_SELECT_WAIT         10   /* Select timeout (sec)      */
 #define SHARED_COMPRESS_MINLEN    512   /* Min length for compression*/
-#define SHARED_MAX_SYS              8   /* Max number connections    */
+#define SHARED_MAX_SYS              8   /* Initial SHRD table size   */
+#define SHARED_NOTIFY_MAX        4096   /* Max size of notify list   */
+#define SHARED_MAX_POSTED          16   /* Max unanswered requests   */
+#define SHARED_DEFAULT_WORKERS      4   /* Default worker threads    */
+#define SHARED_MAX_WORKERS         64   /* Max worker threads        */
+#define SHARED_MAX_DATA         65535   /* Max request data length   */
+#define SHARED_BENCH_COUNT       1000   /* Default benchmark count   */
 
 /* Requests                                                          */
 #define SHRD_CONNECT             0xe0   /* Connect                   */
@@ -358,6 +406,7 @@
 #define SHRD_BUSY                0x20   /* Resource is busy          */
 #define SHRD_COMP                0x10   /* Data is compressed        */
 #define SHRD_PURGE               0x08   /* Purge list provided       */
+#define SHRD_NOTIFY              0x04   /* Unsolicited purge list    */
 
 /* Error responses                                                   */
 #define SHRD_ERROR_INVALID       0xf0   /* Invalid request           */
@@ -378,6 +427,13 @@
 #define SHRD_COMP_MAX_OFF          15   /* Max offset allowed        */
 #define SHRD_LIBZ                0x01   /* Compressed using zlib     */
 #define SHRD_BZIP2               0x02   /* Compressed using bzip2    */
+#define SHRD_COMP_ALT            0x03   /* Method byte precedes data */
+#define SHRD_ZSTD                0x04   /* Compressed using zstd     */
+#define SHRD_LZ4                 0x08   /* Compressed using lz4      */
+
+#if defined( HAVE_ZLIB ) || defined( HAVE_ZSTD ) || defined( HAVE_LZ4 )
+  #define SHARED_COMPRESS               /* Can compress transfers    */
+#endif
 
 /* Query Types                                                       */
 #define SHRD_DEVCHAR             0x41   /* Device characteristics    */
@@ -391,23 +447,64 @@
 
 typedef char SHRD_TRACE[128];           /* Trace entry               */
 
+typedef struct SHRD_MSG   SHRD_MSG;     /* Queued message            */
+typedef struct SHRD_CONN  SHRD_CONN;    /* Server side connection    */
+typedef struct SHRD_MUX   SHRD_MUX;     /* Client side connection    */
+
 /*-------------------------------------------------------------------*/
-struct SHRD                             /* Device Sharing ctl. blk.  */
+struct SHRD_MSG                         /* Queued request/response   */
+{
+        SHRD_MSG *next;                 /* -> Next queued message    */
+        int     len;                    /* Data length               */
+        DBLWRD  hdr;                    /* Header                    */
+        BYTE    buf[FLEXIBLE_ARRAY];    /* Data                      */
+};
+/*-------------------------------------------------------------------*/
+struct SHRD_CONN                        /* Server side connection    */
 {
-        int     id;                     /* Identifier                */
         int     fd;                     /* Socket                    */
         char   *ipaddr;                 /* IP addr of connected peer */
+        LOCK    sendlock;               /* Serializes sends          */
+        int     refs;                   /* Reader + attached SHRDs   */
+        int     nshrd;                  /* Number attached SHRDs     */
+        int     release;                /* Client release level      */
+        time_t  time;                   /* Time last request         */
+        DEVBLK *dev;                    /* Device last attached      */
+        bool    dead;                   /* true=Connection lost      */
+};
+/*-------------------------------------------------------------------*/
+struct SHRD_MUX                         /* Client side connection    */
+{
+        SHRD_MUX *next;                 /* -> Next connection        */
+        LOCK    lock;                   /* Device list/queue LOCK    */
+        LOCK    sendlock;               /* Serializes sends          */
+        COND    cond;                   /* CONNECT serialization     */
+        int     fd;                     /* Socket                    */
+        struct in_addr rmtaddr;         /* Remote address            */
+        U16     rmtport;                /* Remote port number        */
+        bool    localhost;              /* true=Unix domain socket   */
+        bool    dead;                   /* true=Connection lost      */
+        int     refs;                   /* Devices + receiver thread */
+        DEVBLK *devs;                   /* Attached devices          */
+        DEVBLK *connecting;             /* Device awaiting CONNECT   */
+};
+/*-------------------------------------------------------------------*/
+struct SHRD                             /* Device Sharing ctl. blk.  */
+{
+        int     id;                     /* Identifier                */
+        SHRD_CONN *conn;                /* Connection                */
         time_t  time;                   /* Time last request         */
         int     release;                /* Client release level      */
         int     comp;                   /* Compression parameter     */
+        int     compalg;                /* Compression method        */
         int     comps;                  /* Compression supported     */
-        unsigned  pending:1,            /* 1=Request pending         */
-                waiting:1,              /* 1=Waiting for device      */
-                havehdr:1,              /* 1=Header already read     */
+        unsigned  waiting:1,            /* 1=Waiting for device      */
                 disconnect:1;           /* 1=Disconnect device       */
-        DBLWRD  hdr;                    /* Header                    */
+        SHRD_MSG *rq;                   /* Request queue             */
+        SHRD_MSG *rqlast;               /* Last queued request       */
         int     purgen;                 /* Number purge entries      */
-        FWORD   purge[SHARED_PURGE_MAX];/* Purge list                */
+        int     purgemax;               /* Size of purge list        */
+        FWORD  *purge;                  /* Purge list                */
 };
 /*-------------------------------------------------------------------*/
 struct SHRD_HDR                         /* Device Sharing msg header */
@@ -488,24 +585,62 @@ static void    shared_release (DEVBLK *dev);
 static int     clientWrite (DEVBLK *dev, int block);
 static void    clientPurge (DEVBLK *dev, int n, void *buf);
 static int     clientPurgescan (int *answer, int ix, int i, void *data);
+static void    clientNotify (DEVBLK *dev, BYTE *hdr, BYTE *buf, int len);
+static int     clientCompParm (DEVBLK *dev, char *op);
+static int     clientSocket (DEVBLK *dev, int retry);
 static int     clientConnect (DEVBLK *dev, int retry);
+static void    clientClose (DEVBLK *dev);
+static bool    clientMuxAttach (DEVBLK *dev);
+static void    clientMuxCreate (DEVBLK *dev);
+static void    clientMuxDetach (DEVBLK *dev);
+static void    clientMuxRelease (SHRD_MUX *mux);
+static void    clientMuxShutdown (SHRD_MUX *mux);
+static void   *clientMuxThread (void *arg);
 static int     clientRequest (DEVBLK *dev, BYTE *buf, int len, int cmd,
                       int flags, int *code, int *status);
+static int     clientRequestData (DEVBLK *dev, BYTE *sbuf, int slen,
+                      BYTE *buf, int len, int cmd, int flags,
+                      int *code, int *status);
+static int     clientPost (DEVBLK *dev, BYTE *hdr, BYTE *buf, int buflen,
+                      int rcd);
+static void    clientReap (DEVBLK *dev);
+static void    clientPostError (DEVBLK *dev, int ix, int code, int status);
 static int     clientSend (DEVBLK *dev, BYTE *hdr, BYTE *buf, int buflen);
 static int     clientRecv (DEVBLK *dev, BYTE *hdr, BYTE *buf, int buflen);
+static int     clientNext (DEVBLK *dev, BYTE *hdr, BYTE *buf, int buflen);
+static int     sendData (int sock, BYTE *buf, int len);
 static int     recvData(int sock, BYTE *hdr, BYTE *buf, int buflen, int server);
-static void    serverRequest (DEVBLK *dev, int ix, BYTE *hdr, BYTE *buf);
-static int     serverLocate (DEVBLK *dev, int id, int *avail);
+static int     shrdCompress (int alg, int parm, BYTE *dst, int dstlen,
+                      BYTE *src, int srclen);
+static int     shrdDecompress (int alg, BYTE *dst, int dstlen,
+                      BYTE *src, int srclen);
+static bool    shrdCompSupported (int alg);
+static const char *shrdcomp2str (int alg);
+static void    serverRequest (DEVBLK *dev, SHRD *shrd, BYTE *hdr, BYTE *buf);
+static void    serverNotify (DEVBLK *dev, SHRD *shrd);
+static SHRD   *serverLocate (DEVBLK *dev, int id);
+static SHRD   *serverAttach (DEVBLK *dev, SHRD_CONN *conn, int id);
 static int     serverId (DEVBLK *dev);
-static int     serverError (DEVBLK *dev, int ix, int code, int status,
+static int     serverError (DEVBLK *dev, SHRD *shrd, int code, int status,
                       char *msg);
-static int     serverSend (DEVBLK *dev, int ix, BYTE *hdr, BYTE *buf,
+static int     serverSend (DEVBLK *dev, SHRD *shrd, BYTE *hdr, BYTE *buf,
                       int buflen);
-static bool    serverDisconnectable (DEVBLK *dev, int ix);
-static void    serverDisconnect (DEVBLK *dev, int ix);
+static int     serverConnSend (SHRD_CONN *conn, BYTE *buf, int len);
+static int     serverConnError (SHRD_CONN *conn, BYTE *hdr, int code,
+                      char *msg);
+static void    serverConnRelease (SHRD_CONN *conn);
+static bool    serverDisconnectable (DEVBLK *dev, SHRD *shrd);
+static void    serverDisconnect (DEVBLK *dev, SHRD *shrd);
+static void    serverSchedule (DEVBLK *dev);
+static void    serverDevice (DEVBLK *dev);
+static void   *serverWorker (void *arg);
+static void    serverWorkers (void);
+static void    serverDispatch (SHRD_CONN *conn, BYTE *hdr, BYTE *buf);
+static bool    serverIdle (SHRD_CONN *conn);
 static char   *clientip (int sock);
 static DEVBLK *findDevice (U16 devnum);
-static void   *serverConnect (void *psock);
+static void   *serverConnect (void *arg);
+static int     shrdBench (DEVBLK *dev, int release, int count);
 static void    shrdhdrtrc( DEVBLK* dev, const char* msg, const BYTE* hdr,
                           const char* msg2 );
 static void    shrdtrc( DEVBLK* dev, const char* fmt, ... ) ATTR_PRINTF(2,3);
@@ -301,6 +301,200 @@ void* sie_perfmon_disp()
 
 
 #if defined( FEATURE_SIE )
+/*-------------------------------------------------------------------*/
+/*                    SIE state descriptor cache                     */
+/*-------------------------------------------------------------------*/
+/* Each host CPU keeps the decoded storage, SCA, RCP and facility    */
+/* state of the last SIE_CACHE_ENTRIES state descriptors it has      */
+/* dispatched, keyed by the raw SIEBK fields they were decoded from. */
+/* When the 'siecache' command has enabled it, an entry whose key    */
+/* still matches is reused instead of being decoded and validated    */
+/* again, and the guest TLB is kept when the same descriptor is      */
+/* re-dispatched on the same CPU. The per-descriptor entry and exit  */
+/* counters are maintained whether or not the cache is enabled.      */
+/*-------------------------------------------------------------------*/
+
+#define SIE_CACHE_KEY( _p, _f )                                     \
+    do {                                                            \
+        memcpy( (_p), &(_f), sizeof( _f ));                         \
+        (_p) += sizeof( _f );                                       \
+    } while (0)
+
+/*-------------------------------------------------------------------*/
+/*   Build the cache key from everything the decoded state uses      */
+/*-------------------------------------------------------------------*/
+static U32 ARCH_DEP( sie_cache_key )( REGS* regs, BYTE* key )
+{
+    BYTE* p = key;
+
+    SIE_CACHE_KEY( p, regs->arch_mode );
+    SIE_CACHE_KEY( p, GUESTREGS->arch_mode );
+    SIE_CACHE_KEY( p, regs->mainlim );
+    SIE_CACHE_KEY( p, regs->CR( 1 ));
+    SIE_CACHE_KEY( p, sysblk.mainstor );
+    SIE_CACHE_KEY( p, sysblk.storkeys );
+
+    SIE_CACHE_KEY( p, STATEBK->mx );
+    SIE_CACHE_KEY( p, STATEBK->m );
+    SIE_CACHE_KEY( p, STATEBK->zone );
+    SIE_CACHE_KEY( p, STATEBK->prefix );
+    SIE_CACHE_KEY( p, STATEBK->mso );
+    SIE_CACHE_KEY( p, STATEBK->mse );
+    SIE_CACHE_KEY( p, STATEBK->xso );
+    SIE_CACHE_KEY( p, STATEBK->xsl );
+    SIE_CACHE_KEY( p, STATEBK->scao );
+#if defined( FEATURE_001_ZARCH_INSTALLED_FACILITY )
+    SIE_CACHE_KEY( p, STATEBK->scaoh );
+#endif
+    SIE_CACHE_KEY( p, STATEBK->rcpo );
+#if defined( FEATURE_VIRTUAL_ARCHITECTURE_LEVEL )
+    SIE_CACHE_KEY( p, STATEBK->fld );
+#endif
+
+#if defined( FEATURE_REGION_RELOCATE )
+    if ((STATEBK->mx & SIE_MX_RRF) && STATEBK->zone < FEATURE_SIE_MAXZONES)
+    {
+        SIE_CACHE_KEY( p, sysblk.zpb[ STATEBK->zone ].mso );
+        SIE_CACHE_KEY( p, sysblk.zpb[ STATEBK->zone ].msl );
+        SIE_CACHE_KEY( p, sysblk.zpb[ STATEBK->zone ].eso );
+        SIE_CACHE_KEY( p, sysblk.zpb[ STATEBK->zone ].esl );
+    }
+#endif
+
+    return (U32)(p - key);
+}
+
+/*-------------------------------------------------------------------*/
+/*   Find (or assign) the cache entry for the SIEBK being entered.   */
+/*   Returns true if its decoded state was reloaded into GUESTREGS.  */
+/*-------------------------------------------------------------------*/
+static bool ARCH_DEP( sie_cache_lookup )( REGS* regs, RADR sd )
+{
+    SIECACHE*  sc  = GUESTREGS->siecache;
+    SIECENT*   ce  = NULL;
+    SIECENT*   lru = NULL;
+    int        i;
+#if defined( FEATURE_VIRTUAL_ARCHITECTURE_LEVEL )
+    U32        fld;
+#endif
+
+    if (!sc)
+        return false;
+
+    /* Discard everything after a 'siecache reset' */
+    if (sc->gen != sysblk.siecache_gen)
+    {
+        memset( sc->ent, 0, sizeof( sc->ent ));
+        sc->gen = sysblk.siecache_gen;
+    }
+
+    for (i=0; i < SIE_CACHE_ENTRIES; i++)
+    {
+        if (sc->ent[i].sd == sd)
+        {
+            ce = &sc->ent[i];
+            break;
+        }
+        if (!lru || sc->ent[i].lastuse < lru->lastuse)
+            lru = &sc->ent[i];
+    }
+
+    if (!ce)
+    {
+        ce = lru;
+        memset( ce, 0, sizeof( SIECENT ));
+        ce->sd = sd;
+    }
+
+    ce->lastuse = ++sc->clock;
+    ce->entries++;
+    sc->cur = ce;
+    sc->keylen = 0;
+
+    if (!sysblk.siecache)
+        return false;
+
+    sc->keylen = ARCH_DEP( sie_cache_key )( regs, sc->key );
+
+    if (0
+        || ce->keylen != sc->keylen
+        || memcmp( ce->key, sc->key, sc->keylen ) != 0
+    )
+        return false;
+
+#if defined( FEATURE_VIRTUAL_ARCHITECTURE_LEVEL )
+
+    /* The facility lists are outside the SIEBK so compare them too */
+    if (memcmp( ce->hostfac, HOSTREGS->facility_list, STFL_HERC_BY_SIZE ) != 0)
+        return false;
+
+    if (ce->sie_fld)
+    {
+        FETCH_FW( fld, STATEBK->fld );
+        if (memcmp( ce->fldfac, &regs->mainstor[ fld ], STFL_HERC_BY_SIZE ) != 0)
+            return false;
+    }
+
+    memcpy( GUESTREGS->facility_list, ce->facility_list, STFL_HERC_BY_SIZE );
+
+#endif /* defined( FEATURE_VIRTUAL_ARCHITECTURE_LEVEL ) */
+
+    GUESTREGS->mainstor  = ce->mainstor;
+    GUESTREGS->storkeys  = ce->storkeys;
+    GUESTREGS->mainlim   = ce->mainlim;
+    GUESTREGS->sie_mso   = ce->sie_mso;
+    GUESTREGS->sie_xso   = ce->sie_xso;
+    GUESTREGS->sie_xsl   = ce->sie_xsl;
+    GUESTREGS->sie_rcpo  = ce->sie_rcpo;
+    GUESTREGS->sie_scao  = ce->sie_scao;
+    GUESTREGS->sie_pref  = ce->sie_pref;
+    GUESTREGS->sie_fld   = ce->sie_fld;
+
+    ce->hits++;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*   Save the freshly decoded and validated state in the cache       */
+/*-------------------------------------------------------------------*/
+static void ARCH_DEP( sie_cache_update )( REGS* regs )
+{
+    SIECACHE*  sc  = GUESTREGS->siecache;
+    SIECENT*   ce;
+#if defined( FEATURE_VIRTUAL_ARCHITECTURE_LEVEL )
+    U32        fld;
+#endif
+
+    if (!sc || !sc->keylen)
+        return;
+
+    ce = sc->cur;
+
+    ce->keylen = sc->keylen;
+    memcpy( ce->key, sc->key, sc->keylen );
+
+#if defined( FEATURE_VIRTUAL_ARCHITECTURE_LEVEL )
+    memcpy( ce->hostfac, HOSTREGS->facility_list, STFL_HERC_BY_SIZE );
+    if (GUESTREGS->sie_fld)
+    {
+        FETCH_FW( fld, STATEBK->fld );
+        memcpy( ce->fldfac, &regs->mainstor[ fld ], STFL_HERC_BY_SIZE );
+    }
+    memcpy( ce->facility_list, GUESTREGS->facility_list, STFL_HERC_BY_SIZE );
+#endif
+
+    ce->mainstor  = GUESTREGS->mainstor;
+    ce->storkeys  = GUESTREGS->storkeys;
+    ce->mainlim   = GUESTREGS->mainlim;
+    ce->sie_mso   = GUESTREGS->sie_mso;
+    ce->sie_xso   = GUESTREGS->sie_xso;
+    ce->sie_xsl   = GUESTREGS->sie_xsl;
+    ce->sie_rcpo  = GUESTREGS->sie_rcpo;
+    ce->sie_scao  = GUESTREGS->sie_scao;
+    ce->sie_pref  = GUESTREGS->sie_pref;
+    ce->sie_fld   = GUESTREGS->sie_fld;
+}
+
 /*-------------------------------------------------------------------*/
 /* B214 SIE   - Start Interpretive Execution                     [S] */
 /*-------------------------------------------------------------------*/
@@ -315,6 +509,7 @@ int lpsw_xcode;                         /* xcode from load_psw       */
 volatile int icode = 0;                 /* interrupt code            */
                                         /* (why is this volatile?!)  */
 bool    same_cpu, same_state;           /* boolean helper flags      */
+bool    sie_cached;                     /* decoded state was reused  */
 U64     dreg;
 
 #if defined( FEATURE_VIRTUAL_ARCHITECTURE_LEVEL )
@@ -414,6 +609,10 @@ int     i;                              /* (work)                    */
         }
         cpu_init( regs->cpuad, GUESTREGS, regs );
         TXF_ALLOCMAP( GUESTREGS );
+
+        /* (the SIE state cache is optional; run without it if
+           it can't be obtained) */
+        GUESTREGS->siecache = calloc( 1, sizeof( SIECACHE ));
     }
 
     /* Direct pointer to state descriptor block */
@@ -468,6 +667,11 @@ int     i;                              /* (work)                    */
        since prefix is always a FWORD regardless of architecture) */
     FETCH_FW( GUESTREGS->PX_L, STATEBK->prefix );
 
+    /* Reuse the previously decoded storage and facility state
+       if nothing it was decoded from has changed since then */
+    if ((sie_cached = ARCH_DEP( sie_cache_lookup )( regs, effective_addr2 )))
+        goto sie_state_loaded;
+
 #if defined( FEATURE_REGION_RELOCATE )
 
     if (STATEBK->mx & SIE_MX_RRF)
@@ -697,6 +901,11 @@ int     i;                              /* (work)                    */
     }
 #endif
 
+    /* Remember the decoded state for the next dispatch */
+    ARCH_DEP( sie_cache_update )( regs );
+
+sie_state_loaded:
+
     /* Load the CPU timer */
     FETCH_DW( dreg, STATEBK->cputimer );
     set_cpu_timer( GUESTREGS, dreg );
@@ -763,14 +972,25 @@ int     i;                              /* (work)                    */
     }
 #else // defined( OPTION_SIE_PURGE_DAT_ALWAYS )
     /*
-     *   ALWAYS purge guest TLB entries (Ivan 2016-07-30)
+     *   ALWAYS purge guest TLB entries (Ivan 2016-07-30), unless
+     *   the SIE state cache is enabled and shows this very state
+     *   descriptor, unchanged, was the last one this CPU ran.
+     *   Host purges are propagated to GUESTREGS regardless.
      */
-    switch (GUESTREGS->arch_mode)
+    if (sie_cached && same_cpu && same_state)
+    {
+        SIE_PERFMON( SIE_PERF_ENTER_F );
+        GUESTREGS->siecache->cur->tlbkept++;
+    }
+    else
     {
-    case ARCH_370_IDX: s370_purge_tlb( GUESTREGS );                              break;
-    case ARCH_390_IDX: s390_purge_tlb( GUESTREGS ); s390_purge_alb( GUESTREGS ); break;
-    case ARCH_900_IDX: z900_purge_tlb( GUESTREGS ); z900_purge_alb( GUESTREGS ); break;
-    default: CRASH();
+        switch (GUESTREGS->arch_mode)
+        {
+        case ARCH_370_IDX: s370_purge_tlb( GUESTREGS );                              break;
+        case ARCH_390_IDX: s390_purge_tlb( GUESTREGS ); s390_purge_alb( GUESTREGS ); break;
+        case ARCH_900_IDX: z900_purge_tlb( GUESTREGS ); z900_purge_alb( GUESTREGS ); break;
+        default: CRASH();
+        }
     }
 #endif // defined( OPTION_SIE_PURGE_DAT_ALWAYS )
 
@@ -925,6 +1145,10 @@ int     i;                              /* (work)                    */
     ARCH_DEP( sie_exit )( regs, icode );
     PTT_SIE( "SIE < sie_exit", 0, 0, 0 );
 
+    /* Count the interception against this state descriptor */
+    if (GUESTREGS->siecache)
+        GUESTREGS->siecache->cur->codes[ MIN( STATEBK->c >> 2, SIE_CACHE_CODES-1 )]++;
+
     /* Perform serialization and checkpoint synchronization */
     PERFORM_SERIALIZATION( regs );
     PERFORM_CHKPT_SYNC( regs );
@@ -112,7 +112,7 @@ BYTE     psw[16];
             {
                 sysblk.regs[i]->cpustate = CPUSTATE_STOPPING;
                 ON_IC_INTERRUPT(sysblk.regs[i]);
-                signal_condition(&sysblk.regs[i]->intcond);
+                WAKEUP_CPU(sysblk.regs[i]);
             }
         }
         RELEASE_INTLOCK(NULL);
@@ -186,7 +186,7 @@ BYTE     psw[16];
     SR_WRITE_VALUE (file,SR_SYS_MBM,sysblk.mbm,sizeof(sysblk.mbm));
     SR_WRITE_VALUE (file,SR_SYS_MBD,sysblk.mbd,sizeof(sysblk.mbd));
 
-    for (ioq = sysblk.iointq; ioq; ioq = ioq->next)
+    for (ioq = NEXT_IO_INTERRUPT_QLOCKED( NULL ); ioq; ioq = NEXT_IO_INTERRUPT_QLOCKED( ioq ))
         if (ioq->pcipending)
         {
             SR_WRITE_VALUE(file,SR_SYS_PCIPENDING_LCSS, SSID_TO_LCSS(ioq->dev->ssid),sizeof(U16));
@@ -379,7 +379,6 @@ int      devargc=0;
 char    *devargv[16];
 int      devargx=0;
 DEVBLK  *dev = NULL;
-IOINT   *ioq = NULL;
 char     buf[SR_MAX_STRING_LENGTH+1];
 char     zeros[16];
 S64      dreg;
@@ -612,11 +611,7 @@ int      numconfdev=0;
             SR_READ_VALUE(file, len, &hw, sizeof(hw));
             dev = find_device_by_devnum(lcss,hw);
             if (dev == NULL) break;
-            if (ioq == NULL)
-                sysblk.iointq = &dev->ioint;
-            else
-                ioq->next = &dev->ioint;
-            ioq = &dev->ioint;
+            QUEUE_IO_INTERRUPT( &dev->ioint, FALSE );
             dev = NULL;
             lcss = 0;
             break;
@@ -629,11 +624,7 @@ int      numconfdev=0;
             SR_READ_VALUE(file, len, &hw, sizeof(hw));
             dev = find_device_by_devnum(lcss,hw);
             if (dev == NULL) break;
-            if (ioq == NULL)
-                sysblk.iointq = &dev->pciioint;
-            else
-                ioq->next = &dev->pciioint;
-            ioq = &dev->pciioint;
+            QUEUE_IO_INTERRUPT( &dev->pciioint, FALSE );
             dev = NULL;
             lcss = 0;
             break;
@@ -646,11 +637,7 @@ int      numconfdev=0;
             SR_READ_VALUE(file, len, &hw, sizeof(hw));
             dev = find_device_by_devnum(lcss,hw);
             if (dev == NULL) break;
-            if (ioq == NULL)
-                sysblk.iointq = &dev->attnioint;
-            else
-                ioq->next = &dev->attnioint;
-            ioq = &dev->attnioint;
+            QUEUE_IO_INTERRUPT( &dev->attnioint, FALSE );
             dev = NULL;
             lcss = 0;
             break;
@@ -1247,6 +1247,8 @@ PARSER  ptab  [] =
     { "rw",         NULL },
     { "ring",       NULL },
     { "deonirq",    "%d" },
+    { "stream",     "%d" },
+    { "cthreads",   "%d" },
     { "noautomount",NULL },
     { "--blkid-22", NULL },
     { "--blkid-24", NULL },   /* (synonym for --blkid-22) */
@@ -1282,6 +1284,8 @@ enum
     TDPARM_RW,
     TDPARM_RING,
     TDPARM_DEONIRQ,
+    TDPARM_STREAM,
+    TDPARM_CTHREADS,
     TDPARM_NOAUTOMOUNT,
     TDPARM_BLKID22,
     TDPARM_BLKID24,
@@ -1307,6 +1311,16 @@ enum
 /*                     compressed HET tapes while it is not on       */
 /*                     IDRC formated 3480 tapes)                     */
 /*                                                                   */
+/*    stream           0-64: Read this many blocks ahead and write   */
+/*                     this many behind on a helper thread (0=off).  */
+/*                     AWS, HET and FAKETAPE files only.             */
+/*                                                                   */
+/*    method           1-3: HET compression method: 1=zlib, 2=bzip2, */
+/*                     3=zstd.  zstd allows level=1-19.              */
+/*                                                                   */
+/*    cthreads         0-64: Compress HET blocks on this many        */
+/*                     threads (0=compress on the CCW thread).       */
+/*                                                                   */
 /*    --no-erg         for SCSI tape only, means the hardware does   */
 /*                     not support the "Erase Gap" command and all   */
 /*                     such i/o's should return 'success' instead.   */
@@ -1385,6 +1399,8 @@ int  mountnewtape ( DEVBLK *dev, int argc, char **argv )
     dev->tdparms.method    = HETDFLT_METHOD;
     dev->tdparms.level     = HETDFLT_LEVEL;
     dev->tdparms.chksize   = HETDFLT_CHKSIZE;
+    dev->tdparms.stream    = 0;        // no streaming    (default)
+    dev->tdparms.cthreads  = 0;        // no comp threads (default)
     dev->tdparms.maxsize   = 0;        // no max size     (default)
     dev->eotmargin         = 128*1024; // 128K EOT margin (default)
     dev->tdparms.logical_readonly = 0; // read/write      (default)
@@ -1465,6 +1481,13 @@ int  mountnewtape ( DEVBLK *dev, int argc, char **argv )
                 optrc = -1;
                 break;
             }
+            if (!HET_METHOD_OK( res.num ))
+            {
+                // "%1d:%04X Tape file '%s', type '%s': option '%s' rejected: '%s'"
+                WRMSG(HHC00223, "E", LCSS_DEVNUM, dev->filename, TTYPSTR(dev->tapedevt), argv[i], "method not supported by this build");
+                optrc = -1;
+                break;
+            }
             dev->tdparms.method = res.num;
             break;
 
@@ -1477,7 +1500,11 @@ int  mountnewtape ( DEVBLK *dev, int argc, char **argv )
                 // "%1d:%04X Tape file '%s', type '%s': option '%s' rejected: '%s'"
                _HHC00223E(); optrc = -1; break;
             }
+#if defined( HAVE_ZSTD )
+            if (res.num < HETMIN_LEVEL || res.num > HETMAX_ZSTD_LEVEL)
+#else
             if (res.num < HETMIN_LEVEL || res.num > HETMAX_LEVEL)
+#endif
             {
                 // "%1d:%04X Tape file '%s', type '%s': option '%s' rejected: '%s'"
                 WRMSG(HHC00223, "E", LCSS_DEVNUM, dev->filename, TTYPSTR(dev->tapedevt), argv[i], "level out of range");
@@ -1667,6 +1694,48 @@ int  mountnewtape ( DEVBLK *dev, int argc, char **argv )
             dev->tdparms.deonirq=(res.num ? 1 : 0 );
             break;
 
+        case TDPARM_STREAM:
+#if defined( _MSVC_ )
+            if (1)
+#else
+            if (0
+                || TAPEDEVT_SCSITAPE == dev->tapedevt
+                || TAPEDEVT_OMATAPE  == dev->tapedevt
+            )
+#endif
+            {
+                // "%1d:%04X Tape file '%s', type '%s': option '%s' rejected: '%s'"
+                _HHC00223E(); optrc = -1; break;
+            }
+            if (res.num > TAPESTRM_MAXDEPTH)
+            {
+                // "%1d:%04X Tape file '%s', type '%s': option '%s' rejected: '%s'"
+                WRMSG(HHC00223, "E", LCSS_DEVNUM, dev->filename, TTYPSTR(dev->tapedevt), argv[i], "stream depth out of range");
+                optrc = -1;
+                break;
+            }
+            dev->tdparms.stream = res.num;
+            break;
+
+        case TDPARM_CTHREADS:
+            if (0
+                || TAPEDEVT_SCSITAPE == dev->tapedevt
+                || TAPEDEVT_FAKETAPE == dev->tapedevt
+            )
+            {
+                // "%1d:%04X Tape file '%s', type '%s': option '%s' rejected: '%s'"
+                _HHC00223E(); optrc = -1; break;
+            }
+            if (res.num > HETMAX_THREADS)
+            {
+                // "%1d:%04X Tape file '%s', type '%s': option '%s' rejected: '%s'"
+                WRMSG(HHC00223, "E", LCSS_DEVNUM, dev->filename, TTYPSTR(dev->tapedevt), argv[i], "cthreads out of range");
+                optrc = -1;
+                break;
+            }
+            dev->tdparms.cthreads = res.num;
+            break;
+
         case TDPARM_NOAUTOMOUNT:
             if (TAPEDEVT_SCSITAPE == dev->tapedevt)
             {
@@ -1733,6 +1802,14 @@ int  mountnewtape ( DEVBLK *dev, int argc, char **argv )
 
     } // end for (i = 1; i < argc; i++)
 
+    /* The level must suit the method, whichever of them came first */
+    if (0 == rc && dev->tdparms.level > HETMAX_METHOD_LEVEL( dev->tdparms.method ))
+    {
+        // "%1d:%04X Tape file '%s', type '%s': option '%s' rejected: '%s'"
+        WRMSG(HHC00223, "E", LCSS_DEVNUM, dev->filename, TTYPSTR(dev->tapedevt), "level", "level out of range for method");
+        rc = -1;
+    }
+
     if (0 != rc)
     {
         if (lock_obtained) // (release lock only if WE obtained it)
@@ -1914,12 +1991,16 @@ static void tapedev_query_device ( DEVBLK *dev, char **devclass, int buflen, cha
         {
             // Not a SCSI tape,  -or-  mounted SCSI tape...
 
-            snprintf( buffer, buflen, "%s%s %s%s%s IO[%"PRIu64"]",
+            char strm[128];
+
+            tapestrm_query( dev, strm, sizeof( strm ));
+
+            snprintf( buffer, buflen, "%s%s %s%s%s IO[%"PRIu64"]%s",
                 devparms, (dev->readonly ? " ro" : ""),
                 tapepos,
                 dev->tdparms.displayfeat ? "Display: " : "",
                 dev->tdparms.displayfeat ?  dispmsg    : "",
-                dev->excps );
+                dev->excps, strm );
             buffer[buflen-1] = '\0';
         }
         else /* ( TAPEDEVT_SCSITAPE == dev->tapedevt && STS_NOT_MOUNTED(dev) ) */
@@ -2835,6 +2916,142 @@ int readblkid_virtual ( DEVBLK* dev, BYTE* logical, BYTE* physical )
     return 0;
 }
 
+/*-------------------------------------------------------------------*/
+/* Block index for AWSTAPE and FAKETAPE files                        */
+/*                                                                   */
+/* Entry n holds the offset of block n and the number of the file    */
+/* it is in.  Entries are added as blocks are read, written or       */
+/* spaced over going forward, so the index always covers blocks 0    */
+/* to tapeidxcnt-1 without gaps and Locate Block, FSF and BSF can    */
+/* position directly to any block already passed instead of spacing  */
+/* over every block in between.  Writing a block discards the        */
+/* entries of the blocks it overwrote.  HET files are indexed by     */
+/* hetlib itself.                                                    */
+/*-------------------------------------------------------------------*/
+void tapeidx_note( DEVBLK* dev, bool tapemark, bool written )
+{
+    TAPEIDX*  idx  = dev->tapeidx;
+    TAPEIDX*  tidx;
+
+    /* Create the index once the first block has been passed */
+    if (!idx)
+    {
+        if (dev->blockid != 1)
+            return;
+
+        if (!(idx = malloc( TAPEIDX_INIT * sizeof( TAPEIDX ))))
+            return;
+
+        idx[0].blkpos   = 0;
+        idx[0].filen    = 1;
+        dev->tapeidx    = idx;
+        dev->tapeidxcnt = 1;
+        dev->tapeidxmax = TAPEIDX_INIT;
+    }
+
+    /* Blocks after one just written no longer exist */
+    if (written && dev->tapeidxcnt > dev->blockid)
+        dev->tapeidxcnt = dev->blockid;
+
+    /* Only a block just past the end of the index is of interest */
+    if (dev->blockid != dev->tapeidxcnt)
+        return;
+
+    if (dev->tapeidxcnt == dev->tapeidxmax)
+    {
+        if (!(tidx = realloc( idx, 2 * dev->tapeidxmax * sizeof( TAPEIDX ))))
+            return;
+        dev->tapeidx     = idx = tidx;
+        dev->tapeidxmax *= 2;
+    }
+
+    idx[ dev->tapeidxcnt ].blkpos = dev->nxtblkpos;
+    idx[ dev->tapeidxcnt ].filen  = idx[ dev->tapeidxcnt - 1 ].filen
+                                  + (tapemark ? 1 : 0);
+    dev->tapeidxcnt++;
+}
+
+/*-------------------------------------------------------------------*/
+/* Position directly to an indexed block; false if not indexed       */
+/*-------------------------------------------------------------------*/
+bool tapeidx_seek( DEVBLK* dev, U32 blockid )
+{
+    TAPEIDX*  idx  = dev->tapeidx;
+
+    if (blockid >= dev->tapeidxcnt)
+        return false;
+
+    dev->nxtblkpos = idx[ blockid ].blkpos;
+    dev->prvblkpos = blockid ? idx[ blockid - 1 ].blkpos : -1;
+    dev->curfilen  = idx[ blockid ].filen;
+    dev->blockid   = blockid;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/* Forward space file using the index.  Returns 1 if positioned      */
+/* after the next tapemark, 0 if there is none in the index and the  */
+/* tape is positioned at the highest indexed block instead, or -1    */
+/* if the current block is not indexed.                              */
+/*-------------------------------------------------------------------*/
+int tapeidx_fsf( DEVBLK* dev )
+{
+    TAPEIDX*  idx  = dev->tapeidx;
+    U32       blk;
+
+    if (dev->blockid >= dev->tapeidxcnt)
+        return -1;
+
+    for (blk = dev->blockid + 1; blk < dev->tapeidxcnt; blk++)
+    {
+        if (idx[ blk ].filen != idx[ blk - 1 ].filen)
+        {
+            tapeidx_seek( dev, blk );
+            return 1;
+        }
+    }
+
+    tapeidx_seek( dev, dev->tapeidxcnt - 1 );
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* Backspace file using the index.  Returns 1 if positioned before   */
+/* the previous tapemark, 0 if there is none and the tape is now at  */
+/* load point, or -1 if the current block is not indexed.            */
+/*-------------------------------------------------------------------*/
+int tapeidx_bsf( DEVBLK* dev )
+{
+    TAPEIDX*  idx  = dev->tapeidx;
+    U32       blk;
+
+    if (dev->blockid >= dev->tapeidxcnt)
+        return -1;
+
+    for (blk = dev->blockid; blk > 0; blk--)
+    {
+        if (idx[ blk ].filen != idx[ blk - 1 ].filen)
+        {
+            tapeidx_seek( dev, blk - 1 );
+            return 1;
+        }
+    }
+
+    tapeidx_seek( dev, 0 );
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* Discard the block index when the tape file is closed              */
+/*-------------------------------------------------------------------*/
+void tapeidx_free( DEVBLK* dev )
+{
+    free( dev->tapeidx );
+    dev->tapeidx    = NULL;
+    dev->tapeidxcnt = 0;
+    dev->tapeidxmax = 0;
+}
+
 /*-------------------------------------------------------------------*/
 /* locateblk_virtual                                                 */
 /*-------------------------------------------------------------------*/
@@ -2845,8 +3062,9 @@ int locateblk_virtual ( DEVBLK* dev, U32 blockid, BYTE *unitstat, BYTE code )
     int rc;
     bool is_het = (dev->tmh == &tmh_het);
 
-    /* Do it the hard way: rewind to load-point and then
-       keep doing fsb, fsb, fsb... until we find our block
+    /* Rewind to load-point, go straight to the block if it is in
+       the block index or else to the highest block that is, and
+       then keep doing fsb, fsb, fsb... until we find our block
     */
     if ((rc = dev->tmh->rewind( dev, unitstat, code)) >= 0)
     {
@@ -2859,11 +3077,31 @@ int locateblk_virtual ( DEVBLK* dev, U32 blockid, BYTE *unitstat, BYTE code )
         /* Keep doing fsb until we find our block... */
         if (!is_het)
         {
+            if (dev->tapeidxcnt)
+                tapeidx_seek( dev, MIN( blockid, dev->tapeidxcnt - 1 ));
+
             while (dev->blockid < blockid && (rc >= 0))
                 rc = dev->tmh->fsb( dev, unitstat, code );
         }
         else // (special handling for .HET files...)
         {
+            obtain_lock( &dev->lock );
+            {
+                if (dev->hetb && dev->hetb->idxcnt)
+                {
+                    U32  blk  = MIN( blockid, dev->hetb->idxcnt - 1 );
+
+                    if ((rc = het_locate( dev->hetb, blk )) >= 0)
+                    {
+                        dev->blockid  = blk;
+                        dev->curfilen = 1 + het_tapemarks( dev->hetb, blk );
+                    }
+                    else
+                        build_senseX( TAPE_BSENSE_LOCATEERR, dev, unitstat, code );
+                }
+            }
+            release_lock( &dev->lock );
+
             while (1)
             {
                 // PROGRAMMING NOTE: We need dev->lock to prevent
@@ -2947,3 +3185,902 @@ int generic_tmhcall ( GENTMH_PARMS* pGenParms )
 
     UNREACHABLE_CODE( return -1 );
 }
+
+/*-------------------------------------------------------------------*/
+/*            Read-ahead / write-behind streaming engine             */
+/*-------------------------------------------------------------------*/
+/* With the "stream=n" option a helper thread keeps the drive        */
+/* streaming while the guest is busy with the previous block:        */
+/*                                                                   */
+/* AWSTAPE/FAKETAPE: the file is read through two windows of n*64K.  */
+/* While the handler picks blocks out of the current window the      */
+/* helper reads the next one.  Writes are gathered into a buffer of  */
+/* the same size which the helper writes out while the next one      */
+/* fills, and the new physical end of file is set once per flush     */
+/* instead of once per block.                                        */
+/*                                                                   */
+/* HETTAPE: the helper reads and decompresses up to n blocks ahead   */
+/* of the guest, or compresses and writes up to n queued blocks.     */
+/*                                                                   */
+/* Read-ahead never changes what the guest sees: a block the helper  */
+/* could not read is read again by the handler itself, which then    */
+/* reports the error exactly as it always has.  Written data is      */
+/* flushed at tapemarks, Synchronize, rewind/unload and before any   */
+/* other tape motion, as with a real drive in buffered write mode,   */
+/* and a write error found by the helper is presented on the next    */
+/* tape operation as a deferred unit check.                          */
+/*-------------------------------------------------------------------*/
+
+static U64 strm_usecs()
+{
+    struct timeval  tv;
+
+    gettimeofday( &tv, NULL );
+    return ((U64) tv.tv_sec * 1000000) + tv.tv_usec;
+}
+
+static const char* strm_type( DEVBLK* dev )
+{
+    return TAPEDEVT_HETTAPE  == dev->tapedevt ? "het"
+         : TAPEDEVT_FAKETAPE == dev->tapedevt ? "fake" : "aws";
+}
+
+/* Account for a transfer in the statistics shown by devlist */
+static void strm_count( U64* bytes, U64* first, U64* last, U32 len )
+{
+    *last = strm_usecs();
+    if (!*first)
+        *first = *last;
+    *bytes += len;
+}
+
+/* pread/pwrite the whole length unless end of file or an error */
+static ssize_t strm_pread_full( int fd, BYTE* buf, U32 len, off_t pos )
+{
+    ssize_t  n, done = 0;
+
+#if defined( _MSVC_ )
+    /* (never called: "stream=" is rejected without pread/pwrite) */
+    UNREFERENCED( fd ); UNREFERENCED( buf ); UNREFERENCED( len ); UNREFERENCED( pos );
+    UNREFERENCED( n );
+    errno = ENOSYS;
+    return -1;
+#endif
+
+    while (done < (ssize_t) len)
+    {
+        if ((n = pread( fd, buf + done, len - done, pos + done )) < 0)
+        {
+            if (EINTR == errno)
+                continue;
+            return -1;
+        }
+        if (!n)
+            break;
+        done += n;
+    }
+    return done;
+}
+
+static ssize_t strm_pwrite_full( int fd, const BYTE* buf, U32 len, off_t pos )
+{
+    ssize_t  n, done = 0;
+
+#if defined( _MSVC_ )
+    UNREFERENCED( fd ); UNREFERENCED( buf ); UNREFERENCED( len ); UNREFERENCED( pos );
+    UNREFERENCED( n );
+    errno = ENOSYS;
+    return -1;
+#endif
+
+    while (done < (ssize_t) len)
+    {
+        if ((n = pwrite( fd, buf + done, len - done, pos + done )) < 0)
+        {
+            if (EINTR == errno)
+                continue;
+            return -1;
+        }
+        done += n;
+    }
+    return done;
+}
+
+/* Remember the first write error for the next tape operation */
+static void strm_werror( TAPESTRM* s, int err, off_t pos, int hetrc )
+{
+    if (!s->werr)
+    {
+        s->werr    = true;
+        s->werrno  = err;
+        s->werrpos = pos;
+        s->hetrc   = hetrc;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/* The helper thread                                                 */
+/*-------------------------------------------------------------------*/
+static void* tapestrm_thread( void* arg )
+{
+    DEVBLK*    dev = arg;
+    TAPESTRM*  s   = dev->tapestrm;
+    ssize_t    n;
+    BYTE*      buf;
+    int        slot;
+    int        rc;
+
+    obtain_lock( &s->lock );
+
+    while (!s->stop)
+    {
+        if (TAPESTRM_IDLE == s->job)
+        {
+            wait_condition( &s->cond, &s->lock );
+            continue;
+        }
+
+        s->busy = true;
+
+        switch (s->job)
+        {
+        case TAPESTRM_FILL:
+
+            release_lock( &s->lock );
+            n = strm_pread_full( dev->fd, s->rnxt, s->winsize, s->rnxtpos );
+            obtain_lock( &s->lock );
+
+            /* (on error the handler will read it again itself) */
+            s->rnxtlen = (int) n;
+            break;
+
+        case TAPESTRM_WRITE:
+
+            release_lock( &s->lock );
+            n = strm_pwrite_full( dev->fd, s->wfly, s->wflylen, s->wflypos );
+            obtain_lock( &s->lock );
+
+            if (n < 0)
+                strm_werror( s, errno, s->wflypos, 0 );
+            s->wflylen = 0;
+            break;
+
+        case TAPESTRM_HETREAD:
+
+            /* Keep going until the ring is full or we are cancelled */
+            while (!s->stop && TAPESTRM_HETREAD == s->job
+                && s->count < s->depth)
+            {
+                slot = (s->head + s->count) % s->depth;
+                buf  = s->ring[ slot ];
+
+                release_lock( &s->lock );
+                if (!buf)
+                    buf = malloc( HETMAX_BLOCKSIZE );
+                rc = buf ? het_read( dev->hetb, buf ) : HETE_NOMEM;
+                obtain_lock( &s->lock );
+
+                s->ring[ slot ] = buf;
+
+                /* Leave errors for the handler to run into itself */
+                if (rc < 0 && HETE_TAPEMARK != rc)
+                {
+                    s->hetstop = true;
+                    break;
+                }
+
+                s->ringlen[ slot ] = rc;
+                s->count++;
+                broadcast_condition( &s->cond );
+            }
+            break;
+
+        case TAPESTRM_HETWRITE:
+
+            /* Write until the guest stops giving us blocks */
+            while (s->count)
+            {
+                slot = s->head;
+
+                release_lock( &s->lock );
+                rc = s->werr ? 0 : het_write( dev->hetb, s->ring[ slot ],
+                                              s->ringlen[ slot ] );
+                obtain_lock( &s->lock );
+
+                /* (blocks queued after an error are discarded) */
+                if (rc < 0)
+                    strm_werror( s, errno, (off_t) dev->hetb->cblk, rc );
+
+                s->head = (s->head + 1) % s->depth;
+                s->count--;
+                broadcast_condition( &s->cond );
+            }
+            break;
+        }
+
+        s->job  = TAPESTRM_IDLE;
+        s->busy = false;
+        broadcast_condition( &s->cond );
+    }
+
+    release_lock( &s->lock );
+    return NULL;
+}
+
+/* Wait for the helper to finish its job (lock held) */
+static void strm_wait( TAPESTRM* s )
+{
+    while (s->busy || TAPESTRM_IDLE != s->job)
+        wait_condition( &s->cond, &s->lock );
+}
+
+/* Wait for the helper to finish writing (lock held) */
+static void strm_wait_writes( TAPESTRM* s )
+{
+    while (TAPESTRM_WRITE == s->job || TAPESTRM_HETWRITE == s->job)
+        wait_condition( &s->cond, &s->lock );
+}
+
+/* Give the helper a job (lock held, helper idle) */
+static void strm_kick( TAPESTRM* s, int job )
+{
+    s->job = job;
+    broadcast_condition( &s->cond );
+}
+
+/*-------------------------------------------------------------------*/
+/* Create the engine when a tape file is opened with "stream=n"      */
+/*-------------------------------------------------------------------*/
+void tapestrm_open( DEVBLK* dev )
+{
+    TAPESTRM*  s;
+    char       thread_name[16];
+    int        rc;
+
+    /* Never carry windows over from a previous tape */
+    tapestrm_close( dev );
+
+    if (!dev->tdparms.stream)
+        return;
+
+    /* A size limit on a HET file needs the compressed size of each
+       block as soon as it is written, so such files are unbuffered */
+    if (TAPEDEVT_HETTAPE == dev->tapedevt && dev->tdparms.maxsize > 0)
+        return;
+
+    if (!(s = calloc( 1, sizeof( TAPESTRM ))))
+        return;
+
+    s->depth   = dev->tdparms.stream;
+    s->rcurlen = -1;
+    s->rnxtlen = -1;
+    s->weof    = -1;
+
+    if (TAPEDEVT_HETTAPE == dev->tapedevt)
+    {
+        s->ring    = calloc( s->depth, sizeof( BYTE* ));
+        s->ringlen = calloc( s->depth, sizeof( int ));
+        rc = (s->ring && s->ringlen) ? 0 : -1;
+    }
+    else
+    {
+        s->winsize = s->depth * TAPESTRM_SLOTSIZE;
+        s->rcur    = malloc( s->winsize );
+        s->rnxt    = malloc( s->winsize );
+        s->wcur    = malloc( s->winsize );
+        s->wfly    = malloc( s->winsize );
+        rc = (s->rcur && s->rnxt && s->wcur && s->wfly) ? 0 : -1;
+    }
+
+    if (rc < 0)
+    {
+        free( s->ring ); free( s->ringlen );
+        free( s->rcur ); free( s->rnxt  );
+        free( s->wcur ); free( s->wfly  );
+        free( s );
+        return;
+    }
+
+    initialize_lock( &s->lock );
+    initialize_condition( &s->cond );
+    dev->tapestrm = s;
+
+    MSGBUF( thread_name, "tapestrm %1d:%04X", LCSS_DEVNUM );
+    rc = create_thread( &s->tid, JOINABLE, tapestrm_thread, dev, thread_name );
+    if (rc)
+    {
+        // "Error in function create_thread(): %s"
+        WRMSG( HHC00102, "E", strerror( rc ));
+        dev->tapestrm = NULL;
+        destroy_condition( &s->cond );
+        destroy_lock( &s->lock );
+        free( s->ring ); free( s->ringlen );
+        free( s->rcur ); free( s->rnxt  );
+        free( s->wcur ); free( s->wfly  );
+        free( s );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/* Write out everything still buffered (lock held)                   */
+/*                                                                   */
+/* Only the helper's writing is waited for; read-ahead carries on.   */
+/*-------------------------------------------------------------------*/
+static void strm_drain( DEVBLK* dev )
+{
+    TAPESTRM*  s = dev->tapestrm;
+    ssize_t    n;
+    int        rc;
+
+    if (!s->writing && !s->wcurlen && !s->wflylen && s->weof < 0)
+        return;
+
+    /* HET: the helper writes until the ring is empty */
+    if (s->writing)
+    {
+        strm_wait_writes( s );
+        s->writing = false;
+        return;
+    }
+
+    /* AWSTAPE/FAKETAPE: finish the in-flight buffer, then this one */
+    strm_wait_writes( s );
+
+    if (s->wcurlen)
+    {
+        n = strm_pwrite_full( dev->fd, s->wcur, s->wcurlen, s->wcurpos );
+        if (n < 0)
+            strm_werror( s, errno, s->wcurpos, 0 );
+        s->wcurlen = 0;
+    }
+
+    if (s->weof >= 0)
+    {
+        do rc = ftruncate( dev->fd, s->weof );
+        while (rc < 0 && EINTR == errno);
+
+        if (rc < 0)
+            strm_werror( s, errno, s->weof, 0 );
+        s->weof = -1;
+    }
+}
+
+/* Report a deferred write error, returning -1 if there was one */
+static int strm_report( DEVBLK* dev )
+{
+    TAPESTRM*  s = dev->tapestrm;
+    char       msgbuf[128];
+    int        err;
+
+    if (!s->werr)
+        return 0;
+
+    s->werr = false;
+    err     = s->werrno;
+
+    if (s->hetrc)
+    {
+        MSGBUF( msgbuf, "Het error '%s': '%s'", het_error( s->hetrc ), strerror( err ));
+        // "%1d:%04X Tape file %s, type %s: error in function %s, offset 0x%16.16"PRIX64": %s"
+        WRMSG( HHC00204, "E", LCSS_DEVNUM, dev->filename, "het", "het_write()", s->werrpos, msgbuf );
+    }
+    else
+        // "%1d:%04X Tape file %s, type %s: error in function %s, offset 0x%16.16"PRIX64": %s"
+        WRMSG( HHC00204, "E", LCSS_DEVNUM, dev->filename, strm_type( dev ), "write()", s->werrpos, strerror( err ));
+
+    s->hetrc = 0;
+    errno    = err;
+    return -1;
+}
+
+/*-------------------------------------------------------------------*/
+/* Stop the helper thread and discard the engine                     */
+/*-------------------------------------------------------------------*/
+void tapestrm_close( DEVBLK* dev )
+{
+    TAPESTRM*  s = dev->tapestrm;
+    void*      rc;
+    int        i;
+
+    if (!s)
+        return;
+
+    obtain_lock( &s->lock );
+    if (TAPESTRM_HETREAD == s->job)
+        s->job = TAPESTRM_IDLE;
+    strm_drain( dev );
+    strm_report( dev );
+    s->stop = true;
+    broadcast_condition( &s->cond );
+    release_lock( &s->lock );
+
+    join_thread( s->tid, &rc );
+
+    destroy_condition( &s->cond );
+    destroy_lock( &s->lock );
+
+    if (s->ring)
+        for (i=0; i < s->depth; i++)
+            free( s->ring[i] );
+
+    free( s->ring ); free( s->ringlen );
+    free( s->rcur ); free( s->rnxt  );
+    free( s->wcur ); free( s->wfly  );
+    free( s );
+
+    dev->tapestrm = NULL;
+}
+
+/*-------------------------------------------------------------------*/
+/* Write out buffered blocks; presents any deferred write error      */
+/*                                                                   */
+/* Called before reading and by Synchronize.  If a write error was   */
+/* found the return value is -1 and unitstat is set to CE+DE+UC.     */
+/*-------------------------------------------------------------------*/
+int tapestrm_flush( DEVBLK* dev, BYTE* unitstat, BYTE code )
+{
+    TAPESTRM*  s = dev->tapestrm;
+    bool       enospc;
+    int        rc;
+
+    if (!s)
+        return 0;
+
+    obtain_lock( &s->lock );
+    strm_drain( dev );
+    rc = strm_report( dev );
+    enospc = (rc < 0 && ENOSPC == errno);
+    release_lock( &s->lock );
+
+    if (rc < 0)
+        build_senseX( enospc ? TAPE_BSENSE_ENDOFTAPE
+                             : TAPE_BSENSE_WRITEFAIL, dev, unitstat, code );
+    return rc;
+}
+
+/*-------------------------------------------------------------------*/
+/* HETTAPE: stop reading ahead and go back to where the guest is     */
+/*-------------------------------------------------------------------*/
+static int strm_het_discard( DEVBLK* dev )
+{
+    TAPESTRM*  s = dev->tapestrm;
+    bool       ahead;
+
+    obtain_lock( &s->lock );
+    if (TAPESTRM_HETREAD == s->job)
+        s->job = TAPESTRM_IDLE;
+    strm_wait( s );
+    ahead = s->count || s->hetstop;
+    s->count   = 0;
+    s->hetstop = false;
+    release_lock( &s->lock );
+
+    if (ahead && dev->hetb->cblk != s->hetblk)
+        return het_locate( dev->hetb, s->hetblk );
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* Flush and stop HET read-ahead before any other tape operation     */
+/*                                                                   */
+/* The HET file is repositioned to the block the guest reads next.   */
+/* AWSTAPE/FAKETAPE read windows are kept since they stay valid      */
+/* until the file is written.                                        */
+/*-------------------------------------------------------------------*/
+int tapestrm_quiesce( DEVBLK* dev, BYTE* unitstat, BYTE code )
+{
+    TAPESTRM*  s = dev->tapestrm;
+    int        rc;
+
+    if (!s)
+        return 0;
+
+    if (tapestrm_flush( dev, unitstat, code ) < 0)
+        return -1;
+
+    if (s->ring && (rc = strm_het_discard( dev )) < 0)
+    {
+        char msgbuf[128];
+        MSGBUF( msgbuf, "Het error '%s': '%s'", het_error( rc ), strerror( errno ));
+        // "%1d:%04X Tape file %s, type %s: error in function %s, offset 0x%16.16"PRIX64": %s"
+        WRMSG( HHC00204, "E", LCSS_DEVNUM, dev->filename, "het", "het_locate()", (off_t) s->hetblk, msgbuf );
+
+        build_senseX( TAPE_BSENSE_LOCATEERR, dev, unitstat, code );
+        return -1;
+    }
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* AWSTAPE/FAKETAPE: make the read window hold pos (lock held)       */
+/*                                                                   */
+/* Returns 1 if it does, 0 if pos is at or past end of file, or -1   */
+/* with errno set if the file could not be read.                     */
+/*-------------------------------------------------------------------*/
+static int strm_window( DEVBLK* dev, off_t pos, U32 len )
+{
+    TAPESTRM*  s = dev->tapestrm;
+    BYTE*      tmp;
+    ssize_t    n;
+    off_t      start;
+
+    /* Move on to the next window if the helper read (or is still
+       reading) the one that holds pos */
+    if ((s->rnxtlen >= 0 || TAPESTRM_FILL == s->job)
+        && pos >= s->rnxtpos && pos < s->rnxtpos + s->winsize)
+    {
+        if (TAPESTRM_FILL == s->job)
+        {
+            s->rstalls++;
+            strm_wait( s );
+        }
+        if (s->rnxtlen >= 0)
+        {
+            tmp        = s->rcur;
+            s->rcur    = s->rnxt;
+            s->rnxt    = tmp;
+            s->rcurpos = s->rnxtpos;
+            s->rcurlen = s->rnxtlen;
+            s->rnxtlen = -1;
+        }
+    }
+
+    /* Otherwise read it ourselves.  When moving backwards end the
+       window at pos so that backspacing stays within it. */
+    if (s->rcurlen < 0 || pos < s->rcurpos || pos >= s->rcurpos + s->rcurlen)
+    {
+        start = pos;
+        if (s->rcurlen >= 0 && pos < s->rcurpos)
+            start = MAX( 0, pos + (off_t) len - (off_t) s->winsize );
+
+        s->rcurlen = -1;
+        s->rstalls++;
+        if ((n = strm_pread_full( dev->fd, s->rcur, s->winsize, start )) < 0)
+            return -1;
+        s->rcurpos = start;
+        s->rcurlen = (int) n;
+
+        if (pos >= s->rcurpos + s->rcurlen)
+            return 0;
+    }
+
+    /* Have the helper read the window after this one */
+    if ((U32) s->rcurlen == s->winsize && TAPESTRM_IDLE == s->job
+        && !(s->rnxtlen >= 0 && s->rnxtpos == s->rcurpos + s->rcurlen))
+    {
+        s->rnxtpos = s->rcurpos + s->rcurlen;
+        s->rnxtlen = -1;
+        strm_kick( s, TAPESTRM_FILL );
+    }
+    return 1;
+}
+
+/* Copy from a write-behind buffer if it holds all of the data */
+static bool strm_inbuf( const BYTE* wbuf, off_t wpos, U32 wlen,
+                        void* buf, U32 len, off_t pos )
+{
+    if (!wlen || pos < wpos || pos + len > wpos + wlen)
+        return false;
+    memcpy( buf, wbuf + (pos - wpos), len );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/* AWSTAPE/FAKETAPE: read from the file through the read windows     */
+/*                                                                   */
+/* Same results as pread(): the number of bytes read, which is less  */
+/* than len only at end of file, or -1 with errno set.               */
+/*-------------------------------------------------------------------*/
+int tapestrm_pread( DEVBLK* dev, void* buf, U32 len, off_t pos )
+{
+    TAPESTRM*  s    = dev->tapestrm;
+    BYTE*      p    = buf;
+    int        done = 0;
+    int        rc;
+    U32        n;
+
+    obtain_lock( &s->lock );
+
+    /* Data not yet written (typically the previous block header
+       being reread to write the next block) comes straight from
+       the write buffers; anything else needs them on disk first */
+    if (s->wcurlen || s->wflylen || s->weof >= 0)
+    {
+        if (strm_inbuf( s->wcur, s->wcurpos, s->wcurlen, buf, len, pos )
+         || strm_inbuf( s->wfly, s->wflypos, s->wflylen, buf, len, pos ))
+        {
+            release_lock( &s->lock );
+            return (int) len;
+        }
+        strm_drain( dev );
+    }
+
+    while (len)
+    {
+        if (s->rcurlen < 0 || pos < s->rcurpos || pos >= s->rcurpos + s->rcurlen)
+        {
+            if ((rc = strm_window( dev, pos, len )) <= 0)
+            {
+                if (rc < 0 && !done)
+                    done = -1;
+                break;
+            }
+        }
+
+        n = MIN( len, (U32)(s->rcurpos + s->rcurlen - pos) );
+        memcpy( p, s->rcur + (pos - s->rcurpos), n );
+        p    += n;
+        pos  += n;
+        len  -= n;
+        done += n;
+    }
+
+    if (done > 0)
+        strm_count( &s->rbytes, &s->rfirst, &s->rlast, done );
+
+    release_lock( &s->lock );
+    return done;
+}
+
+/* Hand the write buffer to the helper (lock held) */
+static void strm_handoff( TAPESTRM* s )
+{
+    BYTE*  tmp;
+
+    if (s->busy || TAPESTRM_IDLE != s->job)
+    {
+        s->wstalls++;
+        strm_wait( s );
+    }
+
+    tmp        = s->wfly;
+    s->wfly    = s->wcur;
+    s->wcur    = tmp;
+    s->wflypos = s->wcurpos;
+    s->wflylen = s->wcurlen;
+    s->wcurlen = 0;
+
+    strm_kick( s, TAPESTRM_WRITE );
+}
+
+/* Any write makes the read windows stale (lock held) */
+static void strm_drop_reads( TAPESTRM* s )
+{
+    if (TAPESTRM_FILL == s->job)
+        strm_wait( s );
+    s->rcurlen = -1;
+    s->rnxtlen = -1;
+}
+
+/*-------------------------------------------------------------------*/
+/* AWSTAPE/FAKETAPE: write to the file through the write buffers     */
+/*                                                                   */
+/* Same results as pwrite(): len, or -1 with errno set if an earlier */
+/* buffered write failed (the error is reported to the guest now).   */
+/*-------------------------------------------------------------------*/
+int tapestrm_pwrite( DEVBLK* dev, const void* buf, U32 len, off_t pos )
+{
+    TAPESTRM*  s = dev->tapestrm;
+    ssize_t    n;
+
+    obtain_lock( &s->lock );
+
+    if (s->werr)
+    {
+        s->werr = false;
+        errno   = s->werrno;
+        release_lock( &s->lock );
+        return -1;
+    }
+
+    strm_drop_reads( s );
+
+    /* Start a new buffer unless this simply extends the current one */
+    if (s->wcurlen && (pos != s->wcurpos + s->wcurlen
+                    || s->wcurlen + len > s->winsize))
+        strm_handoff( s );
+
+    if (len > s->winsize)
+    {
+        /* (cannot happen with 64K chunks but be safe anyway) */
+        strm_drain( dev );
+        n = strm_pwrite_full( dev->fd, buf, len, pos );
+        release_lock( &s->lock );
+        return n < 0 ? -1 : (int) len;
+    }
+
+    if (!s->wcurlen)
+        s->wcurpos = pos;
+    memcpy( s->wcur + s->wcurlen, buf, len );
+    s->wcurlen += len;
+
+    strm_count( &s->wbytes, &s->wfirst, &s->wlast, len );
+
+    release_lock( &s->lock );
+    return (int) len;
+}
+
+/*-------------------------------------------------------------------*/
+/* AWSTAPE/FAKETAPE: set the new physical end of file when the       */
+/* write buffers are next flushed.  Same results as ftruncate().     */
+/*-------------------------------------------------------------------*/
+int tapestrm_ftruncate( DEVBLK* dev, off_t eof )
+{
+    TAPESTRM*  s = dev->tapestrm;
+
+    obtain_lock( &s->lock );
+
+    if (s->werr)
+    {
+        s->werr = false;
+        errno   = s->werrno;
+        release_lock( &s->lock );
+        return -1;
+    }
+
+    strm_drop_reads( s );
+    s->weof = eof;
+
+    release_lock( &s->lock );
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* HETTAPE: read the next block, decompressed ahead by the helper    */
+/*                                                                   */
+/* Same results as het_read().  When the helper stopped on an error  */
+/* the block is read again here so that the error is the real one.   */
+/*-------------------------------------------------------------------*/
+int tapestrm_het_read( DEVBLK* dev, BYTE* buf )
+{
+    TAPESTRM*  s = dev->tapestrm;
+    int        slot;
+    int        rc;
+
+    obtain_lock( &s->lock );
+
+    /* The helper is idle with nothing read ahead: the HET file is
+       positioned where the guest is, so start reading from there */
+    if (!s->count && !s->hetstop && TAPESTRM_IDLE == s->job)
+    {
+        s->hetblk = dev->hetb->cblk;
+        strm_kick( s, TAPESTRM_HETREAD );
+    }
+
+    if (!s->count && TAPESTRM_HETREAD == s->job)
+    {
+        s->rstalls++;
+        while (!s->count && TAPESTRM_HETREAD == s->job)
+            wait_condition( &s->cond, &s->lock );
+    }
+
+    if (s->count)
+    {
+        slot = s->head;
+        rc   = s->ringlen[ slot ];
+
+        release_lock( &s->lock );
+        if (rc > 0)
+            memcpy( buf, s->ring[ slot ], rc );
+        obtain_lock( &s->lock );
+
+        s->head = (s->head + 1) % s->depth;
+        s->count--;
+        s->hetblk++;
+
+        if (rc > 0)
+            strm_count( &s->rbytes, &s->rfirst, &s->rlast, rc );
+
+        /* Keep the helper going */
+        if (TAPESTRM_IDLE == s->job && !s->hetstop)
+            strm_kick( s, TAPESTRM_HETREAD );
+
+        release_lock( &s->lock );
+        return rc;
+    }
+
+    /* The helper ran into an error: go back and read it ourselves */
+    s->hetstop = false;
+    release_lock( &s->lock );
+
+    if (dev->hetb->cblk != s->hetblk
+        && (rc = het_locate( dev->hetb, s->hetblk )) < 0)
+        return rc;
+
+    return het_read( dev->hetb, buf );
+}
+
+/*-------------------------------------------------------------------*/
+/* HETTAPE: queue a block for the helper to compress and write       */
+/*                                                                   */
+/* Same results as het_write(), except that an error returned may be */
+/* that of an earlier block the helper failed to write.              */
+/*-------------------------------------------------------------------*/
+int tapestrm_het_write( DEVBLK* dev, const BYTE* buf, U32 blklen )
+{
+    TAPESTRM*  s = dev->tapestrm;
+    BYTE*      slotbuf;
+    int        slot;
+    int        rc;
+
+    obtain_lock( &s->lock );
+
+    if (s->werr)
+    {
+        s->werr  = false;
+        errno    = s->werrno;
+        rc       = s->hetrc;
+        s->hetrc = 0;
+        release_lock( &s->lock );
+        return rc;
+    }
+
+    /* Anything read ahead is about to be overwritten */
+    if (!s->writing)
+    {
+        release_lock( &s->lock );
+        if ((rc = strm_het_discard( dev )) < 0)
+            return rc;
+        obtain_lock( &s->lock );
+        s->writing = true;
+    }
+
+    if (s->count == s->depth)
+    {
+        s->wstalls++;
+        while (s->count == s->depth)
+            wait_condition( &s->cond, &s->lock );
+    }
+
+    /* (the helper only touches ring entries head to head+count-1) */
+    slot    = (s->head + s->count) % s->depth;
+    slotbuf = s->ring[ slot ];
+
+    release_lock( &s->lock );
+    if (!slotbuf && !(slotbuf = malloc( HETMAX_BLOCKSIZE )))
+        return HETE_NOMEM;
+    memcpy( slotbuf, buf, blklen );
+    obtain_lock( &s->lock );
+
+    s->ring[ slot ]    = slotbuf;
+    s->ringlen[ slot ] = blklen;
+    s->count++;
+
+    strm_count( &s->wbytes, &s->wfirst, &s->wlast, blklen );
+
+    if (TAPESTRM_IDLE == s->job)
+        strm_kick( s, TAPESTRM_HETWRITE );
+
+    release_lock( &s->lock );
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* Streaming statistics for the devlist command                      */
+/*-------------------------------------------------------------------*/
+void tapestrm_query( DEVBLK* dev, char* buf, size_t bufsz )
+{
+    TAPESTRM*  s = dev->tapestrm;
+    double     rsecs, wsecs;
+
+    if (!dev->tdparms.stream)
+    {
+        buf[0] = 0;
+        return;
+    }
+
+    if (!s)
+    {
+        snprintf( buf, bufsz, " stream=%d", dev->tdparms.stream );
+        return;
+    }
+
+    rsecs = (s->rlast - s->rfirst) / 1000000.0;
+    wsecs = (s->wlast - s->wfirst) / 1000000.0;
+
+    snprintf( buf, bufsz, " stream=%d rd=%.1fMB/s wr=%.1fMB/s stalls=%"PRIu64"/%"PRIu64,
+        s->depth,
+        rsecs > 0 ? s->rbytes / rsecs / (1024 * 1024) : 0.0,
+        wsecs > 0 ? s->wbytes / wsecs / (1024 * 1024) : 0.0,
+        s->rstalls, s->wstalls );
+}
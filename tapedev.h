@@ -446,6 +446,80 @@ typedef struct _OMATAPE_DESC
 }
 OMATAPE_DESC;
 
+/*-------------------------------------------------------------------*/
+/* Block index entry for AWSTAPE and FAKETAPE files                  */
+/*-------------------------------------------------------------------*/
+typedef struct _TAPEIDX
+{
+    off_t   blkpos;                     /* Offset of block header    */
+    U32     filen;                      /* File number of the block  */
+}
+TAPEIDX;
+
+#define TAPEIDX_INIT    1024            /* Initial number of entries */
+
+/*-------------------------------------------------------------------*/
+/* Read-ahead / write-behind streaming engine   ("stream=n" option)  */
+/*                                                                   */
+/* A helper thread per drive reads the next n blocks ahead of the    */
+/* guest and writes (for HET, compresses and writes) the previous n  */
+/* blocks behind it.  AWSTAPE and FAKETAPE files are streamed as     */
+/* windows of raw file data; HET files as whole decompressed blocks. */
+/*-------------------------------------------------------------------*/
+#define TAPESTRM_MAXDEPTH   64          /* Maximum "stream=" value   */
+#define TAPESTRM_SLOTSIZE   _64_KIBIBYTE /* Window bytes per block   */
+
+enum                                    /* Helper thread work        */
+{
+    TAPESTRM_IDLE,                      /* Nothing to do             */
+    TAPESTRM_FILL,                      /* Read next file window     */
+    TAPESTRM_WRITE,                     /* Write in-flight buffer    */
+    TAPESTRM_HETREAD,                   /* Read and expand blocks    */
+    TAPESTRM_HETWRITE                   /* Compress and write blocks */
+};
+
+typedef struct _TAPESTRM
+{
+    LOCK    lock;                       /* Serializes fields below   */
+    COND    cond;                       /* Signalled on any change   */
+    TID     tid;                        /* Helper thread             */
+    int     depth;                      /* Blocks ahead/behind       */
+    int     job;                        /* TAPESTRM_xxxx work        */
+    bool    busy;                       /* Helper is doing the job   */
+    bool    stop;                       /* Helper should exit        */
+
+    /* AWSTAPE and FAKETAPE                                          */
+    U32     winsize;                    /* Size of each window       */
+    BYTE   *rcur, *rnxt;                /* Current/next read window  */
+    off_t   rcurpos, rnxtpos;           /* File offset of windows    */
+    int     rcurlen, rnxtlen;           /* Bytes valid, -1 = none    */
+    BYTE   *wcur, *wfly;                /* Filling/in-flight buffers */
+    off_t   wcurpos, wflypos;           /* File offset of buffers    */
+    U32     wcurlen, wflylen;           /* Bytes in each buffer      */
+    off_t   weof;                       /* Pending new EOF, or -1    */
+
+    /* HETTAPE                                                       */
+    BYTE  **ring;                       /* Block buffers             */
+    int    *ringlen;                    /* Length or het_read rc     */
+    int     head;                       /* Oldest ring entry         */
+    int     count;                      /* Ring entries in use       */
+    bool    writing;                    /* Ring holds blocks to write*/
+    bool    hetstop;                    /* Read-ahead hit an error   */
+    U32     hetblk;                     /* Block of oldest entry     */
+    int     hetrc;                      /* Deferred het_write rc     */
+
+    bool    werr;                       /* Deferred write error      */
+    int     werrno;                     /* ...its errno              */
+    off_t   werrpos;                    /* ...and where it happened  */
+
+    /* Statistics ("devlist")                                        */
+    U64     rbytes, wbytes;             /* Bytes read/written        */
+    U64     rstalls, wstalls;           /* Times guest waited on I/O */
+    U64     rfirst, rlast;              /* Time of first/last read   */
+    U64     wfirst, wlast;              /* Time of first/last write  */
+}
+TAPESTRM;
+
 /*-------------------------------------------------------------------*/
 /* Tape Auto-Loader table entry                                      */
 /*-------------------------------------------------------------------*/
@@ -553,6 +627,21 @@ extern int   write_READONLY         (DEVBLK *dev,                              B
 extern int   no_operation           (DEVBLK *dev,                              BYTE *unitstat, BYTE code);
 extern int   readblkid_virtual      (DEVBLK*, BYTE* logical, BYTE* physical);
 extern int   locateblk_virtual      (DEVBLK*, U32 blockid,                     BYTE *unitstat, BYTE code);
+extern void  tapeidx_note           (DEVBLK *dev, bool tapemark, bool written);
+extern bool  tapeidx_seek           (DEVBLK *dev, U32 blockid);
+extern int   tapeidx_fsf            (DEVBLK *dev);
+extern int   tapeidx_bsf            (DEVBLK *dev);
+extern void  tapeidx_free           (DEVBLK *dev);
+extern void  tapestrm_open          (DEVBLK *dev);
+extern void  tapestrm_close         (DEVBLK *dev);
+extern int   tapestrm_flush         (DEVBLK *dev,                              BYTE *unitstat, BYTE code);
+extern int   tapestrm_quiesce       (DEVBLK *dev,                              BYTE *unitstat, BYTE code);
+extern int   tapestrm_pread         (DEVBLK *dev,       void *buf, U32 len, off_t pos);
+extern int   tapestrm_pwrite        (DEVBLK *dev, const void *buf, U32 len, off_t pos);
+extern int   tapestrm_ftruncate     (DEVBLK *dev, off_t eof);
+extern int   tapestrm_het_read      (DEVBLK *dev,       BYTE *buf);
+extern int   tapestrm_het_write     (DEVBLK *dev, const BYTE *buf, U32 blklen);
+extern void  tapestrm_query         (DEVBLK *dev, char *buf, size_t bufsz);
 extern int   generic_tmhcall        (GENTMH_PARMS*);
 
 /*-------------------------------------------------------------------*/
@@ -49,6 +49,10 @@ int             curblkl;                /* Current block length      */
 int             minblksz;               /* Minimum block size        */
 int             maxblksz;               /* Maximum block size        */
 int64_t         file_bytes;             /* File byte count           */
+U32             blockid;                /* Block id of next block    */
+U32             fblock;                 /* Block id of file's first  */
+int64_t         offset;                 /* Offset of next block      */
+int64_t         foffset;                /* Offset of file's first    */
 BYTE            labelrec[81];           /* Standard label (ASCIIZ)   */
 AWSTAPE_BLKHDR  awshdr;                 /* AWSTAPE block header      */
 char            pathname[MAX_PATH];     /* file path in host format  */
@@ -84,6 +88,10 @@ char            pathname[MAX_PATH];     /* file path in host format  */
     maxblksz = 0;
     file_bytes = 0;
     len = 0;
+    blockid = 0;
+    fblock = 0;
+    offset = 0;
+    foffset = 0;
 
     while (1)
     {
@@ -128,6 +136,9 @@ char            pathname[MAX_PATH];     /* file path in host format  */
 
         /* Parse the block header */
         memcpy(&awshdr, buf, sizeof(AWSTAPE_BLKHDR));
+        offset += len;
+        if (awshdr.flags1 & (AWSTAPE_FLAG1_ENDREC | AWSTAPE_FLAG1_TAPEMARK))
+            blockid++;
 
         /* Tapemark? */
         if ((awshdr.flags1 & AWSTAPE_FLAG1_TAPEMARK) != 0)
@@ -138,12 +149,18 @@ char            pathname[MAX_PATH];     /* file path in host format  */
                          minblksz, maxblksz,
                          (blkcount ? ((int)file_bytes/blkcount) : 0 ));
 
+            /* Print where the file starts, for Locate Block */
+            // "File No. %u: First block id=%u, offset=%"PRId64
+            WRMSG( HHC02762, "I", fileno, fblock, foffset );
+
             /* Reset counters for next file */
             fileno++;
             minblksz = 0;
             maxblksz = 0;
             blkcount = 0;
             file_bytes = 0;
+            fblock = blockid;
+            foffset = offset;
 
         }
         else /* if(tapemark) */
@@ -158,6 +175,8 @@ char            pathname[MAX_PATH];     /* file path in host format  */
 
             /* Read the data block. */
             len = read (infd, buf, curblkl);
+            if (len > 0)
+                offset += len;
 
             if (extgui)
                 curpos += len;
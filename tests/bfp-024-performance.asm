@@ -0,0 +1,315 @@
+ TITLE '            bfp-024-performance (Test BFP host FPU fast path)'
+***********************************************************************
+*
+*              BFP host FPU fast path instruction tests
+*
+***********************************************************************
+*
+*  This program tests the short and long BFP add, subtract, multiply,
+*  divide and square root instructions on both of the paths through
+*  ieee.c: first with an FPC of zero, which makes every instruction go
+*  through SoftFloat, and then with the inexact flag already set in
+*  the FPC, which lets them use the host FPU.  Both passes must produce
+*  the same results.
+*
+*
+*                     ********************
+*                     **   IMPORTANT!   **
+*                     ********************
+*
+*        This test uses the Hercules Diagnose X'008' interface
+*        to display messages and thus your .tst runtest script
+*        MUST contain a "DIAG8CMD ENABLE" statement within it!
+*
+***********************************************************************
+*
+*  Example Hercules Testcase:
+*
+*
+*      *Testcase bfp-024-performance (Test BFP host FPU fast path)
+*
+*      mainsize    16
+*      numcpu      1
+*      sysclear
+*      archlvl     z/Arch
+*      loadcore    "$(testpath)/bfp-024-performance.core" 0x0
+*      diag8cmd    enable   # (needed for messages to Hercules console)
+*      #r           860=ff  # (enable timing tests)
+*      runtest     300      # (test duration, depends on host)
+*      diag8cmd    disable  # (reset back to default)
+*      *Done
+*
+*
+***********************************************************************
+                                                                SPACE 3
+BFPPERF  START 0
+         USING BFPPERF,R0             Low core addressability
+                                                                SPACE 4
+         ORG   BFPPERF+X'1A0'         z/Architecure RESTART PSW
+         DC    X'0000000180000000'
+         DC    AD(BEGIN)
+                                                                SPACE 2
+         ORG   BFPPERF+X'1D0'         z/Architecure PROGRAM CHECK PSW
+         DC    X'0002000180000000'
+         DC    AD(X'DEAD')
+                                                                SPACE 4
+         ORG   BFPPERF+X'200'         Start of actual test program...
+                                                                EJECT
+***********************************************************************
+*               The actual "BFPPERF" program itself...
+***********************************************************************
+*
+*  Architecture Mode: z/Arch
+*  Register Usage:
+*
+*   R1       (work)
+*   R2-R3    DIAG8 message address and length
+*   R4-R5    Timing loop patching
+*   R7       Timing loop count
+*   R13      Current table entry
+*   R14      Subroutine call
+*   R15      FPC to be used for the current pass
+*
+***********************************************************************
+                                                                SPACE
+BEGIN    STCTG R0,R0,CR0SAV           Get control register 0
+         OI    CR0SAV+5,X'04'         Set the AFP-register control
+         LCTLG R0,R0,CR0SAV           ...so BFP instructions work
+                                                                SPACE
+         LA    R15,FPCZERO            No flags, round to nearest
+         BRAS  R14,CHECK              Check results (SoftFloat)
+         LA    R15,FPCRNE             Inexact flag, round to nearest
+         BRAS  R14,CHECK              Check results (host FPU)
+                                                                SPACE
+         CLI   TIMEOPT,X'FF'          Timing tests requested?
+         BRC   7,DONE                 No, then we are done
+                                                                SPACE
+         MVC   MSGMODE,RNE            Identify the rounding mode
+         LA    R15,FPCRNE             Inexact flag, round to nearest
+         BRAS  R14,TIME               Time the host FPU path
+         MVC   MSGMODE,RZ             Identify the rounding mode
+         LA    R15,FPCRZ              Inexact flag, round toward 0
+         BRAS  R14,TIME               Time the SoftFloat path
+                                                                SPACE
+DONE     LPSWE GOODPSW                Load success wait PSW
+FAIL     LPSWE FAILPSW                Load failure wait PSW
+                                                                EJECT
+***********************************************************************
+*        CHECK                  Verify each table entry's result
+***********************************************************************
+                                                                SPACE
+CHECK    LA    R13,TABLE              Point to the first entry
+CHECK1   CLI   0(R13),X'00'           End of table?
+         BER   R14                    Yes, return
+                                                                SPACE
+         LD    FPR0,8(,R13)           Load operand 1
+         LD    FPR2,16(,R13)          Load operand 2
+         LFPC  0(R15)                 Set the FPC for this pass
+         EX    0,0(,R13)              Execute the instruction
+         STD   FPR0,RESULT            Save the result
+         CLC   RESULT,24(R13)         Expected result?
+         BRC   7,FAIL                 No, fail the test
+                                                                SPACE
+         LA    R13,56(,R13)           Point to the next entry
+         BRC   15,CHECK1              ...and check it
+                                                                EJECT
+***********************************************************************
+*        TIME                   Time each table entry's instruction
+***********************************************************************
+                                                                SPACE
+TIME     LA    R13,TABLE              Point to the first entry
+TIME1    CLI   0(R13),X'00'           End of table?
+         BER   R14                    Yes, return
+                                                                SPACE
+         LA    R4,LOOP                Point to the loop body
+         LA    R5,10                  Number of instructions in it
+PATCH    MVC   0(4,R4),0(R13)         Plant the instruction
+         LA    R4,4(,R4)              Next one
+         BRCT  R5,PATCH               Until the body is complete
+                                                                SPACE
+         LD    FPR0,32(,R13)          Load timing operand 1
+         LD    FPR2,40(,R13)          Load timing operand 2
+         LFPC  0(R15)                 Set the FPC for this pass
+         LGFI  R7,100000              Iterations of the loop body
+                                                                SPACE
+         STCK  BEGCLOCK               Start time
+LOOP     DC    10X'07000700'          (instruction under test) x 10
+         BRCTG R7,LOOP                Loop 100,000 times
+         STCK  ENDCLOCK               End time
+                                                                SPACE
+         LG    R1,ENDCLOCK            Elapsed TOD clock units...
+         SLG   R1,BEGCLOCK
+         SRLG  R1,R1,12               ...in microseconds
+         CVDG  R1,DEC                 Convert to decimal
+                                                                SPACE
+         MVC   MSGNAME,48(R13)        Instruction name
+         MVC   MSGNUM,EDPAT           Edit the microseconds
+         ED    MSGNUM,DEC+11
+         LA    R2,MSGCMD              Message command
+         LA    R3,MSGLEN              ...and its length
+         DC    X'83230008'            DIAG 8 to issue it
+                                                                SPACE
+         LA    R13,56(,R13)           Point to the next entry
+         BRC   15,TIME1               ...and time it
+                                                                EJECT
+***********************************************************************
+*        Working storage
+***********************************************************************
+                                                                SPACE
+         ORG   BFPPERF+X'800'
+                                                                SPACE
+GOODPSW  DC    0D'0',X'0002000180000000',AD(0)      Success wait PSW
+FAILPSW  DC    0D'0',X'0002000180000000',AD(X'BAD0') Failure wait PSW
+                                                                SPACE
+CR0SAV   DS    D                      Control register 0
+FPCZERO  DC    F'0'                   FPC: RNE, no flags
+FPCRNE   DC    X'00080000'            FPC: RNE, inexact flag
+FPCRZ    DC    X'00080001'            FPC: RZ, inexact flag
+BEGCLOCK DS    D                      TOD clock at start of loop
+ENDCLOCK DS    D                      TOD clock at end of loop
+RESULT   DS    D                      Result of the checked instruction
+DEC      DS    PL16                   Elapsed microseconds
+TIMEOPT  DC    X'00'                  Set to X'FF' to run timing tests
+                                                                SPACE 2
+         ORG   BFPPERF+X'880'
+                                                                SPACE
+MSGCMD   DC    C'MSGNOH * 1,000,000 iterations of '
+MSGNAME  DC    CL8' '                 Instruction name
+         DC    C' took '
+MSGNUM   DC    CL12' '                Edited microseconds
+         DC    C' microseconds '
+MSGMODE  DC    CL3' '                 Rounding mode
+MSGLEN   EQU   *-MSGCMD               Length of the message command
+                                                                SPACE 2
+         ORG   BFPPERF+X'900'
+                                                                SPACE
+EDPAT    DC    X'402020206B2020206B202120'  Edit pattern
+         DS    0D
+RNE      DC    C'RNE'
+         DS    0F
+RZ       DC    C'RZ '
+                                                                EJECT
+***********************************************************************
+*        Test table:  56 bytes per entry
+*
+*          +0   instruction to execute, followed by a fullword of zero
+*          +8   check operand 1
+*          +16  check operand 2
+*          +24  expected result (short results are left-justified)
+*          +32  timing operand 1
+*          +40  timing operand 2
+*          +48  instruction name
+*
+*        Operands:  1.1, 0.3 (check) and 1.1, 1.0000001 (timing).
+***********************************************************************
+                                                                SPACE
+         ORG   BFPPERF+X'A00'
+                                                                SPACE
+TABLE    DS    0D
+TADBR    DC    X'B31A0002',F'0'       ADBR  FPR0,FPR2
+         DC    X'3FF199999999999A'    1.1
+         DC    X'3FD3333333333333'    0.3
+         DC    X'3FF6666666666667'    Expected result
+         DC    X'3FF199999999999A'    1.1
+         DC    X'3FF000001AD7F29B'    1.0000001
+         DC    CL8'ADBR'
+                                                                SPACE
+TSDBR    DC    X'B31B0002',F'0'       SDBR  FPR0,FPR2
+         DC    X'3FF199999999999A'    1.1
+         DC    X'3FD3333333333333'    0.3
+         DC    X'3FE999999999999A'    Expected result
+         DC    X'3FF199999999999A'    1.1
+         DC    X'3FF000001AD7F29B'    1.0000001
+         DC    CL8'SDBR'
+                                                                SPACE
+TMDBR    DC    X'B31C0002',F'0'       MDBR  FPR0,FPR2
+         DC    X'3FF199999999999A'    1.1
+         DC    X'3FD3333333333333'    0.3
+         DC    X'3FD51EB851EB851F'    Expected result
+         DC    X'3FF199999999999A'    1.1
+         DC    X'3FF000001AD7F29B'    1.0000001
+         DC    CL8'MDBR'
+                                                                SPACE
+TDDBR    DC    X'B31D0002',F'0'       DDBR  FPR0,FPR2
+         DC    X'3FF199999999999A'    1.1
+         DC    X'3FD3333333333333'    0.3
+         DC    X'400D555555555556'    Expected result
+         DC    X'3FF199999999999A'    1.1
+         DC    X'3FF000001AD7F29B'    1.0000001
+         DC    CL8'DDBR'
+                                                                SPACE
+TSQDBR   DC    X'B3150002',F'0'       SQDBR FPR0,FPR2
+         DC    X'3FF199999999999A'    1.1
+         DC    X'3FD3333333333333'    0.3
+         DC    X'3FE186F174F88472'    Expected result
+         DC    X'3FF199999999999A'    1.1
+         DC    X'3FF000001AD7F29B'    1.0000001
+         DC    CL8'SQDBR'
+                                                                SPACE
+TAEBR    DC    X'B30A0002',F'0'       AEBR  FPR0,FPR2
+         DC    X'3F8CCCCD',F'0'       1.1
+         DC    X'3E99999A',F'0'       0.3
+         DC    X'3FB33334',F'0'       Expected result
+         DC    X'3F8CCCCD',F'0'       1.1
+         DC    X'3F800001',F'0'       1.0000001
+         DC    CL8'AEBR'
+                                                                SPACE
+TSEBR    DC    X'B30B0002',F'0'       SEBR  FPR0,FPR2
+         DC    X'3F8CCCCD',F'0'       1.1
+         DC    X'3E99999A',F'0'       0.3
+         DC    X'3F4CCCCD',F'0'       Expected result
+         DC    X'3F8CCCCD',F'0'       1.1
+         DC    X'3F800001',F'0'       1.0000001
+         DC    CL8'SEBR'
+                                                                SPACE
+TMEEBR   DC    X'B3170002',F'0'       MEEBR FPR0,FPR2
+         DC    X'3F8CCCCD',F'0'       1.1
+         DC    X'3E99999A',F'0'       0.3
+         DC    X'3EA8F5C3',F'0'       Expected result
+         DC    X'3F8CCCCD',F'0'       1.1
+         DC    X'3F800001',F'0'       1.0000001
+         DC    CL8'MEEBR'
+                                                                SPACE
+TDEBR    DC    X'B30D0002',F'0'       DEBR  FPR0,FPR2
+         DC    X'3F8CCCCD',F'0'       1.1
+         DC    X'3E99999A',F'0'       0.3
+         DC    X'406AAAAA',F'0'       Expected result
+         DC    X'3F8CCCCD',F'0'       1.1
+         DC    X'3F800001',F'0'       1.0000001
+         DC    CL8'DEBR'
+                                                                SPACE
+TSQEBR   DC    X'B3140002',F'0'       SQEBR FPR0,FPR2
+         DC    X'3F8CCCCD',F'0'       1.1
+         DC    X'3E99999A',F'0'       0.3
+         DC    X'3F0C378C',F'0'       Expected result
+         DC    X'3F8CCCCD',F'0'       1.1
+         DC    X'3F800001',F'0'       1.0000001
+         DC    CL8'SQEBR'
+                                                                SPACE
+         DC    X'00'                  End of table
+                                                                SPACE 4
+***********************************************************************
+*        Register equates
+***********************************************************************
+                                                                SPACE 2
+R0       EQU   0
+R1       EQU   1
+R2       EQU   2
+R3       EQU   3
+R4       EQU   4
+R5       EQU   5
+R6       EQU   6
+R7       EQU   7
+R8       EQU   8
+R9       EQU   9
+R10      EQU   10
+R11      EQU   11
+R12      EQU   12
+R13      EQU   13
+R14      EQU   14
+R15      EQU   15
+                                                                SPACE 2
+FPR0     EQU   0
+FPR2     EQU   2
+                                                                SPACE 2
+         END
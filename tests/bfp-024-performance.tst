@@ -0,0 +1,42 @@
+*Testcase bfp-024-performance (Test BFP host FPU fast path)
+
+# ------------------------------------------------------------------------------
+#  This tests the short and long BFP add, subtract, multiply, divide and
+#  square root instructions on both of the paths through ieee.c: first
+#  with an FPC of zero, which makes every instruction go through
+#  SoftFloat, and then with the inexact flag already set in the FPC,
+#  which lets them use the host FPU.  Both passes must produce the same
+#  results.
+#
+#  The default is to NOT run the timing tests.  To enable them, uncomment
+#  the "#r 860=ff   # (enable timing tests)" line below.
+#
+#     Timing tests:
+#
+#           Each instruction is run 1,000,000 times as ' xxxBR F0,F2 ',
+#           first rounding to nearest (the host FPU path) and then
+#           rounding toward zero (the SoftFloat path).
+#
+#     Output:
+#
+#         For each instruction and rounding mode a console line is
+#         generated with the timing results, as follows:
+#
+#              1,000,000 iterations of ADBR     took     nnn,nnn microseconds RNE
+#              ...
+#              1,000,000 iterations of ADBR     took     nnn,nnn microseconds RZ
+# ------------------------------------------------------------------------------
+
+mainsize    16
+numcpu      1
+sysclear
+archlvl     z/Arch
+
+loadcore    "$(testpath)/bfp-024-performance.core" 0x0
+
+diag8cmd    enable    # (needed for messages to Hercules console)
+#r           860=ff    # (enable timing tests)
+runtest     300       # (test duration, depends on host)
+diag8cmd    disable   # (reset back to default)
+
+*Done
@@ -0,0 +1,331 @@
+ TITLE '            decimal-performance (Test packed decimal instruction mixes)'
+***********************************************************************
+*
+*              Packed decimal instruction mix tests
+*
+***********************************************************************
+*
+*  This program runs short mixes of the packed decimal instructions of
+*  the kind a COBOL program generates: running totals (AP, SP, CP),
+*  extended prices (ZAP, MP, AP), interest and averages (MP, DP),
+*  31-digit arithmetic, decimal overflow into a short field, and CVB,
+*  CVD, CVBG and CVDG.  Each mix ends with a result area and (where
+*  set) a condition code which are checked against the expected values.
+*
+*
+*                     ********************
+*                     **   IMPORTANT!   **
+*                     ********************
+*
+*        This test uses the Hercules Diagnose X'008' interface
+*        to display messages and thus your .tst runtest script
+*        MUST contain a "DIAG8CMD ENABLE" statement within it!
+*
+***********************************************************************
+*
+*  Example Hercules Testcase:
+*
+*
+*      *Testcase decimal-performance (Test packed decimal instruction mixes)
+*
+*      mainsize    16
+*      numcpu      1
+*      sysclear
+*      archlvl     z/Arch
+*      loadcore    "$(testpath)/decimal-performance.core" 0x0
+*      diag8cmd    enable   # (needed for messages to Hercules console)
+*      #r           848=ff  # (enable timing tests)
+*      runtest     300      # (test duration, depends on host)
+*      diag8cmd    disable  # (reset back to default)
+*      *Done
+*
+*
+***********************************************************************
+                                                                SPACE 3
+DECPERF  START 0
+         USING DECPERF,R0             Low core addressability
+                                                                SPACE 4
+         ORG   DECPERF+X'1A0'         z/Architecure RESTART PSW
+         DC    X'0000000180000000'
+         DC    AD(BEGIN)
+                                                                SPACE 2
+         ORG   DECPERF+X'1D0'         z/Architecure PROGRAM CHECK PSW
+         DC    X'0002000180000000'
+         DC    AD(X'DEAD')
+                                                                SPACE 4
+         ORG   DECPERF+X'200'         Start of actual test program...
+                                                                EJECT
+***********************************************************************
+*               The actual "DECPERF" program itself...
+***********************************************************************
+*
+*  Architecture Mode: z/Arch
+*  Register Usage:
+*
+*   R1       Condition code, (work)
+*   R2-R3    DIAG8 message address and length
+*   R7       Timing loop count
+*   R8-R9    (used by the CONVERT mix)
+*   R12      RUN subroutine call
+*   R13      Current table entry
+*   R14      Subroutine call
+*
+***********************************************************************
+                                                                SPACE
+BEGIN    BRAS  R14,CHECK              Check the results
+         CLI   TIMEOPT,X'FF'          Timing tests requested?
+         BRC   7,DONE                 No, then we are done
+         BRAS  R14,TIME               Time the instruction mixes
+                                                                SPACE
+DONE     LPSWE GOODPSW                Load success wait PSW
+FAIL     LPSWE FAILPSW                Load failure wait PSW
+                                                                EJECT
+***********************************************************************
+*        CHECK                  Verify each table entry's results
+***********************************************************************
+                                                                SPACE
+CHECK    LARL  R13,TABLE              Point to the first entry
+CHECK1   CLI   0(R13),X'00'           End of table?
+         BER   R14                    Yes, return
+                                                                SPACE
+         LGHI  R7,1                   Run the mix once
+         BRAS  R12,RUN                ...and get its condition code
+         CLC   MIXRES(16,R13),MIXEXP(R13)  Expected result?
+         BRC   7,FAIL                 No, fail the test
+         CLI   MIXCC(R13),X'FF'       Condition code unchanged?
+         BRC   8,CHECK2               Yes, nothing to check
+         SRL   R1,28                  Isolate the condition code
+         STC   R1,CCOUT
+         CLC   CCOUT,MIXCC(R13)       Expected condition code?
+         BRC   7,FAIL                 No, fail the test
+                                                                SPACE
+CHECK2   LA    R13,MIXLEN(,R13)       Point to the next entry
+         BRC   15,CHECK1              ...and check it
+                                                                EJECT
+***********************************************************************
+*        TIME                   Time each table entry's mix
+***********************************************************************
+                                                                SPACE
+TIME     LARL  R13,TABLE              Point to the first entry
+TIME1    CLI   0(R13),X'00'           End of table?
+         BER   R14                    Yes, return
+                                                                SPACE
+         LGFI  R7,1000000             Iterations of the mix
+         BRAS  R12,RUN                Run it
+                                                                SPACE
+         LG    R1,ENDCLOCK            Elapsed TOD clock units...
+         SLG   R1,BEGCLOCK
+         SRLG  R1,R1,12               ...in microseconds
+         CVDG  R1,DEC                 Convert to decimal
+                                                                SPACE
+         MVC   MSGNAME,MIXNAME(R13)   Mix name
+         MVC   MSGNUM,EDPAT           Edit the microseconds
+         ED    MSGNUM,DEC+11
+         LA    R2,MSGCMD              Message command
+         LA    R3,MSGLEN              ...and its length
+         DC    X'83230008'            DIAG 8 to issue it
+                                                                SPACE
+         LA    R13,MIXLEN(,R13)       Point to the next entry
+         BRC   15,TIME1               ...and time it
+                                                                EJECT
+***********************************************************************
+*        RUN                    Run the mix at R13 R7 times
+***********************************************************************
+                                                                SPACE
+RUN      MVC   LOOP(48),0(R13)        Plant the instruction mix
+         STCK  BEGCLOCK               Start time
+LOOP     DC    8X'070007000700'       (instruction mix under test)
+         BRCTG R7,LOOP                Repeat the mix
+         IPM   R1                     Save its condition code
+         STCK  ENDCLOCK               End time
+         BR    R12                    Return
+                                                                EJECT
+***********************************************************************
+*        Working storage
+***********************************************************************
+                                                                SPACE
+         ORG   DECPERF+X'800'
+                                                                SPACE
+GOODPSW  DC    0D'0',X'0002000180000000',AD(0)      Success wait PSW
+FAILPSW  DC    0D'0',X'0002000180000000',AD(X'BAD0') Failure wait PSW
+                                                                SPACE
+CCOUT    DS    X                      Condition code
+BEGCLOCK DS    D                      TOD clock at start of loop
+ENDCLOCK DS    D                      TOD clock at end of loop
+DEC      DS    PL16                   Elapsed microseconds
+TIMEOPT  DC    X'00'                  Set to X'FF' to run timing tests
+                                                                SPACE 2
+         ORG   DECPERF+X'880'
+                                                                SPACE
+MSGCMD   DC    C'MSGNOH * 1,000,000 iterations of '
+MSGNAME  DC    CL8' '                 Mix name
+         DC    C' took '
+MSGNUM   DC    CL12' '                Edited microseconds
+         DC    C' microseconds'
+MSGLEN   EQU   *-MSGCMD               Length of the message command
+                                                                SPACE 2
+         ORG   DECPERF+X'900'
+                                                                SPACE
+EDPAT    DC    X'402020206B2020206B202120'  Edit pattern
+                                                                EJECT
+***********************************************************************
+*        Test table:  128 bytes per entry
+*
+*        Each mix is copied into the loop body and addresses its
+*        operands through R13, which points to the table entry.
+***********************************************************************
+                                                                SPACE
+MIXNAME  EQU   48                     Mix name
+MIXCC    EQU   56                     Expected cc, X'FF' if not set
+MIXEXP   EQU   64                     Expected result
+MIXRES   EQU   80                     Result area
+MIXOPS   EQU   96                     Operands
+MIXLEN   EQU   128                    Length of an entry
+                                                                SPACE
+         ORG   DECPERF+X'1000'
+                                                                SPACE
+TABLE    DS    0D
+*
+*        Running total: add and subtract amounts
+*
+T01      ZAP   MIXRES(8,R13),MIXOPS(5,R13)
+         AP    MIXRES(8,R13),MIXOPS+5(4,R13)
+         SP    MIXRES(8,R13),MIXOPS+9(3,R13)
+         AP    MIXRES(8,R13),MIXOPS+12(2,R13)
+         AP    MIXRES(8,R13),MIXOPS+9(3,R13)
+         SP    MIXRES(8,R13),MIXOPS+5(4,R13)
+         AP    MIXRES(8,R13),MIXOPS(5,R13)
+         CP    MIXRES(8,R13),MIXOPS(5,R13)
+         DC    CL8'ADDSUB'
+         DC    AL1(2),XL7'00'
+         DC    PL8'2469122',XL8'00'
+         DC    XL16'00'
+         DC    PL5'1234567',PL4'-98765',PL3'4500',PL2'-12'
+         DC    XL18'00'
+*
+*        Extended price: quantity times unit price, added to a total
+*
+T02      ZAP   MIXRES(8,R13),MIXOPS(2,R13)
+         MP    MIXRES(8,R13),MIXOPS+2(4,R13)
+         ZAP   MIXRES+8(8,R13),MIXOPS+6(8,R13)
+         AP    MIXRES+8(8,R13),MIXRES(8,R13)
+         AP    MIXRES+8(8,R13),MIXRES(8,R13)
+         AP    MIXRES+8(8,R13),MIXRES(8,R13)
+         CP    MIXRES+8(8,R13),MIXRES(8,R13)
+         DC    X'070007000700'        (padding)
+         DC    CL8'PRICE'
+         DC    AL1(2),XL7'00'
+         DC    PL8'24993750',PL8'74981250'
+         DC    XL16'00'
+         DC    PL2'125',PL4'199950',PL8'0'
+         DC    XL18'00'
+*
+*        Balance times a rate, divided back to cents
+*
+T03      ZAP   MIXRES(16,R13),MIXOPS(5,R13)
+         MP    MIXRES(16,R13),MIXOPS+5(2,R13)
+         DP    MIXRES(16,R13),MIXOPS+7(3,R13)
+         ZAP   MIXRES(16,R13),MIXOPS(5,R13)
+         MP    MIXRES(16,R13),MIXOPS+5(2,R13)
+         DP    MIXRES(16,R13),MIXOPS+7(3,R13)
+         CP    MIXRES(13,R13),MIXOPS(5,R13)
+         DC    X'070007000700'        (padding)
+         DC    CL8'INTEREST'
+         DC    AL1(1),XL7'00'
+         DC    PL13'41975308',PL3'600'
+         DC    XL16'00'
+         DC    PL5'98765432',PL2'425',PL3'1000'
+         DC    XL22'00'
+*
+*        Total divided by a count
+*
+T04      ZAP   MIXRES(16,R13),MIXOPS(8,R13)
+         DP    MIXRES(16,R13),MIXOPS+8(2,R13)
+         AP    MIXRES(14,R13),MIXOPS+10(1,R13)
+         ZAP   MIXRES(16,R13),MIXOPS(8,R13)
+         DP    MIXRES(16,R13),MIXOPS+8(2,R13)
+         SP    MIXRES(14,R13),MIXOPS+10(1,R13)
+         CP    MIXRES(14,R13),MIXOPS(8,R13)
+         DC    X'070007000700'        (padding)
+         DC    CL8'AVERAGE'
+         DC    AL1(1),XL7'00'
+         DC    PL14'3336669973305',PL2'23'
+         DC    XL16'00'
+         DC    PL8'123456789012345',PL2'37',PL1'1'
+         DC    XL21'00'
+*
+*        31-digit accumulation
+*
+T05      ZAP   MIXRES(16,R13),MIXOPS(16,R13)
+         AP    MIXRES(16,R13),MIXOPS(16,R13)
+         SP    MIXRES(16,R13),MIXOPS(16,R13)
+         AP    MIXRES(16,R13),MIXOPS(16,R13)
+         SP    MIXRES(16,R13),MIXOPS(16,R13)
+         AP    MIXRES(16,R13),MIXOPS(16,R13)
+         CP    MIXRES(16,R13),MIXOPS(16,R13)
+         DC    X'070007000700'        (padding)
+         DC    CL8'LONG'
+         DC    AL1(2),XL7'00'
+         DC    PL16'2469135780246913578024691357802'
+         DC    XL16'00'
+         DC    PL16'1234567890123456789012345678901'
+         DC    XL16'00'
+*
+*        Sums that overflow a small field (cc 3)
+*
+T06      ZAP   MIXRES(2,R13),MIXOPS(2,R13)
+         AP    MIXRES(2,R13),MIXOPS+3(1,R13)
+         ZAP   MIXRES+2(2,R13),MIXOPS(2,R13)
+         SP    MIXRES+2(2,R13),MIXOPS+2(1,R13)
+         ZAP   MIXRES+4(2,R13),MIXOPS(2,R13)
+         AP    MIXRES+4(2,R13),MIXOPS(2,R13)
+         DC    2X'070007000700'       (padding)
+         DC    CL8'OVERFLOW'
+         DC    AL1(3),XL7'00'
+         DC    PL2'0',PL2'0',PL2'998',XL10'00'
+         DC    XL16'00'
+         DC    PL2'999',PL1'-1',PL1'1'
+         DC    XL28'00'
+*
+*        Packed to binary and back
+*
+T07      CVB   R8,MIXOPS(,R13)
+         CVD   R8,MIXRES(,R13)
+         CVBG  R9,MIXOPS+8(,R13)
+         CVDG  R9,MIXRES(,R13)
+         CVB   R8,MIXOPS(,R13)
+         CVD   R8,MIXRES+8(,R13)
+         CVBG  R9,MIXOPS+8(,R13)
+         CVD   R9,MIXRES(,R13)
+         DC    X'07000700070007000700'  (padding)
+         DC    CL8'CONVERT'
+         DC    X'FF',XL7'00'
+         DC    PL8'-1506741426',PL8'-7654321'
+         DC    XL16'00'
+         DC    PL8'-7654321',PL16'123456789012345678'
+         DC    XL8'00'
+                                                                SPACE
+         DC    X'00'                  End of table
+                                                                SPACE 4
+***********************************************************************
+*        Register equates
+***********************************************************************
+                                                                SPACE 2
+R0       EQU   0
+R1       EQU   1
+R2       EQU   2
+R3       EQU   3
+R4       EQU   4
+R5       EQU   5
+R6       EQU   6
+R7       EQU   7
+R8       EQU   8
+R9       EQU   9
+R10      EQU   10
+R11      EQU   11
+R12      EQU   12
+R13      EQU   13
+R14      EQU   14
+R15      EQU   15
+                                                                SPACE 2
+         END
@@ -0,0 +1,40 @@
+*Testcase decimal-performance (Test packed decimal instruction mixes)
+
+# ------------------------------------------------------------------------------
+#  This runs short mixes of the packed decimal instructions of the kind a
+#  COBOL program generates: running totals (AP, SP, CP), extended prices
+#  (ZAP, MP, AP), interest and averages (MP, DP), 31-digit arithmetic,
+#  decimal overflow into a short field, and CVB, CVD, CVBG and CVDG.
+#  Each mix ends with a result area and (where set) a condition code
+#  which are checked against the expected values.
+#
+#  The default is to NOT run the timing tests.  To enable them, uncomment
+#  the "#r 848=ff   # (enable timing tests)" line below.
+#
+#     Timing tests:
+#
+#           Each mix is copied into the loop body and run 1,000,000
+#           times.  The instructions address their operands through
+#           R13, which points to the table entry holding the mix.
+#
+#     Output:
+#
+#         For each mix a console line is generated with the timing
+#         results, as follows:
+#
+#              1,000,000 iterations of ADDSUB   took     nnn,nnn microseconds
+# ------------------------------------------------------------------------------
+
+mainsize    16
+numcpu      1
+sysclear
+archlvl     z/Arch
+
+loadcore    "$(testpath)/decimal-performance.core" 0x0
+
+diag8cmd    enable    # (needed for messages to Hercules console)
+#r           848=ff    # (enable timing tests)
+runtest     300       # (test duration, depends on host)
+diag8cmd    disable   # (reset back to default)
+
+*Done
@@ -0,0 +1,330 @@
+ TITLE '            dfp-042-performance (Test DFP integer coefficient fast path)'
+***********************************************************************
+*
+*            DFP integer coefficient fast path instruction tests
+*
+***********************************************************************
+*
+*  This program tests the long and extended DFP add, subtract,
+*  multiply, compare and quantize instructions with operands which
+*  dfp.c handles with host integer arithmetic, and with operands which
+*  need rounding and so go through the decNumber library.  Each result,
+*  the FPC and (where set) the condition code are checked against the
+*  values decNumber gives.
+*
+*
+*                     ********************
+*                     **   IMPORTANT!   **
+*                     ********************
+*
+*        This test uses the Hercules Diagnose X'008' interface
+*        to display messages and thus your .tst runtest script
+*        MUST contain a "DIAG8CMD ENABLE" statement within it!
+*
+***********************************************************************
+*
+*  Example Hercules Testcase:
+*
+*
+*      *Testcase dfp-042-performance (Test DFP integer coefficient fast path)
+*
+*      mainsize    16
+*      numcpu      1
+*      sysclear
+*      archlvl     z/Arch
+*      loadcore    "$(testpath)/dfp-042-performance.core" 0x0
+*      diag8cmd    enable   # (needed for messages to Hercules console)
+*      #r           868=ff  # (enable timing tests)
+*      runtest     300      # (test duration, depends on host)
+*      diag8cmd    disable  # (reset back to default)
+*      *Done
+*
+*
+***********************************************************************
+                                                                SPACE 3
+DFPPERF  START 0
+         USING DFPPERF,R0             Low core addressability
+                                                                SPACE 4
+         ORG   DFPPERF+X'1A0'         z/Architecure RESTART PSW
+         DC    X'0000000180000000'
+         DC    AD(BEGIN)
+                                                                SPACE 2
+         ORG   DFPPERF+X'1D0'         z/Architecure PROGRAM CHECK PSW
+         DC    X'0002000180000000'
+         DC    AD(X'DEAD')
+                                                                SPACE 4
+         ORG   DFPPERF+X'200'         Start of actual test program...
+                                                                EJECT
+***********************************************************************
+*               The actual "DFPPERF" program itself...
+***********************************************************************
+*
+*  Architecture Mode: z/Arch
+*  Register Usage:
+*
+*   R1       Condition code, (work)
+*   R2-R3    DIAG8 message address and length
+*   R4-R5    Timing loop patching
+*   R7       Timing loop count
+*   R13      Current table entry
+*   R14      Subroutine call
+*
+*   FPR0/2   Result
+*   FPR1/3   Operand 2
+*   FPR4/6   Operand 3
+*
+***********************************************************************
+                                                                SPACE
+BEGIN    STCTG R0,R0,CR0SAV           Get control register 0
+         OI    CR0SAV+5,X'04'         Set the AFP-register control
+         LCTLG R0,R0,CR0SAV           ...so DFP instructions work
+                                                                SPACE
+         BRAS  R14,CHECK              Check the results
+         CLI   TIMEOPT,X'FF'          Timing tests requested?
+         BRC   7,DONE                 No, then we are done
+         BRAS  R14,TIME               Time the instructions
+                                                                SPACE
+DONE     LPSWE GOODPSW                Load success wait PSW
+FAIL     LPSWE FAILPSW                Load failure wait PSW
+                                                                EJECT
+***********************************************************************
+*        CHECK                  Verify each table entry's results
+***********************************************************************
+                                                                SPACE
+CHECK    LA    R13,TABLE              Point to the first entry
+CHECK1   CLI   0(R13),X'00'           End of table?
+         BER   R14                    Yes, return
+                                                                SPACE
+         LZDR  FPR0                   Clear the result registers
+         LZDR  FPR2
+         LD    FPR1,8(,R13)           Load operand 2 into FPR1/FPR3
+         LD    FPR3,16(,R13)
+         LD    FPR4,24(,R13)          Load operand 3 into FPR4/FPR6
+         LD    FPR6,32(,R13)
+         LFPC  4(R13)                 Set the FPC
+         LGHI  R1,0
+         EX    0,0(,R13)              Execute the instruction
+         IPM   R1                     Save its condition code
+         STFPC FPCOUT                 ...and the FPC
+         STD   FPR0,RESULT            ...and the result
+         STD   FPR2,RESULT+8
+                                                                SPACE
+         CLC   RESULT,40(R13)         Expected result?
+         BRC   7,FAIL                 No, fail the test
+         CLC   FPCOUT,56(R13)         Expected FPC?
+         BRC   7,FAIL                 No, fail the test
+         CLI   60(R13),X'FF'          Condition code unchanged?
+         BRC   8,CHECK2               Yes, nothing to check
+         SRL   R1,28                  Isolate the condition code
+         STC   R1,CCOUT
+         CLC   CCOUT,60(R13)          Expected condition code?
+         BRC   7,FAIL                 No, fail the test
+                                                                SPACE
+CHECK2   LA    R13,72(,R13)           Point to the next entry
+         BRC   15,CHECK1              ...and check it
+                                                                EJECT
+***********************************************************************
+*        TIME                   Time each table entry's instruction
+***********************************************************************
+                                                                SPACE
+TIME     LA    R13,TABLE              Point to the first entry
+TIME1    CLI   0(R13),X'00'           End of table?
+         BER   R14                    Yes, return
+                                                                SPACE
+         LA    R4,LOOP                Point to the loop body
+         LA    R5,10                  Number of instructions in it
+PATCH    MVC   0(4,R4),0(R13)         Plant the instruction
+         LA    R4,4(,R4)              Next one
+         BRCT  R5,PATCH               Until the body is complete
+                                                                SPACE
+         LD    FPR1,8(,R13)           Load operand 2 into FPR1/FPR3
+         LD    FPR3,16(,R13)
+         LD    FPR4,24(,R13)          Load operand 3 into FPR4/FPR6
+         LD    FPR6,32(,R13)
+         LFPC  4(R13)                 Set the FPC
+         LGFI  R7,100000              Iterations of the loop body
+                                                                SPACE
+         STCK  BEGCLOCK               Start time
+LOOP     DC    10X'07000700'          (instruction under test) x 10
+         BRCTG R7,LOOP                Loop 100,000 times
+         STCK  ENDCLOCK               End time
+                                                                SPACE
+         LG    R1,ENDCLOCK            Elapsed TOD clock units...
+         SLG   R1,BEGCLOCK
+         SRLG  R1,R1,12               ...in microseconds
+         CVDG  R1,DEC                 Convert to decimal
+                                                                SPACE
+         MVC   MSGNAME,64(R13)        Instruction name
+         MVC   MSGNUM,EDPAT           Edit the microseconds
+         ED    MSGNUM,DEC+11
+         LA    R2,MSGCMD              Message command
+         LA    R3,MSGLEN              ...and its length
+         DC    X'83230008'            DIAG 8 to issue it
+                                                                SPACE
+         LA    R13,72(,R13)           Point to the next entry
+         BRC   15,TIME1               ...and time it
+                                                                EJECT
+***********************************************************************
+*        Working storage
+***********************************************************************
+                                                                SPACE
+         ORG   DFPPERF+X'800'
+                                                                SPACE
+GOODPSW  DC    0D'0',X'0002000180000000',AD(0)      Success wait PSW
+FAILPSW  DC    0D'0',X'0002000180000000',AD(X'BAD0') Failure wait PSW
+                                                                SPACE
+CR0SAV   DS    D                      Control register 0
+FPCOUT   DS    F                      FPC after the instruction
+CCOUT    DS    X                      Condition code
+                                                                SPACE
+         ORG   DFPPERF+X'838'
+BEGCLOCK DS    D                      TOD clock at start of loop
+ENDCLOCK DS    D                      TOD clock at end of loop
+RESULT   DS    XL16                   Result of the checked instruction
+DEC      DS    PL16                   Elapsed microseconds
+TIMEOPT  DC    X'00'                  Set to X'FF' to run timing tests
+                                                                SPACE 2
+         ORG   DFPPERF+X'880'
+                                                                SPACE
+MSGCMD   DC    C'MSGNOH * 1,000,000 iterations of '
+MSGNAME  DC    CL8' '                 Instruction name
+         DC    C' took '
+MSGNUM   DC    CL12' '                Edited microseconds
+         DC    C' microseconds'
+MSGLEN   EQU   *-MSGCMD               Length of the message command
+                                                                SPACE 2
+         ORG   DFPPERF+X'900'
+                                                                SPACE
+EDPAT    DC    X'402020206B2020206B202120'  Edit pattern
+                                                                EJECT
+***********************************************************************
+*        Test table:  72 bytes per entry
+*
+*          +0   instruction to execute
+*          +4   FPC to be used
+*          +8   operand 2 (long operands are followed by zeros)
+*          +24  operand 3
+*          +40  expected result
+*          +56  expected FPC
+*          +60  expected condition code, X'FF' if it is not set
+*          +64  instruction name
+***********************************************************************
+                                                                SPACE
+         ORG   DFPPERF+X'A00'
+                                                                SPACE
+TABLE    DS    0D
+T01      DC    X'B3D24001',X'00000000'   ADTR  FPR0,FPR4,FPR1
+         DC    DD'1234.56',D'0'
+         DC    DD'78.90',D'0'
+         DC    DD'1313.46',D'0'
+         DC    X'00000000',AL1(2),XL3'00'
+         DC    CL8'ADTR'
+                                                                SPACE
+T02      DC    X'B3D34001',X'00000000'   SDTR  FPR0,FPR4,FPR1
+         DC    DD'100.00',D'0'
+         DC    DD'250.5',D'0'
+         DC    DD'-150.50',D'0'
+         DC    X'00000000',AL1(1),XL3'00'
+         DC    CL8'SDTR'
+                                                                SPACE
+T03      DC    X'B3D04001',X'00000000'   MDTR  FPR0,FPR4,FPR1
+         DC    DD'12.34',D'0'
+         DC    DD'5.6',D'0'
+         DC    DD'69.104',D'0'
+         DC    X'00000000',X'FF',XL3'00'
+         DC    CL8'MDTR'
+                                                                SPACE
+T04      DC    X'B3E40014',X'00000000'   CDTR  FPR1,FPR4
+         DC    DD'1.20',D'0'
+         DC    DD'1.2',D'0'
+         DC    XL16'00'
+         DC    X'00000000',AL1(0),XL3'00'
+         DC    CL8'CDTR'
+                                                                SPACE
+T05      DC    X'B3F54001',X'00000000'   QADTR FPR0,FPR4,FPR1,0
+         DC    DD'123.456',D'0'
+         DC    DD'0.01',D'0'
+         DC    DD'123.46',D'0'
+         DC    X'00080000',X'FF',XL3'00'
+         DC    CL8'QADTR'
+                                                                SPACE
+T06      DC    X'B3D24001',X'00000000'   ADTR  FPR0,FPR4,FPR1
+         DC    DD'9999999999999999',D'0'
+         DC    DD'0.5',D'0'
+         DC    DD'1.000000000000000E+16',D'0'
+         DC    X'00080000',AL1(2),XL3'00'
+         DC    CL8'ADTR'
+                                                                SPACE
+T07      DC    X'B3DA4001',X'00000000'   AXTR  FPR0,FPR4,FPR1
+         DC    LD'1234.56'
+         DC    LD'78.90'
+         DC    LD'1313.46'
+         DC    X'00000000',AL1(2),XL3'00'
+         DC    CL8'AXTR'
+                                                                SPACE
+T08      DC    X'B3DB4001',X'00000000'   SXTR  FPR0,FPR4,FPR1
+         DC    LD'100.00'
+         DC    LD'250.5'
+         DC    LD'-150.50'
+         DC    X'00000000',AL1(1),XL3'00'
+         DC    CL8'SXTR'
+                                                                SPACE
+T09      DC    X'B3D84001',X'00000000'   MXTR  FPR0,FPR4,FPR1
+         DC    LD'12.34'
+         DC    LD'5.6'
+         DC    LD'69.104'
+         DC    X'00000000',X'FF',XL3'00'
+         DC    CL8'MXTR'
+                                                                SPACE
+T10      DC    X'B3EC0014',X'00000000'   CXTR  FPR1,FPR4
+         DC    LD'-7.5'
+         DC    LD'-7.50'
+         DC    XL16'00'
+         DC    X'00000000',AL1(0),XL3'00'
+         DC    CL8'CXTR'
+                                                                SPACE
+T11      DC    X'B3FD4001',X'00000040'   QAXTR FPR0,FPR4,FPR1,0 (DRM 4)
+         DC    LD'-123.455'
+         DC    LD'0.01'
+         DC    LD'-123.46'
+         DC    X'00080040',X'FF',XL3'00'
+         DC    CL8'QAXTR'
+                                                                SPACE
+T12      DC    X'B3DA4001',X'00000000'   AXTR  FPR0,FPR4,FPR1
+         DC    LD'123456789012345678901234567890.1234'
+         DC    LD'0.00005'
+         DC    LD'123456789012345678901234567890.1234'
+         DC    X'00080000',AL1(2),XL3'00'
+         DC    CL8'AXTR'
+                                                                SPACE
+         DC    X'00'                  End of table
+                                                                SPACE 4
+***********************************************************************
+*        Register equates
+***********************************************************************
+                                                                SPACE 2
+R0       EQU   0
+R1       EQU   1
+R2       EQU   2
+R3       EQU   3
+R4       EQU   4
+R5       EQU   5
+R6       EQU   6
+R7       EQU   7
+R8       EQU   8
+R9       EQU   9
+R10      EQU   10
+R11      EQU   11
+R12      EQU   12
+R13      EQU   13
+R14      EQU   14
+R15      EQU   15
+                                                                SPACE 2
+FPR0     EQU   0
+FPR1     EQU   1
+FPR2     EQU   2
+FPR3     EQU   3
+FPR4     EQU   4
+FPR6     EQU   6
+                                                                SPACE 2
+         END
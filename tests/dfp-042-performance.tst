@@ -0,0 +1,39 @@
+*Testcase dfp-042-performance (Test DFP integer coefficient fast path)
+
+# ------------------------------------------------------------------------------
+#  This tests the long and extended DFP add, subtract, multiply, compare
+#  and quantize instructions with operands which dfp.c handles with host
+#  integer arithmetic, and with operands which need rounding and so go
+#  through the decNumber library.  Each result, the FPC and (where set)
+#  the condition code are checked against the values decNumber gives.
+#
+#  The default is to NOT run the timing tests.  To enable them, uncomment
+#  the "#r 868=ff   # (enable timing tests)" line below.
+#
+#     Timing tests:
+#
+#           Each table entry is run 1,000,000 times.  The last entry
+#           for each of ADTR and AXTR needs rounding and shows the
+#           decNumber path for comparison.
+#
+#     Output:
+#
+#         For each table entry a console line is generated with the
+#         timing results, as follows:
+#
+#              1,000,000 iterations of ADTR     took     nnn,nnn microseconds
+# ------------------------------------------------------------------------------
+
+mainsize    16
+numcpu      1
+sysclear
+archlvl     z/Arch
+
+loadcore    "$(testpath)/dfp-042-performance.core" 0x0
+
+diag8cmd    enable    # (needed for messages to Hercules console)
+#r           868=ff    # (enable timing tests)
+runtest     300       # (test duration, depends on host)
+diag8cmd    disable   # (reset back to default)
+
+*Done
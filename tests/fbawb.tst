@@ -0,0 +1,125 @@
+*Testcase FBA write-back: updated block groups reach the image file
+
+# A 512K FBA image is created with savecore from cleared storage.
+# With the writeback option, blocks in three different block groups
+# are written and read back in one chained channel program, so the
+# first two groups are left to the write-back threads.  The device
+# is then detached, which flushes them, attached again without the
+# option and the three blocks read back from the image file.
+
+mainsize    1
+numcpu      1
+archlvl     S/370
+sysclear    # must FOLLOW archlvl command!
+
+savecore    "fbawb.img"  0  7FFFF   # (1024 blocks of zeros)
+
+r 00=0008000000000200       # Restart New PSW
+r 68=000A00000000DEAD       # Program Check New PSW
+r 78=000A000000000000       # I/O Interrupt New PSW
+
+r 200=41100500              # R1 --> Channel program
+r 204=50100048              # Store into CAW
+r 208=9C000100              # SIO X'100'
+r 20C=4730021C              # cc=2, cc=3: FAIL
+r 210=47400218              # cc=1: CSW stored
+r 214=82000400              # Wait for I/O interrupt
+r 218=82000078              # Test finished
+r 21C=82000408              # SIO failed
+
+r 400=020A000000000000      # Wait on I/O PSW
+r 408=000A000000EEEEEE      # SIO failure PSW
+
+r 500=6300060060000010      # Define extent
+r 508=4300061060000008      # Locate: write block 0
+r 510=4100100060000200      # Write 512 from 1000
+r 518=4300061860000008      # Locate: write block 200
+r 520=4100120060000200      # Write 512 from 1200
+r 528=4300062060000008      # Locate: write block 400
+r 530=4100140060000200      # Write 512 from 1400
+r 538=4300062860000008      # Locate: read block 0
+r 540=4200400060000200      # Read 512 into 4000
+r 548=4300063060000008      # Locate: read block 200
+r 550=4200420060000200      # Read 512 into 4200
+r 558=4300063860000008      # Locate: read block 400
+r 560=4200440020000200      # Read 512 into 4400
+
+r 600=C000020000000000      # Extent: all 1024 blocks
+r 608=00000000000003FF
+r 610=0100000100000000      # Write 1 block at 0
+r 618=01000001000000C8      # Write 1 block at 200
+r 620=0100000100000190      # Write 1 block at 400
+r 628=0600000100000000      # Read 1 block at 0
+r 630=06000001000000C8      # Read 1 block at 200
+r 638=0600000100000190      # Read 1 block at 400
+
+r 1000=C1C1C1C1C1C1C1C1     # block 0
+r 11F8=C1C1C1C1C1C1C1F1
+r 1200=C2C2C2C2C2C2C2C2     # block 200
+r 13F8=C2C2C2C2C2C2C2F2
+r 1400=C3C3C3C3C3C3C3C3     # block 400
+r 15F8=C3C3C3C3C3C3C3F3
+
+attach  0100  3370  "fbawb.img"  writeback  wbsync=0
+
+runtest   1
+
+*Compare
+r 44.4
+*Want "Good CSW" 0C000000
+r 4000.8
+*Want C1C1C1C1 C1C1C1C1
+r 41F8.8
+*Want C1C1C1C1 C1C1C1F1
+r 4200.8
+*Want C2C2C2C2 C2C2C2C2
+r 43F8.8
+*Want C2C2C2C2 C2C2C2F2
+r 4400.8
+*Want C3C3C3C3 C3C3C3C3
+r 45F8.8
+*Want C3C3C3C3 C3C3C3F3
+
+detach  0100
+
+r 44=00000000
+r 4000=0000000000000000
+r 41F8=0000000000000000
+r 4200=0000000000000000
+r 43F8=0000000000000000
+r 4400=0000000000000000
+r 45F8=0000000000000000
+
+r 200=41100700              # R1 --> Read-only channel program
+
+r 700=6300060060000010      # Define extent
+r 708=4300062860000008      # Locate: read block 0
+r 710=4200400060000200      # Read 512 into 4000
+r 718=4300063060000008      # Locate: read block 200
+r 720=4200420060000200      # Read 512 into 4200
+r 728=4300063860000008      # Locate: read block 400
+r 730=4200440020000200      # Read 512 into 4400
+
+attach  0100  3370  "fbawb.img"
+
+runtest   1
+
+*Compare
+r 44.4
+*Want "Good CSW" 0C000000
+r 4000.8
+*Want C1C1C1C1 C1C1C1C1
+r 41F8.8
+*Want C1C1C1C1 C1C1C1F1
+r 4200.8
+*Want C2C2C2C2 C2C2C2C2
+r 43F8.8
+*Want C2C2C2C2 C2C2C2F2
+r 4400.8
+*Want C3C3C3C3 C3C3C3C3
+r 45F8.8
+*Want C3C3C3C3 C3C3C3F3
+
+detach  0100
+
+*Done
@@ -0,0 +1,15 @@
+#----------------------------------------------------------------------
+#           Test S/370 HET tape positioning with the block index
+#----------------------------------------------------------------------
+
+*Testcase S/370 HET tape positioning with the block index
+
+defsym  tapecuu     590                 # just a device number
+defsym  ftype       het                 # tape filename filetype
+defsym  tapefile    "tapeidx.$(ftype)"
+
+script "$(testpath)/tapeidx.subtst"
+
+*Done
+
+#-------------------------------------------------------------------
@@ -0,0 +1,130 @@
+*Testcase I/O interrupt queue: subclass masking and presentation order
+
+# Three printers are enabled with interruption subclasses 5, 2 and 5
+# and each is started with a NOP while CR6 enables no subclass.  The
+# CPU then waits for a CPU timer interruption, by which time all three
+# are status pending, enables only ISC 5 and waits for I/O: the first
+# ISC 5 device (intparm AAAA) must be presented although ISC 2 is
+# queued ahead of it.  The I/O handler then enables all subclasses, so
+# the ISC 2 device (BBBB) must come next and the second ISC 5 device
+# (CCCC) last.
+
+# Main program:
+#
+#   200  4150 0800          LA    R5,X'800'          result list
+#   204  5810 06F0          L     R1,X'6F0'          first SSID
+#   208  B234 0900    SCAN  STSCH X'900'
+#   20C  A714 0021          BRC   1,SCANDONE         no more subchannels
+#   210  4160 0600          LA    R6,X'600'          device table
+#   214  A778 0003          LHI   R7,3
+#   218  D501 0906 6000 MATCH CLC X'906'(2),0(R6)    our device?
+#   21E  A774 0010          BRC   7,NEXTENT
+#   222  4380 6002          IC    R8,2(R6)           its ISC
+#   226  8980 0003          SLL   R8,3
+#   22A  4280 0904          STC   R8,X'904'          PMCW ISC
+#   22E  9680 0905          OI    X'905',X'80'       enabled
+#   232  B232 0900          MSCH  X'900'
+#   236  A774 0025          BRC   7,FAIL
+#   23A  5010 6004          ST    R1,4(R6)           save SSID
+#   23E  4160 6010  NEXTENT LA    R6,16(R6)
+#   242  A776 FFEB          BRCT  R7,MATCH
+#   246  4110 1001          LA    R1,1(R1)
+#   24A  A7F4 FFDF          BRC   15,SCAN
+#   24E  4160 0600 SCANDONE LA    R6,X'600'
+#   252  4190 0A00          LA    R9,X'A00'          ORBs
+#   256  A778 0003          LHI   R7,3
+#   25A  5810 6004    SSCH  L     R1,4(R6)
+#   25E  B233 9000          SSCH  0(R9)
+#   262  A774 000F          BRC   7,FAIL
+#   266  4160 6010          LA    R6,16(R6)
+#   26A  4190 9020          LA    R9,32(R9)
+#   26E  A776 FFF6          BRCT  R7,SSCH
+#   272  B208 06F8          SPT   X'6F8'             100 milliseconds
+#   276  EB00 06D8 002F     LCTLG 0,0,X'6D8'         CPU timer subclass
+#   27C  B2B2 0650          LPSWE X'650'             external wait
+#   280  B2B2 0430    FAIL  LPSWE X'430'             failure
+#
+# I/O interrupt handler:
+#
+#   300  5810 00B8          L     R1,X'B8'           SSID
+#   304  B235 0A80          TSCH  X'A80'
+#   308  5880 00BC          L     R8,X'BC'           intparm
+#   30C  5080 5000          ST    R8,0(R5)
+#   310  4150 5004          LA    R5,4(R5)
+#   314  EB66 06E8 002F     LCTLG 6,6,X'6E8'         all ISCs
+#   31A  5950 06F4          C     R5,X'6F4'          all three?
+#   31E  A774 0009          BRC   7,WAIT
+#   322  D50B 0800 06A0     CLC   X'800'(12),X'6A0'
+#   328  A774 FFAC          BRC   7,FAIL
+#   32C  B2B2 0420          LPSWE X'420'             success
+#   330  B2B2 0640    WAIT  LPSWE X'640'             I/O wait
+#
+# External interrupt handler:
+#
+#   334  EB66 06E0 002F     LCTLG 6,6,X'6E0'         ISC 5 only
+#   33A  B2B2 0640          LPSWE X'640'             I/O wait
+
+mainsize 1
+numcpu 1
+sysclear
+archlvl z/Arch
+
+detach 0A1
+detach 0A2
+detach 0A3
+attach 0A1 1403 /dev/null
+attach 0A2 1403 /dev/null
+attach 0A3 1403 /dev/null
+
+r    1A0=00000001800000000000000000000200
+r    1B0=00000001800000000000000000000334
+r    1D0=0002000180000000000000000000DEAD
+r    1F0=00000001800000000000000000000300
+
+r    200=41500800581006F0B2340900A7140021
+r    210=41600600A7780003D50109066000A774
+r    220=00104380600289800003428009049680
+r    230=0905B2320900A7740025501060044160
+r    240=6010A776FFEB41101001A7F4FFDF4160
+r    250=060041900A00A778000358106004B233
+r    260=9000A774000F4160601041909020A776
+r    270=FFF6B20806F8EB0006D8002FB2B20650
+r    280=B2B20430
+
+r    300=581000B8B2350A80588000BC50805000
+r    310=41505004EB6606E8002F595006F4A774
+r    320=0009D50B080006A0A774FFACB2B20420
+r    330=B2B20640EB6606E0002FB2B20640
+
+r    420=00020001800000000000000000000000
+r    430=0002000180000000000000000000BAD0
+
+r    600=00A10500000000000000000000000000
+r    610=00A20200000000000000000000000000
+r    620=00A30500000000000000000000000000
+r    640=02020001800000000000000000000000
+r    650=01020001800000000000000000000000
+r    6A0=0000AAAA0000BBBB0000CCCC
+r    6D8=0000000000000400
+r    6E0=000000000400000000000000FF000000
+r    6F0=000100000000080C00000000186A0000
+
+r    A00=0000AAAA0080FF0000000B00
+r    A20=0000BBBB0080FF0000000B00
+r    A40=0000CCCC0080FF0000000B00
+r    B00=0320000100000C00
+
+runtest 1
+
+detach 0A1
+detach 0A2
+detach 0A3
+
+*Compare
+r 800.C
+*Want "Presentation order" 0000AAAA 0000BBBB 0000CCCC
+
+iointq
+iointq reset
+
+*Done
@@ -0,0 +1,98 @@
+*Testcase SIE state cache: guest storage change between dispatches
+
+# A z/Arch host dispatches the same state descriptor (at 3000) 1000
+# times with MSO=100000, then 1000 times with MSO=200000.  Each time
+# the guest adds the fullword at its absolute 300 to GR2 and loads a
+# disabled wait PSW (wait state interception).  The word is 1 in the
+# first guest image and 10000 in the second, so GR2 only ends up
+# 03E803E8 if the changed MSO is noticed and the guest TLB purged.
+# The test is run with the SIE state cache both disabled and enabled.
+
+# Host program:
+#
+#   200  EB11 0440 002F     LCTLG 1,1,X'440'      host primary ASCE
+#   206  A788 3000          LHI   R8,X'3000'      state descriptor
+#   20A  4120 0000          LA    R2,0            guest accumulator
+#   20E  41A0 0400          LA    R10,X'400'      host data
+#   212  A798 03E8          LHI   R9,1000
+#   216  D20F 8090 A000     MVC   X'90'(16,R8),0(R10)   guest PSW
+#   21C  B214 8000          SIE   0(R8)
+#   220  951C 8050          CLI   X'50'(R8),X'1C'       wait intercept?
+#   224  A774 0016          BRC   7,FAIL
+#   228  A796 FFF7          BRCT  R9,216
+#   22C  D20F 8080 A010     MVC   X'80'(16,R8),16(R10)  new MSO/MSE
+#   232  A798 03E8          LHI   R9,1000
+#   236  D20F 8090 A000     MVC   X'90'(16,R8),0(R10)
+#   23C  B214 8000          SIE   0(R8)
+#   240  951C 8050          CLI   X'50'(R8),X'1C'
+#   244  A774 0006          BRC   7,FAIL
+#   248  A796 FFF7          BRCT  R9,236
+#   24C  B2B2 0420          LPSWE X'420'          success
+#   250  B2B2 0430    FAIL  LPSWE X'430'          failure
+#
+# Guest absolute storage is host primary virtual storage, so the host
+# segment table at 10000 maps host virtual 100000 and 200000 (the first
+# page of each guest image) through the page tables at 11000 and 11800.
+#
+# Guest program (guest absolute 200):
+#
+#   200  5830 0300          L     R3,X'300'
+#   204  1A23               AR    R2,R3
+#   206  B2B2 0280          LPSWE X'280'          disabled wait
+
+mainsize 4
+numcpu 1
+sysclear
+archlvl z/Arch
+
+r    1A0=00000001800000000000000000000200
+r    1D0=0002000180000000000000000000DEAD
+
+r    200=EB110440002FA78830004120000041A0
+r    210=0400A79803E8D20F8090A000B2148000
+r    220=951C8050A7740016A796FFF7D20F8080
+r    230=A010A79803E8D20F8090A000B2148000
+r    240=951C8050A7740006A796FFF7B2B20420
+r    250=B2B20430
+
+r    400=00000001800000000000000000000200
+r    410=000000000020000000000000002FFFFF
+r    420=00020001800000000000000000000000
+r    430=0002000180000000000000000000BAD0
+r    440=0000000000010000
+
+r  10008=00000000000110000000000000011800
+r  11000=0000000000100000
+r  11800=0000000000200000
+
+r 100200=583003001A23B2B20280
+r 100280=00020001800000000000000000000000
+r 100300=00000001
+
+r 200200=583003001A23B2B20280
+r 200280=00020001800000000000000000000000
+r 200300=00010000
+
+*Compare
+
+siecache disable
+r   3000=0000080000000000
+r   3028=7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF
+r   3080=000000000010000000000000001FFFFF
+runtest .5
+gpr
+*Gpr 2 3E803E8
+
+siecache enable
+r   3000=0000080000000000
+r   3028=7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF
+r   3080=000000000010000000000000001FFFFF
+runtest .5
+gpr
+*Gpr 2 3E803E8
+
+siecache
+siecache disable
+siecache reset
+
+*Done
@@ -0,0 +1,171 @@
+*Testcase Tape streaming: write-behind then read-ahead
+
+# Three 4K blocks and a tapemark are written to a new tape with
+# stream=8, the tape is rewound and the blocks read back, all in one
+# chained channel program.  Done once for AWSTAPE, once for HET and
+# once for HET with the blocks compressed by two threads (cthreads=2).
+# On Linux the last case writes to /dev/full: both writes complete,
+# and the failed write is reported as a deferred unit check on the
+# Synchronize that follows them.
+
+mainsize    1
+numcpu      1
+archlvl     S/370
+sysclear    # must FOLLOW archlvl command!
+
+r 00=0008000000000200       # Restart New PSW
+r 68=000A00000000DEAD       # Program Check New PSW
+r 78=000A000000000000       # I/O Interrupt New PSW
+
+r 200=41100500              # R1 --> Channel program
+r 204=50100048              # Store into CAW
+r 208=9C000580              # SIO X'580'
+r 20C=4730021C              # cc=2, cc=3: FAIL
+r 210=47400218              # cc=1: CSW stored
+r 214=82000400              # Wait for I/O interrupt
+r 218=82000078              # Test finished
+r 21C=82000408              # SIO failed
+
+r 400=020A000000000000      # Wait on I/O PSW
+r 408=000A000000EEEEEE      # SIO failure PSW
+
+r 500=0700000060000001      # Rewind
+r 508=0100100060001000      # Write 4K from 1000
+r 510=0100200060001000      # Write 4K from 2000
+r 518=0100300060001000      # Write 4K from 3000
+r 520=1F00000060000001      # Write tapemark
+r 528=0700000060000001      # Rewind
+r 530=0200400060001000      # Read 4K into 4000
+r 538=0200500060001000      # Read 4K into 5000
+r 540=0200600020001000      # Read 4K into 6000
+
+r 1000=C1C1C1C1C1C1C1C1     # block 1
+r 1FF8=C1C1C1C1C1C1C1F1
+r 2000=C2C2C2C2C2C2C2C2     # block 2
+r 2FF8=C2C2C2C2C2C2C2F2
+r 3000=C3C3C3C3C3C3C3C3     # block 3
+r 3FF8=C3C3C3C3C3C3C3F3
+
+detach  0580
+attach  0580  3490  "tapestrm.aws"  stream=8
+
+runtest   1
+
+*Compare
+r 44.4
+*Want "Good CSW" 0C000000
+r 4000.8
+*Want C1C1C1C1 C1C1C1C1
+r 4FF8.8
+*Want C1C1C1C1 C1C1C1F1
+r 5000.8
+*Want C2C2C2C2 C2C2C2C2
+r 5FF8.8
+*Want C2C2C2C2 C2C2C2F2
+r 6000.8
+*Want C3C3C3C3 C3C3C3C3
+r 6FF8.8
+*Want C3C3C3C3 C3C3C3F3
+
+devlist 0580
+detach  0580
+
+r 44=00000000
+r 4000=0000000000000000
+r 4FF8=0000000000000000
+r 5000=0000000000000000
+r 5FF8=0000000000000000
+r 6000=0000000000000000
+r 6FF8=0000000000000000
+
+attach  0580  3490  "tapestrm.het"  stream=8 compress=1
+
+runtest   1
+
+*Compare
+r 44.4
+*Want "Good CSW" 0C000000
+r 4000.8
+*Want C1C1C1C1 C1C1C1C1
+r 4FF8.8
+*Want C1C1C1C1 C1C1C1F1
+r 5000.8
+*Want C2C2C2C2 C2C2C2C2
+r 5FF8.8
+*Want C2C2C2C2 C2C2C2F2
+r 6000.8
+*Want C3C3C3C3 C3C3C3C3
+r 6FF8.8
+*Want C3C3C3C3 C3C3C3F3
+
+devlist 0580
+detach  0580
+
+r 44=00000000
+r 4000=0000000000000000
+r 4FF8=0000000000000000
+r 5000=0000000000000000
+r 5FF8=0000000000000000
+r 6000=0000000000000000
+r 6FF8=0000000000000000
+
+attach  0580  3490  "tapecthr.het"  compress=1 cthreads=2
+
+runtest   1
+
+*Compare
+r 44.4
+*Want "Good CSW" 0C000000
+r 4000.8
+*Want C1C1C1C1 C1C1C1C1
+r 4FF8.8
+*Want C1C1C1C1 C1C1C1F1
+r 5000.8
+*Want C2C2C2C2 C2C2C2C2
+r 5FF8.8
+*Want C2C2C2C2 C2C2C2F2
+r 6000.8
+*Want C3C3C3C3 C3C3C3C3
+r 6FF8.8
+*Want C3C3C3C3 C3C3C3F3
+
+devlist 0580
+detach  0580
+
+*If $platform = "Linux"
+
+    r 200=41100800              # R1 --> Write then Synchronize
+
+    r 800=0100100060001000      # Write 4K from 1000
+    r 808=0100200060001000      # Write 4K from 2000
+    r 810=4300000020000001      # Synchronize
+
+    r 900=0400700020000020      # Sense
+
+    # ("//dev/full", since "/dev/..." would be taken as a SCSI tape)
+    attach  0580  3490  "//dev/full"  stream=8
+
+    runtest   1
+
+    *Compare
+    r 40.8
+    *Want "Unit check on Synchronize" 00000818 0E000001
+
+    r 200=41100900              # R1 --> Sense
+
+    runtest   1
+
+    *Compare
+    r 44.4
+    *Want "Good CSW" 0C000000
+    r 7000.4
+    *Want "Equipment check, physical end of tape" 10402038
+
+    detach  0580
+
+*Else
+    *Message SKIPPING: Testcase Tape streaming deferred write error
+    *Message REASON:   No /dev/full
+*Fi
+
+*Done
@@ -0,0 +1,742 @@
+ TITLE '            unicode-performance (Test Unicode conversions)'
+***********************************************************************
+*
+*        Unicode conversion and translate instruction tests
+*
+***********************************************************************
+*
+*  This program converts text between UTF-8, UTF-16 and UTF-32 with
+*  CU12, CU21, CU14, CU41, CU24 and CU42 and translates it with TROO,
+*  TROT, TRTO and TRTT: plain ASCII, European text with occasional
+*  multi-byte characters, and Japanese text, some of it with a
+*  character outside the basic plane.  Some of the operands are at odd
+*  addresses and all of them cross a page boundary.  Each conversion
+*  is repeated for as long as the instruction ends with condition code
+*  3, and the result and final condition code are checked against the
+*  expected values.
+*
+*
+*                     ********************
+*                     **   IMPORTANT!   **
+*                     ********************
+*
+*        This test uses the Hercules Diagnose X'008' interface
+*        to display messages and thus your .tst runtest script
+*        MUST contain a "DIAG8CMD ENABLE" statement within it!
+*
+***********************************************************************
+*
+*  Example Hercules Testcase:
+*
+*
+*      *Testcase unicode-performance (Test Unicode conversion ...)
+*
+*      mainsize    16
+*      numcpu      1
+*      sysclear
+*      archlvl     z/Arch
+*      loadcore    "$(testpath)/unicode-performance.core" 0x0
+*      diag8cmd    enable   # (needed for messages to Hercules console)
+*      #r           848=ff  # (enable timing tests)
+*      runtest     300      # (test duration, depends on host)
+*      diag8cmd    disable  # (reset back to default)
+*      *Done
+*
+*
+***********************************************************************
+                                                                SPACE 3
+UNIPERF  START 0
+         USING UNIPERF,R0             Low core addressability
+                                                                SPACE 4
+         ORG   UNIPERF+X'1A0'         z/Architecure RESTART PSW
+         DC    X'0000000180000000'
+         DC    AD(BEGIN)
+                                                                SPACE 2
+         ORG   UNIPERF+X'1D0'         z/Architecure PROGRAM CHECK PSW
+         DC    X'0002000180000000'
+         DC    AD(X'DEAD')
+                                                                SPACE 4
+         ORG   UNIPERF+X'200'         Start of actual test program...
+                                                                EJECT
+***********************************************************************
+*               The actual "UNIPERF" program itself...
+***********************************************************************
+*
+*  Architecture Mode: z/Arch
+*  Register Usage:
+*
+*   R0-R5    (used by the conversions)
+*   R1       Condition code
+*   R2-R5    CLCL operands, DIAG8 message address and length
+*   R7       Timing loop count
+*   R12      RUN subroutine call
+*   R13      Current table entry
+*   R14      Subroutine call
+*
+***********************************************************************
+                                                                SPACE
+BEGIN    BRAS  R14,CHECK              Check the results
+         CLI   TIMEOPT,X'FF'          Timing tests requested?
+         BRC   7,DONE                 No, then we are done
+         BRAS  R14,TIME               Time the conversions
+                                                                SPACE
+DONE     LPSWE GOODPSW                Load success wait PSW
+FAIL     LPSWE FAILPSW                Load failure wait PSW
+                                                                EJECT
+***********************************************************************
+*        CHECK                  Verify each table entry's results
+***********************************************************************
+                                                                SPACE
+CHECK    LARL  R13,TABLE              Point to the first entry
+CHECK1   CLI   0(R13),X'00'           End of table?
+         BER   R14                    Yes, return
+                                                                SPACE
+         LGHI  R7,1                   Run the conversion once
+         BRAS  R12,RUN                ...and get its condition code
+         LH    R2,UNIROFF(,R13)       Result offset
+         AR    R2,R13
+         LH    R3,UNIRLEN(,R13)       Result length
+         LH    R4,UNIXOFF(,R13)       Expected result offset
+         AR    R4,R13
+         LR    R5,R3
+         CLCL  R2,R4                  Expected result?
+         BRC   7,FAIL                 No, fail the test
+         SRL   R1,28                  Isolate the condition code
+         STC   R1,CCOUT
+         CLC   CCOUT,UNICC(R13)       Expected condition code?
+         BRC   7,FAIL                 No, fail the test
+                                                                SPACE
+         LAY   R13,UNILEN(,R13)       Point to the next entry
+         BRC   15,CHECK1              ...and check it
+                                                                EJECT
+***********************************************************************
+*        TIME                   Time each table entry's conversion
+***********************************************************************
+                                                                SPACE
+TIME     LARL  R13,TABLE              Point to the first entry
+TIME1    CLI   0(R13),X'00'           End of table?
+         BER   R14                    Yes, return
+                                                                SPACE
+         LGFI  R7,100000              Iterations of the conversion
+         BRAS  R12,RUN                Run it
+                                                                SPACE
+         LG    R1,ENDCLOCK            Elapsed TOD clock units...
+         SLG   R1,BEGCLOCK
+         SRLG  R1,R1,12               ...in microseconds
+         CVDG  R1,DEC                 Convert to decimal
+                                                                SPACE
+         MVC   MSGNAME,UNINAME(R13)   Conversion name
+         MVC   MSGNUM,EDPAT           Edit the microseconds
+         ED    MSGNUM,DEC+11
+         LA    R2,MSGCMD              Message command
+         LA    R3,MSGLEN              ...and its length
+         DC    X'83230008'            DIAG 8 to issue it
+                                                                SPACE
+         LAY   R13,UNILEN(,R13)       Point to the next entry
+         BRC   15,TIME1               ...and time it
+                                                                EJECT
+***********************************************************************
+*        RUN                    Run the conversion at R13 R7 times
+***********************************************************************
+                                                                SPACE
+RUN      MVC   LOOP(48),0(R13)        Plant the conversion
+         STCK  BEGCLOCK               Start time
+LOOP     DC    8X'070007000700'       (instructions under test)
+         BRCTG R7,LOOP                Repeat the conversion
+         IPM   R1                     Save its condition code
+         STCK  ENDCLOCK               End time
+         BR    R12                    Return
+                                                                EJECT
+***********************************************************************
+*        Working storage
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'800'
+                                                                SPACE
+GOODPSW  DC    0D'0',X'0002000180000000',AD(0)      Success wait PSW
+FAILPSW  DC    0D'0',X'0002000180000000',AD(X'BAD0') Failure wait PSW
+                                                                SPACE
+CCOUT    DS    X                      Condition code
+BEGCLOCK DS    D                      TOD clock at start of loop
+ENDCLOCK DS    D                      TOD clock at end of loop
+DEC      DS    PL16                   Elapsed microseconds
+TIMEOPT  DC    X'00'                  Set to X'FF' to run timing tests
+                                                                SPACE 2
+         ORG   UNIPERF+X'880'
+                                                                SPACE
+MSGCMD   DC    C'MSGNOH * 100,000 iterations of '
+MSGNAME  DC    CL8' '                 Conversion name
+         DC    C' took '
+MSGNUM   DC    CL12' '                Edited microseconds
+         DC    C' microseconds'
+MSGLEN   EQU   *-MSGCMD               Length of the message command
+                                                                SPACE 2
+         ORG   UNIPERF+X'900'
+                                                                SPACE
+EDPAT    DC    X'402020206B2020206B202120'  Edit pattern
+                                                                EJECT
+***********************************************************************
+*        Test table:  16K per entry
+*
+*          +0     conversion to run, padded to 48 bytes
+*          +48    conversion name
+*          +56    expected condition code
+*          +64    result offset and length, expected result offset
+*          +X'E00'   source (some at an odd address)
+*          +X'1E80'  result (some at an odd address)
+*          +X'2C00'  expected result
+*
+*        The conversions address their operands through R13, which
+*        points to the table entry; the translate tables are at fixed
+*        addresses.
+***********************************************************************
+                                                                SPACE
+UNINAME  EQU   48                     Conversion name
+UNICC    EQU   56                     Expected condition code
+UNIROFF  EQU   64                     Result offset
+UNIRLEN  EQU   66                     Result length
+UNIXOFF  EQU   68                     Expected result offset
+UNISRC   EQU   X'E00'                 Source
+UNIRES   EQU   X'1E80'                Result
+UNIEXP   EQU   X'2C00'                Expected result
+UNILEN   EQU   X'4000'                Length of an entry
+                                                                SPACE
+         ORG   UNIPERF+X'10000'
+TABLE    DS    0D
+                                                                EJECT
+***********************************************************************
+*        T01:  CU12 UTF-8 to UTF-16, ASCII text
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'10000'
+T01      LAY   R2,UNIRES(,R13)        Result
+         LHI   R3,T01XL
+         LAY   R4,UNISRC(,R13)        Source
+         LHI   R5,T01SL
+         CU12  R2,R4
+         BRC   1,*-4                  CPU-determined amount
+         DC    10X'0700'              (padding)
+         DC    CL8'CU12ASC'           Name
+         DC    AL1(0),XL7'00'         Expected condition code
+         DC    AL2(UNIRES,T01XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T01+UNISRC
+*        Source: 'Quick brown ', UTF-8
+T01S     DC    50X'517569636B2062726F776E20'
+T01SL    EQU   *-T01S                 Source length
+                                                                SPACE
+         ORG   T01+UNIEXP
+T01X     DC    50X'0051007500690063006B002000620072006F0077006E0020'
+T01XL    EQU   *-T01X                 Expected result length
+                                                                EJECT
+***********************************************************************
+*        T02:  CU12 UTF-8 to UTF-16, European text
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'14000'
+T02      LAY   R2,UNIRES(,R13)        Result
+         LHI   R3,T02XL
+         LAY   R4,UNISRC(,R13)        Source
+         LHI   R5,T02SL
+         CU12  R2,R4
+         BRC   1,*-4                  CPU-determined amount
+         DC    10X'0700'              (padding)
+         DC    CL8'CU12MIX'           Name
+         DC    AL1(0),XL7'00'         Expected condition code
+         DC    AL2(UNIRES,T02XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T02+UNISRC
+*        Source: 'Gr(u-umlaut)(sharp s)e 2(euro) (U+1F600) ', UTF-8
+T02S     DC    30X'4772C3BCC39F652032E282AC20F09F988020'
+T02SL    EQU   *-T02S                 Source length
+                                                                SPACE
+         ORG   T02+UNIEXP
+T02X     DC    30X'0047007200FC00DF00650020003220AC0020D83DDE000020'
+T02XL    EQU   *-T02X                 Expected result length
+                                                                EJECT
+***********************************************************************
+*        T03:  CU21 UTF-16 to UTF-8, ASCII text
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'18000'
+T03      LAY   R2,UNIRES(,R13)        Result
+         LHI   R3,T03XL
+         LAY   R4,UNISRC(,R13)        Source
+         LHI   R5,T03SL
+         CU21  R2,R4
+         BRC   1,*-4                  CPU-determined amount
+         DC    10X'0700'              (padding)
+         DC    CL8'CU21ASC'           Name
+         DC    AL1(0),XL7'00'         Expected condition code
+         DC    AL2(UNIRES,T03XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T03+UNISRC
+*        Source: 'Quick brown ', UTF-16
+T03S     DC    50X'0051007500690063006B002000620072006F0077006E0020'
+T03SL    EQU   *-T03S                 Source length
+                                                                SPACE
+         ORG   T03+UNIEXP
+T03X     DC    50X'517569636B2062726F776E20'
+T03XL    EQU   *-T03X                 Expected result length
+                                                                EJECT
+***********************************************************************
+*        T04:  CU21 UTF-16 to UTF-8, European text
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'1C000'
+T04      LAY   R2,UNIRES(,R13)        Result
+         LHI   R3,T04XL
+         LAY   R4,UNISRC(,R13)        Source
+         LHI   R5,T04SL
+         CU21  R2,R4
+         BRC   1,*-4                  CPU-determined amount
+         DC    10X'0700'              (padding)
+         DC    CL8'CU21MIX'           Name
+         DC    AL1(0),XL7'00'         Expected condition code
+         DC    AL2(UNIRES,T04XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T04+UNISRC
+*        Source: 'Gr(u-umlaut)(sharp s)e 2(euro) (U+1F600) ', UTF-16
+T04S     DC    30X'0047007200FC00DF00650020003220AC0020D83DDE000020'
+T04SL    EQU   *-T04S                 Source length
+                                                                SPACE
+         ORG   T04+UNIEXP
+T04X     DC    30X'4772C3BCC39F652032E282AC20F09F988020'
+T04XL    EQU   *-T04X                 Expected result length
+                                                                EJECT
+***********************************************************************
+*        T05:  CU14 UTF-8 to UTF-32, European text
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'20000'
+T05      LAY   R2,UNIRES(,R13)        Result
+         LHI   R3,T05XL
+         LAY   R4,UNISRC(,R13)        Source
+         LHI   R5,T05SL
+         CU14  R2,R4
+         BRC   1,*-4                  CPU-determined amount
+         DC    10X'0700'              (padding)
+         DC    CL8'CU14MIX'           Name
+         DC    AL1(0),XL7'00'         Expected condition code
+         DC    AL2(UNIRES,T05XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T05+UNISRC
+*        Source: 'Gr(u-umlaut)(euro)(U+1F600) ', UTF-8
+T05S     DC    50X'4772C3BCE282ACF09F988020'
+T05SL    EQU   *-T05S                 Source length
+                                                                SPACE
+         ORG   T05+UNIEXP
+T05X     DC    50X'0000004700000072000000FC000020AC0001F60000000020'
+T05XL    EQU   *-T05X                 Expected result length
+                                                                EJECT
+***********************************************************************
+*        T06:  CU41 UTF-32 to UTF-8, ASCII text
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'24000'
+T06      LAY   R2,UNIRES(,R13)        Result
+         LHI   R3,T06XL
+         LAY   R4,UNISRC(,R13)        Source
+         LHI   R5,T06SL
+         CU41  R2,R4
+         BRC   1,*-4                  CPU-determined amount
+         DC    10X'0700'              (padding)
+         DC    CL8'CU41ASC'           Name
+         DC    AL1(0),XL7'00'         Expected condition code
+         DC    AL2(UNIRES,T06XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T06+UNISRC
+*        Source: 'Quick ', UTF-32
+T06S     DC    80X'000000510000007500000069000000630000006B00000020'
+T06SL    EQU   *-T06S                 Source length
+                                                                SPACE
+         ORG   T06+UNIEXP
+T06X     DC    80X'517569636B20'
+T06XL    EQU   *-T06X                 Expected result length
+                                                                EJECT
+***********************************************************************
+*        T07:  CU24 UTF-16 to UTF-32, Japanese text
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'28000'
+T07      LAY   R2,UNIRES(,R13)        Result
+         LHI   R3,T07XL
+         LAY   R4,UNISRC+X'101'(,R13)  Source
+         LHI   R5,T07SL
+         CU24  R2,R4
+         BRC   1,*-4                  CPU-determined amount
+         DC    10X'0700'              (padding)
+         DC    CL8'CU24JPN'           Name
+         DC    AL1(0),XL7'00'         Expected condition code
+         DC    AL2(UNIRES,T07XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T07+UNISRC+X'101'
+*        Source: kore wa (hiragana) nihongo (kanji), UTF-16
+T07S     DC    50X'3053308C306F65E5672C8A9E'
+T07SL    EQU   *-T07S                 Source length
+                                                                SPACE
+         ORG   T07+UNIEXP
+T07X     DC    50X'000030530000308C0000306F000065E50000672C00008A9E'
+T07XL    EQU   *-T07X                 Expected result length
+                                                                EJECT
+***********************************************************************
+*        T08:  CU42 UTF-32 to UTF-16, Japanese text
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'2C000'
+T08      LAY   R2,UNIRES+1(,R13)      Result
+         LHI   R3,T08XL
+         LAY   R4,UNISRC(,R13)        Source
+         LHI   R5,T08SL
+         CU42  R2,R4
+         BRC   1,*-4                  CPU-determined amount
+         DC    10X'0700'              (padding)
+         DC    CL8'CU42JPN'           Name
+         DC    AL1(0),XL7'00'         Expected condition code
+         DC    AL2(UNIRES+1,T08XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T08+UNISRC
+*        Source: nihongo (kanji), U+1F363, tesu (katakana), UTF-32
+T08S     DC    50X'000065E50000672C00008A9E0001F363000030C6000030B9'
+T08SL    EQU   *-T08S                 Source length
+                                                                SPACE
+         ORG   T08+UNIEXP
+T08X     DC    50X'65E5672C8A9ED83CDF6330C630B9'
+T08XL    EQU   *-T08X                 Expected result length
+                                                                EJECT
+***********************************************************************
+*        T09:  TROO EBCDIC to ISO-8859-1
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'30000'
+T09      LAY   R2,UNIRES(,R13)        Result
+         LHI   R3,T09SL
+         LAY   R4,UNISRC(,R13)        Source
+         LGFI  R1,TROOTAB             Translate table
+         LHI   R0,0
+         TROO  R2,R4,1
+         BRC   1,*-4                  CPU-determined amount
+         DC    7X'0700'               (padding)
+         DC    CL8'TROOASC'           Name
+         DC    AL1(0),XL7'00'         Expected condition code
+         DC    AL2(UNIRES,T09XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T09+UNISRC
+*        Source: 'The quick brown fox ', EBCDIC
+T09S     DC    35CL20'The quick brown fox '
+T09SL    EQU   *-T09S                 Source length
+                                                                SPACE
+         ORG   T09+UNIEXP
+T09X     DC    35X'54686520717569636B2062726F776E20666F7820'
+T09XL    EQU   *-T09X                 Expected result length
+                                                                EJECT
+***********************************************************************
+*        T10:  TROO stopping on a test character
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'34000'
+T10      LAY   R2,UNIRES(,R13)        Result
+         LHI   R3,T10SL
+         LAY   R4,UNISRC(,R13)        Source
+         LGFI  R1,TROOTAB             Translate table
+         LHI   R0,122                 Test character
+         TROO  R2,R4,0
+         BRC   1,*-4                  CPU-determined amount
+         DC    7X'0700'               (padding)
+         DC    CL8'TROOTST'           Name
+         DC    AL1(1),XL7'00'         Expected condition code
+         DC    AL2(UNIRES,T10XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T10+UNISRC
+*        Source: 'The lazy brown dog. ', EBCDIC
+T10S     DC    35CL20'The lazy brown dog. '
+T10SL    EQU   *-T10S                 Source length
+                                                                SPACE
+         ORG   T10+UNIEXP
+T10X     DC    X'546865206C61'
+         DC    XL694'00'              Not translated
+T10XL    EQU   *-T10X                 Expected result length
+                                                                EJECT
+***********************************************************************
+*        T11:  TROT EBCDIC to UTF-16
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'38000'
+T11      LAY   R2,UNIRES(,R13)        Result
+         LHI   R3,T11SL
+         LAY   R4,UNISRC(,R13)        Source
+         LGFI  R1,TROTTAB             Translate table
+         LHI   R0,0
+         TROT  R2,R4,1
+         BRC   1,*-4                  CPU-determined amount
+         DC    7X'0700'               (padding)
+         DC    CL8'TROTASC'           Name
+         DC    AL1(0),XL7'00'         Expected condition code
+         DC    AL2(UNIRES,T11XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T11+UNISRC
+*        Source: 'Quick brown ', EBCDIC
+T11S     DC    60CL12'Quick brown '
+T11SL    EQU   *-T11S                 Source length
+                                                                SPACE
+         ORG   T11+UNIEXP
+T11X     DC    60X'0051007500690063006B002000620072006F0077006E0020'
+T11XL    EQU   *-T11X                 Expected result length
+                                                                EJECT
+***********************************************************************
+*        T12:  TRTO UTF-16 to EBCDIC, mixed scripts
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'3C000'
+T12      LAY   R2,UNIRES(,R13)        Result
+         LHI   R3,T12SL
+         LAY   R4,UNISRC(,R13)        Source
+         LGFI  R1,TRTOTAB             Translate table
+         LHI   R0,0
+         TRTO  R2,R4,1
+         BRC   1,*-4                  CPU-determined amount
+         DC    7X'0700'               (padding)
+         DC    CL8'TRTOMIX'           Name
+         DC    AL1(0),XL7'00'         Expected condition code
+         DC    AL2(UNIRES,T12XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T12+UNISRC
+*        Source: 'Set! ' tesuto (katakana), full stop, kanji, UTF-16
+T12S     DC    50X'0053006500740021002030C630B930C830026F225B570020'
+T12SL    EQU   *-T12S                 Source length
+                                                                SPACE
+         ORG   T12+UNIEXP
+T12X     DC    50X'E285A35A4046794842000040'
+T12XL    EQU   *-T12X                 Expected result length
+                                                                EJECT
+***********************************************************************
+*        T13:  TRTT UTF-16 upper case and katakana
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'40000'
+T13      LAY   R2,UNIRES+1(,R13)      Result
+         LHI   R3,T13SL
+         LAY   R4,UNISRC+1(,R13)      Source
+         LGFI  R1,TRTTTAB             Translate table
+         LHI   R0,0
+         TRTT  R2,R4,1
+         BRC   1,*-4                  CPU-determined amount
+         DC    7X'0700'               (padding)
+         DC    CL8'TRTTMIX'           Name
+         DC    AL1(0),XL7'00'         Expected condition code
+         DC    AL2(UNIRES+1,T13XL,UNIEXP)  Result, expected
+                                                                SPACE
+         ORG   T13+UNISRC+1
+*        Source: 'data! ' kore wa (hiragana) nihon (kanji), UTF-16
+T13S     DC    50X'0064006100740061002100203053308C306F65E5672C0020'
+T13SL    EQU   *-T13S                 Source length
+                                                                SPACE
+         ORG   T13+UNIEXP
+T13X     DC    50X'00440041005400410021002030B330EC30CF000000000020'
+T13XL    EQU   *-T13X                 Expected result length
+                                                                EJECT
+         ORG   UNIPERF+X'44000'
+         DC    X'00'                  End of table
+                                                                EJECT
+***********************************************************************
+*        TROO table: EBCDIC to ISO-8859-1
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'80000'
+TROOTAB  DC    X'000102039C09867F978D8E0B0C0D0E0F'
+         DC    X'101112139D8508871819928F1C1D1E1F'
+         DC    X'80818283840A171B88898A8B8C050607'
+         DC    X'909116939495960498999A9B14159E1A'
+         DC    X'20A0E2E4E0E1E3E5E7F1A22E3C282B7C'
+         DC    X'26E9EAEBE8EDEEEFECDF21242A293BAC'
+         DC    X'2D2FC2C4C0C1C3C5C7D1A62C255F3E3F'
+         DC    X'F8C9CACBC8CDCECFCC603A2340273D22'
+         DC    X'D8616263646566676869ABBBF0FDFEB1'
+         DC    X'B06A6B6C6D6E6F707172AABAE6B8C6A4'
+         DC    X'B57E737475767778797AA1BFD0DDDEAE'
+         DC    X'5EA3A5B7A9A7B6BCBDBE5B5DAFA8B4D7'
+         DC    X'7B414243444546474849ADF4F6F2F3F5'
+         DC    X'7D4A4B4C4D4E4F505152B9FBFCF9FAFF'
+         DC    X'5CF7535455565758595AB2D4D6D2D3D5'
+         DC    X'30313233343536373839B3DBDCD9DA9F'
+                                                                EJECT
+***********************************************************************
+*        TROT table: EBCDIC to UTF-16
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'81000'
+TROTTAB  DC    X'0000000100020003009C00090086007F'
+         DC    X'0097008D008E000B000C000D000E000F'
+         DC    X'0010001100120013009D008500080087'
+         DC    X'001800190092008F001C001D001E001F'
+         DC    X'00800081008200830084000A0017001B'
+         DC    X'00880089008A008B008C000500060007'
+         DC    X'00900091001600930094009500960004'
+         DC    X'00980099009A009B00140015009E001A'
+         DC    X'002000A000E200E400E000E100E300E5'
+         DC    X'00E700F100A2002E003C0028002B007C'
+         DC    X'002600E900EA00EB00E800ED00EE00EF'
+         DC    X'00EC00DF00210024002A0029003B00AC'
+         DC    X'002D002F00C200C400C000C100C300C5'
+         DC    X'00C700D100A6002C0025005F003E003F'
+         DC    X'00F800C900CA00CB00C800CD00CE00CF'
+         DC    X'00CC0060003A002300400027003D0022'
+         DC    X'00D80061006200630064006500660067'
+         DC    X'0068006900AB00BB00F000FD00FE00B1'
+         DC    X'00B0006A006B006C006D006E006F0070'
+         DC    X'0071007200AA00BA00E600B800C600A4'
+         DC    X'00B5007E007300740075007600770078'
+         DC    X'0079007A00A100BF00D000DD00DE00AE'
+         DC    X'005E00A300A500B700A900A700B600BC'
+         DC    X'00BD00BE005B005D00AF00A800B400D7'
+         DC    X'007B0041004200430044004500460047'
+         DC    X'0048004900AD00F400F600F200F300F5'
+         DC    X'007D004A004B004C004D004E004F0050'
+         DC    X'0051005200B900FB00FC00F900FA00FF'
+         DC    X'005C00F7005300540055005600570058'
+         DC    X'0059005A00B200D400D600D200D300D5'
+         DC    X'00300031003200330034003500360037'
+         DC    X'0038003900B300DB00DC00D900DA009F'
+                                                                EJECT
+***********************************************************************
+*        TRTO table: U+0000-00FF to EBCDIC
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'90000'
+TRTOTAB  DC    X'00010203372D2E2F1605250B0C0D0E0F'
+         DC    X'101112133C3D322618193F271C1D1E1F'
+         DC    X'405A7F7B5B6C507D4D5D5C4E6B604B61'
+         DC    X'F0F1F2F3F4F5F6F7F8F97A5E4C7E6E6F'
+         DC    X'7CC1C2C3C4C5C6C7C8C9D1D2D3D4D5D6'
+         DC    X'D7D8D9E2E3E4E5E6E7E8E9BAE0BBB06D'
+         DC    X'79818283848586878889919293949596'
+         DC    X'979899A2A3A4A5A6A7A8A9C04FD0A107'
+         DC    X'202122232415061728292A2B2C090A1B'
+         DC    X'30311A333435360838393A3B04143EFF'
+         DC    X'41AA4AB19FB26AB5BDB49A8A5FCAAFBC'
+         DC    X'908FEAFABEA0B6B39DDA9B8BB7B8B9AB'
+         DC    X'6465626663679E687471727378757677'
+         DC    X'AC69EDEEEBEFECBF80FDFEFBFCADAE59'
+         DC    X'4445424643479C485451525358555657'
+         DC    X'8C49CDCECBCFCCE170DDDEDBDC8D8EDF'
+                                                                EJECT
+***********************************************************************
+*        TRTO table: U+3000-30FF to EBCDIC
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'93000'
+         DC    X'404142434445464748494A4B4C4D4E4F'
+         DC    X'505152535455565758595A5B5C5D5E5F'
+         DC    X'606162636465666768696A6B6C6D6E6F'
+         DC    X'707172737475767778797A7B7C7D7E7F'
+         DC    X'404142434445464748494A4B4C4D4E4F'
+         DC    X'505152535455565758595A5B5C5D5E5F'
+         DC    X'606162636465666768696A6B6C6D6E6F'
+         DC    X'707172737475767778797A7B7C7D7E7F'
+         DC    X'404142434445464748494A4B4C4D4E4F'
+         DC    X'505152535455565758595A5B5C5D5E5F'
+         DC    X'606162636465666768696A6B6C6D6E6F'
+         DC    X'707172737475767778797A7B7C7D7E7F'
+         DC    X'404142434445464748494A4B4C4D4E4F'
+         DC    X'505152535455565758595A5B5C5D5E5F'
+         DC    X'606162636465666768696A6B6C6D6E6F'
+         DC    X'707172737475767778797A7B7C7D7E7F'
+                                                                EJECT
+***********************************************************************
+*        TRTT table: U+0000-00FF to upper case
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'A0000'
+TRTTTAB  DC    X'00000001000200030004000500060007'
+         DC    X'00080009000A000B000C000D000E000F'
+         DC    X'00100011001200130014001500160017'
+         DC    X'00180019001A001B001C001D001E001F'
+         DC    X'00200021002200230024002500260027'
+         DC    X'00280029002A002B002C002D002E002F'
+         DC    X'00300031003200330034003500360037'
+         DC    X'00380039003A003B003C003D003E003F'
+         DC    X'00400041004200430044004500460047'
+         DC    X'00480049004A004B004C004D004E004F'
+         DC    X'00500051005200530054005500560057'
+         DC    X'00580059005A005B005C005D005E005F'
+         DC    X'00600041004200430044004500460047'
+         DC    X'00480049004A004B004C004D004E004F'
+         DC    X'00500051005200530054005500560057'
+         DC    X'00580059005A007B007C007D007E007F'
+         DC    X'00800081008200830084008500860087'
+         DC    X'00880089008A008B008C008D008E008F'
+         DC    X'00900091009200930094009500960097'
+         DC    X'00980099009A009B009C009D009E009F'
+         DC    X'00A000A100A200A300A400A500A600A7'
+         DC    X'00A800A900AA00AB00AC00AD00AE00AF'
+         DC    X'00B000B100B200B300B400B500B600B7'
+         DC    X'00B800B900BA00BB00BC00BD00BE00BF'
+         DC    X'00C000C100C200C300C400C500C600C7'
+         DC    X'00C800C900CA00CB00CC00CD00CE00CF'
+         DC    X'00D000D100D200D300D400D500D600D7'
+         DC    X'00D800D900DA00DB00DC00DD00DE00DF'
+         DC    X'00C000C100C200C300C400C500C600C7'
+         DC    X'00C800C900CA00CB00CC00CD00CE00CF'
+         DC    X'00D000D100D200D300D400D500D600F7'
+         DC    X'00D800D900DA00DB00DC00DD00DE00FF'
+                                                                EJECT
+***********************************************************************
+*        TRTT table: U+3000-30FF hiragana to katakana
+***********************************************************************
+                                                                SPACE
+         ORG   UNIPERF+X'A6000'
+         DC    X'30003001300230033004300530063007'
+         DC    X'30083009300A300B300C300D300E300F'
+         DC    X'30103011301230133014301530163017'
+         DC    X'30183019301A301B301C301D301E301F'
+         DC    X'30203021302230233024302530263027'
+         DC    X'30283029302A302B302C302D302E302F'
+         DC    X'30303031303230333034303530363037'
+         DC    X'30383039303A303B303C303D303E303F'
+         DC    X'304030A130A230A330A430A530A630A7'
+         DC    X'30A830A930AA30AB30AC30AD30AE30AF'
+         DC    X'30B030B130B230B330B430B530B630B7'
+         DC    X'30B830B930BA30BB30BC30BD30BE30BF'
+         DC    X'30C030C130C230C330C430C530C630C7'
+         DC    X'30C830C930CA30CB30CC30CD30CE30CF'
+         DC    X'30D030D130D230D330D430D530D630D7'
+         DC    X'30D830D930DA30DB30DC30DD30DE30DF'
+         DC    X'30E030E130E230E330E430E530E630E7'
+         DC    X'30E830E930EA30EB30EC30ED30EE30EF'
+         DC    X'30F030F130F230F330F430F530F63097'
+         DC    X'30983099309A309B309C309D309E309F'
+         DC    X'30A030A130A230A330A430A530A630A7'
+         DC    X'30A830A930AA30AB30AC30AD30AE30AF'
+         DC    X'30B030B130B230B330B430B530B630B7'
+         DC    X'30B830B930BA30BB30BC30BD30BE30BF'
+         DC    X'30C030C130C230C330C430C530C630C7'
+         DC    X'30C830C930CA30CB30CC30CD30CE30CF'
+         DC    X'30D030D130D230D330D430D530D630D7'
+         DC    X'30D830D930DA30DB30DC30DD30DE30DF'
+         DC    X'30E030E130E230E330E430E530E630E7'
+         DC    X'30E830E930EA30EB30EC30ED30EE30EF'
+         DC    X'30F030F130F230F330F430F530F630F7'
+         DC    X'30F830F930FA30FB30FC30FD30FE30FF'
+                                                                SPACE 4
+***********************************************************************
+*        Register equates
+***********************************************************************
+                                                                SPACE 2
+R0       EQU   0
+R1       EQU   1
+R2       EQU   2
+R3       EQU   3
+R4       EQU   4
+R5       EQU   5
+R6       EQU   6
+R7       EQU   7
+R8       EQU   8
+R9       EQU   9
+R10      EQU   10
+R11      EQU   11
+R12      EQU   12
+R13      EQU   13
+R14      EQU   14
+R15      EQU   15
+                                                                SPACE 2
+         END
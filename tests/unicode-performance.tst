@@ -0,0 +1,43 @@
+*Testcase unicode-performance (Test Unicode conversion and translate instructions)
+
+# ------------------------------------------------------------------------------
+#  This converts text between UTF-8, UTF-16 and UTF-32 with CU12, CU21,
+#  CU14, CU41, CU24 and CU42 and translates it with TROO, TROT, TRTO and
+#  TRTT: plain ASCII, European text with occasional multi-byte characters,
+#  and Japanese text, some of it with a character outside the basic
+#  plane.  Some of the operands are at odd addresses and all of them
+#  cross a page boundary.  Each conversion is repeated for as long as
+#  the instruction ends with condition code 3, and the result and final
+#  condition code are checked against the expected values.
+#
+#  The default is to NOT run the timing tests.  To enable them, uncomment
+#  the "#r 848=ff   # (enable timing tests)" line below.
+#
+#     Timing tests:
+#
+#           Each conversion is copied into the loop body and run
+#           100,000 times.  The instructions address their operands
+#           through R13, which points to the table entry holding the
+#           conversion; the translate tables are at fixed addresses.
+#
+#     Output:
+#
+#         For each conversion a console line is generated with the
+#         timing results, as follows:
+#
+#              100,000 iterations of CU12ASC  took     nnn,nnn microseconds
+# ------------------------------------------------------------------------------
+
+mainsize    16
+numcpu      1
+sysclear
+archlvl     z/Arch
+
+loadcore    "$(testpath)/unicode-performance.core" 0x0
+
+diag8cmd    enable    # (needed for messages to Hercules console)
+#r           848=ff    # (enable timing tests)
+runtest     300       # (test duration, depends on host)
+diag8cmd    disable   # (reset back to default)
+
+*Done
@@ -0,0 +1,122 @@
+*Testcase xstore-performance (PGOUT and PGIN with each XPNDMOVE method)
+
+# ------------------------------------------------------------------------------
+#  This pages a 4K page with markers at its start, middle and end out to
+#  expanded storage block 5, pages it back in to a second page and checks
+#  the markers, then checks that a PGOUT past the end of expanded storage
+#  sets cc3.  It is run once with XPNDMOVE COPY (ordinary memcpy) and once
+#  with XPNDMOVE STREAM (non-temporal host stores).
+#
+#  The default is to NOT run the timing test.  To enable it, uncomment
+#  the "#r 848=ff   # (enable timing tests)" lines below.
+#
+#     Timing test:
+#
+#           The source page is paged out to each of the 16,384 blocks
+#           of a 64M expanded storage, 25 times over, so that the
+#           target of every PGOUT is well out of the host cache.
+#
+#     Output:
+#
+#         For each XPNDMOVE method a console line is generated with the
+#         timing results, as follows:
+#
+#              409,600 PGOUTs took     nnn,nnn microseconds
+#
+# ------------------------------------------------------------------------------
+
+mainsize    1
+xpndsize    64
+numcpu      1
+sysclear
+archlvl     z/Arch
+
+r 1a0=0000000180000000       #  z/Arch RESTART PSW - part 1
+r 1a8=0000000000000200       #  z/Arch RESTART PSW - part 2 (address)
+r 1d0=0002000180000000       #  z/Arch PGM NEW PSW - part 1
+r 1d8=000000000000DEAD       #  z/Arch PGM NEW PSW - part 2 (address)
+*
+r 200=a7181000               # START    LHI   R1,X'1000'         Source page
+r 204=a7280005               #          LHI   R2,5               Expanded storage block 5
+r 208=b22f0012               #          PGOUT R1,R2              Page it out
+r 20c=a7740016               #          BRC   7,FAIL             Fail unless cc0
+r 210=a7382000               #          LHI   R3,X'2000'         Target page
+r 214=b22e0032               #          PGIN  R3,R2              Page it back in
+r 218=a7740010               #          BRC   7,FAIL             Fail unless cc0
+r 21c=a7284000               #          LHI   R2,16384           First block past the end
+r 220=b22f0012               #          PGOUT R1,R2              Page out to it
+r 224=a7e4000a               #          BRC   14,FAIL            Fail unless cc3
+r 228=95ff0848               #          CLI   TIMEOPT,X'FF'      Timing test requested?
+r 22c=a7740004               #          BRC   7,DONE             No, then we are done
+r 230=a7e50006               #          BRAS  R14,TIME           Time the page-outs
+r 234=b2b20800               # DONE     LPSWE GOODPSW            Load success wait PSW
+r 238=b2b20810               # FAIL     LPSWE FAILPSW            Load failure wait PSW
+r 23c=b2050828               # TIME     STCK  BEGCLOCK           Start time
+r 240=a7790019               #          LGHI  R7,25              Passes over expanded storage
+r 244=a7280000               # OUTER    LHI   R2,0               First block
+r 248=b22f0012               # INNER    PGOUT R1,R2              Page out to it
+r 24c=a72a0001               #          AHI   R2,1               Next block
+r 250=a72e4000               #          CHI   R2,16384           Past the end?
+r 254=a744fffa               #          BRC   4,INNER            No, page out to it
+r 258=a777fff6               #          BRCTG R7,OUTER           Next pass
+r 25c=b2050830               #          STCK  ENDCLOCK           End time
+r 260=e31008300004           #          LG    R1,ENDCLOCK        Elapsed TOD clock units...
+r 266=e31008280009           #          SLG   R1,BEGCLOCK
+r 26c=eb11000c000c           #          SRLG  R1,R1,12           ...in microseconds
+r 272=e3100838002e           #          CVDG  R1,DEC             Convert to decimal
+r 278=d20b089d0900           #          MVC   MSGNUM,EDPAT       Edit the microseconds
+r 27e=de0b089d0843           #          ED    MSGNUM,DEC+11
+r 284=41200880               #          LA    R2,MSGCMD          Message command
+r 288=41300036               #          LA    R3,L'MSGCMD'       ...and its length
+r 28c=83230008               #          DC    X'83230008'        DIAG 8 to issue it
+r 290=07fe                   #          BR    R14                Return
+*
+r 800=0002000180000000       # GOODPSW  DC    0D'0',X'...'       Success wait PSW part 1
+r 808=0000000000000000       #          DC    X'...'             Success wait PSW part 2
+r 810=0002000180000000       # FAILPSW  DC    0D'0',X'...'       Failure wait PSW part 1
+r 818=000000000000bad0       #          DC    X'...'             Failure wait PSW part 2
+r 848=00                     # TIMEOPT  DC    X'00'              Timing test requested
+*
+r 880=d4e2c7d5d6c8405c40f4f0f96bf6f0f0 # MSGCMD   DC    C'MSGNOH * 409,600'
+r 890=40d7c7d6e4e3a240a396969240404040 #          DC    C' PGOUTs took    '
+r 8a0=404040404040404040409489839996a2 #          DC    C'          micros'
+r 8b0=8583969584a2           #          DC    C'econds'
+r 900=402020206b2020206b202120 # EDPAT    DC    X'4020...'         Edit pattern
+*
+r 1000=0123456789abcdef      # SOURCE   DC    X'...'             First doubleword
+r 17f8=a5a5a5a55a5a5a5a      #          DC    X'...'             Middle doubleword
+r 1ff8=fedcba9876543210      #          DC    X'...'             Last doubleword
+*
+diag8cmd    enable    # (needed for messages to Hercules console)
+
+xpndmove    copy
+#r           848=ff    # (enable timing tests)
+runtest     60        # (test duration, depends on host)
+
+*Compare
+r 2000.8
+*Want "PGIN first doubleword" 01234567 89ABCDEF
+r 27f8.8
+*Want "PGIN middle doubleword" A5A5A5A5 5A5A5A5A
+r 2ff8.8
+*Want "PGIN last doubleword" FEDCBA98 76543210
+
+r 2000=0000000000000000
+r 27f8=0000000000000000
+r 2ff8=0000000000000000
+xpndmove    stream
+#r           848=ff    # (enable timing tests)
+runtest     60        # (test duration, depends on host)
+
+*Compare
+r 2000.8
+*Want "PGIN first doubleword" 01234567 89ABCDEF
+r 27f8.8
+*Want "PGIN middle doubleword" A5A5A5A5 5A5A5A5A
+r 2ff8.8
+*Want "PGIN last doubleword" FEDCBA98 76543210
+
+diag8cmd    disable   # (reset back to default)
+xpndmove    stream    # (reset back to default)
+
+*Done
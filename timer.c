@@ -181,6 +181,7 @@ U64     intv_secs;                      /* Interval                  */
 U64     half_intv;                      /* One-half interval         */
 U64     wait_secs;                      /* Wait time                 */
 const U64   one_sec  = ETOD_SEC;        /* MIPS calculation period   */
+U32     affgen = 0;                     /* sysblk.affgen applied     */
 #if defined( _FEATURE_073_TRANSACT_EXEC_FACILITY )
 bool    txf_PPA;                        /* true == PPA assist needed */
 #endif
@@ -202,9 +203,16 @@ bool    txf_PPA;                        /* true == PPA assist needed */
 #if defined( _FEATURE_073_TRANSACT_EXEC_FACILITY )
         txf_PPA = false;                /* default until we learn otherwise */
 #endif
+        /* Follow any AFFINITY TOD host CPU set change */
+        UPDATE_THREAD_AFFINITY( &sysblk.todaff, affgen );
+
         /* Update TOD clock and save TOD clock value */
         now = update_tod_clock();
 
+        /* Sample guest code locations if the profiler is active */
+        if (sysblk.profint)
+            hprof_sample( now );
+
         intv_secs = now - then;
 
         if (intv_secs >= one_sec)             /* Period expired? */
@@ -362,6 +370,7 @@ void* rubato_thread( void* argp )
     U32    count[5] = {0,0,0,0,0};      /* Transactions executed     */
                                         /* during past 5 intervals   */
     U32    max_tps_rate = 0;            /* Transactions per second   */
+    U32    affgen = 0;                  /* sysblk.affgen applied     */
 
     UNREFERENCED( argp );
 
@@ -379,6 +388,9 @@ void* rubato_thread( void* argp )
     {
         while (!sysblk.shutfini && sysblk.rubtid)
         {
+            /* Follow any AFFINITY TOD host CPU set change */
+            UPDATE_THREAD_AFFINITY( &sysblk.todaff, affgen );
+
             /* Detect change to starting timerint value */
             if (sysblk.timerint != starting_timerint)
             {
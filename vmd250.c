@@ -19,7 +19,7 @@
 /*                                                                   */
 /*  - Could not allocate storage for Block I/O environment           */
 /*  - Invalid list processor status code returned                    */
-/*  - Error creating asynchronous thread                             */
+/*  - Error creating a block I/O worker thread                       */
 /*  - Could not allocate storage for asynchronous I/O request        */
 /*                                                                   */
 /* Conditional log messages when device tracing is enabled           */
@@ -32,7 +32,7 @@
 /*  - List processor parameters                                      */
 /*  - BIOE operation being performed                                 */
 /*  - List processor status code                                     */
-/*  - Read/Write I/O operation                                       */
+/*  - Read/Write I/O operation (one per run of contiguous blocks)    */
 /*  - Syncronous or asynchronous request information                 */
 /*  - Address checking results                                       */
 /*  - Device driver results                                          */
@@ -55,13 +55,15 @@
 /*   IOREQ:                                                          */
 /*    +-> AD:d250_iorq32--+---SYNC----> d250_list32--+               */
 /*    |                   V                   ^      |               */
-/*    |               ASYNC Thread            |      |    d250_read  */
-/*    |                   +-> AD:d250_async32-+      +--> d250_write */
-/*    |                       d250_bio_interrupt     |    (calls     */
-/*    |                                              |    drivers)   */
+/*    |               d250_queue              |      |    d250_iorun */
+/*    |               d250_worker             |      +--> (calls     */
+/*    |                   +-> AD:d250_async32-+      |    drivers)   */
+/*    |                       d250_bio_interrupt     |               */
+/*    |                                              |               */
 /*    +-> AD:d250_iorq64--+----SYNC---> d250_list64--+               */
 /*    |                   V                   ^                      */
-/*    |               ASYNC Thread            |                      */
+/*    |               d250_queue              |                      */
+/*    |               d250_worker             |                      */
 /*    |                   +-> AD:d250_async64-+                      */
 /*    |                       d250_bio_interrupt                     */
 /*   REMOVE:                                                         */
@@ -74,14 +76,26 @@
 /*  d250_init32/64      No       Yes        No         No            */
 /*  d250_init           No       Yes        No         No            */
 /*  d250_iorq32/64      Yes      Yes        No         No            */
+/*  d250_queue          No       Yes        No         No            */
+/*  d250_worker         No       No         Yes        No            */
 /*  d250_async32/64     Yes      No         Yes        No            */
 /*  d250_list32/64      Yes      Yes        Yes       Yes            */
 /*  d250_bio_interrup   No       No         Yes       N/A            */
-/*  d250_read           No       Yes        Yes       Yes            */
-/*  d250_write          No       Yes        Yes       Yes            */
+/*  d250_iorun          No       Yes        Yes       Yes            */
+/*  d250_fbaio          No       Yes        Yes       Yes            */
 /*  d250_remove         No       Yes        No         No            */
 /*  d250_addrck         Yes      Yes        Yes        No            */
 /*                                                                   */
+/* Asynchronous requests are queued to the device they are for and   */
+/* processed by a small pool of worker threads, in the order they    */
+/* were made.  Only one worker at a time processes the requests of   */
+/* a device, and devices with queued requests are served round robin.*/
+/*                                                                   */
+/* A list processor first validates all BIOE's of a request and then */
+/* has d250_iorun read or write their blocks.  Neighbouring BIOE's   */
+/* of the same type for contiguous blocks are merged into one call   */
+/* of the device driver.                                             */
+/*                                                                   */
 /*-------------------------------------------------------------------*/
 
 #include "hstdinc.h"
@@ -278,6 +292,7 @@ typedef struct _BIOE64 {
 #define BIOE_ALETEXC   0x0A     /* Not used - z/VM specific          */
 #define BIOE_NOTZERO   0x0B     /* Reserved fields not zero          */
 #define BIOE_ABORTED   0x0C     /* Request aborted                   */
+#define BIOE_PENDING   0xFF     /* Internal: I/O not yet performed   */
 
 /*-------------------------------------------------------------------*/
 /* I/O Request Control Structures and Flags                          */
@@ -286,6 +301,8 @@ typedef struct _BIOE64 {
 #define SYNC   0  /* Synchronous request being processed  */
 #define ASYNC  1  /* Asynchronous request being processed */
 
+#define VMD250_WORKERS 4  /* Most asynchronous request workers */
+
 /* Synchronous or asynchronous processing status codes     */
 #define PSC_SUCCESS 0x00  /* Successful processing         */
 #define PSC_PARTIAL 0x01  /* Partial success               */
@@ -326,6 +343,19 @@ typedef struct _IOCTL64 {
         int     badblks;             /* Number of unsuccessful I/O's */
     } IOCTL64;
 
+/* A validated BIOE whose block is to be read or written             */
+#define D250_MAXBIOE   256    /* Maximum BIOE's in a request         */
+
+typedef struct _D250BIO {
+        RADR    bioe;                /* BIOE address                 */
+        RADR    bufbeg;              /* First byte of the I/O buffer */
+        RADR    bufend;              /* Last byte of the I/O buffer  */
+        S64     physblk;             /* Physical block (rel. to 0)   */
+        BYTE    type;                /* BIOE_READ or BIOE_WRITE      */
+        BYTE    status;              /* BIOE status or BIOE_PENDING  */
+        U16     xcode;               /* Status byte store exception  */
+    } D250BIO;
+
 #endif /* !defined(_VMD250_H) */
 
 /*-------------------------------------------------------------------*/
@@ -339,10 +369,14 @@ static struct VMBIOENV* d250_init(DEVBLK *, U32, S64, int *, int *);
 /* Input/Output Request Functions */
 static void d250_preserve(DEVBLK *);
 static void d250_restore(DEVBLK *);
-static int d250_read(DEVBLK *, S64, S32, void *);
-static int d250_write(DEVBLK *, S64, S32, void *);
+static void d250_iorun(DEVBLK *, D250BIO *, int, BYTE *);
+static void d250_fbaio(DEVBLK *, struct VMBIOENV *, D250BIO *, int, BYTE *);
 /* Note: some I/O request functions are architecture dependent */
 
+/* Asynchronous Request Queueing */
+static int   d250_queue(DEVBLK *, void* (*)(void*), void *);
+static void* d250_worker(void *);
+
 /* Removal Function */
 static int  d250_remove(DEVBLK *, int *, BIOPL_REMOVE *, REGS *);
 
@@ -703,6 +737,7 @@ static void d250_preserve(DEVBLK *dev)
 
     dev->busy = 1;
     dev->startpending = 0;
+    dev->vmd250reqs++;
     if (dev->sns_pending)
     {
        /* Save the pending sense */
@@ -824,138 +859,328 @@ int       cc;                        /* Condition code to return     */
 } /* end function d250_remove */
 
 /*-------------------------------------------------------------------*/
-/*  Device Independent Read Block                                    */
+/*  Device Independent Read/Write of a Request's Blocks              */
 /*-------------------------------------------------------------------*/
-static int d250_read(DEVBLK *dev, S64 pblknum, S32 blksize, void *buffer)
+/* Each run of BIOE's of the same type for contiguous blocks is read */
+/* or written with a single call of the device driver.  BIOE's that  */
+/* failed validation are skipped, their status is already set.       */
+static void d250_iorun(DEVBLK *dev, D250BIO *bio, int count, BYTE *mainstor)
 {
-BYTE unitstat;     /* Device unit status */
-U32  residual;     /* Residual byte count */
+struct VMBIOENV *bioenv;   /* Block I/O environment          */
+int  i;                    /* First BIOE of a run            */
+int  j;                    /* BIOE following the run         */
+int  k;                    /* BIOE in the run                */
 
 /* Note: Not called with device lock held */
 
     obtain_lock(&dev->lock);
-    if (dev->ccwtrace)
+
+    bioenv = dev->vmd250env;
+
+    /* Call the I/O start exit */
+    if (bioenv && !bioenv->isCKD && dev->hnd->start)
+       (dev->hnd->start) (dev);
+
+    for ( i = 0 ; i < count ; i = j )
     {
-       WRMSG(HHC01922, "I", dev->devnum, blksize, pblknum);
+       j = i + 1;
+
+       if (bio[i].status != BIOE_PENDING)
+       {
+          continue;
+       }
+
+       /* Extend the run over the following contiguous blocks */
+       while ( j < count
+            && bio[j].status == BIOE_PENDING
+            && bio[j].type == bio[i].type
+            && bio[j].physblk == bio[i].physblk + (j - i) )
+       {
+          j++;
+       }
+
+       if (!bioenv)
+       {
+          for ( k = i ; k < j ; k++ )
+             bio[k].status = BIOE_ABORTED;
+       }
+       else if (bioenv->isCKD)
+       {
+          /* Do CKD I/O */
+
+          /* CKD to be supplied */
+
+          for ( k = i ; k < j ; k++ )
+             bio[k].status = BIOE_IOERROR;
+       }
+       else
+       {
+          /* Do FBA I/O */
+          d250_fbaio(dev, bioenv, bio + i, j - i, mainstor);
+       }
     }
 
-    if (dev->vmd250env->isCKD)
-    {
-       release_lock(&dev->lock);
-       /* Do CKD I/O */
+    /* Call the I/O end exit */
+    if (bioenv && !bioenv->isCKD && dev->hnd->end)
+       (dev->hnd->end) (dev);
+
+    release_lock(&dev->lock);
+}
+
+/*-------------------------------------------------------------------*/
+/*  FBA Read/Write of Contiguous Blocks                              */
+/*-------------------------------------------------------------------*/
+/* The blocks are read or written directly in main storage when the  */
+/* guest's buffers are contiguous, and otherwise through a buffer    */
+/* holding all of them.  If the I/O fails, the blocks are retried    */
+/* one at a time so that each BIOE gets its own status.              */
+/* Note: Called with the device lock held                            */
+static void d250_fbaio(DEVBLK *dev, struct VMBIOENV *bioenv, D250BIO *bio,
+                       int count, BYTE *mainstor)
+{
+BYTE *buffer;      /* I/O buffer for all blocks */
+BYTE unitstat;     /* Device unit status */
+U32  residual;     /* Residual byte count */
+BYTE status;       /* Status of the I/O */
+int  contig;       /* Guest buffers are contiguous */
+int  len;          /* Length of all blocks */
+int  i;
 
-       /* CKD to be supplied */
+    len = count * bioenv->blksiz;
 
-       return BIOE_IOERROR;
+    for ( contig = 1, i = 1 ; contig && i < count ; i++ )
+    {
+       contig = ( bio[i].bufbeg == bio[0].bufbeg + (RADR)i * bioenv->blksiz );
     }
-    else
+
+    if (contig)
+    {
+       buffer = mainstor + bio[0].bufbeg;
+    }
+    else if (!(buffer = malloc(len)))
     {
-       /* Do FBA I/O */
+       /* Do the blocks one at a time instead */
+       for ( i = 0 ; i < count ; i++ )
+          d250_fbaio(dev, bioenv, bio + i, 1, mainstor);
+       return;
+    }
 
-       /* Call the I/O start exit */
-       if (dev->hnd->start) (dev->hnd->start) (dev);
+    if (dev->ccwtrace)
+    {
+       WRMSG(HHC01922, "I", dev->devnum,
+             bio[0].type == BIOE_READ ? "read" : "write",
+             count, bioenv->blksiz, bio[0].physblk);
+    }
 
-       unitstat = 0;
+    unitstat = 0;
+    residual = 0;
 
-       /* Call the FBA driver's read standard block routine */
-       fbadasd_read_block(dev, (int)pblknum, (int)blksize,
-                          dev->vmd250env->blkphys,
+    /* The FBA driver's standard block routines accept the length of */
+    /* any number of contiguous blocks                               */
+    if (bio[0].type == BIOE_READ)
+    {
+       fbadasd_read_block(dev, (int)bio[0].physblk, len,
+                          bioenv->blkphys,
                           buffer, &unitstat, &residual );
-
-       if (dev->ccwtrace)
+       dev->vmd250rdblks += count;
+    }
+    else
+    {
+       if (!contig)
        {
-          WRMSG(HHC01923, "I", dev->devnum, unitstat, residual );
+          for ( i = 0 ; i < count ; i++ )
+             memcpy(buffer + i * bioenv->blksiz,
+                    mainstor + bio[i].bufbeg, bioenv->blksiz);
        }
+       fbadasd_write_block(dev, (int)bio[0].physblk, len,
+                           bioenv->blkphys,
+                           buffer, &unitstat, &residual );
+       dev->vmd250wrblks += count;
+    }
+    dev->vmd250ios++;
 
-       /* Call the I/O end exit */
-       if (dev->hnd->end) (dev->hnd->end) (dev);
-
-       release_lock(&dev->lock);
+    if (dev->ccwtrace)
+    {
+       WRMSG(HHC01923, "I", dev->devnum, unitstat, residual );
     }
+
     /* If an I/O error occurred, return status of I/O Error */
     if ( unitstat != ( CSW_CE | CSW_DE ) )
     {
-       return BIOE_IOERROR;
+       status = BIOE_IOERROR;
     }
-
     /* If there was a residual count, block size error, return status of 2 */
     /* Note: This can only happen for CKD devices                          */
-    if ( residual != 0 )
+    else if ( residual != 0 )
     {
-       return BIOE_CKDRECL;
+       status = BIOE_CKDRECL;
     }
-
     /* Success! return 0 status */
-    return BIOE_SUCCESS;
+    else
+    {
+       status = BIOE_SUCCESS;
+    }
+
+    if (status == BIOE_SUCCESS && bio[0].type == BIOE_READ && !contig)
+    {
+       for ( i = 0 ; i < count ; i++ )
+          memcpy(mainstor + bio[i].bufbeg,
+                 buffer + i * bioenv->blksiz, bioenv->blksiz);
+    }
+
+    if (!contig)
+    {
+       free(buffer);
+    }
+
+    if (status == BIOE_SUCCESS || count == 1)
+    {
+       for ( i = 0 ; i < count ; i++ )
+          bio[i].status = status;
+       return;
+    }
+
+    /* Find out which of the blocks failed, forgetting the sense */
+    /* of the failed I/O of all of them                          */
+    memset(dev->sense, 0, sizeof(dev->sense));
+    for ( i = 0 ; i < count ; i++ )
+       d250_fbaio(dev, bioenv, bio + i, 1, mainstor);
 }
 
 /*-------------------------------------------------------------------*/
-/*  Device Independent Write Block                                   */
+/*  Queue an Asynchronous Request                                    */
 /*-------------------------------------------------------------------*/
-static int d250_write(DEVBLK *dev, S64 pblknum, S32 blksize, void *buffer)
+/* The request is queued to its device and the device, unless it     */
+/* already is, to the block I/O worker threads.  Another worker is   */
+/* started when none is waiting for work and there are fewer than    */
+/* VMD250_WORKERS.                                                   */
+static int d250_queue(DEVBLK *dev, void* (*func)(void*), void *ctl)
 {
-BYTE unitstat;     /* Device unit status */
-U32  residual;     /* Residual byte count */
+struct VMBIOREQ *req;      /* Queued request                 */
+TID     tid;               /* Worker thread ID               */
+int     rc;                /* Return code                    */
 
-    obtain_lock(&dev->lock);
-    if (dev->ccwtrace)
+    if (!(req = (struct VMBIOREQ *)malloc(sizeof(struct VMBIOREQ))))
     {
-       WRMSG(HHC01922, "I", dev->devnum, blksize, pblknum);
+       char buf[40];
+       MSGBUF(buf, "malloc(%d)", (int)sizeof(struct VMBIOREQ));
+       WRMSG (HHC01908, "E", buf, strerror(errno));
+       return ENOMEM;
     }
+    req->next = NULL;
+    req->func = func;
+    req->ctl  = ctl;
+    req->qtod = host_tod();
 
-    if (!dev->vmd250env)
+    obtain_lock(&sysblk.vmd250lock);
+
+    if (!sysblk.vmd250idle && sysblk.vmd250workers < VMD250_WORKERS)
     {
-       release_lock(&dev->lock);
-       return BIOE_ABORTED;
+       rc = create_thread (&tid, DETACHED, d250_worker, NULL, "d250 worker");
+       if (rc)
+       {
+          WRMSG (HHC00102, "E", strerror(rc));
+
+          /* Without any worker the request can't be processed */
+          if (!sysblk.vmd250workers)
+          {
+             release_lock(&sysblk.vmd250lock);
+             free(req);
+             return rc;
+          }
+       }
+       else
+       {
+          sysblk.vmd250workers++;
+       }
     }
-    if (dev->vmd250env->isCKD)
-    {
-        release_lock(&dev->lock);
-        /* Do CKD I/O */
-
-        /* CKD to be supplied */
 
-        return BIOE_IOERROR;
-    }
+    /* Queue the request to its device */
+    if (dev->vmd250rql)
+       dev->vmd250rql->next = req;
     else
+       dev->vmd250rq = req;
+    dev->vmd250rql = req;
+    dev->vmd250async++;
+    if (++dev->vmd250qdepth > dev->vmd250qmax)
+       dev->vmd250qmax = dev->vmd250qdepth;
+
+    /* Queue the device to the workers */
+    if (!dev->vmd250sched)
     {
-       /* Do FBA I/O */
+       dev->vmd250sched = 1;
+       dev->vmd250next = NULL;
+       if (sysblk.vmd250ql)
+          sysblk.vmd250ql->vmd250next = dev;
+       else
+          sysblk.vmd250q = dev;
+       sysblk.vmd250ql = dev;
+       signal_condition(&sysblk.vmd250cond);
+    }
 
-       /* Call the I/O start exit */
-       if (dev->hnd->start) (dev->hnd->start) (dev);
+    release_lock(&sysblk.vmd250lock);
+    return 0;
+}
 
-       unitstat = 0;
+/*-------------------------------------------------------------------*/
+/*  Asynchronous Request Worker Thread                               */
+/*-------------------------------------------------------------------*/
+/* A worker processes one request of the first queued device, and    */
+/* queues the device again behind the others if it has more.         */
+static void* d250_worker(void *arg)
+{
+DEVBLK  *dev;              /* Device with queued requests    */
+struct VMBIOREQ *req;      /* Its first queued request       */
 
-       /* Call the FBA driver's write standard block routine */
-       fbadasd_write_block(dev, (int)pblknum, (int)blksize,
-                           dev->vmd250env->blkphys,
-                           buffer, &unitstat, &residual );
-       if (dev->ccwtrace)
+    UNREFERENCED(arg);
+
+    obtain_lock(&sysblk.vmd250lock);
+
+    for (;;)
+    {
+       if (!(dev = sysblk.vmd250q))
        {
-          WRMSG(HHC01923, "I", dev->devnum, unitstat, residual );
+          sysblk.vmd250idle++;
+          wait_condition(&sysblk.vmd250cond, &sysblk.vmd250lock);
+          sysblk.vmd250idle--;
+          continue;
        }
+       sysblk.vmd250q = dev->vmd250next;
+       if (!sysblk.vmd250q)
+          sysblk.vmd250ql = NULL;
 
-       /* Call the I/O end exit */
-       if (dev->hnd->end) (dev->hnd->end) (dev);
+       req = dev->vmd250rq;
+       dev->vmd250rq = req->next;
+       if (!dev->vmd250rq)
+          dev->vmd250rql = NULL;
+       dev->vmd250qdepth--;
+       dev->vmd250qwait += (host_tod() - req->qtod) / ETOD_USEC;
 
-       release_lock(&dev->lock);
-    }
+       release_lock(&sysblk.vmd250lock);
 
-    /* If an I/O error occurred, return status of 1 */
-    if ( unitstat != ( CSW_CE | CSW_DE ) )
-    {
-       return BIOE_IOERROR;
-    }
+       /* Process the request and trigger its interrupt */
+       (req->func)(req->ctl);
+       free(req);
 
-    /* If there was a residual count, block size error, return status of 2 */
-    /* Note: This can only happen for CKD devices                          */
-    if ( residual != 0 )
-    {
-       return BIOE_CKDRECL;
+       obtain_lock(&sysblk.vmd250lock);
+
+       /* Queue the device again if it has more requests */
+       if (dev->vmd250rq)
+       {
+          dev->vmd250next = NULL;
+          if (sysblk.vmd250ql)
+             sysblk.vmd250ql->vmd250next = dev;
+          else
+             sysblk.vmd250q = dev;
+          sysblk.vmd250ql = dev;
+       }
+       else
+       {
+          dev->vmd250sched = 0;
+       }
     }
 
-    /* Success! */
-    return BIOE_SUCCESS;
+    UNREACHABLE_CODE( return NULL );
 }
 
 #endif /*!defined(_VMD250_C)*/
@@ -1147,7 +1372,7 @@ int     cc;                            /* condition code             */
 } /* end function vm_blockio */
 
 /*-------------------------------------------------------------------*/
-/*  Asynchronous Input/Outut 32-bit Driver Thread                    */
+/*  Asynchronous Input/Outut 32-bit Driver (on a worker thread)      */
 /*-------------------------------------------------------------------*/
 static void *ARCH_DEP(d250_async32)(void *ctl)
 {
@@ -1157,7 +1382,7 @@ BYTE    psc;       /* List processing status code   */
    /* Fetch the IO request control structure */
    ioctl=(IOCTL32 *)ctl;
 
-   /* Call the 32-bit BIOE request processor on this async thread*/
+   /* Call the 32-bit BIOE request processor on this worker thread */
    psc=ARCH_DEP(d250_list32)(ioctl, ASYNC);
 
    /* Trigger the external interrupt here */
@@ -1179,10 +1404,7 @@ IOCTL32 ioctl;            /* Request information */
 BYTE    psc;              /* List processing status code */
 
 /* Asynchronous request related fields */
-TID     tid;         /* Asynchronous thread ID */
-char    tname[32];   /* Thread name */
-IOCTL32 *asyncp;     /* Pointer to async thread's storage */
-int     rc2;
+IOCTL32 *asyncp;     /* Pointer to async request's storage */
 
    /* Clear the reserved BIOPL */
    memset(&bioplx00,0,sizeof(BIOPL_IORQ32));
@@ -1257,7 +1479,7 @@ int     rc2;
        /* Note: This should be set correctly from the returned PSC */
        ioctl.statuscod = PSC_STGERR;
 
-       /* Get the storage for the thread's parameters */
+       /* Get the storage for the request's parameters */
        if (!(asyncp=(IOCTL32 *)malloc(sizeof(IOCTL32))))
        {
           char buf[40];
@@ -1267,22 +1489,17 @@ int     rc2;
           return CC_FAILED;
        }
 
-       /* Copy the thread's parameters to its own storage */
+       /* Copy the request's parameters to its own storage */
        memcpy(asyncp,&ioctl,sizeof(IOCTL32));
 
-       /* Launch the asynchronous request on a separate thread */
-       MSGBUF(tname,"d250_async %4.4X",dev->devnum);
-       tname[sizeof(tname)-1]=0;
-       rc2 = create_thread (&tid, DETACHED, ARCH_DEP(d250_async32),
-               asyncp, tname);
-       if(rc2)
+       /* Queue the asynchronous request for a block I/O worker */
+       if (d250_queue(dev, ARCH_DEP(d250_async32), asyncp))
        {
-          WRMSG (HHC00102, "E", strerror(rc2));
-          release_lock (&dev->lock);
+          free(asyncp);
           *rc = RC_ERROR;
           return CC_FAILED;
        }
-       /* Launched the async request successfully */
+       /* Queued the async request successfully */
        *rc = RC_ASYNC;
        return CC_SUCCESS;
    }
@@ -1368,9 +1585,12 @@ int    block;     /* counter used in block I/O loop            */
 S32    blknum;    /* Block number of the request               */
 BYTE   status;    /* Returned BIOE status                      */
 /* Passed to generic block I/O function                        */
-int    physblk;   /* Physical block number                     */
+S64    physblk;   /* Physical block number                     */
 RADR   bufbeg;    /* Address where the read/write will occur   */
 RADR   bufend;    /* Last byte read or written                 */
+D250BIO bio[D250_MAXBIOE]; /* Validated BIOE's                 */
+int    count;     /* Number of validated BIOE's                */
+int    i;         /* Index of a validated BIOE                 */
 
    xcode = 0;   /* Initialize the address check exception code */
    status = 0;
@@ -1400,11 +1620,14 @@ RADR   bufend;    /* Last byte read or written                 */
 
    blocks=(int)ioctl->blkcount;
    bioebeg=ioctl->listaddr & AMASK31 ;
+   count=0;
 
-   /* Process each of the BIOE's supplied by the BIOPL count field */
+   /* Validate each of the BIOE's supplied by the BIOPL count field */
    for ( block = 0 ; block < blocks ; block++ )
    {
-      status = 0xFF;  /* Set undefined status */
+      status = BIOE_PENDING;  /* Set I/O still to be performed */
+      physblk = 0;
+      bufbeg = bufend = 0;
 
       bioeend=( bioebeg + sizeof(BIOE32) - 1 ) & AMASK31;
       xcode=ARCH_DEP(d250_addrck)
@@ -1500,25 +1723,6 @@ RADR   bufend;    /* Last byte read or written                 */
             }
             /* At this point, the block number has been validated */
             /* and the buffer is addressable and accessible       */
-            status=d250_read(ioctl->dev,
-                               physblk,
-                               ioctl->dev->vmd250env->blksiz,
-                               ioctl->regs->mainstor+bufbeg);
-
-            /* Set I/O storage key references if successful */
-            if (!status)
-            {
-               ARCH_DEP( or_storage_key )( bufbeg, STORKEY_REF );
-               ARCH_DEP( or_storage_key )( bufend, STORKEY_REF );
-
-#if defined(FEATURE_2K_STORAGE_KEYS)
-               if ( ioctl->dev->vmd250env->blksiz == 4096 )
-               {
-                  ARCH_DEP( or_storage_key )( bufbeg+2048, STORKEY_REF );
-               }
-#endif
-            }
-
             continue;
          }  /* end of BIOE_READ */
          else
@@ -1550,24 +1754,6 @@ RADR   bufend;    /* Last byte read or written                 */
                   status=BIOE_DASDRO;
                   continue;
                }
-               status=d250_write(ioctl->dev,
-                                   physblk,
-                                   ioctl->dev->vmd250env->blksiz,
-                                   ioctl->regs->mainstor+bufbeg);
-
-               /* Set I/O storage key references if good I/O */
-               if (!status)
-               {
-                  ARCH_DEP( or_storage_key )( bufbeg, (STORKEY_REF | STORKEY_CHANGE) );
-                  ARCH_DEP( or_storage_key )( bufend, (STORKEY_REF | STORKEY_CHANGE) );
-#if defined(FEATURE_2K_STORAGE_KEYS)
-                  if ( ioctl->dev->vmd250env->blksiz == 4096 )
-                  {
-                     ARCH_DEP( or_storage_key )( bufbeg+2048, (STORKEY_REF | STORKEY_CHANGE) );
-                  }
-#endif
-               }
-
                continue;
             } /* end of if BIOE_WRITE */
             else
@@ -1587,6 +1773,16 @@ RADR   bufend;    /* Last byte read or written                 */
                   ioctl->dev->devnum,xcode,bioebeg+1,bioebeg+1,ioctl->key);
       }
 
+      /* Save the validated BIOE, its I/O is done with the others' */
+      bio[count].bioe    = bioebeg;
+      bio[count].bufbeg  = bufbeg;
+      bio[count].bufend  = bufend;
+      bio[count].physblk = physblk;
+      bio[count].type    = bioe.type;
+      bio[count].status  = status;
+      bio[count].xcode   = xcode;
+      count++;
+
       /* If the status byte is store protected, give up on processing any */
       /* more BIOE's.  Leave the BIOE list process for loop               */
       if ( xcode )
@@ -1594,6 +1790,55 @@ RADR   bufend;    /* Last byte read or written                 */
          break;
       }
 
+      /* Determine the address of the next BIOE */
+      bioebeg += sizeof(BIOE32);
+      bioebeg &= AMASK31;
+   } /* end of for loop */
+
+   /* Read or write the blocks of all validated BIOE's */
+   d250_iorun(ioctl->dev, bio, count, ioctl->regs->mainstor);
+
+   /* Store the status of each validated BIOE */
+   for ( i = 0 ; i < count ; i++ )
+   {
+      bioebeg = bio[i].bioe;
+      bufbeg  = bio[i].bufbeg;
+      bufend  = bio[i].bufend;
+      status  = bio[i].status;
+
+      /* Set I/O storage key references if successful */
+      if (!status)
+      {
+         if (bio[i].type == BIOE_READ)
+         {
+            ARCH_DEP( or_storage_key )( bufbeg, STORKEY_REF );
+            ARCH_DEP( or_storage_key )( bufend, STORKEY_REF );
+#if defined(FEATURE_2K_STORAGE_KEYS)
+            if ( bufend - bufbeg >= 2048 )
+            {
+               ARCH_DEP( or_storage_key )( bufbeg+2048, STORKEY_REF );
+            }
+#endif
+         }
+         else
+         {
+            ARCH_DEP( or_storage_key )( bufbeg, (STORKEY_REF | STORKEY_CHANGE) );
+            ARCH_DEP( or_storage_key )( bufend, (STORKEY_REF | STORKEY_CHANGE) );
+#if defined(FEATURE_2K_STORAGE_KEYS)
+            if ( bufend - bufbeg >= 2048 )
+            {
+               ARCH_DEP( or_storage_key )( bufbeg+2048, (STORKEY_REF | STORKEY_CHANGE) );
+            }
+#endif
+         }
+      }
+
+      /* Stop at the BIOE whose status byte is store protected */
+      if ( bio[i].xcode )
+      {
+         break;
+      }
+
       /* Store the status in the BIOE */
       memcpy(ioctl->regs->mainstor+bioebeg+1,&status,1);
 
@@ -1618,10 +1863,6 @@ RADR   bufend;    /* Last byte read or written                 */
       {
          ioctl->goodblks+=1;
       }
-
-      /* Determine the address of the next BIOE */
-      bioebeg += sizeof(BIOE32);
-      bioebeg &= AMASK31;
    } /* end of for loop */
 
 #if 0
@@ -1741,7 +1982,7 @@ BYTE   skmid;    /* Storage key of middle byte of area        */
 #if defined(FEATURE_001_ZARCH_INSTALLED_FACILITY)
 
 /*-------------------------------------------------------------------*/
-/*  Asynchronous Input/Output 64-bit Driver Thread                   */
+/*  Asynchronous Input/Output 64-bit Driver (on a worker thread)     */
 /*-------------------------------------------------------------------*/
 static void* ARCH_DEP(d250_async64)(void *ctl)
 {
@@ -1751,7 +1992,7 @@ BYTE     psc;      /* List processing status code */
    /* Fetch the IO request control structure */
    ioctl=(IOCTL64 *)ctl;
 
-   /* Call the 32-bit BIOE request processor on this async thread*/
+   /* Call the 64-bit BIOE request processor on this worker thread */
    psc=ARCH_DEP(d250_list64)(ioctl, ASYNC);
 
    d250_bio_interrupt(ioctl->dev, ioctl->intrparm, psc, 0x07);
@@ -1772,10 +2013,7 @@ IOCTL64 ioctl;             /* Request information */
 BYTE    psc;               /* List processing status code   */
 
 /* Asynchronous request related fields */
-TID     tid;         /* Asynchronous thread ID */
-char    tname[32];   /* Thread name */
-IOCTL64 *asyncp;     /* Pointer to async thread's free standing storage */
-int     rc2;
+IOCTL64 *asyncp;     /* Pointer to async request's free standing storage */
 
 #if 0
    LOGMSG( "(d250_iorq64) Entered\n" );
@@ -1864,7 +2102,7 @@ int     rc2;
        /* Note: This should be set correctly from the returned PSC */
        ioctl.statuscod = PSC_STGERR;
 
-       /* Get the storage for the thread's parameters */
+       /* Get the storage for the request's parameters */
        if (!(asyncp=(IOCTL64 *)malloc(sizeof(IOCTL64))))
        {
           char buf[40];
@@ -1874,22 +2112,17 @@ int     rc2;
           return CC_FAILED;
        }
 
-       /* Copy the thread's parameters to its own storage */
+       /* Copy the request's parameters to its own storage */
        memcpy(asyncp,&ioctl,sizeof(IOCTL64));
 
-       /* Launch the asynchronous request on a separate thread */
-       MSGBUF(tname,"d250_async %4.4X",dev->devnum);
-       tname[sizeof(tname)-1]=0;
-       rc2 = create_thread (&tid, DETACHED, ARCH_DEP(d250_async64),
-               asyncp, tname);
-       if(rc2)
+       /* Queue the asynchronous request for a block I/O worker */
+       if (d250_queue(dev, ARCH_DEP(d250_async64), asyncp))
        {
-          WRMSG (HHC00102, "E", strerror(rc2));
-          release_lock (&dev->lock);
+          free(asyncp);
           *rc = RC_ERROR;
           return CC_FAILED;
        }
-       /* Launched the async request successfully */
+       /* Queued the async request successfully */
        *rc = RC_ASYNC;
        return CC_SUCCESS;
    }
@@ -1955,9 +2188,12 @@ int    block;     /* counter used in block I/O loop            */
 S64    blknum;    /* Block number of the request               */
 BYTE   status;    /* Returned BIOE status                      */
 /* Passed to generic block I/O function                        */
-int    physblk;   /* Physical block number                     */
+S64    physblk;   /* Physical block number                     */
 RADR   bufbeg;    /* Address where the read/write will occur   */
 RADR   bufend;    /* Last byte read or written                 */
+D250BIO bio[D250_MAXBIOE]; /* Validated BIOE's                 */
+int    count;     /* Number of validated BIOE's                */
+int    i;         /* Index of a validated BIOE                 */
 
 
    xcode = 0;   /* Initialize the address check exception code */
@@ -1988,11 +2224,14 @@ RADR   bufend;    /* Last byte read or written                 */
 
    blocks=(int)ioctl->blkcount;
    bioebeg=ioctl->listaddr & AMASK64 ;
+   count=0;
 
-   /* Process each of the BIOE's supplied by the BIOPL count field */
+   /* Validate each of the BIOE's supplied by the BIOPL count field */
    for ( block = 0 ; block < blocks ; block++ )
    {
-      status = 0xFF;  /* Set undefined status */
+      status = BIOE_PENDING;  /* Set I/O still to be performed */
+      physblk = 0;
+      bufbeg = bufend = 0;
 
       bioeend=( bioebeg + sizeof(BIOE32) - 1 ) & AMASK31;
       xcode=ARCH_DEP(d250_addrck)
@@ -2088,18 +2327,6 @@ RADR   bufend;    /* Last byte read or written                 */
             }
             /* At this point, the block number has been validated */
             /* and the buffer is addressable and accessible       */
-            status=d250_read(ioctl->dev,
-                               physblk,
-                               ioctl->dev->vmd250env->blksiz,
-                               ioctl->regs->mainstor+bufbeg);
-
-            /* Set I/O storage key references if successful */
-            if (!status)
-            {
-               ARCH_DEP( or_storage_key )( bufbeg, STORKEY_REF );
-               ARCH_DEP( or_storage_key )( bufend, STORKEY_REF );
-            }
-
             continue;
          }  /* end of BIOE_READ */
          else
@@ -2131,16 +2358,6 @@ RADR   bufend;    /* Last byte read or written                 */
                   status=BIOE_DASDRO;
                   continue;
                }
-               status=d250_write(ioctl->dev,
-                                   physblk,
-                                   ioctl->dev->vmd250env->blksiz,
-                                   ioctl->regs->mainstor+bufbeg);
-               /* Set I/O storage key references if good I/O */
-               if (!status)
-               {
-                  ARCH_DEP( or_storage_key )( bufbeg, (STORKEY_REF | STORKEY_CHANGE) );
-                  ARCH_DEP( or_storage_key )( bufend, (STORKEY_REF | STORKEY_CHANGE) );
-               }
                continue;
             } /* end of if BIOE_WRITE */
             else
@@ -2159,6 +2376,16 @@ RADR   bufend;    /* Last byte read or written                 */
          WRMSG(HHC01944,"I",ioctl->dev->devnum,xcode,bioebeg+1,bioebeg+1,ioctl->key);
       }
 
+      /* Save the validated BIOE, its I/O is done with the others' */
+      bio[count].bioe    = bioebeg;
+      bio[count].bufbeg  = bufbeg;
+      bio[count].bufend  = bufend;
+      bio[count].physblk = physblk;
+      bio[count].type    = bioe.type;
+      bio[count].status  = status;
+      bio[count].xcode   = xcode;
+      count++;
+
       /* If the status byte is store protected, give up on processing any */
       /* more BIOE's.  Leave the BIOE list process for loop               */
       if ( xcode )
@@ -2166,6 +2393,43 @@ RADR   bufend;    /* Last byte read or written                 */
          break;
       }
 
+      /* Determine the address of the next BIOE */
+      bioebeg += sizeof(BIOE64);
+      bioebeg &= AMASK64;
+   } /* end of for loop */
+
+   /* Read or write the blocks of all validated BIOE's */
+   d250_iorun(ioctl->dev, bio, count, ioctl->regs->mainstor);
+
+   /* Store the status of each validated BIOE */
+   for ( i = 0 ; i < count ; i++ )
+   {
+      bioebeg = bio[i].bioe;
+      bufbeg  = bio[i].bufbeg;
+      bufend  = bio[i].bufend;
+      status  = bio[i].status;
+
+      /* Set I/O storage key references if successful */
+      if (!status)
+      {
+         if (bio[i].type == BIOE_READ)
+         {
+            ARCH_DEP( or_storage_key )( bufbeg, STORKEY_REF );
+            ARCH_DEP( or_storage_key )( bufend, STORKEY_REF );
+         }
+         else
+         {
+            ARCH_DEP( or_storage_key )( bufbeg, (STORKEY_REF | STORKEY_CHANGE) );
+            ARCH_DEP( or_storage_key )( bufend, (STORKEY_REF | STORKEY_CHANGE) );
+         }
+      }
+
+      /* Stop at the BIOE whose status byte is store protected */
+      if ( bio[i].xcode )
+      {
+         break;
+      }
+
       /* Store the status in the BIOE */
       memcpy(ioctl->regs->mainstor+bioebeg+1,&status,1);
 
@@ -2190,10 +2454,6 @@ RADR   bufend;    /* Last byte read or written                 */
       {
          ioctl->goodblks+=1;
       }
-
-      /* Determine the address of the next BIOE */
-      bioebeg += sizeof(BIOE64);
-      bioebeg &= AMASK64;
    } /* end of for loop */
 
 #if 0 // remove after testing
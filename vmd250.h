@@ -25,4 +25,14 @@ struct VMBIOENV {
         BYTE  sense[32]; /* Save area for any pending sense data     */
 };
 
+/*-------------------------------------------------------------------*/
+/*  DIAGNOSE X'250' Block I/O - Queued Asynchronous Request          */
+/*-------------------------------------------------------------------*/
+struct VMBIOREQ {
+        struct VMBIOREQ *next;   /* Next request for the same device */
+        void* (*func)(void*);    /* List processor to be called      */
+        void   *ctl;             /* Its IOCTL32 or IOCTL64 structure */
+        U64     qtod;            /* Host TOD when queued             */
+};
+
 #endif /* !defined(__VMD250_H__) */
@@ -148,8 +148,12 @@ size_t  xoffs;                          /* Byte offset into xpndstor */
     vaddr = (regs->GR(r1) & ADDRESS_MAXWRAP(regs)) & XSTORE_PAGEMASK;
     maddr = MADDR (vaddr, USE_REAL_ADDR, regs, ACCTYPE_READ, 0);
 
-    /* Copy data from main to expanded */
-    memcpy (sysblk.xpndstor + xoffs, maddr, XSTORE_PAGESIZE);
+    /* Copy data from main to expanded, bypassing the host cache
+       unless XPNDMOVE COPY was requested */
+    if (sysblk.xpndstream)
+        hsimd_stream_page (sysblk.xpndstor + xoffs, maddr);
+    else
+        memcpy (sysblk.xpndstor + xoffs, maddr, XSTORE_PAGESIZE);
 
     /* cc0 means pgout ok */
     regs->psw.cc = 0;
@@ -561,9 +565,13 @@ BYTE    xpkey1 = 0, xpkey2 = 0;         /* Expanded storage keys     */
         STORE_W(regs->mainstor + raddr1, pte1 | PAGETAB_ESREF | PAGETAB_ESCHA);
 
         /* Move 4K bytes from main storage to expanded storage */
-        memcpy (sysblk.xpndstor + ((size_t)xpblk1 << XSTORE_PAGESHIFT),
-                main2,
-                XSTORE_PAGESIZE);
+        if (sysblk.xpndstream)
+            hsimd_stream_page (sysblk.xpndstor + ((size_t)xpblk1 << XSTORE_PAGESHIFT),
+                               main2);
+        else
+            memcpy (sysblk.xpndstor + ((size_t)xpblk1 << XSTORE_PAGESHIFT),
+                    main2,
+                    XSTORE_PAGESIZE);
     }
     else
 #endif /*defined(FEATURE_EXPANDED_STORAGE)*/